@@ -45,8 +45,7 @@ using namespace chip::app::Clusters;
 
 namespace {
 
-constexpr uint8_t kMaxRetries = 10;
-constexpr int kNodeLabelSize  = 32;
+constexpr int kNodeLabelSize = 32;
 
 // Current ZCL implementation of Struct uses a max-size array of 254 bytes
 constexpr int kDescriptorAttributeArraySize = 254;
@@ -126,118 +125,76 @@ DeviceManager DeviceManager::sInstance;
 void DeviceManager::Init()
 {
     memset(mDevices, 0, sizeof(mDevices));
-    mFirstDynamicEndpointId = static_cast<chip::EndpointId>(
-        static_cast<int>(emberAfEndpointFromIndex(static_cast<uint16_t>(emberAfFixedEndpointCount() - 1))) + 1);
-    mCurrentEndpointId = mFirstDynamicEndpointId;
+    mEndpointManager.Init();
 }
 
 int DeviceManager::AddDeviceEndpoint(Device * dev, chip::EndpointId parentEndpointId)
 {
-    uint8_t index                                              = 0;
-    EmberAfEndpointType * ep                                   = &sBridgedNodeEndpoint;
-    const chip::Span<const EmberAfDeviceType> & deviceTypeList = Span<const EmberAfDeviceType>(sBridgedDeviceTypes);
-    const chip::Span<chip::DataVersion> & dataVersionStorage   = Span<DataVersion>(sBridgedNodeDataVersions);
-
-    while (index < CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT)
+    BridgedEndpointManager::EndpointConfig config;
+    config.endpointType       = &sBridgedNodeEndpoint;
+    config.deviceTypes        = Span<const EmberAfDeviceType>(sBridgedDeviceTypes);
+    config.dataVersionStorage = Span<DataVersion>(sBridgedNodeDataVersions);
+    config.parentEndpointId   = parentEndpointId;
+
+    DeviceLayer::StackLock lock;
+    uint16_t index;
+    CHIP_ERROR err = mEndpointManager.AddEndpoint(dev->GetNodeId(), config, index);
+    if (err != CHIP_NO_ERROR)
     {
-        if (nullptr == mDevices[index])
-        {
-            mDevices[index] = dev;
-            CHIP_ERROR err;
-            int retryCount = 0;
-            while (retryCount < kMaxRetries)
-            {
-                DeviceLayer::StackLock lock;
-                dev->SetEndpointId(mCurrentEndpointId);
-                dev->SetParentEndpointId(parentEndpointId);
-                err =
-                    emberAfSetDynamicEndpoint(index, mCurrentEndpointId, ep, dataVersionStorage, deviceTypeList, parentEndpointId);
-                if (err == CHIP_NO_ERROR)
-                {
-                    ChipLogProgress(NotSpecified,
-                                    "Added device with nodeId=0x" ChipLogFormatX64 " to dynamic endpoint %d (index=%d)",
-                                    ChipLogValueX64(dev->GetNodeId()), mCurrentEndpointId, index);
-                    return index;
-                }
-                if (err != CHIP_ERROR_ENDPOINT_EXISTS)
-                {
-                    mDevices[index] = nullptr;
-                    return -1; // Return error as endpoint addition failed due to an error other than endpoint already exists
-                }
-                // Increment the endpoint ID and handle wrap condition
-                if (++mCurrentEndpointId < mFirstDynamicEndpointId)
-                {
-                    mCurrentEndpointId = mFirstDynamicEndpointId;
-                }
-                retryCount++;
-            }
-            ChipLogError(NotSpecified, "Failed to add dynamic endpoint after %d retries", kMaxRetries);
-            mDevices[index] = nullptr;
-            return -1; // Return error as all retries are exhausted
-        }
-        index++;
+        ChipLogError(NotSpecified, "Failed to add dynamic endpoint: %" CHIP_ERROR_FORMAT, err.Format());
+        return -1;
     }
-    ChipLogProgress(NotSpecified, "Failed to add dynamic endpoint: No endpoints available!");
-    return -1;
+
+    EndpointId endpointId = mEndpointManager.GetEndpointId(index);
+    dev->SetEndpointId(endpointId);
+    dev->SetParentEndpointId(parentEndpointId);
+    mDevices[index] = dev;
+    ChipLogProgress(NotSpecified, "Added device with nodeId=0x" ChipLogFormatX64 " to dynamic endpoint %d (index=%d)",
+                    ChipLogValueX64(dev->GetNodeId()), endpointId, index);
+    return index;
 }
 
 int DeviceManager::RemoveDeviceEndpoint(Device * dev)
 {
-    uint8_t index = 0;
-    while (index < CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT)
+    DeviceLayer::StackLock lock;
+    uint16_t index = mEndpointManager.FindIndexByKey(dev->GetNodeId());
+    if (index == BridgedEndpointManager::kInvalidIndex || mDevices[index] != dev)
     {
-        if (mDevices[index] == dev)
-        {
-            DeviceLayer::StackLock lock;
-            // Silence complaints about unused ep when progress logging
-            // disabled.
-            [[maybe_unused]] EndpointId ep = emberAfClearDynamicEndpoint(index);
-            mDevices[index]                = nullptr;
-            ChipLogProgress(NotSpecified, "Removed device %s from dynamic endpoint %d (index=%d)", dev->GetName(), ep, index);
-            return index;
-        }
-        index++;
+        return -1;
     }
-    return -1;
+
+    // Silence complaints about unused ep when progress logging
+    // disabled.
+    [[maybe_unused]] EndpointId ep = mEndpointManager.RemoveEndpoint(index);
+    mDevices[index]                = nullptr;
+    ChipLogProgress(NotSpecified, "Removed device %s from dynamic endpoint %d (index=%d)", dev->GetName(), ep, index);
+    return index;
 }
 
 Device * DeviceManager::GetDevice(chip::EndpointId endpointId) const
 {
-    for (uint8_t index = 0; index < CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT; ++index)
-    {
-        if (mDevices[index] && mDevices[index]->GetEndpointId() == endpointId)
-        {
-            return mDevices[index];
-        }
-    }
-    return nullptr;
+    uint16_t index = mEndpointManager.FindIndexByEndpoint(endpointId);
+    return (index == BridgedEndpointManager::kInvalidIndex) ? nullptr : mDevices[index];
 }
 
 Device * DeviceManager::GetDeviceByNodeId(chip::NodeId nodeId) const
 {
-    for (uint8_t index = 0; index < CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT; ++index)
-    {
-        if (mDevices[index] && mDevices[index]->GetNodeId() == nodeId)
-        {
-            return mDevices[index];
-        }
-    }
-    return nullptr;
+    uint16_t index = mEndpointManager.FindIndexByKey(nodeId);
+    return (index == BridgedEndpointManager::kInvalidIndex) ? nullptr : mDevices[index];
 }
 
 int DeviceManager::RemoveDeviceByNodeId(chip::NodeId nodeId)
 {
-    for (uint8_t index = 0; index < CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT; ++index)
+    DeviceLayer::StackLock lock;
+    uint16_t index = mEndpointManager.FindIndexByKey(nodeId);
+    if (index == BridgedEndpointManager::kInvalidIndex)
     {
-        if (mDevices[index] && mDevices[index]->GetNodeId() == nodeId)
-        {
-            DeviceLayer::StackLock lock;
-            EndpointId ep   = emberAfClearDynamicEndpoint(index);
-            mDevices[index] = nullptr;
-            ChipLogProgress(NotSpecified, "Removed device with NodeId=0x" ChipLogFormatX64 " from dynamic endpoint %d (index=%d)",
-                            ChipLogValueX64(nodeId), ep, index);
-            return index;
-        }
+        return -1;
     }
-    return -1;
+
+    [[maybe_unused]] EndpointId ep = mEndpointManager.RemoveEndpoint(index);
+    mDevices[index]                = nullptr;
+    ChipLogProgress(NotSpecified, "Removed device with NodeId=0x" ChipLogFormatX64 " from dynamic endpoint %d (index=%d)",
+                    ChipLogValueX64(nodeId), ep, index);
+    return index;
 }
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <app/util/BridgedEndpointManager.h>
 #include <platform/CHIPDeviceLayer.h>
 
 #include "Device.h"
@@ -31,17 +32,18 @@ public:
      * @brief Initializes the DeviceManager.
      *
      * This function sets up the initial state of the DeviceManager, clearing
-     * any existing devices and setting the starting dynamic endpoint ID.
+     * any existing devices and starting the dynamic endpoint IDs after the last
+     * fixed endpoint.
      */
     void Init();
 
     /**
      * @brief Adds a device to a dynamic endpoint.
      *
-     * This function attempts to add a device to a dynamic endpoint. It tries to find an available
-     * endpoint slot and retries the addition process up to a specified maximum number of times if
-     * the endpoint already exists. If the addition is successful, it returns the index of the
-     * dynamic endpoint; otherwise, it returns -1.
+     * This function attempts to add a device to a dynamic endpoint, using the next free endpoint
+     * slot and endpoint ID. The device is identified by its NodeId, which must not be used by
+     * another device. If the addition is successful, it returns the index of the dynamic endpoint;
+     * otherwise, it returns -1.
      *
      * @param dev A pointer to the device to be added.
      * @param parentEndpointId The parent endpoint ID. Defaults to an invalid endpoint ID.
@@ -52,10 +54,9 @@ public:
     /**
      * @brief Removes a device from a dynamic endpoint.
      *
-     * This function attempts to remove a device from a dynamic endpoint by iterating through the
-     * available endpoints and checking if the device matches. If the device is found, it clears the
-     * dynamic endpoint, logs the removal, and returns the index of the removed endpoint.
-     * If the device is not found, it returns -1.
+     * This function attempts to remove a device from a dynamic endpoint, looking it up by its
+     * NodeId. If the device is found, it clears the dynamic endpoint, logs the removal, and returns
+     * the index of the removed endpoint. If the device is not found, it returns -1.
      *
      * @param dev A pointer to the device to be removed.
      * @return int The index of the removed dynamic endpoint if successful, -1 otherwise.
@@ -65,8 +66,8 @@ public:
     /**
      * @brief Gets a device from its endpoint ID.
      *
-     * This function iterates through the available devices and returns the device that matches the
-     * specified endpoint ID. If no device matches the endpoint ID, it returns nullptr.
+     * This function returns the device at the specified endpoint ID. If no device is at the
+     * endpoint ID, it returns nullptr.
      *
      * @param endpointId The endpoint ID of the device to be retrieved.
      * @return Device* A pointer to the device if found, nullptr otherwise.
@@ -76,8 +77,8 @@ public:
     /**
      * @brief Gets a device from its NodeId.
      *
-     * This function iterates through the available devices and returns the device that matches the
-     * specified NodeId. If no device matches the NodeId, it returns nullptr.
+     * This function returns the device that matches the specified NodeId. If no device matches the
+     * NodeId, it returns nullptr.
      *
      * @param nodeId The NodeId of the device to be retrieved.
      * @return Device* A pointer to the device if found, nullptr otherwise.
@@ -87,10 +88,9 @@ public:
     /**
      * @brief Removes a device from a dynamic endpoint by its NodeId.
      *
-     * This function attempts to remove a device from a dynamic endpoint by iterating through the
-     * available endpoints and checking if the device matches the specified NodeId. If the device is
-     * found, it clears the dynamic endpoint, logs the removal, and returns the index of the removed
-     * endpoint. If the device is not found, it returns -1.
+     * This function attempts to remove the device that matches the specified NodeId from its dynamic
+     * endpoint. If the device is found, it clears the dynamic endpoint, logs the removal, and returns
+     * the index of the removed endpoint. If the device is not found, it returns -1.
      *
      * @param nodeId The NodeId of the device to be removed.
      * @return int The index of the removed dynamic endpoint if successful, -1 otherwise.
@@ -102,8 +102,8 @@ private:
 
     static DeviceManager sInstance;
 
-    chip::EndpointId mCurrentEndpointId;
-    chip::EndpointId mFirstDynamicEndpointId;
+    // Keyed by the NodeId of the devices, at the same index as in mDevices.
+    chip::app::BridgedEndpointManager mEndpointManager;
     Device * mDevices[CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT + 1];
 };
 
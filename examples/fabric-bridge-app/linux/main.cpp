@@ -188,10 +188,9 @@ Protocols::InteractionModel::Status emberAfExternalAttributeReadCallback(Endpoin
                                                                          const EmberAfAttributeMetadata * attributeMetadata,
                                                                          uint8_t * buffer, uint16_t maxReadLength)
 {
-    uint16_t endpointIndex  = emberAfGetDynamicIndexFromEndpoint(endpoint);
     AttributeId attributeId = attributeMetadata->attributeId;
 
-    Device * dev = DeviceMgr().GetDevice(endpointIndex);
+    Device * dev = DeviceMgr().GetDevice(endpoint);
     if (dev != nullptr && clusterId == app::Clusters::BridgedDeviceBasicInformation::Id)
     {
         using namespace app::Clusters::BridgedDeviceBasicInformation::Attributes;
@@ -232,10 +231,9 @@ Protocols::InteractionModel::Status emberAfExternalAttributeWriteCallback(Endpoi
                                                                           const EmberAfAttributeMetadata * attributeMetadata,
                                                                           uint8_t * buffer)
 {
-    uint16_t endpointIndex                  = emberAfGetDynamicIndexFromEndpoint(endpoint);
     Protocols::InteractionModel::Status ret = Protocols::InteractionModel::Status::Failure;
 
-    Device * dev = DeviceMgr().GetDevice(endpointIndex);
+    Device * dev = DeviceMgr().GetDevice(endpoint);
     if (dev != nullptr && dev->IsReachable())
     {
         ChipLogProgress(NotSpecified, "emberAfExternalAttributeWriteCallback: ep=%d, clusterId=%d", endpoint, clusterId);
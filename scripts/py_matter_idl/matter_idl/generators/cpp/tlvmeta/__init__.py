@@ -20,12 +20,30 @@ from matter_idl.generators import CodeGenerator, GeneratorStorage
 from matter_idl.matter_idl_types import Cluster, Field, Idl, StructTag
 
 
+# Profile IDs of the tags used in tables, see tlv_meta.h
+_TAG_PROFILE_IDS = {
+    'ContextTag': 0xFFFFFFFF,
+    'AttributeTag': 1,
+    'CommandTag': 2,
+    'EventTag': 3,
+}
+
+# AnonymousTag() is a special tag number of the context tag profile
+_ANONYMOUS_TAG_ORDER = (0xFFFFFFFF << 32) | 0x100
+
+
+def TagOrder(tag_type: str, code: int) -> int:
+    """Key of a tag in the order of chip::TLVMeta::TagOrder."""
+    return (_TAG_PROFILE_IDS[tag_type] << 32) | code
+
+
 @dataclass
 class TableEntry:
     code: str                   # Encoding like ContextTag() or AnonymousTag() or similar
     name: str                   # human friendly name
     reference: Optional[str]    # reference to full name
     real_type: str              # real type
+    order: int                  # sort order of the tag, so that decoders can binary search
     item_type: str = 'kDefault'  # type flag for decoding
 
 
@@ -87,6 +105,7 @@ class ClusterTablesGenerator:
             name=field.name,
             reference=type_reference,
             real_type=real_type,
+            order=TagOrder(tag_type, field.code),
             item_type=item_type,
         )
 
@@ -117,7 +136,8 @@ class ClusterTablesGenerator:
                     reference="%s_%s" % (
                         self.cluster.name, c.input_param),
                     real_type="%s::%s::%s" % (
-                        self.cluster.name, c.name, c.input_param)
+                        self.cluster.name, c.name, c.input_param),
+                    order=TagOrder('CommandTag', c.code),
                 )
             else:
                 yield TableEntry(
@@ -125,7 +145,8 @@ class ClusterTablesGenerator:
                     code=f'CommandTag({c.code})',
                     reference=None,
                     real_type="%s::%s::()" % (
-                        self.cluster.name, c.name)
+                        self.cluster.name, c.name),
+                    order=TagOrder('CommandTag', c.code),
                 )
 
         # yield entries for every command output. We use "respons struct"
@@ -139,6 +160,7 @@ class ClusterTablesGenerator:
                 reference="%s_%s" % (
                     self.cluster.name, c.name),
                 real_type="%s::%s" % (self.cluster.name, c.name),
+                order=TagOrder('CommandTag', c.code),
             )
 
     def GenerateTables(self) -> Generator[Table, None, None]:
@@ -166,7 +188,8 @@ class ClusterTablesGenerator:
                 code=f'EventTag({e.code})',
                 name=e.name,
                 reference="%s_%s" % (self.cluster.name, e.name),
-                real_type='%s::%s' % (self.cluster.name, e.name)
+                real_type='%s::%s' % (self.cluster.name, e.name),
+                order=TagOrder('EventTag', e.code),
             )
             for e in self.cluster.events if e.fields
         ])
@@ -202,6 +225,7 @@ class ClusterTablesGenerator:
                         name="Anonymous<>",
                         reference=name,
                         real_type="%s[]" % name,
+                        order=_ANONYMOUS_TAG_ORDER,
                     )
                 ]
             )
@@ -215,7 +239,9 @@ class ClusterTablesGenerator:
                         name=entry.name,
                         reference=None,
                         real_type="%s::%s::%s" % (
-                            self.cluster.name, e.name, entry.name)
+                            self.cluster.name, e.name, entry.name),
+                        # ConstantValueTag(value) orders as value
+                        order=entry.code,
                     )
                     for entry in e.entries
                 ]
@@ -230,7 +256,9 @@ class ClusterTablesGenerator:
                         name=entry.name,
                         reference=None,
                         real_type="%s::%s::%s" % (
-                            self.cluster.name, e.name, entry.name)
+                            self.cluster.name, e.name, entry.name),
+                        # ConstantValueTag(value) orders as value
+                        order=entry.code,
                     )
                     for entry in e.entries
                 ]
@@ -243,6 +271,12 @@ def CreateTables(idl: Idl) -> List[Table]:
         result.extend(
             [table for table in ClusterTablesGenerator(cluster).GenerateTables()])
 
+    # Tables are marked as sorted for binary searches. The sort is stable, so
+    # that of several entries with the same tag (like a command and its
+    # response), the first one is still found first.
+    for table in result:
+        table.entries.sort(key=lambda entry: entry.order)
+
     return result
 
 
@@ -34,7 +34,8 @@ const Entry<ItemInfo> _primitive_type_list[] = {
 
 } // namespace
 
-#define _ENTRY(n) { sizeof(n) / sizeof(n[0]), n}
+// All the tables are sorted by tag (see TagOrder), for binary searches.
+#define _ENTRY(n) { sizeof(n) / sizeof(n[0]), n, true }
 
 const std::array<const Node<ItemInfo>, 3 + 2> clusters_meta = { {
   _ENTRY(_all_clusters), // 0
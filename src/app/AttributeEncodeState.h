@@ -31,6 +31,10 @@ namespace app {
 ///   - CurrentEncodingListIndex representing the list index that is next
 ///     to be encoded in the output. kInvalidListIndex means that a new list
 ///     encoding has been started.
+///   - NextGeneratedItemIndex representing the position, among all the items
+///     produced by the list generator (including the ones dropped by fabric
+///     filtering), of the item that is next to be encoded. This lets resumable
+///     list generators continue where the previous chunk stopped.
 class AttributeEncodeState
 {
 public:
@@ -49,12 +53,14 @@ public:
         else
         {
             mCurrentEncodingListIndex = kInvalidListIndex;
+            mNextGeneratedItemIndex   = 0;
             mAllowPartialData         = false;
         }
     }
 
     bool AllowPartialData() const { return mAllowPartialData; }
     ListIndex CurrentEncodingListIndex() const { return mCurrentEncodingListIndex; }
+    ListIndex NextGeneratedItemIndex() const { return mNextGeneratedItemIndex; }
 
     AttributeEncodeState & SetAllowPartialData(bool allow)
     {
@@ -68,9 +74,16 @@ public:
         return *this;
     }
 
+    AttributeEncodeState & SetNextGeneratedItemIndex(ListIndex idx)
+    {
+        mNextGeneratedItemIndex = idx;
+        return *this;
+    }
+
     void Reset()
     {
         mCurrentEncodingListIndex = kInvalidListIndex;
+        mNextGeneratedItemIndex   = 0;
         mAllowPartialData         = false;
     }
 
@@ -84,6 +97,13 @@ private:
      */
     ListIndex mCurrentEncodingListIndex = kInvalidListIndex;
 
+    /**
+     * The number of items the list generator has produced before the next item that needs to be encoded.
+     * This differs from mCurrentEncodingListIndex when a fabric filtered read drops items belonging to
+     * other fabrics.  Only meaningful when mCurrentEncodingListIndex is a valid ListIndex value.
+     */
+    ListIndex mNextGeneratedItemIndex = 0;
+
     /**
      * When an attempt to encode an attribute returns an error, the buffer may contain tailing dirty data
      * (since the put was aborted).  The report engine normally rolls back the buffer to right before encoding
@@ -60,6 +60,7 @@ CHIP_ERROR AttributeValueEncoder::EnsureListStarted()
             mAttributeReportIBsBuilder.GetWriter()->ReserveBuffer(kEndOfAttributeReportIBByteCount + kEndOfListByteCount));
 
         mEncodeState.SetCurrentEncodingListIndex(0);
+        mEncodeState.SetNextGeneratedItemIndex(0);
     }
     else
     {
@@ -69,6 +70,7 @@ CHIP_ERROR AttributeValueEncoder::EnsureListStarted()
     }
 
     mCurrentEncodingListIndex = 0;
+    mGeneratedItemIndex       = 0;
 
     // After encoding the initial list start, the remaining items are atomically encoded into the buffer. Tell report engine to not
     // revert partial data.
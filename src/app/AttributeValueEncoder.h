@@ -52,9 +52,11 @@ public:
 
             // If we are encoding for a fabric filtered attribute read and the fabric index does not match that present in the
             // request, skip encoding this list item.
-            VerifyOrReturnError(!mAttributeValueEncoder.mIsFabricFiltered ||
-                                    aArg.GetFabricIndex() == mAttributeValueEncoder.AccessingFabricIndex(),
-                                CHIP_NO_ERROR);
+            if (mAttributeValueEncoder.mIsFabricFiltered && aArg.GetFabricIndex() != mAttributeValueEncoder.AccessingFabricIndex())
+            {
+                mAttributeValueEncoder.SkipFilteredListItem();
+                return CHIP_NO_ERROR;
+            }
             return mAttributeValueEncoder.EncodeListItem(mAttributeValueEncoder.AccessingFabricIndex(), std::forward<T>(aArg));
         }
 
@@ -131,18 +133,35 @@ public:
         // values. After encoding the empty list, mEncodeState.mCurrentEncodingListIndex and mCurrentEncodingListIndex are set to 0.
         ReturnErrorOnFailure(EnsureListStarted());
         CHIP_ERROR err = aCallback(ListEncodeHelper(*this));
+        return FinishList(err);
+    }
 
-        // Even if encoding list items failed, make sure we EnsureListEnded().
-        // Since we encode list items atomically, in the case when we just
-        // didn't fit the next item we want to make sure our list is properly
-        // ended before the reporting engine starts chunking.
-        EnsureListEnded();
-        if (err == CHIP_NO_ERROR)
-        {
-            // The Encode procedure finished without any error, clear the state.
-            mEncodeState.Reset();
-        }
-        return err;
+    /**
+     * Same as EncodeList, but for lists whose items can be produced starting from an arbitrary position.
+     *
+     * aCallback is expected to take a (const auto & encoder, ListIndex startIndex) pair of arguments and Encode() on the
+     * encoder, in order, every item of the list starting with the item at position startIndex.  Positions count every item the
+     * callback would Encode() when starting from 0, including the ones that get dropped by fabric filtering.
+     *
+     * When a list does not fit in a single report and gets chunked, EncodeList has to run its callback from the start of the
+     * list for every chunk, and the items that were already sent are dropped by the encoder; for long lists this makes the total
+     * work quadratic in the list length.  With EncodeResumableList the callback resumes from the first item that still has to be
+     * encoded, so each item is produced once plus at most one retry per chunk.
+     *
+     * The list must produce the same items in the same order across chunks, exactly as required for EncodeList.
+     */
+    template <typename ListGenerator>
+    CHIP_ERROR EncodeResumableList(ListGenerator aCallback)
+    {
+        mTriedEncode = true;
+        ReturnErrorOnFailure(EnsureListStarted());
+
+        // Everything before these positions was encoded in previous chunks, so there is nothing to skip.
+        mCurrentEncodingListIndex = mEncodeState.CurrentEncodingListIndex();
+        mGeneratedItemIndex       = mEncodeState.NextGeneratedItemIndex();
+
+        CHIP_ERROR err = aCallback(ListEncodeHelper(*this), mGeneratedItemIndex);
+        return FinishList(err);
     }
 
     bool TriedEncode() const { return mTriedEncode; }
@@ -168,6 +187,7 @@ private:
     {
         // EncodeListItem must be called after EnsureListStarted(), thus mCurrentEncodingListIndex and
         // mEncodeState.mCurrentEncodingListIndex are not invalid values.
+        ListIndex generatedItemIndex = mGeneratedItemIndex++;
         if (mCurrentEncodingListIndex < mEncodeState.CurrentEncodingListIndex())
         {
             // We have encoded this element in previous chunks, skip it.
@@ -200,10 +220,45 @@ private:
 
         mCurrentEncodingListIndex++;
         mEncodeState.SetCurrentEncodingListIndex(mCurrentEncodingListIndex);
+        MarkGeneratedItemDone(generatedItemIndex);
         mEncodedAtLeastOneListItem = true;
         return CHIP_NO_ERROR;
     }
 
+    /**
+     * Accounts for a list item that the generator produced but that is not part of a fabric filtered read.
+     */
+    void SkipFilteredListItem() { MarkGeneratedItemDone(mGeneratedItemIndex++); }
+
+    /**
+     * Records that the generator does not need to produce the item at generatedItemIndex again in a later chunk.
+     */
+    void MarkGeneratedItemDone(ListIndex generatedItemIndex)
+    {
+        if (generatedItemIndex >= mEncodeState.NextGeneratedItemIndex())
+        {
+            mEncodeState.SetNextGeneratedItemIndex(static_cast<ListIndex>(generatedItemIndex + 1));
+        }
+    }
+
+    /**
+     * Common tail of EncodeList and EncodeResumableList, err is the result of the list generator.
+     */
+    CHIP_ERROR FinishList(CHIP_ERROR err)
+    {
+        // Even if encoding list items failed, make sure we EnsureListEnded().
+        // Since we encode list items atomically, in the case when we just
+        // didn't fit the next item we want to make sure our list is properly
+        // ended before the reporting engine starts chunking.
+        EnsureListEnded();
+        if (err == CHIP_NO_ERROR)
+        {
+            // The Encode procedure finished without any error, clear the state.
+            mEncodeState.Reset();
+        }
+        return err;
+    }
+
     /**
      * Builds a single AttributeReportIB in AttributeReportIBs.  The caller is
      * responsible for setting up mPath correctly.
@@ -224,7 +279,7 @@ private:
     }
 
     /**
-     * EnsureListStarted sets our mCurrentEncodingListIndex to 0, and:
+     * EnsureListStarted sets our mCurrentEncodingListIndex and mGeneratedItemIndex to 0, and:
      *
      * * If we are just starting the list, gets us ready to encode list items.
      *
@@ -252,6 +307,8 @@ private:
     // mEncodedAtLeastOneListItem becomes true once we successfully encode a list item.
     bool mEncodedAtLeastOneListItem     = false;
     ListIndex mCurrentEncodingListIndex = kInvalidListIndex;
+    // mGeneratedItemIndex is the position of the next item the list generator will produce, counting fabric filtered items.
+    ListIndex mGeneratedItemIndex = 0;
     AttributeEncodeState mEncodeState;
 };
 
@@ -19,7 +19,8 @@
 #include "system/SystemPacketBuffer.h"
 #include <app/ClusterStateCache.h>
 #include <app/InteractionModelEngine.h>
-#include <tuple>
+
+#include <algorithm>
 
 namespace chip {
 namespace app {
@@ -49,6 +50,33 @@ uint32_t SizeOfStatusIB(const StatusIB & aStatus)
 
 } // anonymous namespace
 
+template <bool CanEnableDataCaching>
+size_t ClusterStateCacheT<CanEnableDataCaching>::SizeOfAttributeState(const AttributeState & aState)
+{
+    if constexpr (CanEnableDataCaching)
+    {
+        if (aState.template Is<StatusIB>())
+        {
+            return SizeOfStatusIB(aState.template Get<StatusIB>());
+        }
+        if (aState.template Is<AttributeData>())
+        {
+            // The buffer holds exactly the TLV element of the attribute.
+            return aState.template Get<AttributeData>().AllocatedSize();
+        }
+        if (aState.template Is<uint32_t>())
+        {
+            return aState.template Get<uint32_t>();
+        }
+        // Attribute that was just added to the cluster.
+        return 0;
+    }
+    else
+    {
+        return aState;
+    }
+}
+
 template <bool CanEnableDataCaching>
 CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::GetElementTLVSize(TLV::TLVReader * apData, uint32_t & aSize)
 {
@@ -70,22 +98,13 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteD
                                                                  const StatusIB & aStatus)
 {
     AttributeState state;
-    bool endpointIsNew = false;
-
-    if (mCache.find(aPath.mEndpointId) == mCache.end())
-    {
-        //
-        // Since we might potentially be creating a new entry at mCache[aPath.mEndpointId][aPath.mClusterId] that
-        // wasn't there before, we need to check if an entry didn't exist there previously and remember that so that
-        // we can appropriately notify our clients of the addition of a new endpoint.
-        //
-        endpointIsNew = true;
-    }
+    size_t stateSize = 0;
 
     if (apData)
     {
         uint32_t elementSize = 0;
         ReturnErrorOnFailure(GetElementTLVSize(apData, elementSize));
+        stateSize = elementSize;
 
         if constexpr (CanEnableDataCaching)
         {
@@ -109,12 +128,49 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteD
         {
             state = elementSize;
         }
+    }
+    else
+    {
+        stateSize = SizeOfStatusIB(aStatus);
+
+        if constexpr (CanEnableDataCaching)
+        {
+            if (mCacheData)
+            {
+                state.template Set<StatusIB>(aStatus);
+            }
+            else
+            {
+                state.template Set<uint32_t>(SizeOfStatusIB(aStatus));
+            }
+        }
+        else
+        {
+            state = SizeOfStatusIB(aStatus);
+        }
+    }
 
+    auto endpointIter = mCache.find(aPath.mEndpointId);
+    if (endpointIter == mCache.end())
+    {
+        //
+        // if the endpoint didn't exist previously, let's track the insertion
+        // so that we can inform our callback of a new endpoint being added appropriately.
+        //
+        endpointIter = mCache.emplace(aPath.mEndpointId, EndpointState()).first;
+        mAddedEndpoints.push_back(aPath.mEndpointId);
+    }
+
+    ClusterState & clusterState = endpointIter->second[aPath.mClusterId];
+    RemoveFromFilterIndex(aPath.mEndpointId, aPath.mClusterId, clusterState);
+
+    if (apData)
+    {
         //
         // Clear out the committed data version and only set it again once we have received all data for this cluster.
         // Otherwise, we may have incomplete data that looks like it's complete since it has a valid data version.
         //
-        mCache[aPath.mEndpointId][aPath.mClusterId].mCommittedDataVersion.ClearValue();
+        clusterState.mCommittedDataVersion.ClearValue();
 
         // This commits a pending data version if the last report path is valid and it is different from the current path.
         if (mLastReportDataPath.IsValidConcreteClusterPath() && mLastReportDataPath != aPath)
@@ -135,44 +191,21 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::UpdateCache(const ConcreteD
         // if this data item is encompassed by a wildcard path, let's go ahead and update its pending data version.
         if (foundEncompassingWildcardPath)
         {
-            mCache[aPath.mEndpointId][aPath.mClusterId].mPendingDataVersion = aPath.mDataVersion;
+            clusterState.mPendingDataVersion = aPath.mDataVersion;
         }
 
         mLastReportDataPath = aPath;
     }
-    else
-    {
-        if constexpr (CanEnableDataCaching)
-        {
-            if (mCacheData)
-            {
-                state.template Set<StatusIB>(aStatus);
-            }
-            else
-            {
-                state.template Set<uint32_t>(SizeOfStatusIB(aStatus));
-            }
-        }
-        else
-        {
-            state = SizeOfStatusIB(aStatus);
-        }
-    }
 
-    //
-    // if the endpoint didn't exist previously, let's track the insertion
-    // so that we can inform our callback of a new endpoint being added appropriately.
-    //
-    if (endpointIsNew)
-    {
-        mAddedEndpoints.push_back(aPath.mEndpointId);
-    }
+    AttributeState & attributeState = clusterState.mAttributes[aPath.mAttributeId];
+    clusterState.mSize              = clusterState.mSize - SizeOfAttributeState(attributeState) + stateSize;
+    attributeState                  = std::move(state);
 
-    mCache[aPath.mEndpointId][aPath.mClusterId].mAttributes[aPath.mAttributeId] = std::move(state);
+    AddToFilterIndex(aPath.mEndpointId, aPath.mClusterId, clusterState);
 
     if (mCacheData)
     {
-        mChangedAttributeSet.insert(aPath);
+        mChangedAttributes.push_back(aPath);
     }
 
     return CHIP_NO_ERROR;
@@ -231,7 +264,7 @@ template <bool CanEnableDataCaching>
 void ClusterStateCacheT<CanEnableDataCaching>::OnReportBegin()
 {
     mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
-    mChangedAttributeSet.clear();
+    mChangedAttributes.clear();
     mAddedEndpoints.clear();
     mCallback.OnReportBegin();
 }
@@ -247,8 +280,10 @@ void ClusterStateCacheT<CanEnableDataCaching>::CommitPendingDataVersion()
     auto & lastClusterInfo = mCache[mLastReportDataPath.mEndpointId][mLastReportDataPath.mClusterId];
     if (lastClusterInfo.mPendingDataVersion.HasValue())
     {
+        RemoveFromFilterIndex(mLastReportDataPath.mEndpointId, mLastReportDataPath.mClusterId, lastClusterInfo);
         lastClusterInfo.mCommittedDataVersion = lastClusterInfo.mPendingDataVersion;
         lastClusterInfo.mPendingDataVersion.ClearValue();
+        AddToFilterIndex(mLastReportDataPath.mEndpointId, mLastReportDataPath.mClusterId, lastClusterInfo);
     }
 }
 
@@ -257,21 +292,27 @@ void ClusterStateCacheT<CanEnableDataCaching>::OnReportEnd()
 {
     CommitPendingDataVersion();
     mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
-    std::set<std::tuple<EndpointId, ClusterId>> changedClusters;
 
     //
-    // Add the EndpointId and ClusterId into a set so that we only
-    // convey unique combinations in the subsequent OnClusterChanged callback.
+    // Attributes are ordered by endpoint and cluster first, so that each changed cluster is a run of
+    // adjacent paths and is only conveyed once in the OnClusterChanged callback.
     //
-    for (auto & path : mChangedAttributeSet)
+    std::sort(mChangedAttributes.begin(), mChangedAttributes.end());
+    mChangedAttributes.erase(std::unique(mChangedAttributes.begin(), mChangedAttributes.end()), mChangedAttributes.end());
+
+    for (auto & path : mChangedAttributes)
     {
         mCallback.OnAttributeChanged(this, path);
-        changedClusters.insert(std::make_tuple(path.mEndpointId, path.mClusterId));
     }
 
-    for (auto & item : changedClusters)
+    for (size_t i = 0; i < mChangedAttributes.size(); i++)
     {
-        mCallback.OnClusterChanged(this, std::get<0>(item), std::get<1>(item));
+        const ConcreteAttributePath & path = mChangedAttributes[i];
+        if (i == 0 || mChangedAttributes[i - 1].mEndpointId != path.mEndpointId ||
+            mChangedAttributes[i - 1].mClusterId != path.mClusterId)
+        {
+            mCallback.OnClusterChanged(this, path.mEndpointId, path.mClusterId);
+        }
     }
 
     for (auto endpoint : mAddedEndpoints)
@@ -499,70 +540,26 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::GetStatus(const ConcreteEve
 }
 
 template <bool CanEnableDataCaching>
-void ClusterStateCacheT<CanEnableDataCaching>::GetSortedFilters(std::vector<std::pair<DataVersionFilter, size_t>> & aVector) const
+void ClusterStateCacheT<CanEnableDataCaching>::RemoveFromFilterIndex(EndpointId aEndpointId, ClusterId aClusterId,
+                                                                     const ClusterState & aClusterState)
 {
-    for (auto const & endpointIter : mCache)
+    if (aClusterState.mCommittedDataVersion.HasValue() && aClusterState.mSize > 0)
     {
-        EndpointId endpointId = endpointIter.first;
-        for (auto const & clusterIter : endpointIter.second)
-        {
-            if (!clusterIter.second.mCommittedDataVersion.HasValue())
-            {
-                continue;
-            }
-            DataVersion dataVersion = clusterIter.second.mCommittedDataVersion.Value();
-            size_t clusterSize      = 0;
-            ClusterId clusterId     = clusterIter.first;
-
-            for (auto const & attributeIter : clusterIter.second.mAttributes)
-            {
-                if constexpr (CanEnableDataCaching)
-                {
-                    if (attributeIter.second.template Is<StatusIB>())
-                    {
-                        clusterSize += SizeOfStatusIB(attributeIter.second.template Get<StatusIB>());
-                    }
-                    else if (attributeIter.second.template Is<uint32_t>())
-                    {
-                        clusterSize += attributeIter.second.template Get<uint32_t>();
-                    }
-                    else
-                    {
-                        VerifyOrDie(attributeIter.second.template Is<AttributeData>());
-                        TLV::TLVReader bufReader;
-                        bufReader.Init(attributeIter.second.template Get<AttributeData>().Get(),
-                                       attributeIter.second.template Get<AttributeData>().AllocatedSize());
-                        ReturnOnFailure(bufReader.Next());
-                        // Skip to the end of the element.
-                        ReturnOnFailure(bufReader.Skip());
-
-                        // Compute the amount of value data
-                        clusterSize += bufReader.GetLengthRead();
-                    }
-                }
-                else
-                {
-                    clusterSize += attributeIter.second;
-                }
-            }
-
-            if (clusterSize == 0)
-            {
-                // No data in this cluster, so no point in sending a dataVersion
-                // along at all.
-                continue;
-            }
-
-            DataVersionFilter filter(endpointId, clusterId, dataVersion);
-
-            aVector.push_back(std::make_pair(filter, clusterSize));
-        }
+        DataVersionFilter filter(aEndpointId, aClusterId, aClusterState.mCommittedDataVersion.Value());
+        mFilterIndex.erase(std::make_pair(filter, aClusterState.mSize));
     }
+}
 
-    std::sort(aVector.begin(), aVector.end(),
-              [](const std::pair<DataVersionFilter, size_t> & x, const std::pair<DataVersionFilter, size_t> & y) {
-                  return x.second > y.second;
-              });
+template <bool CanEnableDataCaching>
+void ClusterStateCacheT<CanEnableDataCaching>::AddToFilterIndex(EndpointId aEndpointId, ClusterId aClusterId,
+                                                                const ClusterState & aClusterState)
+{
+    // No data in this cluster, so no point in sending a dataVersion along at all.
+    if (aClusterState.mCommittedDataVersion.HasValue() && aClusterState.mSize > 0)
+    {
+        DataVersionFilter filter(aEndpointId, aClusterId, aClusterState.mCommittedDataVersion.Value());
+        mFilterIndex.insert(std::make_pair(filter, aClusterState.mSize));
+    }
 }
 
 template <bool CanEnableDataCaching>
@@ -603,11 +600,8 @@ CHIP_ERROR ClusterStateCacheT<CanEnableDataCaching>::OnUpdateDataVersionFilterLi
         }
     }
 
-    std::vector<std::pair<DataVersionFilter, size_t>> filterVector;
-    GetSortedFilters(filterVector);
-
     aEncodedDataVersionList = false;
-    for (auto & filter : filterVector)
+    for (auto & filter : mFilterIndex)
     {
         bool intersected = false;
         aDataVersionFilterIBsBuilder.Checkpoint(backup);
@@ -32,6 +32,7 @@
 #include <map>
 #include <queue>
 #include <set>
+#include <tuple>
 #include <vector>
 
 #if CHIP_CONFIG_ENABLE_READ_CLIENT
@@ -551,11 +552,15 @@ private:
     // mCurrentDataVersion represents a known data version for a cluster.  In order for this to have a
     // value the cluster must be included in a path in mRequestPathSet that has a wildcard attribute
     // and we must not be in the middle of receiving reports for that cluster.
+    //
+    // mSize is the total size of the attribute states, kept up to date as they are replaced so that the
+    // data version filters do not need to be recomputed from the attributes on every resubscription.
     struct ClusterState
     {
         std::map<AttributeId, AttributeState> mAttributes;
         Optional<DataVersion> mPendingDataVersion;
         Optional<DataVersion> mCommittedDataVersion;
+        size_t mSize = 0;
     };
     using EndpointState = std::map<ClusterId, ClusterState>;
     using NodeState     = std::map<EndpointId, EndpointState>;
@@ -568,6 +573,25 @@ private:
         }
     };
 
+    using FilterEntry = std::pair<DataVersionFilter, size_t>;
+
+    //
+    // Orders the data version filters from largest to smallest by the total size of the TLV payload for the
+    // filter's cluster.  Applying filters in this order should maximize space savings on the wire if not all
+    // filters can be applied.  Clusters of the same size are ordered by path, so that entries are unique.
+    //
+    struct FilterEntryCompare
+    {
+        bool operator()(const FilterEntry & x, const FilterEntry & y) const
+        {
+            if (x.second != y.second)
+            {
+                return x.second > y.second;
+            }
+            return std::tie(x.first.mEndpointId, x.first.mClusterId) < std::tie(y.first.mEndpointId, y.first.mClusterId);
+        }
+    };
+
     using EventData = std::pair<EventHeader, System::PacketBufferHandle>;
 
     //
@@ -664,16 +688,21 @@ private:
     // Commit the pending cluster data version, if there is one.
     void CommitPendingDataVersion();
 
-    // Get our list of data version filters, sorted from larges to smallest by the total size of the TLV
-    // payload for the filter's cluster.  Applying filters in this order should maximize space savings
-    // on the wire if not all filters can be applied.
-    void GetSortedFilters(std::vector<std::pair<DataVersionFilter, size_t>> & aVector) const;
+    // A cluster has an entry in mFilterIndex while it has a committed data version and some data.  These are
+    // called around every change to the data version or the size of a cluster.
+    void RemoveFromFilterIndex(EndpointId aEndpointId, ClusterId aClusterId, const ClusterState & aClusterState);
+    void AddToFilterIndex(EndpointId aEndpointId, ClusterId aClusterId, const ClusterState & aClusterState);
 
     CHIP_ERROR GetElementTLVSize(TLV::TLVReader * apData, uint32_t & aSize);
 
+    // Size that an attribute state accounts for in the size of its cluster.
+    static size_t SizeOfAttributeState(const AttributeState & aState);
+
     Callback & mCallback;
     NodeState mCache;
-    std::set<ConcreteAttributePath> mChangedAttributeSet;
+    // Attributes changed by the current report, in arrival order; sorted and deduplicated at the end of the report.
+    std::vector<ConcreteAttributePath> mChangedAttributes;
+    std::set<FilterEntry, FilterEntryCompare> mFilterIndex;
     std::set<AttributePathParams, Comparator> mRequestPathSet; // wildcard attribute request path only
     std::vector<EndpointId> mAddedEndpoints;
 
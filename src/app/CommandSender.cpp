@@ -20,6 +20,7 @@
 #include "StatusResponse.h"
 #include <app/InteractionModelTimeout.h>
 #include <app/TimedRequest.h>
+#include <crypto/CHIPCryptoPAL.h>
 #include <platform/LockTracker.h>
 #include <protocols/Protocols.h>
 #include <protocols/interaction_model/Constants.h>
@@ -86,18 +87,20 @@ CHIP_ERROR CommandSender::AllocateBuffer()
     {
         mCommandMessageWriter.Reset();
 
-        System::PacketBufferHandle commandPacket;
-        if (mAllowLargePayload)
-        {
-            commandPacket = System::PacketBufferHandle::New(kMaxLargeSecureSduLengthBytes);
-        }
-        else
+        size_t maxSduLength = mAllowLargePayload ? kMaxLargeSecureSduLengthBytes : kMaxSecureSduLengthBytes;
+        System::PacketBufferHandle commandPacket = System::PacketBufferHandle::New(maxSduLength);
+        VerifyOrReturnError(!commandPacket.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+        // Always limit the size of the packet to fit within maxSduLength regardless of the available buffer capacity, and
+        // reserve space for the MIC field, so that a message filled up with commands can still be sent.
+        size_t reservedSize = Crypto::CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
+        if (commandPacket->AvailableDataLength() > maxSduLength)
         {
-            commandPacket = System::PacketBufferHandle::New(kMaxSecureSduLengthBytes);
+            reservedSize += commandPacket->AvailableDataLength() - maxSduLength;
         }
-        VerifyOrReturnError(!commandPacket.IsNull(), CHIP_ERROR_NO_MEMORY);
 
         mCommandMessageWriter.Init(std::move(commandPacket));
+        ReturnErrorOnFailure(mCommandMessageWriter.ReserveBuffer(static_cast<uint32_t>(reservedSize)));
         ReturnErrorOnFailure(mInvokeRequestBuilder.InitWithEndBufferReserved(&mCommandMessageWriter));
 
         mInvokeRequestBuilder.SuppressResponse(mSuppressResponse).TimedRequest(mTimedRequest);
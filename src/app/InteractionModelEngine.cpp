@@ -44,18 +44,6 @@
 namespace chip {
 namespace app {
 
-class AutoReleaseSubscriptionInfoIterator
-{
-public:
-    AutoReleaseSubscriptionInfoIterator(SubscriptionResumptionStorage::SubscriptionInfoIterator * iterator) : mIterator(iterator){};
-    ~AutoReleaseSubscriptionInfoIterator() { mIterator->Release(); }
-
-    SubscriptionResumptionStorage::SubscriptionInfoIterator * operator->() const { return mIterator; }
-
-private:
-    SubscriptionResumptionStorage::SubscriptionInfoIterator * mIterator;
-};
-
 using Protocols::InteractionModel::Status;
 
 Global<InteractionModelEngine> sInteractionModelEngine;
@@ -81,6 +69,15 @@ CHIP_ERROR InteractionModelEngine::Init(Messaging::ExchangeManager * apExchangeM
     mpSubscriptionResumptionStorage = subscriptionResumptionStorage;
     mReportScheduler                = reportScheduler;
 
+#if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+    mSubscriptionResumptionScheduler.Shutdown();
+    if (mpSubscriptionResumptionStorage != nullptr)
+    {
+        ReturnErrorOnFailure(
+            mSubscriptionResumptionScheduler.Init(this, mReportScheduler->GetTimerDelegate(), mpSubscriptionResumptionStorage));
+    }
+#endif // CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+
     ReturnErrorOnFailure(mpFabricTable->AddFabricDelegate(this));
     ReturnErrorOnFailure(mpExchangeMgr->RegisterUnsolicitedMessageHandlerForProtocol(Protocols::InteractionModel::Id, this));
 
@@ -94,6 +91,9 @@ CHIP_ERROR InteractionModelEngine::Init(Messaging::ExchangeManager * apExchangeM
 void InteractionModelEngine::Shutdown()
 {
     mpExchangeMgr->GetSessionManager()->SystemLayer()->CancelTimer(ResumeSubscriptionsTimerCallback, this);
+#if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+    mSubscriptionResumptionScheduler.Shutdown();
+#endif // CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
 
     CommandHandlerInterface * handlerIter = mCommandHandlerList;
 
@@ -1892,6 +1892,11 @@ void InteractionModelEngine::OnFabricRemoved(const FabricTable & fabricTable, Fa
     }
 #endif // CHIP_CONFIG_ENABLE_READ_CLIENT
 
+#if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+    // The persisted subscriptions of the fabric are deleted along with it; do not resume them.
+    mSubscriptionResumptionScheduler.CancelResumptions(fabricIndex);
+#endif // CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+
     for (auto & handler : mWriteHandlers)
     {
         if (!(handler.IsFree()) && handler.GetAccessingFabricIndex() == fabricIndex)
@@ -1915,35 +1920,19 @@ CHIP_ERROR InteractionModelEngine::ResumeSubscriptions()
     ReturnErrorCodeIf(mSubscriptionResumptionScheduled, CHIP_NO_ERROR);
 #endif
 
-    // To avoid the case of a reboot loop causing rapid traffic generation / power consumption, subscription resumption should make
-    // use of the persisted min-interval values, and wait before resumption. Ideally, each persisted subscription should wait their
-    // own min-interval value before resumption, but that both A) potentially runs into a timer resource issue, and B) having a
-    // low-powered device wake many times also has energy use implications. The logic below waits the largest of the persisted
-    // min-interval values before resuming subscriptions.
-
-    // Even though this causes subscription-to-subscription interaction by linking the min-interval values, this is the right thing
-    // to do for now because it's both simple and avoids the timer resource and multiple-wake problems. This issue is to track
-    // future improvements: https://github.com/project-chip/connectedhomeip/issues/25439
-
-    SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo;
-    auto * iterator             = mpSubscriptionResumptionStorage->IterateSubscriptions();
-    mNumOfSubscriptionsToResume = 0;
-    uint16_t minInterval        = 0;
-    while (iterator->Next(subscriptionInfo))
-    {
-        mNumOfSubscriptionsToResume++;
-        minInterval = std::max(minInterval, subscriptionInfo.mMinInterval);
-    }
-    iterator->Release();
+    // To avoid the case of a reboot loop causing rapid traffic generation / power consumption, each persisted subscription waits
+    // its own min-interval value before resumption. The scheduler runs a single timer for all of them, batches the resumptions
+    // that are due together and caps the number of concurrent CASE establishments, so that a device with many persisted
+    // subscriptions neither wakes once per subscription nor floods the network right after boot.
+    ReturnErrorOnFailure(
+        mSubscriptionResumptionScheduler.ScheduleResumptions(true /* waitMinInterval */, mNumOfSubscriptionsToResume));
 
     if (mNumOfSubscriptionsToResume)
     {
 #if CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
         mSubscriptionResumptionScheduled = true;
 #endif
-        ChipLogProgress(InteractionModel, "Resuming %d subscriptions in %u seconds", mNumOfSubscriptionsToResume, minInterval);
-        ReturnErrorOnFailure(mpExchangeMgr->GetSessionManager()->SystemLayer()->StartTimer(System::Clock::Seconds16(minInterval),
-                                                                                           ResumeSubscriptionsTimerCallback, this));
+        ChipLogProgress(InteractionModel, "Resuming %u subscriptions", mNumOfSubscriptionsToResume);
     }
     else
     {
@@ -1961,49 +1950,21 @@ void InteractionModelEngine::ResumeSubscriptionsTimerCallback(System::Layer * ap
     InteractionModelEngine * imEngine = static_cast<InteractionModelEngine *>(apAppState);
 #if CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
     imEngine->mSubscriptionResumptionScheduled = false;
-    bool resumedSubscriptions                  = false;
 #endif // CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
-    SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo;
-    AutoReleaseSubscriptionInfoIterator iterator(imEngine->mpSubscriptionResumptionStorage->IterateSubscriptions());
-    while (iterator->Next(subscriptionInfo))
-    {
-        // If subscription happens between reboot and this timer callback, it's already live and should skip resumption
-        if (Loop::Break == imEngine->mReadHandlers.ForEachActiveObject([&](ReadHandler * handler) {
-                SubscriptionId subscriptionId;
-                handler->GetSubscriptionId(subscriptionId);
-                if (subscriptionId == subscriptionInfo.mSubscriptionId)
-                {
-                    return Loop::Break;
-                }
-                return Loop::Continue;
-            }))
-        {
-            ChipLogProgress(InteractionModel, "Skip resuming live subscriptionId %" PRIu32, subscriptionInfo.mSubscriptionId);
-            continue;
-        }
 
-        auto subscriptionResumptionSessionEstablisher = Platform::MakeUnique<SubscriptionResumptionSessionEstablisher>();
-        if (subscriptionResumptionSessionEstablisher == nullptr)
-        {
-            ChipLogProgress(InteractionModel, "Failed to create SubscriptionResumptionSessionEstablisher");
-            return;
-        }
-
-        if (subscriptionResumptionSessionEstablisher->ResumeSubscription(*imEngine->mpCASESessionMgr, subscriptionInfo) !=
-            CHIP_NO_ERROR)
-        {
-            ChipLogProgress(InteractionModel, "Failed to ResumeSubscription 0x%" PRIx32, subscriptionInfo.mSubscriptionId);
-            return;
-        }
-        subscriptionResumptionSessionEstablisher.release();
-#if CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
-        resumedSubscriptions = true;
-#endif // CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
+    // Retries do not wait for the min-interval again; the scheduler still paces them.
+    uint16_t numSubscriptionsToResume = 0;
+    CHIP_ERROR err =
+        imEngine->mSubscriptionResumptionScheduler.ScheduleResumptions(false /* waitMinInterval */, numSubscriptionsToResume);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(InteractionModel, "Failed to schedule subscription resumption: %" CHIP_ERROR_FORMAT, err.Format());
+        return;
     }
 
 #if CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
     // If no persisted subscriptions needed resumption then all resumption retries are done
-    if (!resumedSubscriptions)
+    if (numSubscriptionsToResume == 0)
     {
         imEngine->mNumSubscriptionResumptionRetries = 0;
     }
@@ -2012,6 +1973,36 @@ void InteractionModelEngine::ResumeSubscriptionsTimerCallback(System::Layer * ap
 #endif // CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
 }
 
+bool InteractionModelEngine::IsSubscriptionActive(SubscriptionId subscriptionId)
+{
+    return Loop::Break == mReadHandlers.ForEachActiveObject([subscriptionId](ReadHandler * handler) {
+               SubscriptionId handlerSubscriptionId;
+               handler->GetSubscriptionId(handlerSubscriptionId);
+               return (handlerSubscriptionId == subscriptionId) ? Loop::Break : Loop::Continue;
+           });
+}
+
+CHIP_ERROR
+InteractionModelEngine::StartSubscriptionResumption(const SubscriptionResumptionStorage::SubscriptionInfo & subscriptionInfo)
+{
+#if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+    VerifyOrReturnError(mpCASESessionMgr != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+#if CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
+    // The scheduled resumption is under way: failed attempts may now schedule a retry.
+    mSubscriptionResumptionScheduled = false;
+#endif // CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
+
+    auto subscriptionResumptionSessionEstablisher = Platform::MakeUnique<SubscriptionResumptionSessionEstablisher>();
+    VerifyOrReturnError(subscriptionResumptionSessionEstablisher != nullptr, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(subscriptionResumptionSessionEstablisher->ResumeSubscription(*mpCASESessionMgr, subscriptionInfo));
+    subscriptionResumptionSessionEstablisher.release();
+    return CHIP_NO_ERROR;
+#else
+    return CHIP_ERROR_NOT_IMPLEMENTED;
+#endif // CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+}
+
 #if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS && CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
 uint32_t InteractionModelEngine::ComputeTimeSecondsTillNextSubscriptionResumption()
 {
@@ -2041,15 +2032,7 @@ bool InteractionModelEngine::HasSubscriptionsToResume()
     bool foundSubscriptionToResume = false;
     while (iterator->Next(subscriptionInfo))
     {
-        if (Loop::Break == mReadHandlers.ForEachActiveObject([&](ReadHandler * handler) {
-                SubscriptionId subscriptionId;
-                handler->GetSubscriptionId(subscriptionId);
-                if (subscriptionId == subscriptionInfo.mSubscriptionId)
-                {
-                    return Loop::Break;
-                }
-                return Loop::Continue;
-            }))
+        if (IsSubscriptionActive(subscriptionInfo.mSubscriptionId))
         {
             continue;
         }
@@ -2080,6 +2063,11 @@ void InteractionModelEngine::DecrementNumSubscriptionsToResume()
     }
 #endif // CHIP_CONFIG_ENABLE_ICD_CIP && !CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
 }
+
+void InteractionModelEngine::OnSubscriptionResumptionAttemptDone(SubscriptionId subscriptionId)
+{
+    mSubscriptionResumptionScheduler.OnResumptionAttemptDone(subscriptionId);
+}
 #endif // CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
 
 } // namespace app
@@ -45,6 +45,7 @@
 #include <app/ReadClient.h>
 #include <app/ReadHandler.h>
 #include <app/StatusResponse.h>
+#include <app/SubscriptionResumptionScheduler.h>
 #include <app/SubscriptionResumptionSessionEstablisher.h>
 #include <app/SubscriptionsInfoProvider.h>
 #include <app/TimedHandler.h>
@@ -92,7 +93,8 @@ class InteractionModelEngine : public Messaging::UnsolicitedMessageHandler,
                                public FabricTable::Delegate,
                                public SubscriptionsInfoProvider,
                                public TimedHandlerDelegate,
-                               public WriteHandlerDelegate
+                               public WriteHandlerDelegate,
+                               public SubscriptionResumptionScheduler::Delegate
 {
 public:
     /**
@@ -329,6 +331,12 @@ public:
      *        was succesful or not.
      */
     void DecrementNumSubscriptionsToResume();
+
+    /**
+     * @brief Lets the resumption scheduler start its next resumptions.  This should be called once a re-subscribe attempt
+     *        started by the scheduler is over, whether the attempt was successful or not.
+     */
+    void OnSubscriptionResumptionAttemptDone(SubscriptionId subscriptionId);
 #endif // CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
 
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
@@ -424,6 +432,10 @@ private:
 
     void TryToResumeSubscriptions();
 
+    // SubscriptionResumptionScheduler::Delegate
+    bool IsSubscriptionActive(SubscriptionId subscriptionId) override;
+    CHIP_ERROR StartSubscriptionResumption(const SubscriptionResumptionStorage::SubscriptionInfo & subscriptionInfo) override;
+
     ReadHandler::ApplicationCallback * GetAppCallback() override { return mpReadHandlerApplicationCallback; }
 
     InteractionModelEngine * GetInteractionModelEngine() override { return this; }
@@ -681,11 +693,12 @@ private:
 #if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
     /**
      * mNumOfSubscriptionsToResume tracks the number of subscriptions that the device will try to resume at its next resumption
-     * attempt. At boot up, the attempt will be at the highest min interval of all the subscriptions to resume.
+     * attempt. At boot up, each subscription is resumed after its own min interval, paced by mSubscriptionResumptionScheduler.
      * When the subscription timeout resumption feature is present, after the boot up attempt, the next attempt will be determined
      * by ComputeTimeSecondsTillNextSubscriptionResumption.
      */
-    int8_t mNumOfSubscriptionsToResume = 0;
+    uint16_t mNumOfSubscriptionsToResume = 0;
+    SubscriptionResumptionScheduler mSubscriptionResumptionScheduler;
 #if CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
     bool HasSubscriptionsToResume();
     uint32_t ComputeTimeSecondsTillNextSubscriptionResumption();
@@ -0,0 +1,271 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "PipelinedCommandSender.h"
+
+#include <algorithm>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+namespace chip {
+namespace app {
+
+CHIP_ERROR PipelinedCommandSender::Start(const SessionHandle & aSession, size_t aRequestCount, const Parameters & aParameters)
+{
+    VerifyOrReturnError(!mRunning, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(mpCallback != nullptr && mpRequestSource != nullptr && mpExchangeMgr != nullptr,
+                        CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(aRequestCount > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(aParameters.remoteMaxPathsPerInvoke > 0 && aParameters.maxMessagesInFlight > 0,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+#if CHIP_CONFIG_COMMAND_SENDER_BUILTIN_SUPPORT_FOR_BATCHED_COMMANDS
+    uint16_t pathsPerMessage = aParameters.remoteMaxPathsPerInvoke;
+#else
+    uint16_t pathsPerMessage = 1;
+#endif // CHIP_CONFIG_COMMAND_SENDER_BUILTIN_SUPPORT_FOR_BATCHED_COMMANDS
+
+    VerifyOrReturnError(mAnswered.Calloc(kMaxMessagesInFlight * pathsPerMessage), CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(mSession.Grab(aSession), CHIP_ERROR_INCORRECT_STATE);
+
+    mParameters                     = aParameters;
+    mParameters.maxMessagesInFlight = std::min(aParameters.maxMessagesInFlight, kMaxMessagesInFlight);
+    mPathsPerMessage                = pathsPerMessage;
+    mRequestCount                   = aRequestCount;
+    mNextRequest                    = 0;
+    mMessagesInFlight               = 0;
+    mRunning                        = true;
+
+    ChipLogDetail(DataManagement, "Pipelining %u invokes, %u per message, %u messages in flight",
+                  static_cast<unsigned>(mRequestCount), mPathsPerMessage, static_cast<unsigned>(mParameters.maxMessagesInFlight));
+
+    // This may call OnDone, so it must come last.
+    FillPipeline();
+    return CHIP_NO_ERROR;
+}
+
+void PipelinedCommandSender::Abort()
+{
+    for (auto & message : mMessages)
+    {
+        // Destroying a CommandSender aborts its exchange without calling back.
+        message.sender.reset();
+    }
+    mMessagesInFlight = 0;
+    mRunning          = false;
+    mSession.Release();
+}
+
+PipelinedCommandSender::Message * PipelinedCommandSender::FindMessage(const CommandSender * apCommandSender)
+{
+    for (auto & message : mMessages)
+    {
+        if (message.sender.get() == apCommandSender)
+        {
+            return &message;
+        }
+    }
+    return nullptr;
+}
+
+bool * PipelinedCommandSender::GetAnsweredFlags(const Message & aMessage)
+{
+    return &mAnswered[static_cast<size_t>(&aMessage - mMessages) * mPathsPerMessage];
+}
+
+void PipelinedCommandSender::FillPipeline()
+{
+    // Failing a message reports to the application, which is not allowed to start filling the pipeline again from there.
+    VerifyOrReturn(!mFilling);
+    mFilling = true;
+
+    while (mRunning && mNextRequest < mRequestCount && mMessagesInFlight < mParameters.maxMessagesInFlight)
+    {
+        Message * message = FindMessage(nullptr);
+        VerifyOrDie(message != nullptr);
+
+        CHIP_ERROR err = BuildMessage(*message);
+        if (err == CHIP_NO_ERROR && message->addedCount == 0)
+        {
+            // Every request the message would have carried failed to be added, and has been reported already.
+            message->sender.reset();
+            continue;
+        }
+
+        if (err == CHIP_NO_ERROR)
+        {
+            Optional<SessionHandle> session = mSession.Get();
+            err = session.HasValue() ? message->sender->SendCommandRequest(session.Value(), mParameters.responseTimeout)
+                                     : CHIP_ERROR_MISSING_SECURE_SESSION;
+        }
+
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DataManagement, "Failed to send pipelined invoke: %" CHIP_ERROR_FORMAT, err.Format());
+            // The CommandSender does not call OnDone when sending fails.
+            FailMessage(*message, err);
+            message->sender.reset();
+            continue;
+        }
+
+        mMessagesInFlight++;
+    }
+
+    mFilling = false;
+
+    if (mRunning && mMessagesInFlight == 0 && mNextRequest == mRequestCount)
+    {
+        mRunning = false;
+        mSession.Release();
+        // The application may destroy us from there.
+        mpCallback->OnDone(*this);
+    }
+}
+
+CHIP_ERROR PipelinedCommandSender::BuildMessage(Message & aMessage)
+{
+    CHIP_ERROR err  = CHIP_NO_ERROR;
+    bool * answered = GetAnsweredFlags(aMessage);
+    CommandSender::ConfigParameters config;
+
+    aMessage.firstRequest = mNextRequest;
+    aMessage.requestCount = 0;
+    aMessage.addedCount   = 0;
+
+    aMessage.sender = Platform::MakeUnique<CommandSender>(static_cast<CommandSender::ExtendableCallback *>(this), mpExchangeMgr,
+                                                          mParameters.timedInvokeTimeoutMs.HasValue());
+    VerifyOrExit(aMessage.sender, err = CHIP_ERROR_NO_MEMORY);
+
+    config.SetRemoteMaxPathsPerInvoke(mPathsPerMessage);
+    SuccessOrExit(err = aMessage.sender->SetCommandSenderConfig(config));
+
+    while (mNextRequest < mRequestCount && aMessage.requestCount < mPathsPerMessage)
+    {
+        uint16_t offset = aMessage.requestCount;
+
+        CommandSender::AddRequestDataParameters params(mParameters.timedInvokeTimeoutMs);
+        if (mPathsPerMessage > 1)
+        {
+            params.SetCommandRef(offset);
+        }
+
+        CHIP_ERROR addErr = mpRequestSource->AddRequest(mNextRequest, *aMessage.sender, params);
+        if ((addErr == CHIP_ERROR_NO_MEMORY || addErr == CHIP_ERROR_BUFFER_TOO_SMALL) && aMessage.addedCount > 0)
+        {
+            // The message is full; this request goes into the next one.
+            break;
+        }
+
+        aMessage.requestCount++;
+        mNextRequest++;
+
+        if (addErr != CHIP_NO_ERROR)
+        {
+            answered[offset] = true;
+            mpCallback->OnError(*this, aMessage.firstRequest + offset, addErr);
+            continue;
+        }
+
+        answered[offset] = false;
+        aMessage.addedCount++;
+    }
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        // Fail the next request along with the message, so that the pipeline keeps moving.
+        answered[0]           = false;
+        aMessage.requestCount = 1;
+        mNextRequest++;
+    }
+    return err;
+}
+
+void PipelinedCommandSender::FailMessage(Message & aMessage, CHIP_ERROR aError)
+{
+    bool * answered = GetAnsweredFlags(aMessage);
+    for (uint16_t offset = 0; offset < aMessage.requestCount; offset++)
+    {
+        if (!answered[offset])
+        {
+            answered[offset] = true;
+            mpCallback->OnError(*this, aMessage.firstRequest + offset, aError);
+        }
+    }
+}
+
+void PipelinedCommandSender::OnResponse(CommandSender * apCommandSender, const CommandSender::ResponseData & aResponseData)
+{
+    Message * message = FindMessage(apCommandSender);
+    VerifyOrReturn(message != nullptr);
+
+    // Without batching, the response to the single request of the message may not carry a command reference.
+    uint16_t offset = aResponseData.commandRef.ValueOr(0);
+    VerifyOrReturn(offset < message->requestCount);
+
+    bool * answered = GetAnsweredFlags(*message);
+    VerifyOrReturn(!answered[offset]);
+    answered[offset] = true;
+    mpCallback->OnResponse(*this, message->firstRequest + offset, aResponseData);
+}
+
+void PipelinedCommandSender::OnNoResponse(CommandSender * apCommandSender, const CommandSender::NoResponseData & aNoResponseData)
+{
+    Message * message = FindMessage(apCommandSender);
+    VerifyOrReturn(message != nullptr);
+    VerifyOrReturn(aNoResponseData.commandRef < message->requestCount);
+
+    bool * answered = GetAnsweredFlags(*message);
+    VerifyOrReturn(!answered[aNoResponseData.commandRef]);
+    answered[aNoResponseData.commandRef] = true;
+    mpCallback->OnNoResponse(*this, message->firstRequest + aNoResponseData.commandRef);
+}
+
+void PipelinedCommandSender::OnError(const CommandSender * apCommandSender, const CommandSender::ErrorData & aErrorData)
+{
+    Message * message = FindMessage(apCommandSender);
+    VerifyOrReturn(message != nullptr);
+    FailMessage(*message, aErrorData.error);
+}
+
+void PipelinedCommandSender::OnDone(CommandSender * apCommandSender)
+{
+    Message * message = FindMessage(apCommandSender);
+    VerifyOrReturn(message != nullptr);
+
+    // CommandSender only reports missing responses when it tracks them, i.e. for batched messages.
+    bool * answered = GetAnsweredFlags(*message);
+    for (uint16_t offset = 0; offset < message->requestCount; offset++)
+    {
+        if (!answered[offset])
+        {
+            answered[offset] = true;
+            mpCallback->OnNoResponse(*this, message->firstRequest + offset);
+        }
+    }
+
+    // CommandSender allows being destroyed from its OnDone.
+    message->sender.reset();
+    mMessagesInFlight--;
+
+    FillPipeline();
+}
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,184 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines an object that streams a large number of invokes to a node, on top of CommandSender.
+ */
+
+#pragma once
+
+#include <app/CommandSender.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/Optional.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/ScopedBuffer.h>
+#include <messaging/ExchangeMgr.h>
+#include <transport/Session.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * @brief Sends a large number of invoke requests to a single node, keeping several InvokeRequestMessages in flight.
+ *
+ *   Requests are identified by their index, from 0 to the request count given to Start, and are added to messages in
+ *   that order.  Each message carries as many requests as the node accepts per invoke (its MaxPathsPerInvoke) and as fit
+ *   in a message.  Up to a given number of messages are outstanding at once; as soon as one completes, the next one is
+ *   built and sent.  Responses are streamed to the callback as they are received, tagged with the request index.
+ *
+ *   Packing more than one request per message requires CHIP_CONFIG_COMMAND_SENDER_BUILTIN_SUPPORT_FOR_BATCHED_COMMANDS;
+ *   without it, each message carries a single request, and only the pipelining applies.
+ */
+class PipelinedCommandSender : private CommandSender::ExtendableCallback
+{
+public:
+    static constexpr size_t kMaxMessagesInFlight = CHIP_CONFIG_PIPELINED_INVOKE_MAX_MESSAGES_IN_FLIGHT;
+
+    class RequestSource
+    {
+    public:
+        virtual ~RequestSource() = default;
+
+        /**
+         * Adds request aRequestIndex to aSender, by calling one of its AddRequestData methods with aParams.
+         *
+         * This may be called more than once for the same request, when it did not fit in the message that was being
+         * built.  Failures other than CHIP_ERROR_NO_MEMORY and CHIP_ERROR_BUFFER_TOO_SMALL are reported to
+         * Callback::OnError for that request, which is then skipped.
+         */
+        virtual CHIP_ERROR AddRequest(size_t aRequestIndex, CommandSender & aSender,
+                                      CommandSender::AddRequestDataParameters & aParams) = 0;
+    };
+
+    class Callback
+    {
+    public:
+        virtual ~Callback() = default;
+
+        /**
+         * Called for each request the node responded to, including with a path-specific error status.
+         */
+        virtual void OnResponse(PipelinedCommandSender & aSender, size_t aRequestIndex,
+                                const CommandSender::ResponseData & aResponseData)
+        {}
+
+        /**
+         * Called for each request the node did not respond to although it completed the message carrying it.
+         */
+        virtual void OnNoResponse(PipelinedCommandSender & aSender, size_t aRequestIndex) {}
+
+        /**
+         * Called for each request that could not be added to a message or sent, or whose message failed as a whole
+         * (e.g. with CHIP_ERROR_TIMEOUT, or a non-path-specific status).
+         */
+        virtual void OnError(PipelinedCommandSender & aSender, size_t aRequestIndex, CHIP_ERROR aError) {}
+
+        /**
+         * Called once every request has been reported through one of the callbacks above.  The PipelinedCommandSender
+         * may be destroyed from this call.
+         */
+        virtual void OnDone(PipelinedCommandSender & aSender) = 0;
+    };
+
+    struct Parameters
+    {
+        // MaxPathsPerInvoke of the node, read from its Basic Information cluster.
+        uint16_t remoteMaxPathsPerInvoke = 1;
+        // Number of InvokeRequestMessages kept outstanding, capped to kMaxMessagesInFlight.
+        size_t maxMessagesInFlight = kMaxMessagesInFlight;
+        // When set, every request is sent as a timed invoke with this timeout.
+        Optional<uint16_t> timedInvokeTimeoutMs;
+        // Maximum time to wait for the response to each message; the default timeout is used otherwise.
+        Optional<System::Clock::Timeout> responseTimeout;
+    };
+
+    /**
+     * The callback, request source and exchange manager have to outlive this object.
+     */
+    PipelinedCommandSender(Callback * apCallback, RequestSource * apRequestSource, Messaging::ExchangeManager * apExchangeMgr) :
+        mpCallback(apCallback), mpRequestSource(apRequestSource), mpExchangeMgr(apExchangeMgr)
+    {}
+    ~PipelinedCommandSender() override { Abort(); }
+
+    /**
+     * Starts sending aRequestCount requests over aSession.
+     *
+     * Upon successful return, the outcome of every request is reported through the callback, followed by OnDone.  If none
+     * of the requests could be sent, that happens before Start returns.  Upon failure, no callback is called.
+     */
+    CHIP_ERROR Start(const SessionHandle & aSession, size_t aRequestCount, const Parameters & aParameters);
+
+    /**
+     * Stops sending requests and releases the outstanding messages, without calling any callback.  Must not be called from
+     * Callback::OnResponse, OnNoResponse or OnError.
+     */
+    void Abort();
+
+    bool IsRunning() const { return mRunning; }
+
+    // Number of requests that have been added to a message so far.
+    size_t GetSentRequestCount() const { return mNextRequest; }
+
+private:
+    struct Message
+    {
+        Platform::UniquePtr<CommandSender> sender;
+        // The message covers requests [firstRequest, firstRequest + requestCount).  The command reference of each request is
+        // its offset in that range; requests the source failed to add are left out of the message.
+        size_t firstRequest   = 0;
+        uint16_t requestCount = 0;
+        uint16_t addedCount   = 0;
+    };
+
+    // CommandSender::ExtendableCallback implementation.
+    void OnResponse(CommandSender * apCommandSender, const CommandSender::ResponseData & aResponseData) override;
+    void OnNoResponse(CommandSender * apCommandSender, const CommandSender::NoResponseData & aNoResponseData) override;
+    void OnError(const CommandSender * apCommandSender, const CommandSender::ErrorData & aErrorData) override;
+    void OnDone(CommandSender * apCommandSender) override;
+
+    Message * FindMessage(const CommandSender * apCommandSender);
+    bool * GetAnsweredFlags(const Message & aMessage);
+
+    // Builds and sends messages until enough of them are outstanding or every request has been added to one, then calls
+    // OnDone once nothing is left outstanding.
+    void FillPipeline();
+    CHIP_ERROR BuildMessage(Message & aMessage);
+    // Reports aError for every request of aMessage that has not been reported yet.
+    void FailMessage(Message & aMessage, CHIP_ERROR aError);
+
+    Callback * mpCallback;
+    RequestSource * mpRequestSource;
+    Messaging::ExchangeManager * mpExchangeMgr;
+    SessionHolder mSession;
+    Parameters mParameters;
+
+    Message mMessages[kMaxMessagesInFlight];
+    // For each message, which of its requests have been reported to the callback, so that every request is reported once.
+    Platform::ScopedMemoryBuffer<bool> mAnswered;
+    size_t mMessagesInFlight  = 0;
+    size_t mRequestCount      = 0;
+    size_t mNextRequest       = 0;
+    uint16_t mPathsPerMessage = 1;
+    bool mRunning             = false;
+    bool mFilling             = false;
+};
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,351 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/SubscriptionResumptionScheduler.h>
+
+#include <crypto/RandUtils.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+
+namespace chip {
+namespace app {
+
+using namespace System::Clock;
+
+CHIP_ERROR SubscriptionResumptionScheduler::Init(Delegate * delegate, TimerDelegate * timerDelegate,
+                                                 SubscriptionResumptionStorage * storage, const Config & config)
+{
+    VerifyOrReturnError(delegate != nullptr && timerDelegate != nullptr && storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(config.maxConcurrentResumptions > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mDelegate == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    mDelegate      = delegate;
+    mTimerDelegate = timerDelegate;
+    mStorage       = storage;
+    mConfig        = config;
+    mNextBatchTime = Timestamp::zero();
+    return CHIP_NO_ERROR;
+}
+
+void SubscriptionResumptionScheduler::Shutdown()
+{
+    if (mTimerDelegate != nullptr)
+    {
+        mTimerDelegate->CancelTimer(this);
+    }
+    Clear();
+    mResumptions.Free();
+    mCount         = 0;
+    mInFlightCount = 0;
+    mDelegate      = nullptr;
+    mTimerDelegate = nullptr;
+    mStorage       = nullptr;
+}
+
+CHIP_ERROR SubscriptionResumptionScheduler::ScheduleResumptions(bool waitMinInterval, uint16_t & count)
+{
+    count = 0;
+    VerifyOrReturnError(mDelegate != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    Timestamp now   = mTimerDelegate->GetCurrentMonotonicTimestamp();
+    auto * iterator = mStorage->IterateSubscriptions();
+    VerifyOrReturnError(iterator != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    // In-flight resumptions are kept even if their subscription was removed from the storage, so that the attempt can still be
+    // accounted for when it completes.
+    size_t capacity = iterator->Count() + mInFlightCount;
+    Platform::ScopedMemoryBuffer<Resumption> resumptions;
+    uint16_t resumptionCount = 0;
+    if (capacity > 0)
+    {
+        resumptions.Alloc(capacity);
+    }
+    if (capacity > UINT16_MAX || (capacity > 0 && resumptions.Get() == nullptr))
+    {
+        iterator->Release();
+        return CHIP_ERROR_NO_MEMORY;
+    }
+
+    for (uint16_t i = 0; i < mCount; i++)
+    {
+        if (mResumptions[i].state == State::kInFlight)
+        {
+            resumptions[resumptionCount++] = mResumptions[i];
+        }
+    }
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo;
+    while (iterator->Next(subscriptionInfo) && resumptionCount < capacity)
+    {
+        SubscriptionId subscriptionId = subscriptionInfo.mSubscriptionId;
+        const Resumption * existing   = Find(subscriptionId);
+        if ((existing != nullptr && existing->state == State::kInFlight) ||
+            (existing == nullptr && mDelegate->IsSubscriptionActive(subscriptionId)))
+        {
+            continue;
+        }
+
+        // Keep the loaded subscription so that starting its resumption does not need another pass over the storage.
+        auto * info = Platform::New<SubscriptionResumptionStorage::SubscriptionInfo>(std::move(subscriptionInfo));
+        if (info == nullptr)
+        {
+            err = CHIP_ERROR_NO_MEMORY;
+            break;
+        }
+
+        if (existing != nullptr)
+        {
+            // Already waiting: keep its deadline so that rescheduling never moves a resumption earlier.
+            resumptions[resumptionCount++] = { subscriptionId, existing->deadline, State::kWaiting, info };
+            continue;
+        }
+
+        Timestamp deadline = now + Jitter();
+        if (waitMinInterval)
+        {
+            deadline += Seconds16(info->mMinInterval);
+        }
+        resumptions[resumptionCount++] = { subscriptionId, deadline, State::kWaiting, info };
+    }
+    iterator->Release();
+
+    if (err != CHIP_NO_ERROR)
+    {
+        for (uint16_t i = 0; i < resumptionCount; i++)
+        {
+            Platform::Delete(resumptions[i].info);
+        }
+        return err;
+    }
+
+    std::sort(resumptions.Get(), resumptions.Get() + resumptionCount,
+              [](const Resumption & a, const Resumption & b) { return a.subscriptionId < b.subscriptionId; });
+    uint16_t uniqueCount = 0;
+    for (uint16_t i = 0; i < resumptionCount; i++)
+    {
+        if (uniqueCount > 0 && resumptions[uniqueCount - 1].subscriptionId == resumptions[i].subscriptionId)
+        {
+            Platform::Delete(resumptions[i].info);
+            continue;
+        }
+        resumptions[uniqueCount++] = resumptions[i];
+    }
+
+    // The new entries hold freshly loaded subscriptions; release the ones loaded by the previous pass.
+    // Moving a scoped buffer does not free the one it replaces.
+    Clear();
+    mResumptions.Free();
+    mResumptions = std::move(resumptions);
+    mCount       = uniqueCount;
+    count        = mCount;
+
+    ScheduleTimer();
+    return CHIP_NO_ERROR;
+}
+
+void SubscriptionResumptionScheduler::OnResumptionAttemptDone(SubscriptionId subscriptionId)
+{
+    Resumption * resumption = Find(subscriptionId);
+    VerifyOrReturn(resumption != nullptr && resumption->state == State::kInFlight);
+
+    mInFlightCount--;
+    Remove(subscriptionId);
+
+    // Never start the next resumption from within the completion callback: the timer keeps batches paced and keeps the
+    // establisher that is completing out of the call stack of the next one.
+    ScheduleTimer();
+}
+
+void SubscriptionResumptionScheduler::CancelResumptions(FabricIndex fabricIndex)
+{
+    uint16_t kept = 0;
+    for (uint16_t i = 0; i < mCount; i++)
+    {
+        Resumption & resumption = mResumptions[i];
+        if (resumption.info != nullptr && resumption.info->mFabricIndex == fabricIndex)
+        {
+            Platform::Delete(resumption.info);
+            continue;
+        }
+        mResumptions[kept++] = resumption;
+    }
+    mCount = kept;
+
+    ScheduleTimer();
+}
+
+void SubscriptionResumptionScheduler::TimerFired()
+{
+    StartDueResumptions();
+}
+
+SubscriptionResumptionScheduler::Resumption * SubscriptionResumptionScheduler::Find(SubscriptionId subscriptionId)
+{
+    return const_cast<Resumption *>(static_cast<const SubscriptionResumptionScheduler *>(this)->Find(subscriptionId));
+}
+
+const SubscriptionResumptionScheduler::Resumption * SubscriptionResumptionScheduler::Find(SubscriptionId subscriptionId) const
+{
+    VerifyOrReturnValue(mCount > 0, nullptr);
+
+    const Resumption * begin = mResumptions.Get();
+    const Resumption * end   = begin + mCount;
+    const Resumption * it    = std::lower_bound(begin, end, subscriptionId, [](const Resumption & resumption, SubscriptionId id) {
+        return resumption.subscriptionId < id;
+    });
+    return (it != end && it->subscriptionId == subscriptionId) ? it : nullptr;
+}
+
+void SubscriptionResumptionScheduler::Remove(SubscriptionId subscriptionId)
+{
+    Resumption * resumption = Find(subscriptionId);
+    VerifyOrReturn(resumption != nullptr);
+
+    Platform::Delete(resumption->info);
+    Resumption * end = mResumptions.Get() + mCount;
+    std::move(resumption + 1, end, resumption);
+    mCount--;
+}
+
+void SubscriptionResumptionScheduler::Clear()
+{
+    for (uint16_t i = 0; i < mCount; i++)
+    {
+        Platform::Delete(mResumptions[i].info);
+        mResumptions[i].info = nullptr;
+    }
+}
+
+void SubscriptionResumptionScheduler::StartDueResumptions()
+{
+    VerifyOrReturn(mDelegate != nullptr);
+
+    Timestamp now = mTimerDelegate->GetCurrentMonotonicTimestamp();
+    if (now < mNextBatchTime)
+    {
+        ScheduleTimer();
+        return;
+    }
+
+    // Pick the due resumptions with the earliest deadlines, up to the room left under the concurrency cap.
+    uint16_t selected = 0;
+    while (mInFlightCount + selected < mConfig.maxConcurrentResumptions)
+    {
+        Resumption * next = nullptr;
+        for (uint16_t i = 0; i < mCount; i++)
+        {
+            Resumption & resumption = mResumptions[i];
+            if (resumption.state == State::kWaiting && resumption.deadline <= now &&
+                (next == nullptr || resumption.deadline < next->deadline))
+            {
+                next = &resumption;
+            }
+        }
+        if (next == nullptr)
+        {
+            break;
+        }
+        next->state = State::kSelected;
+        selected++;
+    }
+
+    if (selected > 0)
+    {
+        StartSelectedResumptions();
+        mNextBatchTime = now + mConfig.pacingInterval + Jitter();
+    }
+
+    ScheduleTimer();
+}
+
+void SubscriptionResumptionScheduler::StartSelectedResumptions()
+{
+    // The delegate may complete an attempt synchronously, which removes it from the array, so look the next one up each time.
+    for (;;)
+    {
+        Resumption * resumption = std::find_if(mResumptions.Get(), mResumptions.Get() + mCount,
+                                               [](const Resumption & entry) { return entry.state == State::kSelected; });
+        VerifyOrReturn(resumption != mResumptions.Get() + mCount);
+
+        SubscriptionId subscriptionId                          = resumption->subscriptionId;
+        SubscriptionResumptionStorage::SubscriptionInfo * info = resumption->info;
+        resumption->info                                       = nullptr;
+
+        if (mDelegate->IsSubscriptionActive(subscriptionId))
+        {
+            ChipLogProgress(InteractionModel, "Skip resuming live subscriptionId %" PRIu32, subscriptionId);
+            Remove(subscriptionId);
+            Platform::Delete(info);
+            continue;
+        }
+
+        // Mark the resumption in flight first, as the delegate may complete the attempt synchronously.
+        resumption->state = State::kInFlight;
+        mInFlightCount++;
+
+        CHIP_ERROR err = mDelegate->StartSubscriptionResumption(*info);
+        Platform::Delete(info);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(InteractionModel, "Failed to resume subscriptionId %" PRIu32 ": %" CHIP_ERROR_FORMAT, subscriptionId,
+                         err.Format());
+            resumption = Find(subscriptionId);
+            if (resumption != nullptr && resumption->state == State::kInFlight)
+            {
+                mInFlightCount--;
+                Remove(subscriptionId);
+            }
+        }
+    }
+}
+
+void SubscriptionResumptionScheduler::ScheduleTimer()
+{
+    VerifyOrReturn(mTimerDelegate != nullptr);
+    mTimerDelegate->CancelTimer(this);
+    VerifyOrReturn(mInFlightCount < mConfig.maxConcurrentResumptions);
+
+    bool hasWaiting    = false;
+    Timestamp deadline = Timestamp::zero();
+    for (uint16_t i = 0; i < mCount; i++)
+    {
+        if (mResumptions[i].state == State::kWaiting && (!hasWaiting || mResumptions[i].deadline < deadline))
+        {
+            hasWaiting = true;
+            deadline   = mResumptions[i].deadline;
+        }
+    }
+    VerifyOrReturn(hasWaiting);
+
+    Timestamp now   = mTimerDelegate->GetCurrentMonotonicTimestamp();
+    Timestamp next  = std::max(deadline, mNextBatchTime);
+    Timeout timeout = (next > now) ? std::chrono::duration_cast<Timeout>(next - now) : Timeout::zero();
+    LogErrorOnFailure(mTimerDelegate->StartTimer(this, timeout));
+}
+
+Milliseconds32 SubscriptionResumptionScheduler::Jitter() const
+{
+    VerifyOrReturnValue(mConfig.maxJitter.count() > 0, Milliseconds32::zero());
+    return Milliseconds32(Crypto::GetRandU32() % (mConfig.maxJitter.count() + 1));
+}
+
+} // namespace app
+} // namespace chip
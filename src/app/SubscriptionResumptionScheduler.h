@@ -0,0 +1,152 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/SubscriptionResumptionStorage.h>
+#include <app/reporting/ReportScheduler.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/support/ScopedBuffer.h>
+#include <system/SystemClock.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * Paces the resumption of persisted subscriptions.
+ *
+ * Each persisted subscription gets its own resumption deadline (optionally its min-interval, plus a random jitter).  Due
+ * subscriptions are resumed in batches: a batch starts at most as many session establishments as the concurrency cap leaves
+ * room for, and consecutive batches are spaced by the pacing interval plus a random jitter.  This bounds the number of CASE
+ * handshakes in flight after a reboot, no matter how many subscriptions were persisted.
+ *
+ * The scheduler keeps the subscriptions it has to resume in memory, sorted by subscription id.  The storage is only iterated
+ * when scheduling; batches start from the subscription information loaded at that time.
+ */
+class SubscriptionResumptionScheduler : public reporting::TimerContext
+{
+public:
+    using TimerDelegate = reporting::ReportScheduler::TimerDelegate;
+    using Timestamp     = System::Clock::Timestamp;
+
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        /**
+         * Returns true if the given subscription is already live, e.g. because the subscriber subscribed again on its own.
+         * Such subscriptions are not resumed.
+         */
+        virtual bool IsSubscriptionActive(SubscriptionId subscriptionId) = 0;
+
+        /**
+         * Starts resuming the given subscription.  On success, OnResumptionAttemptDone must be called once the attempt has
+         * completed, whether it succeeded or not.
+         */
+        virtual CHIP_ERROR
+        StartSubscriptionResumption(const SubscriptionResumptionStorage::SubscriptionInfo & subscriptionInfo) = 0;
+    };
+
+    struct Config
+    {
+        uint16_t maxConcurrentResumptions = CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_CONCURRENT_SESSIONS;
+        System::Clock::Milliseconds32 pacingInterval =
+            System::Clock::Milliseconds32(CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_PACING_INTERVAL_MS);
+        System::Clock::Milliseconds32 maxJitter = System::Clock::Milliseconds32(CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_JITTER_MS);
+    };
+
+    ~SubscriptionResumptionScheduler() { Shutdown(); }
+
+    CHIP_ERROR Init(Delegate * delegate, TimerDelegate * timerDelegate, SubscriptionResumptionStorage * storage,
+                    const Config & config);
+    CHIP_ERROR Init(Delegate * delegate, TimerDelegate * timerDelegate, SubscriptionResumptionStorage * storage)
+    {
+        return Init(delegate, timerDelegate, storage, Config());
+    }
+    void Shutdown();
+
+    /**
+     * Schedules the resumption of every persisted subscription that is not live yet.  Subscriptions that are already scheduled
+     * or being resumed keep their current state; scheduled subscriptions that are no longer persisted are dropped.
+     *
+     * @param[in]  waitMinInterval  If true, each newly scheduled subscription waits for its own min-interval before being
+     *                              resumed, which avoids generating traffic in a reboot loop.  Otherwise it is resumed as soon
+     *                              as pacing allows.
+     * @param[out] count            The number of subscriptions waiting for or undergoing resumption.
+     */
+    CHIP_ERROR ScheduleResumptions(bool waitMinInterval, uint16_t & count);
+
+    /**
+     * Must be called when a resumption attempt started through Delegate::StartSubscriptionResumption completes.
+     */
+    void OnResumptionAttemptDone(SubscriptionId subscriptionId);
+
+    /**
+     * Drops the scheduled resumptions of the given fabric, whose subscriptions are no longer persisted.  Attempts already in
+     * flight still complete through OnResumptionAttemptDone.
+     */
+    void CancelResumptions(FabricIndex fabricIndex);
+
+    bool IsResumptionScheduled(SubscriptionId subscriptionId) const { return Find(subscriptionId) != nullptr; }
+    uint16_t GetScheduledCount() const { return mCount; }
+    uint16_t GetInFlightCount() const { return mInFlightCount; }
+
+    void TimerFired() override;
+
+private:
+    enum class State : uint8_t
+    {
+        kWaiting,  // Waiting for its deadline, or for room in a batch.
+        kSelected, // Picked for the batch being started.
+        kInFlight, // Session establishment in progress.
+    };
+
+    struct Resumption
+    {
+        SubscriptionId subscriptionId;
+        Timestamp deadline;
+        State state;
+        // Loaded when scheduled and owned by the scheduler; released once the attempt is started.
+        SubscriptionResumptionStorage::SubscriptionInfo * info;
+    };
+
+    Resumption * Find(SubscriptionId subscriptionId);
+    const Resumption * Find(SubscriptionId subscriptionId) const;
+    void Remove(SubscriptionId subscriptionId);
+    void Clear();
+    void StartDueResumptions();
+    void StartSelectedResumptions();
+    void ScheduleTimer();
+    System::Clock::Milliseconds32 Jitter() const;
+
+    Delegate * mDelegate                     = nullptr;
+    TimerDelegate * mTimerDelegate           = nullptr;
+    SubscriptionResumptionStorage * mStorage = nullptr;
+    Config mConfig;
+
+    // Sorted by subscription id.
+    Platform::ScopedMemoryBuffer<Resumption> mResumptions;
+    uint16_t mCount         = 0;
+    uint16_t mInFlightCount = 0;
+    // Earliest time at which the next batch may start.
+    Timestamp mNextBatchTime = Timestamp::zero();
+};
+
+} // namespace app
+} // namespace chip
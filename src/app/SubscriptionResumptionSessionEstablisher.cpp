@@ -95,6 +95,7 @@ void SubscriptionResumptionSessionEstablisher::HandleDeviceConnected(void * cont
     // We do this before the readHandler creation since we do not care if the subscription has successfully been resumed or
     // not. Counter only tracks the number of individual subscriptions we will try to resume.
     imEngine->DecrementNumSubscriptionsToResume();
+    imEngine->OnSubscriptionResumptionAttemptDone(subscriptionInfo.mSubscriptionId);
 
     if (!imEngine->EnsureResourceForSubscription(subscriptionInfo.mFabricIndex, subscriptionInfo.mAttributePaths.AllocatedSize(),
                                                  subscriptionInfo.mEventPaths.AllocatedSize()))
@@ -135,6 +136,7 @@ void SubscriptionResumptionSessionEstablisher::HandleDeviceConnectionFailure(voi
     // We do this here since we were not able to connect to the subscriber thus we have completed our resumption attempt.
     // Counter only tracks the number of individual subscriptions we will try to resume.
     imEngine->DecrementNumSubscriptionsToResume();
+    imEngine->OnSubscriptionResumptionAttemptDone(subscriptionInfo.mSubscriptionId);
 
     auto * subscriptionResumptionStorage = imEngine->GetSubscriptionResumptionStorage();
     if (!subscriptionResumptionStorage)
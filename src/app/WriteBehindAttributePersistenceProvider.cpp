@@ -0,0 +1,226 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#include <app/WriteBehindAttributePersistenceProvider.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <string.h>
+
+namespace chip {
+namespace app {
+
+CHIP_ERROR WriteBehindAttributePersistenceProvider::Init(AttributePersistenceProvider * persister, System::Layer * systemLayer,
+                                                         System::Clock::Milliseconds32 writeDelay)
+{
+    VerifyOrReturnError(persister != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mPersister == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    mPersister   = persister;
+    mSystemLayer = systemLayer;
+    mWriteDelay  = writeDelay;
+    return CHIP_NO_ERROR;
+}
+
+void WriteBehindAttributePersistenceProvider::Shutdown()
+{
+    VerifyOrReturn(mPersister != nullptr);
+
+    LogErrorOnFailure(Flush());
+    DiscardPendingWrites();
+    mPersister   = nullptr;
+    mSystemLayer = nullptr;
+}
+
+CHIP_ERROR WriteBehindAttributePersistenceProvider::Flush()
+{
+    VerifyOrReturnError(mPersister != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    CancelTimer();
+
+    CHIP_ERROR firstError = CHIP_NO_ERROR;
+    for (PendingWrite & entry : mPendingWrites)
+    {
+        if (!entry.IsPending())
+        {
+            continue;
+        }
+
+        CHIP_ERROR err = mPersister->WriteValue(entry.path, ByteSpan(entry.value.Get(), entry.value.AllocatedSize()));
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DataManagement,
+                         "Failed to persist attribute " ChipLogFormatMEI "/" ChipLogFormatMEI ": %" CHIP_ERROR_FORMAT,
+                         ChipLogValueMEI(entry.path.mClusterId), ChipLogValueMEI(entry.path.mAttributeId), err.Format());
+            if (firstError == CHIP_NO_ERROR)
+            {
+                firstError = err;
+            }
+            // Keep the value, so that it is not lost to a transient storage failure.
+            continue;
+        }
+        entry.value.Free();
+    }
+
+    if (firstError != CHIP_NO_ERROR && mSystemLayer != nullptr)
+    {
+        // Try the failed values again after the write delay.  Falling back to Flush, as ArmTimer does, would recurse.
+        LogErrorOnFailure(StartTimer());
+    }
+
+    return firstError;
+}
+
+void WriteBehindAttributePersistenceProvider::DiscardPendingWrites()
+{
+    CancelTimer();
+
+    for (PendingWrite & entry : mPendingWrites)
+    {
+        entry.value.Free();
+    }
+}
+
+size_t WriteBehindAttributePersistenceProvider::GetPendingWriteCount() const
+{
+    size_t count = 0;
+    for (const PendingWrite & entry : mPendingWrites)
+    {
+        if (entry.IsPending())
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+CHIP_ERROR WriteBehindAttributePersistenceProvider::WriteValue(const ConcreteAttributePath & aPath, const ByteSpan & aValue)
+{
+    VerifyOrReturnError(mPersister != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    PendingWrite * entry = FindPendingWrite(aPath);
+    if (entry == nullptr)
+    {
+        entry = FindFreeEntry();
+    }
+    if (entry == nullptr)
+    {
+        // Every entry is taken: write them all out together, which frees those that could be written.
+        LogErrorOnFailure(Flush());
+        entry = FindFreeEntry();
+        if (entry == nullptr)
+        {
+            // Every pending value failed to be written: let the caller know whether this one can be.
+            return mPersister->WriteValue(aPath, aValue);
+        }
+    }
+
+    if (entry->IsPending() && entry->value.AllocatedSize() == aValue.size())
+    {
+        memcpy(entry->value.Get(), aValue.data(), aValue.size());
+        return CHIP_NO_ERROR;
+    }
+
+    // Reallocating frees the entry first, so that a failure does not leave a stale value behind.
+    if (aValue.empty() || !entry->value.Alloc(aValue.size()))
+    {
+        entry->value.Free();
+        return mPersister->WriteValue(aPath, aValue);
+    }
+
+    entry->path = aPath;
+    memcpy(entry->value.Get(), aValue.data(), aValue.size());
+    ArmTimer();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR WriteBehindAttributePersistenceProvider::ReadValue(const ConcreteAttributePath & aPath,
+                                                              const EmberAfAttributeMetadata * aMetadata, MutableByteSpan & aValue)
+{
+    VerifyOrReturnError(mPersister != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    PendingWrite * entry = FindPendingWrite(aPath);
+    if (entry == nullptr)
+    {
+        return mPersister->ReadValue(aPath, aMetadata, aValue);
+    }
+
+    return CopySpanToMutableSpan(ByteSpan(entry->value.Get(), entry->value.AllocatedSize()), aValue);
+}
+
+WriteBehindAttributePersistenceProvider::PendingWrite *
+WriteBehindAttributePersistenceProvider::FindPendingWrite(const ConcreteAttributePath & aPath)
+{
+    for (PendingWrite & entry : mPendingWrites)
+    {
+        if (entry.IsPending() && entry.path == aPath)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+WriteBehindAttributePersistenceProvider::PendingWrite * WriteBehindAttributePersistenceProvider::FindFreeEntry()
+{
+    for (PendingWrite & entry : mPendingWrites)
+    {
+        if (!entry.IsPending())
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void WriteBehindAttributePersistenceProvider::ArmTimer()
+{
+    VerifyOrReturn(!mTimerArmed && mSystemLayer != nullptr);
+
+    // The timer is armed by the first pending value only, so that values that keep changing still get written.
+    CHIP_ERROR err = StartTimer();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement, "Failed to arm attribute write-behind timer: %" CHIP_ERROR_FORMAT, err.Format());
+        LogErrorOnFailure(Flush());
+    }
+}
+
+CHIP_ERROR WriteBehindAttributePersistenceProvider::StartTimer()
+{
+    ReturnErrorOnFailure(mSystemLayer->StartTimer(mWriteDelay, OnFlushTimer, this));
+    mTimerArmed = true;
+    return CHIP_NO_ERROR;
+}
+
+void WriteBehindAttributePersistenceProvider::CancelTimer()
+{
+    VerifyOrReturn(mTimerArmed);
+
+    mSystemLayer->CancelTimer(OnFlushTimer, this);
+    mTimerArmed = false;
+}
+
+void WriteBehindAttributePersistenceProvider::OnFlushTimer(System::Layer * layer, void * context)
+{
+    auto * self = static_cast<WriteBehindAttributePersistenceProvider *>(context);
+
+    self->mTimerArmed = false;
+    LogErrorOnFailure(self->Flush());
+}
+
+} // namespace app
+} // namespace chip
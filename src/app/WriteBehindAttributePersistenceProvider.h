@@ -0,0 +1,116 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <app/AttributePersistenceProvider.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/support/ScopedBuffer.h>
+#include <lib/support/Span.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * Decorator class for the AttributePersistenceProvider implementation that
+ * coalesces writes of all attributes.
+ *
+ * Written values are kept in RAM, and written to the decorated persister at
+ * most the configured delay after the first of them.  An attribute that
+ * changes several times within that window, such as the CurrentLevel attribute
+ * of the LevelControl cluster during a transition, is written once, with its
+ * last value.  All the pending values are written together, so that storage
+ * writes scale with the number of distinct attributes that changed rather than
+ * with the number of changes.
+ *
+ * Unlike DeferredAttributePersistenceProvider, the delay is not extended by
+ * further changes, so an attribute that keeps changing still gets persisted
+ * once per window.
+ *
+ * Pending values are lost on power loss, so Flush should be called when they
+ * have to reach storage, e.g. when commissioning completes.
+ */
+class WriteBehindAttributePersistenceProvider : public AttributePersistenceProvider
+{
+public:
+    static constexpr size_t kMaxPendingWrites = CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_MAX_PENDING_WRITES;
+
+    WriteBehindAttributePersistenceProvider() = default;
+    ~WriteBehindAttributePersistenceProvider() override { Shutdown(); }
+
+    /**
+     * @param[in] persister    Provider the values are written to.  Must outlive this object.
+     * @param[in] systemLayer  Layer used to arm the write-behind timer.  If null, pending values are only written when
+     *                         kMaxPendingWrites attributes have pending values, or on Flush and Shutdown.
+     * @param[in] writeDelay   Maximum time a value is kept in RAM before being written.
+     */
+    CHIP_ERROR Init(AttributePersistenceProvider * persister, System::Layer * systemLayer,
+                    System::Clock::Milliseconds32 writeDelay);
+
+    /**
+     * Writes the pending values, then stops using the persister and the system layer.  Values that fail to be written are
+     * dropped.
+     */
+    void Shutdown();
+
+    /**
+     * Writes all the pending values to the decorated persister right away.
+     *
+     * Every pending value is attempted even if some of the writes fail, and the first failure is returned.  The values that
+     * failed stay pending, and are attempted again once the write delay has elapsed, or on the next Flush.
+     */
+    CHIP_ERROR Flush();
+
+    /**
+     * Drops the pending values without writing them, e.g. because the storage is being erased.
+     */
+    void DiscardPendingWrites();
+
+    size_t GetPendingWriteCount() const;
+
+    // AttributePersistenceProvider implementation.
+    CHIP_ERROR WriteValue(const ConcreteAttributePath & aPath, const ByteSpan & aValue) override;
+    CHIP_ERROR ReadValue(const ConcreteAttributePath & aPath, const EmberAfAttributeMetadata * aMetadata,
+                         MutableByteSpan & aValue) override;
+
+private:
+    struct PendingWrite
+    {
+        ConcreteAttributePath path;
+        Platform::ScopedMemoryBufferWithSize<uint8_t> value;
+
+        bool IsPending() const { return static_cast<bool>(value); }
+    };
+
+    PendingWrite * FindPendingWrite(const ConcreteAttributePath & aPath);
+    PendingWrite * FindFreeEntry();
+    void ArmTimer();
+    CHIP_ERROR StartTimer();
+    void CancelTimer();
+
+    static void OnFlushTimer(System::Layer * layer, void * context);
+
+    AttributePersistenceProvider * mPersister = nullptr;
+    System::Layer * mSystemLayer              = nullptr;
+    System::Clock::Milliseconds32 mWriteDelay = System::Clock::kZero;
+    bool mTimerArmed                          = false;
+
+    PendingWrite mPendingWrites[kMaxPendingWrites];
+};
+
+} // namespace app
+} // namespace chip
@@ -150,11 +150,15 @@ CHIP_ERROR WriteClient::FinalizeMessage(bool aHasMoreChunks)
     ReturnErrorOnFailure(mWriteRequestBuilder.MoreChunkedMessages(aHasMoreChunks).EndOfWriteRequestMessage());
     ReturnErrorOnFailure(mMessageWriter.Finalize(&packet));
     mChunks.AddToEnd(std::move(packet));
+    mChunkCount++;
     return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR WriteClient::EnsureMessage()
 {
+    // A list pulled from a ListItemSource is the last attribute of the request, even once its items are all encoded.
+    VerifyOrReturnError(!mListItemPath.IsListItemOperation(), CHIP_ERROR_INCORRECT_STATE);
+
     if (mState != State::AddAttribute)
     {
         return StartNewMessage();
@@ -285,6 +289,71 @@ CHIP_ERROR WriteClient::PutPreencodedAttribute(const ConcreteDataAttributePath &
     return PutSinglePreencodedAttributeWritePayload(attributePath, data);
 }
 
+CHIP_ERROR WriteClient::EncodeListAttribute(const AttributePathParams & attributePath, ListItemSource & source,
+                                            const Optional<DataVersion> & aDataVersion)
+{
+    ReturnErrorOnFailure(EnsureMessage());
+
+    // Here, we are using kInvalidEndpointId for missing endpoint id, which is used when sending group write requests.
+    ConcreteDataAttributePath path =
+        ConcreteDataAttributePath(attributePath.HasWildcardEndpointId() ? kInvalidEndpointId : attributePath.mEndpointId,
+                                  attributePath.mClusterId, attributePath.mAttributeId, aDataVersion);
+
+    // Encode an empty list for the chunking protocol.
+    ReturnErrorOnFailure(EncodeSingleAttributeDataIB(path, DataModel::List<uint8_t>()));
+
+    mListItemPath         = path;
+    mListItemPath.mListOp = ConcreteDataAttributePath::ListOperation::AppendItem;
+    mpListItemSource      = &source;
+
+    CHIP_ERROR err = EncodeListItems();
+    if (err != CHIP_NO_ERROR)
+    {
+        mpListItemSource = nullptr;
+    }
+    return err;
+}
+
+CHIP_ERROR WriteClient::TryEncodeListItem()
+{
+    TLV::TLVWriter * writer = nullptr;
+
+    ReturnErrorOnFailure(PrepareAttributeIB(mListItemPath));
+    VerifyOrReturnError((writer = GetAttributeDataIBTLVWriter()) != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    ReturnErrorOnFailure(mpListItemSource->EncodeItem(*writer, TLV::ContextTag(AttributeDataIB::Tag::kData)));
+    return FinishAttributeIB();
+}
+
+CHIP_ERROR WriteClient::EncodeListItems()
+{
+    static_assert(CHIP_IM_MAX_WRITE_CLIENT_QUEUED_CHUNKS >= 1, "Chunks must be queued for the list items not encoded yet");
+
+    while (!mpListItemSource->AtEnd())
+    {
+        TLV::TLVWriter backupWriter;
+
+        mWriteRequestBuilder.GetWriteRequests().Checkpoint(backupWriter);
+
+        CHIP_ERROR err = TryEncodeListItem();
+        if (err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL)
+        {
+            mWriteRequestBuilder.GetWriteRequests().Rollback(backupWriter);
+
+            // The current chunk is full: the item waits for a chunk to be sent if enough of them are queued already.
+            VerifyOrReturnError(mChunkCount < CHIP_IM_MAX_WRITE_CLIENT_QUEUED_CHUNKS, CHIP_NO_ERROR);
+
+            ReturnErrorOnFailure(StartNewMessage());
+            err = TryEncodeListItem();
+        }
+        ReturnErrorOnFailure(err);
+
+        mpListItemSource->Next();
+    }
+
+    mpListItemSource = nullptr;
+    return CHIP_NO_ERROR;
+}
+
 const char * WriteClient::GetStateStr() const
 {
 #if CHIP_DETAIL_LOGGING
@@ -324,8 +393,12 @@ CHIP_ERROR WriteClient::SendWriteRequest(const SessionHandle & session, System::
 
     VerifyOrExit(mState == State::AddAttribute, err = CHIP_ERROR_INCORRECT_STATE);
 
-    err = FinalizeMessage(false /* hasMoreChunks */);
-    SuccessOrExit(err);
+    // The chunk being encoded is not the last one while list items remain to be encoded.
+    if (mpListItemSource == nullptr)
+    {
+        err = FinalizeMessage(false /* hasMoreChunks */);
+        SuccessOrExit(err);
+    }
 
     {
         // Create a new exchange context.
@@ -391,6 +464,19 @@ CHIP_ERROR WriteClient::SendWriteRequest()
     using namespace Messaging;
 
     System::PacketBufferHandle data = mChunks.PopHead();
+    mChunkCount--;
+
+    if (mpListItemSource != nullptr)
+    {
+        // A chunk is leaving the queue: encode the next list items, before sending so that encoding failures close the
+        // interaction.
+        MoveToState(State::AddAttribute);
+        ReturnErrorOnFailure(EncodeListItems());
+        if (mpListItemSource == nullptr)
+        {
+            ReturnErrorOnFailure(FinalizeMessage(false /* hasMoreChunks */));
+        }
+    }
 
     bool isGroupWrite = mExchangeCtx->IsGroupExchangeContext();
     if (!mChunks.IsNull() && isGroupWrite)
@@ -114,6 +114,51 @@ public:
         virtual void OnDone(WriteClient * apWriteClient) = 0;
     };
 
+    /**
+     * Source of the items of a list attribute written with EncodeListAttribute(). The items are pulled as the chunks of the
+     * write request are sent, so that the list does not need to be held in memory as a whole.
+     */
+    class ListItemSource
+    {
+    public:
+        virtual ~ListItemSource() = default;
+
+        /**
+         * Returns true once all the items have been encoded.
+         */
+        virtual bool AtEnd() = 0;
+
+        /**
+         * Encodes the current item. May be called again for the same item, when it did not fit in the remaining space of
+         * a chunk.
+         */
+        virtual CHIP_ERROR EncodeItem(TLV::TLVWriter & writer, TLV::Tag tag) = 0;
+
+        /**
+         * Moves to the next item, once the current one has been encoded.
+         */
+        virtual void Next() = 0;
+    };
+
+    /**
+     * ListItemSource for the items of an iterator range, e.g. of a container or of a generator with an input iterator
+     * interface.
+     */
+    template <typename Iterator>
+    class IteratorListItemSource : public ListItemSource
+    {
+    public:
+        IteratorListItemSource(Iterator begin, Iterator end) : mCurrent(begin), mEnd(end) {}
+
+        bool AtEnd() override { return mCurrent == mEnd; }
+        CHIP_ERROR EncodeItem(TLV::TLVWriter & writer, TLV::Tag tag) override { return EncodeValue(writer, tag, *mCurrent); }
+        void Next() override { ++mCurrent; }
+
+    private:
+        Iterator mCurrent;
+        Iterator mEnd;
+    };
+
     /**
      *  Construct the client object. Within the lifetime
      *  of this instance.
@@ -208,6 +253,17 @@ public:
         return EncodeAttribute(attributePath, value.Value(), aDataVersion);
     }
 
+    /**
+     * Encode a list attribute value whose items are pulled from a ListItemSource as the write request is sent, instead of
+     * being encoded up front. At most CHIP_IM_MAX_WRITE_CLIENT_QUEUED_CHUNKS complete chunks wait to be sent at any time,
+     * so that large lists (e.g. ACL entries or bindings) can be written with bounded memory.
+     *
+     * The list must be the last attribute of the write request. The source must remain valid until OnDone is called, or
+     * until SendWriteRequest fails. Items that fail to encode after SendWriteRequest succeeded are reported to OnError.
+     */
+    CHIP_ERROR EncodeListAttribute(const AttributePathParams & attributePath, ListItemSource & source,
+                                   const Optional<DataVersion> & aDataVersion = NullOptional);
+
     /**
      * Encode an attribute value which is already encoded into a TLV. The TLVReader is expected to be initialized and the read head
      * is expected to point to the element to be encoded.
@@ -251,6 +307,18 @@ private:
     CHIP_ERROR ProcessAttributeStatusIB(AttributeStatusIB::Parser & aAttributeStatusIB);
     const char * GetStateStr() const;
 
+    template <class T, std::enable_if_t<!DataModel::IsFabricScoped<T>::value, int> = 0>
+    static CHIP_ERROR EncodeValue(TLV::TLVWriter & writer, TLV::Tag tag, const T & value)
+    {
+        return DataModel::Encode(writer, tag, value);
+    }
+
+    template <class T, std::enable_if_t<DataModel::IsFabricScoped<T>::value, int> = 0>
+    static CHIP_ERROR EncodeValue(TLV::TLVWriter & writer, TLV::Tag tag, const T & value)
+    {
+        return DataModel::EncodeForWrite(writer, tag, value);
+    }
+
     /**
      *  Encode an attribute value that can be directly encoded using DataModel::Encode.
      */
@@ -324,6 +392,13 @@ private:
 
     CHIP_ERROR EnsureMessage();
 
+    /**
+     * Encode the items of mpListItemSource, until they are all encoded or CHIP_IM_MAX_WRITE_CLIENT_QUEUED_CHUNKS chunks are
+     * waiting to be sent.
+     */
+    CHIP_ERROR EncodeListItems();
+    CHIP_ERROR TryEncodeListItem();
+
     /**
      * Called internally to signal the completion of all work on this object, gracefully close the
      * exchange (by calling into the base class) and finally, signal to the application that it's
@@ -377,6 +452,13 @@ private:
 
     // A list of buffers, one buffer for each chunk.
     System::PacketBufferHandle mChunks;
+    size_t mChunkCount = 0;
+
+    // The list being encoded by EncodeListAttribute, if its items are not all encoded yet. Some chunks are then always
+    // waiting to be sent in mChunks.
+    ListItemSource * mpListItemSource = nullptr;
+    // The path of the items of the list encoded by EncodeListAttribute, if any.
+    ConcreteDataAttributePath mListItemPath;
 
     // TODO: This file might be compiled with different build flags on Darwin platform (when building WriteClient.cpp and
     // CHIPClustersObjc.mm), which will cause undefined behavior when building write requests. Uncomment the #if and #endif after
@@ -171,7 +171,11 @@ CHIP_ERROR AccessControlAttribute::ReadAcl(AttributeValueEncoder & aEncoder)
     AccessControl::EntryIterator iterator;
     AccessControl::Entry entry;
     AclStorage::EncodableEntry encodableEntry(entry);
-    return aEncoder.EncodeList([&](const auto & encoder) -> CHIP_ERROR {
+    // The ACL can hold many entries per fabric, so resume from the first entry not yet sent when the list is chunked instead of
+    // encoding every entry again for each chunk. Entries already sent are only stepped over by the iterator, as reading
+    // entries by index is not constant time for every delegate.
+    return aEncoder.EncodeResumableList([&](const auto & encoder, ListIndex startIndex) -> CHIP_ERROR {
+        size_t position = 0;
         for (auto & info : Server::GetInstance().GetFabricTable())
         {
             auto fabric = info.GetFabricIndex();
@@ -179,7 +183,10 @@ CHIP_ERROR AccessControlAttribute::ReadAcl(AttributeValueEncoder & aEncoder)
             CHIP_ERROR err = CHIP_NO_ERROR;
             while ((err = iterator.Next(entry)) == CHIP_NO_ERROR)
             {
-                ReturnErrorOnFailure(encoder.Encode(encodableEntry));
+                if (position++ >= startIndex)
+                {
+                    ReturnErrorOnFailure(encoder.Encode(encodableEntry));
+                }
             }
             ReturnErrorCodeIf(err != CHIP_NO_ERROR && err != CHIP_ERROR_SENTINEL, err);
         }
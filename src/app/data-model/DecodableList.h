@@ -208,14 +208,22 @@ public:
         return mReader.CountRemainingInContainer(size);
     }
 
+    /*
+     * Keeps a reader positioned into the list, for the iterator to decode its
+     * elements, and moves the passed-in reader past the list.
+     *
+     * Moving past the list checks that it is properly terminated, so that a
+     * truncated or malformed list fails to decode.  This only skips over the
+     * element heads: the elements themselves are decoded by the iterator,
+     * which reports malformed elements through Iterator::GetStatus().
+     */
     CHIP_ERROR Decode(TLV::TLVReader & reader)
     {
         VerifyOrReturnError(reader.GetType() == TLV::kTLVType_Array, CHIP_ERROR_SCHEMA_MISMATCH);
         TLV::TLVType type;
         ReturnErrorOnFailure(reader.EnterContainer(type));
         SetReader(reader);
-        ReturnErrorOnFailure(reader.ExitContainer(type));
-        return CHIP_NO_ERROR;
+        return reader.ExitContainer(type);
     }
 
 private:
@@ -20,8 +20,8 @@
 #include <access/Privilege.h>
 #include <access/RequestPath.h>
 #include <access/SubjectDescriptor.h>
-#include <app-common/zap-generated/ids/Clusters.h>
 #include <app/InteractionModelEngine.h>
+#include <app/dynamic_server/DynamicDataModelRegistry.h>
 #include <lib/core/CHIPError.h>
 #include <lib/core/Global.h>
 
@@ -32,12 +32,9 @@
 
 using namespace chip;
 using namespace chip::Access;
-using namespace chip::app::Clusters;
+using chip::app::dynamic_server::DynamicDataModelRegistry;
 
 namespace {
-// TODO: Maybe consider making this configurable?  See also
-// DynamicDispatch.cpp.
-constexpr EndpointId kSupportedEndpoint = 0;
 
 class DeviceTypeResolver : public Access::AccessControl::DeviceTypeResolver
 {
@@ -54,16 +51,16 @@ class AccessControlDelegate : public Access::AccessControl::Delegate
     CHIP_ERROR Check(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
                      Privilege requestPrivilege) override
     {
-        if (requestPath.endpoint != kSupportedEndpoint || requestPath.cluster != OtaSoftwareUpdateProvider::Id)
+        if (DynamicDataModelRegistry::Instance().FindServerCluster(requestPath.endpoint, requestPath.cluster) == nullptr)
         {
-            // We only allow access to OTA software update provider.
+            // We only allow access to clusters registered with the dynamic server.
             return CHIP_ERROR_ACCESS_DENIED;
         }
 
         if (requestPrivilege != Privilege::kOperate)
         {
-            // The commands on OtaSoftwareUpdateProvider all require
-            // Operate; we should not be asked for anything else.
+            // The commands on the registered clusters (OtaSoftwareUpdateProvider by
+            // default) all require Operate; we should not be asked for anything else.
             return CHIP_ERROR_ACCESS_DENIED;
         }
 
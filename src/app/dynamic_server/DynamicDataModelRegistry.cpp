@@ -0,0 +1,189 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#include "DynamicDataModelRegistry.h"
+
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace app {
+namespace dynamic_server {
+
+CHIP_ERROR DynamicDataModelRegistry::AddEndpoint(EndpointId endpoint, const EmberAfEndpointType * endpointType)
+{
+    VerifyOrReturnError(endpoint != kInvalidEndpointId && endpointType != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mEndpointIndex.find(endpoint) == mEndpointIndex.end(), CHIP_ERROR_DUPLICATE_KEY_ID);
+
+    uint16_t index;
+    if (!mFreeSlots.empty())
+    {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+    }
+    else
+    {
+        VerifyOrReturnError(mSlots.size() < kInvalidIndex, CHIP_ERROR_NO_MEMORY);
+        index = static_cast<uint16_t>(mSlots.size());
+        mSlots.emplace_back();
+    }
+
+    mSlots[index].endpoint     = endpoint;
+    mSlots[index].endpointType = endpointType;
+    mEndpointIndex[endpoint]   = index;
+
+    uint8_t serverIndex = 0;
+    uint8_t clientIndex = 0;
+    for (uint8_t i = 0; i < endpointType->clusterCount; i++)
+    {
+        const EmberAfCluster & cluster = endpointType->cluster[i];
+        const bool server              = cluster.IsServer();
+        uint8_t & nextIndex            = server ? serverIndex : clientIndex;
+        mClusters[ClusterKey(endpoint, cluster.clusterId, server)] = ClusterEntry{ &cluster, nextIndex++ };
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DynamicDataModelRegistry::RemoveEndpoint(EndpointId endpoint)
+{
+    auto it = mEndpointIndex.find(endpoint);
+    VerifyOrReturnError(it != mEndpointIndex.end(), CHIP_ERROR_NOT_FOUND);
+
+    const uint16_t index                     = it->second;
+    const EmberAfEndpointType * endpointType = mSlots[index].endpointType;
+    for (uint8_t i = 0; i < endpointType->clusterCount; i++)
+    {
+        const EmberAfCluster & cluster = endpointType->cluster[i];
+        mClusters.erase(ClusterKey(endpoint, cluster.clusterId, cluster.IsServer()));
+    }
+
+    mSlots[index] = EndpointSlot();
+    mFreeSlots.push_back(index);
+    mEndpointIndex.erase(it);
+
+    return CHIP_NO_ERROR;
+}
+
+CommandDispatchFunction DynamicDataModelRegistry::GetCommandDispatch(ClusterId cluster) const
+{
+    auto it = mCommandDispatch.find(cluster);
+    return (it == mCommandDispatch.end()) ? nullptr : it->second;
+}
+
+uint16_t DynamicDataModelRegistry::IndexOfEndpoint(EndpointId endpoint) const
+{
+    auto it = mEndpointIndex.find(endpoint);
+    return (it == mEndpointIndex.end()) ? kInvalidIndex : it->second;
+}
+
+EndpointId DynamicDataModelRegistry::EndpointAtIndex(uint16_t index) const
+{
+    return (index < mSlots.size()) ? mSlots[index].endpoint : kInvalidEndpointId;
+}
+
+const EmberAfEndpointType * DynamicDataModelRegistry::FindEndpointType(EndpointId endpoint) const
+{
+    uint16_t index = IndexOfEndpoint(endpoint);
+    return (index == kInvalidIndex) ? nullptr : mSlots[index].endpointType;
+}
+
+const EmberAfCluster * DynamicDataModelRegistry::FindCluster(EndpointId endpoint, ClusterId cluster,
+                                                             EmberAfClusterMask mask) const
+{
+    if (mask & CLUSTER_MASK_SERVER)
+    {
+        auto it = mClusters.find(ClusterKey(endpoint, cluster, true));
+        if (it != mClusters.end())
+        {
+            return it->second.cluster;
+        }
+    }
+
+    if (mask & CLUSTER_MASK_CLIENT)
+    {
+        auto it = mClusters.find(ClusterKey(endpoint, cluster, false));
+        if (it != mClusters.end())
+        {
+            return it->second.cluster;
+        }
+    }
+
+    return nullptr;
+}
+
+uint8_t DynamicDataModelRegistry::ClusterIndex(EndpointId endpoint, ClusterId cluster, EmberAfClusterMask mask) const
+{
+    if (mask & CLUSTER_MASK_SERVER)
+    {
+        auto it = mClusters.find(ClusterKey(endpoint, cluster, true));
+        if (it != mClusters.end())
+        {
+            return it->second.index;
+        }
+    }
+
+    if (mask & CLUSTER_MASK_CLIENT)
+    {
+        auto it = mClusters.find(ClusterKey(endpoint, cluster, false));
+        if (it != mClusters.end())
+        {
+            return it->second.index;
+        }
+    }
+
+    return UINT8_MAX;
+}
+
+uint8_t DynamicDataModelRegistry::ClusterCount(EndpointId endpoint, bool server) const
+{
+    const EmberAfEndpointType * endpointType = FindEndpointType(endpoint);
+    VerifyOrReturnValue(endpointType != nullptr, 0);
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < endpointType->clusterCount; i++)
+    {
+        if (endpointType->cluster[i].IsServer() == server)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint16_t DynamicDataModelRegistry::ClusterServerEndpointIndex(EndpointId endpoint, ClusterId cluster,
+                                                              uint16_t fixedClusterServerEndpointCount) const
+{
+    VerifyOrReturnValue(FindServerCluster(endpoint, cluster) != nullptr, kInvalidIndex);
+
+    // As for the dynamic endpoints of attribute-storage, the index is offset by the fixed endpoints hosting the cluster,
+    // and indices freed by removed endpoints are not compacted.
+    uint32_t index = static_cast<uint32_t>(fixedClusterServerEndpointCount) + IndexOfEndpoint(endpoint);
+    return (index < kInvalidIndex) ? static_cast<uint16_t>(index) : kInvalidIndex;
+}
+
+void DynamicDataModelRegistry::Clear()
+{
+    mSlots.clear();
+    mFreeSlots.clear();
+    mEndpointIndex.clear();
+    mClusters.clear();
+    mCommandDispatch.clear();
+}
+
+} // namespace dynamic_server
+} // namespace app
+} // namespace chip
@@ -0,0 +1,147 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <app/ConcreteCommandPath.h>
+#include <app/util/af-types.h>
+#include <app/util/att-storage.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/TLVReader.h>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace chip {
+namespace app {
+
+class CommandHandler;
+
+namespace dynamic_server {
+
+/**
+ * Decodes and handles a command for a cluster registered with the dynamic server. The command is
+ * known to be in the accepted command list of the cluster when this is called.
+ *
+ * Returns false if the command was not handled, in which case an InvalidCommand status is sent.
+ */
+using CommandDispatchFunction = bool (*)(const ConcreteCommandPath & path, TLV::TLVReader & reader, CommandHandler * handler);
+
+/**
+ * Data model registry backing the dynamic server dispatch and ember stubs.
+ *
+ * Endpoints can be added and removed at runtime. Each endpoint occupies a slot whose index is the
+ * ember endpoint index; slots are stored in a deque so that adding endpoints never relocates
+ * existing ones, and slots freed by removal are reused by later additions (their index reports
+ * as disabled in the meantime). Endpoint and (endpoint, cluster) lookups are hashed, so resolving
+ * paths does not depend on the number of endpoints.
+ */
+class DynamicDataModelRegistry
+{
+public:
+    static constexpr uint16_t kInvalidIndex = UINT16_MAX;
+
+    /**
+     * The registry used by the dynamic server (defined in DynamicDispatcher.cpp). It initially
+     * hosts the OTA Software Update Provider cluster on endpoint 0.
+     */
+    static DynamicDataModelRegistry & Instance();
+
+    /**
+     * Add an endpoint with the given clusters. The endpoint type must outlive the registration.
+     *
+     * @retval CHIP_ERROR_DUPLICATE_KEY_ID if the endpoint is already registered.
+     * @retval CHIP_ERROR_NO_MEMORY if all endpoint indices are in use.
+     */
+    CHIP_ERROR AddEndpoint(EndpointId endpoint, const EmberAfEndpointType * endpointType);
+
+    /**
+     * Remove an endpoint. Its index is reported as disabled until it is reused.
+     *
+     * @retval CHIP_ERROR_NOT_FOUND if the endpoint is not registered.
+     */
+    CHIP_ERROR RemoveEndpoint(EndpointId endpoint);
+
+    /**
+     * Set the function that handles commands for every registered instance of a cluster.
+     */
+    void SetCommandDispatch(ClusterId cluster, CommandDispatchFunction dispatch) { mCommandDispatch[cluster] = dispatch; }
+    CommandDispatchFunction GetCommandDispatch(ClusterId cluster) const;
+
+    /// Number of endpoint indices, including disabled ones.
+    uint16_t EndpointIndexCount() const { return static_cast<uint16_t>(mSlots.size()); }
+    uint16_t IndexOfEndpoint(EndpointId endpoint) const;
+    EndpointId EndpointAtIndex(uint16_t index) const;
+    bool IsIndexEnabled(uint16_t index) const { return index < mSlots.size() && mSlots[index].endpointType != nullptr; }
+
+    const EmberAfEndpointType * FindEndpointType(EndpointId endpoint) const;
+    const EmberAfCluster * FindCluster(EndpointId endpoint, ClusterId cluster, EmberAfClusterMask mask) const;
+    const EmberAfCluster * FindServerCluster(EndpointId endpoint, ClusterId cluster) const
+    {
+        return FindCluster(endpoint, cluster, CLUSTER_MASK_SERVER);
+    }
+
+    /// Index of the cluster among the clusters of the endpoint matching mask, or UINT8_MAX.
+    uint8_t ClusterIndex(EndpointId endpoint, ClusterId cluster, EmberAfClusterMask mask) const;
+
+    /// Number of clusters of the endpoint that are servers (or clients, if server is false).
+    uint8_t ClusterCount(EndpointId endpoint, bool server) const;
+
+    /**
+     * Index that cluster servers use into their per-endpoint arrays (see
+     * emberAfGetClusterServerEndpointIndex). Registered endpoints are all dynamic ones, so this is
+     * fixedClusterServerEndpointCount plus the endpoint index, which does not change while the
+     * endpoint is registered, whatever other endpoints are added or removed.
+     *
+     * Returns kInvalidIndex if the endpoint does not host the cluster server.
+     */
+    uint16_t ClusterServerEndpointIndex(EndpointId endpoint, ClusterId cluster, uint16_t fixedClusterServerEndpointCount) const;
+
+    /// Remove all endpoints and command dispatch functions.
+    void Clear();
+
+private:
+    struct EndpointSlot
+    {
+        EndpointId endpoint                      = kInvalidEndpointId;
+        const EmberAfEndpointType * endpointType = nullptr;
+    };
+
+    struct ClusterEntry
+    {
+        const EmberAfCluster * cluster;
+        uint8_t index; // Index among the clusters of the endpoint with the same server/client side.
+    };
+
+    static uint64_t ClusterKey(EndpointId endpoint, ClusterId cluster, bool server)
+    {
+        return (static_cast<uint64_t>(endpoint) << 33) | (static_cast<uint64_t>(server) << 32) | cluster;
+    }
+
+    std::deque<EndpointSlot> mSlots;
+    std::vector<uint16_t> mFreeSlots;
+    std::unordered_map<EndpointId, uint16_t> mEndpointIndex;
+    std::unordered_map<uint64_t, ClusterEntry> mClusters;
+    std::unordered_map<ClusterId, CommandDispatchFunction> mCommandDispatch;
+};
+
+} // namespace dynamic_server
+} // namespace app
+} // namespace chip
@@ -31,6 +31,7 @@
 #include <app/MessageDef/StatusIB.h>
 #include <app/WriteHandler.h>
 #include <app/data-model/Decode.h>
+#include <app/dynamic_server/DynamicDataModelRegistry.h>
 #include <app/util/att-storage.h>
 #include <app/util/endpoint-config-api.h>
 #include <lib/core/CHIPError.h>
@@ -46,21 +47,98 @@
  * IMClusterCommandHandler.cpp but we want a different implementation of these
  * to enable more dynamic behavior, since not all framework consumers will be
  * implementing the same server clusters.
+ *
+ * Paths are resolved through DynamicDataModelRegistry, which by default hosts
+ * the OTA Software Update Provider cluster on endpoint 0.
  */
 using namespace chip;
 using namespace chip::app;
 using namespace chip::app::Clusters;
+using chip::app::dynamic_server::DynamicDataModelRegistry;
 
 namespace {
 
-// TODO: Maybe consider making this configurable?  See also
-// AccessControl.cpp.
-constexpr EndpointId kSupportedEndpoint = 0;
+constexpr EndpointId kOtaProviderEndpoint = 0;
+
+bool DispatchOtaProviderCommand(const ConcreteCommandPath & aPath, TLV::TLVReader & aReader, CommandHandler * aCommandObj)
+{
+    using namespace OtaSoftwareUpdateProvider::Commands;
+
+    switch (aPath.mCommandId)
+    {
+    case QueryImage::Id: {
+        QueryImage::DecodableType commandData;
+        VerifyOrReturnValue(DataModel::Decode(aReader, commandData) == CHIP_NO_ERROR, false);
+        return emberAfOtaSoftwareUpdateProviderClusterQueryImageCallback(aCommandObj, aPath, commandData);
+    }
+    case ApplyUpdateRequest::Id: {
+        ApplyUpdateRequest::DecodableType commandData;
+        VerifyOrReturnValue(DataModel::Decode(aReader, commandData) == CHIP_NO_ERROR, false);
+        return emberAfOtaSoftwareUpdateProviderClusterApplyUpdateRequestCallback(aCommandObj, aPath, commandData);
+    }
+    case NotifyUpdateApplied::Id: {
+        NotifyUpdateApplied::DecodableType commandData;
+        VerifyOrReturnValue(DataModel::Decode(aReader, commandData) == CHIP_NO_ERROR, false);
+        return emberAfOtaSoftwareUpdateProviderClusterNotifyUpdateAppliedCallback(aCommandObj, aPath, commandData);
+    }
+    default:
+        return false;
+    }
+}
+
+const CommandId acceptedCommands[]  = { Clusters::OtaSoftwareUpdateProvider::Commands::QueryImage::Id,
+                                        Clusters::OtaSoftwareUpdateProvider::Commands::ApplyUpdateRequest::Id,
+                                        Clusters::OtaSoftwareUpdateProvider::Commands::NotifyUpdateApplied::Id, kInvalidCommandId };
+const CommandId generatedCommands[] = { Clusters::OtaSoftwareUpdateProvider::Commands::QueryImageResponse::Id,
+                                        Clusters::OtaSoftwareUpdateProvider::Commands::ApplyUpdateResponse::Id, kInvalidCommandId };
+const EmberAfCluster otaProviderCluster{
+    .clusterId            = Clusters::OtaSoftwareUpdateProvider::Id,
+    .attributes           = nullptr,
+    .attributeCount       = 0,
+    .clusterSize          = 0,
+    .mask                 = CLUSTER_MASK_SERVER,
+    .functions            = nullptr,
+    .acceptedCommandList  = acceptedCommands,
+    .generatedCommandList = generatedCommands,
+    .eventList            = nullptr,
+    .eventCount           = 0,
+};
+const EmberAfEndpointType otaProviderEndpoint{ .cluster = &otaProviderCluster, .clusterCount = 1, .endpointSize = 0 };
+
+const EmberAfAttributeMetadata * FindAttributeMetadata(const EmberAfCluster * cluster, AttributeId attributeId)
+{
+    VerifyOrReturnValue(cluster != nullptr, nullptr);
+
+    for (uint16_t i = 0; i < cluster->attributeCount; i++)
+    {
+        if (cluster->attributes[i].attributeId == attributeId)
+        {
+            return &cluster->attributes[i];
+        }
+    }
+
+    return nullptr;
+}
 
 } // anonymous namespace
 
 namespace chip {
 namespace app {
+namespace dynamic_server {
+
+DynamicDataModelRegistry & DynamicDataModelRegistry::Instance()
+{
+    static DynamicDataModelRegistry registry;
+    static const bool initialized = [] {
+        LogErrorOnFailure(registry.AddEndpoint(kOtaProviderEndpoint, &otaProviderEndpoint));
+        registry.SetCommandDispatch(OtaSoftwareUpdateProvider::Id, DispatchOtaProviderCommand);
+        return true;
+    }();
+    (void) initialized;
+    return registry;
+}
+
+} // namespace dynamic_server
 
 using Access::SubjectDescriptor;
 using Protocols::InteractionModel::Status;
@@ -93,23 +171,20 @@ bool IsSupportedGlobalAttribute(AttributeId aAttribute)
 
 Status DetermineAttributeStatus(const ConcreteAttributePath & aPath, bool aIsWrite)
 {
-    // TODO: Consider making this configurable for applications that are not
-    // trying to be an OTA provider, though in practice it just affects which
-    // error is returned.
-    if (aPath.mEndpointId != kSupportedEndpoint)
+    DynamicDataModelRegistry & registry = DynamicDataModelRegistry::Instance();
+
+    if (registry.FindEndpointType(aPath.mEndpointId) == nullptr)
     {
         return Status::UnsupportedEndpoint;
     }
 
-    // TODO: Consider making this configurable for applications that are not
-    // trying to be an OTA provider, though in practice it just affects which
-    // error is returned.
-    if (aPath.mClusterId != OtaSoftwareUpdateProvider::Id)
+    const EmberAfCluster * cluster = registry.FindServerCluster(aPath.mEndpointId, aPath.mClusterId);
+    if (cluster == nullptr)
     {
         return Status::UnsupportedCluster;
     }
 
-    if (!IsSupportedGlobalAttribute(aPath.mAttributeId))
+    if (!IsSupportedGlobalAttribute(aPath.mAttributeId) && FindAttributeMetadata(cluster, aPath.mAttributeId) == nullptr)
     {
         return Status::UnsupportedAttribute;
     }
@@ -136,28 +211,25 @@ bool ConcreteAttributePathExists(const ConcreteAttributePath & aPath)
 
 Status ServerClusterCommandExists(const ConcreteCommandPath & aPath)
 {
-    // TODO: Consider making this configurable for applications that are not
-    // trying to be an OTA provider.
-    using namespace OtaSoftwareUpdateProvider::Commands;
+    DynamicDataModelRegistry & registry = DynamicDataModelRegistry::Instance();
 
-    if (aPath.mEndpointId != kSupportedEndpoint)
+    if (registry.FindEndpointType(aPath.mEndpointId) == nullptr)
     {
         return Status::UnsupportedEndpoint;
     }
 
-    if (aPath.mClusterId != OtaSoftwareUpdateProvider::Id)
+    const EmberAfCluster * cluster = registry.FindServerCluster(aPath.mEndpointId, aPath.mClusterId);
+    if (cluster == nullptr)
     {
         return Status::UnsupportedCluster;
     }
 
-    switch (aPath.mCommandId)
+    for (const CommandId * command = cluster->acceptedCommandList; command != nullptr && *command != kInvalidCommandId; command++)
     {
-    case QueryImage::Id:
-        FALLTHROUGH;
-    case ApplyUpdateRequest::Id:
-        FALLTHROUGH;
-    case NotifyUpdateApplied::Id:
-        return Status::Success;
+        if (*command == aPath.mCommandId)
+        {
+            return Status::Success;
+        }
     }
 
     return Status::UnsupportedCommand;
@@ -171,7 +243,15 @@ bool IsClusterDataVersionEqual(const ConcreteClusterPath & aConcreteClusterPath,
 
 const EmberAfAttributeMetadata * GetAttributeMetadata(const ConcreteAttributePath & aConcreteClusterPath)
 {
-    // Note: This test does not make use of the real attribute metadata.
+    const EmberAfCluster * cluster =
+        DynamicDataModelRegistry::Instance().FindServerCluster(aConcreteClusterPath.mEndpointId, aConcreteClusterPath.mClusterId);
+    const EmberAfAttributeMetadata * metadata = FindAttributeMetadata(cluster, aConcreteClusterPath.mAttributeId);
+    if (metadata != nullptr)
+    {
+        return metadata;
+    }
+
+    // Note: Global attributes do not make use of the real attribute metadata.
     static EmberAfAttributeMetadata stub = { .defaultValue = EmberAfDefaultOrMinMaxAttributeValue(uint32_t(0)) };
     return &stub;
 }
@@ -192,45 +272,9 @@ void DispatchSingleClusterCommand(const ConcreteCommandPath & aPath, TLV::TLVRea
 {
     // This command passed ServerClusterCommandExists so we know it's one of our
     // supported commands.
-    using namespace OtaSoftwareUpdateProvider::Commands;
-
-    bool wasHandled = false;
-    CHIP_ERROR err  = CHIP_NO_ERROR;
+    dynamic_server::CommandDispatchFunction dispatch = DynamicDataModelRegistry::Instance().GetCommandDispatch(aPath.mClusterId);
 
-    switch (aPath.mCommandId)
-    {
-    case QueryImage::Id: {
-        QueryImage::DecodableType commandData;
-        err = DataModel::Decode(aReader, commandData);
-        if (err == CHIP_NO_ERROR)
-        {
-            wasHandled = emberAfOtaSoftwareUpdateProviderClusterQueryImageCallback(aCommandObj, aPath, commandData);
-        }
-        break;
-    }
-    case ApplyUpdateRequest::Id: {
-        ApplyUpdateRequest::DecodableType commandData;
-        err = DataModel::Decode(aReader, commandData);
-        if (err == CHIP_NO_ERROR)
-        {
-            wasHandled = emberAfOtaSoftwareUpdateProviderClusterApplyUpdateRequestCallback(aCommandObj, aPath, commandData);
-        }
-        break;
-    }
-    case NotifyUpdateApplied::Id: {
-        NotifyUpdateApplied::DecodableType commandData;
-        err = DataModel::Decode(aReader, commandData);
-        if (err == CHIP_NO_ERROR)
-        {
-            wasHandled = emberAfOtaSoftwareUpdateProviderClusterNotifyUpdateAppliedCallback(aCommandObj, aPath, commandData);
-        }
-        break;
-    }
-    default:
-        break;
-    }
-
-    if (CHIP_NO_ERROR != err || !wasHandled)
+    if (dispatch == nullptr || !dispatch(aPath, aReader, aCommandObj))
     {
         aCommandObj->AddStatus(aPath, Status::InvalidCommand);
     }
@@ -245,57 +289,56 @@ Protocols::InteractionModel::Status CheckEventSupportStatus(const ConcreteEventP
 } // namespace chip
 
 /**
- * Called by the OTA provider cluster server to determine an index
- * into its array.
+ * Called by cluster servers (such as the OTA provider) to determine an index
+ * into their per-endpoint arrays.
  */
 uint16_t emberAfGetClusterServerEndpointIndex(EndpointId endpoint, ClusterId cluster, uint16_t fixedClusterServerEndpointCount)
 {
-    if (endpoint == kSupportedEndpoint && cluster == OtaSoftwareUpdateProvider::Id)
-    {
-        return 0;
-    }
-
-    return UINT16_MAX;
+    return DynamicDataModelRegistry::Instance().ClusterServerEndpointIndex(endpoint, cluster, fixedClusterServerEndpointCount);
 }
 
 /**
  * Methods used by AttributePathExpandIterator, which need to exist
- * because it is part of libCHIP.  For AttributePathExpandIterator
- * purposes, for now, we just pretend like we have just our one
- * endpoint, the OTA Provider cluster, and no attributes (because we
- * would be erroring out from them anyway).
+ * because it is part of libCHIP.  These expose the endpoints and clusters of
+ * the dynamic data model registry.
  */
 uint16_t emberAfGetServerAttributeCount(EndpointId endpoint, ClusterId cluster)
 {
-    return 0;
+    const EmberAfCluster * serverCluster = DynamicDataModelRegistry::Instance().FindServerCluster(endpoint, cluster);
+    return (serverCluster == nullptr) ? 0 : serverCluster->attributeCount;
 }
 
 uint16_t emberAfEndpointCount(void)
 {
-    return 1;
+    return DynamicDataModelRegistry::Instance().EndpointIndexCount();
 }
 
 uint16_t emberAfIndexFromEndpoint(EndpointId endpoint)
 {
-    if (endpoint == kSupportedEndpoint)
-    {
-        return 0;
-    }
-
-    return UINT16_MAX;
+    return DynamicDataModelRegistry::Instance().IndexOfEndpoint(endpoint);
 }
 
 EndpointId emberAfEndpointFromIndex(uint16_t index)
 {
-    // Index must be valid here, so 0.
-    return kSupportedEndpoint;
+    return DynamicDataModelRegistry::Instance().EndpointAtIndex(index);
 }
 
 Optional<ClusterId> emberAfGetNthClusterId(EndpointId endpoint, uint8_t n, bool server)
 {
-    if (endpoint == kSupportedEndpoint && n == 0 && server)
+    const EmberAfEndpointType * endpointType = DynamicDataModelRegistry::Instance().FindEndpointType(endpoint);
+    VerifyOrReturnValue(endpointType != nullptr, NullOptional);
+
+    for (uint8_t i = 0; i < endpointType->clusterCount; i++)
     {
-        return MakeOptional(OtaSoftwareUpdateProvider::Id);
+        const EmberAfCluster & cluster = endpointType->cluster[i];
+        if (cluster.IsServer() == server)
+        {
+            if (n == 0)
+            {
+                return MakeOptional(cluster.clusterId);
+            }
+            n--;
+        }
     }
 
     return NullOptional;
@@ -303,81 +346,49 @@ Optional<ClusterId> emberAfGetNthClusterId(EndpointId endpoint, uint8_t n, bool
 
 uint16_t emberAfGetServerAttributeIndexByAttributeId(EndpointId endpoint, ClusterId cluster, AttributeId attributeId)
 {
-    return UINT16_MAX;
+    const EmberAfCluster * serverCluster = DynamicDataModelRegistry::Instance().FindServerCluster(endpoint, cluster);
+    const EmberAfAttributeMetadata * metadata = FindAttributeMetadata(serverCluster, attributeId);
+    return (metadata == nullptr) ? UINT16_MAX : static_cast<uint16_t>(metadata - serverCluster->attributes);
 }
 
 bool emberAfContainsAttribute(chip::EndpointId endpoint, chip::ClusterId clusterId, chip::AttributeId attributeId)
 {
-    return false;
+    return FindAttributeMetadata(DynamicDataModelRegistry::Instance().FindServerCluster(endpoint, clusterId), attributeId) !=
+        nullptr;
 }
 
 uint8_t emberAfClusterCount(EndpointId endpoint, bool server)
 {
-    if (endpoint == kSupportedEndpoint && server)
-    {
-        return 1;
-    }
-
-    return 0;
+    return DynamicDataModelRegistry::Instance().ClusterCount(endpoint, server);
 }
 
 Optional<AttributeId> emberAfGetServerAttributeIdByIndex(EndpointId endpoint, ClusterId cluster, uint16_t attributeIndex)
 {
-    return NullOptional;
+    const EmberAfCluster * serverCluster = DynamicDataModelRegistry::Instance().FindServerCluster(endpoint, cluster);
+    if (serverCluster == nullptr || attributeIndex >= serverCluster->attributeCount)
+    {
+        return NullOptional;
+    }
+
+    return MakeOptional(serverCluster->attributes[attributeIndex].attributeId);
 }
 
 uint8_t emberAfClusterIndex(EndpointId endpoint, ClusterId clusterId, EmberAfClusterMask mask)
 {
-    if (endpoint == kSupportedEndpoint && clusterId == OtaSoftwareUpdateProvider::Id && (mask & CLUSTER_MASK_SERVER))
-    {
-        return 0;
-    }
-
-    return UINT8_MAX;
+    return DynamicDataModelRegistry::Instance().ClusterIndex(endpoint, clusterId, mask);
 }
 
 bool emberAfEndpointIndexIsEnabled(uint16_t index)
 {
-    return index == 0;
+    return DynamicDataModelRegistry::Instance().IsIndexEnabled(index);
 }
 
-namespace {
-const CommandId acceptedCommands[]  = { Clusters::OtaSoftwareUpdateProvider::Commands::QueryImage::Id,
-                                        Clusters::OtaSoftwareUpdateProvider::Commands::ApplyUpdateRequest::Id,
-                                        Clusters::OtaSoftwareUpdateProvider::Commands::NotifyUpdateApplied::Id, kInvalidCommandId };
-const CommandId generatedCommands[] = { Clusters::OtaSoftwareUpdateProvider::Commands::QueryImageResponse::Id,
-                                        Clusters::OtaSoftwareUpdateProvider::Commands::ApplyUpdateResponse::Id, kInvalidCommandId };
-const EmberAfCluster otaProviderCluster{
-    .clusterId            = Clusters::OtaSoftwareUpdateProvider::Id,
-    .attributes           = nullptr,
-    .attributeCount       = 0,
-    .clusterSize          = 0,
-    .mask                 = CLUSTER_MASK_SERVER,
-    .functions            = nullptr,
-    .acceptedCommandList  = acceptedCommands,
-    .generatedCommandList = generatedCommands,
-    .eventList            = nullptr,
-    .eventCount           = 0,
-};
-const EmberAfEndpointType otaProviderEndpoint{ .cluster = &otaProviderCluster, .clusterCount = 1, .endpointSize = 0 };
-} // namespace
-
 const EmberAfEndpointType * emberAfFindEndpointType(EndpointId endpoint)
 {
-    if (endpoint == kSupportedEndpoint)
-    {
-        return &otaProviderEndpoint;
-    }
-
-    return nullptr;
+    return DynamicDataModelRegistry::Instance().FindEndpointType(endpoint);
 }
 
 const EmberAfCluster * emberAfFindServerCluster(EndpointId endpoint, ClusterId cluster)
 {
-    if (endpoint == kSupportedEndpoint && cluster == Clusters::OtaSoftwareUpdateProvider::Id)
-    {
-        return &otaProviderCluster;
-    }
-
-    return nullptr;
+    return DynamicDataModelRegistry::Instance().FindServerCluster(endpoint, cluster);
 }
@@ -0,0 +1,264 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/dynamic_server/DynamicDataModelRegistry.h>
+#include <lib/support/CodeUtils.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdio.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::app;
+using chip::app::dynamic_server::DynamicDataModelRegistry;
+
+constexpr ClusterId kOnOffClusterId        = 0x0006;
+constexpr ClusterId kLevelControlClusterId = 0x0008;
+constexpr ClusterId kDescriptorClusterId   = 0x001D;
+constexpr ClusterId kBindingClusterId      = 0x001E;
+constexpr CommandId kOnCommandId           = 0x01;
+
+const EmberAfAttributeMetadata onOffAttributes[] = { { .defaultValue = EmberAfDefaultOrMinMaxAttributeValue(uint32_t(0)),
+                                                       .attributeId  = 0x0000 } };
+const CommandId onOffAcceptedCommands[] = { 0x00, kOnCommandId, kInvalidCommandId };
+
+const EmberAfCluster bridgedLightClusters[] = {
+    { .clusterId = kDescriptorClusterId, .mask = CLUSTER_MASK_SERVER },
+    { .clusterId = kBindingClusterId, .mask = CLUSTER_MASK_CLIENT },
+    { .clusterId           = kOnOffClusterId,
+      .attributes          = onOffAttributes,
+      .attributeCount      = ArraySize(onOffAttributes),
+      .mask                = CLUSTER_MASK_SERVER,
+      .acceptedCommandList = onOffAcceptedCommands },
+    { .clusterId = kLevelControlClusterId, .mask = CLUSTER_MASK_SERVER },
+};
+const EmberAfEndpointType bridgedLightEndpoint{ .cluster      = bridgedLightClusters,
+                                                .clusterCount = ArraySize(bridgedLightClusters),
+                                                .endpointSize = 0 };
+
+const EmberAfCluster aggregatorClusters[] = {
+    { .clusterId = kDescriptorClusterId, .mask = CLUSTER_MASK_SERVER },
+    { .clusterId = kOnOffClusterId, .mask = CLUSTER_MASK_CLIENT },
+};
+const EmberAfEndpointType aggregatorEndpoint{ .cluster      = aggregatorClusters,
+                                              .clusterCount = ArraySize(aggregatorClusters),
+                                              .endpointSize = 0 };
+
+bool gDispatched = false;
+
+bool DispatchOnOff(const ConcreteCommandPath & path, TLV::TLVReader & reader, CommandHandler * handler)
+{
+    gDispatched = true;
+    return true;
+}
+
+TEST(TestDynamicDataModelRegistry, TestAddFindRemove)
+{
+    DynamicDataModelRegistry registry;
+
+    EXPECT_EQ(registry.AddEndpoint(3, &bridgedLightEndpoint), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.AddEndpoint(7, &bridgedLightEndpoint), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.AddEndpoint(3, &bridgedLightEndpoint), CHIP_ERROR_DUPLICATE_KEY_ID);
+
+    EXPECT_EQ(registry.EndpointIndexCount(), 2u);
+    EXPECT_EQ(registry.IndexOfEndpoint(3), 0u);
+    EXPECT_EQ(registry.IndexOfEndpoint(7), 1u);
+    EXPECT_EQ(registry.EndpointAtIndex(1), 7u);
+    EXPECT_EQ(registry.FindEndpointType(7), &bridgedLightEndpoint);
+
+    EXPECT_EQ(registry.FindServerCluster(3, kOnOffClusterId), &bridgedLightClusters[2]);
+    EXPECT_EQ(registry.FindServerCluster(3, kBindingClusterId), nullptr);
+    EXPECT_EQ(registry.FindCluster(3, kBindingClusterId, CLUSTER_MASK_CLIENT), &bridgedLightClusters[1]);
+    EXPECT_EQ(registry.ClusterIndex(3, kOnOffClusterId, CLUSTER_MASK_SERVER), 1u);
+    EXPECT_EQ(registry.ClusterIndex(3, kLevelControlClusterId, CLUSTER_MASK_SERVER), 2u);
+    EXPECT_EQ(registry.ClusterIndex(3, kBindingClusterId, CLUSTER_MASK_CLIENT), 0u);
+    EXPECT_EQ(registry.ClusterIndex(3, kBindingClusterId, CLUSTER_MASK_SERVER), UINT8_MAX);
+    EXPECT_EQ(registry.ClusterCount(3, /* server = */ true), 3u);
+    EXPECT_EQ(registry.ClusterCount(3, /* server = */ false), 1u);
+
+    // Removing an endpoint disables its index without moving the others.
+    EXPECT_EQ(registry.RemoveEndpoint(3), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.RemoveEndpoint(3), CHIP_ERROR_NOT_FOUND);
+    EXPECT_FALSE(registry.IsIndexEnabled(0));
+    EXPECT_TRUE(registry.IsIndexEnabled(1));
+    EXPECT_EQ(registry.IndexOfEndpoint(7), 1u);
+    EXPECT_EQ(registry.IndexOfEndpoint(3), DynamicDataModelRegistry::kInvalidIndex);
+    EXPECT_EQ(registry.FindServerCluster(3, kOnOffClusterId), nullptr);
+
+    // The freed index is reused.
+    EXPECT_EQ(registry.AddEndpoint(9, &bridgedLightEndpoint), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.IndexOfEndpoint(9), 0u);
+    EXPECT_EQ(registry.EndpointIndexCount(), 2u);
+}
+
+TEST(TestDynamicDataModelRegistry, TestClusterServerEndpointIndex)
+{
+    constexpr uint16_t kFixedCount = 2;
+    constexpr uint16_t kInvalid    = DynamicDataModelRegistry::kInvalidIndex;
+
+    DynamicDataModelRegistry registry;
+
+    // Only the light endpoints host the On/Off server; the others have no index into its per-endpoint arrays.
+    EXPECT_EQ(registry.AddEndpoint(1, &aggregatorEndpoint), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.AddEndpoint(3, &bridgedLightEndpoint), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.AddEndpoint(4, &aggregatorEndpoint), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.AddEndpoint(7, &bridgedLightEndpoint), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.AddEndpoint(9, &bridgedLightEndpoint), CHIP_NO_ERROR);
+
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(1, kOnOffClusterId, kFixedCount), kInvalid);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(3, kOnOffClusterId, kFixedCount), kFixedCount + 1u);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(4, kOnOffClusterId, kFixedCount), kInvalid);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(7, kOnOffClusterId, kFixedCount), kFixedCount + 3u);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(9, kOnOffClusterId, kFixedCount), kFixedCount + 4u);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(2, kOnOffClusterId, kFixedCount), kInvalid);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(3, kBindingClusterId, kFixedCount), kInvalid);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(4, kDescriptorClusterId, 0), 2u);
+
+    // Adding and removing other endpoints does not move the state of an endpoint to another one.
+    EXPECT_EQ(registry.RemoveEndpoint(3), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(3, kOnOffClusterId, kFixedCount), kInvalid);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(7, kOnOffClusterId, kFixedCount), kFixedCount + 3u);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(9, kOnOffClusterId, kFixedCount), kFixedCount + 4u);
+
+    EXPECT_EQ(registry.AddEndpoint(11, &bridgedLightEndpoint), CHIP_NO_ERROR);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(11, kOnOffClusterId, kFixedCount), kFixedCount + 1u);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(7, kOnOffClusterId, kFixedCount), kFixedCount + 3u);
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(9, kOnOffClusterId, kFixedCount), kFixedCount + 4u);
+
+    // Indices that cannot be represented are invalid.
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(9, kOnOffClusterId, static_cast<uint16_t>(kInvalid - 4)), kInvalid);
+
+    registry.Clear();
+    EXPECT_EQ(registry.ClusterServerEndpointIndex(7, kOnOffClusterId, kFixedCount), kInvalid);
+}
+
+TEST(TestDynamicDataModelRegistry, TestCommandDispatch)
+{
+    DynamicDataModelRegistry registry;
+
+    EXPECT_EQ(registry.GetCommandDispatch(kOnOffClusterId), nullptr);
+    registry.SetCommandDispatch(kOnOffClusterId, DispatchOnOff);
+
+    dynamic_server::CommandDispatchFunction dispatch = registry.GetCommandDispatch(kOnOffClusterId);
+    ASSERT_NE(dispatch, nullptr);
+
+    TLV::TLVReader reader;
+    gDispatched = false;
+    EXPECT_TRUE(dispatch(ConcreteCommandPath(1, kOnOffClusterId, kOnCommandId), reader, nullptr));
+    EXPECT_TRUE(gDispatched);
+}
+
+// Add, resolve and churn a bridge-scale number of endpoints.
+TEST(TestDynamicDataModelRegistry, TestBridgeScale)
+{
+    constexpr EndpointId kFirstEndpoint = 2;
+    constexpr uint16_t kEndpointCount   = 5000;
+
+    DynamicDataModelRegistry registry;
+
+    for (uint16_t i = 0; i < kEndpointCount; i++)
+    {
+        ASSERT_EQ(registry.AddEndpoint(static_cast<EndpointId>(kFirstEndpoint + i), &bridgedLightEndpoint), CHIP_NO_ERROR);
+    }
+
+    for (uint16_t i = 0; i < kEndpointCount; i++)
+    {
+        EndpointId endpoint = static_cast<EndpointId>(kFirstEndpoint + i);
+        EXPECT_NE(registry.FindServerCluster(endpoint, kOnOffClusterId), nullptr);
+        EXPECT_EQ(registry.ClusterIndex(endpoint, kLevelControlClusterId, CLUSTER_MASK_SERVER), 2u);
+        EXPECT_EQ(registry.IndexOfEndpoint(endpoint), i);
+        EXPECT_EQ(registry.ClusterServerEndpointIndex(endpoint, kOnOffClusterId, 0), i);
+    }
+
+    // Remove every other endpoint and add replacements; the index space must not grow, and the remaining endpoints keep
+    // their indices.
+    for (uint16_t i = 0; i < kEndpointCount; i += 2)
+    {
+        ASSERT_EQ(registry.RemoveEndpoint(static_cast<EndpointId>(kFirstEndpoint + i)), CHIP_NO_ERROR);
+    }
+    for (uint16_t i = 0; i < kEndpointCount; i += 2)
+    {
+        ASSERT_EQ(registry.AddEndpoint(static_cast<EndpointId>(kFirstEndpoint + kEndpointCount + i), &bridgedLightEndpoint),
+                  CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(registry.EndpointIndexCount(), kEndpointCount);
+    for (uint16_t i = 1; i < kEndpointCount; i += 2)
+    {
+        EXPECT_EQ(registry.ClusterServerEndpointIndex(static_cast<EndpointId>(kFirstEndpoint + i), kOnOffClusterId, 0), i);
+    }
+}
+
+// Not a pass/fail test, so disabled by default: reports the cost of adding, resolving and churning 5000 endpoints.
+TEST(TestDynamicDataModelRegistry, DISABLED_BenchmarkBridgeScale)
+{
+    constexpr EndpointId kFirstEndpoint = 2;
+    constexpr uint16_t kEndpointCount   = 5000;
+    constexpr int kLookupRounds         = 20;
+
+    DynamicDataModelRegistry registry;
+    using Clock = std::chrono::steady_clock;
+
+    auto start = Clock::now();
+    for (uint16_t i = 0; i < kEndpointCount; i++)
+    {
+        ASSERT_EQ(registry.AddEndpoint(static_cast<EndpointId>(kFirstEndpoint + i), &bridgedLightEndpoint), CHIP_NO_ERROR);
+    }
+    auto addTime = Clock::now() - start;
+
+    size_t found = 0;
+    start        = Clock::now();
+    for (int round = 0; round < kLookupRounds; round++)
+    {
+        for (uint16_t i = 0; i < kEndpointCount; i++)
+        {
+            EndpointId endpoint = static_cast<EndpointId>(kFirstEndpoint + i);
+            if (registry.FindServerCluster(endpoint, kOnOffClusterId) != nullptr &&
+                registry.ClusterIndex(endpoint, kLevelControlClusterId, CLUSTER_MASK_SERVER) != UINT8_MAX &&
+                registry.ClusterServerEndpointIndex(endpoint, kOnOffClusterId, 0) == i)
+            {
+                found++;
+            }
+        }
+    }
+    auto lookupTime = Clock::now() - start;
+    EXPECT_EQ(found, static_cast<size_t>(kLookupRounds) * kEndpointCount);
+
+    start = Clock::now();
+    for (uint16_t i = 0; i < kEndpointCount; i += 2)
+    {
+        ASSERT_EQ(registry.RemoveEndpoint(static_cast<EndpointId>(kFirstEndpoint + i)), CHIP_NO_ERROR);
+    }
+    for (uint16_t i = 0; i < kEndpointCount; i += 2)
+    {
+        ASSERT_EQ(registry.AddEndpoint(static_cast<EndpointId>(kFirstEndpoint + kEndpointCount + i), &bridgedLightEndpoint),
+                  CHIP_NO_ERROR);
+    }
+    auto churnTime = Clock::now() - start;
+
+    using std::chrono::duration_cast;
+    using std::chrono::nanoseconds;
+    printf("%u endpoints: add %u ns/endpoint, lookup %u ns/path, remove+add %u ns/endpoint\n", kEndpointCount,
+           static_cast<unsigned>(duration_cast<nanoseconds>(addTime).count() / kEndpointCount),
+           static_cast<unsigned>(duration_cast<nanoseconds>(lookupTime).count() / (kLookupRounds * kEndpointCount * 3)),
+           static_cast<unsigned>(duration_cast<nanoseconds>(churnTime).count() / kEndpointCount));
+}
+
+} // namespace
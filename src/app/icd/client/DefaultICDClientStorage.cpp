@@ -18,7 +18,9 @@
 #include <app/icd/client/DefaultICDClientStorage.h>
 #include <iterator>
 #include <lib/core/Global.h>
+#include <lib/core/CHIPEncoding.h>
 #include <lib/support/Base64.h>
+#include <lib/support/BufferWriter.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/DefaultStorageKeyAllocator.h>
 #include <lib/support/SafeInt.h>
@@ -35,6 +37,15 @@ constexpr size_t kFabricIndexMax = 255;
 
 constexpr size_t kMaxFabricListTlvLength = kFabricIndexTlvSize * kFabricIndexMax + kArrayOverHead;
 static_assert(kMaxFabricListTlvLength <= std::numeric_limits<uint16_t>::max(), "Expected size for fabric list TLV is too large!");
+
+// The Check-In index is keyed by the first 8 bytes of the 13-byte nonce.  A collision between two ICDs only costs a failed
+// decryption followed by the full scan.
+static_assert(chip::Crypto::CHIP_CRYPTO_AEAD_NONCE_LENGTH_BYTES >= sizeof(uint64_t), "Check-In nonce is too short for its tag");
+
+uint64_t NonceTag(const uint8_t * nonce)
+{
+    return chip::Encoding::LittleEndian::Get64(nonce);
+}
 } // namespace
 
 namespace chip {
@@ -50,6 +61,8 @@ CHIP_ERROR DefaultICDClientStorage::UpdateFabricList(FabricIndex fabricIndex)
     }
 
     mFabricList.push_back(fabricIndex);
+    // Entries of the new fabric may already be persisted, reload the Check-In index on next use.
+    ClearCheckInIndex();
 
     Platform::ScopedMemoryBuffer<uint8_t> backingBuffer;
     size_t counter = mFabricList.size();
@@ -364,6 +377,12 @@ CHIP_ERROR DefaultICDClientStorage::StoreEntry(const ICDClientInfo & clientInfo)
         DefaultStorageKeyAllocator::ICDClientInfoKey(clientInfo.peer_node.GetFabricIndex()).KeyName(), backingBuffer.Get(),
         static_cast<uint16_t>(len)));
 
+    if (mCheckInIndexLoaded)
+    {
+        RemoveFromCheckInIndex(clientInfo.peer_node);
+        AddToCheckInIndex(clientInfo);
+    }
+
     return IncreaseEntryCountForFabric(clientInfo.peer_node.GetFabricIndex());
 }
 
@@ -426,6 +445,12 @@ CHIP_ERROR DefaultICDClientStorage::DeleteEntry(const ScopedNodeId & peerNode)
         }
     }
 
+    // The index holds copies of the key handles that were just destroyed.
+    if (mCheckInIndexLoaded)
+    {
+        RemoveFromCheckInIndex(peerNode);
+    }
+
     ReturnErrorOnFailure(
         mpClientInfoStore->SyncDeleteKeyValue(DefaultStorageKeyAllocator::ICDClientInfoKey(peerNode.GetFabricIndex()).KeyName()));
 
@@ -456,30 +481,221 @@ CHIP_ERROR DefaultICDClientStorage::DeleteAllEntries(FabricIndex fabricIndex)
     for (auto & clientInfo : clientInfoVector)
     {
         RemoveKey(clientInfo);
+        if (mCheckInIndexLoaded)
+        {
+            RemoveFromCheckInIndex(clientInfo.peer_node);
+        }
     }
     ReturnErrorOnFailure(
         mpClientInfoStore->SyncDeleteKeyValue(DefaultStorageKeyAllocator::ICDClientInfoKey(fabricIndex).KeyName()));
     return mpClientInfoStore->SyncDeleteKeyValue(DefaultStorageKeyAllocator::FabricICDClientInfoCounter(fabricIndex).KeyName());
 }
 
-CHIP_ERROR DefaultICDClientStorage::ProcessCheckInPayload(const ByteSpan & payload, ICDClientInfo & clientInfo,
-                                                          Protocols::SecureChannel::CounterType & counter)
+CHIP_ERROR DefaultICDClientStorage::LoadCheckInIndex()
 {
-    uint8_t appDataBuffer[kAppDataLength];
-    MutableByteSpan appData(appDataBuffer);
+    ClearCheckInIndex();
+
     auto * iterator = IterateICDClientInfo();
     VerifyOrReturnError(iterator != nullptr, CHIP_ERROR_NO_MEMORY);
+    ICDClientInfoIteratorWrapper clientInfoIteratorWrapper(iterator);
+
+    ICDClientInfo clientInfo;
     while (iterator->Next(clientInfo))
     {
-        CHIP_ERROR err = chip::Protocols::SecureChannel::CheckinMessage::ParseCheckinMessagePayload(
-            clientInfo.aes_key_handle, clientInfo.hmac_key_handle, payload, counter, appData);
-        if (CHIP_NO_ERROR == err)
+        AddToCheckInIndex(clientInfo);
+    }
+
+    mCheckInIndexLoaded = true;
+    return CHIP_NO_ERROR;
+}
+
+void DefaultICDClientStorage::ClearCheckInIndex()
+{
+    mCheckInIndexLoaded = false;
+    mCheckInIndex.clear();
+    mCheckInNonceTags.clear();
+}
+
+void DefaultICDClientStorage::AddToCheckInIndex(const ICDClientInfo & clientInfo)
+{
+    CheckInIndexEntry entry;
+    entry.clientInfo = clientInfo;
+    mCheckInIndex.push_back(entry);
+
+    // Counter values up to start_icd_counter + offset were already received, so the next Check-In uses a later one.
+    Protocols::SecureChannel::CounterType nextCounter = clientInfo.start_icd_counter + clientInfo.offset + 1;
+    CHIP_ERROR err                                    = MoveCheckInWindow(mCheckInIndex.size() - 1, nextCounter);
+    if (err != CHIP_NO_ERROR)
+    {
+        // The entry can still be matched by the full scan.
+        ChipLogError(ICD, "Failed to index Check-In nonces for " ChipLogFormatScopedNodeId ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueScopedNodeId(clientInfo.peer_node), err.Format());
+    }
+}
+
+void DefaultICDClientStorage::RemoveFromCheckInIndex(const ScopedNodeId & peerNode)
+{
+    for (size_t entryIndex = 0; entryIndex < mCheckInIndex.size(); entryIndex++)
+    {
+        if (mCheckInIndex[entryIndex].clientInfo.peer_node != peerNode)
+        {
+            continue;
+        }
+
+        EraseNonceTags(entryIndex);
+
+        // Move the last entry into the freed slot and repoint its nonce tags.
+        size_t lastIndex = mCheckInIndex.size() - 1;
+        if (entryIndex != lastIndex)
+        {
+            mCheckInIndex[entryIndex] = mCheckInIndex[lastIndex];
+            if (mCheckInIndex[entryIndex].hasWindow)
+            {
+                for (uint64_t tag : mCheckInIndex[entryIndex].nonceTags)
+                {
+                    auto it = mCheckInNonceTags.find(tag);
+                    if (it != mCheckInNonceTags.end() && it->second == lastIndex)
+                    {
+                        it->second = entryIndex;
+                    }
+                }
+            }
+        }
+        mCheckInIndex.pop_back();
+        return;
+    }
+}
+
+void DefaultICDClientStorage::EraseNonceTags(size_t entryIndex)
+{
+    CheckInIndexEntry & entry = mCheckInIndex[entryIndex];
+    if (!entry.hasWindow)
+    {
+        return;
+    }
+
+    for (uint64_t tag : entry.nonceTags)
+    {
+        auto it = mCheckInNonceTags.find(tag);
+        if (it != mCheckInNonceTags.end() && it->second == entryIndex)
+        {
+            mCheckInNonceTags.erase(it);
+        }
+    }
+    entry.hasWindow = false;
+}
+
+CHIP_ERROR DefaultICDClientStorage::MoveCheckInWindow(size_t entryIndex, Protocols::SecureChannel::CounterType windowStart)
+{
+    using Protocols::SecureChannel::CounterType;
+
+    CheckInIndexEntry & entry = mCheckInIndex[entryIndex];
+
+    // Only the counter values that enter the window need a new nonce; when the window moves by more than its size, or was
+    // never computed, all of them do.
+    CounterType firstNewCounter = windowStart;
+    if (entry.hasWindow && static_cast<CounterType>(windowStart - entry.windowStart) < kCheckInCounterWindow)
+    {
+        firstNewCounter = entry.windowStart + kCheckInCounterWindow;
+    }
+    else
+    {
+        EraseNonceTags(entryIndex);
+    }
+
+    CounterType windowEnd = windowStart + kCheckInCounterWindow;
+    for (CounterType counter = firstNewCounter; counter != windowEnd; counter++)
+    {
+        uint64_t & slot = entry.nonceTags[counter % kCheckInCounterWindow];
+        if (entry.hasWindow)
+        {
+            // The slot holds the tag of the counter value that leaves the window.
+            auto it = mCheckInNonceTags.find(slot);
+            if (it != mCheckInNonceTags.end() && it->second == entryIndex)
+            {
+                mCheckInNonceTags.erase(it);
+            }
+        }
+
+        uint8_t nonce[Crypto::CHIP_CRYPTO_AEAD_NONCE_LENGTH_BYTES];
+        Encoding::LittleEndian::BufferWriter writer(nonce, sizeof(nonce));
+        CHIP_ERROR err = Protocols::SecureChannel::CheckinMessage::GenerateCheckInMessageNonce(entry.clientInfo.hmac_key_handle,
+                                                                                              counter, writer);
+        if (err != CHIP_NO_ERROR)
+        {
+            // Drop the whole window, including the tags added so far; the entry is left to the full scan.
+            entry.hasWindow = true;
+            EraseNonceTags(entryIndex);
+            return err;
+        }
+
+        slot                    = NonceTag(nonce);
+        mCheckInNonceTags[slot] = entryIndex;
+    }
+
+    entry.windowStart = windowStart;
+    entry.hasWindow   = true;
+    return CHIP_NO_ERROR;
+}
+
+bool DefaultICDClientStorage::TryCheckInEntry(size_t entryIndex, const ByteSpan & payload, ICDClientInfo & clientInfo,
+                                              Protocols::SecureChannel::CounterType & counter)
+{
+    using Protocols::SecureChannel::CounterType;
+
+    uint8_t appDataBuffer[kAppDataLength];
+    MutableByteSpan appData(appDataBuffer);
+    CheckInIndexEntry & entry = mCheckInIndex[entryIndex];
+    CounterType receivedCounter;
+    CHIP_ERROR err = Protocols::SecureChannel::CheckinMessage::ParseCheckinMessagePayload(
+        entry.clientInfo.aes_key_handle, entry.clientInfo.hmac_key_handle, payload, receivedCounter, appData);
+    if (err != CHIP_NO_ERROR)
+    {
+        return false;
+    }
+
+    clientInfo = entry.clientInfo;
+    counter    = receivedCounter;
+
+    // Keep the received counter in the window so that duplicates are matched cheaply too, and precompute the ones following it.
+    // Counter values that are behind the window (old or replayed messages) leave it as is.
+    if (!entry.hasWindow || static_cast<CounterType>(receivedCounter - entry.windowStart) < (1u << 31))
+    {
+        LogErrorOnFailure(MoveCheckInWindow(entryIndex, receivedCounter));
+    }
+    return true;
+}
+
+CHIP_ERROR DefaultICDClientStorage::ProcessCheckInPayload(const ByteSpan & payload, ICDClientInfo & clientInfo,
+                                                          Protocols::SecureChannel::CounterType & counter)
+{
+    if (!mCheckInIndexLoaded)
+    {
+        ReturnErrorOnFailure(LoadCheckInIndex());
+    }
+
+    size_t candidate = mCheckInIndex.size();
+    if (payload.size() >= Crypto::CHIP_CRYPTO_AEAD_NONCE_LENGTH_BYTES)
+    {
+        auto it = mCheckInNonceTags.find(NonceTag(payload.data()));
+        if (it != mCheckInNonceTags.end())
+        {
+            candidate = it->second;
+            if (TryCheckInEntry(candidate, payload, clientInfo, counter))
+            {
+                return CHIP_NO_ERROR;
+            }
+        }
+    }
+
+    // The nonce does not belong to any expected counter value, try every registered key.
+    for (size_t entryIndex = 0; entryIndex < mCheckInIndex.size(); entryIndex++)
+    {
+        if (entryIndex != candidate && TryCheckInEntry(entryIndex, payload, clientInfo, counter))
         {
-            iterator->Release();
             return CHIP_NO_ERROR;
         }
     }
-    iterator->Release();
     return CHIP_ERROR_NOT_FOUND;
 }
 } // namespace app
@@ -33,6 +33,7 @@
 #include <lib/core/TLV.h>
 #include <lib/support/CommonIterator.h>
 #include <lib/support/Pool.h>
+#include <unordered_map>
 #include <vector>
 
 // TODO: SymmetricKeystore is an alias for SessionKeystore, replace the below when sdk supports SymmetricKeystore
@@ -77,6 +78,13 @@ public:
 
     static constexpr size_t kIteratorsMax = CHIP_CONFIG_MAX_ICD_CLIENTS_INFO_STORAGE_CONCURRENT_ITERATORS;
 
+    /**
+     * Number of upcoming Check-In counter values for which the nonce of every registered ICD is precomputed.  A Check-In
+     * message whose counter falls in that window is matched to its sender with a single lookup and decryption; other ones
+     * (e.g. after the ICD skipped more counter values than the window covers) fall back to trying every registered key.
+     */
+    static constexpr uint8_t kCheckInCounterWindow = 8;
+
     CHIP_ERROR Init(PersistentStorageDelegate * clientInfoStore, Crypto::SymmetricKeystore * keyStore);
 
     /**
@@ -117,6 +125,10 @@ public:
      */
     CHIP_ERROR DeleteAllEntries(FabricIndex fabricIndex);
 
+    /**
+     * The first call loads every ICDClientInfo from storage into an in-memory Check-In index, which StoreEntry, DeleteEntry and
+     * DeleteAllEntries then keep up to date.  Later calls do not access storage.
+     */
     CHIP_ERROR ProcessCheckInPayload(const ByteSpan & payload, ICDClientInfo & clientInfo,
                                      Protocols::SecureChannel::CounterType & counter) override;
 
@@ -170,6 +182,25 @@ protected:
 
 private:
     friend class ICDClientInfoIteratorImpl;
+
+    struct CheckInIndexEntry
+    {
+        ICDClientInfo clientInfo;
+        // When hasWindow is true, nonceTags[c % kCheckInCounterWindow] holds the nonce tag of each Check-In counter c in
+        // [windowStart, windowStart + kCheckInCounterWindow).
+        bool hasWindow                                    = false;
+        Protocols::SecureChannel::CounterType windowStart = 0;
+        uint64_t nonceTags[kCheckInCounterWindow]         = {};
+    };
+
+    CHIP_ERROR LoadCheckInIndex();
+    void AddToCheckInIndex(const ICDClientInfo & clientInfo);
+    void RemoveFromCheckInIndex(const ScopedNodeId & peerNode);
+    void ClearCheckInIndex();
+    CHIP_ERROR MoveCheckInWindow(size_t entryIndex, Protocols::SecureChannel::CounterType windowStart);
+    void EraseNonceTags(size_t entryIndex);
+    bool TryCheckInEntry(size_t entryIndex, const ByteSpan & payload, ICDClientInfo & clientInfo,
+                         Protocols::SecureChannel::CounterType & counter);
     CHIP_ERROR LoadFabricList();
     CHIP_ERROR LoadCounter(FabricIndex fabricIndex, size_t & count, size_t & clientInfoSize);
 
@@ -185,6 +216,11 @@ private:
     PersistentStorageDelegate * mpClientInfoStore = nullptr;
     Crypto::SymmetricKeystore * mpKeyStore        = nullptr;
     std::vector<FabricIndex> mFabricList;
+
+    bool mCheckInIndexLoaded = false;
+    std::vector<CheckInIndexEntry> mCheckInIndex;
+    // Maps the leading bytes of an expected Check-In nonce to the position of its ICD in mCheckInIndex.
+    std::unordered_map<uint64_t, size_t> mCheckInNonceTags;
 };
 } // namespace app
 } // namespace chip
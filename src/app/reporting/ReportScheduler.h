@@ -216,6 +216,9 @@ public:
     /// @brief Get the number of ReadHandlers registered in the scheduler's node pool
     size_t GetNumReadHandlers() const { return mNodesPool.Allocated(); }
 
+    /// @brief Get the TimerDelegate used by the scheduler, so that other timers of the engine can share its time source
+    TimerDelegate * GetTimerDelegate() const { return mTimerDelegate; }
+
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
     Timestamp GetMinTimestampForHandler(const ReadHandler * aReadHandler)
     {
@@ -157,7 +157,15 @@ CHIP_ERROR Server::Init(const ServerInitParams & initParams)
     // Set up attribute persistence before we try to bring up the data model
     // handler.
     SuccessOrExit(err = mAttributePersister.Init(mDeviceStorage));
+#if CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
+    // Coalesce the writes of attributes that change often, e.g. during level or color transitions.
+    SuccessOrExit(err = mWriteBehindAttributePersister.Init(
+                      &mAttributePersister, &DeviceLayer::SystemLayer(),
+                      System::Clock::Milliseconds32(CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS)));
+    SetAttributePersistenceProvider(&mWriteBehindAttributePersister);
+#else
     SetAttributePersistenceProvider(&mAttributePersister);
+#endif // CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
     SetSafeAttributePersistenceProvider(&mAttributePersister);
 
     {
@@ -455,6 +463,14 @@ void Server::OnPlatformEvent(const DeviceLayer::ChipDeviceEvent & event)
             CheckServerReadyEvent();
         }
         break;
+#if CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
+    case DeviceEventType::kCommissioningComplete:
+    case DeviceEventType::kFailSafeTimerExpired:
+        // Make sure the attribute values the commissioner configured, or that reverting the fail-safe restored, are not
+        // lost if the device reboots right away.
+        LogErrorOnFailure(mWriteBehindAttributePersister.Flush());
+        break;
+#endif // CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
     case DeviceEventType::kServerReady:
 #if CHIP_CONFIG_ENABLE_ICD_SERVER && CHIP_CONFIG_ENABLE_ICD_CIP
         // Only Trigger Check-In messages if we are not in the middle of a commissioning.
@@ -562,6 +578,10 @@ void Server::ScheduleFactoryReset()
         // Delete all fabrics and emit Leave event.
         GetInstance().GetFabricTable().DeleteAllFabrics();
         PlatformMgr().HandleServerShuttingDown();
+#if CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
+        // Pending attribute values must not be written back once the storage is erased.
+        GetInstance().mWriteBehindAttributePersister.DiscardPendingWrites();
+#endif // CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
         ConfigurationMgr().InitiateFactoryReset();
     });
 }
@@ -615,6 +635,9 @@ void Server::Shutdown()
     mTestEventTriggerDelegate->RemoveHandler(&mICDManager);
     mICDManager.Shutdown();
 #endif // CHIP_CONFIG_ENABLE_ICD_SERVER
+#if CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
+    mWriteBehindAttributePersister.Shutdown();
+#endif // CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
     mAttributePersister.Shutdown();
     // TODO(16969): Remove chip::Platform::MemoryInit() call from Server class, it belongs to outer code
     chip::Platform::MemoryShutdown();
@@ -29,6 +29,7 @@
 #include <app/OperationalSessionSetupPool.h>
 #include <app/SimpleSubscriptionResumptionStorage.h>
 #include <app/TestEventTriggerDelegate.h>
+#include <app/WriteBehindAttributePersistenceProvider.h>
 #include <app/server/AclStorage.h>
 #include <app/server/AppDelegate.h>
 #include <app/server/CommissioningWindowManager.h>
@@ -647,6 +648,9 @@ private:
     Credentials::GroupDataProvider * mGroupsProvider;
     Crypto::SessionKeystore * mSessionKeystore;
     app::DefaultAttributePersistenceProvider mAttributePersister;
+#if CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
+    app::WriteBehindAttributePersistenceProvider mWriteBehindAttributePersister;
+#endif // CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS > 0
     GroupDataProviderListener mListener;
     ServerFabricDelegate mFabricDelegate;
     app::reporting::ReportScheduler * mReportScheduler;
@@ -17,6 +17,7 @@
  */
 
 #include <optional>
+#include <vector>
 
 #include <lib/core/StringBuilderAdapters.h>
 #include <pw_unit_test/framework.h>
@@ -24,6 +25,8 @@
 #include <app-common/zap-generated/cluster-objects.h>
 #include <app/AttributeValueEncoder.h>
 #include <app/MessageDef/AttributeDataIB.h>
+#include <app/MessageDef/AttributeReportIB.h>
+#include <app/data-model/Decode.h>
 #include <app/data-model/FabricScopedPreEncodedValue.h>
 #include <app/data-model/PreEncodedValue.h>
 #include <lib/core/TLVTags.h>
@@ -859,6 +862,216 @@ TEST(TestAttributeValueEncoder, TestEncodeFabricFilteredListOfPreEncoded)
     VERIFY_BUFFER_STATE(test, expected);
 }
 
+// Closes the report in the given test setup and appends the uint32_t list items it carries (either inside the initial
+// ReplaceAll report or as AppendItem reports) to items.
+template <size_t N>
+void DecodeReportedListItems(LimitedTestSetup<N> & test, std::vector<uint32_t> & items)
+{
+    ASSERT_EQ(test.builder.EndOfAttributeReportIBs(), CHIP_NO_ERROR);
+    ASSERT_EQ(test.writer.EndContainer(kTLVType_NotSpecified), CHIP_NO_ERROR);
+    ASSERT_EQ(test.writer.Finalize(), CHIP_NO_ERROR);
+
+    TLVReader reader;
+    reader.Init(test.buf, test.writer.GetLengthWritten());
+    ASSERT_EQ(reader.Next(kTLVType_Structure, AnonymousTag()), CHIP_NO_ERROR);
+    TLVType outer;
+    ASSERT_EQ(reader.EnterContainer(outer), CHIP_NO_ERROR);
+    ASSERT_EQ(reader.Next(kTLVType_Array, ContextTag(1)), CHIP_NO_ERROR);
+    TLVType reportsType;
+    ASSERT_EQ(reader.EnterContainer(reportsType), CHIP_NO_ERROR);
+
+    CHIP_ERROR err;
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        AttributeReportIB::Parser report;
+        ASSERT_EQ(report.Init(reader), CHIP_NO_ERROR);
+        AttributeDataIB::Parser data;
+        ASSERT_EQ(report.GetAttributeData(&data), CHIP_NO_ERROR);
+        TLVReader dataReader;
+        ASSERT_EQ(data.GetData(&dataReader), CHIP_NO_ERROR);
+
+        if (dataReader.GetType() == kTLVType_Array)
+        {
+            DataModel::DecodableList<uint32_t> list;
+            ASSERT_EQ(DataModel::Decode(dataReader, list), CHIP_NO_ERROR);
+            auto iter = list.begin();
+            while (iter.Next())
+            {
+                items.push_back(iter.GetValue());
+            }
+            ASSERT_EQ(iter.GetStatus(), CHIP_NO_ERROR);
+        }
+        else
+        {
+            uint32_t item;
+            ASSERT_EQ(DataModel::Decode(dataReader, item), CHIP_NO_ERROR);
+            items.push_back(item);
+        }
+    }
+    ASSERT_EQ(err, CHIP_END_OF_TLV);
+}
+
+// Runs encodeAttribute in as many 1024-byte reports as needed, the same way the reporting engine chunks a list, and
+// returns the number of reports that were used.
+template <typename EncodeAttribute>
+size_t EncodeInChunks(EncodeAttribute encodeAttribute, std::vector<uint32_t> & items)
+{
+    constexpr size_t kMaxChunks = 1000;
+    AttributeEncodeState state;
+
+    for (size_t chunks = 1; chunks <= kMaxChunks; chunks++)
+    {
+        TestSetup test(kTestFabricIndex, state);
+        CHIP_ERROR err = encodeAttribute(test.encoder);
+        if (err != CHIP_NO_ERROR)
+        {
+            EXPECT_TRUE(err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+            EXPECT_TRUE(test.encoder.GetState().AllowPartialData());
+            if (!test.encoder.GetState().AllowPartialData())
+            {
+                return 0;
+            }
+        }
+        DecodeReportedListItems(test, items);
+        if (err == CHIP_NO_ERROR)
+        {
+            return chunks;
+        }
+        state = test.encoder.GetState();
+    }
+    return 0;
+}
+
+TEST(TestAttributeValueEncoder, TestEncodeResumableListChunking)
+{
+    constexpr uint32_t kListLength = 500;
+    std::vector<uint32_t> startIndexes;
+    size_t generatedItems = 0;
+
+    auto encodeAttribute = [&](AttributeValueEncoder & encoder) {
+        return encoder.EncodeResumableList([&](const auto & listEncoder, ListIndex startIndex) -> CHIP_ERROR {
+            startIndexes.push_back(startIndex);
+            for (uint32_t i = startIndex; i < kListLength; i++)
+            {
+                generatedItems++;
+                ReturnErrorOnFailure(listEncoder.Encode(i));
+            }
+            return CHIP_NO_ERROR;
+        });
+    };
+
+    std::vector<uint32_t> items;
+    size_t chunks = EncodeInChunks(encodeAttribute, items);
+    EXPECT_GT(chunks, 2u);
+
+    ASSERT_EQ(items.size(), kListLength);
+    for (uint32_t i = 0; i < kListLength; i++)
+    {
+        EXPECT_EQ(items[i], i);
+    }
+
+    // Every chunk resumes where the previous one stopped: the only items generated twice are the ones that did not fit.
+    ASSERT_EQ(startIndexes.size(), chunks);
+    EXPECT_EQ(startIndexes[0], 0u);
+    EXPECT_EQ(generatedItems, kListLength + chunks - 1);
+}
+
+TEST(TestAttributeValueEncoder, TestEncodeResumableListFabricFiltered)
+{
+    // Items alternate between the accessing fabric and another one, so every other item is dropped by fabric filtering.
+    constexpr uint8_t kListLength           = 60;
+    constexpr FabricIndex kOtherFabricIndex = 2;
+    uint8_t data[kListLength]               = {};
+    std::vector<uint8_t> encodedItems;
+    size_t generatedItems = 0;
+    AttributeEncodeState state;
+
+    auto encodeAttribute = [&](AttributeValueEncoder & encoder) {
+        return encoder.EncodeResumableList([&](const auto & listEncoder, ListIndex startIndex) -> CHIP_ERROR {
+            for (uint8_t i = static_cast<uint8_t>(startIndex); i < kListLength; i++)
+            {
+                Clusters::AccessControl::Structs::AccessControlExtensionStruct::Type item;
+                data[i]          = i;
+                item.data        = ByteSpan(&data[i], 1);
+                item.fabricIndex = (i % 2 == 0) ? kTestFabricIndex : kOtherFabricIndex;
+                generatedItems++;
+                ReturnErrorOnFailure(listEncoder.Encode(item));
+                if (item.fabricIndex == kTestFabricIndex)
+                {
+                    encodedItems.push_back(i);
+                }
+            }
+            return CHIP_NO_ERROR;
+        });
+    };
+
+    size_t chunks = 0;
+    CHIP_ERROR err;
+    do
+    {
+        LimitedTestSetup<128> test(kTestFabricIndex, state);
+        err = encodeAttribute(test.encoder);
+        EXPECT_TRUE(err == CHIP_NO_ERROR || err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+        state = test.encoder.GetState();
+        chunks++;
+    } while (err != CHIP_NO_ERROR && chunks < kListLength);
+    EXPECT_EQ(err, CHIP_NO_ERROR);
+    EXPECT_GT(chunks, 2u);
+
+    // Each item of the accessing fabric is encoded exactly once and in order, and none is lost across chunks.
+    ASSERT_EQ(encodedItems.size(), kListLength / 2u);
+    for (size_t i = 0; i < encodedItems.size(); i++)
+    {
+        EXPECT_EQ(encodedItems[i], 2 * i);
+    }
+    EXPECT_EQ(generatedItems, kListLength + chunks - 1);
+}
+
+TEST(TestAttributeValueEncoder, TestEncodeLongListGeneratedItems)
+{
+    // Compares the work done to chunk a 1000 element list when the list generator restarts from the first element for every
+    // report (EncodeList) and when it resumes from the first element not yet sent (EncodeResumableList).
+    constexpr uint32_t kListLength = 1000;
+
+    size_t listGenerated      = 0;
+    size_t resumableGenerated = 0;
+
+    auto encodeList = [&](AttributeValueEncoder & encoder) {
+        return encoder.EncodeList([&](const auto & listEncoder) -> CHIP_ERROR {
+            for (uint32_t i = 0; i < kListLength; i++)
+            {
+                listGenerated++;
+                ReturnErrorOnFailure(listEncoder.Encode(i));
+            }
+            return CHIP_NO_ERROR;
+        });
+    };
+    auto encodeResumableList = [&](AttributeValueEncoder & encoder) {
+        return encoder.EncodeResumableList([&](const auto & listEncoder, ListIndex startIndex) -> CHIP_ERROR {
+            for (uint32_t i = startIndex; i < kListLength; i++)
+            {
+                resumableGenerated++;
+                ReturnErrorOnFailure(listEncoder.Encode(i));
+            }
+            return CHIP_NO_ERROR;
+        });
+    };
+
+    std::vector<uint32_t> listItems;
+    size_t listChunks = EncodeInChunks(encodeList, listItems);
+
+    std::vector<uint32_t> resumableItems;
+    size_t resumableChunks = EncodeInChunks(encodeResumableList, resumableItems);
+
+    // Both produce the very same reports.
+    EXPECT_EQ(listChunks, resumableChunks);
+    ASSERT_EQ(listItems.size(), kListLength);
+    EXPECT_EQ(listItems, resumableItems);
+
+    EXPECT_EQ(resumableGenerated, kListLength + resumableChunks - 1);
+    EXPECT_GT(listGenerated, resumableGenerated * (listChunks / 4));
+}
+
 #undef VERIFY_BUFFER_STATE
 
 } // anonymous namespace
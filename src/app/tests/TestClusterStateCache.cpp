@@ -16,6 +16,7 @@
  *    limitations under the License.
  */
 
+#include <chrono>
 #include <string.h>
 #include <vector>
 
@@ -698,4 +699,156 @@ TEST_F(TestClusterStateCache, TestCache)
                              AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData) });
 }
 
+class NullCacheCallback : public ClusterStateCache::Callback
+{
+    void OnDone(ReadClient *) override {}
+};
+
+// Reports an octet string of valueSize bytes for the UnitTesting cluster of an endpoint.
+void ReportOctetString(ReadClient::Callback & callback, EndpointId endpointId, DataVersion dataVersion, size_t valueSize)
+{
+    std::vector<uint8_t> value(valueSize, 0xAB);
+    uint8_t buf[600];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    EXPECT_EQ(DataModel::Encode(writer, TLV::AnonymousTag(), ByteSpan(value.data(), value.size())), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(buf, writer.GetLengthWritten());
+    EXPECT_EQ(reader.Next(), CHIP_NO_ERROR);
+
+    ConcreteDataAttributePath path(endpointId, Clusters::UnitTesting::Id, Clusters::UnitTesting::Attributes::OctetString::Id);
+    path.mDataVersion.SetValue(dataVersion);
+    callback.OnAttributeData(path, &reader, StatusIB());
+}
+
+// Encodes the data version filters of the cache for a resubscription to the given paths, and returns them in order.
+std::vector<DataVersionFilter> GetDataVersionFilters(ClusterStateCache & cache, const Span<AttributePathParams> & paths,
+                                                     size_t bufferSize)
+{
+    std::vector<DataVersionFilter> filters;
+    std::vector<uint8_t> buf(bufferSize);
+    TLV::TLVWriter writer;
+    writer.Init(buf.data(), buf.size());
+
+    DataVersionFilterIBs::Builder builder;
+    EXPECT_EQ(builder.Init(&writer), CHIP_NO_ERROR);
+    bool encodedDataVersionList = false;
+    EXPECT_EQ(cache.GetBufferedCallback().OnUpdateDataVersionFilterList(builder, paths, encodedDataVersionList), CHIP_NO_ERROR);
+    EXPECT_EQ(builder.EndOfDataVersionFilterIBs(), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(buf.data(), writer.GetLengthWritten());
+    EXPECT_EQ(reader.Next(), CHIP_NO_ERROR);
+    DataVersionFilterIBs::Parser parser;
+    EXPECT_EQ(parser.Init(reader), CHIP_NO_ERROR);
+
+    TLV::TLVReader filtersReader;
+    parser.GetReader(&filtersReader);
+    while (filtersReader.Next() == CHIP_NO_ERROR)
+    {
+        DataVersionFilterIB::Parser filterParser;
+        ClusterPathIB::Parser pathParser;
+        DataVersionFilter filter;
+        DataVersion dataVersion = 0;
+        EXPECT_EQ(filterParser.Init(filtersReader), CHIP_NO_ERROR);
+        EXPECT_EQ(filterParser.GetPath(&pathParser), CHIP_NO_ERROR);
+        EXPECT_EQ(pathParser.GetEndpoint(&filter.mEndpointId), CHIP_NO_ERROR);
+        EXPECT_EQ(pathParser.GetCluster(&filter.mClusterId), CHIP_NO_ERROR);
+        EXPECT_EQ(filterParser.GetDataVersion(&dataVersion), CHIP_NO_ERROR);
+        filter.mDataVersion.SetValue(dataVersion);
+        filters.push_back(filter);
+    }
+    EXPECT_EQ(encodedDataVersionList, !filters.empty());
+
+    return filters;
+}
+
+/*
+ * This validates that the data version filters follow the reports: they are ordered from the cluster with the most data
+ * to the one with the least, and they track the latest committed data version of each cluster.
+ */
+TEST_F(TestClusterStateCache, TestDataVersionFilters)
+{
+    NullCacheCallback callback;
+    ClusterStateCache cache(callback);
+    ReadClient::Callback & readCallback = cache.GetBufferedCallback();
+
+    AttributePathParams wildcardPath;
+    const Span<AttributePathParams> pathSpan(&wildcardPath, 1);
+    EXPECT_TRUE(GetDataVersionFilters(cache, pathSpan, 100).empty());
+
+    readCallback.OnReportBegin();
+    ReportOctetString(readCallback, 1, 10, 10);
+    ReportOctetString(readCallback, 2, 20, 100);
+    ReportOctetString(readCallback, 3, 30, 50);
+    readCallback.OnReportEnd();
+
+    const ClusterId clusterId = Clusters::UnitTesting::Id;
+    EXPECT_EQ(GetDataVersionFilters(cache, pathSpan, 1024),
+              (std::vector<DataVersionFilter>{ { 2, clusterId, 20 }, { 3, clusterId, 30 }, { 1, clusterId, 10 } }));
+
+    // A larger value moves the cluster first, with its new data version.
+    readCallback.OnReportBegin();
+    ReportOctetString(readCallback, 1, 11, 200);
+    readCallback.OnReportEnd();
+    EXPECT_EQ(GetDataVersionFilters(cache, pathSpan, 1024),
+              (std::vector<DataVersionFilter>{ { 1, clusterId, 11 }, { 2, clusterId, 20 }, { 3, clusterId, 30 } }));
+
+    // A status replacing a value shrinks the cluster.
+    readCallback.OnReportBegin();
+    ConcreteDataAttributePath statusPath(2, clusterId, Clusters::UnitTesting::Attributes::OctetString::Id);
+    readCallback.OnAttributeData(statusPath, nullptr, StatusIB(Protocols::InteractionModel::Status::Failure));
+    readCallback.OnReportEnd();
+    EXPECT_EQ(GetDataVersionFilters(cache, pathSpan, 1024),
+              (std::vector<DataVersionFilter>{ { 1, clusterId, 11 }, { 3, clusterId, 30 }, { 2, clusterId, 20 } }));
+
+    // When they do not all fit, the filters of the largest clusters are kept.
+    EXPECT_EQ(GetDataVersionFilters(cache, pathSpan, 40),
+              (std::vector<DataVersionFilter>{ { 1, clusterId, 11 }, { 3, clusterId, 30 } }));
+
+    // Filters are only sent for the clusters of the request.
+    AttributePathParams endpoint3Path(static_cast<EndpointId>(3), clusterId);
+    EXPECT_EQ(GetDataVersionFilters(cache, Span<AttributePathParams>(&endpoint3Path, 1), 1024),
+              (std::vector<DataVersionFilter>{ { 3, clusterId, 30 } }));
+}
+
+// Not a pass/fail test, so disabled by default: reports how long preparing the data version filters of a resubscription
+// takes as the cache grows.
+TEST_F(TestClusterStateCache, DISABLED_BenchmarkDataVersionFilters)
+{
+    constexpr int kIterations = 200;
+
+    for (EndpointId endpointCount : { 10, 100, 1000 })
+    {
+        NullCacheCallback callback;
+        ClusterStateCache cache(callback);
+        ReadClient::Callback & readCallback = cache.GetBufferedCallback();
+
+        AttributePathParams wildcardPath;
+        const Span<AttributePathParams> pathSpan(&wildcardPath, 1);
+        GetDataVersionFilters(cache, pathSpan, 100);
+
+        readCallback.OnReportBegin();
+        for (EndpointId endpointId = 0; endpointId < endpointCount; endpointId++)
+        {
+            ReportOctetString(readCallback, endpointId, endpointId, (endpointId * 37u) % 500u);
+        }
+        readCallback.OnReportEnd();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIterations; i++)
+        {
+            // About the room left for the filters in a subscribe request.
+            GetDataVersionFilters(cache, pathSpan, 1024);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        printf("Data version filters for %u cached clusters: %lld us per resubscription\n", static_cast<unsigned>(endpointCount),
+               static_cast<long long>(elapsed.count() / kIterations));
+    }
+}
+
 } // namespace
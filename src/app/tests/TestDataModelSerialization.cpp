@@ -16,6 +16,8 @@
  *    limitations under the License.
  */
 
+#include <chrono>
+
 #include <app-common/zap-generated/cluster-objects.h>
 #include <app/data-model/Decode.h>
 #include <app/data-model/Encode.h>
@@ -986,4 +988,165 @@ TEST_F(TestDataModelSerialization, NullablesOptionalsCommand)
     NullablesOptionalsEncodeDecodeCheck<EncType, DecType>();
 }
 
+TEST_F(TestDataModelSerialization, DecodableListReaderPosition)
+{
+    SetupBuf();
+
+    const uint8_t values[] = { 1, 2, 3 };
+    {
+        TLV::TLVType outer;
+        EXPECT_EQ(mWriter.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outer), CHIP_NO_ERROR);
+        EXPECT_EQ(DataModel::Encode(mWriter, TLV::ContextTag(0), DataModel::List<const uint8_t>(values)), CHIP_NO_ERROR);
+        EXPECT_EQ(DataModel::Encode(mWriter, TLV::ContextTag(1), static_cast<uint8_t>(42)), CHIP_NO_ERROR);
+        EXPECT_EQ(mWriter.EndContainer(outer), CHIP_NO_ERROR);
+        EXPECT_EQ(mWriter.Finalize(), CHIP_NO_ERROR);
+    }
+
+    SetupReader();
+
+    TLV::TLVType outer;
+    DataModel::DecodableList<uint8_t> list;
+    EXPECT_EQ(mReader.EnterContainer(outer), CHIP_NO_ERROR);
+    EXPECT_EQ(mReader.Next(TLV::ContextTag(0)), CHIP_NO_ERROR);
+    EXPECT_EQ(DataModel::Decode(mReader, list), CHIP_NO_ERROR);
+
+    // Decode moves the reader past the list, to the element that follows it.
+    uint8_t following = 0;
+    EXPECT_EQ(mReader.Next(TLV::ContextTag(1)), CHIP_NO_ERROR);
+    EXPECT_EQ(DataModel::Decode(mReader, following), CHIP_NO_ERROR);
+    EXPECT_EQ(following, 42);
+    EXPECT_EQ(mReader.ExitContainer(outer), CHIP_NO_ERROR);
+
+    size_t count = 0;
+    EXPECT_EQ(list.ComputeSize(&count), CHIP_NO_ERROR);
+    EXPECT_EQ(count, ArraySize(values));
+
+    auto iter = list.begin();
+    for (uint8_t value : values)
+    {
+        EXPECT_TRUE(iter.Next());
+        EXPECT_EQ(iter.GetValue(), value);
+    }
+    EXPECT_FALSE(iter.Next());
+    EXPECT_EQ(iter.GetStatus(), CHIP_NO_ERROR);
+}
+
+TEST_F(TestDataModelSerialization, DecodableListTruncated)
+{
+    const uint8_t values[] = { 1, 2, 3 };
+    uint8_t buffer[32];
+    TLV::TLVWriter writer;
+    writer.Init(buffer);
+    EXPECT_EQ(DataModel::Encode(writer, TLV::AnonymousTag(), DataModel::List<const uint8_t>(values)), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+    const uint32_t length = writer.GetLengthWritten();
+
+    TLV::TLVReader reader;
+    reader.Init(buffer, length);
+    EXPECT_EQ(reader.Next(), CHIP_NO_ERROR);
+    DataModel::DecodableList<uint8_t> list;
+    EXPECT_EQ(DataModel::Decode(reader, list), CHIP_NO_ERROR);
+
+    // Cutting the list anywhere after its head, including only its end-of-container, fails the decode.
+    for (uint32_t truncatedLength = 1; truncatedLength < length; truncatedLength++)
+    {
+        reader.Init(buffer, truncatedLength);
+        EXPECT_EQ(reader.Next(), CHIP_NO_ERROR);
+        EXPECT_NE(DataModel::Decode(reader, list), CHIP_NO_ERROR);
+    }
+}
+
+// Not a pass/fail test, so disabled by default: reports the encode and decode cost of representative lists of structs, as
+// found in attribute reports.
+TEST_F(TestDataModelSerialization, DISABLED_BenchmarkStructListCodec)
+{
+    constexpr size_t kRounds = 2000;
+    uint8_t buffer[2048];
+
+    auto report = [&](const char * name, size_t structCount, auto encode, auto decode) {
+        uint32_t length = 0;
+        auto start      = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < kRounds; round++)
+        {
+            TLV::TLVWriter writer;
+            writer.Init(buffer);
+            ASSERT_EQ(encode(writer), CHIP_NO_ERROR);
+            ASSERT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+            length = writer.GetLengthWritten();
+        }
+        auto encoded = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < kRounds; round++)
+        {
+            TLV::TLVReader reader;
+            reader.Init(buffer, length);
+            ASSERT_EQ(reader.Next(), CHIP_NO_ERROR);
+            ASSERT_EQ(decode(reader), CHIP_NO_ERROR);
+        }
+        auto decoded = std::chrono::steady_clock::now();
+
+        auto perStruct = [&](auto elapsed) {
+            return static_cast<unsigned>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() /
+                                         static_cast<long long>(kRounds * structCount));
+        };
+        printf("%s: %u bytes, %u ns per struct encoded, %u ns per struct decoded\n", name, static_cast<unsigned>(length),
+               perStruct(encoded - start), perStruct(decoded - encoded));
+    };
+
+    // Descriptor DeviceTypeList: small structs of fixed-size fields.
+    using DeviceType = Descriptor::Structs::DeviceTypeStruct::Type;
+    DeviceType deviceTypes[64];
+    for (size_t i = 0; i < ArraySize(deviceTypes); i++)
+    {
+        deviceTypes[i].deviceType = static_cast<DeviceTypeId>(0x100 + i);
+        deviceTypes[i].revision   = 2;
+    }
+    report(
+        "Descriptor DeviceTypeList", ArraySize(deviceTypes),
+        [&](TLV::TLVWriter & writer) {
+            return DataModel::Encode(writer, TLV::AnonymousTag(), DataModel::List<const DeviceType>(deviceTypes));
+        },
+        [&](TLV::TLVReader & reader) {
+            DataModel::DecodableList<Descriptor::Structs::DeviceTypeStruct::DecodableType> list;
+            ReturnErrorOnFailure(DataModel::Decode(reader, list));
+            auto iter = list.begin();
+            while (iter.Next())
+            {
+            }
+            return iter.GetStatus();
+        });
+
+    // AccessControl ACL: fabric-scoped structs with nested lists.
+    using Entry  = AccessControl::Structs::AccessControlEntryStruct::Type;
+    using Target = AccessControl::Structs::AccessControlTargetStruct::Type;
+    const uint64_t subjects[] = { 1, 2, 3, 4 };
+    Target targets[2];
+    targets[0].cluster.SetNonNull(OnOff::Id);
+    targets[0].endpoint.SetNull();
+    targets[0].deviceType.SetNull();
+    targets[1] = targets[0];
+    Entry entries[16];
+    for (auto & entry : entries)
+    {
+        entry.privilege = AccessControl::AccessControlEntryPrivilegeEnum::kOperate;
+        entry.authMode  = AccessControl::AccessControlEntryAuthModeEnum::kCase;
+        entry.subjects.SetNonNull(subjects);
+        entry.targets.SetNonNull(targets);
+        entry.fabricIndex = 1;
+    }
+    report(
+        "AccessControl ACL", ArraySize(entries),
+        [&](TLV::TLVWriter & writer) {
+            return DataModel::EncodeForRead(writer, TLV::AnonymousTag(), 1, DataModel::List<const Entry>(entries));
+        },
+        [&](TLV::TLVReader & reader) {
+            DataModel::DecodableList<AccessControl::Structs::AccessControlEntryStruct::DecodableType> list;
+            ReturnErrorOnFailure(DataModel::Decode(reader, list));
+            auto iter = list.begin();
+            while (iter.Next())
+            {
+            }
+            return iter.GetStatus();
+        });
+}
+
 } // namespace
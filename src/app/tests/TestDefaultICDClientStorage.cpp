@@ -15,6 +15,9 @@
  *    limitations under the License.
  */
 
+#include <chrono>
+#include <vector>
+
 #include <lib/core/StringBuilderAdapters.h>
 #include <lib/support/Span.h>
 #include <pw_unit_test/framework.h>
@@ -22,8 +25,10 @@
 
 #include <app/icd/client/DefaultICDClientStorage.h>
 #include <crypto/DefaultSessionKeystore.h>
+#include <lib/core/CHIPEncoding.h>
 #include <lib/support/DefaultStorageKeyAllocator.h>
 #include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <protocols/secure_channel/CheckinMessage.h>
 #include <transport/SessionManager.h>
 
@@ -55,6 +60,23 @@ struct TestClientInfo : public ICDClientInfo
     }
 };
 
+using chip::Protocols::SecureChannel::CheckinMessage;
+
+struct CheckInPayload
+{
+    uint8_t buffer[CheckinMessage::kMinPayloadSize];
+    ByteSpan payload;
+};
+
+void GenerateCheckInPayload(const ICDClientInfo & clientInfo, uint32_t counter, CheckInPayload & checkIn)
+{
+    MutableByteSpan output(checkIn.buffer);
+    EXPECT_EQ(CheckinMessage::GenerateCheckinMessagePayload(clientInfo.aes_key_handle, clientInfo.hmac_key_handle, counter,
+                                                            ByteSpan(), output),
+              CHIP_NO_ERROR);
+    checkIn.payload = output;
+}
+
 class TestDefaultICDClientStorage : public ::testing::Test
 {
 public:
@@ -225,3 +247,173 @@ TEST_F(TestDefaultICDClientStorage, TestProcessCheckInPayload)
     ByteSpan payload1{ buffer->Start(), buffer->DataLength() };
     EXPECT_EQ(manager.ProcessCheckInPayload(payload1, decodeClientInfo, checkInCounter), CHIP_ERROR_NOT_FOUND);
 }
+
+TEST_F(TestDefaultICDClientStorage, TestProcessCheckInPayloadIndex)
+{
+    FabricIndex fabricId = 1;
+    NodeId nodeId1       = 6666;
+    NodeId nodeId2       = 6667;
+    TestPersistentStorageDelegate clientInfoStorage;
+    TestSessionKeystoreImpl keystore;
+
+    DefaultICDClientStorage manager;
+    EXPECT_EQ(manager.Init(&clientInfoStorage, &keystore), CHIP_NO_ERROR);
+    EXPECT_EQ(manager.UpdateFabricList(fabricId), CHIP_NO_ERROR);
+
+    ICDClientInfo clientInfo1;
+    clientInfo1.peer_node         = ScopedNodeId(nodeId1, fabricId);
+    clientInfo1.start_icd_counter = 100;
+    EXPECT_EQ(manager.SetKey(clientInfo1, ByteSpan(kKeyBuffer1)), CHIP_NO_ERROR);
+    EXPECT_EQ(manager.StoreEntry(clientInfo1), CHIP_NO_ERROR);
+
+    ICDClientInfo clientInfo2;
+    clientInfo2.peer_node         = ScopedNodeId(nodeId2, fabricId);
+    clientInfo2.start_icd_counter = 0xFFFFFFFE;
+    EXPECT_EQ(manager.SetKey(clientInfo2, ByteSpan(kKeyBuffer2)), CHIP_NO_ERROR);
+    EXPECT_EQ(manager.StoreEntry(clientInfo2), CHIP_NO_ERROR);
+
+    CheckInPayload checkIn;
+    ICDClientInfo decodeClientInfo;
+    uint32_t checkInCounter = 0;
+
+    // 1. Counters in the precomputed window, including one wrapping around, and a duplicate.
+    for (uint32_t counter : { 101u, 102u, 102u, 105u })
+    {
+        GenerateCheckInPayload(clientInfo1, counter, checkIn);
+        EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_NO_ERROR);
+        EXPECT_EQ(decodeClientInfo.peer_node, clientInfo1.peer_node);
+        EXPECT_EQ(checkInCounter, counter);
+    }
+    GenerateCheckInPayload(clientInfo2, 1, checkIn);
+    EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_NO_ERROR);
+    EXPECT_EQ(decodeClientInfo.peer_node, clientInfo2.peer_node);
+    EXPECT_EQ(checkInCounter, 1u);
+
+    // 2. Counters beyond the window are still found, and the window follows them; so are old counters.
+    for (uint32_t counter : { 1000u, 1001u, 103u })
+    {
+        GenerateCheckInPayload(clientInfo1, counter, checkIn);
+        EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_NO_ERROR);
+        EXPECT_EQ(decodeClientInfo.peer_node, clientInfo1.peer_node);
+        EXPECT_EQ(checkInCounter, counter);
+    }
+
+    // 3. Replacing the keys of an entry, as done by a key refresh, drops the old ones from the index.
+    ICDClientInfo oldClientInfo1 = clientInfo1;
+    EXPECT_EQ(manager.SetKey(clientInfo1, ByteSpan(kKeyBuffer3)), CHIP_NO_ERROR);
+    EXPECT_EQ(manager.StoreEntry(clientInfo1), CHIP_NO_ERROR);
+    GenerateCheckInPayload(oldClientInfo1, 1002, checkIn);
+    EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_ERROR_NOT_FOUND);
+    GenerateCheckInPayload(clientInfo1, 101, checkIn);
+    EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_NO_ERROR);
+    EXPECT_EQ(decodeClientInfo.peer_node, clientInfo1.peer_node);
+
+    // 4. Deleted entries are no longer found, while the remaining ones still are.
+    GenerateCheckInPayload(clientInfo2, 2, checkIn);
+    EXPECT_EQ(manager.DeleteEntry(clientInfo2.peer_node), CHIP_NO_ERROR);
+    EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_ERROR_NOT_FOUND);
+    GenerateCheckInPayload(clientInfo1, 102, checkIn);
+    EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_NO_ERROR);
+    EXPECT_EQ(decodeClientInfo.peer_node, clientInfo1.peer_node);
+
+    EXPECT_EQ(manager.DeleteAllEntries(fabricId), CHIP_NO_ERROR);
+    EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_ERROR_NOT_FOUND);
+
+    // 5. A new storage instance over the same persisted entries builds its index from storage.
+    EXPECT_EQ(manager.SetKey(clientInfo2, ByteSpan(kKeyBuffer2)), CHIP_NO_ERROR);
+    EXPECT_EQ(manager.StoreEntry(clientInfo2), CHIP_NO_ERROR);
+    DefaultICDClientStorage manager2;
+    EXPECT_EQ(manager2.Init(&clientInfoStorage, &keystore), CHIP_NO_ERROR);
+    GenerateCheckInPayload(clientInfo2, 1, checkIn);
+    EXPECT_EQ(manager2.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_NO_ERROR);
+    EXPECT_EQ(decodeClientInfo.peer_node, clientInfo2.peer_node);
+}
+
+TEST_F(TestDefaultICDClientStorage, DISABLED_BenchmarkProcessCheckInPayload)
+{
+    // Check-Ins per second versus the number of registered ICDs, for the indexed lookup and for trying every registered key
+    // in turn (which is what ProcessCheckInPayload did before the index, minus the storage reads). Disabled by default, as
+    // it only reports timings.
+    constexpr FabricIndex kFabricCount = 4;
+    constexpr size_t kCheckInCount     = 64;
+
+    for (size_t icdCount : { 10u, 100u, 1000u })
+    {
+        TestPersistentStorageDelegate clientInfoStorage;
+        TestSessionKeystoreImpl keystore;
+        DefaultICDClientStorage manager;
+        EXPECT_EQ(manager.Init(&clientInfoStorage, &keystore), CHIP_NO_ERROR);
+        for (FabricIndex fabricIndex = 1; fabricIndex <= kFabricCount; fabricIndex++)
+        {
+            EXPECT_EQ(manager.UpdateFabricList(fabricIndex), CHIP_NO_ERROR);
+        }
+
+        std::vector<ICDClientInfo> clientInfos(icdCount);
+        for (size_t i = 0; i < icdCount; i++)
+        {
+            uint8_t key[sizeof(kKeyBuffer1)];
+            memcpy(key, kKeyBuffer1, sizeof(key));
+            Encoding::LittleEndian::Put32(key, static_cast<uint32_t>(i));
+
+            clientInfos[i].peer_node = ScopedNodeId(static_cast<NodeId>(1000 + i), static_cast<FabricIndex>(1 + i % kFabricCount));
+            clientInfos[i].start_icd_counter = static_cast<uint32_t>(i);
+            EXPECT_EQ(manager.SetKey(clientInfos[i], ByteSpan(key)), CHIP_NO_ERROR);
+            EXPECT_EQ(manager.StoreEntry(clientInfos[i]), CHIP_NO_ERROR);
+        }
+
+        // ICDs spread over the whole table, each sending its next Check-In.
+        std::vector<CheckInPayload> checkIns(kCheckInCount);
+        for (size_t i = 0; i < kCheckInCount; i++)
+        {
+            const ICDClientInfo & clientInfo = clientInfos[(i * 7919) % icdCount];
+            GenerateCheckInPayload(clientInfo, clientInfo.start_icd_counter + 1 + static_cast<uint32_t>(i / icdCount), checkIns[i]);
+        }
+
+        // The first Check-In loads the index from storage.
+        ICDClientInfo decodeClientInfo;
+        uint32_t checkInCounter = 0;
+        auto loadStart          = std::chrono::steady_clock::now();
+        EXPECT_EQ(manager.ProcessCheckInPayload(checkIns[0].payload, decodeClientInfo, checkInCounter), CHIP_NO_ERROR);
+        auto loadTime = std::chrono::steady_clock::now() - loadStart;
+
+        auto indexedStart = std::chrono::steady_clock::now();
+        for (auto & checkIn : checkIns)
+        {
+            EXPECT_EQ(manager.ProcessCheckInPayload(checkIn.payload, decodeClientInfo, checkInCounter), CHIP_NO_ERROR);
+        }
+        auto indexedTime = std::chrono::steady_clock::now() - indexedStart;
+
+        auto scanStart = std::chrono::steady_clock::now();
+        for (auto & checkIn : checkIns)
+        {
+            bool found = false;
+            for (auto & clientInfo : clientInfos)
+            {
+                uint8_t appDataBuffer[ICDClientStorage::kAppDataLength];
+                MutableByteSpan appData(appDataBuffer);
+                if (CheckinMessage::ParseCheckinMessagePayload(clientInfo.aes_key_handle, clientInfo.hmac_key_handle,
+                                                               checkIn.payload, checkInCounter, appData) == CHIP_NO_ERROR)
+                {
+                    found = true;
+                    break;
+                }
+            }
+            EXPECT_TRUE(found);
+        }
+        auto scanTime = std::chrono::steady_clock::now() - scanStart;
+
+        auto checkInsPerSecond = [](std::chrono::steady_clock::duration duration) {
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+            return static_cast<unsigned>(kCheckInCount * 1000000 / static_cast<size_t>(us > 0 ? us : 1));
+        };
+        ChipLogProgress(Test, "%u ICDs: index built in %u us, indexed %u Check-Ins/s, full scan %u Check-Ins/s",
+                        static_cast<unsigned>(icdCount),
+                        static_cast<unsigned>(std::chrono::duration_cast<std::chrono::microseconds>(loadTime).count()),
+                        checkInsPerSecond(indexedTime), checkInsPerSecond(scanTime));
+
+        for (auto & clientInfo : clientInfos)
+        {
+            manager.RemoveKey(clientInfo);
+        }
+    }
+}
@@ -0,0 +1,391 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/SubscriptionResumptionScheduler.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <pw_unit_test/framework.h>
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace {
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::System::Clock::Literals;
+using chip::System::Clock::Milliseconds32;
+using chip::System::Clock::Timeout;
+using chip::System::Clock::Timestamp;
+
+class TestSubscriptionResumptionScheduler : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+};
+
+class MockTimerDelegate : public SubscriptionResumptionScheduler::TimerDelegate
+{
+public:
+    CHIP_ERROR StartTimer(reporting::TimerContext * context, Timeout timeout) override
+    {
+        mContext  = context;
+        mDeadline = mNow + timeout;
+        return CHIP_NO_ERROR;
+    }
+    void CancelTimer(reporting::TimerContext * context) override
+    {
+        if (mContext == context)
+        {
+            mContext = nullptr;
+        }
+    }
+    bool IsTimerActive(reporting::TimerContext * context) override { return mContext != nullptr && mContext == context; }
+    Timestamp GetCurrentMonotonicTimestamp() override { return mNow; }
+
+    // Moves the clock to the timer deadline and fires it.
+    void FireTimer()
+    {
+        ASSERT_NE(mContext, nullptr);
+        mNow                              = std::max(mNow, mDeadline);
+        reporting::TimerContext * context = mContext;
+        mContext                          = nullptr;
+        context->TimerFired();
+    }
+
+    Timestamp mNow                     = Timestamp::zero();
+    Timestamp mDeadline                = Timestamp::zero();
+    reporting::TimerContext * mContext = nullptr;
+};
+
+// Storage that is not capped by CHIP_IM_MAX_NUM_SUBSCRIPTIONS and counts how many times it is iterated.
+class MockSubscriptionResumptionStorage : public SubscriptionResumptionStorage
+{
+public:
+    struct Entry
+    {
+        NodeId nodeId;
+        FabricIndex fabricIndex;
+        SubscriptionId subscriptionId;
+        uint16_t minInterval;
+    };
+
+    class Iterator : public SubscriptionInfoIterator
+    {
+    public:
+        Iterator(MockSubscriptionResumptionStorage & storage) : mStorage(storage) {}
+        size_t Count() override { return mStorage.mEntries.size(); }
+        bool Next(SubscriptionInfo & output) override
+        {
+            VerifyOrReturnValue(mIndex < mStorage.mEntries.size(), false);
+            const Entry & entry    = mStorage.mEntries[mIndex++];
+            output.mNodeId         = entry.nodeId;
+            output.mFabricIndex    = entry.fabricIndex;
+            output.mSubscriptionId = entry.subscriptionId;
+            output.mMinInterval    = entry.minInterval;
+            output.mMaxInterval    = static_cast<uint16_t>(entry.minInterval + 60);
+            output.mFabricFiltered = false;
+            return true;
+        }
+        void Release() override { mStorage.mOpenIterators--; }
+
+    private:
+        MockSubscriptionResumptionStorage & mStorage;
+        size_t mIndex = 0;
+    };
+
+    SubscriptionInfoIterator * IterateSubscriptions() override
+    {
+        mIterationCount++;
+        mOpenIterators++;
+        mIterator.Emplace(*this);
+        return &mIterator.Value();
+    }
+    CHIP_ERROR Save(SubscriptionInfo & subscriptionInfo) override
+    {
+        mEntries.push_back({ subscriptionInfo.mNodeId, subscriptionInfo.mFabricIndex, subscriptionInfo.mSubscriptionId,
+                             subscriptionInfo.mMinInterval });
+        return CHIP_NO_ERROR;
+    }
+    CHIP_ERROR Delete(NodeId nodeId, FabricIndex fabricIndex, SubscriptionId subscriptionId) override
+    {
+        mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+                                      [&](const Entry & entry) { return entry.subscriptionId == subscriptionId; }),
+                       mEntries.end());
+        return CHIP_NO_ERROR;
+    }
+    CHIP_ERROR DeleteAll(FabricIndex fabricIndex) override
+    {
+        mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+                                      [&](const Entry & entry) { return entry.fabricIndex == fabricIndex; }),
+                       mEntries.end());
+        return CHIP_NO_ERROR;
+    }
+
+    void Add(SubscriptionId subscriptionId, uint16_t minInterval, FabricIndex fabricIndex = 1)
+    {
+        mEntries.push_back({ static_cast<NodeId>(subscriptionId + 1000), fabricIndex, subscriptionId, minInterval });
+    }
+
+    std::vector<Entry> mEntries;
+    Optional<Iterator> mIterator;
+    size_t mIterationCount = 0;
+    int mOpenIterators     = 0;
+};
+
+class MockDelegate : public SubscriptionResumptionScheduler::Delegate
+{
+public:
+    bool IsSubscriptionActive(SubscriptionId subscriptionId) override { return mActive.count(subscriptionId) > 0; }
+    CHIP_ERROR StartSubscriptionResumption(const SubscriptionResumptionStorage::SubscriptionInfo & subscriptionInfo) override
+    {
+        VerifyOrReturnError(mFailures.count(subscriptionInfo.mSubscriptionId) == 0, CHIP_ERROR_NO_MEMORY);
+        mStarted.push_back(subscriptionInfo.mSubscriptionId);
+        if (mScheduler != nullptr && mCompleteSynchronously)
+        {
+            mScheduler->OnResumptionAttemptDone(subscriptionInfo.mSubscriptionId);
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    std::set<SubscriptionId> mActive;
+    std::set<SubscriptionId> mFailures;
+    std::vector<SubscriptionId> mStarted;
+    SubscriptionResumptionScheduler * mScheduler = nullptr;
+    bool mCompleteSynchronously                  = false;
+};
+
+SubscriptionResumptionScheduler::Config MakeConfig(uint16_t maxConcurrent, uint32_t pacingMs, uint32_t jitterMs)
+{
+    SubscriptionResumptionScheduler::Config config;
+    config.maxConcurrentResumptions = maxConcurrent;
+    config.pacingInterval           = Milliseconds32(pacingMs);
+    config.maxJitter                = Milliseconds32(jitterMs);
+    return config;
+}
+
+TEST_F(TestSubscriptionResumptionScheduler, TestPerSubscriptionMinInterval)
+{
+    MockTimerDelegate timer;
+    MockSubscriptionResumptionStorage storage;
+    MockDelegate delegate;
+    SubscriptionResumptionScheduler scheduler;
+    ASSERT_EQ(scheduler.Init(&delegate, &timer, &storage, MakeConfig(4, 0, 0)), CHIP_NO_ERROR);
+
+    storage.Add(30, 10);
+    storage.Add(10, 1);
+    storage.Add(20, 5);
+
+    uint16_t count = 0;
+    EXPECT_EQ(scheduler.ScheduleResumptions(true, count), CHIP_NO_ERROR);
+    EXPECT_EQ(count, 3u);
+    EXPECT_TRUE(scheduler.IsResumptionScheduled(10));
+    EXPECT_TRUE(scheduler.IsResumptionScheduled(20));
+    EXPECT_TRUE(scheduler.IsResumptionScheduled(30));
+
+    // Each subscription waits its own min-interval rather than the largest one.
+    ASSERT_TRUE(timer.IsTimerActive(&scheduler));
+    EXPECT_EQ(timer.mDeadline, Timestamp(1_s));
+    timer.FireTimer();
+    ASSERT_EQ(delegate.mStarted.size(), 1u);
+    EXPECT_EQ(delegate.mStarted[0], 10u);
+    EXPECT_EQ(scheduler.GetInFlightCount(), 1u);
+
+    EXPECT_EQ(timer.mDeadline, Timestamp(5_s));
+    timer.FireTimer();
+    ASSERT_EQ(delegate.mStarted.size(), 2u);
+    EXPECT_EQ(delegate.mStarted[1], 20u);
+
+    scheduler.OnResumptionAttemptDone(10);
+    scheduler.OnResumptionAttemptDone(20);
+    EXPECT_EQ(scheduler.GetInFlightCount(), 0u);
+    EXPECT_FALSE(scheduler.IsResumptionScheduled(10));
+
+    EXPECT_EQ(timer.mDeadline, Timestamp(10_s));
+    timer.FireTimer();
+    ASSERT_EQ(delegate.mStarted.size(), 3u);
+    EXPECT_EQ(delegate.mStarted[2], 30u);
+    scheduler.OnResumptionAttemptDone(30);
+
+    EXPECT_EQ(scheduler.GetScheduledCount(), 0u);
+    EXPECT_FALSE(timer.IsTimerActive(&scheduler));
+    EXPECT_EQ(storage.mOpenIterators, 0);
+}
+
+TEST_F(TestSubscriptionResumptionScheduler, TestSkipsLiveAndRemovedSubscriptions)
+{
+    MockTimerDelegate timer;
+    MockSubscriptionResumptionStorage storage;
+    MockDelegate delegate;
+    SubscriptionResumptionScheduler scheduler;
+    ASSERT_EQ(scheduler.Init(&delegate, &timer, &storage, MakeConfig(4, 0, 0)), CHIP_NO_ERROR);
+
+    for (SubscriptionId id = 1; id <= 5; id++)
+    {
+        storage.Add(id, 2, static_cast<FabricIndex>((id == 3) ? 2 : 1));
+    }
+    delegate.mActive.insert(1);
+
+    uint16_t count = 0;
+    EXPECT_EQ(scheduler.ScheduleResumptions(true, count), CHIP_NO_ERROR);
+    EXPECT_EQ(count, 4u);
+    EXPECT_FALSE(scheduler.IsResumptionScheduled(1));
+
+    // Subscription 2 goes live and the fabric of 3 is removed before the deadline; 4 cannot be started.
+    delegate.mActive.insert(2);
+    EXPECT_EQ(storage.DeleteAll(2), CHIP_NO_ERROR);
+    scheduler.CancelResumptions(2);
+    EXPECT_FALSE(scheduler.IsResumptionScheduled(3));
+    delegate.mFailures.insert(4);
+
+    timer.FireTimer();
+    ASSERT_EQ(delegate.mStarted.size(), 1u);
+    EXPECT_EQ(delegate.mStarted[0], 5u);
+    EXPECT_EQ(scheduler.GetScheduledCount(), 1u);
+    EXPECT_EQ(scheduler.GetInFlightCount(), 1u);
+
+    // Rescheduling keeps the in-flight attempt and does not start it again.
+    EXPECT_EQ(scheduler.ScheduleResumptions(false, count), CHIP_NO_ERROR);
+    EXPECT_EQ(count, 2u);
+    EXPECT_TRUE(scheduler.IsResumptionScheduled(4));
+    EXPECT_EQ(scheduler.GetInFlightCount(), 1u);
+
+    delegate.mFailures.clear();
+    timer.FireTimer();
+    ASSERT_EQ(delegate.mStarted.size(), 2u);
+    EXPECT_EQ(delegate.mStarted[1], 4u);
+
+    scheduler.OnResumptionAttemptDone(5);
+    scheduler.OnResumptionAttemptDone(4);
+    EXPECT_EQ(scheduler.GetScheduledCount(), 0u);
+    EXPECT_EQ(scheduler.GetInFlightCount(), 0u);
+    EXPECT_EQ(storage.mOpenIterators, 0);
+}
+
+TEST_F(TestSubscriptionResumptionScheduler, TestSynchronousCompletion)
+{
+    MockTimerDelegate timer;
+    MockSubscriptionResumptionStorage storage;
+    MockDelegate delegate;
+    SubscriptionResumptionScheduler scheduler;
+    ASSERT_EQ(scheduler.Init(&delegate, &timer, &storage, MakeConfig(2, 100, 0)), CHIP_NO_ERROR);
+    delegate.mScheduler             = &scheduler;
+    delegate.mCompleteSynchronously = true;
+
+    for (SubscriptionId id = 1; id <= 5; id++)
+    {
+        storage.Add(id, 0);
+    }
+
+    uint16_t count = 0;
+    EXPECT_EQ(scheduler.ScheduleResumptions(true, count), CHIP_NO_ERROR);
+    EXPECT_EQ(count, 5u);
+
+    // Attempts that complete from within the start call free their slot, but the next batch still waits for the pacing
+    // interval.
+    timer.FireTimer();
+    EXPECT_EQ(delegate.mStarted.size(), 2u);
+    EXPECT_EQ(scheduler.GetInFlightCount(), 0u);
+    EXPECT_EQ(timer.mDeadline, Timestamp(100_ms));
+
+    timer.FireTimer();
+    timer.FireTimer();
+    EXPECT_EQ(delegate.mStarted.size(), 5u);
+    EXPECT_EQ(scheduler.GetScheduledCount(), 0u);
+    EXPECT_FALSE(timer.IsTimerActive(&scheduler));
+}
+
+TEST_F(TestSubscriptionResumptionScheduler, TestResumeManySubscriptions)
+{
+    constexpr uint16_t kNumSubscriptions = 200;
+    constexpr uint16_t kMaxConcurrent    = 4;
+    constexpr auto kHandshakeLatency     = 300_ms64;
+
+    MockTimerDelegate timer;
+    MockSubscriptionResumptionStorage storage;
+    MockDelegate delegate;
+    SubscriptionResumptionScheduler scheduler;
+    ASSERT_EQ(scheduler.Init(&delegate, &timer, &storage, MakeConfig(kMaxConcurrent, 250, 250)), CHIP_NO_ERROR);
+
+    for (uint16_t i = 0; i < kNumSubscriptions; i++)
+    {
+        storage.Add(static_cast<SubscriptionId>(0x1000 + i * 7919u % kNumSubscriptions), static_cast<uint16_t>(1 + i % 10));
+    }
+
+    uint16_t count = 0;
+    EXPECT_EQ(scheduler.ScheduleResumptions(true, count), CHIP_NO_ERROR);
+    EXPECT_EQ(count, kNumSubscriptions);
+
+    // Drive the scheduler with simulated CASE handshakes that each take kHandshakeLatency to complete.
+    struct Handshake
+    {
+        SubscriptionId subscriptionId;
+        Timestamp completion;
+    };
+    std::vector<Handshake> handshakes;
+    size_t startedCount  = 0;
+    size_t peakInFlight  = 0;
+    size_t peakBurst     = 0;
+    Timestamp lastBatch  = Timestamp::zero();
+    size_t currentBurst  = 0;
+    size_t initialPasses = storage.mIterationCount;
+
+    while (startedCount < kNumSubscriptions || !handshakes.empty())
+    {
+        auto nextHandshake = std::min_element(handshakes.begin(), handshakes.end(),
+                                              [](const Handshake & a, const Handshake & b) { return a.completion < b.completion; });
+        bool timerFirst    = timer.IsTimerActive(&scheduler) &&
+            (nextHandshake == handshakes.end() || timer.mDeadline <= nextHandshake->completion);
+        if (timerFirst)
+        {
+            timer.FireTimer();
+        }
+        else
+        {
+            ASSERT_NE(nextHandshake, handshakes.end());
+            timer.mNow                    = std::max(timer.mNow, nextHandshake->completion);
+            SubscriptionId subscriptionId = nextHandshake->subscriptionId;
+            handshakes.erase(nextHandshake);
+            scheduler.OnResumptionAttemptDone(subscriptionId);
+        }
+
+        for (; startedCount < delegate.mStarted.size(); startedCount++)
+        {
+            handshakes.push_back({ delegate.mStarted[startedCount], timer.mNow + kHandshakeLatency });
+            currentBurst = (timer.mNow == lastBatch) ? currentBurst + 1 : 1;
+            lastBatch    = timer.mNow;
+            peakBurst    = std::max(peakBurst, currentBurst);
+        }
+        peakInFlight = std::max(peakInFlight, handshakes.size());
+        EXPECT_EQ(scheduler.GetInFlightCount(), handshakes.size());
+    }
+
+    std::set<SubscriptionId> started(delegate.mStarted.begin(), delegate.mStarted.end());
+    EXPECT_EQ(started.size(), kNumSubscriptions);
+    EXPECT_EQ(delegate.mStarted.size(), kNumSubscriptions);
+    EXPECT_LE(peakInFlight, kMaxConcurrent);
+    EXPECT_LE(peakBurst, kMaxConcurrent);
+    EXPECT_EQ(scheduler.GetScheduledCount(), 0u);
+    EXPECT_EQ(storage.mOpenIterators, 0);
+
+    // Batches start from the subscriptions loaded when scheduling, without going back to the storage.
+    size_t batchPasses = storage.mIterationCount - initialPasses;
+    EXPECT_EQ(batchPasses, 0u);
+}
+
+} // namespace
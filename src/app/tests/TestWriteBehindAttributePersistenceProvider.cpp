@@ -0,0 +1,246 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app-common/zap-generated/attribute-type.h>
+#include <app/DefaultAttributePersistenceProvider.h>
+#include <app/WriteBehindAttributePersistenceProvider.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <pw_unit_test/framework.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+constexpr System::Clock::Milliseconds32 kWriteDelay(1000);
+
+const ConcreteAttributePath kCurrentLevelPath(1, 0x0008, 0x0000);
+const ConcreteAttributePath kCurrentHuePath(1, 0x0300, 0x0000);
+
+const EmberAfAttributeMetadata kUint16Metadata = { .defaultValue  = EmberAfDefaultOrMinMaxAttributeValue(uint32_t(0)),
+                                                   .attributeId   = 0x0000,
+                                                   .size          = sizeof(uint16_t),
+                                                   .attributeType = ZCL_INT16U_ATTRIBUTE_TYPE };
+
+class CountingPersistentStorageDelegate : public TestPersistentStorageDelegate
+{
+public:
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override
+    {
+        mWrites++;
+        return TestPersistentStorageDelegate::SyncSetKeyValue(key, value, size);
+    }
+
+    size_t mWrites = 0;
+};
+
+class TestWriteBehindAttributePersistenceProvider : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+
+    void SetUp() override
+    {
+        ASSERT_EQ(mDefaultProvider.Init(&mStorage), CHIP_NO_ERROR);
+        // Without a system layer, pending values only get written by Flush, Shutdown, or when too many of them accumulate.
+        ASSERT_EQ(mProvider.Init(&mDefaultProvider, nullptr, kWriteDelay), CHIP_NO_ERROR);
+    }
+
+    void TearDown() override { mProvider.Shutdown(); }
+
+    CHIP_ERROR Write(const ConcreteAttributePath & path, uint16_t value)
+    {
+        return mProvider.WriteValue(path, ByteSpan(reinterpret_cast<const uint8_t *>(&value), sizeof(value)));
+    }
+
+    static CHIP_ERROR Read(AttributePersistenceProvider & provider, const ConcreteAttributePath & path, uint16_t & value)
+    {
+        MutableByteSpan span(reinterpret_cast<uint8_t *>(&value), sizeof(value));
+        ReturnErrorOnFailure(provider.ReadValue(path, &kUint16Metadata, span));
+        VerifyOrReturnError(span.size() == sizeof(value), CHIP_ERROR_INCORRECT_STATE);
+        return CHIP_NO_ERROR;
+    }
+
+    CountingPersistentStorageDelegate mStorage;
+    DefaultAttributePersistenceProvider mDefaultProvider;
+    WriteBehindAttributePersistenceProvider mProvider;
+};
+
+TEST_F(TestWriteBehindAttributePersistenceProvider, TestCoalescesWritesPerAttribute)
+{
+    for (uint16_t level = 0; level <= 100; level++)
+    {
+        EXPECT_EQ(Write(kCurrentLevelPath, level), CHIP_NO_ERROR);
+        EXPECT_EQ(Write(kCurrentHuePath, static_cast<uint16_t>(level * 2)), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(mStorage.mWrites, 0u);
+    EXPECT_EQ(mProvider.GetPendingWriteCount(), 2u);
+
+    // Only the last value of each attribute is written.
+    EXPECT_EQ(mProvider.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(mStorage.mWrites, 2u);
+    EXPECT_EQ(mProvider.GetPendingWriteCount(), 0u);
+
+    uint16_t value = 0;
+    EXPECT_EQ(Read(mDefaultProvider, kCurrentLevelPath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 100u);
+    EXPECT_EQ(Read(mDefaultProvider, kCurrentHuePath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 200u);
+
+    // Nothing left to write.
+    EXPECT_EQ(mProvider.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(mStorage.mWrites, 2u);
+}
+
+TEST_F(TestWriteBehindAttributePersistenceProvider, TestReadsPendingValues)
+{
+    EXPECT_EQ(Write(kCurrentLevelPath, 10), CHIP_NO_ERROR);
+    EXPECT_EQ(mProvider.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(Write(kCurrentLevelPath, 20), CHIP_NO_ERROR);
+
+    // The pending value is read back, while the storage still has the previous one.
+    uint16_t value = 0;
+    EXPECT_EQ(Read(mProvider, kCurrentLevelPath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 20u);
+    EXPECT_EQ(Read(mDefaultProvider, kCurrentLevelPath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 10u);
+
+    // Attributes without a pending value are read from storage.
+    EXPECT_NE(Read(mProvider, kCurrentHuePath, value), CHIP_NO_ERROR);
+
+    // A pending value that does not fit is reported as such.
+    uint8_t small[1];
+    MutableByteSpan smallSpan(small);
+    EXPECT_EQ(mProvider.ReadValue(kCurrentLevelPath, &kUint16Metadata, smallSpan), CHIP_ERROR_BUFFER_TOO_SMALL);
+}
+
+TEST_F(TestWriteBehindAttributePersistenceProvider, TestWritesAllWhenFull)
+{
+    for (AttributeId id = 0; id < WriteBehindAttributePersistenceProvider::kMaxPendingWrites; id++)
+    {
+        EXPECT_EQ(Write(ConcreteAttributePath(1, 0x0008, id), 1), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(mStorage.mWrites, 0u);
+
+    // Changing an attribute that already has a pending value does not need a new entry.
+    EXPECT_EQ(Write(ConcreteAttributePath(1, 0x0008, 0), 2), CHIP_NO_ERROR);
+    EXPECT_EQ(mStorage.mWrites, 0u);
+
+    // One more attribute writes all the pending values together, and keeps the new one pending.
+    EXPECT_EQ(Write(kCurrentHuePath, 3), CHIP_NO_ERROR);
+    EXPECT_EQ(mStorage.mWrites, WriteBehindAttributePersistenceProvider::kMaxPendingWrites);
+    EXPECT_EQ(mProvider.GetPendingWriteCount(), 1u);
+
+    uint16_t value = 0;
+    EXPECT_EQ(Read(mDefaultProvider, ConcreteAttributePath(1, 0x0008, 0), value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 2u);
+}
+
+TEST_F(TestWriteBehindAttributePersistenceProvider, TestKeepsFailedWritesPending)
+{
+    const StorageKeyName levelKey = DefaultStorageKeyAllocator::AttributeValue(
+        kCurrentLevelPath.mEndpointId, kCurrentLevelPath.mClusterId, kCurrentLevelPath.mAttributeId);
+    mStorage.AddPoisonKey(levelKey.KeyName());
+
+    EXPECT_EQ(Write(kCurrentLevelPath, 10), CHIP_NO_ERROR);
+    EXPECT_EQ(Write(kCurrentHuePath, 20), CHIP_NO_ERROR);
+
+    // The value that could not be written stays pending, and is still what gets read back.
+    EXPECT_NE(mProvider.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(mProvider.GetPendingWriteCount(), 1u);
+    uint16_t value = 0;
+    EXPECT_EQ(Read(mProvider, kCurrentLevelPath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 10u);
+    EXPECT_EQ(Read(mDefaultProvider, kCurrentHuePath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 20u);
+
+    // Once the storage recovers, the next flush writes it.
+    mStorage.ClearPoisonKeys();
+    EXPECT_EQ(mProvider.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(mProvider.GetPendingWriteCount(), 0u);
+    EXPECT_EQ(Read(mDefaultProvider, kCurrentLevelPath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 10u);
+}
+
+TEST_F(TestWriteBehindAttributePersistenceProvider, TestValueSizeChanges)
+{
+    const uint8_t shortString[] = { 1, 'a' };
+    const uint8_t longString[]  = { 3, 'a', 'b', 'c' };
+
+    EXPECT_EQ(mProvider.WriteValue(kCurrentLevelPath, ByteSpan(longString)), CHIP_NO_ERROR);
+    EXPECT_EQ(mProvider.WriteValue(kCurrentLevelPath, ByteSpan(shortString)), CHIP_NO_ERROR);
+    EXPECT_EQ(mProvider.GetPendingWriteCount(), 1u);
+
+    uint8_t buffer[8];
+    MutableByteSpan readBack(buffer);
+    EXPECT_EQ(mProvider.ReadValue(kCurrentLevelPath, &kUint16Metadata, readBack), CHIP_NO_ERROR);
+    EXPECT_TRUE(readBack.data_equal(ByteSpan(shortString)));
+}
+
+TEST_F(TestWriteBehindAttributePersistenceProvider, TestShutdownWritesAndDiscardDrops)
+{
+    EXPECT_EQ(Write(kCurrentLevelPath, 42), CHIP_NO_ERROR);
+    mProvider.DiscardPendingWrites();
+    EXPECT_EQ(mProvider.GetPendingWriteCount(), 0u);
+
+    EXPECT_EQ(Write(kCurrentHuePath, 7), CHIP_NO_ERROR);
+    mProvider.Shutdown();
+    EXPECT_EQ(mStorage.mWrites, 1u);
+
+    uint16_t value = 0;
+    EXPECT_NE(Read(mDefaultProvider, kCurrentLevelPath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(Read(mDefaultProvider, kCurrentHuePath, value), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 7u);
+
+    // Once shut down, nothing is accepted anymore.
+    EXPECT_EQ(Write(kCurrentHuePath, 8), CHIP_ERROR_INCORRECT_STATE);
+}
+
+// Compares the storage writes of a level and color transition, with and without write-behind.
+TEST_F(TestWriteBehindAttributePersistenceProvider, TestTransitionCoalescesStorageWrites)
+{
+    // A 10 s transition updating both attributes every 100 ms, with the write-behind timer firing every second.
+    constexpr uint16_t kSteps        = 100;
+    constexpr uint16_t kStepsPerTick = 10;
+
+    CountingPersistentStorageDelegate directStorage;
+    DefaultAttributePersistenceProvider directProvider;
+    ASSERT_EQ(directProvider.Init(&directStorage), CHIP_NO_ERROR);
+
+    for (uint16_t step = 1; step <= kSteps; step++)
+    {
+        ByteSpan value(reinterpret_cast<const uint8_t *>(&step), sizeof(step));
+        EXPECT_EQ(directProvider.WriteValue(kCurrentLevelPath, value), CHIP_NO_ERROR);
+        EXPECT_EQ(directProvider.WriteValue(kCurrentHuePath, value), CHIP_NO_ERROR);
+
+        EXPECT_EQ(Write(kCurrentLevelPath, step), CHIP_NO_ERROR);
+        EXPECT_EQ(Write(kCurrentHuePath, step), CHIP_NO_ERROR);
+        if (step % kStepsPerTick == 0)
+        {
+            EXPECT_EQ(mProvider.Flush(), CHIP_NO_ERROR);
+        }
+    }
+
+    EXPECT_EQ(directStorage.mWrites, 2u * kSteps);
+    EXPECT_EQ(mStorage.mWrites, 2u * kSteps / kStepsPerTick);
+}
+
+} // namespace
@@ -0,0 +1,118 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/util/BridgedEndpointManager.h>
+
+#include <app/util/attribute-storage.h>
+#include <app/util/endpoint-config-api.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#if CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT > 0
+
+namespace chip {
+namespace app {
+
+namespace {
+
+// Attempts with endpoint IDs that ember already uses, e.g. for endpoints not added through the manager.
+constexpr uint8_t kMaxRetries = 10;
+
+} // namespace
+
+void BridgedEndpointManager::Init(EndpointId firstEndpointId)
+{
+    if (firstEndpointId == kInvalidEndpointId)
+    {
+        uint16_t lastFixedIndex = static_cast<uint16_t>(emberAfFixedEndpointCount() - 1);
+        firstEndpointId         = static_cast<EndpointId>(emberAfEndpointFromIndex(lastFixedIndex) + 1);
+    }
+
+    mTable.Clear();
+    mFirstEndpointId = firstEndpointId;
+    mNextEndpointId  = firstEndpointId;
+}
+
+EndpointId BridgedEndpointManager::NextEndpointId(EndpointId endpointId) const
+{
+    // Wrap around before kInvalidEndpointId.
+    return (endpointId + 1 == kInvalidEndpointId) ? mFirstEndpointId : static_cast<EndpointId>(endpointId + 1);
+}
+
+CHIP_ERROR BridgedEndpointManager::AddEndpoint(uint64_t key, const EndpointConfig & config, uint16_t & outIndex)
+{
+    VerifyOrReturnError(mFirstEndpointId != kInvalidEndpointId, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(config.endpointType != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!mTable.IsFull(), CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(mTable.FindByKey(key) == kInvalidIndex, CHIP_ERROR_DUPLICATE_KEY_ID);
+
+    CHIP_ERROR err = CHIP_ERROR_ENDPOINT_EXISTS;
+    for (uint8_t retry = 0; retry < kMaxRetries && err == CHIP_ERROR_ENDPOINT_EXISTS; retry++)
+    {
+        // Endpoint IDs of the table are skipped without asking ember: since the table is not full, there is a free
+        // one within as many steps as there are endpoints.
+        EndpointId endpointId = mNextEndpointId;
+        while (mTable.FindByEndpoint(endpointId) != kInvalidIndex)
+        {
+            endpointId = NextEndpointId(endpointId);
+        }
+        mNextEndpointId = NextEndpointId(endpointId);
+
+        uint16_t index;
+        ReturnErrorOnFailure(mTable.Allocate(key, endpointId, index));
+
+        err = emberAfSetDynamicEndpoint(index, endpointId, config.endpointType, config.dataVersionStorage, config.deviceTypes,
+                                        config.parentEndpointId);
+        if (err == CHIP_NO_ERROR)
+        {
+            outIndex = index;
+            return CHIP_NO_ERROR;
+        }
+        mTable.Release(index);
+    }
+
+    if (err == CHIP_ERROR_ENDPOINT_EXISTS)
+    {
+        ChipLogError(DataManagement, "Failed to add dynamic endpoint after %u retries", kMaxRetries);
+    }
+    return err;
+}
+
+EndpointId BridgedEndpointManager::RemoveEndpoint(uint16_t index)
+{
+    VerifyOrReturnValue(mTable.IsInUse(index), kInvalidEndpointId);
+
+    EndpointId endpointId = mTable.GetEndpointId(index);
+    emberAfClearDynamicEndpoint(index);
+    mTable.Release(index);
+    return endpointId;
+}
+
+BridgedEndpointManager::ScopedBulkChange::ScopedBulkChange()
+{
+    emberAfBeginEndpointCompositionChange();
+}
+
+BridgedEndpointManager::ScopedBulkChange::~ScopedBulkChange()
+{
+    emberAfEndEndpointCompositionChange();
+}
+
+} // namespace app
+} // namespace chip
+
+#endif // CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT > 0
@@ -0,0 +1,112 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/util/DynamicEndpointTable.h>
+#include <app/util/af-types.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/Span.h>
+#include <platform/CHIPDeviceConfig.h>
+
+#if CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT > 0
+
+namespace chip {
+namespace app {
+
+/**
+ * Adds and removes the dynamic endpoints of a bridge, each of them associated with an application-defined key
+ * such as the node ID of the bridged device.
+ *
+ * Free dynamic endpoint indices and endpoint IDs are found without scanning the endpoints, and endpoints are
+ * looked up by key or by endpoint ID in constant time, which matters for bridges with hundreds of devices.
+ *
+ * Must be used with the Matter stack lock held, like the emberAfSetDynamicEndpoint functions it wraps.
+ */
+class BridgedEndpointManager
+{
+public:
+    static constexpr uint16_t kInvalidIndex = DynamicEndpointTable<CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT>::kInvalidIndex;
+
+    struct EndpointConfig
+    {
+        const EmberAfEndpointType * endpointType = nullptr;
+        Span<const EmberAfDeviceType> deviceTypes;
+        // Needs to remain allocated until the endpoint is removed.
+        Span<DataVersion> dataVersionStorage;
+        EndpointId parentEndpointId = kInvalidEndpointId;
+    };
+
+    /**
+     * Removes all the endpoints from the manager, without clearing them from ember.
+     *
+     * @param firstEndpointId  First dynamic endpoint ID to use; by default, the one after the last fixed endpoint.
+     */
+    void Init(EndpointId firstEndpointId = kInvalidEndpointId);
+
+    /**
+     * Adds a dynamic endpoint for the given key, using the next endpoint ID not in use.
+     *
+     * @param[out] outIndex  Dynamic endpoint index of the new endpoint.
+     *
+     * @retval CHIP_ERROR_NO_MEMORY         if all the dynamic endpoint indices are in use.
+     * @retval CHIP_ERROR_DUPLICATE_KEY_ID  if an endpoint was already added for the key.
+     * @retval CHIP_ERROR_ENDPOINT_EXISTS   if no endpoint ID could be found after several attempts.
+     * @retval other                        errors of emberAfSetDynamicEndpoint.
+     */
+    CHIP_ERROR AddEndpoint(uint64_t key, const EndpointConfig & config, uint16_t & outIndex);
+
+    /**
+     * Clears a dynamic endpoint added by AddEndpoint.
+     *
+     * @return the endpoint ID of the removed endpoint, or kInvalidEndpointId if the index is not in use.
+     */
+    EndpointId RemoveEndpoint(uint16_t index);
+
+    uint16_t FindIndexByKey(uint64_t key) const { return mTable.FindByKey(key); }
+    uint16_t FindIndexByEndpoint(EndpointId endpointId) const { return mTable.FindByEndpoint(endpointId); }
+    EndpointId GetEndpointId(uint16_t index) const { return mTable.GetEndpointId(index); }
+    uint64_t GetKey(uint16_t index) const { return mTable.GetKey(index); }
+    uint16_t GetEndpointCount() const { return mTable.Count(); }
+
+    /**
+     * Reports the Descriptor PartsList changes once, rather than once per endpoint, for the endpoints added or
+     * removed during its lifetime.
+     */
+    class ScopedBulkChange
+    {
+    public:
+        ScopedBulkChange();
+        ~ScopedBulkChange();
+
+        ScopedBulkChange(const ScopedBulkChange &)             = delete;
+        ScopedBulkChange & operator=(const ScopedBulkChange &) = delete;
+    };
+
+private:
+    EndpointId NextEndpointId(EndpointId endpointId) const;
+
+    DynamicEndpointTable<CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT> mTable;
+    EndpointId mFirstEndpointId = kInvalidEndpointId;
+    EndpointId mNextEndpointId  = kInvalidEndpointId;
+};
+
+} // namespace app
+} // namespace chip
+
+#endif // CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT > 0
@@ -0,0 +1,225 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/CodeUtils.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chip {
+namespace app {
+
+/**
+ * Tracks which dynamic endpoint indices are in use, for applications that add and remove many dynamic
+ * endpoints, such as bridges.
+ *
+ * Each index in use is associated with an endpoint ID and with an application-defined key, e.g. the node ID of
+ * a bridged device.  Free indices are kept in a free list, and both the endpoint ID and the key are hashed to
+ * their index, so that none of the operations depend on the number of endpoints.
+ */
+template <uint16_t kCapacity>
+class DynamicEndpointTable
+{
+public:
+    static_assert(kCapacity > 0, "A table needs room for at least one endpoint");
+    static_assert(kCapacity < UINT16_MAX, "Indices must fit in 16 bits, besides kInvalidIndex");
+
+    static constexpr uint16_t kInvalidIndex = UINT16_MAX;
+
+    DynamicEndpointTable() { Clear(); }
+
+    /**
+     * Frees all the indices.
+     */
+    void Clear()
+    {
+        for (uint16_t i = 0; i < kCapacity; i++)
+        {
+            mEntries[i].nextFree = static_cast<uint16_t>(i + 1 < kCapacity ? i + 1 : kInvalidIndex);
+            mEntries[i].inUse    = false;
+        }
+        for (size_t i = 0; i < kBucketCount; i++)
+        {
+            mKeyBuckets[i]      = kInvalidIndex;
+            mEndpointBuckets[i] = kInvalidIndex;
+        }
+        mFirstFree = 0;
+        mCount     = 0;
+    }
+
+    /**
+     * Takes a free index for the given key and endpoint ID.
+     *
+     * @retval CHIP_ERROR_NO_MEMORY         if all the indices are in use.
+     * @retval CHIP_ERROR_DUPLICATE_KEY_ID  if the key is already associated with an index.
+     * @retval CHIP_ERROR_ENDPOINT_EXISTS   if the endpoint ID is already associated with an index.
+     */
+    CHIP_ERROR Allocate(uint64_t key, EndpointId endpointId, uint16_t & outIndex)
+    {
+        VerifyOrReturnError(endpointId != kInvalidEndpointId, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(mFirstFree != kInvalidIndex, CHIP_ERROR_NO_MEMORY);
+        VerifyOrReturnError(FindByKey(key) == kInvalidIndex, CHIP_ERROR_DUPLICATE_KEY_ID);
+        VerifyOrReturnError(FindByEndpoint(endpointId) == kInvalidIndex, CHIP_ERROR_ENDPOINT_EXISTS);
+
+        uint16_t index   = mFirstFree;
+        Entry & entry    = mEntries[index];
+        mFirstFree       = entry.nextFree;
+        entry.key        = key;
+        entry.endpointId = endpointId;
+        entry.inUse      = true;
+        mCount++;
+
+        Insert(mKeyBuckets, KeyHash(key), index);
+        Insert(mEndpointBuckets, EndpointHash(endpointId), index);
+
+        outIndex = index;
+        return CHIP_NO_ERROR;
+    }
+
+    /**
+     * Frees an index, which is the first one to be taken again.
+     */
+    void Release(uint16_t index)
+    {
+        VerifyOrReturn(IsInUse(index));
+
+        Entry & entry = mEntries[index];
+        Erase(mKeyBuckets, KeyHash(entry.key), index, &DynamicEndpointTable::KeyHashAt);
+        Erase(mEndpointBuckets, EndpointHash(entry.endpointId), index, &DynamicEndpointTable::EndpointHashAt);
+
+        entry.inUse    = false;
+        entry.nextFree = mFirstFree;
+        mFirstFree     = index;
+        mCount--;
+    }
+
+    /**
+     * @return the index associated with the key, or kInvalidIndex.
+     */
+    uint16_t FindByKey(uint64_t key) const
+    {
+        for (size_t bucket = KeyHash(key);; bucket = NextBucket(bucket))
+        {
+            uint16_t index = mKeyBuckets[bucket];
+            if (index == kInvalidIndex || mEntries[index].key == key)
+            {
+                return index;
+            }
+        }
+    }
+
+    /**
+     * @return the index associated with the endpoint ID, or kInvalidIndex.
+     */
+    uint16_t FindByEndpoint(EndpointId endpointId) const
+    {
+        for (size_t bucket = EndpointHash(endpointId);; bucket = NextBucket(bucket))
+        {
+            uint16_t index = mEndpointBuckets[bucket];
+            if (index == kInvalidIndex || mEntries[index].endpointId == endpointId)
+            {
+                return index;
+            }
+        }
+    }
+
+    bool IsInUse(uint16_t index) const { return index < kCapacity && mEntries[index].inUse; }
+    uint64_t GetKey(uint16_t index) const { return mEntries[index].key; }
+    EndpointId GetEndpointId(uint16_t index) const { return IsInUse(index) ? mEntries[index].endpointId : kInvalidEndpointId; }
+
+    uint16_t Count() const { return mCount; }
+    bool IsFull() const { return mFirstFree == kInvalidIndex; }
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        EndpointId endpointId;
+        // Next index of the free list, while not in use.
+        uint16_t nextFree;
+        bool inUse;
+    };
+
+    // Open addressing with linear probing, at most half full so that probe sequences stay short.
+    static constexpr size_t BucketCountFor(size_t capacity)
+    {
+        size_t count = 1;
+        while (count < 2 * capacity)
+        {
+            count <<= 1;
+        }
+        return count;
+    }
+    static constexpr size_t kBucketCount = BucketCountFor(kCapacity);
+
+    static size_t Hash(uint64_t value)
+    {
+        // Fibonacci hashing: spreads both sequential endpoint IDs and node IDs over the buckets.
+        return static_cast<size_t>((value * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (kBucketCount - 1);
+    }
+    static size_t KeyHash(uint64_t key) { return Hash(key); }
+    static size_t EndpointHash(EndpointId endpointId) { return Hash(endpointId); }
+    static size_t NextBucket(size_t bucket) { return (bucket + 1) & (kBucketCount - 1); }
+
+    size_t KeyHashAt(uint16_t index) const { return KeyHash(mEntries[index].key); }
+    size_t EndpointHashAt(uint16_t index) const { return EndpointHash(mEntries[index].endpointId); }
+
+    static void Insert(uint16_t * buckets, size_t bucket, uint16_t index)
+    {
+        while (buckets[bucket] != kInvalidIndex)
+        {
+            bucket = NextBucket(bucket);
+        }
+        buckets[bucket] = index;
+    }
+
+    // Removes an index from its buckets, moving back the ones after it that would not be found anymore, so that no
+    // tombstones are needed.
+    void Erase(uint16_t * buckets, size_t bucket, uint16_t index, size_t (DynamicEndpointTable::*hashAt)(uint16_t) const)
+    {
+        while (buckets[bucket] != index)
+        {
+            bucket = NextBucket(bucket);
+        }
+
+        size_t hole = bucket;
+        for (size_t next = NextBucket(hole); buckets[next] != kInvalidIndex; next = NextBucket(next))
+        {
+            size_t home = (this->*hashAt)(buckets[next]);
+            // Distance from the home bucket of the index to where it is, compared with the one to the hole.
+            if (((next - home) & (kBucketCount - 1)) >= ((next - hole) & (kBucketCount - 1)))
+            {
+                buckets[hole] = buckets[next];
+                hole          = next;
+            }
+        }
+        buckets[hole] = kInvalidIndex;
+    }
+
+    Entry mEntries[kCapacity];
+    uint16_t mKeyBuckets[kBucketCount];
+    uint16_t mEndpointBuckets[kBucketCount];
+    uint16_t mFirstFree;
+    uint16_t mCount;
+};
+
+} // namespace app
+} // namespace chip
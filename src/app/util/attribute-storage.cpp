@@ -92,6 +92,36 @@ uint8_t singletonAttributeData[ACTUAL_SINGLETONS_SIZE];
 
 uint16_t emberEndpointCount = 0;
 
+// Parent endpoints whose PartsList changed while composition change reports are deferred, see
+// emberAfBeginEndpointCompositionChange.
+constexpr size_t kMaxDeferredPartsListChanges = 8;
+EndpointId deferredPartsListChanges[kMaxDeferredPartsListChanges];
+size_t deferredPartsListChangeCount = 0;
+uint16_t compositionChangeDepth     = 0;
+
+void ReportPartsListChange(EndpointId endpoint)
+{
+    if (compositionChangeDepth > 0)
+    {
+        for (size_t i = 0; i < deferredPartsListChangeCount; i++)
+        {
+            if (deferredPartsListChanges[i] == endpoint)
+            {
+                return;
+            }
+        }
+        if (deferredPartsListChangeCount < kMaxDeferredPartsListChanges)
+        {
+            deferredPartsListChanges[deferredPartsListChangeCount++] = endpoint;
+            return;
+        }
+        // Too many parents to keep track of, just report this one right away.
+    }
+
+    MatterReportingAttributeChangeCallback(endpoint, app::Clusters::Descriptor::Id,
+                                           app::Clusters::Descriptor::Attributes::PartsList::Id);
+}
+
 // If we have attributes that are more than 4 bytes, then
 // we need this data block for the defaults
 #if (defined(GENERATED_DEFAULTS) && GENERATED_DEFAULTS_COUNT)
@@ -254,7 +284,7 @@ uint16_t emberAfGetDynamicIndexFromEndpoint(EndpointId id)
     {
         if (emAfEndpoints[index].endpoint == id)
         {
-            return static_cast<uint8_t>(index - FIXED_ENDPOINT_COUNT);
+            return static_cast<uint16_t>(index - FIXED_ENDPOINT_COUNT);
         }
     }
     return kEmberInvalidEndpointIndex;
@@ -321,7 +351,7 @@ EndpointId emberAfClearDynamicEndpoint(uint16_t index)
 {
     EndpointId ep = 0;
 
-    index = static_cast<uint8_t>(index + FIXED_ENDPOINT_COUNT);
+    index = static_cast<uint16_t>(index + FIXED_ENDPOINT_COUNT);
 
     if ((index < MAX_ENDPOINT_COUNT) && (emAfEndpoints[index].endpoint != kInvalidEndpointId) &&
         (emberAfEndpointIndexIsEnabled(index)))
@@ -334,6 +364,24 @@ EndpointId emberAfClearDynamicEndpoint(uint16_t index)
     return ep;
 }
 
+void emberAfBeginEndpointCompositionChange()
+{
+    compositionChangeDepth++;
+}
+
+void emberAfEndEndpointCompositionChange()
+{
+    VerifyOrReturn(compositionChangeDepth > 0);
+    VerifyOrReturn(--compositionChangeDepth == 0);
+
+    for (size_t i = 0; i < deferredPartsListChangeCount; i++)
+    {
+        MatterReportingAttributeChangeCallback(deferredPartsListChanges[i], app::Clusters::Descriptor::Id,
+                                               app::Clusters::Descriptor::Attributes::PartsList::Id);
+    }
+    deferredPartsListChangeCount = 0;
+}
+
 uint16_t emberAfFixedEndpointCount()
 {
     return FIXED_ENDPOINT_COUNT;
@@ -931,8 +979,7 @@ bool emberAfEndpointEnableDisable(EndpointId endpoint, bool enable)
         EndpointId parentEndpointId = emberAfParentEndpointFromIndex(index);
         while (parentEndpointId != kInvalidEndpointId)
         {
-            MatterReportingAttributeChangeCallback(parentEndpointId, app::Clusters::Descriptor::Id,
-                                                   app::Clusters::Descriptor::Attributes::PartsList::Id);
+            ReportPartsListChange(parentEndpointId);
             uint16_t parentIndex = emberAfIndexFromEndpoint(parentEndpointId);
             if (parentIndex == kEmberInvalidEndpointIndex)
             {
@@ -942,8 +989,7 @@ bool emberAfEndpointEnableDisable(EndpointId endpoint, bool enable)
             parentEndpointId = emberAfParentEndpointFromIndex(parentIndex);
         }
 
-        MatterReportingAttributeChangeCallback(/* endpoint = */ 0, app::Clusters::Descriptor::Id,
-                                               app::Clusters::Descriptor::Attributes::PartsList::Id);
+        ReportPartsListChange(/* endpoint = */ 0);
     }
 
     return true;
@@ -256,6 +256,14 @@ CHIP_ERROR emberAfSetDynamicEndpoint(uint16_t index, chip::EndpointId id, const
                                      chip::EndpointId parentEndpointId                  = chip::kInvalidEndpointId);
 chip::EndpointId emberAfClearDynamicEndpoint(uint16_t index);
 uint16_t emberAfGetDynamicIndexFromEndpoint(chip::EndpointId id);
+
+// Defer the Descriptor PartsList change reports caused by enabling or disabling endpoints,
+// e.g. while adding or removing many dynamic endpoints at once.  Every PartsList that changed
+// is then reported once, by the emberAfEndEndpointCompositionChange call matching the outermost
+// emberAfBeginEndpointCompositionChange call, instead of once per endpoint.
+void emberAfBeginEndpointCompositionChange();
+void emberAfEndEndpointCompositionChange();
+
 /**
  * @brief Loads attribute defaults and any non-volatile attributes stored
  *
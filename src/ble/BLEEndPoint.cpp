@@ -533,6 +533,7 @@ CHIP_ERROR BLEEndPoint::Init(BleLayer * bleLayer, BLE_CONNECTION_OBJECT connObj,
     mLocalReceiveWindowSize  = 0;
     mRemoteReceiveWindowSize = 0;
     mReceiveWindowMaxSize    = 0;
+    mGattSendsInFlight       = 0;
     mSendQueue               = nullptr;
     mAckToSend               = nullptr;
 
@@ -562,6 +563,22 @@ void BLEEndPoint::Release()
     }
 }
 
+CHIP_ERROR BLEEndPoint::SendTxFragment()
+{
+#if BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT > 1
+    // The fragmenter writes the header of the next fragment over the end of this one, which the platform may still hold
+    // when several GATT sends are in flight, so hand it a copy.
+    PacketBufferHandle fragment = mBtpEngine.BorrowTxPacket();
+    PacketBufferHandle copy =
+        System::PacketBufferHandle::NewWithData(fragment->Start(), fragment->DataLength(), 0, CHIP_CONFIG_BLE_PKT_RESERVED_SIZE);
+    VerifyOrReturnError(!copy.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    return SendCharacteristic(std::move(copy));
+#else
+    return SendCharacteristic(mBtpEngine.BorrowTxPacket());
+#endif
+}
+
 CHIP_ERROR BLEEndPoint::SendCharacteristic(PacketBufferHandle && buf)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
@@ -699,7 +716,7 @@ CHIP_ERROR BLEEndPoint::SendNextMessage()
         ExitNow();
     });
      */
-    ReturnErrorOnFailure(SendCharacteristic(mBtpEngine.BorrowTxPacket()));
+    ReturnErrorOnFailure(SendTxFragment());
 
     if (sentAck)
     {
@@ -724,7 +741,7 @@ CHIP_ERROR BLEEndPoint::ContinueMessageSend()
         return BLE_ERROR_CHIPOBLE_PROTOCOL_ABORT;
     }
 
-    ReturnErrorOnFailure(SendCharacteristic(mBtpEngine.BorrowTxPacket()));
+    ReturnErrorOnFailure(SendTxFragment());
 
     if (sentAck)
     {
@@ -855,6 +872,10 @@ CHIP_ERROR BLEEndPoint::HandleGattSendConfirmationReceived()
     ChipLogDebugBleEndPoint(Ble, "entered HandleGattSendConfirmationReceived");
 
     // Mark outstanding GATT operation as finished.
+    if (mGattSendsInFlight > 0)
+    {
+        mGattSendsInFlight--;
+    }
     mConnStateFlags.Clear(ConnectionStateFlag::kGattOperationInFlight);
 
     // If confirmation was for outbound portion of BTP connect handshake...
@@ -902,6 +923,12 @@ CHIP_ERROR BLEEndPoint::DoSendStandAloneAck()
     return StartAckReceivedTimer();
 }
 
+bool BLEEndPoint::IsStandAloneAckPending() const
+{
+    // mAckToSend also holds a stand-alone ack in flight until it is confirmed, while other GATT sends may go out.
+    return !mAckToSend.IsNull() && !mConnStateFlags.Has(ConnectionStateFlag::kStandAloneAckInFlight);
+}
+
 CHIP_ERROR BLEEndPoint::DriveSending()
 {
     ChipLogDebugBleEndPoint(Ble, "entered DriveSending");
@@ -909,12 +936,12 @@ CHIP_ERROR BLEEndPoint::DriveSending()
     // If receiver's window is almost closed and we don't have an ack to send, OR we do have an ack to send but
     // receiver's window is completely empty, OR another GATT operation is in flight, awaiting confirmation...
     if ((mRemoteReceiveWindowSize <= BTP_WINDOW_NO_ACK_SEND_THRESHOLD &&
-         !mTimerStateFlags.Has(TimerStateFlag::kSendAckTimerRunning) && mAckToSend.IsNull()) ||
+         !mTimerStateFlags.Has(TimerStateFlag::kSendAckTimerRunning) && !IsStandAloneAckPending()) ||
         (mRemoteReceiveWindowSize == 0) || (mConnStateFlags.Has(ConnectionStateFlag::kGattOperationInFlight)))
     {
 #ifdef CHIP_BLE_END_POINT_DEBUG_LOGGING_ENABLED
         if (mRemoteReceiveWindowSize <= BTP_WINDOW_NO_ACK_SEND_THRESHOLD &&
-            !mTimerStateFlags.Has(TimerStateFlag::kSendAckTimerRunning) && mAckToSend.IsNull())
+            !mTimerStateFlags.Has(TimerStateFlag::kSendAckTimerRunning) && !IsStandAloneAckPending())
         {
             ChipLogDebugBleEndPoint(Ble, "NO SEND: receive window almost closed, and no ack to send");
         }
@@ -935,8 +962,9 @@ CHIP_ERROR BLEEndPoint::DriveSending()
     }
 
     // Otherwise, let's see what we can send.
+    uint8_t gattSendsInFlight = mGattSendsInFlight;
 
-    if (!mAckToSend.IsNull()) // If immediate, stand-alone ack is pending, send it.
+    if (IsStandAloneAckPending()) // If immediate, stand-alone ack is pending, send it.
     {
         ReturnErrorOnFailure(DoSendStandAloneAck());
     }
@@ -981,6 +1009,12 @@ CHIP_ERROR BLEEndPoint::DriveSending()
         }
     }
 
+    // If something was sent and the platform has room for more GATT sends, send the next fragment too.
+    if (mGattSendsInFlight > gattSendsInFlight && !mConnStateFlags.Has(ConnectionStateFlag::kGattOperationInFlight))
+    {
+        return DriveSending();
+    }
+
     return CHIP_NO_ERROR;
 }
 
@@ -1309,16 +1343,29 @@ exit:
     return err;
 }
 
+void BLEEndPoint::MarkGattSendInFlight()
+{
+    mGattSendsInFlight++;
+
+    // Wait for a confirmation before the next send once there are as many sends in flight as the platform allows, or
+    // while the BTP handshake is in progress.
+    if (mGattSendsInFlight >= BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT ||
+        !mConnStateFlags.Has(ConnectionStateFlag::kCapabilitiesConfReceived))
+    {
+        mConnStateFlags.Set(ConnectionStateFlag::kGattOperationInFlight);
+    }
+}
+
 bool BLEEndPoint::SendWrite(PacketBufferHandle && buf)
 {
-    mConnStateFlags.Set(ConnectionStateFlag::kGattOperationInFlight);
+    MarkGattSendInFlight();
 
     return mBle->mPlatformDelegate->SendWriteRequest(mConnObj, &CHIP_BLE_SVC_ID, &CHIP_BLE_CHAR_1_UUID, std::move(buf));
 }
 
 bool BLEEndPoint::SendIndication(PacketBufferHandle && buf)
 {
-    mConnStateFlags.Set(ConnectionStateFlag::kGattOperationInFlight);
+    MarkGattSendInFlight();
 
     return mBle->mPlatformDelegate->SendIndication(mConnObj, &CHIP_BLE_SVC_ID, &CHIP_BLE_CHAR_2_UUID, std::move(buf));
 }
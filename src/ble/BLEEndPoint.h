@@ -118,7 +118,7 @@ private:
         kDidBeginSubscribe        = 0x08, // GATT subscribe request sent; must unsubscribe on close.
         kStandAloneAckInFlight    = 0x10, // Stand-alone ack in flight, awaiting GATT confirmation.
         kGattOperationInFlight    = 0x20  // GATT write, indication, subscribe, or unsubscribe in flight,
-                                          // awaiting GATT confirmation.
+                                          // awaiting GATT confirmation before another one may be sent.
     };
 
     enum class TimerStateFlag : uint8_t
@@ -152,6 +152,8 @@ private:
     SequenceNumber_t mLocalReceiveWindowSize;
     SequenceNumber_t mRemoteReceiveWindowSize;
     SequenceNumber_t mReceiveWindowMaxSize;
+    // GATT writes or indications sent and not confirmed yet, up to BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT.
+    uint8_t mGattSendsInFlight;
 
     // Private functions:
     BLEEndPoint()  = delete;
@@ -168,9 +170,12 @@ private:
     CHIP_ERROR SendNextMessage();
     CHIP_ERROR ContinueMessageSend();
     CHIP_ERROR DoSendStandAloneAck();
+    bool IsStandAloneAckPending() const;
+    CHIP_ERROR SendTxFragment();
     CHIP_ERROR SendCharacteristic(PacketBufferHandle && buf);
     bool SendIndication(PacketBufferHandle && buf);
     bool SendWrite(PacketBufferHandle && buf);
+    void MarkGattSendInFlight();
 
     // Receive path:
     CHIP_ERROR HandleConnectComplete();
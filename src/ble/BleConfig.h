@@ -160,6 +160,32 @@
 #error "BLE_MAX_RECEIVE_WINDOW_SIZE must be greater than 2 for BLE transport protocol stability."
 #endif
 
+/**
+ *  @def BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT
+ *
+ *  @brief
+ *    This is the maximum number of BTP fragments and stand-alone acks a BLE end point hands to the platform before
+ *    receiving the GATT confirmation of the first of them. The remote receive window still limits the number of
+ *    fragments sent without BTP-layer acknowledgement.
+ *
+ *    With the default value of 1, the end point waits for the confirmation of each GATT write or indication before it
+ *    prepares the next fragment, so that consecutive fragments are always separated by a round trip through the CHIP
+ *    event loop. Platforms whose BLE stack queues GATT writes and indications, and transmits each of them as soon as
+ *    the previous one is confirmed, may raise this value to send fragments back to back. Each fragment in flight then
+ *    uses its own packet buffer, and this value counts against the GATT buffers discussed for
+ *    BLE_MAX_RECEIVE_WINDOW_SIZE.
+ *
+ *    The GATT operations of the BTP handshake are always confirmed one at a time.
+ *
+ */
+#ifndef BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT
+#define BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT 1
+#endif
+
+#if (BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT < 1) || (BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT > BLE_MAX_RECEIVE_WINDOW_SIZE)
+#error "BLE_CONFIG_MAX_GATT_SENDS_IN_FLIGHT must be between 1 and BLE_MAX_RECEIVE_WINDOW_SIZE."
+#endif
+
 /**
  *  @def BLE_CONFIG_ERROR_MIN
  *
@@ -300,17 +300,18 @@ CHIP_ERROR BtpEngine::HandleCharacteristicReceived(System::PacketBufferHandle &&
 
         data->ConsumeHead(static_cast<uint16_t>(startReader.OctetsRead()));
 
-        // Create a new buffer for use as the Rx re-assembly area.
-        mRxBuf = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSize);
+        // For now, limit BtpEngine message size to max length of 1 pbuf, as we do for chip messages sent via IP.
+        // TODO add support for BtpEngine messages longer than 1 pbuf
+        VerifyOrExit(mRxLength <= System::PacketBuffer::kMaxSize, err = CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG);
 
-        VerifyOrExit(!mRxBuf.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+        // Create a new buffer for use as the Rx re-assembly area, sized for the whole message so that every fragment
+        // is copied to its final place as it arrives.
+        mRxBuf = System::PacketBufferHandle::New(mRxLength);
 
-        mRxBuf->AddToEnd(std::move(data));
-        mRxBuf->CompactHead(); // will free 'data' and adjust rx buf's end/length
+        VerifyOrExit(!mRxBuf.IsNull(), err = CHIP_ERROR_NO_MEMORY);
 
-        // For now, limit BtpEngine message size to max length of 1 pbuf, as we do for chip messages sent via IP.
-        // TODO add support for BtpEngine messages longer than 1 pbuf
-        VerifyOrExit(!mRxBuf->HasChainedBuffer(), err = CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG);
+        err = AppendToRxBuf(std::move(data));
+        SuccessOrExit(err);
     }
     else if (mRxState == kState_InProgress)
     {
@@ -322,12 +323,8 @@ CHIP_ERROR BtpEngine::HandleCharacteristicReceived(System::PacketBufferHandle &&
                      err = BLE_ERROR_INVALID_BTP_HEADER_FLAGS);
 
         // Add received fragment to reassembled message buffer.
-        mRxBuf->AddToEnd(std::move(data));
-        mRxBuf->CompactHead(); // will free 'data' and adjust rx buf's end/length
-
-        // For now, limit BtpEngine message size to max length of 1 pbuf, as we do for chip messages sent via IP.
-        // TODO add support for BtpEngine messages longer than 1 pbuf
-        VerifyOrExit(!mRxBuf->HasChainedBuffer(), err = CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG);
+        err = AppendToRxBuf(std::move(data));
+        SuccessOrExit(err);
     }
     else
     {
@@ -337,16 +334,8 @@ CHIP_ERROR BtpEngine::HandleCharacteristicReceived(System::PacketBufferHandle &&
 
     if (rx_flags.Has(HeaderFlags::kEndMessage))
     {
-        // Trim remainder, if any, of the received packet buffer based on sender-specified length of reassembled message.
-        VerifyOrExit(CanCastTo<uint16_t>(mRxBuf->DataLength()), err = CHIP_ERROR_MESSAGE_TOO_LONG);
-        int padding = static_cast<uint16_t>(mRxBuf->DataLength()) - mRxLength;
-
-        if (padding > 0)
-        {
-            mRxBuf->SetDataLength(static_cast<size_t>(mRxLength));
-        }
-
-        // Ensure all received fragments add up to sender-specified total message size.
+        // Ensure all received fragments add up to sender-specified total message size. Any remainder past that size
+        // was dropped by AppendToRxBuf.
         VerifyOrExit(mRxBuf->DataLength() == mRxLength, err = BLE_ERROR_REASSEMBLER_MISSING_DATA);
 
         // We've reassembled the entire message.
@@ -389,6 +378,20 @@ exit:
     return err;
 }
 
+CHIP_ERROR BtpEngine::AppendToRxBuf(System::PacketBufferHandle && data)
+{
+    // Copy no more than the sender-specified length of the reassembled message, which the buffer was sized for.
+    size_t length = chip::min(data->TotalLength(), static_cast<size_t>(mRxLength) - mRxBuf->DataLength());
+
+    ReturnErrorOnFailure(data->Read(mRxBuf->Start() + mRxBuf->DataLength(), length));
+    mRxBuf->SetDataLength(mRxBuf->DataLength() + length);
+
+    // The fragment is no longer needed, so give its buffer back right away.
+    data = nullptr;
+
+    return CHIP_NO_ERROR;
+}
+
 PacketBufferHandle BtpEngine::TakeRxPacket()
 {
     if (mRxState == kState_Complete)
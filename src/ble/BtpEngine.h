@@ -153,6 +153,7 @@ private:
     // Private functions:
     bool IsValidAck(SequenceNumber_t ack_num) const;
     CHIP_ERROR HandleAckReceived(SequenceNumber_t ack_num);
+    CHIP_ERROR AppendToRxBuf(System::PacketBufferHandle && data);
 };
 
 } /* namespace Ble */
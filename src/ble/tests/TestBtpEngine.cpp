@@ -122,6 +122,54 @@ TEST_F(TestBtpEngine, HandleCharacteristicReceivedThreePacket)
     EXPECT_EQ(mBtpEngine.RxState(), BtpEngine::kState_Complete);
 }
 
+TEST_F(TestBtpEngine, HandleCharacteristicReceivedPadding)
+{
+    // The message is 2-byte long, the remainder of the last fragment is dropped.
+    constexpr uint8_t packetData0[] = { to_underlying(BtpEngine::HeaderFlags::kStartMessage), 0x01, 0x02, 0x00, 0xfe };
+    constexpr uint8_t packetData1[] = { to_underlying(BtpEngine::HeaderFlags::kEndMessage), 0x02, 0xff, 0x00, 0x00 };
+
+    SequenceNumber_t receivedAck;
+    bool didReceiveAck;
+    auto packet0 = System::PacketBufferHandle::NewWithData(packetData0, sizeof(packetData0));
+    EXPECT_EQ(mBtpEngine.HandleCharacteristicReceived(std::move(packet0), receivedAck, didReceiveAck), CHIP_NO_ERROR);
+    auto packet1 = System::PacketBufferHandle::NewWithData(packetData1, sizeof(packetData1));
+    EXPECT_EQ(mBtpEngine.HandleCharacteristicReceived(std::move(packet1), receivedAck, didReceiveAck), CHIP_NO_ERROR);
+    EXPECT_EQ(mBtpEngine.RxState(), BtpEngine::kState_Complete);
+
+    auto message = mBtpEngine.TakeRxPacket();
+    ASSERT_EQ(message->DataLength(), static_cast<size_t>(2));
+    EXPECT_EQ(message->Start()[0], 0xfe);
+    EXPECT_EQ(message->Start()[1], 0xff);
+}
+
+TEST_F(TestBtpEngine, HandleCharacteristicReceivedMissingData)
+{
+    constexpr uint8_t packetData0[] = { to_underlying(BtpEngine::HeaderFlags::kStartMessage), 0x01, 0x03, 0x00, 0xfd };
+    constexpr uint8_t packetData1[] = { to_underlying(BtpEngine::HeaderFlags::kEndMessage), 0x02, 0xfe };
+
+    SequenceNumber_t receivedAck;
+    bool didReceiveAck;
+    auto packet0 = System::PacketBufferHandle::NewWithData(packetData0, sizeof(packetData0));
+    EXPECT_EQ(mBtpEngine.HandleCharacteristicReceived(std::move(packet0), receivedAck, didReceiveAck), CHIP_NO_ERROR);
+    auto packet1 = System::PacketBufferHandle::NewWithData(packetData1, sizeof(packetData1));
+    EXPECT_EQ(mBtpEngine.HandleCharacteristicReceived(std::move(packet1), receivedAck, didReceiveAck),
+              BLE_ERROR_REASSEMBLER_MISSING_DATA);
+    EXPECT_EQ(mBtpEngine.RxState(), BtpEngine::kState_Error);
+}
+
+TEST_F(TestBtpEngine, HandleCharacteristicReceivedTooBig)
+{
+    // Messages longer than a packet buffer are rejected on their first fragment.
+    constexpr uint8_t packetData0[] = { to_underlying(BtpEngine::HeaderFlags::kStartMessage), 0x01, 0xff, 0xff, 0xfe };
+
+    SequenceNumber_t receivedAck;
+    bool didReceiveAck;
+    auto packet0 = System::PacketBufferHandle::NewWithData(packetData0, sizeof(packetData0));
+    EXPECT_EQ(mBtpEngine.HandleCharacteristicReceived(std::move(packet0), receivedAck, didReceiveAck),
+              CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG);
+    EXPECT_EQ(mBtpEngine.RxState(), BtpEngine::kState_Error);
+}
+
 TEST_F(TestBtpEngine, HandleCharacteristicSendOnePacket)
 {
     auto packet0 = System::PacketBufferHandle::New(10);
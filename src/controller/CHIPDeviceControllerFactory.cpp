@@ -38,7 +38,7 @@
 
 #include <app/server/Dnssd.h>
 #include <protocols/secure_channel/CASEServer.h>
-#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+#include <protocols/secure_channel/CachedSessionResumptionStorage.h>
 
 using namespace chip::Inet;
 using namespace chip::System;
@@ -196,6 +196,8 @@ CHIP_ERROR DeviceControllerFactory::InitSystemState(FactoryInitParams params)
         fabricTableInitParams.storage             = params.fabricIndependentStorage;
         fabricTableInitParams.operationalKeystore = params.operationalKeystore;
         fabricTableInitParams.opCertStore         = params.opCertStore;
+        // Controllers may hold many fabrics, whose loading would otherwise dominate startup.
+        fabricTableInitParams.enableStartupSnapshot = true;
         ReturnErrorOnFailure(newFabricTable->Init(fabricTableInitParams));
         stateParams.fabricTable = newFabricTable.release();
         tempFabricTable         = stateParams.fabricTable;
@@ -204,8 +206,8 @@ CHIP_ERROR DeviceControllerFactory::InitSystemState(FactoryInitParams params)
     SessionResumptionStorage * sessionResumptionStorage;
     if (params.sessionResumptionStorage == nullptr)
     {
-        auto ownedSessionResumptionStorage = chip::Platform::MakeUnique<SimpleSessionResumptionStorage>();
-        ReturnErrorOnFailure(ownedSessionResumptionStorage->Init(params.fabricIndependentStorage));
+        auto ownedSessionResumptionStorage = chip::Platform::MakeUnique<CachedSessionResumptionStorage>();
+        ReturnErrorOnFailure(ownedSessionResumptionStorage->Init(params.fabricIndependentStorage, stateParams.systemLayer));
         stateParams.ownedSessionResumptionStorage    = std::move(ownedSessionResumptionStorage);
         stateParams.externalSessionResumptionStorage = nullptr;
         sessionResumptionStorage                     = stateParams.ownedSessionResumptionStorage.get();
@@ -476,6 +478,13 @@ void DeviceControllerSystemState::Shutdown()
         mCASESessionManager = nullptr;
     }
 
+    // Persist the session resumption records saved by the CASE handshakes while the
+    // write-behind timer can still be cancelled.
+    if (mOwnedSessionResumptionStorage)
+    {
+        mOwnedSessionResumptionStorage->Shutdown();
+    }
+
     // The above took care of CASE handshakes, and shutting down all the
     // controllers should have taken care of the PASE handshakes.  Clean up any
     // outstanding secure sessions (shouldn't really be any, since controllers
@@ -0,0 +1,273 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <controller/CommissioningOrchestrator.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <tracing/metric_event.h>
+
+using namespace chip::Tracing;
+
+namespace chip {
+namespace Controller {
+
+namespace {
+
+System::Clock::Milliseconds32 ElapsedSince(System::Clock::Timestamp & since)
+{
+    System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    auto elapsed                 = std::chrono::duration_cast<System::Clock::Milliseconds32>(now - since);
+    since                        = now;
+    return elapsed;
+}
+
+} // namespace
+
+CHIP_ERROR CommissioningOrchestrator::Init(const InitParams & params)
+{
+    VerifyOrReturnError(params.systemLayer != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.delegate != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.deviceAttestationVerifier != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.operationalCredentialsDelegate != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.maxConcurrentAttestations > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.maxConcurrentNOCChainGenerations > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mSystemLayer = params.systemLayer;
+    mDelegate    = params.delegate;
+    mPaused      = true;
+    mAttestationPool.SetMaxInFlight(params.maxConcurrentAttestations);
+    mNOCChainGenerationPool.SetMaxInFlight(params.maxConcurrentNOCChainGenerations);
+
+    for (auto & lane : mLanes)
+    {
+        lane.mOrchestrator = this;
+        lane.mCommissioner        = nullptr;
+        lane.mBusy                = false;
+        lane.mAbandonedOperations = 0;
+        lane.mAttestationVerifier.Init(params.deviceAttestationVerifier, &mAttestationPool);
+        lane.mOperationalCredentialsDelegate.Init(params.operationalCredentialsDelegate, &mNOCChainGenerationPool);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void CommissioningOrchestrator::Shutdown()
+{
+    VerifyOrReturn(mSystemLayer != nullptr);
+
+    mPaused = true;
+    mSystemLayer->CancelTimer(OnLaneFreed, this);
+
+    for (auto & lane : mLanes)
+    {
+        if (lane.mCommissioner != nullptr && lane.mCommissioner->GetPairingDelegate() == &lane)
+        {
+            lane.mCommissioner->RegisterPairingDelegate(nullptr);
+        }
+        lane.mAttestationVerifier.Abandon(nullptr);
+        lane.mOperationalCredentialsDelegate.Abandon(nullptr);
+        lane.mCommissioner        = nullptr;
+        lane.mBusy                = false;
+        lane.mAbandonedOperations = 0;
+    }
+
+    mSystemLayer = nullptr;
+    mDelegate    = nullptr;
+}
+
+OperationalCredentialsDelegate * CommissioningOrchestrator::GetOperationalCredentialsDelegate(uint8_t laneIndex)
+{
+    VerifyOrReturnValue(laneIndex < kMaxLanes, nullptr);
+    return &mLanes[laneIndex].mOperationalCredentialsDelegate;
+}
+
+CHIP_ERROR CommissioningOrchestrator::SetCommissioner(uint8_t laneIndex, DeviceCommissioner * commissioner)
+{
+    VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(laneIndex < kMaxLanes && commissioner != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    Lane & lane = mLanes[laneIndex];
+    VerifyOrReturnError(!lane.IsActive(), CHIP_ERROR_BUSY);
+    VerifyOrReturnError(commissioner->GetOperationalCredentialsDelegate() == &lane.mOperationalCredentialsDelegate,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+    commissioner->SetDeviceAttestationVerifier(&lane.mAttestationVerifier);
+    commissioner->RegisterPairingDelegate(&lane);
+    lane.mCommissioner = commissioner;
+    return CHIP_NO_ERROR;
+}
+
+void CommissioningOrchestrator::Start()
+{
+    VerifyOrReturn(mSystemLayer != nullptr);
+
+    mPaused = false;
+    FillLanes();
+}
+
+uint8_t CommissioningOrchestrator::GetActiveLaneCount() const
+{
+    uint8_t count = 0;
+    for (const auto & lane : mLanes)
+    {
+        if (lane.IsActive())
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+void CommissioningOrchestrator::FillLanes()
+{
+    // The delegate may call Start() from its callbacks.
+    VerifyOrReturn(!mFillingLanes);
+    mFillingLanes = true;
+
+    bool noMoreDevices = false;
+    for (auto & lane : mLanes)
+    {
+        if (mPaused || noMoreDevices)
+        {
+            break;
+        }
+        if (lane.mCommissioner != nullptr && !lane.IsActive())
+        {
+            noMoreDevices = !StartNextDevice(lane);
+        }
+    }
+
+    mFillingLanes = false;
+
+    if ((mPaused || noMoreDevices) && GetActiveLaneCount() == 0)
+    {
+        mDelegate->OnIdle();
+    }
+}
+
+bool CommissioningOrchestrator::StartNextDevice(Lane & lane)
+{
+    DeviceToCommission device;
+    while (!mPaused && mDelegate->GetNextDevice(device))
+    {
+        lane.mNodeId    = device.nodeId;
+        lane.mBusy      = true;
+        lane.mStartTime = lane.mLastStageTime = System::SystemClock().GetMonotonicTimestamp();
+
+        CHIP_ERROR err = PairDevice(*lane.mCommissioner, device);
+
+        // The commissioner may have failed synchronously, after reporting the failure to the lane.
+        VerifyOrReturnValue(lane.mBusy, true);
+        if (err == CHIP_NO_ERROR)
+        {
+            return true;
+        }
+
+        ChipLogError(Controller, "Failed to start commissioning node 0x" ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueX64(device.nodeId), err.Format());
+        lane.mBusy = false;
+        mDelegate->OnDeviceCommissioned(device.nodeId, err, ElapsedSince(lane.mStartTime));
+        device = DeviceToCommission();
+    }
+
+    // Out of devices, unless the delegate paused the orchestrator.
+    return mPaused;
+}
+
+CHIP_ERROR CommissioningOrchestrator::PairDevice(DeviceCommissioner & commissioner, DeviceToCommission & device)
+{
+    if (device.rendezvousParameters.HasValue())
+    {
+        return commissioner.PairDevice(device.nodeId, device.rendezvousParameters.Value(), device.commissioningParameters);
+    }
+    return commissioner.PairDevice(device.nodeId, device.setUpCode, device.commissioningParameters, device.discoveryType);
+}
+
+void CommissioningOrchestrator::OnDeviceDone(Lane & lane, CHIP_ERROR error)
+{
+    VerifyOrReturn(lane.mBusy);
+    lane.mBusy = false;
+
+    // A failed device may leave work queued in the pools, which would otherwise hold up the other lanes and then run
+    // against buffers the commissioner no longer keeps. Work in progress cannot be withdrawn: the lane takes no other
+    // device until it completes, since a request of the next device would overwrite it, and its result is dropped.
+    if (lane.mAttestationVerifier.Abandon(&lane.mAbandonedOperationDone))
+    {
+        lane.mAbandonedOperations++;
+    }
+    if (lane.mOperationalCredentialsDelegate.Abandon(&lane.mAbandonedOperationDone))
+    {
+        lane.mAbandonedOperations++;
+    }
+
+    System::Clock::Milliseconds32 duration = ElapsedSince(lane.mStartTime);
+    MATTER_LOG_METRIC(kMetricCommissioningOrchestratorDevice, duration.count());
+    mDelegate->OnDeviceCommissioned(lane.mNodeId, error, duration);
+
+    // The commissioner is still cleaning up the device: start the next one afterwards.
+    if (mSystemLayer->StartTimer(System::Clock::kZero, OnLaneFreed, this) != CHIP_NO_ERROR)
+    {
+        ChipLogError(Controller, "Failed to schedule the next device to commission");
+    }
+}
+
+void CommissioningOrchestrator::OnLaneFreed(System::Layer * systemLayer, void * context)
+{
+    static_cast<CommissioningOrchestrator *>(context)->FillLanes();
+}
+
+void CommissioningOrchestrator::Lane::OnAbandonedOperationDone(void * context)
+{
+    auto * lane = static_cast<Lane *>(context);
+    VerifyOrDie(lane->mAbandonedOperations > 0);
+    lane->mAbandonedOperations--;
+    VerifyOrReturn(!lane->IsActive());
+
+    if (lane->mOrchestrator->mSystemLayer->StartTimer(System::Clock::kZero, OnLaneFreed, lane->mOrchestrator) != CHIP_NO_ERROR)
+    {
+        ChipLogError(Controller, "Failed to schedule the next device to commission");
+    }
+}
+
+void CommissioningOrchestrator::Lane::OnPairingComplete(CHIP_ERROR error)
+{
+    // Commissioning does not start when PASE fails, so there will be no OnCommissioningComplete.
+    if (error != CHIP_NO_ERROR)
+    {
+        mOrchestrator->OnDeviceDone(*this, error);
+    }
+}
+
+void CommissioningOrchestrator::Lane::OnCommissioningStatusUpdate(PeerId peerId, CommissioningStage stageCompleted,
+                                                                  CHIP_ERROR error)
+{
+    VerifyOrReturn(mBusy);
+
+    // DeviceCommissioner already emits the BEGIN and END metric events of each stage.
+    System::Clock::Milliseconds32 duration = ElapsedSince(mLastStageTime);
+    mOrchestrator->mDelegate->OnStageCompleted(mNodeId, stageCompleted, error, duration);
+}
+
+void CommissioningOrchestrator::Lane::OnCommissioningComplete(NodeId deviceId, CHIP_ERROR error)
+{
+    mOrchestrator->OnDeviceDone(*this, error);
+}
+
+} // namespace Controller
+} // namespace chip
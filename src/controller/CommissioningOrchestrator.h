@@ -0,0 +1,202 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Declaration of the Commissioning Orchestrator, which commissions a
+ *      series of devices with several DeviceCommissioner instances running
+ *      in parallel.
+ *
+ */
+
+#pragma once
+
+#include <controller/CHIPDeviceController.h>
+#include <controller/CommissioningDelegate.h>
+#include <controller/CommissioningWorkPool.h>
+#include <controller/DevicePairingDelegate.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/NodeId.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+namespace Controller {
+
+/**
+ * Commissions devices with several DeviceCommissioner instances, or lanes, each commissioning one
+ * device at a time with its own AutoCommissioner.
+ *
+ * The commissioners are initialized by the application, on the same fabric (see
+ * permitMultiControllerFabrics) and system state, so that they share the sessions, exchanges and
+ * fabric table. Their attestation verifications and NOC chain generations go through bounded pools
+ * in front of a shared DeviceAttestationVerifier and OperationalCredentialsDelegate.
+ *
+ * Devices are obtained from the delegate whenever a lane is free. Commissioning over BLE only runs
+ * on one lane at a time when the platform supports a single BLE connection.
+ */
+class CommissioningOrchestrator
+{
+public:
+    static constexpr uint8_t kMaxLanes = CHIP_CONFIG_CONTROLLER_MAX_COMMISSIONING_LANES;
+
+    struct DeviceToCommission
+    {
+        NodeId nodeId = kUndefinedNodeId;
+        // Either a QR code or manual setup code, which is parsed before GetNextDevice is called again,
+        // or the rendezvous parameters of a device already discovered.
+        const char * setUpCode      = nullptr;
+        DiscoveryType discoveryType = DiscoveryType::kAll;
+        Optional<RendezvousParameters> rendezvousParameters;
+        CommissioningParameters commissioningParameters;
+    };
+
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        /**
+         * Called when a lane is free, to get the next device to commission.
+         *
+         * @return false if there is no device to commission for now; call Start() when there are.
+         */
+        virtual bool GetNextDevice(DeviceToCommission & device) = 0;
+
+        /**
+         * Called for every commissioning stage completed, with the time since the previous stage, or
+         * since the start of the commissioning for the first one.
+         */
+        virtual void OnStageCompleted(NodeId nodeId, CommissioningStage stage, CHIP_ERROR error,
+                                      System::Clock::Milliseconds32 duration)
+        {}
+
+        /**
+         * Called when the commissioning of a device has completed, successfully or not.
+         */
+        virtual void OnDeviceCommissioned(NodeId nodeId, CHIP_ERROR error, System::Clock::Milliseconds32 duration) = 0;
+
+        /**
+         * Called when the devices in progress have all completed and no more will be started, because
+         * GetNextDevice returned false or Pause() was called.
+         */
+        virtual void OnIdle() {}
+    };
+
+    struct InitParams
+    {
+        System::Layer * systemLayer = nullptr;
+        Delegate * delegate         = nullptr;
+        // Shared by the lanes, through pools of at most maxConcurrent{Attestations,NOCChainGenerations}
+        // operations in progress.
+        Credentials::DeviceAttestationVerifier * deviceAttestationVerifier = nullptr;
+        OperationalCredentialsDelegate * operationalCredentialsDelegate    = nullptr;
+        uint8_t maxConcurrentAttestations                                  = 1;
+        uint8_t maxConcurrentNOCChainGenerations                           = 1;
+    };
+
+    virtual ~CommissioningOrchestrator() = default;
+
+    CHIP_ERROR Init(const InitParams & params);
+
+    /**
+     * Withdraws the pending work of the lanes. Devices still in progress, see OnIdle(), must be
+     * stopped on their commissioners beforehand.
+     */
+    void Shutdown();
+
+    /**
+     * Returns the delegate that the commissioner of a lane must be initialized with, in place of the
+     * shared OperationalCredentialsDelegate, so that its NOC chain generations go through the pool.
+     */
+    OperationalCredentialsDelegate * GetOperationalCredentialsDelegate(uint8_t laneIndex);
+
+    /**
+     * Sets the commissioner of a lane, which replaces its pairing delegate and attestation verifier.
+     *
+     * @retval CHIP_ERROR_INVALID_ARGUMENT if the commissioner was not initialized with the operational
+     *                                     credentials delegate of the lane.
+     */
+    CHIP_ERROR SetCommissioner(uint8_t laneIndex, DeviceCommissioner * commissioner);
+
+    /**
+     * Starts commissioning devices on the free lanes, first after the lanes are set, and then e.g.
+     * after GetNextDevice returned false and more devices are available.
+     */
+    void Start();
+
+    /**
+     * Stops starting new devices; the devices in progress complete.
+     */
+    void Pause() { mPaused = true; }
+
+    uint8_t GetActiveLaneCount() const;
+
+protected:
+    /**
+     * Starts commissioning a device on the commissioner of a lane. Virtual so that unit tests can
+     * drive the lanes without running commissioners.
+     */
+    virtual CHIP_ERROR PairDevice(DeviceCommissioner & commissioner, DeviceToCommission & device);
+
+private:
+    class Lane : public DevicePairingDelegate
+    {
+    public:
+        Lane() : mAbandonedOperationDone(OnAbandonedOperationDone, this) {}
+
+        void OnPairingComplete(CHIP_ERROR error) override;
+        void OnCommissioningStatusUpdate(PeerId peerId, CommissioningStage stageCompleted, CHIP_ERROR error) override;
+        void OnCommissioningComplete(NodeId deviceId, CHIP_ERROR error) override;
+
+        // Busy with a device, or waiting for the pooled operations of a failed device to complete.
+        bool IsActive() const { return mBusy || mAbandonedOperations > 0; }
+
+        static void OnAbandonedOperationDone(void * context);
+
+        CommissioningOrchestrator * mOrchestrator = nullptr;
+        DeviceCommissioner * mCommissioner        = nullptr;
+        NodeId mNodeId                            = kUndefinedNodeId;
+        bool mBusy                                = false;
+        uint8_t mAbandonedOperations              = 0;
+        Callback::Callback<> mAbandonedOperationDone;
+        System::Clock::Timestamp mStartTime;
+        System::Clock::Timestamp mLastStageTime;
+        PooledDeviceAttestationVerifier mAttestationVerifier;
+        PooledOperationalCredentialsDelegate mOperationalCredentialsDelegate;
+    };
+
+    static void OnLaneFreed(System::Layer * systemLayer, void * context);
+
+    void FillLanes();
+    // Returns false if the delegate has no more devices.
+    bool StartNextDevice(Lane & lane);
+    void OnDeviceDone(Lane & lane, CHIP_ERROR error);
+
+    System::Layer * mSystemLayer = nullptr;
+    Delegate * mDelegate         = nullptr;
+    CommissioningWorkPool mAttestationPool;
+    CommissioningWorkPool mNOCChainGenerationPool;
+    Lane mLanes[kMaxLanes];
+    bool mPaused       = true;
+    bool mFillingLanes = false;
+};
+
+} // namespace Controller
+} // namespace chip
@@ -0,0 +1,262 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <controller/CommissioningWorkPool.h>
+
+#include <lib/support/CodeUtils.h>
+#include <tracing/metric_event.h>
+
+using namespace chip::Credentials;
+using namespace chip::Tracing;
+
+namespace chip {
+namespace Controller {
+
+#if MATTER_TRACING_ENABLED
+namespace {
+
+uint32_t MillisecondsSince(System::Clock::Timestamp since)
+{
+    auto elapsed = System::SystemClock().GetMonotonicTimestamp() - since;
+    return static_cast<uint32_t>(std::chrono::duration_cast<System::Clock::Milliseconds32>(elapsed).count());
+}
+
+} // namespace
+#endif // MATTER_TRACING_ENABLED
+
+bool CommissioningWorkPool::TryStart(Work * work)
+{
+    if (mInFlight < mMaxInFlight && mPending.IsEmpty())
+    {
+        mInFlight++;
+        return true;
+    }
+
+    mPending.Enqueue(work->Cancel());
+    return false;
+}
+
+void CommissioningWorkPool::Finish()
+{
+    VerifyOrDie(mInFlight > 0);
+    mInFlight--;
+
+    // The started work may finish synchronously and call back in here, which keeps starting the
+    // queued work until the slots are all taken again.
+    while (mInFlight < mMaxInFlight && !mPending.IsEmpty())
+    {
+        Work * work = Work::FromCancelable(mPending.First());
+        work->Cancel();
+        mInFlight++;
+        work->mCall(work->mContext);
+    }
+}
+
+PooledDeviceAttestationVerifier::PooledDeviceAttestationVerifier() :
+    mStartWork(OnStart, this), mVerificationCallback(OnVerificationComplete, this)
+{}
+
+void PooledDeviceAttestationVerifier::Init(DeviceAttestationVerifier * verifier, CommissioningWorkPool * pool)
+{
+    mVerifier = verifier;
+    mPool     = pool;
+}
+
+void PooledDeviceAttestationVerifier::VerifyAttestationInformation(
+    const AttestationInfo & info, Callback::Callback<OnAttestationInformationVerification> * onCompletion)
+{
+    VerifyOrDie(mVerifier != nullptr && mPool != nullptr);
+
+    mAttestationElements  = info.attestationElementsBuffer;
+    mAttestationChallenge = info.attestationChallengeBuffer;
+    mAttestationSignature = info.attestationSignatureBuffer;
+    mPaiDer               = info.paiDerBuffer;
+    mDacDer               = info.dacDerBuffer;
+    mAttestationNonce     = info.attestationNonceBuffer;
+    mVendorId             = info.vendorId;
+    mProductId            = info.productId;
+    mOnCompletion         = onCompletion;
+    mQueuedAt             = System::SystemClock().GetMonotonicTimestamp();
+
+    if (mPool->TryStart(&mStartWork))
+    {
+        Start();
+    }
+}
+
+bool PooledDeviceAttestationVerifier::Abandon(Callback::Callback<> * onDone)
+{
+    mStartWork.Cancel();
+    mOnCompletion = nullptr;
+    VerifyOrReturnValue(mInfo.HasValue(), false);
+
+    mOnAbandonedDone = onDone;
+    return true;
+}
+
+void PooledDeviceAttestationVerifier::OnStart(void * context)
+{
+    auto * self = static_cast<PooledDeviceAttestationVerifier *>(context);
+    MATTER_LOG_METRIC(kMetricCommissioningAttestationQueueWait, MillisecondsSince(self->mQueuedAt));
+    self->Start();
+}
+
+void PooledDeviceAttestationVerifier::Start()
+{
+    mInfo.Emplace(mAttestationElements, mAttestationChallenge, mAttestationSignature, mPaiDer, mDacDer, mAttestationNonce,
+                  mVendorId, mProductId);
+    mVerifier->VerifyAttestationInformation(mInfo.Value(), &mVerificationCallback);
+}
+
+void PooledDeviceAttestationVerifier::OnVerificationComplete(void * context, const AttestationInfo & info,
+                                                             AttestationVerificationResult result)
+{
+    auto * self            = static_cast<PooledDeviceAttestationVerifier *>(context);
+    auto * pool            = self->mPool;
+    auto * onCompletion    = self->mOnCompletion;
+    auto * onAbandonedDone = self->mOnAbandonedDone;
+    self->mOnCompletion    = nullptr;
+    self->mOnAbandonedDone = nullptr;
+
+    // Report the result before starting the verification of another commissioner, which only
+    // delays the one that just completed. The commissioner does not start another verification
+    // from its callback, and info stays valid until the slot is released.
+    if (onCompletion != nullptr)
+    {
+        onCompletion->mCall(onCompletion->mContext, info, result);
+    }
+    self->mInfo.ClearValue();
+    pool->Finish();
+
+    if (onAbandonedDone != nullptr)
+    {
+        onAbandonedDone->mCall(onAbandonedDone->mContext);
+    }
+}
+
+PooledOperationalCredentialsDelegate::PooledOperationalCredentialsDelegate() :
+    mStartWork(OnStart, this), mNOCChainCallback(OnNOCChainGenerated, this)
+{}
+
+void PooledOperationalCredentialsDelegate::Init(OperationalCredentialsDelegate * delegate, CommissioningWorkPool * pool)
+{
+    mDelegate = delegate;
+    mPool     = pool;
+}
+
+CHIP_ERROR PooledOperationalCredentialsDelegate::GenerateNOCChain(const ByteSpan & csrElements, const ByteSpan & csrNonce,
+                                                                  const ByteSpan & attestationSignature,
+                                                                  const ByteSpan & attestationChallenge, const ByteSpan & DAC,
+                                                                  const ByteSpan & PAI,
+                                                                  Callback::Callback<OnNOCChainGeneration> * onCompletion)
+{
+    VerifyOrReturnError(mDelegate != nullptr && mPool != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    mCsrElements          = csrElements;
+    mCsrNonce             = csrNonce;
+    mAttestationSignature = attestationSignature;
+    mAttestationChallenge = attestationChallenge;
+    mDAC                  = DAC;
+    mPAI                  = PAI;
+    mOnCompletion         = onCompletion;
+    mQueuedAt             = System::SystemClock().GetMonotonicTimestamp();
+
+    VerifyOrReturnError(mPool->TryStart(&mStartWork), CHIP_NO_ERROR);
+
+    // Started right away: failures to start are returned as they would be without the pool.
+    CHIP_ERROR err = Start();
+    if (err != CHIP_NO_ERROR)
+    {
+        mOnCompletion = nullptr;
+        mPool->Finish();
+    }
+    return err;
+}
+
+bool PooledOperationalCredentialsDelegate::Abandon(Callback::Callback<> * onDone)
+{
+    mStartWork.Cancel();
+    mOnCompletion = nullptr;
+    VerifyOrReturnValue(mInProgress, false);
+
+    mOnAbandonedDone = onDone;
+    return true;
+}
+
+void PooledOperationalCredentialsDelegate::OnStart(void * context)
+{
+    auto * self = static_cast<PooledOperationalCredentialsDelegate *>(context);
+    MATTER_LOG_METRIC(kMetricCommissioningNOCQueueWait, MillisecondsSince(self->mQueuedAt));
+
+    CHIP_ERROR err = self->Start();
+    if (err != CHIP_NO_ERROR)
+    {
+        // The commissioner was told that the generation started, so the failure goes to its callback.
+        OnNOCChainGenerated(self, err, ByteSpan(), ByteSpan(), ByteSpan(), NullOptional, NullOptional);
+    }
+}
+
+CHIP_ERROR PooledOperationalCredentialsDelegate::Start()
+{
+    if (mNodeId.HasValue())
+    {
+        mDelegate->SetNodeIdForNextNOCRequest(mNodeId.Value());
+    }
+    if (mFabricId.HasValue())
+    {
+        mDelegate->SetFabricIdForNextNOCRequest(mFabricId.Value());
+    }
+
+    // The delegate may also complete synchronously.
+    mInProgress    = true;
+    CHIP_ERROR err = mDelegate->GenerateNOCChain(mCsrElements, mCsrNonce, mAttestationSignature, mAttestationChallenge, mDAC,
+                                                 mPAI, &mNOCChainCallback);
+    if (err != CHIP_NO_ERROR)
+    {
+        mInProgress = false;
+    }
+    return err;
+}
+
+void PooledOperationalCredentialsDelegate::OnNOCChainGenerated(void * context, CHIP_ERROR status, const ByteSpan & noc,
+                                                               const ByteSpan & icac, const ByteSpan & rcac,
+                                                               Optional<Crypto::IdentityProtectionKeySpan> ipk,
+                                                               Optional<NodeId> adminSubject)
+{
+    auto * self            = static_cast<PooledOperationalCredentialsDelegate *>(context);
+    auto * pool            = self->mPool;
+    auto * onCompletion    = self->mOnCompletion;
+    auto * onAbandonedDone = self->mOnAbandonedDone;
+    self->mOnCompletion    = nullptr;
+    self->mOnAbandonedDone = nullptr;
+    self->mInProgress      = false;
+
+    if (onCompletion != nullptr)
+    {
+        onCompletion->mCall(onCompletion->mContext, status, noc, icac, rcac, ipk, adminSubject);
+    }
+    pool->Finish();
+
+    if (onAbandonedDone != nullptr)
+    {
+        onAbandonedDone->mCall(onAbandonedDone->mContext);
+    }
+}
+
+} // namespace Controller
+} // namespace chip
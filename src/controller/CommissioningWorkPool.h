@@ -0,0 +1,232 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Bounded pools for the attestation verifications and NOC chain generations
+ *      of several DeviceCommissioner instances commissioning in parallel.
+ *
+ */
+
+#pragma once
+
+#include <controller/OperationalCredentialsDelegate.h>
+#include <credentials/attestation_verifier/DeviceAttestationVerifier.h>
+#include <lib/core/CHIPCallback.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/Optional.h>
+#include <system/SystemClock.h>
+
+namespace chip {
+namespace Controller {
+
+/**
+ * Limits the number of asynchronous operations running at the same time, and starts the others in
+ * order as the running ones finish.
+ *
+ * The operations are already asynchronous, and all run on the CHIP thread: the pool does not own any
+ * thread, it only defers the start of an operation until one of its slots is free.
+ */
+class CommissioningWorkPool
+{
+public:
+    using Work = Callback::Callback<>;
+
+    CommissioningWorkPool(uint8_t maxInFlight = 1) : mMaxInFlight(maxInFlight) {}
+
+    void SetMaxInFlight(uint8_t maxInFlight) { mMaxInFlight = maxInFlight; }
+    uint8_t GetMaxInFlight() const { return mMaxInFlight; }
+    uint8_t GetInFlightCount() const { return mInFlight; }
+    bool HasPendingWork() { return !mPending.IsEmpty(); }
+
+    /**
+     * Takes a slot for work that can start immediately, or queues it.
+     *
+     * @return true if the caller holds a slot and must start the work itself; false if the work was
+     *         queued, in which case it is called, holding a slot, once one is free. Queued work can be
+     *         withdrawn with work->Cancel().
+     */
+    bool TryStart(Work * work);
+
+    /**
+     * Frees the slot of work that has finished, and starts queued work.
+     */
+    void Finish();
+
+private:
+    Callback::CallbackDeque mPending;
+    uint8_t mMaxInFlight;
+    uint8_t mInFlight = 0;
+};
+
+/**
+ * DeviceAttestationVerifier of one DeviceCommissioner that runs the attestation information
+ * verifications of a shared verifier through a CommissioningWorkPool. The other checks are
+ * forwarded as is.
+ *
+ * A commissioner has at most one verification in progress, so that a queued verification only
+ * needs to keep references to the buffers of its AttestationInfo: DeviceCommissioner keeps them
+ * until the verification completes.
+ */
+class PooledDeviceAttestationVerifier : public Credentials::DeviceAttestationVerifier
+{
+public:
+    PooledDeviceAttestationVerifier();
+
+    void Init(Credentials::DeviceAttestationVerifier * verifier, CommissioningWorkPool * pool);
+
+    /**
+     * Withdraws a verification still waiting for a slot, and drops the result of one in progress: the
+     * completion callback of the request is not called.
+     *
+     * @return true if a verification is still in progress, in which case onDone is called once it has
+     *         completed; no other verification can be started until then.
+     */
+    bool Abandon(Callback::Callback<> * onDone);
+
+    void VerifyAttestationInformation(const AttestationInfo & info,
+                                      Callback::Callback<OnAttestationInformationVerification> * onCompletion) override;
+
+    Credentials::AttestationVerificationResult ValidateCertificationDeclarationSignature(const ByteSpan & cmsEnvelopeBuffer,
+                                                                                         ByteSpan & certDeclBuffer) override
+    {
+        return mVerifier->ValidateCertificationDeclarationSignature(cmsEnvelopeBuffer, certDeclBuffer);
+    }
+
+    Credentials::AttestationVerificationResult
+    ValidateCertificateDeclarationPayload(const ByteSpan & certDeclBuffer, const ByteSpan & firmwareInfo,
+                                          const Credentials::DeviceInfoForAttestation & deviceInfo) override
+    {
+        return mVerifier->ValidateCertificateDeclarationPayload(certDeclBuffer, firmwareInfo, deviceInfo);
+    }
+
+    CHIP_ERROR VerifyNodeOperationalCSRInformation(const ByteSpan & nocsrElementsBuffer,
+                                                   const ByteSpan & attestationChallengeBuffer,
+                                                   const ByteSpan & attestationSignatureBuffer,
+                                                   const Crypto::P256PublicKey & dacPublicKey, const ByteSpan & csrNonce) override
+    {
+        return mVerifier->VerifyNodeOperationalCSRInformation(nocsrElementsBuffer, attestationChallengeBuffer,
+                                                              attestationSignatureBuffer, dacPublicKey, csrNonce);
+    }
+
+    void CheckForRevokedDACChain(const AttestationInfo & info,
+                                 Callback::Callback<OnAttestationInformationVerification> * onCompletion) override
+    {
+        mVerifier->CheckForRevokedDACChain(info, onCompletion);
+    }
+
+    Credentials::WellKnownKeysTrustStore * GetCertificationDeclarationTrustStore() override
+    {
+        return mVerifier->GetCertificationDeclarationTrustStore();
+    }
+
+private:
+    static void OnStart(void * context);
+    static void OnVerificationComplete(void * context, const AttestationInfo & info,
+                                       Credentials::AttestationVerificationResult result);
+
+    void Start();
+
+    Credentials::DeviceAttestationVerifier * mVerifier = nullptr;
+    CommissioningWorkPool * mPool                      = nullptr;
+
+    // Request waiting for a slot, or in progress.
+    ByteSpan mAttestationElements;
+    ByteSpan mAttestationChallenge;
+    ByteSpan mAttestationSignature;
+    ByteSpan mPaiDer;
+    ByteSpan mDacDer;
+    ByteSpan mAttestationNonce;
+    VendorId mVendorId  = VendorId::NotSpecified;
+    uint16_t mProductId = 0;
+    // Only set while the verification is in progress.
+    Optional<AttestationInfo> mInfo;
+    Callback::Callback<OnAttestationInformationVerification> * mOnCompletion = nullptr;
+    Callback::Callback<> * mOnAbandonedDone                                  = nullptr;
+    System::Clock::Timestamp mQueuedAt;
+
+    CommissioningWorkPool::Work mStartWork;
+    Callback::Callback<OnAttestationInformationVerification> mVerificationCallback;
+};
+
+/**
+ * OperationalCredentialsDelegate of one DeviceCommissioner that runs the NOC chain generations of
+ * a shared delegate through a CommissioningWorkPool.
+ *
+ * The node ID and fabric ID hints of the commissioner are kept with its request and passed to the
+ * shared delegate just before the request starts, so that the requests of other commissioners do
+ * not overwrite them. As for attestation, the buffers of a queued request are those of the
+ * commissioner, which keeps them until the generation completes.
+ */
+class PooledOperationalCredentialsDelegate : public OperationalCredentialsDelegate
+{
+public:
+    PooledOperationalCredentialsDelegate();
+
+    void Init(OperationalCredentialsDelegate * delegate, CommissioningWorkPool * pool);
+
+    /**
+     * Withdraws a generation still waiting for a slot, and drops the result of one in progress: the
+     * completion callback of the request is not called.
+     *
+     * @return true if a generation is still in progress, in which case onDone is called once it has
+     *         completed; no other generation can be started until then.
+     */
+    bool Abandon(Callback::Callback<> * onDone);
+
+    CHIP_ERROR GenerateNOCChain(const ByteSpan & csrElements, const ByteSpan & csrNonce, const ByteSpan & attestationSignature,
+                                const ByteSpan & attestationChallenge, const ByteSpan & DAC, const ByteSpan & PAI,
+                                Callback::Callback<OnNOCChainGeneration> * onCompletion) override;
+
+    void SetNodeIdForNextNOCRequest(NodeId nodeId) override { mNodeId.SetValue(nodeId); }
+    void SetFabricIdForNextNOCRequest(FabricId fabricId) override { mFabricId.SetValue(fabricId); }
+
+    CHIP_ERROR ObtainCsrNonce(MutableByteSpan & csrNonce) override { return mDelegate->ObtainCsrNonce(csrNonce); }
+
+private:
+    static void OnStart(void * context);
+    static void OnNOCChainGenerated(void * context, CHIP_ERROR status, const ByteSpan & noc, const ByteSpan & icac,
+                                    const ByteSpan & rcac, Optional<Crypto::IdentityProtectionKeySpan> ipk,
+                                    Optional<NodeId> adminSubject);
+
+    CHIP_ERROR Start();
+
+    OperationalCredentialsDelegate * mDelegate = nullptr;
+    CommissioningWorkPool * mPool              = nullptr;
+
+    Optional<NodeId> mNodeId;
+    Optional<FabricId> mFabricId;
+
+    // Request waiting for a slot, or in progress.
+    ByteSpan mCsrElements;
+    ByteSpan mCsrNonce;
+    ByteSpan mAttestationSignature;
+    ByteSpan mAttestationChallenge;
+    ByteSpan mDAC;
+    ByteSpan mPAI;
+    bool mInProgress                                         = false;
+    Callback::Callback<OnNOCChainGeneration> * mOnCompletion = nullptr;
+    Callback::Callback<> * mOnAbandonedDone                  = nullptr;
+    System::Clock::Timestamp mQueuedAt;
+
+    CommissioningWorkPool::Work mStartWork;
+    Callback::Callback<OnNOCChainGeneration> mNOCChainCallback;
+};
+
+} // namespace Controller
+} // namespace chip
@@ -23,6 +23,7 @@ import ctypes
 import inspect
 import logging
 import sys
+import threading
 from asyncio.futures import Future
 from ctypes import CFUNCTYPE, POINTER, c_size_t, c_uint8, c_uint16, c_uint32, c_uint64, c_void_p, cast, py_object
 from dataclasses import dataclass, field
@@ -312,6 +313,10 @@ class AttributeCache:
         TLV data (or ValueDecodeFailure in the case of IM status codes) are stored for each attribute in
         attributeTLVCache[endpoint][cluster][attribute].
 
+        Both TLV and cluster object formats are produced lazily: reports only store the raw TLV of the
+        attributes they change, which gets decoded the first time either format is accessed. An attribute
+        that changes in several reports before that is only decoded once.
+
         Upon completion of data population, it can be retrieved in a more friendly cluster object format,
         with two options available. In both options, data is in the dictionary is key'ed not by the raw numeric
         cluster and attribute IDs, but instead by the cluster object descriptor types for each of those generated
@@ -323,39 +328,83 @@ class AttributeCache:
         This strongly typed keys permit a more natural and safer form of indexing.
     '''
     returnClusterObject: bool = False
-    attributeTLVCache: Dict[int, Dict[int, Dict[int, bytes]]] = field(
+    _attributeTLVCache: Dict[int, Dict[int, Dict[int, Any]]] = field(
         default_factory=lambda: {})
-    attributeCache: Dict[int, List[Cluster]] = field(
+    _attributeCache: Dict[int, List[Cluster]] = field(
         default_factory=lambda: {})
     versionList: Dict[int, Dict[int, Dict[int, int]]] = field(
         default_factory=lambda: {})
+    # Raw TLV of the attributes updated since the TLV format was last accessed.
+    _pendingTLV: Dict[AttributePath, bytes] = field(
+        default_factory=lambda: {})
+    # Paths changed since the cluster object format was last accessed.
+    _pendingPathSet: set[AttributePath] = field(
+        default_factory=lambda: set())
+    # Reports are handled by the CHIP thread, while the formats can be accessed from any thread.
+    _lock: threading.RLock = field(
+        default_factory=lambda: threading.RLock(), repr=False, compare=False)
+
+    @property
+    def attributeTLVCache(self) -> Dict[int, Dict[int, Dict[int, Any]]]:
+        with self._lock:
+            self._DecodePendingTLV()
+            return self._attributeTLVCache
+
+    @property
+    def attributeCache(self) -> Dict[int, List[Cluster]]:
+        with self._lock:
+            self._DecodePendingTLV()
+            self._BuildPendingCachedData()
+            return self._attributeCache
 
     def UpdateTLV(self, path: AttributePath, dataVersion: int,  data: Union[bytes, ValueDecodeFailure]):
         ''' Store data in TLV since that makes it easiest to eventually convert to either the
             cluster or attribute view representations (see below in UpdateCachedData).
-        '''
-        if (path.EndpointId not in self.attributeTLVCache):
-            self.attributeTLVCache[path.EndpointId] = {}
-
-        if (path.EndpointId not in self.versionList):
-            self.versionList[path.EndpointId] = {}
-
-        endpointCache = self.attributeTLVCache[path.EndpointId]
-        endpointVersion = self.versionList[path.EndpointId]
-        if (path.ClusterId not in endpointCache):
-            endpointCache[path.ClusterId] = {}
 
-        # All attributes from the same cluster instance should have the same dataVersion,
-        # so we can set the dataVersion of the cluster to the dataVersion with a random attribute.
-        endpointVersion[path.ClusterId] = dataVersion
-
-        clusterCache = endpointCache[path.ClusterId]
-        if (path.AttributeId not in clusterCache):
-            clusterCache[path.AttributeId] = None
+            Raw TLV bytes are only decoded once the data is accessed.
+        '''
+        with self._lock:
+            if (path.EndpointId not in self._attributeTLVCache):
+                self._attributeTLVCache[path.EndpointId] = {}
+
+            if (path.EndpointId not in self.versionList):
+                self.versionList[path.EndpointId] = {}
+
+            endpointCache = self._attributeTLVCache[path.EndpointId]
+            endpointVersion = self.versionList[path.EndpointId]
+            if (path.ClusterId not in endpointCache):
+                endpointCache[path.ClusterId] = {}
+
+            # All attributes from the same cluster instance should have the same dataVersion,
+            # so we can set the dataVersion of the cluster to the dataVersion with a random attribute.
+            endpointVersion[path.ClusterId] = dataVersion
+
+            clusterCache = endpointCache[path.ClusterId]
+            if isinstance(data, ValueDecodeFailure):
+                self._pendingTLV.pop(path, None)
+                clusterCache[path.AttributeId] = data
+            else:
+                # Keeps the position of the attribute in the cluster until it gets decoded.
+                clusterCache.setdefault(path.AttributeId, None)
+                self._pendingTLV[path] = data
 
-        clusterCache[path.AttributeId] = data
+    def _DecodePendingTLV(self):
+        for path, data in self._pendingTLV.items():
+            try:
+                value = chip.tlv.TLVReader(data).get().get("Any", {})
+            except Exception as ex:
+                logging.exception(ex)
+                value = ValueDecodeFailure(None, ex)
+            self._attributeTLVCache[path.EndpointId][path.ClusterId][path.AttributeId] = value
+        self._pendingTLV = {}
 
     def UpdateCachedData(self, changedPathSet: set[AttributePath]):
+        ''' Marks the given paths as changed, for their cluster object format to be built the next time it is accessed.
+        '''
+        with self._lock:
+            self._pendingPathSet.update(changedPathSet)
+
+    def _BuildPendingCachedData(self):
         ''' This converts the raw TLV data into a cluster object format.
 
             Two formats are available:
@@ -377,14 +426,14 @@ class AttributeCache:
         def handle_cluster_view(endpointId, clusterId, clusterType):
             try:
                 decodedData = clusterType.FromDict(
-                    data=clusterType.descriptor.TagDictToLabelDict([], self.attributeTLVCache[endpointId][clusterId]))
+                    data=clusterType.descriptor.TagDictToLabelDict([], self._attributeTLVCache[endpointId][clusterId]))
                 decodedData.SetDataVersion(self.versionList.get(endpointId, {}).get(clusterId))
                 return decodedData
             except Exception as ex:
-                return ValueDecodeFailure(self.attributeTLVCache[endpointId][clusterId], ex)
+                return ValueDecodeFailure(self._attributeTLVCache[endpointId][clusterId], ex)
 
         def handle_attribute_view(endpointId, clusterId, attributeId, attributeType):
-            value = self.attributeTLVCache[endpointId][clusterId][attributeId]
+            value = self._attributeTLVCache[endpointId][clusterId][attributeId]
             if isinstance(value, ValueDecodeFailure):
                 return value
             try:
@@ -392,12 +441,15 @@ class AttributeCache:
             except Exception as ex:
                 return ValueDecodeFailure(value, ex)
 
-        for attributePath in changedPathSet:
+        # A cluster object covers all the attributes of its cluster: only build it once.
+        builtClusters = set()
+
+        for attributePath in self._pendingPathSet:
             endpointId, clusterId, attributeId = attributePath.EndpointId, attributePath.ClusterId, attributePath.AttributeId
 
-            if endpointId not in self.attributeCache:
-                self.attributeCache[endpointId] = {}
-            endpointCache = self.attributeCache[endpointId]
+            if endpointId not in self._attributeCache:
+                self._attributeCache[endpointId] = {}
+            endpointCache = self._attributeCache[endpointId]
 
             if clusterId not in _ClusterIndex:
                 #
@@ -409,7 +461,9 @@ class AttributeCache:
             clusterType = _ClusterIndex[clusterId]
 
             if self.returnClusterObject:
-                endpointCache[clusterType] = handle_cluster_view(endpointId, clusterId, clusterType)
+                if (endpointId, clusterId) not in builtClusters:
+                    endpointCache[clusterType] = handle_cluster_view(endpointId, clusterId, clusterType)
+                    builtClusters.add((endpointId, clusterId))
             else:
                 if clusterType not in endpointCache:
                     endpointCache[clusterType] = {}
@@ -426,6 +480,8 @@ class AttributeCache:
                 attributeType = _AttributeIndex[(clusterId, attributeId)][0]
                 clusterCache[attributeType] = handle_attribute_view(endpointId, clusterId, attributeId, attributeType)
 
+        self._pendingPathSet = set()
+
 
 class SubscriptionTransaction:
     def __init__(self, transaction: AsyncReadTransaction, subscriptionId, devCtrl):
@@ -668,8 +724,8 @@ class AsyncReadTransaction:
                 attributeValue = ValueDecodeFailure(
                     None, chip.interaction_model.InteractionModelError(imStatus))
             else:
-                tlvData = chip.tlv.TLVReader(data).get().get("Any", {})
-                attributeValue = tlvData
+                # Decoded by the cache, once accessed.
+                attributeValue = data
 
             self._cache.UpdateTLV(path, dataVersion, attributeValue)
             self._changedPathSet.add(path)
@@ -677,6 +733,12 @@ class AsyncReadTransaction:
         except Exception as ex:
             logging.exception(ex)
 
+    def handleAttributeDataBatch(self, entries, data: bytes):
+        for entry in entries:
+            path = AttributePath(EndpointId=entry.endpointId, ClusterId=entry.clusterId, AttributeId=entry.attributeId)
+            self.handleAttributeData(path, entry.dataVersion, entry.imStatus,
+                                     data[entry.dataOffset:entry.dataOffset + entry.dataLength])
+
     def handleEventData(self, header: EventHeader, path: EventPath, data: bytes, status: int):
         try:
             eventType = _EventIndex.get(str(path), None)
@@ -847,8 +909,29 @@ class AsyncWriteTransaction:
         self._event_loop.call_soon_threadsafe(self._handleDone)
 
 
+class AttributeReportEntry(ctypes.Structure):
+    ''' Index entry of the attribute data of a report, that has a c++ counterpart for CFFI.
+
+    ```c
+    struct __attribute__((packed)) AttributeReportEntry
+    {
+        chip::EndpointId endpointId;
+        chip::ClusterId clusterId;
+        chip::AttributeId attributeId;
+        chip::DataVersion dataVersion;
+        uint32_t dataOffset;
+        uint32_t dataLength;
+        uint8_t imStatus;
+    };
+    ```
+    '''
+    _pack_ = 1
+    _fields_ = [('endpointId', c_uint16), ('clusterId', c_uint32), ('attributeId', c_uint32), ('dataVersion', c_uint32),
+                ('dataOffset', c_uint32), ('dataLength', c_uint32), ('imStatus', c_uint8)]
+
+
 _OnReadAttributeDataCallbackFunct = CFUNCTYPE(
-    None, py_object, c_uint32, c_uint16, c_uint32, c_uint32, c_uint8, c_void_p, c_size_t)
+    None, py_object, c_void_p, c_size_t, c_void_p, c_size_t)
 _OnSubscriptionEstablishedCallbackFunct = CFUNCTYPE(None, py_object, c_uint32)
 _OnResubscriptionAttemptedCallbackFunct = CFUNCTYPE(None, py_object, PyChipError, c_uint32)
 _OnReadEventDataCallbackFunct = CFUNCTYPE(
@@ -864,10 +947,11 @@ _OnReportEndCallbackFunct = CFUNCTYPE(
 
 
 @_OnReadAttributeDataCallbackFunct
-def _OnReadAttributeDataCallback(closure, dataVersion: int, endpoint: int, cluster: int, attribute: int, status, data, len):
+def _OnReadAttributeDataCallback(closure, entries, entryCount: int, data, len):
+    # The entries are only valid for the duration of the callback.
+    entryArray = cast(entries, POINTER(AttributeReportEntry * entryCount)).contents
     dataBytes = ctypes.string_at(data, len)
-    closure.handleAttributeData(AttributePath(
-        EndpointId=endpoint, ClusterId=cluster, AttributeId=attribute), dataVersion, status, dataBytes[:])
+    closure.handleAttributeDataBatch(entryArray, dataBytes)
 
 
 @_OnReadEventDataCallbackFunct
@@ -19,6 +19,7 @@
 #include <cstdarg>
 #include <memory>
 #include <type_traits>
+#include <vector>
 
 #include <app/BufferedReadCallback.h>
 #include <app/ChunkedWriteCallback.h>
@@ -68,10 +69,21 @@ struct __attribute__((packed)) DataVersionFilter
     chip::DataVersion dataVersion;
 };
 
-using OnReadAttributeDataCallback       = void (*)(PyObject * appContext, chip::DataVersion version, chip::EndpointId endpointId,
-                                             chip::ClusterId clusterId, chip::AttributeId attributeId,
-                                             std::underlying_type_t<Protocols::InteractionModel::Status> imstatus, uint8_t * data,
-                                             size_t dataLen);
+// This needs to match the python definition that uses the same name.
+struct __attribute__((packed)) AttributeReportEntry
+{
+    chip::EndpointId endpointId;
+    chip::ClusterId clusterId;
+    chip::AttributeId attributeId;
+    chip::DataVersion dataVersion;
+    // Location of the attribute TLV in the report data, empty when the status is not Success.
+    uint32_t dataOffset;
+    uint32_t dataLength;
+    std::underlying_type_t<Protocols::InteractionModel::Status> imStatus;
+};
+
+using OnReadAttributeDataCallback       = void (*)(PyObject * appContext, AttributeReportEntry * entries, size_t entryCount,
+                                             uint8_t * data, size_t dataLen);
 using OnReadEventDataCallback           = void (*)(PyObject * appContext, chip::EndpointId endpointId, chip::ClusterId clusterId,
                                          chip::EventId eventId, chip::EventNumber eventNumber, uint8_t priority, uint64_t timestamp,
                                          uint8_t timestampType, uint8_t * data, size_t dataLen,
@@ -112,35 +124,41 @@ public:
         // callback. If we do, that's a bug.
         //
         VerifyOrDie(!aPath.IsListItemOperation());
-        size_t bufferLen                  = (apData == nullptr ? 0 : apData->GetRemainingLength() + apData->GetLengthRead());
-        std::unique_ptr<uint8_t[]> buffer = std::unique_ptr<uint8_t[]>(apData == nullptr ? nullptr : new uint8_t[bufferLen]);
-        size_t size                       = 0;
+
+        // Attribute data is accumulated for the whole report, and handed to Python in one go once the report ends: crossing
+        // into Python for each attribute is what makes priming a wildcard subscription slow.
+        AttributeReportEntry entry = {};
+        entry.endpointId           = aPath.mEndpointId;
+        entry.clusterId            = aPath.mClusterId;
+        entry.attributeId          = aPath.mAttributeId;
+        entry.dataVersion          = aPath.mDataVersion.ValueOr(0);
+        entry.imStatus             = to_underlying(aStatus.mStatus);
+        entry.dataOffset           = static_cast<uint32_t>(mReportData.size());
+
         // When the apData is nullptr, means we did not receive a valid attribute data from server, status will be some error
         // status.
         if (apData != nullptr)
         {
+            uint32_t maxLength = apData->GetRemainingLength() + apData->GetLengthRead();
+            mReportData.resize(entry.dataOffset + maxLength);
+
             // The TLVReader's read head is not pointing to the first element in the container instead of the container itself, use
             // a TLVWriter to get a TLV with a normalized TLV buffer (Wrapped with a anonymous tag, no extra "end of container" tag
             // at the end.)
             TLV::TLVWriter writer;
-            writer.Init(buffer.get(), bufferLen);
+            writer.Init(mReportData.data() + entry.dataOffset, maxLength);
             CHIP_ERROR err = writer.CopyElement(TLV::AnonymousTag(), *apData);
             if (err != CHIP_NO_ERROR)
             {
+                mReportData.resize(entry.dataOffset);
                 this->OnError(err);
                 return;
             }
-            size = writer.GetLengthWritten();
+            entry.dataLength = writer.GetLengthWritten();
+            mReportData.resize(entry.dataOffset + entry.dataLength);
         }
 
-        DataVersion version = 0;
-        if (aPath.mDataVersion.HasValue())
-        {
-            version = aPath.mDataVersion.Value();
-        }
-
-        gOnReadAttributeDataCallback(mAppContext, version, aPath.mEndpointId, aPath.mClusterId, aPath.mAttributeId,
-                                     to_underlying(aStatus.mStatus), buffer.get(), size);
+        mReportEntries.push_back(entry);
     }
 
     void OnSubscriptionEstablished(SubscriptionId aSubscriptionId) override
@@ -223,10 +241,16 @@ public:
         }
     }
 
-    void OnReportEnd() override { gOnReportEndCallback(mAppContext); }
+    void OnReportEnd() override
+    {
+        DeliverAttributeData();
+        gOnReportEndCallback(mAppContext);
+    }
 
     void OnDone(ReadClient *) override
     {
+        // Attribute data of a report that did not complete is still delivered, as it used to be before the end of the report.
+        DeliverAttributeData();
         gOnReadDoneCallback(mAppContext);
 
         delete this;
@@ -237,10 +261,25 @@ public:
     void SetAutoResubscribe(bool autoResubscribe) { mAutoResubscribe = autoResubscribe; }
 
 private:
+    void DeliverAttributeData()
+    {
+        VerifyOrReturn(!mReportEntries.empty());
+
+        gOnReadAttributeDataCallback(mAppContext, mReportEntries.data(), mReportEntries.size(), mReportData.data(),
+                                     mReportData.size());
+
+        // Keep the buffers around: subscriptions reuse them for every report.
+        mReportEntries.clear();
+        mReportData.clear();
+    }
+
     BufferedReadCallback mBufferedReadCallback;
 
     PyObject * mAppContext;
 
+    std::vector<AttributeReportEntry> mReportEntries;
+    std::vector<uint8_t> mReportData;
+
     std::unique_ptr<ReadClient> mReadClient;
     bool mAutoResubscribe = true;
 };
@@ -0,0 +1,173 @@
+#
+#    Copyright (c) 2024 Project CHIP Authors
+#    All rights reserved.
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+import ctypes
+import unittest
+from unittest import mock
+
+import chip.clusters as Clusters
+import chip.interaction_model
+import chip.tlv
+from chip.clusters import Attribute
+from chip.clusters.Attribute import (AsyncReadTransaction, AttributeCache, AttributePath, AttributeReportEntry, DataVersion,
+                                     ValueDecodeFailure)
+from chip.tlv import TLVWriter
+
+'''
+This file contains tests for the attribute cache that read and subscribe reports are accumulated into:
+1. Attribute TLV is only decoded when either format of the cache is accessed, once per path however many reports changed it
+2. Malformed TLV is kept as a ValueDecodeFailure, rather than being dropped
+3. A batch of attribute reports, as delivered by the C++ read callback, ends up in the cluster object format
+'''
+
+kEndpoint = 1
+kOnOffPath = AttributePath(EndpointId=kEndpoint, ClusterId=Clusters.OnOff.id,
+                           AttributeId=Clusters.OnOff.Attributes.OnOff.attribute_id)
+kOnTimePath = AttributePath(EndpointId=kEndpoint, ClusterId=Clusters.OnOff.id,
+                            AttributeId=Clusters.OnOff.Attributes.OnTime.attribute_id)
+# A uint8 element without its value.
+kMalformedTLV = b'\x04'
+
+
+def _encode(value) -> bytes:
+    writer = TLVWriter()
+    writer.put(None, value)
+    return bytes(writer.encoding)
+
+
+class TestAttributeCache(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        # Built by Attribute.Init() along with the native callbacks, which these tests do not need.
+        Attribute._BuildAttributeIndex()
+        Attribute._BuildClusterIndex()
+
+    def _tlvReaderSpy(self):
+        return mock.patch.object(chip.tlv, 'TLVReader', wraps=chip.tlv.TLVReader)
+
+    def test_decode_on_first_access(self):
+        cache = AttributeCache()
+        with self._tlvReaderSpy() as reader:
+            cache.UpdateTLV(kOnOffPath, 1, _encode(True))
+            cache.UpdateCachedData({kOnOffPath})
+            reader.assert_not_called()
+
+            self.assertEqual(cache.attributeTLVCache[kEndpoint][Clusters.OnOff.id][kOnOffPath.AttributeId], True)
+            self.assertEqual(reader.call_count, 1)
+
+            clusterCache = cache.attributeCache[kEndpoint][Clusters.OnOff]
+            self.assertEqual(clusterCache[Clusters.OnOff.Attributes.OnOff], True)
+            self.assertEqual(clusterCache[DataVersion], 1)
+            self.assertEqual(reader.call_count, 1)
+
+    def test_overwritten_pending_path_decoded_once(self):
+        cache = AttributeCache()
+        with self._tlvReaderSpy() as reader:
+            cache.UpdateTLV(kOnOffPath, 1, _encode(True))
+            cache.UpdateTLV(kOnOffPath, 2, _encode(False))
+            cache.UpdateCachedData({kOnOffPath})
+
+            clusterCache = cache.attributeCache[kEndpoint][Clusters.OnOff]
+            self.assertEqual(clusterCache[Clusters.OnOff.Attributes.OnOff], False)
+            self.assertEqual(clusterCache[DataVersion], 2)
+            self.assertEqual(reader.call_count, 1)
+
+    def test_pending_path_replaced_by_status(self):
+        cache = AttributeCache()
+        failure = ValueDecodeFailure(None, chip.interaction_model.InteractionModelError(
+            chip.interaction_model.Status.UnsupportedAttribute))
+        with self._tlvReaderSpy() as reader:
+            cache.UpdateTLV(kOnOffPath, 1, _encode(True))
+            cache.UpdateTLV(kOnOffPath, 1, failure)
+            cache.UpdateCachedData({kOnOffPath})
+
+            self.assertIs(cache.attributeCache[kEndpoint][Clusters.OnOff][Clusters.OnOff.Attributes.OnOff], failure)
+            self.assertIs(cache.attributeTLVCache[kEndpoint][Clusters.OnOff.id][kOnOffPath.AttributeId], failure)
+            reader.assert_not_called()
+
+    def test_decode_failure_kept(self):
+        cache = AttributeCache()
+        with self.assertLogs(level='ERROR'):
+            cache.UpdateTLV(kOnOffPath, 1, kMalformedTLV)
+            cache.UpdateTLV(kOnTimePath, 1, _encode(chip.tlv.uint(5)))
+            cache.UpdateCachedData({kOnOffPath, kOnTimePath})
+            clusterCache = cache.attributeCache[kEndpoint][Clusters.OnOff]
+
+        value = clusterCache[Clusters.OnOff.Attributes.OnOff]
+        self.assertIsInstance(value, ValueDecodeFailure)
+        self.assertIsNone(value.TLVValue)
+        self.assertIsNotNone(value.Reason)
+        self.assertEqual(clusterCache[Clusters.OnOff.Attributes.OnTime], 5)
+
+    def _deliverBatch(self, transaction: AsyncReadTransaction, reports):
+        # Lays out the reports as the C++ read callback does: one entry per attribute, indexing into the report data.
+        data = b''.join(report[3] for report in reports)
+        entries = (AttributeReportEntry * len(reports))()
+        offset = 0
+        for entry, (path, dataVersion, status, tlv) in zip(entries, reports):
+            entry.endpointId = path.EndpointId
+            entry.clusterId = path.ClusterId
+            entry.attributeId = path.AttributeId
+            entry.dataVersion = dataVersion
+            entry.imStatus = status
+            entry.dataOffset = offset
+            entry.dataLength = len(tlv)
+            offset += len(tlv)
+
+        transaction.handleAttributeDataBatch(entries, data)
+        transaction.handleReportEnd()
+
+    def test_update_cached_data_after_batched_report(self):
+        transaction = AsyncReadTransaction(None, None, None, returnClusterObject=False)
+        self._deliverBatch(transaction, [
+            (kOnOffPath, 3, chip.interaction_model.Status.Success, _encode(True)),
+            (kOnTimePath, 3, chip.interaction_model.Status.UnsupportedAttribute, b''),
+        ])
+
+        clusterCache = transaction._cache.attributeCache[kEndpoint][Clusters.OnOff]
+        self.assertEqual(clusterCache[Clusters.OnOff.Attributes.OnOff], True)
+        self.assertEqual(clusterCache[DataVersion], 3)
+        onTime = clusterCache[Clusters.OnOff.Attributes.OnTime]
+        self.assertIsInstance(onTime, ValueDecodeFailure)
+        self.assertEqual(onTime.Reason.status, chip.interaction_model.Status.UnsupportedAttribute)
+
+        # A later report only changes the attributes it carries.
+        self._deliverBatch(transaction, [(kOnTimePath, 4, chip.interaction_model.Status.Success, _encode(chip.tlv.uint(7)))])
+        clusterCache = transaction._cache.attributeCache[kEndpoint][Clusters.OnOff]
+        self.assertEqual(clusterCache[Clusters.OnOff.Attributes.OnOff], True)
+        self.assertEqual(clusterCache[Clusters.OnOff.Attributes.OnTime], 7)
+        self.assertEqual(clusterCache[DataVersion], 4)
+
+    def test_update_cluster_object_after_batched_report(self):
+        transaction = AsyncReadTransaction(None, None, None, returnClusterObject=True)
+        self._deliverBatch(transaction, [
+            (kOnOffPath, 3, chip.interaction_model.Status.Success, _encode(True)),
+            (kOnTimePath, 3, chip.interaction_model.Status.Success, _encode(chip.tlv.uint(7))),
+        ])
+
+        cluster = transaction._cache.attributeCache[kEndpoint][Clusters.OnOff]
+        self.assertEqual(cluster.onOff, True)
+        self.assertEqual(cluster.onTime, 7)
+        self.assertEqual(cluster.data_version, 3)
+
+    def test_report_entry_layout(self):
+        # Packed to match its C++ counterpart in attribute.cpp.
+        self.assertEqual(ctypes.sizeof(AttributeReportEntry), 2 + 4 * 5 + 1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,420 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <controller/CommissioningOrchestrator.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/CHIPMem.h>
+#include <system/SystemLayerImpl.h>
+
+#include <utility>
+#include <vector>
+
+using namespace chip;
+using namespace chip::Controller;
+using namespace chip::Credentials;
+
+namespace {
+
+constexpr uint8_t kLaneCount   = 3;
+constexpr NodeId kFirstNodeId  = 100;
+constexpr NodeId kNoSuchNodeId = kUndefinedNodeId;
+
+static_assert(kLaneCount <= CommissioningOrchestrator::kMaxLanes, "Not enough lanes for the test");
+
+// Keeps the timers until FireTimers() is called, so that the tests decide when the orchestrator gets to run.
+class MockSystemLayer : public System::LayerImpl
+{
+public:
+    CHIP_ERROR StartTimer(System::Clock::Timeout aDelay, System::TimerCompleteCallback aComplete, void * aAppState) override
+    {
+        CancelTimer(aComplete, aAppState);
+        mTimers.emplace_back(aComplete, aAppState);
+        return CHIP_NO_ERROR;
+    }
+
+    void CancelTimer(System::TimerCompleteCallback aComplete, void * aAppState) override
+    {
+        for (auto it = mTimers.begin(); it != mTimers.end(); ++it)
+        {
+            if (it->first == aComplete && it->second == aAppState)
+            {
+                mTimers.erase(it);
+                return;
+            }
+        }
+    }
+
+    void FireTimers()
+    {
+        auto timers = std::move(mTimers);
+        mTimers.clear();
+        for (auto & timer : timers)
+        {
+            timer.first(this, timer.second);
+        }
+    }
+
+    std::vector<std::pair<System::TimerCompleteCallback, void *>> mTimers;
+};
+
+// Keeps the requests pending until Complete() is called, like a delegate signing the NOCs remotely.
+class AsyncOperationalCredentialsDelegate : public OperationalCredentialsDelegate
+{
+public:
+    CHIP_ERROR GenerateNOCChain(const ByteSpan & csrElements, const ByteSpan & csrNonce, const ByteSpan & attestationSignature,
+                                const ByteSpan & attestationChallenge, const ByteSpan & DAC, const ByteSpan & PAI,
+                                Callback::Callback<OnNOCChainGeneration> * onCompletion) override
+    {
+        mRequests.push_back(onCompletion);
+        return CHIP_NO_ERROR;
+    }
+
+    void SetNodeIdForNextNOCRequest(NodeId nodeId) override {}
+    void SetFabricIdForNextNOCRequest(FabricId fabricId) override {}
+
+    void Complete(size_t index)
+    {
+        Callback::Callback<OnNOCChainGeneration> * onCompletion = mRequests[index];
+        onCompletion->mCall(onCompletion->mContext, CHIP_NO_ERROR, ByteSpan(), ByteSpan(), ByteSpan(), NullOptional,
+                            NullOptional);
+    }
+
+    std::vector<Callback::Callback<OnNOCChainGeneration> *> mRequests;
+};
+
+class NullDeviceAttestationVerifier : public DeviceAttestationVerifier
+{
+public:
+    void VerifyAttestationInformation(const AttestationInfo & info,
+                                      Callback::Callback<OnAttestationInformationVerification> * onCompletion) override
+    {}
+
+    AttestationVerificationResult ValidateCertificationDeclarationSignature(const ByteSpan & cmsEnvelopeBuffer,
+                                                                            ByteSpan & certDeclBuffer) override
+    {
+        return AttestationVerificationResult::kNotImplemented;
+    }
+
+    AttestationVerificationResult ValidateCertificateDeclarationPayload(const ByteSpan & certDeclBuffer,
+                                                                        const ByteSpan & firmwareInfo,
+                                                                        const DeviceInfoForAttestation & deviceInfo) override
+    {
+        return AttestationVerificationResult::kNotImplemented;
+    }
+
+    CHIP_ERROR VerifyNodeOperationalCSRInformation(const ByteSpan & nocsrElementsBuffer,
+                                                   const ByteSpan & attestationChallengeBuffer,
+                                                   const ByteSpan & attestationSignatureBuffer,
+                                                   const Crypto::P256PublicKey & dacPublicKey, const ByteSpan & csrNonce) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    void CheckForRevokedDACChain(const AttestationInfo & info,
+                                 Callback::Callback<OnAttestationInformationVerification> * onCompletion) override
+    {}
+};
+
+// A commissioner that is never started: the tests report its progress to the lane through its pairing delegate.
+class TestCommissioner : public DeviceCommissioner
+{
+public:
+    void SetOperationalCredentialsDelegate(OperationalCredentialsDelegate * delegate)
+    {
+        mOperationalCredentialsDelegate = delegate;
+    }
+};
+
+// Records the devices started on the lanes instead of commissioning them.
+class TestOrchestrator : public CommissioningOrchestrator
+{
+public:
+    std::vector<NodeId> mStarted;
+    // Fails to start, without reporting anything to the lane.
+    NodeId mFailToStart = kNoSuchNodeId;
+    // Reports the failure to the lane before returning it, as a commissioner failing to establish PASE right away does.
+    NodeId mFailWhileStarting = kNoSuchNodeId;
+
+protected:
+    CHIP_ERROR PairDevice(DeviceCommissioner & commissioner, DeviceToCommission & device) override
+    {
+        mStarted.push_back(device.nodeId);
+        if (device.nodeId == mFailToStart)
+        {
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
+        if (device.nodeId == mFailWhileStarting)
+        {
+            commissioner.GetPairingDelegate()->OnPairingComplete(CHIP_ERROR_TIMEOUT);
+            return CHIP_ERROR_TIMEOUT;
+        }
+        return CHIP_NO_ERROR;
+    }
+};
+
+class TestDelegate : public CommissioningOrchestrator::Delegate
+{
+public:
+    bool GetNextDevice(CommissioningOrchestrator::DeviceToCommission & device) override
+    {
+        VerifyOrReturnValue(mNextDevice < mDeviceCount, false);
+        device.nodeId    = kFirstNodeId + mNextDevice++;
+        device.setUpCode = "MT:-24J0AFN00KA0648G00";
+        return true;
+    }
+
+    void OnDeviceCommissioned(NodeId nodeId, CHIP_ERROR error, System::Clock::Milliseconds32 duration) override
+    {
+        mResults.emplace_back(nodeId, error);
+    }
+
+    void OnIdle() override { mIdleCount++; }
+
+    size_t mDeviceCount = 0;
+    size_t mNextDevice  = 0;
+    std::vector<std::pair<NodeId, CHIP_ERROR>> mResults;
+    size_t mIdleCount = 0;
+};
+
+// Stands for the NOC chain callback of a DeviceCommissioner.
+struct NOCChainRequester
+{
+    static void OnNOCChainGenerated(void * context, CHIP_ERROR status, const ByteSpan & noc, const ByteSpan & icac,
+                                    const ByteSpan & rcac, Optional<Crypto::IdentityProtectionKeySpan> ipk,
+                                    Optional<NodeId> adminSubject)
+    {
+        static_cast<NOCChainRequester *>(context)->mResults++;
+    }
+
+    NOCChainRequester() : mCallback(OnNOCChainGenerated, this) {}
+
+    Callback::Callback<OnNOCChainGeneration> mCallback;
+    size_t mResults = 0;
+};
+
+class TestCommissioningOrchestrator : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+
+    void SetUp() override
+    {
+        CommissioningOrchestrator::InitParams params;
+        params.systemLayer                    = &mSystemLayer;
+        params.delegate                       = &mDelegate;
+        params.deviceAttestationVerifier      = &mVerifier;
+        params.operationalCredentialsDelegate = &mCredentialsDelegate;
+        ASSERT_EQ(mOrchestrator.Init(params), CHIP_NO_ERROR);
+
+        for (uint8_t i = 0; i < kLaneCount; i++)
+        {
+            mCommissioners[i].SetOperationalCredentialsDelegate(mOrchestrator.GetOperationalCredentialsDelegate(i));
+            ASSERT_EQ(mOrchestrator.SetCommissioner(i, &mCommissioners[i]), CHIP_NO_ERROR);
+        }
+    }
+
+    void TearDown() override { mOrchestrator.Shutdown(); }
+
+    // Completes the commissioning of a device, as its commissioner would.
+    void Complete(NodeId nodeId, CHIP_ERROR error = CHIP_NO_ERROR)
+    {
+        mCommissioners[LaneOf(nodeId)].GetPairingDelegate()->OnCommissioningComplete(nodeId, error);
+    }
+
+    // Devices are started on the first free lane, so the lane of a device follows from the order they were started in.
+    uint8_t LaneOf(NodeId nodeId)
+    {
+        uint8_t lane = 0;
+        for (NodeId started : mOrchestrator.mStarted)
+        {
+            if (started == nodeId)
+            {
+                return mLanes[lane];
+            }
+            lane++;
+        }
+        return kLaneCount;
+    }
+
+    MockSystemLayer mSystemLayer;
+    TestDelegate mDelegate;
+    NullDeviceAttestationVerifier mVerifier;
+    AsyncOperationalCredentialsDelegate mCredentialsDelegate;
+    TestOrchestrator mOrchestrator;
+    TestCommissioner mCommissioners[kLaneCount];
+    // Lane of each started device, in the order of mOrchestrator.mStarted.
+    std::vector<uint8_t> mLanes;
+};
+
+TEST_F(TestCommissioningOrchestrator, FillsLanesAndStartsNextDeviceOnceFreed)
+{
+    mDelegate.mDeviceCount = 5;
+    mOrchestrator.Start();
+    ASSERT_EQ(mOrchestrator.mStarted.size(), 3u);
+    mLanes = { 0, 1, 2 };
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 3u);
+
+    // The next device only starts once the commissioner that completed is done cleaning up.
+    Complete(kFirstNodeId + 1);
+    ASSERT_EQ(mDelegate.mResults.size(), 1u);
+    EXPECT_EQ(mDelegate.mResults[0].first, kFirstNodeId + 1);
+    EXPECT_EQ(mDelegate.mResults[0].second, CHIP_NO_ERROR);
+    EXPECT_EQ(mOrchestrator.mStarted.size(), 3u);
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 2u);
+
+    mSystemLayer.FireTimers();
+    ASSERT_EQ(mOrchestrator.mStarted.size(), 4u);
+    mLanes.push_back(1);
+    EXPECT_EQ(mOrchestrator.mStarted[3], kFirstNodeId + 3);
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 3u);
+
+    Complete(kFirstNodeId, CHIP_ERROR_TIMEOUT);
+    mSystemLayer.FireTimers();
+    ASSERT_EQ(mOrchestrator.mStarted.size(), 5u);
+    mLanes.push_back(0);
+
+    // Out of devices: the lanes drain, then the orchestrator reports that it is idle, once.
+    for (NodeId nodeId : { kFirstNodeId + 2, kFirstNodeId + 3, kFirstNodeId + 4 })
+    {
+        EXPECT_EQ(mDelegate.mIdleCount, 0u);
+        Complete(nodeId);
+        mSystemLayer.FireTimers();
+    }
+    EXPECT_EQ(mOrchestrator.mStarted.size(), 5u);
+    EXPECT_EQ(mDelegate.mResults.size(), 5u);
+    EXPECT_EQ(mDelegate.mResults[1].second, CHIP_ERROR_TIMEOUT);
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 0u);
+    EXPECT_EQ(mDelegate.mIdleCount, 1u);
+}
+
+TEST_F(TestCommissioningOrchestrator, PauseDrainsLanesAndStartResumes)
+{
+    mDelegate.mDeviceCount = 10;
+    mOrchestrator.Start();
+    ASSERT_EQ(mOrchestrator.mStarted.size(), 3u);
+    mLanes = { 0, 1, 2 };
+
+    // The devices in progress complete, but no more are started.
+    mOrchestrator.Pause();
+    Complete(kFirstNodeId);
+    mSystemLayer.FireTimers();
+    EXPECT_EQ(mOrchestrator.mStarted.size(), 3u);
+    EXPECT_EQ(mDelegate.mIdleCount, 0u);
+
+    Complete(kFirstNodeId + 1);
+    Complete(kFirstNodeId + 2);
+    mSystemLayer.FireTimers();
+    EXPECT_EQ(mOrchestrator.mStarted.size(), 3u);
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 0u);
+    EXPECT_EQ(mDelegate.mIdleCount, 1u);
+
+    mOrchestrator.Start();
+    EXPECT_EQ(mOrchestrator.mStarted.size(), 6u);
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 3u);
+    EXPECT_EQ(mDelegate.mIdleCount, 1u);
+}
+
+TEST_F(TestCommissioningOrchestrator, ReportsSynchronousFailuresOnce)
+{
+    mDelegate.mDeviceCount           = 5;
+    mOrchestrator.mFailToStart       = kFirstNodeId;
+    mOrchestrator.mFailWhileStarting = kFirstNodeId + 1;
+    mOrchestrator.Start();
+
+    // A device that fails to start is reported and the lane moves on to the next device right away. A device whose
+    // failure was already reported through the pairing delegate is not reported again, and frees its lane for later.
+    ASSERT_EQ(mOrchestrator.mStarted.size(), 4u);
+    mLanes = { 0, 0, 1, 2 };
+    ASSERT_EQ(mDelegate.mResults.size(), 2u);
+    EXPECT_EQ(mDelegate.mResults[0].first, kFirstNodeId);
+    EXPECT_EQ(mDelegate.mResults[0].second, CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(mDelegate.mResults[1].first, kFirstNodeId + 1);
+    EXPECT_EQ(mDelegate.mResults[1].second, CHIP_ERROR_TIMEOUT);
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 2u);
+
+    mSystemLayer.FireTimers();
+    ASSERT_EQ(mOrchestrator.mStarted.size(), 5u);
+    EXPECT_EQ(mOrchestrator.mStarted[4], kFirstNodeId + 4);
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 3u);
+    EXPECT_EQ(mDelegate.mResults.size(), 2u);
+}
+
+TEST_F(TestCommissioningOrchestrator, WithdrawsPoolWorkOfCompletedDevice)
+{
+    mDelegate.mDeviceCount = 2;
+    mOrchestrator.Start();
+    mLanes = { 0, 1 };
+
+    // With a single NOC chain generation at a time, the request of the second lane waits for the first one.
+    NOCChainRequester requesters[2];
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        EXPECT_EQ(mOrchestrator.GetOperationalCredentialsDelegate(i)->GenerateNOCChain(
+                      ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), &requesters[i].mCallback),
+                  CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(mCredentialsDelegate.mRequests.size(), 1u);
+
+    // The second device fails meanwhile: its queued request must not run once the slot frees up.
+    Complete(kFirstNodeId + 1, CHIP_ERROR_TIMEOUT);
+    mCredentialsDelegate.Complete(0);
+    EXPECT_EQ(requesters[0].mResults, 1u);
+    EXPECT_EQ(mCredentialsDelegate.mRequests.size(), 1u);
+    EXPECT_EQ(requesters[1].mResults, 0u);
+}
+
+TEST_F(TestCommissioningOrchestrator, KeepsLaneUntilPoolWorkOfFailedDeviceCompletes)
+{
+    mDelegate.mDeviceCount = 4;
+    mOrchestrator.Start();
+    mLanes = { 0, 1, 2 };
+
+    NOCChainRequester requester;
+    EXPECT_EQ(mOrchestrator.GetOperationalCredentialsDelegate(0)->GenerateNOCChain(
+                  ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), &requester.mCallback),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(mCredentialsDelegate.mRequests.size(), 1u);
+
+    // The device fails while its NOC chain is being generated: the lane takes no other device until the generation
+    // completes, since the request of the next one would overwrite it.
+    Complete(kFirstNodeId, CHIP_ERROR_TIMEOUT);
+    mSystemLayer.FireTimers();
+    EXPECT_EQ(mDelegate.mResults.size(), 1u);
+    EXPECT_EQ(mOrchestrator.mStarted.size(), 3u);
+    EXPECT_EQ(mOrchestrator.GetActiveLaneCount(), 3u);
+
+    // Its result is dropped, and the lane is freed.
+    mCredentialsDelegate.Complete(0);
+    EXPECT_EQ(requester.mResults, 0u);
+    mSystemLayer.FireTimers();
+    ASSERT_EQ(mOrchestrator.mStarted.size(), 4u);
+    mLanes.push_back(0);
+    EXPECT_EQ(mOrchestrator.mStarted[3], kFirstNodeId + 3);
+
+    // The next device of the lane generates its NOC chain as usual.
+    EXPECT_EQ(mOrchestrator.GetOperationalCredentialsDelegate(0)->GenerateNOCChain(
+                  ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), &requester.mCallback),
+              CHIP_NO_ERROR);
+    ASSERT_EQ(mCredentialsDelegate.mRequests.size(), 2u);
+    mCredentialsDelegate.Complete(1);
+    EXPECT_EQ(requester.mResults, 1u);
+}
+
+} // namespace
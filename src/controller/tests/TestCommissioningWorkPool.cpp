@@ -0,0 +1,306 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <controller/CommissioningWorkPool.h>
+#include <lib/core/StringBuilderAdapters.h>
+
+using namespace chip;
+using namespace chip::Controller;
+using namespace chip::Credentials;
+
+namespace {
+
+constexpr uint8_t kCommissionerCount = 3;
+
+// Keeps the requests pending until Complete() is called, like a delegate signing the NOCs remotely.
+class AsyncOperationalCredentialsDelegate : public OperationalCredentialsDelegate
+{
+public:
+    CHIP_ERROR GenerateNOCChain(const ByteSpan & csrElements, const ByteSpan & csrNonce, const ByteSpan & attestationSignature,
+                                const ByteSpan & attestationChallenge, const ByteSpan & DAC, const ByteSpan & PAI,
+                                Callback::Callback<OnNOCChainGeneration> * onCompletion) override
+    {
+        ReturnErrorOnFailure(mGenerateError);
+        mRequests[mRequestCount]  = onCompletion;
+        mNodeIds[mRequestCount]   = mNextNodeId;
+        mFabricIds[mRequestCount] = mNextFabricId;
+        mRequestCount++;
+        return CHIP_NO_ERROR;
+    }
+
+    void SetNodeIdForNextNOCRequest(NodeId nodeId) override { mNextNodeId = nodeId; }
+    void SetFabricIdForNextNOCRequest(FabricId fabricId) override { mNextFabricId = fabricId; }
+
+    void Complete(size_t index, CHIP_ERROR status = CHIP_NO_ERROR)
+    {
+        Callback::Callback<OnNOCChainGeneration> * onCompletion = mRequests[index];
+        onCompletion->mCall(onCompletion->mContext, status, ByteSpan(), ByteSpan(), ByteSpan(), NullOptional, NullOptional);
+    }
+
+    CHIP_ERROR mGenerateError = CHIP_NO_ERROR;
+    Callback::Callback<OnNOCChainGeneration> * mRequests[kCommissionerCount];
+    NodeId mNodeIds[kCommissionerCount];
+    FabricId mFabricIds[kCommissionerCount];
+    size_t mRequestCount   = 0;
+    NodeId mNextNodeId     = kUndefinedNodeId;
+    FabricId mNextFabricId = kUndefinedFabricId;
+};
+
+// Verifies synchronously, like the DefaultDACVerifier.
+class SyncDeviceAttestationVerifier : public DeviceAttestationVerifier
+{
+public:
+    void VerifyAttestationInformation(const AttestationInfo & info,
+                                      Callback::Callback<OnAttestationInformationVerification> * onCompletion) override
+    {
+        mVerifyCount++;
+        onCompletion->mCall(onCompletion->mContext, info, AttestationVerificationResult::kSuccess);
+    }
+
+    AttestationVerificationResult ValidateCertificationDeclarationSignature(const ByteSpan & cmsEnvelopeBuffer,
+                                                                            ByteSpan & certDeclBuffer) override
+    {
+        return AttestationVerificationResult::kNotImplemented;
+    }
+
+    AttestationVerificationResult ValidateCertificateDeclarationPayload(const ByteSpan & certDeclBuffer,
+                                                                        const ByteSpan & firmwareInfo,
+                                                                        const DeviceInfoForAttestation & deviceInfo) override
+    {
+        return AttestationVerificationResult::kNotImplemented;
+    }
+
+    CHIP_ERROR VerifyNodeOperationalCSRInformation(const ByteSpan & nocsrElementsBuffer,
+                                                   const ByteSpan & attestationChallengeBuffer,
+                                                   const ByteSpan & attestationSignatureBuffer,
+                                                   const Crypto::P256PublicKey & dacPublicKey, const ByteSpan & csrNonce) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    void CheckForRevokedDACChain(const AttestationInfo & info,
+                                 Callback::Callback<OnAttestationInformationVerification> * onCompletion) override
+    {}
+
+    size_t mVerifyCount = 0;
+};
+
+// Stands for the callbacks that a DeviceCommissioner passes to its delegates.
+struct Commissioner
+{
+    static void OnNOCChainGenerated(void * context, CHIP_ERROR status, const ByteSpan & noc, const ByteSpan & icac,
+                                    const ByteSpan & rcac, Optional<Crypto::IdentityProtectionKeySpan> ipk,
+                                    Optional<NodeId> adminSubject)
+    {
+        auto * self = static_cast<Commissioner *>(context);
+        self->mNOCChainResults++;
+        self->mNOCChainStatus = status;
+    }
+
+    static void OnVerified(void * context, const DeviceAttestationVerifier::AttestationInfo & info,
+                           AttestationVerificationResult result)
+    {
+        auto * self = static_cast<Commissioner *>(context);
+        self->mVerificationResults++;
+        self->mDacSize = info.dacDerBuffer.size();
+    }
+
+    Commissioner() : mNOCChainCallback(OnNOCChainGenerated, this), mVerificationCallback(OnVerified, this) {}
+
+    Callback::Callback<OnNOCChainGeneration> mNOCChainCallback;
+    Callback::Callback<DeviceAttestationVerifier::OnAttestationInformationVerification> mVerificationCallback;
+    size_t mNOCChainResults     = 0;
+    CHIP_ERROR mNOCChainStatus  = CHIP_NO_ERROR;
+    size_t mVerificationResults = 0;
+    size_t mDacSize             = 0;
+};
+
+struct Work
+{
+    static void Run(void * context) { static_cast<Work *>(context)->mRunCount++; }
+
+    Work() : mCallback(Run, this) {}
+
+    Callback::Callback<> mCallback;
+    size_t mRunCount = 0;
+};
+
+TEST(TestCommissioningWorkPool, StartsQueuedWorkInOrder)
+{
+    CommissioningWorkPool pool(2);
+    Work works[4];
+
+    EXPECT_TRUE(pool.TryStart(&works[0].mCallback));
+    EXPECT_TRUE(pool.TryStart(&works[1].mCallback));
+    EXPECT_FALSE(pool.TryStart(&works[2].mCallback));
+    EXPECT_FALSE(pool.TryStart(&works[3].mCallback));
+    EXPECT_EQ(pool.GetInFlightCount(), 2u);
+
+    // Withdrawn work is not started.
+    works[2].mCallback.Cancel();
+
+    pool.Finish();
+    EXPECT_EQ(works[2].mRunCount, 0u);
+    EXPECT_EQ(works[3].mRunCount, 1u);
+    EXPECT_EQ(pool.GetInFlightCount(), 2u);
+    EXPECT_FALSE(pool.HasPendingWork());
+
+    pool.Finish();
+    pool.Finish();
+    EXPECT_EQ(pool.GetInFlightCount(), 0u);
+    EXPECT_TRUE(pool.TryStart(&works[0].mCallback));
+}
+
+TEST(TestCommissioningWorkPool, LimitsNOCChainGenerations)
+{
+    AsyncOperationalCredentialsDelegate backend;
+    CommissioningWorkPool pool(1);
+    PooledOperationalCredentialsDelegate delegates[kCommissionerCount];
+    Commissioner commissioners[kCommissionerCount];
+
+    for (uint8_t i = 0; i < kCommissionerCount; i++)
+    {
+        delegates[i].Init(&backend, &pool);
+        delegates[i].SetNodeIdForNextNOCRequest(100 + i);
+        delegates[i].SetFabricIdForNextNOCRequest(1);
+        EXPECT_EQ(delegates[i].GenerateNOCChain(ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(),
+                                                &commissioners[i].mNOCChainCallback),
+                  CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(backend.mRequestCount, 1u);
+
+    for (size_t i = 0; i < kCommissionerCount; i++)
+    {
+        // Each request reaches the backend with the node ID of its own commissioner, once the previous one completes.
+        ASSERT_EQ(backend.mRequestCount, i + 1);
+        EXPECT_EQ(backend.mNodeIds[i], 100 + i);
+        EXPECT_EQ(backend.mFabricIds[i], 1u);
+        EXPECT_EQ(commissioners[i].mNOCChainResults, 0u);
+        backend.Complete(i);
+        EXPECT_EQ(commissioners[i].mNOCChainResults, 1u);
+    }
+    EXPECT_EQ(pool.GetInFlightCount(), 0u);
+}
+
+TEST(TestCommissioningWorkPool, ReportsNOCChainGenerationStartFailures)
+{
+    AsyncOperationalCredentialsDelegate backend;
+    CommissioningWorkPool pool(1);
+    PooledOperationalCredentialsDelegate delegates[2];
+    Commissioner commissioners[2];
+
+    for (auto & delegate : delegates)
+    {
+        delegate.Init(&backend, &pool);
+    }
+    EXPECT_EQ(delegates[0].GenerateNOCChain(ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(),
+                                            &commissioners[0].mNOCChainCallback),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(delegates[1].GenerateNOCChain(ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(),
+                                            &commissioners[1].mNOCChainCallback),
+              CHIP_NO_ERROR);
+
+    // A queued request that fails to start reports the failure through its callback.
+    backend.mGenerateError = CHIP_ERROR_NO_MEMORY;
+    backend.Complete(0);
+    EXPECT_EQ(commissioners[1].mNOCChainResults, 1u);
+    EXPECT_EQ(commissioners[1].mNOCChainStatus, CHIP_ERROR_NO_MEMORY);
+    EXPECT_EQ(pool.GetInFlightCount(), 0u);
+
+    // A request started right away returns the failure, without calling its callback.
+    EXPECT_EQ(delegates[0].GenerateNOCChain(ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(),
+                                            &commissioners[0].mNOCChainCallback),
+              CHIP_ERROR_NO_MEMORY);
+    EXPECT_EQ(commissioners[0].mNOCChainResults, 1u);
+    EXPECT_EQ(pool.GetInFlightCount(), 0u);
+}
+
+TEST(TestCommissioningWorkPool, AbandonsNOCChainGenerations)
+{
+    AsyncOperationalCredentialsDelegate backend;
+    CommissioningWorkPool pool(1);
+    PooledOperationalCredentialsDelegate delegates[2];
+    Commissioner commissioners[2];
+    Work done;
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        delegates[i].Init(&backend, &pool);
+        EXPECT_EQ(delegates[i].GenerateNOCChain(ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(),
+                                                &commissioners[i].mNOCChainCallback),
+                  CHIP_NO_ERROR);
+    }
+
+    // A queued request is withdrawn, while one in progress keeps its slot until it completes, without a result.
+    EXPECT_FALSE(delegates[1].Abandon(&done.mCallback));
+    EXPECT_TRUE(delegates[0].Abandon(&done.mCallback));
+    EXPECT_EQ(pool.GetInFlightCount(), 1u);
+
+    backend.Complete(0);
+    EXPECT_EQ(commissioners[0].mNOCChainResults, 0u);
+    EXPECT_EQ(done.mRunCount, 1u);
+    EXPECT_EQ(backend.mRequestCount, 1u);
+    EXPECT_EQ(commissioners[1].mNOCChainResults, 0u);
+    EXPECT_EQ(pool.GetInFlightCount(), 0u);
+
+    // The delegate takes requests again, and reports their results.
+    EXPECT_FALSE(delegates[0].Abandon(&done.mCallback));
+    EXPECT_EQ(delegates[0].GenerateNOCChain(ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(),
+                                            &commissioners[0].mNOCChainCallback),
+              CHIP_NO_ERROR);
+    backend.Complete(1);
+    EXPECT_EQ(commissioners[0].mNOCChainResults, 1u);
+    EXPECT_EQ(done.mRunCount, 1u);
+}
+
+TEST(TestCommissioningWorkPool, VerifiesAttestationsWithSynchronousVerifier)
+{
+    SyncDeviceAttestationVerifier backend;
+    CommissioningWorkPool pool(1);
+    PooledDeviceAttestationVerifier verifiers[2];
+    Commissioner commissioners[2];
+    const uint8_t dac[] = { 1, 2, 3 };
+
+    for (auto & verifier : verifiers)
+    {
+        verifier.Init(&backend, &pool);
+    }
+
+    // Holding the only slot queues the verifications, which then complete one after the other.
+    Work holder;
+    EXPECT_TRUE(pool.TryStart(&holder.mCallback));
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        DeviceAttestationVerifier::AttestationInfo info(ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(), ByteSpan(dac, i + 1u),
+                                                        ByteSpan(), VendorId::TestVendor1, 0x8000);
+        verifiers[i].VerifyAttestationInformation(info, &commissioners[i].mVerificationCallback);
+    }
+    EXPECT_EQ(backend.mVerifyCount, 0u);
+
+    pool.Finish();
+    EXPECT_EQ(backend.mVerifyCount, 2u);
+    EXPECT_EQ(commissioners[0].mVerificationResults, 1u);
+    EXPECT_EQ(commissioners[0].mDacSize, 1u);
+    EXPECT_EQ(commissioners[1].mVerificationResults, 1u);
+    EXPECT_EQ(commissioners[1].mDacSize, 2u);
+    EXPECT_EQ(pool.GetInFlightCount(), 0u);
+}
+
+} // namespace
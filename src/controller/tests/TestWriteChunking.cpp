@@ -16,6 +16,8 @@
  *    limitations under the License.
  */
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <utility>
 
@@ -36,6 +38,7 @@
 #include <app/util/DataModelHandler.h>
 #include <app/util/attribute-storage.h>
 #include <controller/InvokeInteraction.h>
+#include <lib/core/CHIPEncoding.h>
 #include <lib/core/ErrorStr.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <messaging/tests/MessagingContext.h>
@@ -171,6 +174,7 @@ public:
 
     std::function<void(const app::ConcreteAttributePath & path)> mOnListWriteBegin;
     std::function<void(const app::ConcreteAttributePath & path, bool wasSuccessful)> mOnListWriteEnd;
+    std::function<void(const ByteSpan & item)> mOnListItemWritten;
 } testServer;
 
 CHIP_ERROR TestAttrAccess::Read(const app::ConcreteReadAttributePath & aPath, app::AttributeValueEncoder & aEncoder)
@@ -193,6 +197,10 @@ CHIP_ERROR TestAttrAccess::Write(const app::ConcreteDataAttributePath & aPath, a
         ByteSpan listItem;
         CHIP_ERROR err = aDecoder.Decode(listItem);
         ChipLogError(Zcl, "Decode result: %s", err.AsString());
+        if (err == CHIP_NO_ERROR && mOnListItemWritten)
+        {
+            mOnListItemWritten(listItem);
+        }
         return err;
     }
 
@@ -494,6 +502,189 @@ TEST_F(TestWriteChunking, TestNonConflictWrite)
     emberAfClearDynamicEndpoint(0);
 }
 
+// Generates the items of a list as the WriteClient pulls them, each item holding its index.
+class GeneratedListItemSource : public app::WriteClient::ListItemSource
+{
+public:
+    GeneratedListItemSource(uint32_t itemCount, const uint32_t & itemsWritten) :
+        mItemCount(itemCount), mItemsWritten(itemsWritten)
+    {}
+
+    bool AtEnd() override { return mNextItem == mItemCount; }
+
+    CHIP_ERROR EncodeItem(TLV::TLVWriter & writer, TLV::Tag tag) override
+    {
+        VerifyOrReturnError(mNextItem != mFailingItem, CHIP_ERROR_INTERNAL);
+
+        mMaxItemsAhead = std::max(mMaxItemsAhead, mNextItem - mItemsWritten);
+
+        uint8_t item[sizeof(uint32_t)];
+        Encoding::LittleEndian::Put32(item, mNextItem);
+        return app::DataModel::Encode(writer, tag, ByteSpan(item));
+    }
+
+    void Next() override { mNextItem++; }
+
+    uint32_t mFailingItem = UINT32_MAX;
+    // Largest number of items encoded but not written on the server yet.
+    uint32_t mMaxItemsAhead = 0;
+
+private:
+    uint32_t mItemCount;
+    const uint32_t & mItemsWritten;
+    uint32_t mNextItem = 0;
+};
+
+/*
+ * Writes a list much larger than a chunk, whose items are generated as the chunks are sent. The items must reach the server
+ * in order, while only a few chunks are encoded ahead of those the server has processed.
+ */
+TEST_F(TestWriteChunking, TestStreamedListChunking)
+{
+    auto sessionHandle = mpContext->GetSessionBobToAlice();
+
+    // Initialize the ember side server logic
+    InitDataModelHandler();
+
+    // Register our fake dynamic endpoint.
+    emberAfSetDynamicEndpoint(0, kTestEndpointId, &testEndpoint, Span<DataVersion>(dataVersionStorage));
+
+    // Register our fake attribute access interface.
+    registerAttributeAccessOverride(&testServer);
+
+    app::AttributePathParams attributePath(kTestEndpointId, app::Clusters::UnitTesting::Id, kTestListAttribute);
+
+    constexpr uint32_t kLargeListLength = 1000;
+    uint32_t itemsWritten               = 0;
+    testServer.mOnListItemWritten       = [&](const ByteSpan & item) {
+        ASSERT_EQ(item.size(), sizeof(uint32_t));
+        EXPECT_EQ(Encoding::LittleEndian::Get32(item.data()), itemsWritten);
+        itemsWritten++;
+    };
+
+    /* use a smaller chunk (128 bytes) so that the list spans hundreds of chunks. */
+    constexpr size_t kReserveSize = kMaxSecureSduLengthBytes - 128;
+
+    TestWriteCallback writeCallback;
+    app::WriteClient writeClient(&mpContext->GetExchangeManager(), &writeCallback, Optional<uint16_t>::Missing(),
+                                 static_cast<uint16_t>(kReserveSize));
+
+    GeneratedListItemSource source(kLargeListLength, itemsWritten);
+    EXPECT_EQ(writeClient.EncodeListAttribute(attributePath, source), CHIP_NO_ERROR);
+
+    // The generated list is the last attribute of the request.
+    EXPECT_EQ(writeClient.EncodeAttribute(attributePath, app::DataModel::Nullable<uint8_t>()), CHIP_ERROR_INCORRECT_STATE);
+
+    EXPECT_EQ(writeClient.SendWriteRequest(sessionHandle), CHIP_NO_ERROR);
+
+    for (uint32_t j = 0; j < kLargeListLength && writeCallback.mOnDoneCount == 0; j++)
+    {
+        mpContext->DrainAndServiceIO();
+    }
+
+    EXPECT_EQ(itemsWritten, kLargeListLength);
+    EXPECT_EQ(writeCallback.mSuccessCount, kLargeListLength + 1 /* an extra item for the empty list at the beginning */);
+    EXPECT_EQ(writeCallback.mErrorCount, 0u);
+    EXPECT_EQ(writeCallback.mOnDoneCount, 1u);
+    // A chunk holds a few items: the whole list is never encoded at once.
+    EXPECT_LT(source.mMaxItemsAhead, 50u);
+
+    EXPECT_EQ(mpContext->GetExchangeManager().GetNumActiveExchanges(), 0u);
+
+    testServer.mOnListItemWritten = nullptr;
+    emberAfClearDynamicEndpoint(0);
+}
+
+TEST_F(TestWriteChunking, TestStreamedListFromIterators)
+{
+    auto sessionHandle = mpContext->GetSessionBobToAlice();
+
+    // Initialize the ember side server logic
+    InitDataModelHandler();
+
+    // Register our fake dynamic endpoint.
+    emberAfSetDynamicEndpoint(0, kTestEndpointId, &testEndpoint, Span<DataVersion>(dataVersionStorage));
+
+    // Register our fake attribute access interface.
+    registerAttributeAccessOverride(&testServer);
+
+    app::AttributePathParams attributePath(kTestEndpointId, app::Clusters::UnitTesting::Id, kTestListAttribute);
+
+    TestWriteCallback writeCallback;
+    app::WriteClient writeClient(&mpContext->GetExchangeManager(), &writeCallback, Optional<uint16_t>::Missing(),
+                                 static_cast<uint16_t>(kMaxSecureSduLengthBytes - 128));
+
+    ByteSpan list[kTestListLength];
+    app::WriteClient::IteratorListItemSource<const ByteSpan *> source(std::begin(list), std::end(list));
+    EXPECT_EQ(writeClient.EncodeListAttribute(attributePath, source), CHIP_NO_ERROR);
+    EXPECT_EQ(writeClient.SendWriteRequest(sessionHandle), CHIP_NO_ERROR);
+
+    for (int j = 0; j < 10 && writeCallback.mOnDoneCount == 0; j++)
+    {
+        mpContext->DrainAndServiceIO();
+    }
+
+    EXPECT_EQ(writeCallback.mSuccessCount, kTestListLength + 1 /* an extra item for the empty list at the beginning */);
+    EXPECT_EQ(writeCallback.mErrorCount, 0u);
+    EXPECT_EQ(writeCallback.mOnDoneCount, 1u);
+
+    EXPECT_EQ(mpContext->GetExchangeManager().GetNumActiveExchanges(), 0u);
+
+    emberAfClearDynamicEndpoint(0);
+}
+
+TEST_F(TestWriteChunking, TestStreamedListEncodingFailure)
+{
+    auto sessionHandle = mpContext->GetSessionBobToAlice();
+
+    // Initialize the ember side server logic
+    InitDataModelHandler();
+
+    // Register our fake dynamic endpoint.
+    emberAfSetDynamicEndpoint(0, kTestEndpointId, &testEndpoint, Span<DataVersion>(dataVersionStorage));
+
+    // Register our fake attribute access interface.
+    registerAttributeAccessOverride(&testServer);
+
+    app::AttributePathParams attributePath(kTestEndpointId, app::Clusters::UnitTesting::Id, kTestListAttribute);
+    constexpr size_t kReserveSize = kMaxSecureSduLengthBytes - 128;
+    uint32_t itemsWritten         = 0;
+
+    // Failures while encoding the first chunks are returned right away.
+    {
+        TestWriteCallback writeCallback;
+        app::WriteClient writeClient(&mpContext->GetExchangeManager(), &writeCallback, Optional<uint16_t>::Missing(),
+                                     static_cast<uint16_t>(kReserveSize));
+
+        GeneratedListItemSource source(100, itemsWritten);
+        source.mFailingItem = 1;
+        EXPECT_EQ(writeClient.EncodeListAttribute(attributePath, source), CHIP_ERROR_INTERNAL);
+    }
+
+    // Later failures abort the interaction.
+    {
+        TestWriteCallback writeCallback;
+        app::WriteClient writeClient(&mpContext->GetExchangeManager(), &writeCallback, Optional<uint16_t>::Missing(),
+                                     static_cast<uint16_t>(kReserveSize));
+
+        GeneratedListItemSource source(100, itemsWritten);
+        source.mFailingItem = 50;
+        EXPECT_EQ(writeClient.EncodeListAttribute(attributePath, source), CHIP_NO_ERROR);
+        EXPECT_EQ(writeClient.SendWriteRequest(sessionHandle), CHIP_NO_ERROR);
+
+        mpContext->GetIOContext().DriveIOUntil(sessionHandle->ComputeRoundTripTimeout(app::kExpectedIMProcessingTime) +
+                                                   System::Clock::Seconds16(1),
+                                               [&]() { return mpContext->GetExchangeManager().GetNumActiveExchanges() == 0; });
+
+        EXPECT_EQ(writeCallback.mErrorCount, 1u);
+        EXPECT_EQ(writeCallback.mOnDoneCount, 1u);
+    }
+
+    EXPECT_EQ(mpContext->GetExchangeManager().GetNumActiveExchanges(), 0u);
+
+    emberAfClearDynamicEndpoint(0);
+}
+
 namespace TestTransactionalListInstructions {
 
 using PathStatus = std::pair<app::ConcreteAttributePath, bool>;
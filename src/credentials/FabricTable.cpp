@@ -54,6 +54,18 @@ constexpr TLV::Tag kFabricIndicesTag            = TLV::ContextTag(1);
 constexpr TLV::Tag kMarkerFabricIndexTag = TLV::ContextTag(0);
 constexpr TLV::Tag kMarkerIsAdditionTag  = TLV::ContextTag(1);
 
+// Tags for startup snapshot storage.  The next available index uses kNextAvailableFabricIndexTag.
+constexpr TLV::Tag kSnapshotFabricsTag = TLV::ContextTag(1);
+
+// Tags for a fabric within the startup snapshot.
+constexpr TLV::Tag kSnapshotFabricIndexTag        = TLV::ContextTag(0);
+constexpr TLV::Tag kSnapshotNodeIdTag             = TLV::ContextTag(1);
+constexpr TLV::Tag kSnapshotFabricIdTag           = TLV::ContextTag(2);
+constexpr TLV::Tag kSnapshotCompressedFabricIdTag = TLV::ContextTag(3);
+constexpr TLV::Tag kSnapshotRootPublicKeyTag      = TLV::ContextTag(4);
+constexpr TLV::Tag kSnapshotVendorIdTag           = TLV::ContextTag(5);
+constexpr TLV::Tag kSnapshotFabricLabelTag        = TLV::ContextTag(6);
+
 constexpr size_t CommitMarkerContextTLVMaxSize()
 {
     // Add 2x uncommitted uint64_t to leave space for backwards/forwards
@@ -207,6 +219,61 @@ CHIP_ERROR FabricInfo::LoadFromStorage(PersistentStorageDelegate * storage, Fabr
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR FabricInfo::SerializeToSnapshot(TLV::TLVWriter & writer) const
+{
+    TLV::TLVType outerType;
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType));
+
+    ReturnErrorOnFailure(writer.Put(kSnapshotFabricIndexTag, mFabricIndex));
+    ReturnErrorOnFailure(writer.Put(kSnapshotNodeIdTag, mNodeId));
+    ReturnErrorOnFailure(writer.Put(kSnapshotFabricIdTag, mFabricId));
+    ReturnErrorOnFailure(writer.Put(kSnapshotCompressedFabricIdTag, mCompressedFabricId));
+    ReturnErrorOnFailure(writer.Put(kSnapshotRootPublicKeyTag, ByteSpan(mRootPublicKey.ConstBytes(), mRootPublicKey.Length())));
+    ReturnErrorOnFailure(writer.Put(kSnapshotVendorIdTag, mVendorId));
+    ReturnErrorOnFailure(writer.PutString(kSnapshotFabricLabelTag, CharSpan::fromCharString(mFabricLabel)));
+
+    return writer.EndContainer(outerType);
+}
+
+CHIP_ERROR FabricInfo::LoadFromSnapshot(TLV::ContiguousBufferTLVReader & reader)
+{
+    TLV::TLVType containerType;
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+
+    ReturnErrorOnFailure(reader.Next(kSnapshotFabricIndexTag));
+    ReturnErrorOnFailure(reader.Get(mFabricIndex));
+
+    ReturnErrorOnFailure(reader.Next(kSnapshotNodeIdTag));
+    ReturnErrorOnFailure(reader.Get(mNodeId));
+
+    ReturnErrorOnFailure(reader.Next(kSnapshotFabricIdTag));
+    ReturnErrorOnFailure(reader.Get(mFabricId));
+
+    ReturnErrorOnFailure(reader.Next(kSnapshotCompressedFabricIdTag));
+    ReturnErrorOnFailure(reader.Get(mCompressedFabricId));
+
+    ReturnErrorOnFailure(reader.Next(kSnapshotRootPublicKeyTag));
+    ByteSpan rootPublicKey;
+    ReturnErrorOnFailure(reader.Get(rootPublicKey));
+    VerifyOrReturnError(rootPublicKey.size() == kP256_PublicKey_Length, CHIP_ERROR_INVALID_TLV_ELEMENT);
+    mRootPublicKey = P256PublicKeySpan(rootPublicKey.data());
+
+    ReturnErrorOnFailure(reader.Next(kSnapshotVendorIdTag));
+    ReturnErrorOnFailure(reader.Get(mVendorId));
+
+    ReturnErrorOnFailure(reader.Next(kSnapshotFabricLabelTag));
+    CharSpan label;
+    ReturnErrorOnFailure(reader.Get(label));
+
+    VerifyOrReturnError(label.size() <= kFabricLabelMaxLengthInBytes, CHIP_ERROR_BUFFER_TOO_SMALL);
+    Platform::CopyString(mFabricLabel, label);
+
+    ReturnErrorOnFailure(reader.ExitContainer(containerType));
+
+    VerifyOrReturnError(IsValidFabricIndex(mFabricIndex) && IsInitialized(), CHIP_ERROR_INVALID_TLV_ELEMENT);
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR FabricInfo::SetFabricLabel(const CharSpan & fabricLabel)
 {
     Platform::CopyString(mFabricLabel, fabricLabel);
@@ -348,20 +415,63 @@ CHIP_ERROR FabricTable::VerifyCredentials(FabricIndex fabricIndex, const ByteSpa
                                           ValidationContext & context, CompressedFabricId & outCompressedFabricId,
                                           FabricId & outFabricId, NodeId & outNodeId, Crypto::P256PublicKey & outNocPubkey,
                                           Crypto::P256PublicKey * outRootPublicKey) const
+{
+    VerifiedCertChainCache::VerifiedChain chain;
+    ReturnErrorOnFailure(VerifyCredentials(fabricIndex, noc, icac, context, chain));
+
+    outCompressedFabricId = chain.compressedFabricId;
+    outFabricId           = chain.fabricId;
+    outNodeId             = chain.nodeId;
+    outNocPubkey          = chain.nocPublicKey;
+    if (outRootPublicKey != nullptr)
+    {
+        *outRootPublicKey = chain.rootPublicKey;
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FabricTable::VerifyCredentials(FabricIndex fabricIndex, const ByteSpan & noc, const ByteSpan & icac,
+                                          ValidationContext & context, VerifiedCertChainCache::VerifiedChain & outChain) const
 {
     MATTER_TRACE_SCOPE("VerifyCredentials", "Fabric");
     assertChipStackLockedByCurrentThread();
     uint8_t rootCertBuf[kMaxCHIPCertLength];
     MutableByteSpan rootCertSpan{ rootCertBuf };
     ReturnErrorOnFailure(FetchRootCert(fabricIndex, rootCertSpan));
-    return VerifyCredentials(noc, icac, rootCertSpan, context, outCompressedFabricId, outFabricId, outNodeId, outNocPubkey,
-                             outRootPublicKey);
+
+    VerifiedCertChainCache::Digest digest;
+    ReturnErrorOnFailure(VerifiedCertChainCache::ComputeDigest(noc, icac, rootCertSpan, context, digest));
+    if (mVerifiedCertChainCache.Find(fabricIndex, digest, context, outChain))
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    ReturnErrorOnFailure(VerifyCredentials(noc, icac, rootCertSpan, context, outChain));
+    mVerifiedCertChainCache.Add(fabricIndex, digest, context, outChain);
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR FabricTable::VerifyCredentials(const ByteSpan & noc, const ByteSpan & icac, const ByteSpan & rcac,
                                           ValidationContext & context, CompressedFabricId & outCompressedFabricId,
                                           FabricId & outFabricId, NodeId & outNodeId, Crypto::P256PublicKey & outNocPubkey,
                                           Crypto::P256PublicKey * outRootPublicKey)
+{
+    VerifiedCertChainCache::VerifiedChain chain;
+    ReturnErrorOnFailure(VerifyCredentials(noc, icac, rcac, context, chain));
+
+    outCompressedFabricId = chain.compressedFabricId;
+    outFabricId           = chain.fabricId;
+    outNodeId             = chain.nodeId;
+    outNocPubkey          = chain.nocPublicKey;
+    if (outRootPublicKey != nullptr)
+    {
+        *outRootPublicKey = chain.rootPublicKey;
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FabricTable::VerifyCredentials(const ByteSpan & noc, const ByteSpan & icac, const ByteSpan & rcac,
+                                          ValidationContext & context, VerifiedCertChainCache::VerifiedChain & outChain)
 {
     // TODO - Optimize credentials verification logic
     //        The certificate chain construction and verification is a compute and memory intensive operation.
@@ -389,7 +499,8 @@ CHIP_ERROR FabricTable::VerifyCredentials(const ByteSpan & noc, const ByteSpan &
     // It confirms that the certs link correctly (noc -> icac -> rcac), and have been correctly signed.
     ReturnErrorOnFailure(certificates.FindValidCert(nocSubjectDN, nocSubjectKeyId, context, &resultCert));
 
-    ReturnErrorOnFailure(ExtractNodeIdFabricIdFromOpCert(certificates.GetLastCert()[0], &outNodeId, &outFabricId));
+    ReturnErrorOnFailure(ExtractNodeIdFabricIdFromOpCert(certificates.GetLastCert()[0], &outChain.nodeId, &outChain.fabricId));
+    ReturnErrorOnFailure(ExtractCATsFromOpCert(certificates.GetLastCert()[0], outChain.cats));
 
     CHIP_ERROR err;
     FabricId icacFabricId = kUndefinedFabricId;
@@ -398,7 +509,7 @@ CHIP_ERROR FabricTable::VerifyCredentials(const ByteSpan & noc, const ByteSpan &
         err = ExtractFabricIdFromCert(certificates.GetCertSet()[1], &icacFabricId);
         if (err == CHIP_NO_ERROR)
         {
-            ReturnErrorCodeIf(icacFabricId != outFabricId, CHIP_ERROR_FABRIC_MISMATCH_ON_ICA);
+            ReturnErrorCodeIf(icacFabricId != outChain.fabricId, CHIP_ERROR_FABRIC_MISMATCH_ON_ICA);
         }
         // FabricId is optional field in ICAC and "not found" code is not treated as error.
         else if (err != CHIP_ERROR_NOT_FOUND)
@@ -411,7 +522,7 @@ CHIP_ERROR FabricTable::VerifyCredentials(const ByteSpan & noc, const ByteSpan &
     err                   = ExtractFabricIdFromCert(certificates.GetCertSet()[0], &rcacFabricId);
     if (err == CHIP_NO_ERROR)
     {
-        ReturnErrorCodeIf(rcacFabricId != outFabricId, CHIP_ERROR_WRONG_CERT_DN);
+        ReturnErrorCodeIf(rcacFabricId != outChain.fabricId, CHIP_ERROR_WRONG_CERT_DN);
     }
     // FabricId is optional field in RCAC and "not found" code is not treated as error.
     else if (err != CHIP_ERROR_NOT_FOUND)
@@ -425,20 +536,30 @@ CHIP_ERROR FabricTable::VerifyCredentials(const ByteSpan & noc, const ByteSpan &
         MutableByteSpan compressedFabricIdSpan(compressedFabricIdBuf);
         P256PublicKey rootPubkey(certificates.GetCertSet()[0].mPublicKey);
 
-        ReturnErrorOnFailure(GenerateCompressedFabricId(rootPubkey, outFabricId, compressedFabricIdSpan));
+        ReturnErrorOnFailure(GenerateCompressedFabricId(rootPubkey, outChain.fabricId, compressedFabricIdSpan));
 
         // Decode compressed fabric ID accounting for endianness, as GenerateCompressedFabricId()
         // returns a binary buffer and is agnostic of usage of the output as an integer type.
-        outCompressedFabricId = Encoding::BigEndian::Get64(compressedFabricIdBuf);
+        outChain.compressedFabricId = Encoding::BigEndian::Get64(compressedFabricIdBuf);
+        outChain.rootPublicKey      = rootPubkey;
+    }
 
-        if (outRootPublicKey != nullptr)
+    outChain.nocPublicKey = certificates.GetLastCert()->mPublicKey;
+
+    // Validity period of the whole chain, for the verified chain cache.
+    outChain.notBefore = 0;
+    outChain.notAfter  = kNullCertTime;
+    for (uint8_t i = 0; i < certificates.GetCertCount(); i++)
+    {
+        const ChipCertificateData & cert = certificates.GetCertSet()[i];
+        outChain.notBefore               = std::max(outChain.notBefore, cert.mNotBeforeTime);
+        if (cert.mNotAfterTime != kNullCertTime)
         {
-            *outRootPublicKey = rootPubkey;
+            outChain.notAfter =
+                (outChain.notAfter == kNullCertTime) ? cert.mNotAfterTime : std::min(outChain.notAfter, cert.mNotAfterTime);
         }
     }
 
-    outNocPubkey = certificates.GetLastCert()->mPublicKey;
-
     return CHIP_NO_ERROR;
 }
 
@@ -948,6 +1069,8 @@ CHIP_ERROR FabricTable::Delete(FabricIndex fabricIndex)
         }
     }
 
+    mVerifiedCertChainCache.Invalidate(fabricIndex);
+
     FabricInfo * fabricInfo = GetMutableFabricByIndex(fabricIndex);
     if (fabricInfo == &mPendingFabric)
     {
@@ -958,7 +1081,12 @@ CHIP_ERROR FabricTable::Delete(FabricIndex fabricIndex)
     }
 
     bool fabricIsInitialized = fabricInfo != nullptr && fabricInfo->IsInitialized();
-    CHIP_ERROR metadataErr   = DeleteMetadataFromStorage(fabricIndex); // Delete from storage regardless
+    if (fabricIsInitialized)
+    {
+        LogErrorOnFailure(InvalidateStartupSnapshot());
+    }
+
+    CHIP_ERROR metadataErr = DeleteMetadataFromStorage(fabricIndex); // Delete from storage regardless
 
     CHIP_ERROR opKeyErr = CHIP_NO_ERROR;
     if (mOperationalKeystore != nullptr)
@@ -1006,6 +1134,7 @@ CHIP_ERROR FabricTable::Delete(FabricIndex fabricIndex)
     // read things from storage later we will realize there is nothing for this
     // index.
     StoreFabricIndexInfo();
+    LogErrorOnFailure(StoreStartupSnapshot());
 
     // If we ever start moving the FabricInfo entries around in the array on
     // delete, we should update DeleteAllFabrics to handle that.
@@ -1057,9 +1186,10 @@ CHIP_ERROR FabricTable::Init(const FabricTable::InitParams & initParams)
     VerifyOrReturnError(initParams.storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(initParams.opCertStore != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
-    mStorage             = initParams.storage;
-    mOperationalKeystore = initParams.operationalKeystore;
-    mOpCertStore         = initParams.opCertStore;
+    mStorage                  = initParams.storage;
+    mOperationalKeystore      = initParams.operationalKeystore;
+    mOpCertStore              = initParams.opCertStore;
+    mIsStartupSnapshotEnabled = initParams.enableStartupSnapshot;
 
     ChipLogDetail(FabricProvisioning, "Initializing FabricTable from persistent storage");
 
@@ -1079,28 +1209,44 @@ CHIP_ERROR FabricTable::Init(const FabricTable::InitParams & initParams)
     // this condition and can act appropriately.
     mLastKnownGoodTime.Init(mStorage);
 
-    uint8_t buf[IndexInfoTLVMaxSize()];
-    uint16_t size  = sizeof(buf);
-    CHIP_ERROR err = mStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::FabricIndexInfo().KeyName(), buf, size);
-    if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    CHIP_ERROR err = CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+    if (mIsStartupSnapshotEnabled)
     {
-        // No fabrics yet.  Nothing to be done here.
+        err = LoadFromStartupSnapshot();
     }
-    else
+    else if (mStorage->SyncDoesKeyExist(DefaultStorageKeyAllocator::FabricTableSnapshot().KeyName()))
     {
-        ReturnErrorOnFailure(err);
-        TLV::ContiguousBufferTLVReader reader;
-        reader.Init(buf, size);
+        // Left over by a previous run that had the snapshot enabled: it would not track the changes made from now on.
+        mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::FabricTableSnapshot().KeyName());
+    }
 
-        // TODO: A safer way would be to just clean-up the entire fabric table on this situation...
-        err = ReadFabricInfo(reader);
-        if (err != CHIP_NO_ERROR)
+    if (err != CHIP_NO_ERROR)
+    {
+        uint8_t buf[IndexInfoTLVMaxSize()];
+        uint16_t size = sizeof(buf);
+        err           = mStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::FabricIndexInfo().KeyName(), buf, size);
+        if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
         {
-            ChipLogError(FabricProvisioning, "Error loading fabric table: %" CHIP_ERROR_FORMAT ", we are in a bad state!",
-                         err.Format());
+            // No fabrics yet.  Nothing to be done here.
         }
+        else
+        {
+            ReturnErrorOnFailure(err);
+            TLV::ContiguousBufferTLVReader reader;
+            reader.Init(buf, size);
+
+            // TODO: A safer way would be to just clean-up the entire fabric table on this situation...
+            err = ReadFabricInfo(reader);
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(FabricProvisioning, "Error loading fabric table: %" CHIP_ERROR_FORMAT ", we are in a bad state!",
+                             err.Format());
+            }
 
-        ReturnErrorOnFailure(err);
+            ReturnErrorOnFailure(err);
+        }
+
+        LogErrorOnFailure(StoreStartupSnapshot());
     }
 
     CommitMarker commitMarker;
@@ -1135,6 +1281,7 @@ void FabricTable::Forget(FabricIndex fabricIndex)
 
     RevertPendingFabricData();
     fabricInfo->Reset();
+    mVerifiedCertChainCache.Invalidate(fabricIndex);
 }
 
 void FabricTable::Shutdown()
@@ -1158,6 +1305,7 @@ void FabricTable::Shutdown()
         // direct lookups fail.
         fabricInfo.Reset();
     }
+    mVerifiedCertChainCache.InvalidateAll();
 
     mStorage = nullptr;
 }
@@ -1411,6 +1559,140 @@ CHIP_ERROR FabricTable::ReadFabricInfo(TLV::ContiguousBufferTLVReader & reader)
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR FabricTable::LoadFromStartupSnapshot()
+{
+    static_assert(StartupSnapshotTLVMaxSize() <= UINT16_MAX, "Startup snapshot does not fit in a single storage entry");
+    VerifyOrReturnError(mIsStartupSnapshotEnabled, CHIP_ERROR_INCORRECT_STATE);
+
+    Platform::ScopedMemoryBuffer<uint8_t> buf;
+    VerifyOrReturnError(buf.Alloc(StartupSnapshotTLVMaxSize()), CHIP_ERROR_NO_MEMORY);
+
+    uint16_t size  = static_cast<uint16_t>(StartupSnapshotTLVMaxSize());
+    CHIP_ERROR err = mStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::FabricTableSnapshot().KeyName(), buf.Get(), size);
+    if (err == CHIP_NO_ERROR)
+    {
+        TLV::ContiguousBufferTLVReader reader;
+        reader.Init(buf.Get(), size);
+        err = ReadStartupSnapshot(reader);
+    }
+
+    if (err == CHIP_NO_ERROR)
+    {
+        ChipLogProgress(FabricProvisioning, "Loaded %u fabrics from the fabric table snapshot",
+                        static_cast<unsigned>(mFabricCount));
+        return CHIP_NO_ERROR;
+    }
+
+    if (err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        ChipLogError(FabricProvisioning, "Ignoring fabric table snapshot: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    // Start over from a clean table, to be loaded from storage.
+    mFabricCount = 0;
+    for (auto & fabric : mStates)
+    {
+        fabric.Reset();
+    }
+    mNextAvailableFabricIndex.SetValue(kMinValidFabricIndex);
+    return err;
+}
+
+CHIP_ERROR FabricTable::ReadStartupSnapshot(TLV::ContiguousBufferTLVReader & reader)
+{
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+    TLV::TLVType containerType;
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+
+    ReturnErrorOnFailure(reader.Next(kNextAvailableFabricIndexTag));
+    if (reader.GetType() == TLV::kTLVType_Null)
+    {
+        mNextAvailableFabricIndex.ClearValue();
+    }
+    else
+    {
+        ReturnErrorOnFailure(reader.Get(mNextAvailableFabricIndex.Emplace()));
+    }
+
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Array, kSnapshotFabricsTag));
+    TLV::TLVType arrayType;
+    ReturnErrorOnFailure(reader.EnterContainer(arrayType));
+
+    CHIP_ERROR err;
+    while ((err = reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag())) == CHIP_NO_ERROR)
+    {
+        VerifyOrReturnError(mFabricCount < ArraySize(mStates), CHIP_ERROR_NO_MEMORY);
+        ReturnErrorOnFailure(mStates[mFabricCount].LoadFromSnapshot(reader));
+        ++mFabricCount;
+    }
+
+    if (err != CHIP_END_OF_TLV)
+    {
+        return err;
+    }
+
+    ReturnErrorOnFailure(reader.ExitContainer(arrayType));
+
+    ReturnErrorOnFailure(reader.ExitContainer(containerType));
+    ReturnErrorOnFailure(reader.VerifyEndOfContainer());
+
+    EnsureNextAvailableFabricIndexUpdated();
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FabricTable::StoreStartupSnapshot() const
+{
+    VerifyOrReturnError(mIsStartupSnapshotEnabled, CHIP_NO_ERROR);
+
+    Platform::ScopedMemoryBuffer<uint8_t> buf;
+    VerifyOrReturnError(buf.Alloc(StartupSnapshotTLVMaxSize()), CHIP_ERROR_NO_MEMORY);
+
+    TLV::TLVWriter writer;
+    writer.Init(buf.Get(), StartupSnapshotTLVMaxSize());
+
+    TLV::TLVType outerType;
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType));
+
+    if (mNextAvailableFabricIndex.HasValue())
+    {
+        ReturnErrorOnFailure(writer.Put(kNextAvailableFabricIndexTag, mNextAvailableFabricIndex.Value()));
+    }
+    else
+    {
+        ReturnErrorOnFailure(writer.PutNull(kNextAvailableFabricIndexTag));
+    }
+
+    TLV::TLVType innerContainerType;
+    ReturnErrorOnFailure(writer.StartContainer(kSnapshotFabricsTag, TLV::kTLVType_Array, innerContainerType));
+    for (const auto & fabric : mStates)
+    {
+        // A fabric being added is only part of the snapshot once committed.
+        bool isPendingAddition =
+            mStateFlags.Has(StateFlags::kIsAddPending) && (fabric.GetFabricIndex() == mFabricIndexWithPendingState);
+        if (fabric.IsInitialized() && !isPendingAddition)
+        {
+            ReturnErrorOnFailure(fabric.SerializeToSnapshot(writer));
+        }
+    }
+    ReturnErrorOnFailure(writer.EndContainer(innerContainerType));
+    ReturnErrorOnFailure(writer.EndContainer(outerType));
+
+    const auto snapshotLength = writer.GetLengthWritten();
+    VerifyOrReturnError(CanCastTo<uint16_t>(snapshotLength), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    return mStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::FabricTableSnapshot().KeyName(), buf.Get(),
+                                     static_cast<uint16_t>(snapshotLength));
+}
+
+CHIP_ERROR FabricTable::InvalidateStartupSnapshot()
+{
+    VerifyOrReturnError(mIsStartupSnapshotEnabled, CHIP_NO_ERROR);
+
+    CHIP_ERROR err = mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::FabricTableSnapshot().KeyName());
+    return (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ? CHIP_NO_ERROR : err;
+}
+
 Crypto::P256Keypair * FabricTable::AllocateEphemeralKeypairForCASE()
 {
     if (mOperationalKeystore != nullptr)
@@ -1809,6 +2091,7 @@ CHIP_ERROR FabricTable::CommitPendingFabricData()
     bool hasInvalidInternalState = hasPending && (!IsValidFabricIndex(mFabricIndexWithPendingState) || !(isAdding || isUpdating));
 
     FabricIndex fabricIndexBeingCommitted = mFabricIndexWithPendingState;
+    mVerifiedCertChainCache.Invalidate(fabricIndexBeingCommitted);
 
     // Proceed with Update/Add pre-flight checks
     if (hasPending && !hasInvalidInternalState)
@@ -1892,6 +2175,9 @@ CHIP_ERROR FabricTable::CommitPendingFabricData()
     }
 
     // ==== Start of actual commit transaction after pre-flight checks ====
+    // The snapshot no longer matches storage from here on, so it has to go first.
+    ReturnErrorOnFailure(InvalidateStartupSnapshot());
+
     CHIP_ERROR stickyError  = StoreCommitMarker(CommitMarker{ fabricIndexBeingCommitted, isAdding });
     bool failedCommitMarker = (stickyError != CHIP_NO_ERROR);
     if (failedCommitMarker)
@@ -2021,6 +2307,8 @@ CHIP_ERROR FabricTable::CommitPendingFabricData()
     // did their job.
     ClearCommitMarker();
 
+    LogErrorOnFailure(StoreStartupSnapshot());
+
     return stickyError;
 }
 
@@ -2043,6 +2331,7 @@ void FabricTable::RevertPendingFabricData()
 
     mLastKnownGoodTime.RevertPendingLastKnownGoodChipEpochTime();
 
+    mVerifiedCertChainCache.Invalidate(mFabricIndexWithPendingState);
     mStateFlags.ClearAll();
     mFabricIndexWithPendingState = kUndefinedFabricIndex;
 }
@@ -2094,7 +2383,9 @@ CHIP_ERROR FabricTable::SetFabricLabel(FabricIndex fabricIndex, const CharSpan &
     if (!mStateFlags.HasAny(StateFlags::kIsAddPending, StateFlags::kIsUpdatePending) && (fabricInfo != &mPendingFabric))
     {
         // Nothing is pending, we have to store immediately.
+        ReturnErrorOnFailure(InvalidateStartupSnapshot());
         ReturnErrorOnFailure(StoreFabricMetadata(fabricInfo));
+        LogErrorOnFailure(StoreStartupSnapshot());
     }
 
     return CHIP_NO_ERROR;
@@ -29,6 +29,7 @@
 #include <credentials/CertificateValidityPolicy.h>
 #include <credentials/LastKnownGoodTime.h>
 #include <credentials/OperationalCertificateStore.h>
+#include <credentials/VerifiedCertChainCache.h>
 #include <crypto/CHIPCryptoPAL.h>
 #include <crypto/OperationalKeystore.h>
 #include <lib/core/CHIPEncoding.h>
@@ -246,9 +247,19 @@ private:
 
     mutable Crypto::P256Keypair * mOperationalKey = nullptr;
 
+    static constexpr size_t SnapshotTLVMaxSize()
+    {
+        return TLV::EstimateStructOverhead(sizeof(FabricIndex), sizeof(NodeId), sizeof(FabricId), sizeof(CompressedFabricId),
+                                           Crypto::kP256_PublicKey_Length, sizeof(uint16_t), kFabricLabelMaxLengthInBytes);
+    }
+
     CHIP_ERROR CommitToStorage(PersistentStorageDelegate * storage) const;
     CHIP_ERROR LoadFromStorage(PersistentStorageDelegate * storage, FabricIndex newFabricIndex, const ByteSpan & rcac,
                                const ByteSpan & noc);
+
+    // Write/read all the fields above, except the operational key, as an anonymous structure of a FabricTable snapshot.
+    CHIP_ERROR SerializeToSnapshot(TLV::TLVWriter & writer) const;
+    CHIP_ERROR LoadFromSnapshot(TLV::ContiguousBufferTLVReader & reader);
 };
 
 /**
@@ -360,6 +371,10 @@ public:
         Crypto::OperationalKeystore * operationalKeystore = nullptr;
         // Operational Certificate store to hold the NOC/ICAC/RCAC chains (MANDATORY).
         Credentials::OperationalCertificateStore * opCertStore = nullptr;
+        // If true, the FabricInfo of all committed fabrics is also kept in a single storage entry, rewritten
+        // whenever they change, so that Init does not have to read and decode the certificates and metadata of
+        // every fabric.  Worth it for controllers holding many fabrics; costs one more storage write per change.
+        bool enableStartupSnapshot = false;
     };
 
     class DLL_EXPORT Delegate
@@ -950,11 +965,29 @@ public:
                                  FabricId & outFabricId, NodeId & outNodeId, Crypto::P256PublicKey & outNocPubkey,
                                  Crypto::P256PublicKey * outRootPublicKey = nullptr) const;
 
+    // Verifies credentials, using the root certificate of the provided fabric index. A chain that was verified before with an
+    // equivalent context is served from the verified chain cache, without decoding or verifying its certificates again.
+    CHIP_ERROR VerifyCredentials(FabricIndex fabricIndex, const ByteSpan & noc, const ByteSpan & icac,
+                                 Credentials::ValidationContext & context,
+                                 Credentials::VerifiedCertChainCache::VerifiedChain & outChain) const;
+
     // Verifies credentials, using the provided root certificate.
     static CHIP_ERROR VerifyCredentials(const ByteSpan & noc, const ByteSpan & icac, const ByteSpan & rcac,
                                         Credentials::ValidationContext & context, CompressedFabricId & outCompressedFabricId,
                                         FabricId & outFabricId, NodeId & outNodeId, Crypto::P256PublicKey & outNocPubkey,
                                         Crypto::P256PublicKey * outRootPublicKey = nullptr);
+
+    // Verifies credentials, using the provided root certificate. Never uses the verified chain cache.
+    static CHIP_ERROR VerifyCredentials(const ByteSpan & noc, const ByteSpan & icac, const ByteSpan & rcac,
+                                        Credentials::ValidationContext & context,
+                                        Credentials::VerifiedCertChainCache::VerifiedChain & outChain);
+
+    /**
+     * @brief Cache of the peer certificate chains verified with VerifyCredentials, cleared for a fabric whenever
+     *        that fabric changes. Its hit and miss counters tell how many chain validations were avoided.
+     */
+    Credentials::VerifiedCertChainCache & GetVerifiedCertChainCache() const { return mVerifiedCertChainCache; }
+
     /**
      * @brief Enables FabricInfo instances to collide and reference the same logical fabric (i.e Root Public Key + FabricId).
      *
@@ -1161,6 +1194,23 @@ private:
      */
     CHIP_ERROR ReadFabricInfo(TLV::ContiguousBufferTLVReader & reader);
 
+    /**
+     * Startup snapshot management, all no-ops unless InitParams::enableStartupSnapshot was set.
+     *
+     * The snapshot is removed before any change to the stored fabrics, and written again once the change is
+     * complete, so that a reboot in between falls back to loading everything from storage.
+     */
+    static constexpr size_t StartupSnapshotTLVMaxSize()
+    {
+        // Same layout as the index info, with a structure per fabric instead of its index.
+        return TLV::EstimateStructOverhead(sizeof(FabricIndex), CHIP_CONFIG_MAX_FABRICS * FabricInfo::SnapshotTLVMaxSize() + 1);
+    }
+
+    CHIP_ERROR LoadFromStartupSnapshot();
+    CHIP_ERROR ReadStartupSnapshot(TLV::ContiguousBufferTLVReader & reader);
+    CHIP_ERROR StoreStartupSnapshot() const;
+    CHIP_ERROR InvalidateStartupSnapshot();
+
     CHIP_ERROR NotifyFabricUpdated(FabricIndex fabricIndex);
     CHIP_ERROR NotifyFabricCommitted(FabricIndex fabricIndex);
 
@@ -1188,11 +1238,16 @@ private:
 
     LastKnownGoodTime mLastKnownGoodTime;
 
+    // Mutable since looking a chain up updates its recency and the hit/miss counters.
+    mutable Credentials::VerifiedCertChainCache mVerifiedCertChainCache;
+
     // We may not have an mNextAvailableFabricIndex if our table is as large as
     // it can go and is full.
     Optional<FabricIndex> mNextAvailableFabricIndex;
     uint8_t mFabricCount = 0;
 
+    bool mIsStartupSnapshotEnabled = false;
+
     BitFlags<StateFlags> mStateFlags;
 };
 
@@ -0,0 +1,166 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <credentials/VerifiedCertChainCache.h>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace Credentials {
+
+namespace {
+
+CHIP_ERROR AddLengthPrefixed(Crypto::Hash_SHA256_stream & hash, const ByteSpan & data)
+{
+    uint8_t length[sizeof(uint32_t)];
+    Encoding::LittleEndian::Put32(length, static_cast<uint32_t>(data.size()));
+    ReturnErrorOnFailure(hash.AddData(ByteSpan(length)));
+    return hash.AddData(data);
+}
+
+} // namespace
+
+CHIP_ERROR VerifiedCertChainCache::ComputeDigest(const ByteSpan & noc, const ByteSpan & icac, const ByteSpan & rcac,
+                                                 const ValidationContext & context, Digest & outDigest)
+{
+    uint8_t requirements[sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint8_t)];
+    Encoding::LittleEndian::Put16(&requirements[0], context.mRequiredKeyUsages.Raw());
+    requirements[2] = context.mRequiredKeyPurposes.Raw();
+    requirements[3] = to_underlying(context.mRequiredCertType);
+
+    Crypto::Hash_SHA256_stream hash;
+    ReturnErrorOnFailure(hash.Begin());
+    ReturnErrorOnFailure(hash.AddData(ByteSpan(requirements)));
+    ReturnErrorOnFailure(AddLengthPrefixed(hash, noc));
+    ReturnErrorOnFailure(AddLengthPrefixed(hash, icac));
+    ReturnErrorOnFailure(AddLengthPrefixed(hash, rcac));
+
+    MutableByteSpan digestSpan(outDigest.data(), outDigest.size());
+    return hash.Finish(digestSpan);
+}
+
+bool VerifiedCertChainCache::Find(FabricIndex fabricIndex, const Digest & digest, const ValidationContext & context,
+                                  VerifiedChain & outChain)
+{
+    TimeSource timeSource = GetTimeSource(context);
+    for (size_t i = 0; i < kCapacity; i++)
+    {
+        Entry & entry = mEntries[i];
+        if (entry.fabricIndex != fabricIndex || fabricIndex == kUndefinedFabricIndex || entry.digest != digest)
+        {
+            continue;
+        }
+
+        if (entry.validityPolicy != context.mValidityPolicy || entry.timeSource != timeSource ||
+            !IsWithinValidity(entry.chain, context))
+        {
+            // The chain may still be valid, but not for the same reasons it was validated: check it again.
+            break;
+        }
+
+        entry.lastUsed = ++mUseCounter;
+        outChain       = entry.chain;
+        mHitCount++;
+        return true;
+    }
+
+    mMissCount++;
+    return false;
+}
+
+void VerifiedCertChainCache::Add(FabricIndex fabricIndex, const Digest & digest, const ValidationContext & context,
+                                 const VerifiedChain & chain)
+{
+    VerifyOrReturn(kCapacity > 0 && fabricIndex != kUndefinedFabricIndex);
+    VerifyOrReturn(IsWithinValidity(chain, context));
+
+    Entry * slot = &mEntries[0];
+    for (size_t i = 0; i < kCapacity; i++)
+    {
+        Entry & entry = mEntries[i];
+        if (entry.fabricIndex == fabricIndex && entry.digest == digest)
+        {
+            slot = &entry;
+            break;
+        }
+        // Free entries were never used, so they are picked before the least recently used one.
+        if (entry.lastUsed < slot->lastUsed)
+        {
+            slot = &entry;
+        }
+    }
+
+    slot->digest         = digest;
+    slot->chain          = chain;
+    slot->validityPolicy = context.mValidityPolicy;
+    slot->timeSource     = GetTimeSource(context);
+    slot->fabricIndex    = fabricIndex;
+    slot->lastUsed       = ++mUseCounter;
+}
+
+void VerifiedCertChainCache::Invalidate(FabricIndex fabricIndex)
+{
+    for (size_t i = 0; i < kCapacity; i++)
+    {
+        if (mEntries[i].fabricIndex == fabricIndex)
+        {
+            mEntries[i] = Entry();
+        }
+    }
+}
+
+void VerifiedCertChainCache::InvalidateAll()
+{
+    for (size_t i = 0; i < kCapacity; i++)
+    {
+        mEntries[i] = Entry();
+    }
+}
+
+VerifiedCertChainCache::TimeSource VerifiedCertChainCache::GetTimeSource(const ValidationContext & context)
+{
+    if (context.mEffectiveTime.Is<CurrentChipEpochTime>())
+    {
+        return TimeSource::kCurrentTime;
+    }
+    if (context.mEffectiveTime.Is<LastKnownGoodChipEpochTime>())
+    {
+        return TimeSource::kLastKnownGoodTime;
+    }
+    return TimeSource::kNone;
+}
+
+bool VerifiedCertChainCache::IsWithinValidity(const VerifiedChain & chain, const ValidationContext & context)
+{
+    // Mirrors the period checks of ChipCertificateSet::ValidateCert(), applied to the intersection of the periods of the chain.
+    if (context.mEffectiveTime.Is<CurrentChipEpochTime>())
+    {
+        uint32_t now = context.mEffectiveTime.Get<CurrentChipEpochTime>().count();
+        return now >= chain.notBefore && (chain.notAfter == kNullCertTime || now <= chain.notAfter);
+    }
+    if (context.mEffectiveTime.Is<LastKnownGoodChipEpochTime>())
+    {
+        uint32_t lastKnownGood = context.mEffectiveTime.Get<LastKnownGoodChipEpochTime>().count();
+        return chain.notAfter == kNullCertTime || lastKnownGood <= chain.notAfter;
+    }
+    return true;
+}
+
+} // namespace Credentials
+} // namespace chip
@@ -0,0 +1,136 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @brief Defines a bounded cache of operational certificate chains that passed validation.
+ */
+
+#pragma once
+
+#include <credentials/CHIPCert.h>
+#include <credentials/CHIPCertificateSet.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CASEAuthTag.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/NodeId.h>
+#include <lib/support/Span.h>
+
+#include <array>
+
+namespace chip {
+namespace Credentials {
+
+/**
+ * Remembers the outcome of validating an operational certificate chain (NOC, optional ICAC, RCAC), so that a peer that
+ * establishes CASE again with the same chain does not cost a decode and signature verification of every certificate.
+ *
+ * Entries are keyed by a SHA-256 digest over the chain and the validation requirements of the ValidationContext.  An entry
+ * only matches a context using the same validity policy and the same kind of effective time, and only while the effective
+ * time is within the validity period of every certificate of the chain: the policy is then consulted with exactly the
+ * same validity results as when the chain was validated, so validity policies are expected to decide on those results
+ * and on the certificate alone.  The ValidationContext trust anchor is not set when a chain is found in the cache.
+ *
+ * The least recently used entry is evicted when the cache is full.  The fabric table invalidates the entries of a fabric
+ * whenever that fabric changes.
+ */
+class VerifiedCertChainCache
+{
+public:
+    using Digest = std::array<uint8_t, Crypto::kSHA256_Hash_Length>;
+
+    static constexpr size_t kCapacity = CHIP_CONFIG_VERIFIED_CERT_CHAIN_CACHE_SIZE;
+
+    /// Everything CASE needs from a validated chain.
+    struct VerifiedChain
+    {
+        CompressedFabricId compressedFabricId = kUndefinedCompressedFabricId;
+        FabricId fabricId                     = kUndefinedFabricId;
+        NodeId nodeId                         = kUndefinedNodeId;
+        Crypto::P256PublicKey nocPublicKey;
+        Crypto::P256PublicKey rootPublicKey;
+        CATValues cats;
+
+        // Intersection of the validity periods of the certificates of the chain, in CHIP epoch seconds.  A notAfter of
+        // kNullCertTime means that the chain does not expire.
+        uint32_t notBefore = 0;
+        uint32_t notAfter  = kNullCertTime;
+    };
+
+    /**
+     * Computes the cache key of a chain validated with the given context.
+     */
+    static CHIP_ERROR ComputeDigest(const ByteSpan & noc, const ByteSpan & icac, const ByteSpan & rcac,
+                                    const ValidationContext & context, Digest & outDigest);
+
+    /**
+     * Looks up a chain of the given fabric that was validated before, and counts a hit or a miss.
+     *
+     * @return true if outChain was filled from the cache, false if the chain must be validated.
+     */
+    bool Find(FabricIndex fabricIndex, const Digest & digest, const ValidationContext & context, VerifiedChain & outChain);
+
+    /**
+     * Records a chain that was just successfully validated with the given context.  Chains that were only accepted because
+     * the validity policy tolerated an invalid period are not recorded.
+     */
+    void Add(FabricIndex fabricIndex, const Digest & digest, const ValidationContext & context, const VerifiedChain & chain);
+
+    /// Drops the entries of the given fabric.
+    void Invalidate(FabricIndex fabricIndex);
+
+    /// Drops every entry.
+    void InvalidateAll();
+
+    uint32_t GetHitCount() const { return mHitCount; }
+    uint32_t GetMissCount() const { return mMissCount; }
+    void ResetCounters()
+    {
+        mHitCount  = 0;
+        mMissCount = 0;
+    }
+
+private:
+    enum class TimeSource : uint8_t
+    {
+        kNone,
+        kCurrentTime,
+        kLastKnownGoodTime,
+    };
+
+    struct Entry
+    {
+        Digest digest;
+        VerifiedChain chain;
+        const CertificateValidityPolicy * validityPolicy = nullptr;
+        uint32_t lastUsed                                = 0;
+        FabricIndex fabricIndex                          = kUndefinedFabricIndex;
+        TimeSource timeSource                            = TimeSource::kNone;
+    };
+
+    static TimeSource GetTimeSource(const ValidationContext & context);
+    static bool IsWithinValidity(const VerifiedChain & chain, const ValidationContext & context);
+
+    Entry mEntries[kCapacity > 0 ? kCapacity : 1];
+    uint32_t mUseCounter = 0;
+    uint32_t mHitCount   = 0;
+    uint32_t mMissCount  = 0;
+};
+
+} // namespace Credentials
+} // namespace chip
@@ -0,0 +1,135 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @brief Defines a bounded cache of the results of device attestation checks that do not depend on the device.
+ */
+
+#pragma once
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+
+#include <array>
+
+namespace chip {
+namespace Credentials {
+
+/**
+ * Remembers values derived from a verified input, such as a PAI certificate or a certification declaration, keyed by
+ * the SHA-256 digest of that input.  Devices of a production run share their PAI and certification declaration, so
+ * that the verifier only needs to check them for the first device.
+ *
+ * The least recently used entry is evicted when the cache is full.
+ */
+template <typename Value, size_t kCapacity>
+class AttestationVerificationCache
+{
+public:
+    using Digest = std::array<uint8_t, Crypto::kSHA256_Hash_Length>;
+
+    static CHIP_ERROR ComputeDigest(const ByteSpan & input, Digest & outDigest)
+    {
+        return Crypto::Hash_SHA256(input.data(), input.size(), outDigest.data());
+    }
+
+    /**
+     * Looks up the value recorded for an input, and counts a hit or a miss.
+     *
+     * @return true if outValue was filled from the cache.
+     */
+    bool Find(const Digest & digest, Value & outValue)
+    {
+        for (Entry & entry : mEntries)
+        {
+            if (entry.lastUsed != 0 && entry.digest == digest)
+            {
+                entry.lastUsed = ++mUseCounter;
+                outValue       = entry.value;
+                mHitCount++;
+                return true;
+            }
+        }
+
+        mMissCount++;
+        return false;
+    }
+
+    /**
+     * Records the value of an input that was just verified.
+     */
+    void Add(const Digest & digest, const Value & value)
+    {
+        VerifyOrReturn(kCapacity > 0);
+
+        Entry * slot = &mEntries[0];
+        for (Entry & entry : mEntries)
+        {
+            if (entry.lastUsed != 0 && entry.digest == digest)
+            {
+                slot = &entry;
+                break;
+            }
+            // Free entries were never used, so they are picked before the least recently used one.
+            if (entry.lastUsed < slot->lastUsed)
+            {
+                slot = &entry;
+            }
+        }
+
+        slot->digest   = digest;
+        slot->value    = value;
+        slot->lastUsed = ++mUseCounter;
+    }
+
+    /// Drops every entry.
+    void InvalidateAll()
+    {
+        for (Entry & entry : mEntries)
+        {
+            entry = Entry();
+        }
+    }
+
+    uint32_t GetHitCount() const { return mHitCount; }
+    uint32_t GetMissCount() const { return mMissCount; }
+    void ResetCounters()
+    {
+        mHitCount  = 0;
+        mMissCount = 0;
+    }
+
+private:
+    struct Entry
+    {
+        Digest digest;
+        Value value;
+        // 0 for a free entry.
+        uint32_t lastUsed = 0;
+    };
+
+    Entry mEntries[kCapacity > 0 ? kCapacity : 1];
+    uint32_t mUseCounter = 0;
+    uint32_t mHitCount   = 0;
+    uint32_t mMissCount  = 0;
+};
+
+} // namespace Credentials
+} // namespace chip
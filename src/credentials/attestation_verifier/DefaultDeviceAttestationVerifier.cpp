@@ -24,12 +24,17 @@
 #include <credentials/attestation_verifier/TestPAAStore.h>
 #include <crypto/CHIPCryptoPAL.h>
 
+#include <lib/asn1/ASN1.h>
+#include <lib/asn1/ASN1Macros.h>
 #include <lib/core/CHIPError.h>
 #include <lib/core/Global.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/ScopedBuffer.h>
 #include <lib/support/Span.h>
 
+#include <algorithm>
+
+using namespace chip::ASN1;
 using namespace chip::Crypto;
 using chip::TestCerts::GetTestPaaRootStore;
 
@@ -308,6 +313,150 @@ AttestationVerificationResult MapError(CertificateChainValidationResult certific
         return AttestationVerificationResult::kInternalError;
     }
 }
+
+// Parts of an X.509 certificate used to check that a DAC was issued by an already verified PAI.
+struct X509CertParts
+{
+    ByteSpan tbs;
+    ByteSpan issuer;
+    ByteSpan subject;
+    ASN1UniversalTime notBefore;
+    ASN1UniversalTime notAfter;
+    // DER encoded Ecdsa-Sig-Value
+    ByteSpan signature;
+};
+
+CHIP_ERROR ParseX509Cert(const ByteSpan & cert, X509CertParts & parts)
+{
+    CHIP_ERROR err;
+    ASN1Reader reader;
+    OID sigAlgoOID;
+    const uint8_t * tbsStart;
+
+    reader.Init(cert);
+
+    // Certificate ::= SEQUENCE
+    ASN1_PARSE_ANY;
+    tbsStart = reader.GetValue();
+    ASN1_ENTER_SEQUENCE
+    {
+        // tbsCertificate TBSCertificate,
+        // TBSCertificate ::= SEQUENCE
+        ASN1_PARSE_ANY;
+        parts.tbs = ByteSpan(tbsStart, static_cast<size_t>(reader.GetValue() + reader.GetValueLen() - tbsStart));
+        ASN1_ENTER_SEQUENCE
+        {
+            // version [0] EXPLICIT Version DEFAULT v1
+            ASN1_PARSE_ELEMENT(kASN1TagClass_ContextSpecific, 0);
+
+            // serialNumber CertificateSerialNumber
+            ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_Integer);
+
+            // signature AlgorithmIdentifier
+            ASN1_PARSE_ENTER_SEQUENCE
+            {
+                ASN1_PARSE_OBJECT_ID(sigAlgoOID);
+                VerifyOrExit(sigAlgoOID == kOID_SigAlgo_ECDSAWithSHA256, err = ASN1_ERROR_UNSUPPORTED_ENCODING);
+            }
+            ASN1_SKIP_AND_EXIT_SEQUENCE;
+
+            // issuer Name
+            ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_Sequence);
+            parts.issuer = ByteSpan(reader.GetValue(), reader.GetValueLen());
+
+            // validity Validity
+            ASN1_PARSE_ENTER_SEQUENCE
+            {
+                ASN1_PARSE_TIME(parts.notBefore);
+                ASN1_PARSE_TIME(parts.notAfter);
+            }
+            ASN1_EXIT_SEQUENCE;
+
+            // subject Name
+            ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_Sequence);
+            parts.subject = ByteSpan(reader.GetValue(), reader.GetValueLen());
+        }
+        ASN1_SKIP_AND_EXIT_SEQUENCE;
+
+        // signatureAlgorithm AlgorithmIdentifier
+        ASN1_PARSE_ENTER_SEQUENCE
+        {
+            ASN1_PARSE_OBJECT_ID(sigAlgoOID);
+            VerifyOrExit(sigAlgoOID == kOID_SigAlgo_ECDSAWithSHA256, err = ASN1_ERROR_UNSUPPORTED_ENCODING);
+        }
+        ASN1_SKIP_AND_EXIT_SEQUENCE;
+
+        // signatureValue BIT STRING
+        ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_BitString);
+        VerifyOrExit(reader.GetValueLen() > 1 && reader.GetValue()[0] == 0, err = ASN1_ERROR_INVALID_ENCODING);
+        parts.signature = ByteSpan(reader.GetValue() + 1, reader.GetValueLen() - 1);
+    }
+    ASN1_EXIT_SEQUENCE;
+
+exit:
+    return err;
+}
+
+// Orders ASN.1 times, which may be out of the range of CHIP epoch times.
+uint64_t PackTime(const ASN1UniversalTime & time)
+{
+    return (static_cast<uint64_t>(time.Year) << 40) | (static_cast<uint64_t>(time.Month) << 32) |
+        (static_cast<uint64_t>(time.Day) << 24) | (static_cast<uint64_t>(time.Hour) << 16) |
+        (static_cast<uint64_t>(time.Minute) << 8) | time.Second;
+}
+
+CHIP_ERROR MakeVerifiedPai(const ByteSpan & pai, const ByteSpan & paa, const AttestationCertVidPid & paiVidPid,
+                           const AttestationCertVidPid & paaVidPid, const ByteSpan & paaSKID,
+                           DefaultDACVerifier::VerifiedPai & outPai)
+{
+    X509CertParts paiParts;
+    X509CertParts paaParts;
+    ReturnErrorOnFailure(ParseX509Cert(pai, paiParts));
+    ReturnErrorOnFailure(ParseX509Cert(paa, paaParts));
+
+    MutableByteSpan paiSKID(outPai.paiSKID);
+    ReturnErrorOnFailure(ExtractSKIDFromX509Cert(pai, paiSKID));
+    VerifyOrReturnError(paiSKID.size() == sizeof(outPai.paiSKID), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(paaSKID.size() == sizeof(outPai.paaSKID), CHIP_ERROR_INVALID_ARGUMENT);
+    memcpy(outPai.paaSKID, paaSKID.data(), paaSKID.size());
+    ReturnErrorOnFailure(ExtractPubkeyFromX509Cert(pai, outPai.publicKey));
+
+    outPai.paiVidPid = paiVidPid;
+    outPai.paaVidPid = paaVidPid;
+    outPai.notBefore = std::max(PackTime(paiParts.notBefore), PackTime(paaParts.notBefore));
+    outPai.notAfter  = std::min(PackTime(paiParts.notAfter), PackTime(paaParts.notAfter));
+    return CHIP_NO_ERROR;
+}
+
+// Checks what ValidateCertificateChain() checks of the DAC, once its PAI is known to chain up to a trusted PAA.
+bool IsDacIssuedByVerifiedPai(const ByteSpan & dac, const ByteSpan & pai, const DefaultDACVerifier::VerifiedPai & verifiedPai)
+{
+    X509CertParts dacParts;
+    X509CertParts paiParts;
+    VerifyOrReturnValue(ParseX509Cert(dac, dacParts) == CHIP_NO_ERROR && ParseX509Cert(pai, paiParts) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(dacParts.issuer.data_equal(paiParts.subject), false);
+
+    // The chain is validated at the time the DAC was issued.
+    uint64_t issuedAt = PackTime(dacParts.notBefore);
+    VerifyOrReturnValue(issuedAt >= verifiedPai.notBefore && issuedAt <= verifiedPai.notAfter &&
+                            issuedAt <= PackTime(dacParts.notAfter),
+                        false);
+
+    uint8_t akidBuf[kAuthorityKeyIdentifierLength];
+    MutableByteSpan akid(akidBuf);
+    VerifyOrReturnValue(ExtractAKIDFromX509Cert(dac, akid) == CHIP_NO_ERROR && akid.data_equal(ByteSpan(verifiedPai.paiSKID)),
+                        false);
+
+    uint8_t rawSignatureBuf[kP256_ECDSA_Signature_Length_Raw];
+    MutableByteSpan rawSignature(rawSignatureBuf);
+    P256ECDSASignature signature;
+    VerifyOrReturnValue(EcdsaAsn1SignatureToRaw(kP256_FE_Length, dacParts.signature, rawSignature) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(signature.SetLength(rawSignature.size()) == CHIP_NO_ERROR, false);
+    memcpy(signature.Bytes(), rawSignature.data(), rawSignature.size());
+
+    return verifiedPai.publicKey.ECDSA_validate_msg_signature(dacParts.tbs.data(), dacParts.tbs.size(), signature) ==
+        CHIP_NO_ERROR;
+}
 } // namespace
 
 void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVerifier::AttestationInfo & info,
@@ -320,6 +469,10 @@ void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVer
     AttestationCertVidPid dacVidPid;
     AttestationCertVidPid paiVidPid;
     AttestationCertVidPid paaVidPid;
+    VerifiedPaiCache::Digest paiDigest;
+    VerifiedPai verifiedPai;
+    bool canCachePai = false;
+    bool paiVerified = false;
 
     VerifyOrExit(!info.attestationElementsBuffer.empty() && !info.attestationChallengeBuffer.empty() &&
                      !info.attestationSignatureBuffer.empty() && !info.dacDerBuffer.empty() &&
@@ -332,10 +485,24 @@ void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVer
     // Ensure PAI is present
     VerifyOrExit(!info.paiDerBuffer.empty(), attestationError = AttestationVerificationResult::kPaiMissing);
 
+    // A PAI that was already verified to chain up to a trusted PAA only leaves the DAC to check against it.  Anything
+    // unexpected about the DAC takes the full path below, which then reports the same error as without the cache.
+    canCachePai = VerifiedPaiCache::ComputeDigest(info.paiDerBuffer, paiDigest) == CHIP_NO_ERROR;
+    if (canCachePai && mVerifiedPaiCache.Find(paiDigest, verifiedPai) &&
+        IsDacIssuedByVerifiedPai(info.dacDerBuffer, info.paiDerBuffer, verifiedPai))
+    {
+        paiVerified = true;
+        paiVidPid   = verifiedPai.paiVidPid;
+        paaVidPid   = verifiedPai.paaVidPid;
+    }
+
     // Validate Proper Certificate Format
     {
-        VerifyOrExit(VerifyAttestationCertificateFormat(info.paiDerBuffer, AttestationCertType::kPAI) == CHIP_NO_ERROR,
-                     attestationError = AttestationVerificationResult::kPaiFormatInvalid);
+        if (!paiVerified)
+        {
+            VerifyOrExit(VerifyAttestationCertificateFormat(info.paiDerBuffer, AttestationCertType::kPAI) == CHIP_NO_ERROR,
+                         attestationError = AttestationVerificationResult::kPaiFormatInvalid);
+        }
         VerifyOrExit(VerifyAttestationCertificateFormat(info.dacDerBuffer, AttestationCertType::kDAC) == CHIP_NO_ERROR,
                      attestationError = AttestationVerificationResult::kDacFormatInvalid);
     }
@@ -344,8 +511,11 @@ void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVer
     {
         VerifyOrExit(ExtractVIDPIDFromX509Cert(info.dacDerBuffer, dacVidPid) == CHIP_NO_ERROR,
                      attestationError = AttestationVerificationResult::kDacFormatInvalid);
-        VerifyOrExit(ExtractVIDPIDFromX509Cert(info.paiDerBuffer, paiVidPid) == CHIP_NO_ERROR,
-                     attestationError = AttestationVerificationResult::kPaiFormatInvalid);
+        if (!paiVerified)
+        {
+            VerifyOrExit(ExtractVIDPIDFromX509Cert(info.paiDerBuffer, paiVidPid) == CHIP_NO_ERROR,
+                         attestationError = AttestationVerificationResult::kPaiFormatInvalid);
+        }
         VerifyOrExit(paiVidPid.mVendorId.HasValue() && paiVidPid.mVendorId == dacVidPid.mVendorId,
                      attestationError = AttestationVerificationResult::kDacVendorIdMismatch);
         VerifyOrExit(dacVidPid.mProductId.HasValue(), attestationError = AttestationVerificationResult::kDacProductIdMismatch);
@@ -373,6 +543,7 @@ void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVer
                      attestationError = AttestationVerificationResult::kAttestationSignatureInvalid);
     }
 
+    if (!paiVerified)
     {
         uint8_t akidBuf[Crypto::kAuthorityKeyIdentifierLength];
         MutableByteSpan akid(akidBuf);
@@ -412,11 +583,14 @@ void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVer
                  attestationError = AttestationVerificationResult::kDacExpired);
 #endif
 
-    CertificateChainValidationResult chainValidationResult;
-    VerifyOrExit(ValidateCertificateChain(paaDerBuffer.data(), paaDerBuffer.size(), info.paiDerBuffer.data(),
-                                          info.paiDerBuffer.size(), info.dacDerBuffer.data(), info.dacDerBuffer.size(),
-                                          chainValidationResult) == CHIP_NO_ERROR,
-                 attestationError = MapError(chainValidationResult));
+    if (!paiVerified)
+    {
+        CertificateChainValidationResult chainValidationResult;
+        VerifyOrExit(ValidateCertificateChain(paaDerBuffer.data(), paaDerBuffer.size(), info.paiDerBuffer.data(),
+                                              info.paiDerBuffer.size(), info.dacDerBuffer.data(), info.dacDerBuffer.size(),
+                                              chainValidationResult) == CHIP_NO_ERROR,
+                     attestationError = MapError(chainValidationResult));
+    }
 
     {
         ByteSpan certificationDeclarationSpan;
@@ -436,11 +610,25 @@ void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVer
             .paaVendorId  = paaVidPid.mVendorId.ValueOr(VendorId::NotSpecified),
         };
 
-        MutableByteSpan paaSKID(deviceInfo.paaSKID);
-        VerifyOrExit(ExtractSKIDFromX509Cert(paaDerBuffer, paaSKID) == CHIP_NO_ERROR,
-                     attestationError = AttestationVerificationResult::kPaaFormatInvalid);
-        VerifyOrExit(paaSKID.size() == sizeof(deviceInfo.paaSKID),
-                     attestationError = AttestationVerificationResult::kPaaFormatInvalid);
+        if (paiVerified)
+        {
+            memcpy(deviceInfo.paaSKID, verifiedPai.paaSKID, sizeof(deviceInfo.paaSKID));
+        }
+        else
+        {
+            MutableByteSpan paaSKID(deviceInfo.paaSKID);
+            VerifyOrExit(ExtractSKIDFromX509Cert(paaDerBuffer, paaSKID) == CHIP_NO_ERROR,
+                         attestationError = AttestationVerificationResult::kPaaFormatInvalid);
+            VerifyOrExit(paaSKID.size() == sizeof(deviceInfo.paaSKID),
+                         attestationError = AttestationVerificationResult::kPaaFormatInvalid);
+
+            // The rest only concerns this device: its PAI can be trusted for the next ones.
+            if (canCachePai &&
+                MakeVerifiedPai(info.paiDerBuffer, paaDerBuffer, paiVidPid, paaVidPid, paaSKID, verifiedPai) == CHIP_NO_ERROR)
+            {
+                mVerifiedPaiCache.Add(paiDigest, verifiedPai);
+            }
+        }
 
         VerifyOrExit(DeconstructAttestationElements(info.attestationElementsBuffer, certificationDeclarationSpan,
                                                     attestationNonceSpan, timestampDeconstructed, firmwareInfoSpan,
@@ -465,6 +653,19 @@ exit:
 AttestationVerificationResult DefaultDACVerifier::ValidateCertificationDeclarationSignature(const ByteSpan & cmsEnvelopeBuffer,
                                                                                             ByteSpan & certDeclBuffer)
 {
+    VerifiedCertificationDeclarationCache::Digest digest;
+    VerifiedCertificationDeclaration verifiedCd;
+    bool canCache = VerifiedCertificationDeclarationCache::ComputeDigest(cmsEnvelopeBuffer, digest) == CHIP_NO_ERROR;
+    if (canCache && mVerifiedCdCache.Find(digest, verifiedCd))
+    {
+        // Disallow test key if support not enabled
+        VerifyOrReturnError(!verifiedCd.signedWithTestKey || IsCdTestKeySupported(),
+                            AttestationVerificationResult::kCertificationDeclarationNoCertificateFound);
+        VerifyOrReturnError(CMS_ExtractCDContent(cmsEnvelopeBuffer, certDeclBuffer) == CHIP_NO_ERROR,
+                            AttestationVerificationResult::kCertificationDeclarationInvalidSignature);
+        return AttestationVerificationResult::kSuccess;
+    }
+
     ByteSpan kid;
     VerifyOrReturnError(CMS_ExtractKeyId(cmsEnvelopeBuffer, kid) == CHIP_NO_ERROR,
                         AttestationVerificationResult::kCertificationDeclarationNoKeyId);
@@ -482,6 +683,12 @@ AttestationVerificationResult DefaultDACVerifier::ValidateCertificationDeclarati
     VerifyOrReturnError(CMS_Verify(cmsEnvelopeBuffer, verifyingKey, certDeclBuffer) == CHIP_NO_ERROR,
                         AttestationVerificationResult::kCertificationDeclarationInvalidSignature);
 
+    if (canCache)
+    {
+        verifiedCd.signedWithTestKey = mCdKeysTrustStore.IsCdTestKey(kid);
+        mVerifiedCdCache.Add(digest, verifiedCd);
+    }
+
     return AttestationVerificationResult::kSuccess;
 }
 
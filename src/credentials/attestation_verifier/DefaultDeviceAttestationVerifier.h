@@ -17,6 +17,7 @@
 #pragma once
 
 #include <array>
+#include <credentials/attestation_verifier/AttestationVerificationCache.h>
 #include <credentials/attestation_verifier/DeviceAttestationVerifier.h>
 #include <crypto/CHIPCryptoPAL.h>
 #include <lib/core/CHIPConfig.h>
@@ -54,9 +55,38 @@ protected:
     size_t mNumTrustedKeys = 0;
 };
 
+/**
+ * Device attestation verifier implementing the checks of the specification.
+ *
+ * The PAIs that chain up to a PAA of the trust store, and the certification declarations with a valid signature, are
+ * remembered in bounded caches: once the first device of a production run is verified, the other devices sharing its PAI
+ * and certification declaration only cost the verification of their DAC signature, attestation signature and nonce.
+ */
 class DefaultDACVerifier : public DeviceAttestationVerifier
 {
 public:
+    // What the verification of a DAC needs from its PAI and PAA, once the PAI was verified to chain up to the PAA.
+    struct VerifiedPai
+    {
+        Crypto::P256PublicKey publicKey;
+        Crypto::AttestationCertVidPid paiVidPid;
+        Crypto::AttestationCertVidPid paaVidPid;
+        uint8_t paiSKID[Crypto::kSubjectKeyIdentifierLength];
+        uint8_t paaSKID[Crypto::kSubjectKeyIdentifierLength];
+        // Intersection of the validity periods of the PAI and PAA, which must contain the notBefore time of the DAC.
+        uint64_t notBefore = 0;
+        uint64_t notAfter  = 0;
+    };
+
+    struct VerifiedCertificationDeclaration
+    {
+        bool signedWithTestKey = false;
+    };
+
+    using VerifiedPaiCache = AttestationVerificationCache<VerifiedPai, CHIP_CONFIG_DAC_VERIFIER_PAI_CACHE_SIZE>;
+    using VerifiedCertificationDeclarationCache =
+        AttestationVerificationCache<VerifiedCertificationDeclaration, CHIP_CONFIG_DAC_VERIFIER_CD_CACHE_SIZE>;
+
     DefaultDACVerifier(const AttestationTrustStore * paaRootStore) : mAttestationTrustStore(paaRootStore) {}
 
     void VerifyAttestationInformation(const DeviceAttestationVerifier::AttestationInfo & info,
@@ -79,11 +109,26 @@ public:
 
     CsaCdKeysTrustStore * GetCertificationDeclarationTrustStore() override { return &mCdKeysTrustStore; }
 
+    /**
+     * Forgets the PAIs and certification declarations verified so far.  Must be called when the content of the
+     * AttestationTrustStore changes.
+     */
+    void ClearVerificationCaches()
+    {
+        mVerifiedPaiCache.InvalidateAll();
+        mVerifiedCdCache.InvalidateAll();
+    }
+
+    VerifiedPaiCache & GetVerifiedPaiCache() { return mVerifiedPaiCache; }
+    VerifiedCertificationDeclarationCache & GetVerifiedCertificationDeclarationCache() { return mVerifiedCdCache; }
+
 protected:
     DefaultDACVerifier() {}
 
     CsaCdKeysTrustStore mCdKeysTrustStore;
     const AttestationTrustStore * mAttestationTrustStore;
+    VerifiedPaiCache mVerifiedPaiCache;
+    VerifiedCertificationDeclarationCache mVerifiedCdCache;
 };
 
 /**
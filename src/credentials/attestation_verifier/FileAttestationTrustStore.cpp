@@ -17,6 +17,7 @@
 #include "FileAttestationTrustStore.h"
 
 #include <crypto/CHIPCryptoPAL.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <string>
@@ -48,6 +49,7 @@ FileAttestationTrustStore::FileAttestationTrustStore(const char * paaTrustStoreP
     {
         mPAADerCerts = LoadAllX509DerCerts(paaTrustStorePath);
         VerifyOrReturn(paaCount());
+        BuildIndex();
     }
 
     mIsInitialized = true;
@@ -138,9 +140,30 @@ FileAttestationTrustStore::~FileAttestationTrustStore()
     Cleanup();
 }
 
+void FileAttestationTrustStore::BuildIndex()
+{
+    mPAAIndex.clear();
+    mPAAIndex.reserve(mPAADerCerts.size());
+    for (size_t i = 0; i < mPAADerCerts.size(); i++)
+    {
+        const ByteSpan certSpan{ mPAADerCerts[i].data(), mPAADerCerts[i].size() };
+        SubjectKeyId skid;
+        MutableByteSpan skidSpan{ skid };
+        // LoadAllX509DerCerts only keeps the certificates with a SKID.
+        if (CHIP_NO_ERROR == Crypto::ExtractSKIDFromX509Cert(certSpan, skidSpan) && skidSpan.size() == skid.size())
+        {
+            mPAAIndex.emplace_back(skid, i);
+        }
+    }
+
+    // Keep the first certificate loaded for a SKID, as the linear search did.
+    std::stable_sort(mPAAIndex.begin(), mPAAIndex.end(), [](const auto & a, const auto & b) { return a.first < b.first; });
+}
+
 void FileAttestationTrustStore::Cleanup()
 {
     mPAADerCerts.clear();
+    mPAAIndex.clear();
     mIsInitialized = false;
 }
 
@@ -158,20 +181,14 @@ CHIP_ERROR FileAttestationTrustStore::GetProductAttestationAuthorityCert(const B
     VerifyOrReturnError(!skid.empty() && (skid.data() != nullptr), CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(skid.size() == Crypto::kSubjectKeyIdentifierLength, CHIP_ERROR_INVALID_ARGUMENT);
 
-    for (auto candidate : mPAADerCerts)
+    SubjectKeyId key;
+    memcpy(key.data(), skid.data(), key.size());
+    auto match = std::lower_bound(mPAAIndex.begin(), mPAAIndex.end(), key,
+                                  [](const auto & entry, const SubjectKeyId & value) { return entry.first < value; });
+    if (match != mPAAIndex.end() && match->first == key)
     {
-        uint8_t skidBuf[Crypto::kSubjectKeyIdentifierLength] = { 0 };
-        MutableByteSpan candidateSkidSpan{ skidBuf };
-        if (CHIP_NO_ERROR != Crypto::ExtractSKIDFromX509Cert(ByteSpan{ candidate.data(), candidate.size() }, candidateSkidSpan))
-        {
-            continue;
-        }
-
-        if (skid.data_equal(candidateSkidSpan))
-        {
-            // Found a match
-            return CopySpanToMutableSpan(ByteSpan{ candidate.data(), candidate.size() }, outPaaDerBuffer);
-        }
+        const std::vector<uint8_t> & paa = mPAADerCerts[match->second];
+        return CopySpanToMutableSpan(ByteSpan{ paa.data(), paa.size() }, outPaaDerBuffer);
     }
 
     return CHIP_ERROR_CA_CERT_NOT_FOUND;
@@ -20,6 +20,7 @@
 #include <credentials/attestation_verifier/DeviceAttestationVerifier.h>
 
 #include <array>
+#include <utility>
 #include <vector>
 
 namespace chip {
@@ -49,6 +50,12 @@ enum class CertificateValidationMode
 std::vector<std::vector<uint8_t>> LoadAllX509DerCerts(const char * trustStorePath,
                                                       CertificateValidationMode validationMode = CertificateValidationMode::kPAA);
 
+/**
+ * @brief Attestation trust store of the PAA certificates found in a directory.
+ *
+ * The certificates are read once, on construction, and indexed by subject key identifier so that a lookup does not parse
+ * every certificate of the store.
+ */
 class FileAttestationTrustStore : public AttestationTrustStore
 {
 public:
@@ -61,11 +68,16 @@ public:
     size_t paaCount() const { return mPAADerCerts.size(); };
 
 protected:
+    using SubjectKeyId = std::array<uint8_t, Crypto::kSubjectKeyIdentifierLength>;
+
     std::vector<std::vector<uint8_t>> mPAADerCerts;
+    // Index of mPAADerCerts by SKID, sorted by SKID.
+    std::vector<std::pair<SubjectKeyId, size_t>> mPAAIndex;
 
 private:
     bool mIsInitialized = false;
 
+    void BuildIndex();
     void Cleanup();
 };
 
@@ -33,6 +33,8 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+
 #include "CHIPAttCert_test_vectors.h"
 
 using namespace chip;
@@ -45,6 +47,38 @@ namespace {
 static const ByteSpan kExpectedDacPublicKey = DevelopmentCerts::kDacPublicKey;
 static const ByteSpan kExpectedPaiPublicKey = DevelopmentCerts::kPaiPublicKey;
 
+// Attestation information of TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert.
+const uint8_t kAttestationElementsTestVector[] = {
+    0x15, 0x30, 0x01, 0xeb, 0x30, 0x81, 0xe8, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x07, 0x02, 0xa0, 0x81,
+    0xda, 0x30, 0x81, 0xd7, 0x02, 0x01, 0x03, 0x31, 0x0d, 0x30, 0x0b, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04,
+    0x02, 0x01, 0x30, 0x45, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x07, 0x01, 0xa0, 0x38, 0x04, 0x36, 0x15,
+    0x24, 0x00, 0x01, 0x25, 0x01, 0xf1, 0xff, 0x36, 0x02, 0x05, 0x00, 0x80, 0x18, 0x25, 0x03, 0x34, 0x12, 0x2c, 0x04, 0x13,
+    0x5a, 0x49, 0x47, 0x32, 0x30, 0x31, 0x34, 0x31, 0x5a, 0x42, 0x33, 0x33, 0x30, 0x30, 0x30, 0x31, 0x2d, 0x32, 0x34, 0x24,
+    0x05, 0x00, 0x24, 0x06, 0x00, 0x25, 0x07, 0x94, 0x26, 0x24, 0x08, 0x00, 0x18, 0x31, 0x7c, 0x30, 0x7a, 0x02, 0x01, 0x03,
+    0x80, 0x14, 0x62, 0xfa, 0x82, 0x33, 0x59, 0xac, 0xfa, 0xa9, 0x96, 0x3e, 0x1c, 0xfa, 0x14, 0x0a, 0xdd, 0xf5, 0x04, 0xf3,
+    0x71, 0x60, 0x30, 0x0b, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x30, 0x0a, 0x06, 0x08, 0x2a,
+    0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x04, 0x46, 0x30, 0x44, 0x02, 0x20, 0x43, 0xa6, 0x3f, 0x2b, 0x94, 0x3d, 0xf3,
+    0x3c, 0x38, 0xb3, 0xe0, 0x2f, 0xca, 0xa7, 0x5f, 0xe3, 0x53, 0x2a, 0xeb, 0xbf, 0x5e, 0x63, 0xf5, 0xbb, 0xdb, 0xc0, 0xb1,
+    0xf0, 0x1d, 0x3c, 0x4f, 0x60, 0x02, 0x20, 0x4c, 0x1a, 0xbf, 0x5f, 0x18, 0x07, 0xb8, 0x18, 0x94, 0xb1, 0x57, 0x6c, 0x47,
+    0xe4, 0x72, 0x4e, 0x4d, 0x96, 0x6c, 0x61, 0x2e, 0xd3, 0xfa, 0x25, 0xc1, 0x18, 0xc3, 0xf2, 0xb3, 0xf9, 0x03, 0x69, 0x30,
+    0x02, 0x20, 0xe0, 0x42, 0x1b, 0x91, 0xc6, 0xfd, 0xcd, 0xb4, 0x0e, 0x2a, 0x4d, 0x2c, 0xf3, 0x1d, 0xb2, 0xb4, 0xe1, 0x8b,
+    0x41, 0x1b, 0x1d, 0x3a, 0xd4, 0xd1, 0x2a, 0x9d, 0x90, 0xaa, 0x8e, 0x52, 0xfa, 0xe2, 0x26, 0x03, 0xfd, 0xc6, 0x5b, 0x28,
+    0xd0, 0xf1, 0xff, 0x3e, 0x00, 0x01, 0x00, 0x17, 0x73, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x5f, 0x76, 0x65, 0x6e, 0x64, 0x6f,
+    0x72, 0x5f, 0x72, 0x65, 0x73, 0x65, 0x72, 0x76, 0x65, 0x64, 0x31, 0xd0, 0xf1, 0xff, 0x3e, 0x00, 0x03, 0x00, 0x18, 0x76,
+    0x65, 0x6e, 0x64, 0x6f, 0x72, 0x5f, 0x72, 0x65, 0x73, 0x65, 0x72, 0x76, 0x65, 0x64, 0x33, 0x5f, 0x65, 0x78, 0x61, 0x6d,
+    0x70, 0x6c, 0x65, 0x18
+};
+const uint8_t kAttestationChallengeTestVector[] = { 0x7a, 0x49, 0x53, 0x05, 0xd0, 0x77, 0x79, 0xa4,
+                                                    0x94, 0xdd, 0x39, 0xa0, 0x85, 0x1b, 0x66, 0x0d };
+const uint8_t kAttestationSignatureTestVector[] = { 0x79, 0x82, 0x53, 0x5d, 0x24, 0xcf, 0xe1, 0x4a, 0x71, 0xab, 0x04, 0x24, 0xcf,
+                                                    0x0b, 0xac, 0xf1, 0xe3, 0x45, 0x48, 0x7e, 0xd5, 0x0f, 0x1a, 0xc0, 0xbc, 0x25,
+                                                    0x9e, 0xcc, 0xfb, 0x39, 0x08, 0x1e, 0x61, 0xa9, 0x26, 0x7e, 0x74, 0xf8, 0x55,
+                                                    0xda, 0x53, 0x63, 0x83, 0x74, 0xa0, 0x16, 0x71, 0xcf, 0x3d, 0x7d, 0xb8, 0xcc,
+                                                    0x17, 0x0b, 0x38, 0x03, 0x45, 0xe6, 0x0b, 0xc8, 0x6f, 0xdf, 0x45, 0x9e };
+const uint8_t kAttestationNonceTestVector[]     = { 0xe0, 0x42, 0x1b, 0x91, 0xc6, 0xfd, 0xcd, 0xb4, 0x0e, 0x2a, 0x4d,
+                                                    0x2c, 0xf3, 0x1d, 0xb2, 0xb4, 0xe1, 0x8b, 0x41, 0x1b, 0x1d, 0x3a,
+                                                    0xd4, 0xd1, 0x2a, 0x9d, 0x90, 0xaa, 0x8e, 0x52, 0xfa, 0xe2 };
+
 } // namespace
 
 struct TestDeviceAttestationCredentials : public ::testing::Test
@@ -163,37 +197,6 @@ static void OnAttestationInformationVerificationCallback(void * context, const D
 
 TEST_F(TestDeviceAttestationCredentials, TestDACVerifierExample_AttestationInfoVerification)
 {
-    uint8_t attestationElementsTestVector[] = {
-        0x15, 0x30, 0x01, 0xeb, 0x30, 0x81, 0xe8, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x07, 0x02, 0xa0, 0x81,
-        0xda, 0x30, 0x81, 0xd7, 0x02, 0x01, 0x03, 0x31, 0x0d, 0x30, 0x0b, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04,
-        0x02, 0x01, 0x30, 0x45, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x07, 0x01, 0xa0, 0x38, 0x04, 0x36, 0x15,
-        0x24, 0x00, 0x01, 0x25, 0x01, 0xf1, 0xff, 0x36, 0x02, 0x05, 0x00, 0x80, 0x18, 0x25, 0x03, 0x34, 0x12, 0x2c, 0x04, 0x13,
-        0x5a, 0x49, 0x47, 0x32, 0x30, 0x31, 0x34, 0x31, 0x5a, 0x42, 0x33, 0x33, 0x30, 0x30, 0x30, 0x31, 0x2d, 0x32, 0x34, 0x24,
-        0x05, 0x00, 0x24, 0x06, 0x00, 0x25, 0x07, 0x94, 0x26, 0x24, 0x08, 0x00, 0x18, 0x31, 0x7c, 0x30, 0x7a, 0x02, 0x01, 0x03,
-        0x80, 0x14, 0x62, 0xfa, 0x82, 0x33, 0x59, 0xac, 0xfa, 0xa9, 0x96, 0x3e, 0x1c, 0xfa, 0x14, 0x0a, 0xdd, 0xf5, 0x04, 0xf3,
-        0x71, 0x60, 0x30, 0x0b, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x30, 0x0a, 0x06, 0x08, 0x2a,
-        0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x04, 0x46, 0x30, 0x44, 0x02, 0x20, 0x43, 0xa6, 0x3f, 0x2b, 0x94, 0x3d, 0xf3,
-        0x3c, 0x38, 0xb3, 0xe0, 0x2f, 0xca, 0xa7, 0x5f, 0xe3, 0x53, 0x2a, 0xeb, 0xbf, 0x5e, 0x63, 0xf5, 0xbb, 0xdb, 0xc0, 0xb1,
-        0xf0, 0x1d, 0x3c, 0x4f, 0x60, 0x02, 0x20, 0x4c, 0x1a, 0xbf, 0x5f, 0x18, 0x07, 0xb8, 0x18, 0x94, 0xb1, 0x57, 0x6c, 0x47,
-        0xe4, 0x72, 0x4e, 0x4d, 0x96, 0x6c, 0x61, 0x2e, 0xd3, 0xfa, 0x25, 0xc1, 0x18, 0xc3, 0xf2, 0xb3, 0xf9, 0x03, 0x69, 0x30,
-        0x02, 0x20, 0xe0, 0x42, 0x1b, 0x91, 0xc6, 0xfd, 0xcd, 0xb4, 0x0e, 0x2a, 0x4d, 0x2c, 0xf3, 0x1d, 0xb2, 0xb4, 0xe1, 0x8b,
-        0x41, 0x1b, 0x1d, 0x3a, 0xd4, 0xd1, 0x2a, 0x9d, 0x90, 0xaa, 0x8e, 0x52, 0xfa, 0xe2, 0x26, 0x03, 0xfd, 0xc6, 0x5b, 0x28,
-        0xd0, 0xf1, 0xff, 0x3e, 0x00, 0x01, 0x00, 0x17, 0x73, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x5f, 0x76, 0x65, 0x6e, 0x64, 0x6f,
-        0x72, 0x5f, 0x72, 0x65, 0x73, 0x65, 0x72, 0x76, 0x65, 0x64, 0x31, 0xd0, 0xf1, 0xff, 0x3e, 0x00, 0x03, 0x00, 0x18, 0x76,
-        0x65, 0x6e, 0x64, 0x6f, 0x72, 0x5f, 0x72, 0x65, 0x73, 0x65, 0x72, 0x76, 0x65, 0x64, 0x33, 0x5f, 0x65, 0x78, 0x61, 0x6d,
-        0x70, 0x6c, 0x65, 0x18
-    };
-    uint8_t attestationChallengeTestVector[] = { 0x7a, 0x49, 0x53, 0x05, 0xd0, 0x77, 0x79, 0xa4,
-                                                 0x94, 0xdd, 0x39, 0xa0, 0x85, 0x1b, 0x66, 0x0d };
-    uint8_t attestationSignatureTestVector[] = { 0x79, 0x82, 0x53, 0x5d, 0x24, 0xcf, 0xe1, 0x4a, 0x71, 0xab, 0x04, 0x24, 0xcf,
-                                                 0x0b, 0xac, 0xf1, 0xe3, 0x45, 0x48, 0x7e, 0xd5, 0x0f, 0x1a, 0xc0, 0xbc, 0x25,
-                                                 0x9e, 0xcc, 0xfb, 0x39, 0x08, 0x1e, 0x61, 0xa9, 0x26, 0x7e, 0x74, 0xf8, 0x55,
-                                                 0xda, 0x53, 0x63, 0x83, 0x74, 0xa0, 0x16, 0x71, 0xcf, 0x3d, 0x7d, 0xb8, 0xcc,
-                                                 0x17, 0x0b, 0x38, 0x03, 0x45, 0xe6, 0x0b, 0xc8, 0x6f, 0xdf, 0x45, 0x9e };
-    uint8_t attestationNonceTestVector[]     = { 0xe0, 0x42, 0x1b, 0x91, 0xc6, 0xfd, 0xcd, 0xb4, 0x0e, 0x2a, 0x4d,
-                                                 0x2c, 0xf3, 0x1d, 0xb2, 0xb4, 0xe1, 0x8b, 0x41, 0x1b, 0x1d, 0x3a,
-                                                 0xd4, 0xd1, 0x2a, 0x9d, 0x90, 0xaa, 0x8e, 0x52, 0xfa, 0xe2 };
-
     // Make sure default verifier exists and is not implemented on at least one method
     DeviceAttestationVerifier * default_verifier = GetDeviceAttestationVerifier();
     ASSERT_NE(default_verifier, nullptr);
@@ -216,9 +219,9 @@ TEST_F(TestDeviceAttestationCredentials, TestDACVerifierExample_AttestationInfoV
         OnAttestationInformationVerificationCallback, &attestationResult);
 
     Credentials::DeviceAttestationVerifier::AttestationInfo info(
-        ByteSpan(attestationElementsTestVector), ByteSpan(attestationChallengeTestVector), ByteSpan(attestationSignatureTestVector),
-        TestCerts::sTestCert_PAI_FFF1_8000_Cert, TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert, ByteSpan(attestationNonceTestVector),
-        static_cast<VendorId>(0xFFF1), 0x8000);
+        ByteSpan(kAttestationElementsTestVector), ByteSpan(kAttestationChallengeTestVector),
+        ByteSpan(kAttestationSignatureTestVector), TestCerts::sTestCert_PAI_FFF1_8000_Cert,
+        TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert, ByteSpan(kAttestationNonceTestVector), static_cast<VendorId>(0xFFF1), 0x8000);
     default_verifier->VerifyAttestationInformation(info, &attestationInformationVerificationCallback);
 
     EXPECT_EQ(attestationResult, AttestationVerificationResult::kSuccess);
@@ -411,3 +414,89 @@ TEST_F(TestDeviceAttestationCredentials, TestAttestationTrustStore)
         }
     }
 }
+
+// Verifies the attestation information of TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert, with the given DAC and nonce.
+static AttestationVerificationResult VerifyTestAttestation(DeviceAttestationVerifier & verifier, const ByteSpan & dac,
+                                                           const ByteSpan & nonce)
+{
+    AttestationVerificationResult result = AttestationVerificationResult::kNotImplemented;
+    Callback::Callback<DeviceAttestationVerifier::OnAttestationInformationVerification> callback(
+        OnAttestationInformationVerificationCallback, &result);
+
+    DeviceAttestationVerifier::AttestationInfo info(
+        ByteSpan(kAttestationElementsTestVector), ByteSpan(kAttestationChallengeTestVector),
+        ByteSpan(kAttestationSignatureTestVector), TestCerts::sTestCert_PAI_FFF1_8000_Cert, dac, nonce,
+        static_cast<VendorId>(0xFFF1), 0x8000);
+    verifier.VerifyAttestationInformation(info, &callback);
+    return result;
+}
+
+TEST_F(TestDeviceAttestationCredentials, TestDACVerifierExample_VerificationCaches)
+{
+    DefaultDACVerifier verifier(GetTestAttestationTrustStore());
+    const ByteSpan dac = TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert;
+    const ByteSpan nonce(kAttestationNonceTestVector);
+
+    // Same DAC, with a signature that does not verify with the key of the PAI.
+    uint8_t badDacBuf[kMaxDERCertLength];
+    ASSERT_LE(dac.size(), sizeof(badDacBuf));
+    memcpy(badDacBuf, dac.data(), dac.size());
+    badDacBuf[dac.size() - 1] ^= 0x01;
+    const ByteSpan badDac(badDacBuf, dac.size());
+
+    uint8_t otherNonce[sizeof(kAttestationNonceTestVector)];
+    memcpy(otherNonce, kAttestationNonceTestVector, sizeof(otherNonce));
+    otherNonce[0] ^= 0x01;
+
+    // Nothing is remembered from a chain that fails validation.
+    EXPECT_EQ(VerifyTestAttestation(verifier, badDac, nonce), AttestationVerificationResult::kDacSignatureInvalid);
+    EXPECT_EQ(VerifyTestAttestation(verifier, dac, nonce), AttestationVerificationResult::kSuccess);
+    EXPECT_EQ(verifier.GetVerifiedPaiCache().GetHitCount(), 0u);
+    EXPECT_EQ(verifier.GetVerifiedCertificationDeclarationCache().GetHitCount(), 0u);
+
+    // Other devices of the same PAI and certification declaration get the same results from the caches.
+    EXPECT_EQ(VerifyTestAttestation(verifier, dac, nonce), AttestationVerificationResult::kSuccess);
+    EXPECT_EQ(verifier.GetVerifiedPaiCache().GetHitCount(), 1u);
+    EXPECT_EQ(verifier.GetVerifiedCertificationDeclarationCache().GetHitCount(), 1u);
+    EXPECT_EQ(VerifyTestAttestation(verifier, badDac, nonce), AttestationVerificationResult::kDacSignatureInvalid);
+    EXPECT_EQ(VerifyTestAttestation(verifier, dac, ByteSpan(otherNonce)),
+              AttestationVerificationResult::kAttestationNonceMismatch);
+    EXPECT_EQ(verifier.GetVerifiedPaiCache().GetHitCount(), 3u);
+
+    verifier.ClearVerificationCaches();
+    verifier.GetVerifiedPaiCache().ResetCounters();
+    EXPECT_EQ(VerifyTestAttestation(verifier, dac, nonce), AttestationVerificationResult::kSuccess);
+    EXPECT_EQ(verifier.GetVerifiedPaiCache().GetHitCount(), 0u);
+    EXPECT_EQ(verifier.GetVerifiedPaiCache().GetMissCount(), 1u);
+}
+
+// Not a pass/fail test, so disabled by default: reports the attestation verifications per second of devices sharing their
+// PAI and certification declaration, with and without the verification caches of the DefaultDACVerifier.
+TEST_F(TestDeviceAttestationCredentials, DISABLED_BenchmarkVerificationCaches)
+{
+    constexpr unsigned kIterations = 200;
+
+    DefaultDACVerifier verifier(GetTestAttestationTrustStore());
+    const ByteSpan dac = TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert;
+    const ByteSpan nonce(kAttestationNonceTestVector);
+
+    auto measure = [&](bool useCaches) {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < kIterations; i++)
+        {
+            if (!useCaches)
+            {
+                verifier.ClearVerificationCaches();
+            }
+            EXPECT_EQ(VerifyTestAttestation(verifier, dac, nonce), AttestationVerificationResult::kSuccess);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        return static_cast<unsigned long>(kIterations * 1000000ull / static_cast<unsigned long long>(elapsed.count() + 1));
+    };
+
+    unsigned long uncachedRate = measure(/* useCaches = */ false);
+    unsigned long cachedRate   = measure(/* useCaches = */ true);
+
+    printf("Attestation verifications per second: %lu verifying the whole chain and CD, %lu with the PAI and CD cached\n",
+           uncachedRate, cachedRate);
+}
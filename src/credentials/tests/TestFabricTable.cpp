@@ -35,6 +35,7 @@
 #include <crypto/PersistentStorageOperationalKeystore.h>
 #include <lib/asn1/ASN1.h>
 #include <lib/support/CodeUtils.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
 #include <lib/support/TestPersistentStorageDelegate.h>
 
 #include <platform/ConfigurationManager.h>
@@ -59,12 +60,13 @@ public:
         mOpKeyStore.Finish();
     }
 
-    CHIP_ERROR Init(chip::TestPersistentStorageDelegate * storage)
+    CHIP_ERROR Init(chip::TestPersistentStorageDelegate * storage, bool enableStartupSnapshot = false)
     {
         chip::FabricTable::InitParams initParams;
-        initParams.storage             = storage;
-        initParams.operationalKeystore = &mOpKeyStore;
-        initParams.opCertStore         = &mOpCertStore;
+        initParams.storage               = storage;
+        initParams.operationalKeystore   = &mOpKeyStore;
+        initParams.opCertStore           = &mOpCertStore;
+        initParams.enableStartupSnapshot = enableStartupSnapshot;
 
         ReturnErrorOnFailure(mOpKeyStore.Init(storage));
         ReturnErrorOnFailure(mOpCertStore.Init(storage));
@@ -79,6 +81,42 @@ private:
     chip::Credentials::PersistentStorageOpCertStore mOpCertStore;
 };
 
+class ReadCountingPersistentStorageDelegate : public chip::TestPersistentStorageDelegate
+{
+public:
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override
+    {
+        mReads++;
+        return TestPersistentStorageDelegate::SyncGetKeyValue(key, buffer, size);
+    }
+
+    size_t mReads = 0;
+};
+
+/**
+ * Add and commit a fabric under the root of the given authority, with an operational key from the keystore.
+ */
+static CHIP_ERROR AddTestFabric(FabricTable & fabricTable, Credentials::TestOnlyLocalCertificateAuthority & fabricCertAuthority,
+                                FabricId fabricId, NodeId nodeId, FabricIndex * outFabricIndex = nullptr)
+{
+    uint8_t csrBuf[chip::Crypto::kMIN_CSR_Buffer_Size];
+    MutableByteSpan csrSpan{ csrBuf };
+    ReturnErrorOnFailure(fabricTable.AllocatePendingOperationalKey(chip::NullOptional, csrSpan));
+    ReturnErrorOnFailure(fabricCertAuthority.SetIncludeIcac(true).GenerateNocChain(fabricId, nodeId, csrSpan).GetStatus());
+
+    FabricIndex newFabricIndex = kUndefinedFabricIndex;
+    ReturnErrorOnFailure(fabricTable.AddNewPendingTrustedRootCert(fabricCertAuthority.GetRcac()));
+    ReturnErrorOnFailure(fabricTable.AddNewPendingFabricWithOperationalKeystore(
+        fabricCertAuthority.GetNoc(), fabricCertAuthority.GetIcac(), VendorId::TestVendor1, &newFabricIndex));
+    ReturnErrorOnFailure(fabricTable.CommitPendingFabricData());
+
+    if (outFabricIndex != nullptr)
+    {
+        *outFabricIndex = newFabricIndex;
+    }
+    return CHIP_NO_ERROR;
+}
+
 /**
  * Load a single test fabric with with the Root01:ICA01:Node01_01 identity.
  */
@@ -2411,6 +2449,88 @@ TEST_F(TestFabricTable, TestFetchCATs)
     // TODO(#20335): Add test cases for NOCs that actually embed CATs
 }
 
+TEST_F(TestFabricTable, TestVerifyCredentialsCache)
+{
+    chip::TestPersistentStorageDelegate testStorage;
+    ScopedFabricTable fabricTableHolder;
+    EXPECT_EQ(fabricTableHolder.Init(&testStorage), CHIP_NO_ERROR);
+    FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+    EXPECT_EQ(LoadTestFabric_Node01_01(fabricTable, /* doCommit = */ true), CHIP_NO_ERROR);
+    EXPECT_EQ(LoadTestFabric_Node02_01(fabricTable, /* doCommit = */ true), CHIP_NO_ERROR);
+
+    VerifiedCertChainCache & cache = fabricTable.GetVerifiedCertChainCache();
+    cache.ResetCounters();
+
+    auto makeContext = []() {
+        ValidationContext context;
+        context.Reset();
+        context.SetEffectiveTime<LastKnownGoodChipEpochTime>(System::Clock::Seconds32(0));
+        context.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+        context.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+        context.mRequiredCertType = CertType::kNode;
+        return context;
+    };
+
+    ByteSpan noc(TestCerts::sTestCert_Node01_01_Chip);
+    ByteSpan icac(TestCerts::sTestCert_ICA01_Chip);
+
+    // The first verification validates the chain, the second one is served from the cache with the same outcome.
+    VerifiedCertChainCache::VerifiedChain validatedChain;
+    {
+        ValidationContext context = makeContext();
+        EXPECT_EQ(fabricTable.VerifyCredentials(1, noc, icac, context, validatedChain), CHIP_NO_ERROR);
+        EXPECT_EQ(cache.GetMissCount(), 1u);
+        EXPECT_EQ(cache.GetHitCount(), 0u);
+    }
+    {
+        ValidationContext context = makeContext();
+        VerifiedCertChainCache::VerifiedChain cachedChain;
+        EXPECT_EQ(fabricTable.VerifyCredentials(1, noc, icac, context, cachedChain), CHIP_NO_ERROR);
+        EXPECT_EQ(cache.GetHitCount(), 1u);
+        EXPECT_EQ(cachedChain.compressedFabricId, validatedChain.compressedFabricId);
+        EXPECT_EQ(cachedChain.fabricId, validatedChain.fabricId);
+        EXPECT_EQ(cachedChain.nodeId, validatedChain.nodeId);
+        EXPECT_TRUE(cachedChain.nocPublicKey.Matches(validatedChain.nocPublicKey));
+        EXPECT_TRUE(cachedChain.rootPublicKey.Matches(validatedChain.rootPublicKey));
+        EXPECT_EQ(cachedChain.cats, validatedChain.cats);
+    }
+
+    // The legacy overload goes through the cache as well.
+    {
+        ValidationContext context = makeContext();
+        CompressedFabricId compressedFabricId;
+        FabricId fabricId;
+        NodeId nodeId;
+        Crypto::P256PublicKey nocPubkey;
+        EXPECT_EQ(fabricTable.VerifyCredentials(1, noc, icac, context, compressedFabricId, fabricId, nodeId, nocPubkey),
+                  CHIP_NO_ERROR);
+        EXPECT_EQ(cache.GetHitCount(), 2u);
+        EXPECT_EQ(nodeId, validatedChain.nodeId);
+        EXPECT_EQ(fabricId, validatedChain.fabricId);
+    }
+
+    // A chain is never served for another fabric: it fails against the root of fabric 2.
+    {
+        ValidationContext context = makeContext();
+        VerifiedCertChainCache::VerifiedChain chain;
+        EXPECT_NE(fabricTable.VerifyCredentials(2, noc, icac, context, chain), CHIP_NO_ERROR);
+        EXPECT_EQ(cache.GetHitCount(), 2u);
+    }
+
+    // Removing a fabric drops its entries.
+    EXPECT_EQ(fabricTable.Delete(1), CHIP_NO_ERROR);
+    {
+        ValidationContext context = makeContext();
+        VerifiedCertChainCache::VerifiedChain chain;
+        EXPECT_NE(fabricTable.VerifyCredentials(1, noc, icac, context, chain), CHIP_NO_ERROR);
+        VerifiedCertChainCache::Digest digest;
+        EXPECT_EQ(VerifiedCertChainCache::ComputeDigest(noc, icac, ByteSpan(TestCerts::sTestCert_Root01_Chip), context, digest),
+                  CHIP_NO_ERROR);
+        EXPECT_FALSE(cache.Find(1, digest, context, chain));
+        EXPECT_EQ(cache.GetHitCount(), 2u);
+    }
+}
+
 // Validate that adding the same fabric twice fails (same root, same FabricId)
 TEST_F(TestFabricTable, TestAddNocRootCollision)
 {
@@ -2946,4 +3066,194 @@ TEST_F(TestFabricTable, TestCommitMarker)
 #endif // CONFIG_BUILD_FOR_HOST_UNIT_TEST
 }
 
+TEST_F(TestFabricTable, TestStartupSnapshot)
+{
+    Credentials::TestOnlyLocalCertificateAuthority fabricCertAuthority;
+    ReadCountingPersistentStorageDelegate storage;
+    ASSERT_TRUE(fabricCertAuthority.Init().IsSuccess());
+
+    const StorageKeyName snapshotKey = DefaultStorageKeyAllocator::FabricTableSnapshot();
+    CompressedFabricId compressedFabricId1;
+    CompressedFabricId compressedFabricId2;
+    Crypto::P256PublicKey rootPublicKey;
+
+    // Add two fabrics, and label the second one.
+    {
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage, /* enableStartupSnapshot = */ true), CHIP_NO_ERROR);
+        FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+
+        EXPECT_EQ(AddTestFabric(fabricTable, fabricCertAuthority, 1111, 55), CHIP_NO_ERROR);
+        EXPECT_EQ(AddTestFabric(fabricTable, fabricCertAuthority, 2222, 66), CHIP_NO_ERROR);
+        EXPECT_EQ(fabricTable.SetFabricLabel(2, "roof"_span), CHIP_NO_ERROR);
+        EXPECT_TRUE(storage.SyncDoesKeyExist(snapshotKey.KeyName()));
+
+        compressedFabricId1 = fabricTable.FindFabricWithIndex(1)->GetCompressedFabricId();
+        compressedFabricId2 = fabricTable.FindFabricWithIndex(2)->GetCompressedFabricId();
+        EXPECT_EQ(fabricTable.FetchRootPubkey(1, rootPublicKey), CHIP_NO_ERROR);
+    }
+
+    // Loading from the snapshot yields the same fabrics, with far fewer reads.
+    size_t readsFromSnapshot = 0;
+    {
+        storage.mReads = 0;
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage, /* enableStartupSnapshot = */ true), CHIP_NO_ERROR);
+        FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+        readsFromSnapshot         = storage.mReads;
+
+        EXPECT_EQ(fabricTable.FabricCount(), 2);
+
+        const auto * fabricInfo = fabricTable.FindFabricWithIndex(1);
+        ASSERT_NE(fabricInfo, nullptr);
+        EXPECT_EQ(fabricInfo->GetNodeId(), 55u);
+        EXPECT_EQ(fabricInfo->GetFabricId(), 1111u);
+        EXPECT_EQ(fabricInfo->GetCompressedFabricId(), compressedFabricId1);
+        EXPECT_EQ(fabricInfo->GetVendorId(), VendorId::TestVendor1);
+        EXPECT_EQ(fabricInfo->GetFabricLabel().size(), 0u);
+
+        fabricInfo = fabricTable.FindFabricWithIndex(2);
+        ASSERT_NE(fabricInfo, nullptr);
+        EXPECT_EQ(fabricInfo->GetNodeId(), 66u);
+        EXPECT_EQ(fabricInfo->GetFabricId(), 2222u);
+        EXPECT_EQ(fabricInfo->GetCompressedFabricId(), compressedFabricId2);
+        EXPECT_TRUE(fabricInfo->GetFabricLabel().data_equal("roof"_span));
+
+        EXPECT_EQ(fabricTable.FindFabric(rootPublicKey, 2222), fabricInfo);
+
+        // Certificates are still read from the certificate store, when needed.
+        uint8_t nocBuf[kMaxCHIPCertLength];
+        MutableByteSpan nocSpan{ nocBuf };
+        EXPECT_EQ(fabricTable.FetchNOCCert(2, nocSpan), CHIP_NO_ERROR);
+
+        FabricIndex nextFabricIndex = kUndefinedFabricIndex;
+        EXPECT_EQ(fabricTable.PeekFabricIndexForNextAddition(nextFabricIndex), CHIP_NO_ERROR);
+        EXPECT_EQ(nextFabricIndex, 3);
+
+        EXPECT_EQ(fabricTable.Delete(1), CHIP_NO_ERROR);
+    }
+
+    // The deletion made it to the snapshot.
+    {
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage, /* enableStartupSnapshot = */ true), CHIP_NO_ERROR);
+        FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+
+        EXPECT_EQ(fabricTable.FabricCount(), 1);
+        EXPECT_EQ(fabricTable.FindFabricWithIndex(1), nullptr);
+        EXPECT_NE(fabricTable.FindFabricWithIndex(2), nullptr);
+    }
+
+    // A corrupted snapshot is ignored, and replaced.
+    {
+        const uint8_t garbage[] = { 0x15, 0x24, 0x00 };
+        EXPECT_EQ(storage.SyncSetKeyValue(snapshotKey.KeyName(), garbage, sizeof(garbage)), CHIP_NO_ERROR);
+
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage, /* enableStartupSnapshot = */ true), CHIP_NO_ERROR);
+        FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+
+        EXPECT_EQ(fabricTable.FabricCount(), 1);
+        EXPECT_NE(fabricTable.FindFabricWithIndex(2), nullptr);
+
+        uint8_t buf[128];
+        uint16_t size = sizeof(buf);
+        EXPECT_EQ(storage.SyncGetKeyValue(snapshotKey.KeyName(), buf, size), CHIP_NO_ERROR);
+        EXPECT_GT(size, sizeof(garbage));
+    }
+
+    // Without the snapshot, everything is loaded from storage, and the left-over snapshot is removed.
+    {
+        storage.mReads = 0;
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage), CHIP_NO_ERROR);
+        FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+
+        EXPECT_EQ(fabricTable.FabricCount(), 1);
+        EXPECT_GT(storage.mReads, readsFromSnapshot);
+        EXPECT_FALSE(storage.SyncDoesKeyExist(snapshotKey.KeyName()));
+    }
+}
+
+// The following test requires test methods not available on all builds.
+#if CONFIG_BUILD_FOR_HOST_UNIT_TEST
+TEST_F(TestFabricTable, TestStartupSnapshotAbortedCommit)
+{
+    Credentials::TestOnlyLocalCertificateAuthority fabricCertAuthority;
+    chip::TestPersistentStorageDelegate storage;
+    ASSERT_TRUE(fabricCertAuthority.Init().IsSuccess());
+
+    const StorageKeyName snapshotKey = DefaultStorageKeyAllocator::FabricTableSnapshot();
+
+    {
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage, /* enableStartupSnapshot = */ true), CHIP_NO_ERROR);
+        FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+
+        EXPECT_EQ(AddTestFabric(fabricTable, fabricCertAuthority, 1111, 55), CHIP_NO_ERROR);
+
+        fabricTable.SetForceAbortCommitForTest(true);
+        EXPECT_EQ(AddTestFabric(fabricTable, fabricCertAuthority, 2222, 66), CHIP_ERROR_INTERNAL);
+        fabricTable.SetForceAbortCommitForTest(false);
+
+        // The commit did not complete, so there must not be a snapshot to skip the commit marker clean-up.
+        EXPECT_FALSE(storage.SyncDoesKeyExist(snapshotKey.KeyName()));
+    }
+
+    {
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage, /* enableStartupSnapshot = */ true), CHIP_NO_ERROR);
+        FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+
+        EXPECT_EQ(fabricTable.GetDeletedFabricFromCommitMarker(), 2);
+        EXPECT_EQ(fabricTable.FabricCount(), 1);
+        EXPECT_TRUE(storage.SyncDoesKeyExist(snapshotKey.KeyName()));
+        fabricTable.ClearCommitMarker();
+    }
+
+    {
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage, /* enableStartupSnapshot = */ true), CHIP_NO_ERROR);
+        FabricTable & fabricTable = fabricTableHolder.GetFabricTable();
+
+        EXPECT_EQ(fabricTable.GetDeletedFabricFromCommitMarker(), kUndefinedFabricIndex);
+        EXPECT_EQ(fabricTable.FabricCount(), 1);
+        EXPECT_NE(fabricTable.FindFabricWithIndex(1), nullptr);
+        EXPECT_EQ(fabricTable.FindFabricWithIndex(2), nullptr);
+    }
+}
+#endif // CONFIG_BUILD_FOR_HOST_UNIT_TEST
+
+// FabricTable::Init of a full table reads a single entry instead of the NOC, RCAC and metadata of each fabric.
+TEST_F(TestFabricTable, TestStartupSnapshotStorageReads)
+{
+    Credentials::TestOnlyLocalCertificateAuthority fabricCertAuthority;
+    ReadCountingPersistentStorageDelegate storage;
+    ASSERT_TRUE(fabricCertAuthority.Init().IsSuccess());
+
+    {
+        ScopedFabricTable fabricTableHolder;
+        ASSERT_EQ(fabricTableHolder.Init(&storage, /* enableStartupSnapshot = */ true), CHIP_NO_ERROR);
+        for (FabricId fabricId = 1; fabricId <= CHIP_CONFIG_MAX_FABRICS; fabricId++)
+        {
+            ASSERT_EQ(AddTestFabric(fabricTableHolder.GetFabricTable(), fabricCertAuthority, fabricId, 100 + fabricId),
+                      CHIP_NO_ERROR);
+        }
+    }
+
+    auto countReads = [&](bool enableStartupSnapshot) {
+        storage.mReads = 0;
+        ScopedFabricTable fabricTableHolder;
+        EXPECT_EQ(fabricTableHolder.Init(&storage, enableStartupSnapshot), CHIP_NO_ERROR);
+        EXPECT_EQ(fabricTableHolder.GetFabricTable().FabricCount(), CHIP_CONFIG_MAX_FABRICS);
+        return storage.mReads;
+    };
+
+    // Loading without the snapshot removes it, so it has to be counted last.
+    size_t snapshotReads = countReads(/* enableStartupSnapshot = */ true);
+    size_t storageReads  = countReads(/* enableStartupSnapshot = */ false);
+
+    EXPECT_LT(snapshotReads, storageReads);
+}
+
 } // namespace
@@ -0,0 +1,246 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <credentials/CertificateValidityPolicy.h>
+#include <credentials/VerifiedCertChainCache.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/Span.h>
+
+#include <gtest/gtest.h>
+
+using namespace chip;
+using namespace chip::Credentials;
+
+namespace {
+
+const uint8_t kNoc1[]  = { 0x15, 0x30, 0x01, 0x01, 0x01 };
+const uint8_t kNoc2[]  = { 0x15, 0x30, 0x01, 0x01, 0x02 };
+const uint8_t kIcac[]  = { 0x15, 0x30, 0x01, 0x01, 0x03 };
+const uint8_t kRcac[]  = { 0x15, 0x30, 0x01, 0x01, 0x04 };
+const uint8_t kRcac2[] = { 0x15, 0x30, 0x01, 0x01, 0x05 };
+
+constexpr uint32_t kNotBefore = 1000;
+constexpr uint32_t kNotAfter  = 2000;
+
+class AcceptAllPolicy : public CertificateValidityPolicy
+{
+public:
+    CHIP_ERROR ApplyCertificateValidityPolicy(const ChipCertificateData * cert, uint8_t depth,
+                                              CertificateValidityResult result) override
+    {
+        return CHIP_NO_ERROR;
+    }
+};
+
+ValidationContext MakeContext(uint32_t now)
+{
+    ValidationContext context;
+    context.Reset();
+    context.SetEffectiveTime<CurrentChipEpochTime>(System::Clock::Seconds32(now));
+    context.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+    context.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+    context.mRequiredCertType = CertType::kNode;
+    return context;
+}
+
+VerifiedCertChainCache::VerifiedChain MakeChain(NodeId nodeId)
+{
+    VerifiedCertChainCache::VerifiedChain chain;
+    chain.fabricId  = 0xFAB1;
+    chain.nodeId    = nodeId;
+    chain.notBefore = kNotBefore;
+    chain.notAfter  = kNotAfter;
+    return chain;
+}
+
+VerifiedCertChainCache::Digest Digest(const ByteSpan & noc, const ByteSpan & icac, const ByteSpan & rcac,
+                                      const ValidationContext & context)
+{
+    VerifiedCertChainCache::Digest digest;
+    EXPECT_EQ(VerifiedCertChainCache::ComputeDigest(noc, icac, rcac, context, digest), CHIP_NO_ERROR);
+    return digest;
+}
+
+} // namespace
+
+struct TestVerifiedCertChainCache : public ::testing::Test
+{
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+};
+
+TEST_F(TestVerifiedCertChainCache, TestDigest)
+{
+    ValidationContext context = MakeContext(1500);
+    auto digest               = Digest(ByteSpan(kNoc1), ByteSpan(kIcac), ByteSpan(kRcac), context);
+
+    // Stable for the same inputs, distinct as soon as one certificate or requirement changes.
+    EXPECT_EQ(digest, Digest(ByteSpan(kNoc1), ByteSpan(kIcac), ByteSpan(kRcac), context));
+    EXPECT_NE(digest, Digest(ByteSpan(kNoc2), ByteSpan(kIcac), ByteSpan(kRcac), context));
+    EXPECT_NE(digest, Digest(ByteSpan(kNoc1), ByteSpan(), ByteSpan(kRcac), context));
+    EXPECT_NE(digest, Digest(ByteSpan(kNoc1), ByteSpan(kIcac), ByteSpan(kRcac2), context));
+
+    // Moving bytes between certificates must not collide.
+    const uint8_t concatenated[] = { 0x15, 0x30, 0x01, 0x01, 0x01, 0x15, 0x30, 0x01, 0x01, 0x03 };
+    EXPECT_NE(digest, Digest(ByteSpan(concatenated), ByteSpan(), ByteSpan(kRcac), context));
+
+    ValidationContext otherPurpose = context;
+    otherPurpose.mRequiredKeyPurposes.Clear(KeyPurposeFlags::kServerAuth).Set(KeyPurposeFlags::kClientAuth);
+    EXPECT_NE(digest, Digest(ByteSpan(kNoc1), ByteSpan(kIcac), ByteSpan(kRcac), otherPurpose));
+}
+
+TEST_F(TestVerifiedCertChainCache, TestHitAndMiss)
+{
+    VerifiedCertChainCache cache;
+    ValidationContext context = MakeContext(1500);
+    auto digest               = Digest(ByteSpan(kNoc1), ByteSpan(kIcac), ByteSpan(kRcac), context);
+    VerifiedCertChainCache::VerifiedChain chain;
+
+    EXPECT_FALSE(cache.Find(1, digest, context, chain));
+    EXPECT_EQ(cache.GetMissCount(), 1u);
+
+    cache.Add(1, digest, context, MakeChain(0x1234));
+    EXPECT_TRUE(cache.Find(1, digest, context, chain));
+    EXPECT_EQ(chain.nodeId, 0x1234u);
+    EXPECT_EQ(chain.fabricId, 0xFAB1u);
+    EXPECT_EQ(cache.GetHitCount(), 1u);
+
+    // Entries are scoped to their fabric.
+    EXPECT_FALSE(cache.Find(2, digest, context, chain));
+    EXPECT_FALSE(cache.Find(kUndefinedFabricIndex, digest, context, chain));
+    EXPECT_EQ(cache.GetMissCount(), 3u);
+
+    cache.ResetCounters();
+    EXPECT_EQ(cache.GetHitCount(), 0u);
+    EXPECT_EQ(cache.GetMissCount(), 0u);
+}
+
+TEST_F(TestVerifiedCertChainCache, TestValidityWindow)
+{
+    VerifiedCertChainCache cache;
+    ValidationContext context = MakeContext(1500);
+    auto digest               = Digest(ByteSpan(kNoc1), ByteSpan(), ByteSpan(kRcac), context);
+    VerifiedCertChainCache::VerifiedChain chain;
+
+    cache.Add(1, digest, context, MakeChain(0x1234));
+
+    EXPECT_TRUE(cache.Find(1, digest, MakeContext(kNotBefore), chain));
+    EXPECT_TRUE(cache.Find(1, digest, MakeContext(kNotAfter), chain));
+    EXPECT_FALSE(cache.Find(1, digest, MakeContext(kNotBefore - 1), chain));
+    EXPECT_FALSE(cache.Find(1, digest, MakeContext(kNotAfter + 1), chain));
+
+    // Last known good time only checks expiry, like the certificate validation does.
+    ValidationContext lastKnownGood = context;
+    lastKnownGood.SetEffectiveTime<LastKnownGoodChipEpochTime>(System::Clock::Seconds32(kNotBefore - 1));
+    EXPECT_FALSE(cache.Find(1, digest, lastKnownGood, chain));
+    cache.Add(1, digest, lastKnownGood, MakeChain(0x1234));
+    EXPECT_TRUE(cache.Find(1, digest, lastKnownGood, chain));
+    lastKnownGood.SetEffectiveTime<LastKnownGoodChipEpochTime>(System::Clock::Seconds32(kNotAfter + 1));
+    EXPECT_FALSE(cache.Find(1, digest, lastKnownGood, chain));
+
+    // Chains that are outside of their validity period are never recorded.
+    VerifiedCertChainCache emptyCache;
+    emptyCache.Add(1, digest, MakeContext(kNotAfter + 1), MakeChain(0x1234));
+    EXPECT_FALSE(emptyCache.Find(1, digest, MakeContext(kNotAfter + 1), chain));
+}
+
+TEST_F(TestVerifiedCertChainCache, TestValidityPolicy)
+{
+    VerifiedCertChainCache cache;
+    AcceptAllPolicy policy;
+    ValidationContext context = MakeContext(1500);
+    auto digest               = Digest(ByteSpan(kNoc1), ByteSpan(), ByteSpan(kRcac), context);
+    VerifiedCertChainCache::VerifiedChain chain;
+
+    cache.Add(1, digest, context, MakeChain(0x1234));
+
+    ValidationContext withPolicy = context;
+    withPolicy.mValidityPolicy   = &policy;
+    EXPECT_FALSE(cache.Find(1, digest, withPolicy, chain));
+
+    cache.Add(1, digest, withPolicy, MakeChain(0x1234));
+    EXPECT_TRUE(cache.Find(1, digest, withPolicy, chain));
+    EXPECT_FALSE(cache.Find(1, digest, context, chain));
+}
+
+TEST_F(TestVerifiedCertChainCache, TestInvalidate)
+{
+    VerifiedCertChainCache cache;
+    ValidationContext context = MakeContext(1500);
+    auto digest1              = Digest(ByteSpan(kNoc1), ByteSpan(), ByteSpan(kRcac), context);
+    auto digest2              = Digest(ByteSpan(kNoc2), ByteSpan(), ByteSpan(kRcac2), context);
+    VerifiedCertChainCache::VerifiedChain chain;
+
+    cache.Add(1, digest1, context, MakeChain(0x1111));
+    cache.Add(2, digest2, context, MakeChain(0x2222));
+
+    cache.Invalidate(1);
+    EXPECT_FALSE(cache.Find(1, digest1, context, chain));
+    EXPECT_TRUE(cache.Find(2, digest2, context, chain));
+    EXPECT_EQ(chain.nodeId, 0x2222u);
+
+    cache.InvalidateAll();
+    EXPECT_FALSE(cache.Find(2, digest2, context, chain));
+}
+
+TEST_F(TestVerifiedCertChainCache, TestLeastRecentlyUsedEviction)
+{
+    if (VerifiedCertChainCache::kCapacity < 2)
+    {
+        GTEST_SKIP();
+    }
+
+    VerifiedCertChainCache cache;
+    ValidationContext context = MakeContext(1500);
+    VerifiedCertChainCache::VerifiedChain chain;
+
+    // One distinct chain per entry, plus one: the digest only depends on the NOC bytes here.
+    VerifiedCertChainCache::Digest digests[VerifiedCertChainCache::kCapacity + 1];
+    for (size_t i = 0; i <= VerifiedCertChainCache::kCapacity; i++)
+    {
+        uint8_t noc[] = { 0x15, 0x30, 0x01, static_cast<uint8_t>(i) };
+        digests[i]    = Digest(ByteSpan(noc), ByteSpan(), ByteSpan(kRcac), context);
+    }
+
+    for (size_t i = 0; i < VerifiedCertChainCache::kCapacity; i++)
+    {
+        cache.Add(1, digests[i], context, MakeChain(i));
+    }
+
+    // Touch the oldest entry, so that the second one is the least recently used.
+    EXPECT_TRUE(cache.Find(1, digests[0], context, chain));
+    cache.Add(1, digests[VerifiedCertChainCache::kCapacity], context, MakeChain(VerifiedCertChainCache::kCapacity));
+
+    EXPECT_TRUE(cache.Find(1, digests[0], context, chain));
+    EXPECT_FALSE(cache.Find(1, digests[1], context, chain));
+    for (size_t i = 2; i <= VerifiedCertChainCache::kCapacity; i++)
+    {
+        EXPECT_TRUE(cache.Find(1, digests[i], context, chain));
+        EXPECT_EQ(chain.nodeId, i);
+    }
+
+    // Adding a chain again refreshes its entry instead of taking another one.
+    cache.Add(1, digests[0], context, MakeChain(0x4321));
+    EXPECT_TRUE(cache.Find(1, digests[0], context, chain));
+    EXPECT_EQ(chain.nodeId, 0x4321u);
+    for (size_t i = 2; i <= VerifiedCertChainCache::kCapacity; i++)
+    {
+        EXPECT_TRUE(cache.Find(1, digests[i], context, chain));
+    }
+}
@@ -254,6 +254,20 @@
 #define CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS 16
 #endif // CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
 
+/**
+ *  @def CHIP_CONFIG_EXCHANGE_INDEX_BUCKET_COUNT
+ *
+ *  @brief
+ *    Number of buckets of the hash index the exchange manager uses to match incoming messages to
+ *    active exchange contexts.  An incoming message is compared with the exchanges of one bucket
+ *    only, so platforms whose exchange pool is heap-backed and which keep many exchanges open
+ *    (e.g. controllers) may want a larger value.
+ *
+ */
+#ifndef CHIP_CONFIG_EXCHANGE_INDEX_BUCKET_COUNT
+#define CHIP_CONFIG_EXCHANGE_INDEX_BUCKET_COUNT CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
+#endif // CHIP_CONFIG_EXCHANGE_INDEX_BUCKET_COUNT
+
 /**
  *  @def CHIP_CONFIG_MCSP_RECEIVE_TABLE_SIZE
  *
@@ -774,6 +788,8 @@
  *
  *  @brief
  *    Maximum number of Peer within a fabric that can send group data message to a device.
+ *    When this many peers are known, the least recently heard from one is forgotten to make room, provided it has been idle
+ *    for CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS; otherwise messages from new peers are dropped.
  *
  *  // TODO: Determine a better value for this
  */
@@ -786,11 +802,30 @@
  *
  *  @brief
  *   Maximum number of Peer within a fabric that can send group control message to a device.
+ *   When this many peers are known, the least recently heard from one is forgotten to make room, provided it has been idle
+ *   for CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS; otherwise messages from new peers are dropped.
  */
 #ifndef CHIP_CONFIG_MAX_GROUP_CONTROL_PEERS
 #define CHIP_CONFIG_MAX_GROUP_CONTROL_PEERS 2
 #endif // CHIP_CONFIG_MAX_GROUP_CONTROL_PEER
 
+/**
+ *  @def CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS
+ *
+ *  @brief
+ *    How long a group peer must have been silent before it may be forgotten to make room for a new peer of the same
+ *    fabric, once CHIP_CONFIG_MAX_GROUP_DATA_PEERS or CHIP_CONFIG_MAX_GROUP_CONTROL_PEERS peers are known.
+ *
+ *    Forgetting a peer forgets its message counter.  With the trust-first security policy, the next message claiming to
+ *    come from that peer is accepted whatever its counter, so a previously captured message of the forgotten peer can then
+ *    be replayed.  This interval keeps peers that are actively sending from being pushed out by new ones, which would
+ *    otherwise open that replay window at will; messages from new peers are dropped instead while the table is full of
+ *    recently active peers.
+ */
+#ifndef CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS
+#define CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS (5 * 60 * 1000)
+#endif // CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS
+
 /**
  *  @def CHIP_CONFIG_SLOW_CRYPTO
  *
@@ -949,6 +984,16 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_IM_MAX_NUM_WRITE_CLIENT 4
 #endif
 
+/**
+ * @def CHIP_IM_MAX_WRITE_CLIENT_QUEUED_CHUNKS
+ *
+ * @brief Defines the maximum number of complete chunks that a WriteClient keeps waiting to be sent while it encodes
+ *        a list pulled from a WriteClient::ListItemSource. Must be at least 1.
+ */
+#ifndef CHIP_IM_MAX_WRITE_CLIENT_QUEUED_CHUNKS
+#define CHIP_IM_MAX_WRITE_CLIENT_QUEUED_CHUNKS 1
+#endif
+
 /**
  * @def CHIP_IM_MAX_NUM_TIMED_HANDLER
  *
@@ -1032,6 +1077,15 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_CONTROLLER_MAX_ACTIVE_CASE_CLIENTS 16
 #endif
 
+/**
+ * @def CHIP_CONFIG_CONTROLLER_MAX_COMMISSIONING_LANES
+ *
+ * @brief Number of DeviceCommissioner instances a CommissioningOrchestrator can run in parallel.
+ */
+#ifndef CHIP_CONFIG_CONTROLLER_MAX_COMMISSIONING_LANES
+#define CHIP_CONFIG_CONTROLLER_MAX_COMMISSIONING_LANES 8
+#endif
+
 /**
  * @def CHIP_CONFIG_DEVICE_MAX_ACTIVE_CASE_CLIENTS
  *
@@ -1216,6 +1270,41 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE (3 * CHIP_CONFIG_MAX_FABRICS)
 #endif
 
+/**
+ * @def CHIP_CONFIG_CASE_SESSION_RESUME_WRITE_BEHIND_DELAY_MS
+ *
+ * @brief
+ *   Maximum time, in milliseconds, during which CachedSessionResumptionStorage keeps changes to the session resumption
+ *   records in RAM before persisting them.  Changes made within that window are coalesced into a single write of each
+ *   record and of the index.
+ */
+#ifndef CHIP_CONFIG_CASE_SESSION_RESUME_WRITE_BEHIND_DELAY_MS
+#define CHIP_CONFIG_CASE_SESSION_RESUME_WRITE_BEHIND_DELAY_MS 1000
+#endif
+
+/**
+ * @def CHIP_CONFIG_CASE_SESSION_RESUME_MAX_PENDING_CHANGES
+ *
+ * @brief
+ *   Number of changes to the session resumption records that CachedSessionResumptionStorage accumulates before persisting
+ *   them right away, without waiting for CHIP_CONFIG_CASE_SESSION_RESUME_WRITE_BEHIND_DELAY_MS.
+ */
+#ifndef CHIP_CONFIG_CASE_SESSION_RESUME_MAX_PENDING_CHANGES
+#define CHIP_CONFIG_CASE_SESSION_RESUME_MAX_PENDING_CHANGES 8
+#endif
+
+/**
+ * @def CHIP_CONFIG_VERIFIED_CERT_CHAIN_CACHE_SIZE
+ *
+ * @brief
+ *   Maximum number of operational certificate chains (NOC, ICAC, RCAC) that the fabric table remembers as already
+ *   validated, so that CASE does not decode and verify the chain of a peer that reconnects again.  Each entry holds
+ *   about 200 bytes.  Controllers that talk to many devices should raise it.  Set to 0 to disable the cache.
+ */
+#ifndef CHIP_CONFIG_VERIFIED_CERT_CHAIN_CACHE_SIZE
+#define CHIP_CONFIG_VERIFIED_CERT_CHAIN_CACHE_SIZE 4
+#endif
+
 /**
  * @def CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD
  *
@@ -1332,6 +1421,30 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MAX_ATTRIBUTE_STORE_ELEMENT_SIZE 1003
 #endif // CHIP_CONFIG_MAX_ATTRIBUTE_STORE_ELEMENT_SIZE
 
+/**
+ * @def CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS
+ *
+ * @brief
+ *   Maximum time, in milliseconds, during which the server keeps changes to persisted attribute values in RAM before
+ *   writing them to storage.  Successive changes to an attribute within that window are coalesced into a single write
+ *   of its last value.  Changes kept in RAM are lost on power loss, so products opt in by setting a non-zero value; the
+ *   default of 0 writes every change to storage right away.
+ */
+#ifndef CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS
+#define CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS 0
+#endif // CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_WRITE_BEHIND_DELAY_MS
+
+/**
+ * @def CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_MAX_PENDING_WRITES
+ *
+ * @brief
+ *   Number of distinct attributes whose changes WriteBehindAttributePersistenceProvider keeps in RAM.  When a change to
+ *   one more attribute comes in, all the pending changes are written to storage right away.
+ */
+#ifndef CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_MAX_PENDING_WRITES
+#define CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_MAX_PENDING_WRITES 16
+#endif // CHIP_CONFIG_ATTRIBUTE_PERSISTENCE_MAX_PENDING_WRITES
+
 /*
  * @def CHIP_CONFIG_MINMDNS_DYNAMIC_OPERATIONAL_RESPONDER_LIST
  *
@@ -1416,6 +1529,30 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_NUM_CD_KEY_SLOTS 5
 #endif // CHIP_CONFIG_NUM_CD_KEY_SLOTS
 
+/**
+ * @def CHIP_CONFIG_DAC_VERIFIER_PAI_CACHE_SIZE
+ *
+ * @brief Number of PAI certificates that the default DAC verifier remembers as chaining up to a trusted PAA, so that
+ *        the devices of a same production run only cost the verification of their DAC.  Each entry holds about
+ *        200 bytes.  Set to 0 to disable the cache.
+ *
+ */
+#ifndef CHIP_CONFIG_DAC_VERIFIER_PAI_CACHE_SIZE
+#define CHIP_CONFIG_DAC_VERIFIER_PAI_CACHE_SIZE 4
+#endif // CHIP_CONFIG_DAC_VERIFIER_PAI_CACHE_SIZE
+
+/**
+ * @def CHIP_CONFIG_DAC_VERIFIER_CD_CACHE_SIZE
+ *
+ * @brief Number of certification declarations that the default DAC verifier remembers as properly signed, so that
+ *        their signature is not verified again for every device.  Each entry holds about 40 bytes.  Set to 0 to
+ *        disable the cache.
+ *
+ */
+#ifndef CHIP_CONFIG_DAC_VERIFIER_CD_CACHE_SIZE
+#define CHIP_CONFIG_DAC_VERIFIER_CD_CACHE_SIZE 4
+#endif // CHIP_CONFIG_DAC_VERIFIER_CD_CACHE_SIZE
+
 /**
  * @def CHIP_CONFIG_MAX_SUBSCRIPTION_RESUMPTION_STORAGE_CONCURRENT_ITERATORS
  *
@@ -1679,6 +1816,35 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION_MAX_RETRY_INTERVAL_SECS (3600 * 6)
 #endif // CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION_MAX_RETRY_INTERVAL_SECS
 
+/**
+ *  @def CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_CONCURRENT_SESSIONS
+ *
+ *  @brief The maximum number of persisted subscriptions for which a session to the subscriber is being established at the same
+ *         time when resuming subscriptions.  Other subscriptions wait for one of these attempts to complete.
+ */
+#ifndef CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_CONCURRENT_SESSIONS
+#define CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_CONCURRENT_SESSIONS 4
+#endif // CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_CONCURRENT_SESSIONS
+
+/**
+ *  @def CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_PACING_INTERVAL_MS
+ *
+ *  @brief The minimum time between two batches of subscription resumptions, in milliseconds.
+ */
+#ifndef CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_PACING_INTERVAL_MS
+#define CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_PACING_INTERVAL_MS 250
+#endif // CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_PACING_INTERVAL_MS
+
+/**
+ *  @def CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_JITTER_MS
+ *
+ *  @brief The maximum random delay, in milliseconds, added to the resumption time of each subscription and to the pacing
+ *         interval, so that devices which rebooted together do not contact their subscribers in lockstep.
+ */
+#ifndef CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_JITTER_MS
+#define CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_JITTER_MS 250
+#endif // CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_MAX_JITTER_MS
+
 /**
  * @def CHIP_CONFIG_SYNCHRONOUS_REPORTS_ENABLED
  *
@@ -1714,6 +1880,15 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_COMMAND_SENDER_BUILTIN_SUPPORT_FOR_BATCHED_COMMANDS 0
 #endif
 
+/**
+ * @def CHIP_CONFIG_PIPELINED_INVOKE_MAX_MESSAGES_IN_FLIGHT
+ *
+ * @brief The maximum number of InvokeRequestMessages a PipelinedCommandSender can have outstanding to a node at once.
+ */
+#ifndef CHIP_CONFIG_PIPELINED_INVOKE_MAX_MESSAGES_IN_FLIGHT
+#define CHIP_CONFIG_PIPELINED_INVOKE_MAX_MESSAGES_IN_FLIGHT 4
+#endif
+
 /**
  * @def CHIP_CONFIG_MAX_PATHS_PER_INVOKE
  *
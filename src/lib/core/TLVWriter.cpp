@@ -663,9 +663,13 @@ CHIP_ERROR TLVWriter::WriteElementHead(TLVElementType elemType, Tag tag, uint64_
         return CHIP_ERROR_TLV_CONTAINER_OPEN;
 
     uint8_t stagingBuf[17]; // 17 = 1 control byte + 8 tag bytes + 8 length/value bytes
-    uint8_t * p     = stagingBuf;
     uint32_t tagNum = TagNumFromTag(tag);
 
+    // When the current buffer has room for the largest possible head, write it in place rather than staging it.
+    const bool writeInPlace = (mRemainingLen >= sizeof(stagingBuf)) && ((mMaxLen - mLenWritten) >= sizeof(stagingBuf));
+    uint8_t * const headStart = writeInPlace ? mWritePoint : stagingBuf;
+    uint8_t * p               = headStart;
+
     if (IsSpecialTag(tag))
     {
         if (tagNum <= Tag::kContextTagMaxNum)
@@ -758,8 +762,17 @@ CHIP_ERROR TLVWriter::WriteElementHead(TLVElementType elemType, Tag tag, uint64_
         break;
     }
 
-    uint32_t bytesStaged = static_cast<uint32_t>(p - stagingBuf);
+    uint32_t bytesStaged = static_cast<uint32_t>(p - headStart);
     VerifyOrDie(bytesStaged <= sizeof(stagingBuf));
+
+    if (writeInPlace)
+    {
+        mWritePoint += bytesStaged;
+        mRemainingLen -= bytesStaged;
+        mLenWritten += bytesStaged;
+        return CHIP_NO_ERROR;
+    }
+
     return WriteData(stagingBuf, bytesStaged);
 }
 
@@ -21,6 +21,8 @@
 
 #include <array>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace chip {
 namespace FlatTree {
@@ -46,18 +48,55 @@ struct Entry
     size_t node_index;
 };
 
+namespace Internal {
+
+template <typename CONTENT, typename MATCHER, typename = void>
+struct IsOrderedMatcher : std::false_type
+{
+};
+
+template <typename CONTENT, typename MATCHER>
+struct IsOrderedMatcher<CONTENT, MATCHER,
+                        std::void_t<decltype(std::declval<MATCHER &>().IsOrderedBefore(std::declval<const CONTENT &>()))>>
+    : std::true_type
+{
+};
+
+} // namespace Internal
+
 template <typename CONTENT>
 struct Node
 {
     size_t entry_count;             // number of items in [entries]
     const Entry<CONTENT> * entries; // child items of [entry_count] size
 
+    // Set if [entries] are in increasing order for ordered matchers (see
+    // find_entry), which then find them with a binary search.
+    bool sorted = false;
+
     /// Attempt to find the entry with given matcher.
     ///
+    /// Matchers are called with entry data and return true on a match. In
+    /// sorted nodes, matchers that also provide
+    ///
+    ///     bool IsOrderedBefore(const CONTENT & data);
+    ///
+    /// returning true for data ordered before any match, are used for a
+    /// binary search. When several entries match, the first one is returned
+    /// either way.
+    ///
     /// Returns nullptr if no matches can be found.
     template <typename MATCHER>
     const Entry<CONTENT> * find_entry(MATCHER matcher) const
     {
+        if constexpr (Internal::IsOrderedMatcher<CONTENT, MATCHER>::value)
+        {
+            if (sorted)
+            {
+                return find_sorted_entry(matcher);
+            }
+        }
+
         for (size_t i = 0; i < entry_count; i++)
         {
             if (matcher(entries[i].data))
@@ -67,6 +106,33 @@ struct Node
         }
         return nullptr;
     }
+
+private:
+    template <typename MATCHER>
+    const Entry<CONTENT> * find_sorted_entry(MATCHER & matcher) const
+    {
+        // Lower bound: first entry not ordered before a match.
+        size_t low  = 0;
+        size_t high = entry_count;
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+            if (matcher.IsOrderedBefore(entries[middle].data))
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        if ((low < entry_count) && matcher(entries[low].data))
+        {
+            return &entries[low];
+        }
+        return nullptr;
+    }
 };
 
 /// Search for a given entry in a sized array
@@ -34,15 +34,18 @@ using chip::TLVMeta::CommandTag;
 using chip::TLVMeta::ConstantValueTag;
 using chip::TLVMeta::EventTag;
 using chip::TLVMeta::ItemType;
+using chip::TLVMeta::TagOrder;
 
 class ByTag
 {
 public:
-    constexpr ByTag(Tag tag) : mTag(tag) {}
+    constexpr ByTag(Tag tag) : mTag(tag), mOrder(TagOrder(tag)) {}
     bool operator()(const chip::TLVMeta::ItemInfo & item) { return item.tag == mTag; }
+    bool IsOrderedBefore(const chip::TLVMeta::ItemInfo & item) { return TagOrder(item.tag) < mOrder; }
 
 private:
     const Tag mTag;
+    const uint64_t mOrder;
 };
 
 CHIP_ERROR FormatCurrentValue(const TLVReader & reader, chip::StringBuilderBase & out)
@@ -25,6 +25,8 @@
 
 #include "sample_data.h"
 
+#include <chrono>
+
 namespace {
 
 using namespace chip::Decoders;
@@ -56,6 +58,48 @@ const std::array<const Node<ItemInfo>, 53 + 2> fake_protocols_meta = { {
     { 2, _FakeProtocolData },
 } };
 
+// Decodes a payload the way the tests below do, returning the number of entries.
+size_t DecodeSampleData(const PayloadDecoderInitParams & params, const SamplePayload & data)
+{
+    chip::Decoders::PayloadDecoder<64, 128> decoder(
+        PayloadDecoderInitParams(params).SetProtocol(data.protocolId).SetMessageType(data.messageType));
+
+    decoder.StartDecoding(data.payload);
+
+    PayloadEntry entry;
+    size_t count = 0;
+    while (decoder.Next(entry))
+    {
+        count++;
+    }
+    return count;
+}
+
+class ByTag
+{
+public:
+    constexpr ByTag(Tag tag) : mTag(tag) {}
+    bool operator()(const ItemInfo & item) { return item.tag == mTag; }
+    bool IsOrderedBefore(const ItemInfo & item) { return TagOrder(item.tag) < TagOrder(mTag); }
+
+private:
+    const Tag mTag;
+};
+
+template <size_t N>
+void CheckSortedByTag(const std::array<const Node<ItemInfo>, N> & tree)
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        EXPECT_TRUE(tree[i].sorted);
+        for (size_t j = 1; j < tree[i].entry_count; j++)
+        {
+            EXPECT_LE(TagOrder(tree[i].entries[j - 1].data.tag), TagOrder(tree[i].entries[j].data.tag))
+                << "node " << i << ": " << tree[i].entries[j].data.name;
+        }
+    }
+}
+
 void TestSampleData(const PayloadDecoderInitParams & params, const SamplePayload & data, const char * expectation)
 {
     chip::Decoders::PayloadDecoder<64, 128> decoder(
@@ -691,4 +735,121 @@ TEST(TestDecoding, TestNestingOverflow)
                    "              ContextTag(0x32)\n"
                    "                ContextTag(0x33)\n");
 }
+
+TEST(TestDecoding, TestGeneratedTreesAreSorted)
+{
+    // Binary searches of the decoder rely on the generated tables being in TagOrder.
+    CheckSortedByTag(chip::TLVMeta::protocols_meta);
+    CheckSortedByTag(chip::TLVMeta::clusters_meta);
+}
+
+const SamplePayload * const kSampleCorpus[] = {
+    &secure_channel_mrp_ack,
+    &secure_channel_pkbdf_param_request,
+    &secure_channel_pkbdf_param_response,
+    &secure_channel_pase_pake1,
+    &secure_channel_pase_pake2,
+    &secure_channel_pase_pake3,
+    &secure_channel_status_report,
+    &im_protocol_read_request,
+    &im_protocol_report_data,
+    &im_protocol_invoke_request,
+    &im_protocol_invoke_response,
+    &im_protocol_report_data_acl,
+    &im_protocol_report_data_window_covering,
+    &im_protocol_invoke_request_change_channel,
+    &im_protocol_event_software_fault,
+    &im_protocol_event_multipress,
+};
+
+// The generated trees, not marked as sorted, so that they are searched linearly as before they were sorted.
+PayloadDecoderInitParams LinearSearchParams()
+{
+    static std::array<Node<ItemInfo>, protocols_meta.size()> linearProtocolsMeta;
+    static std::array<Node<ItemInfo>, clusters_meta.size()> linearClustersMeta;
+    for (size_t i = 0; i < protocols_meta.size(); i++)
+    {
+        linearProtocolsMeta[i] = { protocols_meta[i].entry_count, protocols_meta[i].entries, false };
+    }
+    for (size_t i = 0; i < clusters_meta.size(); i++)
+    {
+        linearClustersMeta[i] = { clusters_meta[i].entry_count, clusters_meta[i].entries, false };
+    }
+
+    PayloadDecoderInitParams params;
+    params.SetProtocolDecodeTree(linearProtocolsMeta.data(), linearProtocolsMeta.size())
+        .SetClusterDecodeTree(linearClustersMeta.data(), linearClustersMeta.size());
+    return params;
+}
+
+TEST(TestDecoding, TestBinarySearchMatchesLinearSearch)
+{
+    PayloadDecoderInitParams sortedParams;
+    sortedParams.SetProtocolDecodeTree(protocols_meta).SetClusterDecodeTree(clusters_meta);
+    PayloadDecoderInitParams linearParams = LinearSearchParams();
+
+    for (const SamplePayload * payload : kSampleCorpus)
+    {
+        EXPECT_EQ(DecodeSampleData(sortedParams, *payload), DecodeSampleData(linearParams, *payload));
+    }
+}
+
+// Not a pass/fail test, so disabled by default: compares the decoding throughput of the sample messages with the generated
+// trees searched with binary searches, or linearly as before they were sorted.
+TEST(TestDecoding, DISABLED_BenchmarkDecodingThroughput)
+{
+    constexpr unsigned kIterations = 2000;
+
+    PayloadDecoderInitParams sortedParams;
+    sortedParams.SetProtocolDecodeTree(protocols_meta).SetClusterDecodeTree(clusters_meta);
+    PayloadDecoderInitParams linearParams = LinearSearchParams();
+
+    size_t corpusBytes = 0;
+    for (const SamplePayload * payload : kSampleCorpus)
+    {
+        corpusBytes += payload->payload.size();
+    }
+
+    auto measure = [&](const PayloadDecoderInitParams & params) {
+        size_t entries = 0;
+        auto start     = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < kIterations; i++)
+        {
+            for (const SamplePayload * payload : kSampleCorpus)
+            {
+                entries += DecodeSampleData(params, *payload);
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        EXPECT_GT(entries, 0u);
+        return static_cast<double>(corpusBytes) * kIterations / static_cast<double>(elapsed.count() + 1);
+    };
+
+    double linearBytesPerUs = measure(linearParams);
+    double sortedBytesPerUs = measure(sortedParams);
+    printf("Decoding throughput of the sample messages: %.1f MB/s with linear searches, %.1f MB/s with binary searches\n",
+           linearBytesPerUs, sortedBytesPerUs);
+
+    // The lookups alone, for every cluster of the data model.
+    auto measureClusterLookups = [&](const Node<ItemInfo> & root) {
+        size_t found = 0;
+        auto start   = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < kIterations; i++)
+        {
+            for (size_t j = 0; j < root.entry_count; j++)
+            {
+                found += (root.find_entry(ByTag(root.entries[j].data.tag)) != nullptr) ? 1 : 0;
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        EXPECT_EQ(found, kIterations * root.entry_count);
+        return static_cast<unsigned>(elapsed.count() / static_cast<long long>(found));
+    };
+
+    unsigned linearNs = measureClusterLookups({ clusters_meta[0].entry_count, clusters_meta[0].entries, false });
+    unsigned sortedNs = measureClusterLookups(clusters_meta[0]);
+    printf("Lookup among %u clusters: %u ns with a linear search, %u ns with a binary search\n",
+           static_cast<unsigned>(clusters_meta[0].entry_count), linearNs, sortedNs);
+}
+
 } // namespace
@@ -71,6 +71,27 @@ private:
     const Tag mTag;
 };
 
+// Finds entries of sorted nodes with a binary search, counting the entries it looks at.
+class ByOrderedTag
+{
+public:
+    ByOrderedTag(Tag tag, size_t & comparisons) : mTag(tag), mComparisons(comparisons) {}
+    bool operator()(const NamedTag & item)
+    {
+        mComparisons++;
+        return item.tag == mTag;
+    }
+    bool IsOrderedBefore(const NamedTag & item)
+    {
+        mComparisons++;
+        return TagNumFromTag(item.tag) < TagNumFromTag(mTag);
+    }
+
+private:
+    const Tag mTag;
+    size_t & mComparisons;
+};
+
 class ByName
 {
 public:
@@ -105,4 +126,45 @@ TEST(TestFlatTree, TestFlatTreeFind)
     EXPECT_EQ(FindEntry(tree, 1000, ByTag(AnonymousTag())), nullptr);
     EXPECT_EQ(FindEntry(tree, 9999999, ByTag(AnonymousTag())), nullptr);
 }
+
+TEST(TestFlatTree, TestFlatTreeFindSorted)
+{
+    // Context tags 0, 2, ..., 2 * (kCount - 1), with an additional entry for tag 10: "first" and "second".
+    constexpr size_t kCount = 64;
+    Entry<NamedTag> entries[kCount + 1];
+    for (size_t i = 0, tag = 0; i <= kCount; i++)
+    {
+        entries[i] = { { ContextTag(static_cast<uint8_t>(tag)), "other" }, kInvalidNodeIndex };
+        if (tag != 10 || i == 6)
+        {
+            tag += 2;
+        }
+    }
+    entries[5].data.name = "first";
+    entries[6].data.name = "second";
+
+    const Node<NamedTag> sortedNode   = { kCount + 1, entries, true };
+    const Node<NamedTag> unsortedNode = { kCount + 1, entries };
+
+    size_t comparisons = 0;
+    EXPECT_EQ(sortedNode.find_entry(ByOrderedTag(ContextTag(64), comparisons)), &entries[33]);
+    EXPECT_LE(comparisons, 8u);
+
+    comparisons = 0;
+    EXPECT_EQ(unsortedNode.find_entry(ByOrderedTag(ContextTag(64), comparisons)), &entries[33]);
+    EXPECT_EQ(comparisons, 34u);
+
+    // Of several matches, the first one is found.
+    EXPECT_STREQ(sortedNode.find_entry(ByOrderedTag(ContextTag(10), comparisons))->data.name, "first");
+    EXPECT_STREQ(unsortedNode.find_entry(ByOrderedTag(ContextTag(10), comparisons))->data.name, "first");
+
+    EXPECT_EQ(sortedNode.find_entry(ByOrderedTag(ContextTag(0), comparisons)), &entries[0]);
+    EXPECT_EQ(sortedNode.find_entry(ByOrderedTag(ContextTag(126), comparisons)), &entries[kCount]);
+    EXPECT_EQ(sortedNode.find_entry(ByOrderedTag(ContextTag(7), comparisons)), nullptr);
+    EXPECT_EQ(sortedNode.find_entry(ByOrderedTag(ContextTag(200), comparisons)), nullptr);
+
+    // Matchers without an order still work on sorted nodes.
+    EXPECT_STREQ(sortedNode.find_entry(ByTag(ContextTag(10)))->data.name, "first");
+    EXPECT_EQ(sortedNode.find_entry(ByName("second"))->data.tag, ContextTag(10));
+}
 } // namespace
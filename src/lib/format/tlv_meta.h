@@ -53,6 +53,14 @@ constexpr TLV::Tag ConstantValueTag(uint64_t value)
     return TLV::ProfileTag(static_cast<uint32_t>(value >> 32), static_cast<uint32_t>(value & 0xFFFFFFFF));
 }
 
+/// Generated tables list their entries in increasing order of this value (and
+/// are marked as sorted), so that entries can be found by tag with a binary
+/// search.
+constexpr uint64_t TagOrder(TLV::Tag tag)
+{
+    return (static_cast<uint64_t>(TLV::ProfileIdFromTag(tag)) << 32) | TLV::TagNumFromTag(tag);
+}
+
 enum class ItemType : uint8_t
 {
     kDefault,
@@ -96,6 +96,7 @@ private:
 public:
     // Fabric Table
     static StorageKeyName FabricIndexInfo() { return StorageKeyName::FromConst("g/fidx"); }
+    static StorageKeyName FabricTableSnapshot() { return StorageKeyName::FromConst("g/fsnp"); }
     static StorageKeyName FabricNOC(FabricIndex fabric) { return StorageKeyName::Formatted("f/%x/n", fabric); }
     static StorageKeyName FabricICAC(FabricIndex fabric) { return StorageKeyName::Formatted("f/%x/i", fabric); }
     static StorageKeyName FabricRCAC(FabricIndex fabric) { return StorageKeyName::Formatted("f/%x/r", fabric); }
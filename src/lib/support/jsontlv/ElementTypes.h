@@ -40,4 +40,31 @@ struct ElementTypeContext
     bool isDouble              = false;
 };
 
+inline const char * GetJsonElementStrFromType(const ElementTypeContext & ctx)
+{
+    switch (ctx.tlvType)
+    {
+    case chip::TLV::kTLVType_UnsignedInteger:
+        return kElementTypeUInt;
+    case chip::TLV::kTLVType_SignedInteger:
+        return kElementTypeInt;
+    case chip::TLV::kTLVType_Boolean:
+        return kElementTypeBool;
+    case chip::TLV::kTLVType_FloatingPointNumber:
+        return ctx.isDouble ? kElementTypeDouble : kElementTypeFloat;
+    case chip::TLV::kTLVType_ByteString:
+        return kElementTypeBytes;
+    case chip::TLV::kTLVType_UTF8String:
+        return kElementTypeString;
+    case chip::TLV::kTLVType_Null:
+        return kElementTypeNull;
+    case chip::TLV::kTLVType_Structure:
+        return kElementTypeStruct;
+    case chip::TLV::kTLVType_Array:
+        return kElementTypeArray;
+    default:
+        return kElementTypeEmpty;
+    }
+}
+
 } // namespace
@@ -434,4 +434,9 @@ CHIP_ERROR ConvertTlvTag(uint32_t tagNumber, TLV::Tag & tag)
 {
     return InternalConvertTlvTag(tagNumber, tag);
 }
+
+CHIP_ERROR ConvertTlvTag(uint32_t tagNumber, TLV::Tag & tag, uint32_t implicitProfileId)
+{
+    return InternalConvertTlvTag(tagNumber, tag, implicitProfileId);
+}
 } // namespace chip
@@ -43,4 +43,10 @@ CHIP_ERROR JsonToTlv(const std::string & jsonString, TLV::TLVWriter & writer);
  */
 CHIP_ERROR ConvertTlvTag(uint32_t tagNumber, TLV::Tag & tag);
 
+/*
+ * Same as above, except that tags for standard/scoped sources that do not fit in a ContextSpecific tag are encoded as profile
+ * tags of the given implicit profile (usually the ImplicitProfileId of the TLVWriter they will be written with).
+ */
+CHIP_ERROR ConvertTlvTag(uint32_t tagNumber, TLV::Tag & tag, uint32_t implicitProfileId);
+
 } // namespace chip
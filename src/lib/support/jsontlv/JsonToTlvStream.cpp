@@ -0,0 +1,711 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <charconv>
+#include <limits>
+
+#include <lib/support/Base64.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/SafeInt.h>
+#include <lib/support/ScopedBuffer.h>
+#include <lib/support/jsontlv/ElementTypes.h>
+#include <lib/support/jsontlv/JsonToTlv.h>
+#include <lib/support/jsontlv/JsonToTlvStream.h>
+
+namespace chip {
+
+namespace {
+
+// See JsonToTlv.cpp: used as the implicit profile of the writer when the caller did not set one.
+constexpr uint32_t kTemporaryImplicitProfileId = 0xFF01;
+
+struct ElementTypeName
+{
+    const char * name;
+    TLV::TLVType tlvType;
+    bool isDouble;
+};
+
+constexpr ElementTypeName kElementTypeNames[] = {
+    { kElementTypeInt, TLV::kTLVType_SignedInteger, false },
+    { kElementTypeUInt, TLV::kTLVType_UnsignedInteger, false },
+    { kElementTypeBool, TLV::kTLVType_Boolean, false },
+    { kElementTypeFloat, TLV::kTLVType_FloatingPointNumber, false },
+    { kElementTypeDouble, TLV::kTLVType_FloatingPointNumber, true },
+    { kElementTypeBytes, TLV::kTLVType_ByteString, false },
+    { kElementTypeString, TLV::kTLVType_UTF8String, false },
+    { kElementTypeNull, TLV::kTLVType_Null, false },
+    { kElementTypeStruct, TLV::kTLVType_Structure, false },
+};
+
+struct ElementContext
+{
+    TLV::Tag tag = TLV::AnonymousTag();
+    ElementTypeContext type;
+    ElementTypeContext subType;
+};
+
+CHIP_ERROR ParseElementType(const CharSpan & name, ElementTypeContext & type)
+{
+    for (const auto & entry : kElementTypeNames)
+    {
+        if (name.data_equal(CharSpan::fromCharString(entry.name)))
+        {
+            type.tlvType  = entry.tlvType;
+            type.isDouble = entry.isDouble;
+            return CHIP_NO_ERROR;
+        }
+    }
+    return CHIP_ERROR_INVALID_ARGUMENT;
+}
+
+template <typename T>
+CHIP_ERROR ParseDecimal(const CharSpan & decimalString, T & outValue)
+{
+    const char * end          = decimalString.data() + decimalString.size();
+    auto [lastConverted, err] = std::from_chars(decimalString.data(), end, outValue, 10);
+    VerifyOrReturnError(err == std::errc() && lastConverted == end, CHIP_ERROR_INVALID_ARGUMENT);
+    return CHIP_NO_ERROR;
+}
+
+// Order in which JsonToTlv sorts structure members: context tags first, then by tag number.
+bool IsOrderedAfter(TLV::Tag previous, TLV::Tag tag)
+{
+    if (TLV::IsContextTag(previous) != TLV::IsContextTag(tag))
+    {
+        return TLV::IsContextTag(previous);
+    }
+    if (TLV::TagNumFromTag(previous) != TLV::TagNumFromTag(tag))
+    {
+        return TLV::TagNumFromTag(previous) < TLV::TagNumFromTag(tag);
+    }
+    // Profile tags with the same number from different profiles: any consistent order will do.
+    return !TLV::IsContextTag(tag) && TLV::ProfileIdFromTag(previous) < TLV::ProfileIdFromTag(tag);
+}
+
+CHIP_ERROR ParseHex4(const CharSpan & text, size_t offset, uint32_t & value)
+{
+    VerifyOrReturnError(offset + 4 <= text.size(), CHIP_ERROR_INVALID_ARGUMENT);
+    uint16_t v;
+    auto [lastConverted, err] = std::from_chars(text.data() + offset, text.data() + offset + 4, v, 16);
+    VerifyOrReturnError(err == std::errc() && lastConverted == text.data() + offset + 4, CHIP_ERROR_INVALID_ARGUMENT);
+    value = v;
+    return CHIP_NO_ERROR;
+}
+
+size_t EncodeUtf8(uint32_t codePoint, char * out)
+{
+    if (codePoint < 0x80)
+    {
+        out[0] = static_cast<char>(codePoint);
+        return 1;
+    }
+    if (codePoint < 0x800)
+    {
+        out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+        out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint < 0x10000)
+    {
+        out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+        out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+    out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+/*
+ * Decodes the escape sequences of a JSON string body (without its quotes). The decoded string is never
+ * longer than the escaped one, so out must hold at least escaped.size() characters.
+ */
+CHIP_ERROR Unescape(const CharSpan & escaped, char * out, size_t & outLength)
+{
+    size_t length = 0;
+
+    for (size_t i = 0; i < escaped.size(); i++)
+    {
+        char c = escaped.data()[i];
+        if (c != '\\')
+        {
+            out[length++] = c;
+            continue;
+        }
+
+        VerifyOrReturnError(++i < escaped.size(), CHIP_ERROR_INVALID_ARGUMENT);
+        switch (escaped.data()[i])
+        {
+        case '"':
+        case '\\':
+        case '/':
+            out[length++] = escaped.data()[i];
+            break;
+        case 'b':
+            out[length++] = '\b';
+            break;
+        case 'f':
+            out[length++] = '\f';
+            break;
+        case 'n':
+            out[length++] = '\n';
+            break;
+        case 'r':
+            out[length++] = '\r';
+            break;
+        case 't':
+            out[length++] = '\t';
+            break;
+        case 'u': {
+            uint32_t codePoint;
+            ReturnErrorOnFailure(ParseHex4(escaped, i + 1, codePoint));
+            i += 4;
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+            {
+                // A high surrogate must be followed by an escaped low surrogate.
+                uint32_t lowSurrogate;
+                VerifyOrReturnError(i + 2 < escaped.size() && escaped.data()[i + 1] == '\\' && escaped.data()[i + 2] == 'u',
+                                    CHIP_ERROR_INVALID_ARGUMENT);
+                ReturnErrorOnFailure(ParseHex4(escaped, i + 3, lowSurrogate));
+                VerifyOrReturnError(lowSurrogate >= 0xDC00 && lowSurrogate <= 0xDFFF, CHIP_ERROR_INVALID_ARGUMENT);
+                i += 6;
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+            }
+            else
+            {
+                VerifyOrReturnError(codePoint < 0xDC00 || codePoint > 0xDFFF, CHIP_ERROR_INVALID_ARGUMENT);
+            }
+            length += EncodeUtf8(codePoint, out + length);
+            break;
+        }
+        default:
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    outLength = length;
+    return CHIP_NO_ERROR;
+}
+
+bool IsNumberChar(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+/*
+ * Single pass JSON parser that encodes each value into the TLVWriter as soon as it is parsed.
+ */
+class JsonTlvEncoder
+{
+public:
+    JsonTlvEncoder(const CharSpan & json, TLV::TLVWriter & writer) :
+        mCursor(json.data()), mEnd(json.data() + json.size()), mWriter(writer)
+    {}
+
+    CHIP_ERROR Encode()
+    {
+        // The top level element is an anonymous structure.
+        ReturnErrorOnFailure(EncodeStructure(TLV::AnonymousTag(), 0));
+        SkipWhitespace();
+        VerifyOrReturnError(mCursor == mEnd, CHIP_ERROR_INVALID_ARGUMENT);
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    void SkipWhitespace()
+    {
+        while (mCursor < mEnd && (*mCursor == ' ' || *mCursor == '\t' || *mCursor == '\n' || *mCursor == '\r'))
+        {
+            mCursor++;
+        }
+    }
+
+    bool Peek(char c)
+    {
+        SkipWhitespace();
+        return mCursor < mEnd && *mCursor == c;
+    }
+
+    bool Consume(char c)
+    {
+        VerifyOrReturnValue(Peek(c), false);
+        mCursor++;
+        return true;
+    }
+
+    CHIP_ERROR ReadLiteral(const char * literal)
+    {
+        size_t length = strlen(literal);
+        SkipWhitespace();
+        VerifyOrReturnError(static_cast<size_t>(mEnd - mCursor) >= length && memcmp(mCursor, literal, length) == 0,
+                            CHIP_ERROR_INVALID_ARGUMENT);
+        mCursor += length;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR ReadNumber(CharSpan & token)
+    {
+        SkipWhitespace();
+        const char * start = mCursor;
+        while (mCursor < mEnd && IsNumberChar(*mCursor))
+        {
+            mCursor++;
+        }
+        VerifyOrReturnError(mCursor != start, CHIP_ERROR_INVALID_ARGUMENT);
+        token = CharSpan(start, static_cast<size_t>(mCursor - start));
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Reads the body of a JSON string (without its quotes and escape sequences left as they are).
+     */
+    CHIP_ERROR ScanString(CharSpan & raw, bool & escaped)
+    {
+        VerifyOrReturnError(Consume('"'), CHIP_ERROR_INVALID_ARGUMENT);
+
+        const char * start = mCursor;
+        escaped            = false;
+        while (mCursor < mEnd && *mCursor != '"')
+        {
+            // Control characters must be escaped.
+            VerifyOrReturnError(static_cast<unsigned char>(*mCursor) >= 0x20, CHIP_ERROR_INVALID_ARGUMENT);
+            if (*mCursor == '\\')
+            {
+                escaped = true;
+                mCursor++;
+                VerifyOrReturnError(mCursor < mEnd, CHIP_ERROR_INVALID_ARGUMENT);
+            }
+            mCursor++;
+        }
+        VerifyOrReturnError(mCursor < mEnd, CHIP_ERROR_INVALID_ARGUMENT);
+
+        raw = CharSpan(start, static_cast<size_t>(mCursor - start));
+        mCursor++;
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Reads a JSON string. Strings without escape sequences are returned in place, others are decoded into
+     * scratch, which must then outlive the use of value.
+     */
+    CHIP_ERROR ReadString(CharSpan & value, Platform::ScopedMemoryBuffer<char> & scratch)
+    {
+        CharSpan raw;
+        bool escaped;
+        ReturnErrorOnFailure(ScanString(raw, escaped));
+
+        if (!escaped)
+        {
+            value = raw;
+            return CHIP_NO_ERROR;
+        }
+
+        scratch.Alloc(raw.size());
+        VerifyOrReturnError(scratch.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+        size_t length;
+        ReturnErrorOnFailure(Unescape(raw, scratch.Get(), length));
+        value = CharSpan(scratch.Get(), length);
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Skips over a JSON value of any type. Scalars are only checked for being made of valid characters: they are
+     * fully validated when they are encoded.
+     */
+    CHIP_ERROR SkipValue(uint8_t depth)
+    {
+        SkipWhitespace();
+        VerifyOrReturnError(mCursor < mEnd, CHIP_ERROR_INVALID_ARGUMENT);
+
+        CharSpan raw;
+        bool escaped;
+        switch (*mCursor)
+        {
+        case '"':
+            return ScanString(raw, escaped);
+
+        case '{':
+        case '[': {
+            const char close = (*mCursor == '{') ? '}' : ']';
+            VerifyOrReturnError(depth + 1 < kJsonToTlvStreamMaxDepth, CHIP_ERROR_RECURSION_DEPTH_LIMIT);
+            mCursor++;
+            VerifyOrReturnError(!Consume(close), CHIP_NO_ERROR);
+            do
+            {
+                if (close == '}')
+                {
+                    ReturnErrorOnFailure(ScanString(raw, escaped));
+                    VerifyOrReturnError(Consume(':'), CHIP_ERROR_INVALID_ARGUMENT);
+                }
+                ReturnErrorOnFailure(SkipValue(static_cast<uint8_t>(depth + 1)));
+            } while (Consume(','));
+            VerifyOrReturnError(Consume(close), CHIP_ERROR_INVALID_ARGUMENT);
+            return CHIP_NO_ERROR;
+        }
+
+        default: {
+            // Numbers and literals (true, false, null).
+            const char * start = mCursor;
+            while (mCursor < mEnd && (IsNumberChar(*mCursor) || (*mCursor >= 'a' && *mCursor <= 'z')))
+            {
+                mCursor++;
+            }
+            VerifyOrReturnError(mCursor != start, CHIP_ERROR_INVALID_ARGUMENT);
+            return CHIP_NO_ERROR;
+        }
+        }
+    }
+
+    /*
+     * Reads an integer written either as a JSON number or as a decimal string (for 64-bit values).
+     */
+    template <typename T>
+    CHIP_ERROR ReadInteger(T & value)
+    {
+        CharSpan token;
+        Platform::ScopedMemoryBuffer<char> scratch;
+        if (Peek('"'))
+        {
+            ReturnErrorOnFailure(ReadString(token, scratch));
+        }
+        else
+        {
+            ReturnErrorOnFailure(ReadNumber(token));
+        }
+        return ParseDecimal(token, value);
+    }
+
+    CHIP_ERROR ReadFloatingPoint(double & value)
+    {
+        if (Peek('"'))
+        {
+            CharSpan str;
+            Platform::ScopedMemoryBuffer<char> scratch;
+            ReturnErrorOnFailure(ReadString(str, scratch));
+            if (str.data_equal(CharSpan::fromCharString(kFloatingPointPositiveInfinity)))
+            {
+                value = std::numeric_limits<double>::infinity();
+                return CHIP_NO_ERROR;
+            }
+            VerifyOrReturnError(str.data_equal(CharSpan::fromCharString(kFloatingPointNegativeInfinity)),
+                                CHIP_ERROR_INVALID_ARGUMENT);
+            value = -std::numeric_limits<double>::infinity();
+            return CHIP_NO_ERROR;
+        }
+
+        CharSpan token;
+        char number[64];
+        char * end;
+        ReturnErrorOnFailure(ReadNumber(token));
+        VerifyOrReturnError(token.size() < sizeof(number), CHIP_ERROR_INVALID_ARGUMENT);
+        memcpy(number, token.data(), token.size());
+        number[token.size()] = '\0';
+        value                = strtod(number, &end);
+        VerifyOrReturnError(end == number + token.size(), CHIP_ERROR_INVALID_ARGUMENT);
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Parses a JSON element name ('[field_name:]field_id:element_type[-sub_element_type]', see README.md).
+     */
+    CHIP_ERROR ParseElementName(const CharSpan & name, ElementContext & ctx)
+    {
+        CharSpan fields[3];
+        size_t fieldCount = 0;
+        size_t start      = 0;
+        for (size_t i = 0; i <= name.size(); i++)
+        {
+            if (i == name.size() || name.data()[i] == ':')
+            {
+                VerifyOrReturnError(fieldCount < ArraySize(fields), CHIP_ERROR_INVALID_ARGUMENT);
+                fields[fieldCount++] = name.SubSpan(start, i - start);
+                start                = i + 1;
+            }
+        }
+        VerifyOrReturnError(fieldCount >= 2, CHIP_ERROR_INVALID_ARGUMENT);
+
+        uint32_t tagNumber;
+        ReturnErrorOnFailure(ParseDecimal(fields[fieldCount - 2], tagNumber));
+        ReturnErrorOnFailure(ConvertTlvTag(tagNumber, ctx.tag, mWriter.ImplicitProfileId));
+
+        const CharSpan & elementType = fields[fieldCount - 1];
+        const char * separator       = static_cast<const char *>(memchr(elementType.data(), '-', elementType.size()));
+        if (separator == nullptr)
+        {
+            return ParseElementType(elementType, ctx.type);
+        }
+
+        size_t separatorOffset = static_cast<size_t>(separator - elementType.data());
+        VerifyOrReturnError(elementType.SubSpan(0, separatorOffset).data_equal(CharSpan::fromCharString(kElementTypeArray)),
+                            CHIP_ERROR_INVALID_ARGUMENT);
+        ctx.type.tlvType = TLV::kTLVType_Array;
+
+        CharSpan subType = elementType.SubSpan(separatorOffset + 1);
+        if (subType.data_equal(CharSpan::fromCharString(kElementTypeEmpty)))
+        {
+            ctx.subType.tlvType = TLV::kTLVType_NotSpecified;
+            return CHIP_NO_ERROR;
+        }
+        return ParseElementType(subType, ctx.subType);
+    }
+
+    /*
+     * Reads a structure member name and the ':' that follows it.
+     */
+    CHIP_ERROR ReadMemberName(ElementContext & ctx)
+    {
+        CharSpan name;
+        Platform::ScopedMemoryBuffer<char> scratch;
+        ReturnErrorOnFailure(ReadString(name, scratch));
+        ReturnErrorOnFailure(ParseElementName(name, ctx));
+        VerifyOrReturnError(Consume(':'), CHIP_ERROR_INVALID_ARGUMENT);
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Skips the members of a JSON object (starting after its '{' and ending after its '}'), checking whether they
+     * are in the order in which they have to be encoded.
+     */
+    CHIP_ERROR ScanMembers(bool & sorted, uint8_t depth)
+    {
+        TLV::Tag previousTag = TLV::AnonymousTag();
+
+        sorted = true;
+        VerifyOrReturnError(!Consume('}'), CHIP_NO_ERROR);
+        do
+        {
+            ElementContext ctx;
+            ReturnErrorOnFailure(ReadMemberName(ctx));
+            VerifyOrReturnError(ctx.tag != previousTag, CHIP_ERROR_INVALID_ARGUMENT);
+            sorted      = sorted && (previousTag == TLV::AnonymousTag() || IsOrderedAfter(previousTag, ctx.tag));
+            previousTag = ctx.tag;
+            ReturnErrorOnFailure(SkipValue(depth));
+        } while (Consume(','));
+        VerifyOrReturnError(Consume('}'), CHIP_ERROR_INVALID_ARGUMENT);
+        return CHIP_NO_ERROR;
+    }
+
+    /*
+     * Encodes the members of a JSON object in tag order, by looking up the next member to encode among all of
+     * them each time. This is quadratic in the number of members, but needs no memory to sort them.
+     */
+    CHIP_ERROR EncodeMembersInTagOrder(const char * members, uint8_t depth)
+    {
+        TLV::Tag previousTag = TLV::AnonymousTag();
+
+        while (true)
+        {
+            const char * nextMember = nullptr;
+            ElementContext next;
+
+            mCursor = members;
+            do
+            {
+                const char * member = mCursor;
+                ElementContext ctx;
+                ReturnErrorOnFailure(ReadMemberName(ctx));
+                if (previousTag == TLV::AnonymousTag() || IsOrderedAfter(previousTag, ctx.tag))
+                {
+                    VerifyOrReturnError(nextMember == nullptr || ctx.tag != next.tag, CHIP_ERROR_INVALID_ARGUMENT);
+                    if (nextMember == nullptr || IsOrderedAfter(ctx.tag, next.tag))
+                    {
+                        nextMember = member;
+                        next       = ctx;
+                    }
+                }
+                ReturnErrorOnFailure(SkipValue(depth));
+            } while (Consume(','));
+
+            VerifyOrReturnError(nextMember != nullptr, CHIP_NO_ERROR);
+
+            mCursor = nextMember;
+            ReturnErrorOnFailure(ReadMemberName(next));
+            ReturnErrorOnFailure(EncodeValue(next, depth));
+            previousTag = next.tag;
+        }
+    }
+
+    CHIP_ERROR EncodeStructure(TLV::Tag tag, uint8_t depth)
+    {
+        TLV::TLVType containerType;
+        bool sorted;
+
+        VerifyOrReturnError(depth < kJsonToTlvStreamMaxDepth, CHIP_ERROR_RECURSION_DEPTH_LIMIT);
+        VerifyOrReturnError(Consume('{'), CHIP_ERROR_INVALID_ARGUMENT);
+        ReturnErrorOnFailure(mWriter.StartContainer(tag, TLV::kTLVType_Structure, containerType));
+
+        // Structure members have to be encoded in tag order. Members that are already in order (as written by
+        // TlvToJsonStream) are encoded in a single pass, others are looked up in order.
+        const char * members = mCursor;
+        ReturnErrorOnFailure(ScanMembers(sorted, depth));
+        const char * end = mCursor;
+
+        mCursor = members;
+        if (!sorted)
+        {
+            ReturnErrorOnFailure(EncodeMembersInTagOrder(members, depth));
+        }
+        else if (!Consume('}'))
+        {
+            do
+            {
+                ElementContext ctx;
+                ReturnErrorOnFailure(ReadMemberName(ctx));
+                ReturnErrorOnFailure(EncodeValue(ctx, depth));
+            } while (Consume(','));
+        }
+        mCursor = end;
+
+        return mWriter.EndContainer(containerType);
+    }
+
+    CHIP_ERROR EncodeArray(TLV::Tag tag, const ElementTypeContext & subType, uint8_t depth)
+    {
+        TLV::TLVType containerType;
+
+        VerifyOrReturnError(depth < kJsonToTlvStreamMaxDepth, CHIP_ERROR_RECURSION_DEPTH_LIMIT);
+        VerifyOrReturnError(Consume('['), CHIP_ERROR_INVALID_ARGUMENT);
+        ReturnErrorOnFailure(mWriter.StartContainer(tag, TLV::kTLVType_Array, containerType));
+
+        if (!Consume(']'))
+        {
+            // Only empty arrays may have an unknown element type.
+            VerifyOrReturnError(subType.tlvType != TLV::kTLVType_NotSpecified, CHIP_ERROR_INVALID_ARGUMENT);
+
+            ElementContext elementCtx;
+            elementCtx.type = subType;
+            do
+            {
+                ReturnErrorOnFailure(EncodeValue(elementCtx, depth));
+            } while (Consume(','));
+            VerifyOrReturnError(Consume(']'), CHIP_ERROR_INVALID_ARGUMENT);
+        }
+
+        return mWriter.EndContainer(containerType);
+    }
+
+    CHIP_ERROR EncodeValue(const ElementContext & ctx, uint8_t depth)
+    {
+        TLV::Tag tag = ctx.tag;
+
+        switch (ctx.type.tlvType)
+        {
+        case TLV::kTLVType_UnsignedInteger: {
+            uint64_t v;
+            ReturnErrorOnFailure(ReadInteger(v));
+            return mWriter.Put(tag, v);
+        }
+
+        case TLV::kTLVType_SignedInteger: {
+            int64_t v;
+            ReturnErrorOnFailure(ReadInteger(v));
+            return mWriter.Put(tag, v);
+        }
+
+        case TLV::kTLVType_Boolean: {
+            bool v = Peek('t');
+            ReturnErrorOnFailure(ReadLiteral(v ? "true" : "false"));
+            return mWriter.Put(tag, v);
+        }
+
+        case TLV::kTLVType_FloatingPointNumber: {
+            double v;
+            ReturnErrorOnFailure(ReadFloatingPoint(v));
+            return ctx.type.isDouble ? mWriter.Put(tag, v) : mWriter.Put(tag, static_cast<float>(v));
+        }
+
+        case TLV::kTLVType_ByteString: {
+            CharSpan encoded;
+            Platform::ScopedMemoryBuffer<char> scratch;
+            ReturnErrorOnFailure(ReadString(encoded, scratch));
+            VerifyOrReturnError(CanCastTo<uint16_t>(encoded.size()), CHIP_ERROR_INVALID_ARGUMENT);
+
+            // Check if the length is a multiple of 4 as strict padding is required.
+            VerifyOrReturnError(encoded.size() % 4 == 0, CHIP_ERROR_INVALID_ARGUMENT);
+            VerifyOrReturnError(!encoded.empty(), mWriter.Put(tag, ByteSpan()));
+
+            Platform::ScopedMemoryBuffer<uint8_t> byteString;
+            byteString.Alloc(BASE64_MAX_DECODED_LEN(encoded.size()));
+            VerifyOrReturnError(byteString.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+
+            auto decodedLen = Base64Decode(encoded.data(), static_cast<uint16_t>(encoded.size()), byteString.Get());
+            VerifyOrReturnError(decodedLen < UINT16_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+            return mWriter.PutBytes(tag, byteString.Get(), decodedLen);
+        }
+
+        case TLV::kTLVType_UTF8String: {
+            CharSpan str;
+            Platform::ScopedMemoryBuffer<char> scratch;
+            ReturnErrorOnFailure(ReadString(str, scratch));
+            VerifyOrReturnError(CanCastTo<uint32_t>(str.size()), CHIP_ERROR_INVALID_ARGUMENT);
+            return mWriter.PutString(tag, str.data(), static_cast<uint32_t>(str.size()));
+        }
+
+        case TLV::kTLVType_Null:
+            ReturnErrorOnFailure(ReadLiteral("null"));
+            return mWriter.PutNull(tag);
+
+        case TLV::kTLVType_Structure:
+            return EncodeStructure(tag, static_cast<uint8_t>(depth + 1));
+
+        case TLV::kTLVType_Array:
+            return EncodeArray(tag, ctx.subType, static_cast<uint8_t>(depth + 1));
+
+        default:
+            return CHIP_ERROR_INVALID_TLV_ELEMENT;
+        }
+    }
+
+    const char * mCursor;
+    const char * const mEnd;
+    TLV::TLVWriter & mWriter;
+};
+
+} // namespace
+
+CHIP_ERROR JsonToTlvStream(const CharSpan & json, MutableByteSpan & tlv)
+{
+    TLV::TLVWriter writer;
+    writer.Init(tlv);
+    writer.ImplicitProfileId = kTemporaryImplicitProfileId;
+    ReturnErrorOnFailure(JsonToTlvStream(json, writer));
+    ReturnErrorOnFailure(writer.Finalize());
+    tlv.reduce_size(writer.GetLengthWritten());
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR JsonToTlvStream(const CharSpan & json, TLV::TLVWriter & writer)
+{
+    // Same default as JsonToTlv for tags that need an implicit profile.
+    if (writer.ImplicitProfileId == TLV::kProfileIdNotSpecified)
+    {
+        writer.ImplicitProfileId = kTemporaryImplicitProfileId;
+    }
+
+    JsonTlvEncoder encoder(json, writer);
+    return encoder.Encode();
+}
+
+} // namespace chip
@@ -0,0 +1,48 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/TLV.h>
+#include <lib/support/Span.h>
+
+namespace chip {
+
+constexpr uint8_t kJsonToTlvStreamMaxDepth = 32;
+
+/*
+ * Streaming equivalent of JsonToTlv: parses the JSON text in a single pass and makes the encode calls on the
+ * given TLVWriter as each value is parsed, without building a JSON document first.
+ *
+ * Memory use is bounded by the nesting depth of the payload (at most kJsonToTlvStreamMaxDepth containers).
+ * The only heap allocations are short-lived scratch buffers for BYTES values and for strings that contain
+ * escape sequences; other strings are written straight from the input text.
+ *
+ * Structure members are encoded in the same tag order as JsonToTlv does. Members that already appear in that
+ * order (as written by TlvToJsonStream) are encoded in a single pass; unordered ones are looked up in order,
+ * which costs a scan of the structure per member. The input must be strict JSON: the comments accepted by the
+ * jsoncpp parser are not supported.
+ */
+CHIP_ERROR JsonToTlvStream(const CharSpan & json, TLV::TLVWriter & writer);
+
+/*
+ * Same as above, writing the TLV into the given buffer. The size of tlv will be adjusted to the size of the
+ * actual data written to the buffer.
+ */
+CHIP_ERROR JsonToTlvStream(const CharSpan & json, MutableByteSpan & tlv);
+
+} // namespace chip
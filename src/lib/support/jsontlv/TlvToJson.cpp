@@ -50,33 +50,6 @@ private:
     uint32_t mOldImplicitProfileId;
 };
 
-const char * GetJsonElementStrFromType(const ElementTypeContext & ctx)
-{
-    switch (ctx.tlvType)
-    {
-    case TLV::kTLVType_UnsignedInteger:
-        return kElementTypeUInt;
-    case TLV::kTLVType_SignedInteger:
-        return kElementTypeInt;
-    case TLV::kTLVType_Boolean:
-        return kElementTypeBool;
-    case TLV::kTLVType_FloatingPointNumber:
-        return ctx.isDouble ? kElementTypeDouble : kElementTypeFloat;
-    case TLV::kTLVType_ByteString:
-        return kElementTypeBytes;
-    case TLV::kTLVType_UTF8String:
-        return kElementTypeString;
-    case TLV::kTLVType_Null:
-        return kElementTypeNull;
-    case TLV::kTLVType_Structure:
-        return kElementTypeStruct;
-    case TLV::kTLVType_Array:
-        return kElementTypeArray;
-    default:
-        return kElementTypeEmpty;
-    }
-};
-
 /*
  * Encapsulates the element information required to construct a JSON element name string in a JSON object.
  *
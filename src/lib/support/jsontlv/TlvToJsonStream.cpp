@@ -0,0 +1,435 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include <lib/support/Base64.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/SafeInt.h>
+#include <lib/support/jsontlv/ElementTypes.h>
+#include <lib/support/jsontlv/TlvToJsonStream.h>
+
+namespace chip {
+
+namespace {
+
+// See TlvToJson.cpp: the value does not matter, but one is needed to read 32-bit implicit profile tags.
+constexpr uint32_t kTemporaryImplicitProfileId = 0xFF01;
+
+// Byte strings are base64 encoded in chunks of this many bytes (a multiple of 3, so that only the last
+// chunk is padded).
+constexpr size_t kBase64ChunkSize = 48;
+
+/// RAII to switch the implicit profile id for a reader
+class ImplicitProfileIdChange
+{
+public:
+    ImplicitProfileIdChange(TLV::TLVReader & reader, uint32_t id) : mReader(reader), mOldImplicitProfileId(reader.ImplicitProfileId)
+    {
+        reader.ImplicitProfileId = id;
+    }
+    ~ImplicitProfileIdChange() { mReader.ImplicitProfileId = mOldImplicitProfileId; }
+
+private:
+    TLV::TLVReader & mReader;
+    uint32_t mOldImplicitProfileId;
+};
+
+/*
+ * Buffers small writes so that the output stream sees a few large writes instead of one per token.
+ */
+class JsonEmitter
+{
+public:
+    explicit JsonEmitter(JsonOutputStream & out) : mOut(out) {}
+
+    CHIP_ERROR Put(char c)
+    {
+        if (mLength == sizeof(mBuffer))
+        {
+            ReturnErrorOnFailure(Flush());
+        }
+        mBuffer[mLength++] = c;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR Put(const char * data, size_t length)
+    {
+        if (length > sizeof(mBuffer) - mLength)
+        {
+            ReturnErrorOnFailure(Flush());
+            if (length >= sizeof(mBuffer))
+            {
+                return mOut.Write(data, length);
+            }
+        }
+        memcpy(mBuffer + mLength, data, length);
+        mLength += length;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR Put(const char * str) { return Put(str, strlen(str)); }
+
+    CHIP_ERROR PutQuotedString(const char * data, size_t length)
+    {
+        ReturnErrorOnFailure(Put('"'));
+
+        size_t start = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            const unsigned char c = static_cast<unsigned char>(data[i]);
+            const char * escape   = nullptr;
+            char unicodeEscape[7];
+
+            switch (c)
+            {
+            case '"':
+                escape = "\\\"";
+                break;
+            case '\\':
+                escape = "\\\\";
+                break;
+            case '\b':
+                escape = "\\b";
+                break;
+            case '\f':
+                escape = "\\f";
+                break;
+            case '\n':
+                escape = "\\n";
+                break;
+            case '\r':
+                escape = "\\r";
+                break;
+            case '\t':
+                escape = "\\t";
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    snprintf(unicodeEscape, sizeof(unicodeEscape), "\\u%04x", c);
+                    escape = unicodeEscape;
+                }
+                break;
+            }
+
+            if (escape != nullptr)
+            {
+                ReturnErrorOnFailure(Put(data + start, i - start));
+                ReturnErrorOnFailure(Put(escape));
+                start = i + 1;
+            }
+        }
+
+        ReturnErrorOnFailure(Put(data + start, length - start));
+        return Put('"');
+    }
+
+    CHIP_ERROR Flush()
+    {
+        VerifyOrReturnError(mLength > 0, CHIP_NO_ERROR);
+        CHIP_ERROR err = mOut.Write(mBuffer, mLength);
+        mLength        = 0;
+        return err;
+    }
+
+private:
+    JsonOutputStream & mOut;
+    char mBuffer[128];
+    size_t mLength = 0;
+};
+
+ElementTypeContext GetElementType(TLV::TLVReader & reader)
+{
+    ElementTypeContext type;
+    type.tlvType = reader.GetType();
+    if (type.tlvType == TLV::kTLVType_FloatingPointNumber)
+    {
+        type.isDouble = reader.IsElementDouble();
+    }
+    return type;
+}
+
+/*
+ * Determines the element type of an array without consuming it, as the JSON name of the array
+ * ('TagNumber:ARRAY-SubElementType') has to be written before its elements.
+ */
+CHIP_ERROR PeekArraySubType(const TLV::TLVReader & reader, ElementTypeContext & subType)
+{
+    TLV::TLVReader peekReader;
+    TLV::TLVType containerType;
+
+    peekReader.Init(reader);
+    ReturnErrorOnFailure(peekReader.EnterContainer(containerType));
+
+    CHIP_ERROR err = peekReader.Next();
+    if (err == CHIP_END_OF_TLV)
+    {
+        subType = ElementTypeContext();
+        return CHIP_NO_ERROR;
+    }
+    ReturnErrorOnFailure(err);
+
+    subType = GetElementType(peekReader);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PutElementName(JsonEmitter & out, const TLV::TLVReader & reader, const ElementTypeContext & type,
+                          const ElementTypeContext & subType)
+{
+    TLV::Tag tag       = reader.GetTag();
+    uint32_t tagNumber = TLV::TagNumFromTag(tag);
+    if (TLV::IsProfileTag(tag) && TLV::ProfileIdFromTag(tag) != reader.ImplicitProfileId)
+    {
+        tagNumber = (static_cast<uint32_t>(TLV::VendorIdFromTag(tag)) << 16) | TLV::TagNumFromTag(tag);
+    }
+
+    char tagString[11];
+    snprintf(tagString, sizeof(tagString), "%" PRIu32, tagNumber);
+
+    ReturnErrorOnFailure(out.Put('"'));
+    ReturnErrorOnFailure(out.Put(tagString));
+    ReturnErrorOnFailure(out.Put(':'));
+    ReturnErrorOnFailure(out.Put(GetJsonElementStrFromType(type)));
+    if (type.tlvType == TLV::kTLVType_Array)
+    {
+        ReturnErrorOnFailure(out.Put('-'));
+        ReturnErrorOnFailure(out.Put(GetJsonElementStrFromType(subType)));
+    }
+    return out.Put("\":", 2);
+}
+
+CHIP_ERROR PutDouble(JsonEmitter & out, double v)
+{
+    if (v == std::numeric_limits<double>::infinity())
+    {
+        return out.PutQuotedString(kFloatingPointPositiveInfinity, strlen(kFloatingPointPositiveInfinity));
+    }
+    if (v == -std::numeric_limits<double>::infinity())
+    {
+        return out.PutQuotedString(kFloatingPointNegativeInfinity, strlen(kFloatingPointNegativeInfinity));
+    }
+    if (isnan(v))
+    {
+        // Same as the jsoncpp writer used by TlvToJson.
+        return out.Put("null");
+    }
+
+    // 17 significant digits round-trip any double. Keep a fractional part so the value reads back as a
+    // floating point number.
+    char number[32];
+    int length = snprintf(number, sizeof(number), "%.17g", v);
+    VerifyOrReturnError(length > 0 && static_cast<size_t>(length) < sizeof(number) - 2, CHIP_ERROR_INTERNAL);
+    if (strpbrk(number, ".eE") == nullptr)
+    {
+        number[length++] = '.';
+        number[length++] = '0';
+    }
+    return out.Put(number, static_cast<size_t>(length));
+}
+
+CHIP_ERROR PutByteString(JsonEmitter & out, const ByteSpan & bytes)
+{
+    char encoded[BASE64_ENCODED_LEN(kBase64ChunkSize)];
+
+    ReturnErrorOnFailure(out.Put('"'));
+    for (size_t offset = 0; offset < bytes.size(); offset += kBase64ChunkSize)
+    {
+        size_t chunkSize   = std::min(kBase64ChunkSize, bytes.size() - offset);
+        uint16_t chunkUsed = Base64Encode(bytes.data() + offset, static_cast<uint16_t>(chunkSize), encoded);
+        ReturnErrorOnFailure(out.Put(encoded, chunkUsed));
+    }
+    return out.Put('"');
+}
+
+CHIP_ERROR PutValue(TLV::TLVReader & reader, JsonEmitter & out);
+
+/*
+ * Given a TLVReader positioned at TLV structure this function:
+ *   - enters structure
+ *   - writes all elements of a structure as a JSON object
+ *   - exits structure
+ */
+CHIP_ERROR PutStruct(TLV::TLVReader & reader, JsonEmitter & out)
+{
+    CHIP_ERROR err;
+    TLV::TLVType containerType;
+    bool first = true;
+
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+    ReturnErrorOnFailure(out.Put('{'));
+
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        TLV::Tag tag = reader.GetTag();
+        VerifyOrReturnError(TLV::IsContextTag(tag) || TLV::IsProfileTag(tag), CHIP_ERROR_INVALID_TLV_TAG);
+
+        if (TLV::IsProfileTag(tag) && TLV::VendorIdFromTag(tag) == 0)
+        {
+            VerifyOrReturnError(TLV::TagNumFromTag(tag) > UINT8_MAX, CHIP_ERROR_INVALID_TLV_TAG);
+        }
+
+        ElementTypeContext type = GetElementType(reader);
+        ElementTypeContext subType;
+        if (type.tlvType == TLV::kTLVType_Array)
+        {
+            ReturnErrorOnFailure(PeekArraySubType(reader, subType));
+        }
+
+        if (!first)
+        {
+            ReturnErrorOnFailure(out.Put(','));
+        }
+        first = false;
+
+        ReturnErrorOnFailure(PutElementName(out, reader, type, subType));
+        ReturnErrorOnFailure(PutValue(reader, out));
+    }
+
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    ReturnErrorOnFailure(out.Put('}'));
+    return reader.ExitContainer(containerType);
+}
+
+CHIP_ERROR PutArray(TLV::TLVReader & reader, JsonEmitter & out)
+{
+    CHIP_ERROR err;
+    TLV::TLVType containerType;
+    ElementTypeContext firstSubType;
+    bool first = true;
+
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+    ReturnErrorOnFailure(out.Put('['));
+
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        VerifyOrReturnError(reader.GetTag() == TLV::AnonymousTag(), CHIP_ERROR_INVALID_TLV_TAG);
+        VerifyOrReturnError(reader.GetType() != TLV::kTLVType_Array, CHIP_ERROR_INVALID_TLV_ELEMENT);
+
+        ElementTypeContext subType = GetElementType(reader);
+        if (first)
+        {
+            firstSubType = subType;
+        }
+        else
+        {
+            VerifyOrReturnError(firstSubType.tlvType == subType.tlvType && firstSubType.isDouble == subType.isDouble,
+                                CHIP_ERROR_INVALID_TLV_ELEMENT);
+            ReturnErrorOnFailure(out.Put(','));
+        }
+        first = false;
+
+        ReturnErrorOnFailure(PutValue(reader, out));
+    }
+
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    ReturnErrorOnFailure(out.Put(']'));
+    return reader.ExitContainer(containerType);
+}
+
+CHIP_ERROR PutValue(TLV::TLVReader & reader, JsonEmitter & out)
+{
+    char number[24];
+
+    switch (reader.GetType())
+    {
+    case TLV::kTLVType_UnsignedInteger: {
+        uint64_t v;
+        ReturnErrorOnFailure(reader.Get(v));
+        snprintf(number, sizeof(number), "%" PRIu64, v);
+        // Values that do not fit in 32 bits are written as strings, see README.md.
+        return CanCastTo<uint32_t>(v) ? out.Put(number) : out.PutQuotedString(number, strlen(number));
+    }
+
+    case TLV::kTLVType_SignedInteger: {
+        int64_t v;
+        ReturnErrorOnFailure(reader.Get(v));
+        snprintf(number, sizeof(number), "%" PRId64, v);
+        return CanCastTo<int32_t>(v) ? out.Put(number) : out.PutQuotedString(number, strlen(number));
+    }
+
+    case TLV::kTLVType_Boolean: {
+        bool v;
+        ReturnErrorOnFailure(reader.Get(v));
+        return out.Put(v ? "true" : "false");
+    }
+
+    case TLV::kTLVType_FloatingPointNumber: {
+        double v;
+        ReturnErrorOnFailure(reader.Get(v));
+        return PutDouble(out, v);
+    }
+
+    case TLV::kTLVType_ByteString: {
+        ByteSpan span;
+        ReturnErrorOnFailure(reader.Get(span));
+        return PutByteString(out, span);
+    }
+
+    case TLV::kTLVType_UTF8String: {
+        CharSpan span;
+        ReturnErrorOnFailure(reader.Get(span));
+        return out.PutQuotedString(span.data(), span.size());
+    }
+
+    case TLV::kTLVType_Null:
+        return out.Put("null");
+
+    case TLV::kTLVType_Structure:
+        return PutStruct(reader, out);
+
+    case TLV::kTLVType_Array:
+        return PutArray(reader, out);
+
+    default:
+        return CHIP_ERROR_INVALID_TLV_ELEMENT;
+    }
+}
+
+} // namespace
+
+CHIP_ERROR TlvToJsonStream(const ByteSpan & tlv, JsonOutputStream & out)
+{
+    TLV::TLVReader reader;
+    reader.Init(tlv);
+    reader.ImplicitProfileId = kTemporaryImplicitProfileId;
+
+    ReturnErrorOnFailure(reader.Next());
+    return TlvToJsonStream(reader, out);
+}
+
+CHIP_ERROR TlvToJsonStream(TLV::TLVReader & reader, JsonOutputStream & out)
+{
+    // The top level element must be a TLV Structure of Anonymous type.
+    VerifyOrReturnError(reader.GetType() == TLV::kTLVType_Structure, CHIP_ERROR_WRONG_TLV_TYPE);
+    VerifyOrReturnError(reader.GetTag() == TLV::AnonymousTag(), CHIP_ERROR_INVALID_TLV_TAG);
+
+    // During json conversion, a implicit profile ID is required
+    ImplicitProfileIdChange implicitProfileIdChange(reader, kTemporaryImplicitProfileId);
+
+    JsonEmitter emitter(out);
+    ReturnErrorOnFailure(PutStruct(reader, emitter));
+    return emitter.Flush();
+}
+
+} // namespace chip
@@ -0,0 +1,97 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/TLV.h>
+#include <lib/support/Span.h>
+
+#include <string.h>
+#include <string>
+
+namespace chip {
+
+/*
+ * Destination for the JSON text produced by TlvToJsonStream. Text is handed over in small chunks as
+ * the TLV is walked, so a sink may forward it (e.g. to a socket) without holding the whole document.
+ */
+class JsonOutputStream
+{
+public:
+    virtual ~JsonOutputStream() = default;
+
+    virtual CHIP_ERROR Write(const char * data, size_t length) = 0;
+};
+
+/*
+ * Appends the JSON text to a std::string.
+ */
+class StringJsonOutputStream : public JsonOutputStream
+{
+public:
+    explicit StringJsonOutputStream(std::string & out) : mOut(out) {}
+
+    CHIP_ERROR Write(const char * data, size_t length) override
+    {
+        mOut.append(data, length);
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    std::string & mOut;
+};
+
+/*
+ * Writes the JSON text into a fixed caller-provided buffer. Fails with CHIP_ERROR_BUFFER_TOO_SMALL once
+ * the buffer is full. The text is not NUL terminated.
+ */
+class BufferJsonOutputStream : public JsonOutputStream
+{
+public:
+    explicit BufferJsonOutputStream(MutableCharSpan buffer) : mBuffer(buffer) {}
+
+    CHIP_ERROR Write(const char * data, size_t length) override
+    {
+        VerifyOrReturnError(length <= mBuffer.size() - mLengthWritten, CHIP_ERROR_BUFFER_TOO_SMALL);
+        memcpy(mBuffer.data() + mLengthWritten, data, length);
+        mLengthWritten += length;
+        return CHIP_NO_ERROR;
+    }
+
+    CharSpan GetWritten() const { return CharSpan(mBuffer.data(), mLengthWritten); }
+
+private:
+    MutableCharSpan mBuffer;
+    size_t mLengthWritten = 0;
+};
+
+/*
+ * Streaming equivalent of TlvToJson: given a TLVReader positioned at a data model payload (an anonymous
+ * structure), writes its compact JSON representation to the output stream while walking the reader.
+ *
+ * Unlike TlvToJson, no intermediate JSON document is built: memory use is bounded by the nesting depth of
+ * the payload, and the only heap use is the output stream itself. The generated JSON is equivalent to the
+ * one produced by TlvToJson (same element names and values) but is not pretty-printed.
+ */
+CHIP_ERROR TlvToJsonStream(TLV::TLVReader & reader, JsonOutputStream & out);
+
+/*
+ * Given a TLV encoded byte array, writes its JSON representation to the output stream.
+ */
+CHIP_ERROR TlvToJsonStream(const ByteSpan & tlv, JsonOutputStream & out);
+
+} // namespace chip
@@ -0,0 +1,328 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <lib/core/TLV.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/Span.h>
+#include <lib/support/jsontlv/JsonToTlv.h>
+#include <lib/support/jsontlv/JsonToTlvStream.h>
+#include <lib/support/jsontlv/TextFormat.h>
+#include <lib/support/jsontlv/TlvToJson.h>
+#include <lib/support/jsontlv/TlvToJsonStream.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+namespace {
+
+using namespace chip;
+
+class TestJsonTlvStream : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+};
+
+// Covers every element type of the JSON format, including the string encoded ones.
+CHIP_ERROR EncodeAllTypes(TLV::TLVWriter & writer)
+{
+    TLV::TLVType outer;
+    TLV::TLVType inner;
+    const uint8_t bytes[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0xFF, 0x4A, 0xEF, 0x88 };
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outer));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(0), static_cast<uint64_t>(42)));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(1), static_cast<uint64_t>(0x123456789)));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(2), static_cast<int64_t>(-17)));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(3), static_cast<int64_t>(-40000000000)));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(4), true));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(5), 17.5f));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(6), 1234.5678));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(7), -std::numeric_limits<double>::infinity()));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(8), ByteSpan(bytes)));
+    ReturnErrorOnFailure(writer.PutString(TLV::ContextTag(9), "quote \" backslash \\ newline \n tab \t"));
+    ReturnErrorOnFailure(writer.PutNull(TLV::ContextTag(10)));
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::ContextTag(11), TLV::kTLVType_Structure, inner));
+    ReturnErrorOnFailure(writer.PutString(TLV::ContextTag(1), "John"));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(2), static_cast<uint64_t>(34)));
+    ReturnErrorOnFailure(writer.EndContainer(inner));
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::ContextTag(12), TLV::kTLVType_Array, inner));
+    ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), 1.5));
+    ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), 62534.0));
+    ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), std::numeric_limits<double>::infinity()));
+    ReturnErrorOnFailure(writer.EndContainer(inner));
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::ContextTag(13), TLV::kTLVType_Array, inner));
+    ReturnErrorOnFailure(writer.EndContainer(inner));
+
+    // Profile tags are sorted by tag number, whatever their profile.
+    ReturnErrorOnFailure(writer.Put(TLV::ProfileTag(0xFFF1, 0, 0xAA), static_cast<uint64_t>(3)));
+    ReturnErrorOnFailure(writer.Put(TLV::ProfileTag(writer.ImplicitProfileId, 1000), static_cast<uint64_t>(7)));
+    ReturnErrorOnFailure(writer.EndContainer(outer));
+    return writer.Finalize();
+}
+
+// A large attribute list: an array of structures, as found in e.g. a long ACL or binding report.
+CHIP_ERROR EncodeAttributeList(TLV::TLVWriter & writer, size_t entryCount)
+{
+    TLV::TLVType outer;
+    TLV::TLVType list;
+    TLV::TLVType entry;
+    TLV::TLVType targets;
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outer));
+    ReturnErrorOnFailure(writer.StartContainer(TLV::ContextTag(0), TLV::kTLVType_Array, list));
+    for (size_t i = 0; i < entryCount; i++)
+    {
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, entry));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(1), static_cast<uint64_t>(5)));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(2), static_cast<uint64_t>(2)));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(3), static_cast<uint64_t>(0x1122334455660000 + i)));
+        ReturnErrorOnFailure(writer.PutString(TLV::ContextTag(4), "Living room light"));
+        ReturnErrorOnFailure(writer.StartContainer(TLV::ContextTag(5), TLV::kTLVType_Array, targets));
+        ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), static_cast<uint64_t>(i % 256)));
+        ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), static_cast<uint64_t>(6)));
+        ReturnErrorOnFailure(writer.EndContainer(targets));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(254), static_cast<uint64_t>(1)));
+        ReturnErrorOnFailure(writer.EndContainer(entry));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(list));
+    ReturnErrorOnFailure(writer.EndContainer(outer));
+    return writer.Finalize();
+}
+
+TEST_F(TestJsonTlvStream, TestRoundTripAllTypes)
+{
+    uint8_t buf[512];
+    TLV::TLVWriter writer;
+    writer.Init(buf);
+    writer.ImplicitProfileId = 0xFF01;
+    ASSERT_EQ(EncodeAllTypes(writer), CHIP_NO_ERROR);
+    ByteSpan tlv(buf, writer.GetLengthWritten());
+
+    std::string expectedJson;
+    ASSERT_EQ(TlvToJson(tlv, expectedJson), CHIP_NO_ERROR);
+
+    std::string streamedJson;
+    StringJsonOutputStream out(streamedJson);
+    ASSERT_EQ(TlvToJsonStream(tlv, out), CHIP_NO_ERROR);
+    EXPECT_EQ(PrettyPrintJsonString(streamedJson), PrettyPrintJsonString(expectedJson));
+
+    uint8_t encodedBuf[512];
+    MutableByteSpan encoded(encodedBuf);
+    ASSERT_EQ(JsonToTlvStream(CharSpan(streamedJson.data(), streamedJson.size()), encoded), CHIP_NO_ERROR);
+    EXPECT_TRUE(encoded.data_equal(tlv));
+
+    // The output of TlvToJson is accepted as well, although jsoncpp writes the members in name order.
+    encoded = MutableByteSpan(encodedBuf);
+    ASSERT_EQ(JsonToTlvStream(CharSpan(expectedJson.data(), expectedJson.size()), encoded), CHIP_NO_ERROR);
+    EXPECT_TRUE(encoded.data_equal(tlv));
+}
+
+TEST_F(TestJsonTlvStream, TestJsonToTlvStreamMatchesJsonToTlv)
+{
+    const std::string json = "{\n"
+                             "    \"0:ARRAY-STRUCT\" : [ { \"0:INT\" : 8, \"1:BOOL\" : true } ],\n"
+                             "    \"1:STRUCT\" : { \"0:INT\" : 12, \"1:BOOL\" : false, \"2:STRING\" : \"ex\\u00e9mple\\n\" },\n"
+                             "    \"2:INT\" : \"40000000000\",\n"
+                             "    \"isQualified:3:BOOL\" : true,\n"
+                             "    \"4:ARRAY-?\" : [],\n"
+                             "    \"5:ARRAY-DOUBLE\" : [ 1.1, 134.2763, -12345.87, \"Infinity\", 62534, -62534 ],\n"
+                             "    \"6:ARRAY-BYTES\" : [ \"AAECAwQ=\", \"/w==\", \"Su+I\" ],\n"
+                             "    \"7:BYTES\" : \"VGVzdCBCeXRlcw==\",\n"
+                             "    \"8:DOUBLE\" : 17.9,\n"
+                             "    \"9:FLOAT\" : 17.9,\n"
+                             "    \"10:FLOAT\" : \"-Infinity\",\n"
+                             "    \"11:NULL\" : null,\n"
+                             "    \"12:BYTES\" : \"\",\n"
+                             "    \"4293984426:UINT\" : 3,\n"
+                             "    \"1000:UINT\" : 3\n"
+                             "}\n";
+
+    uint8_t expectedBuf[256];
+    MutableByteSpan expected(expectedBuf);
+    ASSERT_EQ(JsonToTlv(json, expected), CHIP_NO_ERROR);
+
+    uint8_t encodedBuf[256];
+    MutableByteSpan encoded(encodedBuf);
+    ASSERT_EQ(JsonToTlvStream(CharSpan(json.data(), json.size()), encoded), CHIP_NO_ERROR);
+    EXPECT_TRUE(encoded.data_equal(expected));
+}
+
+TEST_F(TestJsonTlvStream, TestJsonToTlvStreamErrors)
+{
+    const char * invalidInputs[] = {
+        "",                                         // no top level structure
+        "[]",                                       // top level is not a structure
+        "{\"1:UINT\" : 1} x",                       // trailing garbage
+        "{\"1:UINT\" : 1,}",                        // trailing comma
+        "{\"1:UINT\" : -1}",                        // negative unsigned
+        "{\"1:UINT\" : 1.5}",                       // fractional integer
+        "{\"1:INT\" : \"12a\"}",                    // malformed integer string
+        "{\"1:FLOAT\" : \"NaN\"}",                  // only infinities may be strings
+        "{\"1:BOOL\" : 1}",                         // wrong JSON type
+        "{\"1:BYTES\" : \"AAE\"}",                  // base64 without padding
+        "{\"1:STRING\" : \"unterminated}",          // unterminated string
+        "{\"1:STRING\" : \"bad \\q escape\"}",      // unknown escape
+        "{\"1:UNKNOWN\" : 1}",                      // unknown element type
+        "{\"a:b:1:UINT\" : 1}",                     // too many name fields
+        "{\"1\" : 1}",                              // missing element type
+        "{\"1:ARRAY\" : []}",                       // missing array element type
+        "{\"1:ARRAY-?\" : [1]}",                    // unknown element type for a non-empty array
+        "{\"1:ARRAY-ARRAY\" : []}",                 // nested arrays
+        "{\"1:UINT\" : 1, \"1:UINT\" : 1}",         // duplicate members
+        "{\"1:UINT\":1,\"0:UINT\":1,\"1:UINT\":1}", // duplicate unordered members
+        "{\"1:UINT\" : 1 /* comment */}",           // comments are not JSON
+    };
+
+    for (const char * input : invalidInputs)
+    {
+        uint8_t buf[64];
+        MutableByteSpan tlv(buf);
+        EXPECT_NE(JsonToTlvStream(CharSpan::fromCharString(input), tlv), CHIP_NO_ERROR) << input;
+    }
+
+    // Nesting is bounded.
+    std::string deep;
+    for (uint8_t i = 0; i < kJsonToTlvStreamMaxDepth; i++)
+    {
+        deep += "{\"1:STRUCT\":";
+    }
+    deep += "{}";
+    for (uint8_t i = 0; i < kJsonToTlvStreamMaxDepth; i++)
+    {
+        deep += "}";
+    }
+    uint8_t buf[256];
+    MutableByteSpan tlv(buf);
+    EXPECT_EQ(JsonToTlvStream(CharSpan(deep.data(), deep.size()), tlv), CHIP_ERROR_RECURSION_DEPTH_LIMIT);
+}
+
+TEST_F(TestJsonTlvStream, TestTlvToJsonStreamErrors)
+{
+    uint8_t buf[512];
+    TLV::TLVWriter writer;
+    TLV::TLVType outer;
+    TLV::TLVType array;
+
+    // Mixed element types in an array.
+    writer.Init(buf);
+    ASSERT_EQ(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outer), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.StartContainer(TLV::ContextTag(1), TLV::kTLVType_Array, array), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.Put(TLV::AnonymousTag(), static_cast<uint64_t>(1)), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.Put(TLV::AnonymousTag(), true), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.EndContainer(array), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.EndContainer(outer), CHIP_NO_ERROR);
+    ASSERT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+
+    std::string json;
+    StringJsonOutputStream stringOut(json);
+    EXPECT_EQ(TlvToJsonStream(ByteSpan(buf, writer.GetLengthWritten()), stringOut), CHIP_ERROR_INVALID_TLV_ELEMENT);
+
+    // Output that does not fit in a fixed buffer.
+    writer.Init(buf);
+    writer.ImplicitProfileId = 0xFF01;
+    ASSERT_EQ(EncodeAllTypes(writer), CHIP_NO_ERROR);
+    char small[32];
+    BufferJsonOutputStream bufferOut{ MutableCharSpan(small) };
+    EXPECT_EQ(TlvToJsonStream(ByteSpan(buf, writer.GetLengthWritten()), bufferOut), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    char large[512];
+    BufferJsonOutputStream largeOut{ MutableCharSpan(large) };
+    ASSERT_EQ(TlvToJsonStream(ByteSpan(buf, writer.GetLengthWritten()), largeOut), CHIP_NO_ERROR);
+    std::string expectedJson;
+    ASSERT_EQ(TlvToJson(ByteSpan(buf, writer.GetLengthWritten()), expectedJson), CHIP_NO_ERROR);
+    EXPECT_EQ(PrettyPrintJsonString(std::string(largeOut.GetWritten().data(), largeOut.GetWritten().size())),
+              PrettyPrintJsonString(expectedJson));
+}
+
+// Benchmark: convert a 1000 entry attribute list in both directions with the jsoncpp based converters
+// and with the streaming ones. Disabled by default, as it only reports timings.
+TEST_F(TestJsonTlvStream, DISABLED_BenchmarkLargeAttributeList)
+{
+    constexpr size_t kEntryCount = 1000;
+    constexpr int kIterations    = 10;
+    using Clock                  = std::chrono::steady_clock;
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    std::vector<uint8_t> tlvBuf(kEntryCount * 64);
+    TLV::TLVWriter writer;
+    writer.Init(tlvBuf.data(), tlvBuf.size());
+    ASSERT_EQ(EncodeAttributeList(writer, kEntryCount), CHIP_NO_ERROR);
+    ByteSpan tlv(tlvBuf.data(), writer.GetLengthWritten());
+
+    std::string treeJson;
+    auto start = Clock::now();
+    for (int i = 0; i < kIterations; i++)
+    {
+        treeJson.clear();
+        ASSERT_EQ(TlvToJson(tlv, treeJson), CHIP_NO_ERROR);
+    }
+    auto treeTlvToJson = Clock::now() - start;
+
+    std::string streamJson;
+    streamJson.reserve(treeJson.size());
+    start = Clock::now();
+    for (int i = 0; i < kIterations; i++)
+    {
+        streamJson.clear();
+        StringJsonOutputStream out(streamJson);
+        ASSERT_EQ(TlvToJsonStream(tlv, out), CHIP_NO_ERROR);
+    }
+    auto streamTlvToJson = Clock::now() - start;
+    EXPECT_EQ(PrettyPrintJsonString(streamJson), PrettyPrintJsonString(treeJson));
+
+    std::vector<uint8_t> encodedBuf(tlvBuf.size());
+    MutableByteSpan encoded;
+    start = Clock::now();
+    for (int i = 0; i < kIterations; i++)
+    {
+        encoded = MutableByteSpan(encodedBuf.data(), encodedBuf.size());
+        ASSERT_EQ(JsonToTlv(streamJson, encoded), CHIP_NO_ERROR);
+    }
+    auto treeJsonToTlv = Clock::now() - start;
+    EXPECT_TRUE(encoded.data_equal(tlv));
+
+    start = Clock::now();
+    for (int i = 0; i < kIterations; i++)
+    {
+        encoded = MutableByteSpan(encodedBuf.data(), encodedBuf.size());
+        ASSERT_EQ(JsonToTlvStream(CharSpan(streamJson.data(), streamJson.size()), encoded), CHIP_NO_ERROR);
+    }
+    auto streamJsonToTlv = Clock::now() - start;
+    EXPECT_TRUE(encoded.data_equal(tlv));
+
+    ChipLogProgress(Support, "%u entry list (%u TLV bytes): TlvToJson %u us, TlvToJsonStream %u us",
+                    static_cast<unsigned>(kEntryCount), static_cast<unsigned>(tlv.size()),
+                    static_cast<unsigned>(duration_cast<microseconds>(treeTlvToJson).count() / kIterations),
+                    static_cast<unsigned>(duration_cast<microseconds>(streamTlvToJson).count() / kIterations));
+    ChipLogProgress(Support, "%u entry list (%u JSON bytes): JsonToTlv %u us, JsonToTlvStream %u us",
+                    static_cast<unsigned>(kEntryCount), static_cast<unsigned>(streamJson.size()),
+                    static_cast<unsigned>(duration_cast<microseconds>(treeJsonToTlv).count() / kIterations),
+                    static_cast<unsigned>(duration_cast<microseconds>(streamJsonToTlv).count() / kIterations));
+}
+
+} // namespace
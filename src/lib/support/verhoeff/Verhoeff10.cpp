@@ -57,7 +57,9 @@ char Verhoeff10::ComputeCheckChar(const char * str, size_t strLen)
         if (val < 0)
             return 0; // invalid character
 
-        int p = Verhoeff::Permute(val, sPermTable, Base, i);
+        // sPermTable is a permutation of order 8: applying it i % 8 times is the same, and bounds the
+        // work per character.
+        int p = Verhoeff::Permute(val, sPermTable, Base, i % 8);
 
 #ifdef VERHOEFF10_NO_MULTIPLY_TABLE
         c = Verhoeff::DihedralMultiply(c, p, PolygonSize);
@@ -259,6 +259,10 @@ private:
     ExchangeSessionHolder mSession; // The connection state
     uint16_t mExchangeId;           // Assigned exchange ID.
 
+    // Owned by ExchangeManager: the bucket of its exchange index this exchange is in, and the next exchange in that bucket.
+    size_t mIndexBucket               = 0;
+    ExchangeContext * mNextIndexEntry = nullptr;
+
     /**
      *  Track whether we are now expecting a response to a message sent via this exchange (because that
      *  message had the kExpectResponse flag set in its sendFlags).
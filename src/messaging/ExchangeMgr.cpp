@@ -74,6 +74,7 @@ CHIP_ERROR ExchangeManager::Init(SessionManager * sessionManager)
         // then re-initializes without removing registered handlers.
         handler.Reset();
     }
+    RebuildUMHIndex();
 
     sessionManager->SetMessageDelegate(this);
 
@@ -115,7 +116,66 @@ ExchangeContext * ExchangeManager::NewContext(const SessionHandle & session, Exc
         // Disallow creating exchange on an inactive session
         return nullptr;
     }
-    return mContextPool.CreateObject(this, mNextExchangeId++, session, isInitiator, delegate);
+    return AllocateContext(mNextExchangeId++, session, isInitiator, delegate);
+}
+
+void ExchangeManager::ReleaseContext(ExchangeContext * ec)
+{
+    ExchangeContext ** link = &mExchangeIndex[ec->mIndexBucket];
+    while (*link != nullptr && *link != ec)
+    {
+        link = &(*link)->mNextIndexEntry;
+    }
+    if (*link == ec)
+    {
+        *link = ec->mNextIndexEntry;
+    }
+
+    mContextPool.ReleaseObject(ec);
+}
+
+size_t ExchangeManager::ExchangeIndexBucket(const Transport::Session * session, uint16_t exchangeId, bool isInitiator)
+{
+    uint64_t key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(session));
+    key ^= (static_cast<uint64_t>(exchangeId) << 1) | (isInitiator ? 1u : 0u);
+    // Multiplicative hashing spreads both the session addresses and the sequentially allocated exchange ids.
+    key *= UINT64_C(0x9E3779B97F4A7C15);
+    return static_cast<size_t>((key >> 32) % kExchangeIndexBucketCount);
+}
+
+ExchangeContext * ExchangeManager::AllocateContext(uint16_t exchangeId, const SessionHandle & session, bool isInitiator,
+                                                   ExchangeDelegate * delegate, bool isEphemeralExchange)
+{
+    ExchangeContext * ec = mContextPool.CreateObject(this, exchangeId, session, isInitiator, delegate, isEphemeralExchange);
+    VerifyOrReturnValue(ec != nullptr, nullptr);
+
+    // Append, so that lookups keep preferring the oldest of several matching exchanges, as a scan of the pool would.
+    ec->mIndexBucket        = ExchangeIndexBucket(session.operator->(), exchangeId, isInitiator);
+    ExchangeContext ** link = &mExchangeIndex[ec->mIndexBucket];
+    while (*link != nullptr)
+    {
+        link = &(*link)->mNextIndexEntry;
+    }
+    *link = ec;
+
+    return ec;
+}
+
+ExchangeContext * ExchangeManager::FindContext(const SessionHandle & session, const PacketHeader & packetHeader,
+                                               const PayloadHeader & payloadHeader)
+{
+    // A matching exchange is the initiator iff the message was not sent by one.
+    size_t bucket = ExchangeIndexBucket(session.operator->(), payloadHeader.GetExchangeID(), !payloadHeader.IsInitiator());
+    for (ExchangeContext * ec = mExchangeIndex[bucket]; ec != nullptr; ec = ec->mNextIndexEntry)
+    {
+        // The index only narrows the search: exchanges whose session has been released stay in their bucket until they are
+        // freed, and MatchExchange rejects them.
+        if (ec->MatchExchange(session, packetHeader, payloadHeader))
+        {
+            return ec;
+        }
+    }
+    return nullptr;
 }
 
 CHIP_ERROR ExchangeManager::RegisterUnsolicitedMessageHandlerForProtocol(Protocols::Id protocolId,
@@ -164,6 +224,7 @@ CHIP_ERROR ExchangeManager::RegisterUMH(Protocols::Id protocolId, int16_t msgTyp
     selected->Handler     = handler;
     selected->ProtocolId  = protocolId;
     selected->MessageType = msgType;
+    RebuildUMHIndex();
 
     SYSTEM_STATS_INCREMENT(chip::System::Stats::kExchangeMgr_NumUMHandlers);
 
@@ -177,6 +238,7 @@ CHIP_ERROR ExchangeManager::UnregisterUMH(Protocols::Id protocolId, int16_t msgT
         if (umh.IsInUse() && umh.Matches(protocolId, msgType))
         {
             umh.Reset();
+            RebuildUMHIndex();
             SYSTEM_STATS_DECREMENT(chip::System::Stats::kExchangeMgr_NumUMHandlers);
             return CHIP_NO_ERROR;
         }
@@ -185,6 +247,51 @@ CHIP_ERROR ExchangeManager::UnregisterUMH(Protocols::Id protocolId, int16_t msgT
     return CHIP_ERROR_NO_UNSOLICITED_MESSAGE_HANDLER;
 }
 
+size_t ExchangeManager::UMHBucket(Protocols::Id protocolId, int16_t msgType)
+{
+    uint32_t key = protocolId.ToFullyQualifiedSpecForm() ^ (static_cast<uint32_t>(static_cast<uint16_t>(msgType)) << 8);
+    key *= 0x9E3779B1u;
+    return static_cast<size_t>((key >> 16) % kUMHBucketCount);
+}
+
+void ExchangeManager::RebuildUMHIndex()
+{
+    for (auto & entry : mUMHIndex)
+    {
+        entry = kNoUMH;
+    }
+
+    for (size_t i = 0; i < ArraySize(UMHandlerPool); ++i)
+    {
+        const auto & umh = UMHandlerPool[i];
+        if (!umh.IsInUse())
+        {
+            continue;
+        }
+
+        // Linear probing; the table is at most half full, so there always is a free bucket.
+        size_t bucket = UMHBucket(umh.ProtocolId, umh.MessageType);
+        while (mUMHIndex[bucket] != kNoUMH)
+        {
+            bucket = (bucket + 1) % kUMHBucketCount;
+        }
+        mUMHIndex[bucket] = static_cast<uint8_t>(i);
+    }
+}
+
+ExchangeManager::UnsolicitedMessageHandlerSlot * ExchangeManager::FindUMH(Protocols::Id protocolId, int16_t msgType)
+{
+    for (size_t bucket = UMHBucket(protocolId, msgType); mUMHIndex[bucket] != kNoUMH; bucket = (bucket + 1) % kUMHBucketCount)
+    {
+        auto & umh = UMHandlerPool[mUMHIndex[bucket]];
+        if (umh.Matches(protocolId, msgType))
+        {
+            return &umh;
+        }
+    }
+    return nullptr;
+}
+
 void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const PayloadHeader & payloadHeader,
                                         const SessionHandle & session, DuplicateMessage isDuplicate,
                                         System::PacketBufferHandle && msgBuf)
@@ -238,23 +345,14 @@ void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const
     if (!packetHeader.IsGroupSession())
     {
         // Search for an existing exchange that the message applies to. If a match is found...
-        bool found = false;
-        mContextPool.ForEachActiveObject([&](auto * ec) {
-            if (ec->MatchExchange(session, packetHeader, payloadHeader))
-            {
-                ChipLogDetail(ExchangeManager, "Found matching exchange: " ChipLogFormatExchange ", Delegate: %p",
-                              ChipLogValueExchange(ec), ec->GetDelegate());
-
-                // Matched ExchangeContext; send to message handler.
-                ec->HandleMessage(packetHeader.GetMessageCounter(), payloadHeader, msgFlags, std::move(msgBuf));
-                found = true;
-                return Loop::Break;
-            }
-            return Loop::Continue;
-        });
-
-        if (found)
+        ExchangeContext * ec = FindContext(session, packetHeader, payloadHeader);
+        if (ec != nullptr)
         {
+            ChipLogDetail(ExchangeManager, "Found matching exchange: " ChipLogFormatExchange ", Delegate: %p",
+                          ChipLogValueExchange(ec), ec->GetDelegate());
+
+            // Matched ExchangeContext; send to message handler.
+            ec->HandleMessage(packetHeader.GetMessageCounter(), payloadHeader, msgFlags, std::move(msgBuf));
             return;
         }
     }
@@ -279,21 +377,10 @@ void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const
     {
         // Search for an unsolicited message handler that can handle the message. Prefer handlers that can explicitly
         // handle the message type over handlers that handle all messages for a profile.
-        matchingUMH = nullptr;
-
-        for (auto & umh : UMHandlerPool)
+        matchingUMH = FindUMH(payloadHeader.GetProtocolID(), static_cast<int16_t>(payloadHeader.GetMessageType()));
+        if (matchingUMH == nullptr)
         {
-            if (umh.IsInUse() && payloadHeader.HasProtocol(umh.ProtocolId))
-            {
-                if (umh.MessageType == payloadHeader.GetMessageType())
-                {
-                    matchingUMH = &umh;
-                    break;
-                }
-
-                if (umh.MessageType == kAnyMessageType)
-                    matchingUMH = &umh;
-            }
+            matchingUMH = FindUMH(payloadHeader.GetProtocolID(), kAnyMessageType);
         }
     }
     // Discard the message if it isn't marked as being sent by an initiator and the message does not need to send
@@ -329,7 +416,7 @@ void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const
             return;
         }
 
-        ExchangeContext * ec = mContextPool.CreateObject(this, payloadHeader.GetExchangeID(), session, false, delegate);
+        ExchangeContext * ec = AllocateContext(payloadHeader.GetExchangeID(), session, false, delegate);
 
         if (ec == nullptr)
         {
@@ -381,8 +468,8 @@ void ExchangeManager::SendStandaloneAckIfNeeded(const PacketHeader & packetHeade
     // If rcvd msg is from initiator then this exchange is created as not Initiator.
     // If rcvd msg is not from initiator then this exchange is created as Initiator.
     // Create a EphemeralExchange to generate a StandaloneAck
-    ExchangeContext * ec = mContextPool.CreateObject(this, payloadHeader.GetExchangeID(), session, !payloadHeader.IsInitiator(),
-                                                     nullptr, true /* IsEphemeralExchange */);
+    ExchangeContext * ec = AllocateContext(payloadHeader.GetExchangeID(), session, !payloadHeader.IsInitiator(), nullptr,
+                                           true /* IsEphemeralExchange */);
 
     if (ec == nullptr)
     {
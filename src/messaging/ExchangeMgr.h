@@ -108,7 +108,7 @@ public:
      */
     ExchangeContext * NewContext(const SessionHandle & session, ExchangeDelegate * delegate, bool isInitiator = true);
 
-    void ReleaseContext(ExchangeContext * ec) { mContextPool.ReleaseObject(ec); }
+    void ReleaseContext(ExchangeContext * ec);
 
     /**
      *  Register an unsolicited message handler for a given protocol identifier. This handler would be
@@ -243,8 +243,31 @@ private:
 
     UnsolicitedMessageHandlerSlot UMHandlerPool[CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS];
 
+    // Active exchanges hashed by (session, exchange id, initiator flag), so that an incoming message is matched against the
+    // few exchanges of its bucket instead of every exchange in mContextPool.  Buckets are chained through
+    // ExchangeContext::mNextIndexEntry, in allocation order.
+    static constexpr size_t kExchangeIndexBucketCount = CHIP_CONFIG_EXCHANGE_INDEX_BUCKET_COUNT;
+    static_assert(kExchangeIndexBucketCount > 0, "The exchange index needs at least one bucket");
+    ExchangeContext * mExchangeIndex[kExchangeIndexBucketCount] = {};
+
+    // Unsolicited message handlers hashed by (protocol, message type), as indices into UMHandlerPool.  The table is kept at
+    // most half full and is rebuilt whenever a handler is registered or unregistered, which is rare compared to lookups.
+    static constexpr size_t kUMHBucketCount = 2 * CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS + 1;
+    static constexpr uint8_t kNoUMH         = UINT8_MAX;
+    static_assert(CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS < kNoUMH, "Too many unsolicited message handlers");
+    uint8_t mUMHIndex[kUMHBucketCount];
+
     CHIP_ERROR RegisterUMH(Protocols::Id protocolId, int16_t msgType, UnsolicitedMessageHandler * handler);
     CHIP_ERROR UnregisterUMH(Protocols::Id protocolId, int16_t msgType);
+    void RebuildUMHIndex();
+    static size_t UMHBucket(Protocols::Id protocolId, int16_t msgType);
+    UnsolicitedMessageHandlerSlot * FindUMH(Protocols::Id protocolId, int16_t msgType);
+
+    static size_t ExchangeIndexBucket(const Transport::Session * session, uint16_t exchangeId, bool isInitiator);
+    ExchangeContext * AllocateContext(uint16_t exchangeId, const SessionHandle & session, bool isInitiator,
+                                      ExchangeDelegate * delegate, bool isEphemeralExchange = false);
+    ExchangeContext * FindContext(const SessionHandle & session, const PacketHeader & packetHeader,
+                                  const PayloadHeader & payloadHeader);
 
     void OnMessageReceived(const PacketHeader & packetHeader, const PayloadHeader & payloadHeader, const SessionHandle & session,
                            DuplicateMessage isDuplicate, System::PacketBufferHandle && msgBuf) override;
@@ -0,0 +1,243 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests and a benchmark for the way the ExchangeManager
+ *      dispatches received messages to exchanges and unsolicited message handlers.
+ */
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <lib/core/CHIPCore.h>
+#include <lib/support/CodeUtils.h>
+#include <messaging/ExchangeContext.h>
+#include <messaging/ExchangeMgr.h>
+#include <messaging/tests/MessagingContext.h>
+#include <protocols/Protocols.h>
+#include <transport/SessionMessageDelegate.h>
+
+#if CHIP_CRYPTO_PSA
+#include "psa/crypto.h"
+#endif
+
+namespace {
+
+using namespace chip;
+using namespace chip::Messaging;
+
+struct TestExchangeDispatch : public chip::Test::LoopbackMessagingContext, public ::testing::Test
+{
+    static void SetUpTestSuite() { chip::Test::LoopbackMessagingContext::SetUpTestSuite(); }
+
+    static void TearDownTestSuite() { chip::Test::LoopbackMessagingContext::TearDownTestSuite(); }
+
+    void SetUp() override
+    {
+#if CHIP_CRYPTO_PSA
+        ASSERT_EQ(psa_crypto_init(), PSA_SUCCESS);
+#endif
+        chip::Test::LoopbackMessagingContext::SetUp();
+    }
+
+    void TearDown() override { chip::Test::LoopbackMessagingContext::TearDown(); }
+
+    // Hands a message straight to the exchange manager, the way the session manager does once it is decrypted.
+    void Deliver(const SessionHandle & session, uint16_t exchangeId, bool isInitiator, uint8_t msgType)
+    {
+        PacketHeader packetHeader;
+        packetHeader.SetSessionId(1).SetMessageCounter(++mMessageCounter);
+
+        PayloadHeader payloadHeader;
+        payloadHeader.SetMessageType(Protocols::BDX::Id, msgType).SetExchangeID(exchangeId).SetInitiator(isInitiator);
+
+        static_cast<SessionMessageDelegate &>(GetExchangeManager())
+            .OnMessageReceived(packetHeader, payloadHeader, session, SessionMessageDelegate::DuplicateMessage::No,
+                               System::PacketBufferHandle::New(System::PacketBuffer::kMaxSize));
+    }
+
+    uint32_t mMessageCounter = 0;
+};
+
+enum : uint8_t
+{
+    kMsgType_TEST1 = 1,
+    kMsgType_TEST2 = 2,
+};
+
+// Keeps its exchanges open, and records which one got the last message.
+class KeepOpenDelegate : public ExchangeDelegate
+{
+public:
+    CHIP_ERROR OnMessageReceived(ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                 System::PacketBufferHandle && buffer) override
+    {
+        ec->WillSendMessage();
+        mLastExchange = ec;
+        mReceived++;
+        return CHIP_NO_ERROR;
+    }
+
+    void OnResponseTimeout(ExchangeContext * ec) override {}
+
+    ExchangeContext * mLastExchange = nullptr;
+    size_t mReceived                = 0;
+};
+
+class CountingHandler : public UnsolicitedMessageHandler, public ExchangeDelegate
+{
+public:
+    CHIP_ERROR OnUnsolicitedMessageReceived(const PayloadHeader & payloadHeader, ExchangeDelegate *& newDelegate) override
+    {
+        mUnsolicited++;
+        newDelegate = this;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR OnMessageReceived(ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                 System::PacketBufferHandle && buffer) override
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    void OnResponseTimeout(ExchangeContext * ec) override {}
+
+    size_t mUnsolicited = 0;
+};
+
+// Opens up to maxCount exchanges to Bob; fewer if the exchange pool runs out.
+std::vector<ExchangeContext *> OpenExchanges(chip::Test::MessagingContext & ctx, ExchangeDelegate & delegate, size_t maxCount)
+{
+    std::vector<ExchangeContext *> exchanges;
+    while (exchanges.size() < maxCount)
+    {
+        ExchangeContext * ec = ctx.NewExchangeToBob(&delegate);
+        if (ec == nullptr)
+        {
+            break;
+        }
+        exchanges.push_back(ec);
+    }
+    return exchanges;
+}
+
+void CloseExchanges(std::vector<ExchangeContext *> & exchanges)
+{
+    for (auto * ec : exchanges)
+    {
+        ec->Close();
+    }
+    exchanges.clear();
+}
+
+TEST_F(TestExchangeDispatch, MatchesExchangeAmongMany)
+{
+    KeepOpenDelegate delegate;
+    auto exchanges = OpenExchanges(*this, delegate, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS - 1);
+    ASSERT_GT(exchanges.size(), 1u);
+
+    for (auto * ec : exchanges)
+    {
+        Deliver(GetSessionAliceToBob(), ec->GetExchangeId(), /* isInitiator = */ false, kMsgType_TEST1);
+        EXPECT_EQ(delegate.mLastExchange, ec);
+    }
+    EXPECT_EQ(delegate.mReceived, exchanges.size());
+
+    // Neither the other session, nor the other side of the exchange, nor a closed exchange match.
+    ExchangeContext * first = exchanges.front();
+    delegate.mLastExchange  = nullptr;
+    Deliver(GetSessionBobToAlice(), first->GetExchangeId(), /* isInitiator = */ false, kMsgType_TEST1);
+    Deliver(GetSessionAliceToBob(), first->GetExchangeId(), /* isInitiator = */ true, kMsgType_TEST1);
+    uint16_t closedExchangeId = first->GetExchangeId();
+    first->Close();
+    exchanges.erase(exchanges.begin());
+    Deliver(GetSessionAliceToBob(), closedExchangeId, /* isInitiator = */ false, kMsgType_TEST1);
+    EXPECT_EQ(delegate.mLastExchange, nullptr);
+
+    CloseExchanges(exchanges);
+    DrainAndServiceIO();
+    EXPECT_EQ(GetExchangeManager().GetNumActiveExchanges(), 0u);
+}
+
+TEST_F(TestExchangeDispatch, PrefersTypeHandlerOverProtocolHandler)
+{
+    CountingHandler protocolHandler;
+    CountingHandler typeHandler;
+
+    EXPECT_EQ(GetExchangeManager().RegisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id, &protocolHandler),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(Protocols::BDX::Id, kMsgType_TEST1, &typeHandler),
+              CHIP_NO_ERROR);
+
+    Deliver(GetSessionBobToAlice(), 1, /* isInitiator = */ true, kMsgType_TEST1);
+    Deliver(GetSessionBobToAlice(), 2, /* isInitiator = */ true, kMsgType_TEST2);
+    EXPECT_EQ(typeHandler.mUnsolicited, 1u);
+    EXPECT_EQ(protocolHandler.mUnsolicited, 1u);
+
+    EXPECT_EQ(GetExchangeManager().UnregisterUnsolicitedMessageHandlerForType(Protocols::BDX::Id, kMsgType_TEST1), CHIP_NO_ERROR);
+    Deliver(GetSessionBobToAlice(), 3, /* isInitiator = */ true, kMsgType_TEST1);
+    EXPECT_EQ(typeHandler.mUnsolicited, 1u);
+    EXPECT_EQ(protocolHandler.mUnsolicited, 2u);
+
+    EXPECT_EQ(GetExchangeManager().UnregisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id), CHIP_NO_ERROR);
+    Deliver(GetSessionBobToAlice(), 4, /* isInitiator = */ true, kMsgType_TEST1);
+    EXPECT_EQ(protocolHandler.mUnsolicited, 2u);
+
+    DrainAndServiceIO();
+    EXPECT_EQ(GetExchangeManager().GetNumActiveExchanges(), 0u);
+}
+
+// Not a pass/fail test, so disabled by default: reports how the cost of dispatching a message to an exchange grows with the
+// number of open exchanges.
+TEST_F(TestExchangeDispatch, DISABLED_BenchmarkDispatchVsOpenExchanges)
+{
+    constexpr size_t kRounds = 2000;
+
+    KeepOpenDelegate delegate;
+    for (size_t target : { 1, 4, 16, 64, 256 })
+    {
+        auto exchanges = OpenExchanges(*this, delegate, target);
+        ASSERT_FALSE(exchanges.empty());
+
+        delegate.mReceived = 0;
+        auto start         = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < kRounds; ++round)
+        {
+            ExchangeContext * ec = exchanges[round % exchanges.size()];
+            Deliver(GetSessionAliceToBob(), ec->GetExchangeId(), /* isInitiator = */ false, kMsgType_TEST1);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_EQ(delegate.mReceived, kRounds);
+
+        printf("%4u open exchanges: %6u ns per dispatched message\n", static_cast<unsigned>(exchanges.size()),
+               static_cast<unsigned>(elapsed / static_cast<long long>(kRounds)));
+
+        size_t opened = exchanges.size();
+        CloseExchanges(exchanges);
+        DrainAndServiceIO();
+        if (opened < target)
+        {
+            // The exchange pool is statically sized; larger counts cannot be measured.
+            break;
+        }
+    }
+}
+
+} // namespace
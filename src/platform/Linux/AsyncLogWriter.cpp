@@ -0,0 +1,734 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "AsyncLogWriter.h"
+
+#include <lib/support/CodeUtils.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace chip {
+namespace Logging {
+namespace Platform {
+
+namespace {
+
+// Bounds the time a line can stay pending, should the writer thread miss a wake-up.
+constexpr auto kMaxIdleWait = std::chrono::milliseconds(100);
+
+long long GetCurrentThreadId()
+{
+    // Only the first line of each thread pays for the system call.
+    static thread_local long long sThreadId = static_cast<long long>(syscall(SYS_gettid));
+    return sThreadId;
+}
+
+enum class ArgumentType : uint8_t
+{
+    kNone,
+    kSigned,
+    kUnsigned,
+    kDouble,
+    kLongDouble,
+    kPointer,
+    kString,
+};
+
+// One printf conversion specification, e.g. "%-*.3lx".
+struct ConversionSpec
+{
+    const char * flags;
+    size_t flagsLength;
+    const char * width;
+    size_t widthLength;
+    bool widthFromArgument;
+    bool hasPrecision;
+    const char * precision;
+    size_t precisionLength;
+    bool precisionFromArgument;
+    char length[3];
+    char conversion;
+    ArgumentType type;
+};
+
+/**
+ * Parses the conversion specification starting after a '%', and advances cursor past it.
+ *
+ * @return false for specifications whose argument cannot be packed, which have to be formatted right away.
+ */
+bool ParseConversionSpec(const char *& cursor, ConversionSpec & spec)
+{
+    const char * p = cursor;
+
+    spec.flags = p;
+    while (*p != '\0' && strchr("-+ #0'", *p) != nullptr)
+    {
+        p++;
+    }
+    spec.flagsLength = static_cast<size_t>(p - spec.flags);
+
+    spec.width             = p;
+    spec.widthFromArgument = (*p == '*');
+    if (spec.widthFromArgument)
+    {
+        p++;
+    }
+    while (*p >= '0' && *p <= '9')
+    {
+        p++;
+    }
+    spec.widthLength = static_cast<size_t>(p - spec.width);
+
+    spec.hasPrecision          = (*p == '.');
+    spec.precisionFromArgument = false;
+    if (spec.hasPrecision)
+    {
+        p++;
+        spec.precision             = p;
+        spec.precisionFromArgument = (*p == '*');
+        if (spec.precisionFromArgument)
+        {
+            p++;
+        }
+        while (*p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+        spec.precisionLength = static_cast<size_t>(p - spec.precision);
+    }
+
+    size_t lengthSize = 0;
+    while (lengthSize < sizeof(spec.length) - 1 && *p != '\0' && strchr("hljztLq", *p) != nullptr)
+    {
+        spec.length[lengthSize++] = *p++;
+    }
+    spec.length[lengthSize] = '\0';
+
+    spec.conversion = *p;
+    VerifyOrReturnValue(spec.conversion != '\0', false);
+    cursor = p + 1;
+
+    switch (spec.conversion)
+    {
+    case '%':
+        spec.type = ArgumentType::kNone;
+        return true;
+    case 'd':
+    case 'i':
+        spec.type = ArgumentType::kSigned;
+        return true;
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+        spec.type = ArgumentType::kUnsigned;
+        return true;
+    case 'c':
+        // Wide characters would need the locale of the logging thread.
+        spec.type = ArgumentType::kSigned;
+        return lengthSize == 0;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        spec.type = (strcmp(spec.length, "L") == 0) ? ArgumentType::kLongDouble : ArgumentType::kDouble;
+        return true;
+    case 'p':
+        spec.type = ArgumentType::kPointer;
+        return true;
+    case 's':
+        spec.type = ArgumentType::kString;
+        return lengthSize == 0;
+    default:
+        // %n, and anything unknown.
+        return false;
+    }
+}
+
+// Reads an integer argument the way printf would for the given length modifier, widened to 64 bits.
+int64_t ReadSignedArgument(const char * length, va_list & v)
+{
+    if (strcmp(length, "hh") == 0)
+    {
+        return static_cast<signed char>(va_arg(v, int));
+    }
+    if (strcmp(length, "h") == 0)
+    {
+        return static_cast<short>(va_arg(v, int));
+    }
+    if (strcmp(length, "l") == 0)
+    {
+        return va_arg(v, long);
+    }
+    if (strcmp(length, "ll") == 0 || strcmp(length, "q") == 0)
+    {
+        return va_arg(v, long long);
+    }
+    if (strcmp(length, "j") == 0)
+    {
+        return va_arg(v, intmax_t);
+    }
+    if (strcmp(length, "z") == 0)
+    {
+        return static_cast<int64_t>(va_arg(v, ssize_t));
+    }
+    if (strcmp(length, "t") == 0)
+    {
+        return va_arg(v, ptrdiff_t);
+    }
+    return va_arg(v, int);
+}
+
+uint64_t ReadUnsignedArgument(const char * length, va_list & v)
+{
+    if (strcmp(length, "hh") == 0)
+    {
+        return static_cast<unsigned char>(va_arg(v, unsigned int));
+    }
+    if (strcmp(length, "h") == 0)
+    {
+        return static_cast<unsigned short>(va_arg(v, unsigned int));
+    }
+    if (strcmp(length, "l") == 0)
+    {
+        return va_arg(v, unsigned long);
+    }
+    if (strcmp(length, "ll") == 0 || strcmp(length, "q") == 0)
+    {
+        return va_arg(v, unsigned long long);
+    }
+    if (strcmp(length, "j") == 0)
+    {
+        return va_arg(v, uintmax_t);
+    }
+    if (strcmp(length, "z") == 0)
+    {
+        return va_arg(v, size_t);
+    }
+    if (strcmp(length, "t") == 0)
+    {
+        return static_cast<uint64_t>(va_arg(v, ptrdiff_t));
+    }
+    return va_arg(v, unsigned int);
+}
+
+// Appends arguments to a line payload, failing once it is full.
+class ArgumentPacker
+{
+public:
+    ArgumentPacker(uint8_t * buffer, size_t size, size_t used) : mBuffer(buffer), mSize(size), mUsed(used) {}
+
+    template <typename T>
+    bool Put(const T & value)
+    {
+        VerifyOrReturnValue(mSize - mUsed >= sizeof(value), false);
+        memcpy(mBuffer + mUsed, &value, sizeof(value));
+        mUsed += sizeof(value);
+        return true;
+    }
+
+    bool PutString(const char * string, bool hasPrecision, int precision)
+    {
+        if (string == nullptr)
+        {
+            // What glibc prints.
+            string = "(null)";
+        }
+        // With a precision, the string does not have to be null-terminated.
+        size_t length = hasPrecision ? strnlen(string, static_cast<size_t>(precision)) : strlen(string);
+        VerifyOrReturnValue(mSize - mUsed > length, false);
+        memcpy(mBuffer + mUsed, string, length);
+        mBuffer[mUsed + length] = '\0';
+        mUsed += length + 1;
+        return true;
+    }
+
+    size_t Used() const { return mUsed; }
+
+private:
+    uint8_t * mBuffer;
+    size_t mSize;
+    size_t mUsed;
+};
+
+/**
+ * Copies the format string and the arguments it consumes into payload.
+ *
+ * @return the size of the payload, or 0 if the line has to be formatted right away.
+ */
+size_t PackLine(const char * format, va_list & v, uint8_t * payload, size_t payloadSize)
+{
+    size_t formatSize = strlen(format) + 1;
+    VerifyOrReturnValue(formatSize <= payloadSize, 0);
+    memcpy(payload, format, formatSize);
+
+    ArgumentPacker packer(payload, payloadSize, formatSize);
+    const char * cursor = format;
+    while ((cursor = strchr(cursor, '%')) != nullptr)
+    {
+        cursor++;
+        ConversionSpec spec;
+        VerifyOrReturnValue(ParseConversionSpec(cursor, spec), 0);
+
+        int width     = 0;
+        int precision = -1;
+        if (spec.widthFromArgument)
+        {
+            width = va_arg(v, int);
+            VerifyOrReturnValue(packer.Put(width), 0);
+        }
+        if (spec.precisionFromArgument)
+        {
+            precision = va_arg(v, int);
+            VerifyOrReturnValue(packer.Put(precision), 0);
+        }
+        else if (spec.hasPrecision)
+        {
+            precision = atoi(spec.precision);
+        }
+
+        bool packed = true;
+        switch (spec.type)
+        {
+        case ArgumentType::kNone:
+            break;
+        case ArgumentType::kSigned:
+            packed = packer.Put(ReadSignedArgument(spec.length, v));
+            break;
+        case ArgumentType::kUnsigned:
+            packed = packer.Put(ReadUnsignedArgument(spec.length, v));
+            break;
+        case ArgumentType::kDouble:
+            packed = packer.Put(va_arg(v, double));
+            break;
+        case ArgumentType::kLongDouble:
+            packed = packer.Put(va_arg(v, long double));
+            break;
+        case ArgumentType::kPointer:
+            packed = packer.Put(va_arg(v, void *));
+            break;
+        case ArgumentType::kString:
+            packed = packer.PutString(va_arg(v, const char *), precision >= 0, precision);
+            break;
+        }
+        VerifyOrReturnValue(packed, 0);
+    }
+
+    return packer.Used();
+}
+
+// Reads back what ArgumentPacker wrote, in the same order.
+class ArgumentUnpacker
+{
+public:
+    ArgumentUnpacker(const uint8_t * buffer, size_t size, size_t used) : mBuffer(buffer), mSize(size), mUsed(used) {}
+
+    template <typename T>
+    T Get()
+    {
+        T value{};
+        if (mSize - mUsed >= sizeof(value))
+        {
+            memcpy(&value, mBuffer + mUsed, sizeof(value));
+            mUsed += sizeof(value);
+        }
+        return value;
+    }
+
+    const char * GetString()
+    {
+        const char * string = reinterpret_cast<const char *>(mBuffer + mUsed);
+        mUsed += strnlen(string, mSize - mUsed) + 1;
+        return string;
+    }
+
+private:
+    const uint8_t * mBuffer;
+    size_t mSize;
+    size_t mUsed;
+};
+
+// Formats text into a fixed-size buffer, truncating it the way vsnprintf would.
+class LineBuilder
+{
+public:
+    LineBuilder(char * buffer, size_t size) : mBuffer(buffer), mSize(size) { mBuffer[0] = '\0'; }
+
+    void Append(const char * text, size_t length)
+    {
+        size_t available = mSize - 1 - mUsed;
+        length           = std::min(length, available);
+        memcpy(mBuffer + mUsed, text, length);
+        mUsed += length;
+        mBuffer[mUsed] = '\0';
+    }
+
+    template <typename T>
+    void AppendFormatted(const char * spec, T value)
+    {
+        int written = snprintf(mBuffer + mUsed, mSize - mUsed, spec, value);
+        if (written > 0)
+        {
+            mUsed = std::min(mUsed + static_cast<size_t>(written), mSize - 1);
+        }
+    }
+
+private:
+    char * mBuffer;
+    size_t mSize;
+    size_t mUsed = 0;
+};
+
+/**
+ * Formats a payload written by PackLine.
+ *
+ * Each conversion is formatted on its own, with its width and precision arguments spelled out, and integers
+ * passed as 64 bits, already narrowed as their original length modifier required.
+ */
+void FormatPackedLine(const uint8_t * payload, size_t payloadLength, char * out, size_t outSize)
+{
+    const char * format = reinterpret_cast<const char *>(payload);
+    ArgumentUnpacker unpacker(payload, payloadLength, strlen(format) + 1);
+    LineBuilder builder(out, outSize);
+
+    const char * cursor = format;
+    const char * percent;
+    while ((percent = strchr(cursor, '%')) != nullptr)
+    {
+        builder.Append(cursor, static_cast<size_t>(percent - cursor));
+        cursor = percent + 1;
+
+        ConversionSpec spec;
+        if (!ParseConversionSpec(cursor, spec))
+        {
+            // Cannot happen: PackLine checked the same format.
+            return;
+        }
+
+        if (spec.type == ArgumentType::kNone)
+        {
+            builder.Append("%", 1);
+            continue;
+        }
+
+        char specText[64];
+        LineBuilder specBuilder(specText, sizeof(specText));
+        specBuilder.Append("%", 1);
+        specBuilder.Append(spec.flags, spec.flagsLength);
+        if (spec.widthFromArgument)
+        {
+            // A negative width is the '-' flag, which can be repeated.
+            specBuilder.AppendFormatted("%d", unpacker.Get<int>());
+        }
+        else
+        {
+            specBuilder.Append(spec.width, spec.widthLength);
+        }
+        if (spec.precisionFromArgument)
+        {
+            // A negative precision is as if there was none.
+            int precision = unpacker.Get<int>();
+            if (precision >= 0)
+            {
+                specBuilder.AppendFormatted(".%d", precision);
+            }
+        }
+        else if (spec.hasPrecision)
+        {
+            specBuilder.Append(".", 1);
+            specBuilder.Append(spec.precision, spec.precisionLength);
+        }
+
+        switch (spec.type)
+        {
+        case ArgumentType::kSigned:
+            if (spec.conversion != 'c')
+            {
+                specBuilder.Append("ll", 2);
+            }
+            specBuilder.Append(&spec.conversion, 1);
+            if (spec.conversion == 'c')
+            {
+                builder.AppendFormatted(specText, static_cast<int>(unpacker.Get<int64_t>()));
+            }
+            else
+            {
+                builder.AppendFormatted(specText, static_cast<long long>(unpacker.Get<int64_t>()));
+            }
+            break;
+        case ArgumentType::kUnsigned:
+            specBuilder.Append("ll", 2);
+            specBuilder.Append(&spec.conversion, 1);
+            builder.AppendFormatted(specText, static_cast<unsigned long long>(unpacker.Get<uint64_t>()));
+            break;
+        case ArgumentType::kDouble:
+            specBuilder.Append(&spec.conversion, 1);
+            builder.AppendFormatted(specText, unpacker.Get<double>());
+            break;
+        case ArgumentType::kLongDouble:
+            specBuilder.Append("L", 1);
+            specBuilder.Append(&spec.conversion, 1);
+            builder.AppendFormatted(specText, unpacker.Get<long double>());
+            break;
+        case ArgumentType::kPointer:
+            specBuilder.Append(&spec.conversion, 1);
+            builder.AppendFormatted(specText, unpacker.Get<void *>());
+            break;
+        case ArgumentType::kString:
+            specBuilder.Append(&spec.conversion, 1);
+            builder.AppendFormatted(specText, unpacker.GetString());
+            break;
+        case ArgumentType::kNone:
+            break;
+        }
+    }
+    builder.Append(cursor, strlen(cursor));
+}
+
+} // namespace
+
+CHIP_ERROR AsyncLogWriter::Start(FILE * output)
+{
+    VerifyOrReturnError(output != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!mRunning && !mWriterThread.joinable(), CHIP_ERROR_INCORRECT_STATE);
+
+    for (size_t i = 0; i < kMaxPendingLines; i++)
+    {
+        mLines[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mEnqueuePosition.store(0, std::memory_order_relaxed);
+    mDequeuePosition.store(0, std::memory_order_relaxed);
+
+    mOutput        = output;
+    mProcessId     = static_cast<long long>(getpid());
+    mStopRequested = false;
+    mWriterThread  = std::thread(&AsyncLogWriter::WriterThreadMain, this);
+    mRunning.store(true, std::memory_order_release);
+    return CHIP_NO_ERROR;
+}
+
+void AsyncLogWriter::Stop()
+{
+    VerifyOrReturn(mWriterThread.joinable());
+
+    mRunning.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mStopRequested = true;
+    }
+    mWakeCondition.notify_one();
+    mWriterThread.join();
+
+    // Catch lines queued by threads that saw the writer running just before it stopped.
+    Flush();
+}
+
+void AsyncLogWriter::Flush()
+{
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+    VerifyOrReturn(mOutput != nullptr);
+
+    WritePendingLines();
+    fflush(mOutput);
+}
+
+bool AsyncLogWriter::Log(const char * module, const char * msg, va_list v, bool flush)
+{
+    VerifyOrReturnValue(mRunning.load(std::memory_order_acquire), false);
+
+    // Claim a free slot.  The sequence of the slot tells whether the writer is done with it.
+    size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+    Line * line     = nullptr;
+    while (true)
+    {
+        line            = &mLines[position % kMaxPendingLines];
+        size_t sequence = line->sequence.load(std::memory_order_acquire);
+        if (sequence == position)
+        {
+            if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (sequence < position)
+        {
+            // The ring is full.
+            if (!flush)
+            {
+                mDroppedLineCount.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            // Make room rather than drop a line that has to be written out.
+            WriteLinesThrough(position - kMaxPendingLines);
+            position = mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            position = mEnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    gettimeofday(&line->time, nullptr);
+    line->threadId = GetCurrentThreadId();
+    line->module   = module;
+
+    // Packing consumes the arguments, which formatting right away needs to start over from.
+    va_list packedArguments;
+    va_copy(packedArguments, v);
+    size_t payloadLength = PackLine(msg, packedArguments, line->payload, sizeof(line->payload));
+    va_end(packedArguments);
+
+    line->isFormatted = (payloadLength == 0);
+    if (line->isFormatted)
+    {
+        vsnprintf(reinterpret_cast<char *>(line->payload), sizeof(line->payload), msg, v);
+    }
+    line->payloadLength = static_cast<uint16_t>(payloadLength);
+
+    // Sequentially consistent, so that it cannot be reordered with the load of mWriterWaiting below, which would
+    // let the writer thread go to sleep without seeing this line.
+    line->sequence.store(position + 1, std::memory_order_seq_cst);
+
+    if (flush)
+    {
+        WriteLinesThrough(position);
+    }
+    else if (mWriterWaiting.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mWakeCondition.notify_one();
+    }
+    return true;
+}
+
+bool AsyncLogWriter::HasPendingLines() const
+{
+    size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+    return mLines[position % kMaxPendingLines].sequence.load(std::memory_order_seq_cst) == position + 1;
+}
+
+size_t AsyncLogWriter::WritePendingLines()
+{
+    size_t written = 0;
+
+    size_t droppedLineCount = mDroppedLineCount.load(std::memory_order_relaxed);
+    if (droppedLineCount != mReportedDroppedLineCount)
+    {
+        fprintf(mOutput, "[%lld] CHIP:-: %zu log lines dropped\n", mProcessId, droppedLineCount - mReportedDroppedLineCount);
+        mReportedDroppedLineCount = droppedLineCount;
+    }
+
+    size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Line & line = mLines[position % kMaxPendingLines];
+        if (line.sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            break;
+        }
+
+        WriteLine(line);
+
+        // Hand the slot back to the producers, for the next round of the ring.
+        line.sequence.store(position + kMaxPendingLines, std::memory_order_release);
+        position++;
+        written++;
+    }
+    mDequeuePosition.store(position, std::memory_order_relaxed);
+
+    return written;
+}
+
+void AsyncLogWriter::WriteLinesThrough(size_t position)
+{
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+
+    // Lines are written in ring order, so a line claimed earlier by another thread, and which that thread is
+    // still filling, holds up the ones after it.  Filling a line does not block, so wait for it.
+    while (mDequeuePosition.load(std::memory_order_relaxed) <= position)
+    {
+        if (WritePendingLines() == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    fflush(mOutput);
+}
+
+void AsyncLogWriter::WriteLine(const Line & line)
+{
+    char formatted[kMaxMessageLength];
+    const char * message = reinterpret_cast<const char *>(line.payload);
+    if (!line.isFormatted)
+    {
+        FormatPackedLine(line.payload, line.payloadLength, formatted, sizeof(formatted));
+        message = formatted;
+    }
+
+    fprintf(mOutput, "[%" PRIu64 ".%06" PRIu64 "][%lld:%lld] CHIP:%s: %s\n", static_cast<uint64_t>(line.time.tv_sec),
+            static_cast<uint64_t>(line.time.tv_usec), mProcessId, line.threadId, line.module, message);
+}
+
+void AsyncLogWriter::WriterThreadMain()
+{
+    while (true)
+    {
+        size_t written;
+        {
+            std::lock_guard<std::mutex> lock(mWriteMutex);
+            written = WritePendingLines();
+            if (written > 0)
+            {
+                fflush(mOutput);
+            }
+        }
+
+        if (written > 0)
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        if (mStopRequested)
+        {
+            break;
+        }
+
+        mWriterWaiting.store(true, std::memory_order_seq_cst);
+        if (!HasPendingLines())
+        {
+            mWakeCondition.wait_for(lock, kMaxIdleWait);
+        }
+        mWriterWaiting.store(false, std::memory_order_relaxed);
+    }
+}
+
+} // namespace Platform
+} // namespace Logging
+} // namespace chip
@@ -0,0 +1,141 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Log line writer that moves the output of log lines off the logging threads.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <sys/time.h>
+#include <thread>
+
+namespace chip {
+namespace Logging {
+namespace Platform {
+
+/**
+ * Writes log lines from a background thread.
+ *
+ * Log() does not format anything: it copies the format string and the raw arguments into a slot of a
+ * fixed-size ring, which any number of threads can fill without taking a lock.  The writer thread formats the
+ * lines, with their time stamp, process and thread IDs and module, and flushes the output once per batch
+ * rather than once per line.  The output is the same text as synchronous logging writes: there is no binary
+ * format to decode offline.
+ *
+ * String arguments are copied, since they are often not valid anymore by the time the writer thread gets
+ * to the line, e.g. CHIP_ERROR::Format() ones.  Lines whose format and arguments do not fit in a slot, or
+ * that use conversions that cannot be deferred (%n, wide characters), are formatted by the logging thread.
+ *
+ * When the ring is full, lines are dropped rather than blocking the logging thread, and their count is
+ * reported with the next line written.  Lines logged with flush are never dropped: the logging thread writes
+ * pending lines itself until there is room.
+ */
+class AsyncLogWriter
+{
+public:
+    static constexpr size_t kMaxPendingLines  = 256;
+    static constexpr size_t kMaxMessageLength = CHIP_CONFIG_LOG_MESSAGE_MAX_SIZE;
+
+    AsyncLogWriter() = default;
+    ~AsyncLogWriter() { Stop(); }
+
+    AsyncLogWriter(const AsyncLogWriter &)             = delete;
+    AsyncLogWriter & operator=(const AsyncLogWriter &) = delete;
+
+    /**
+     * Starts the writer thread, which writes lines to the given output until Stop is called.
+     */
+    CHIP_ERROR Start(FILE * output);
+
+    /**
+     * Writes the pending lines, then stops the writer thread.  Further lines are not accepted.
+     */
+    void Stop();
+
+    /**
+     * Writes the pending lines from the calling thread, and flushes the output.
+     */
+    void Flush();
+
+    /**
+     * Queues a log line for the writer thread.
+     *
+     * @param flush  Whether to return only once the line, and all the lines queued before it, have been
+     *               written and the output flushed, e.g. for errors, which often precede a crash.
+     *
+     * @return false if the writer is not running, in which case the line has to be written by the caller.
+     */
+    bool Log(const char * module, const char * msg, va_list v, bool flush = false);
+
+    size_t GetDroppedLineCount() const { return mDroppedLineCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Line
+    {
+        // Ring position the slot is ready for: equal to the position when free, one more once filled.
+        std::atomic<size_t> sequence{ 0 };
+        struct timeval time;
+        long long threadId;
+        const char * module;
+        // Either the formatted message, or the format string followed by the packed arguments.
+        bool isFormatted;
+        uint16_t payloadLength;
+        uint8_t payload[kMaxMessageLength];
+    };
+
+    bool HasPendingLines() const;
+    // Must be called with mWriteMutex held.
+    size_t WritePendingLines();
+    // Writes the lines up to the one at the given ring position, waiting for those still being filled.
+    void WriteLinesThrough(size_t position);
+    void WriteLine(const Line & line);
+    void WriterThreadMain();
+
+    FILE * mOutput       = nullptr;
+    long long mProcessId = 0;
+    std::atomic<bool> mRunning{ false };
+
+    std::atomic<size_t> mEnqueuePosition{ 0 };
+    std::atomic<size_t> mDequeuePosition{ 0 };
+    std::atomic<size_t> mDroppedLineCount{ 0 };
+    size_t mReportedDroppedLineCount = 0;
+
+    // Serializes the threads writing lines: the writer thread, and the ones calling Flush.
+    std::mutex mWriteMutex;
+
+    std::thread mWriterThread;
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+    std::atomic<bool> mWriterWaiting{ false };
+    bool mStopRequested = false;
+
+    Line mLines[kMaxPendingLines];
+};
+
+} // namespace Platform
+} // namespace Logging
+} // namespace chip
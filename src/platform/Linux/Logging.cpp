@@ -16,6 +16,16 @@
 #include <pw_log/log.h>
 #endif // CHIP_USE_PW_LOGGING
 
+#ifndef CHIP_LINUX_ASYNC_LOGGING
+#define CHIP_LINUX_ASYNC_LOGGING 0
+#endif
+
+#if CHIP_LINUX_ASYNC_LOGGING && !CHIP_USE_PW_LOGGING
+#include "AsyncLogWriter.h"
+
+#include <cstdlib>
+#endif
+
 namespace chip {
 namespace DeviceLayer {
 
@@ -32,11 +42,47 @@ void __attribute__((weak)) OnLogOutput() {}
 namespace Logging {
 namespace Platform {
 
+#if CHIP_LINUX_ASYNC_LOGGING && !CHIP_USE_PW_LOGGING
+namespace {
+
+AsyncLogWriter & GetAsyncLogWriter()
+{
+    // Never destroyed, so that logging from static destructors keeps working: lines logged after the exit
+    // handler stopped the writer are written synchronously.
+    static AsyncLogWriter * sWriter = [] {
+        auto * writer = new AsyncLogWriter();
+        if (writer->Start(stdout) == CHIP_NO_ERROR)
+        {
+            atexit([] { GetAsyncLogWriter().Stop(); });
+        }
+        return writer;
+    }();
+    return *sWriter;
+}
+
+bool LogAsync(const char * module, uint8_t category, const char * msg, va_list v)
+{
+    // Errors often precede a crash or an abort: make sure they are out before going on.
+    bool flush = (static_cast<LogCategory>(category) == kLogCategory_Error);
+    return GetAsyncLogWriter().Log(module, msg, v, flush);
+}
+
+} // namespace
+#endif // CHIP_LINUX_ASYNC_LOGGING && !CHIP_USE_PW_LOGGING
+
 /**
  * CHIP log output functions.
  */
 void LogV(const char * module, uint8_t category, const char * msg, va_list v)
 {
+#if CHIP_LINUX_ASYNC_LOGGING && !CHIP_USE_PW_LOGGING
+    if (LogAsync(module, category, msg, v))
+    {
+        DeviceLayer::OnLogOutput();
+        return;
+    }
+#endif // CHIP_LINUX_ASYNC_LOGGING && !CHIP_USE_PW_LOGGING
+
     struct timeval tv;
 
     // Should not fail per man page of gettimeofday(), but failed to get time is not a fatal error in log. The bad time value will
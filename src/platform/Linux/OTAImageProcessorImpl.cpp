@@ -21,7 +21,16 @@
 
 #include "OTAImageProcessorImpl.h"
 
+#include <lib/support/TypeTraits.h>
+#include <system/SystemError.h>
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 namespace chip {
 
@@ -63,7 +72,7 @@ CHIP_ERROR OTAImageProcessorImpl::Abort()
 
 CHIP_ERROR OTAImageProcessorImpl::ProcessBlock(ByteSpan & block)
 {
-    if (!mOfs.is_open() || !mOfs.good())
+    if (!mWriterThread.joinable())
     {
         return CHIP_ERROR_INTERNAL;
     }
@@ -130,9 +139,10 @@ void OTAImageProcessorImpl::HandlePrepareDownload(intptr_t context)
     imageProcessor->mParams.downloadedBytes = 0;
     imageProcessor->mParams.totalFileBytes  = 0;
     imageProcessor->mHeaderParser.Init();
-    imageProcessor->mOfs.open(imageProcessor->mImageFile, std::ofstream::out | std::ofstream::ate | std::ofstream::app);
-    if (!imageProcessor->mOfs.good())
+    CHIP_ERROR error = imageProcessor->StartWriter();
+    if (error != CHIP_NO_ERROR)
     {
+        ChipLogError(SoftwareUpdate, "Cannot open image file for writing: %" CHIP_ERROR_FORMAT, error.Format());
         imageProcessor->mDownloader->OnPreparedForDownload(CHIP_ERROR_OPEN_FAILED);
         return;
     }
@@ -148,9 +158,42 @@ void OTAImageProcessorImpl::HandleFinalize(intptr_t context)
         return;
     }
 
-    imageProcessor->mOfs.close();
     imageProcessor->ReleaseBlock();
 
+    // The writer thread flushes the remaining data and checks the digest once the queue
+    // has drained, then reports back through HandleFinalizeComplete.
+    std::lock_guard<std::mutex> lock(imageProcessor->mWriterMutex);
+    if (!imageProcessor->mWriterThread.joinable())
+    {
+        ChipLogError(SoftwareUpdate, "No image download in progress");
+        return;
+    }
+    imageProcessor->mFinalizeRequested = true;
+    imageProcessor->mWriterCondition.notify_one();
+}
+
+void OTAImageProcessorImpl::HandleFinalizeComplete(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr);
+
+    CHIP_ERROR result;
+    {
+        // The download may have been aborted, or restarted, since the writer thread posted this.
+        std::lock_guard<std::mutex> lock(imageProcessor->mWriterMutex);
+        VerifyOrReturn(imageProcessor->mFinalizeComplete);
+        result = imageProcessor->mFinalizeResult;
+    }
+    imageProcessor->StopWriter();
+
+    if (result != CHIP_NO_ERROR)
+    {
+        ChipLogError(SoftwareUpdate, "OTA image finalization failed: %" CHIP_ERROR_FORMAT, result.Format());
+        unlink(imageProcessor->mImageFile);
+        return;
+    }
+
+    imageProcessor->mImageValid = true;
     ChipLogProgress(SoftwareUpdate, "OTA image downloaded to %s", imageProcessor->mImageFile);
 }
 
@@ -162,9 +205,16 @@ void OTAImageProcessorImpl::HandleApply(intptr_t context)
     OTARequestorInterface * requestor = chip::GetRequestorInstance();
     VerifyOrReturn(requestor != nullptr);
 
+    if (!imageProcessor->mImageValid)
+    {
+        ChipLogError(SoftwareUpdate, "No verified OTA image to apply");
+        return;
+    }
+
     // Move the downloaded image to the location where the new image is to be executed from
     unlink(kImageExecPath);
     rename(imageProcessor->mImageFile, kImageExecPath);
+    imageProcessor->mImageValid = false;
     chmod(kImageExecPath, S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
 
     // Shutdown the stack and expect to boot into the new image once the event loop is stopped
@@ -180,8 +230,9 @@ void OTAImageProcessorImpl::HandleAbort(intptr_t context)
         return;
     }
 
-    imageProcessor->mOfs.close();
+    imageProcessor->StopWriter();
     unlink(imageProcessor->mImageFile);
+    imageProcessor->mImageValid = false;
     imageProcessor->ReleaseBlock();
 }
 
@@ -208,16 +259,42 @@ void OTAImageProcessorImpl::HandleProcessBlock(intptr_t context)
         return;
     }
 
-    if (!imageProcessor->mOfs.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size())))
+    // Writing and hashing happen on the writer thread. If the queue is now full, the next
+    // block is requested by HandleFetchNextData once the writer has made room for it.
+    bool fetchNext = false;
+    error          = imageProcessor->EnqueueBlock(block, fetchNext);
+    if (error != CHIP_NO_ERROR)
     {
-        imageProcessor->mDownloader->EndDownload(CHIP_ERROR_WRITE_FAILED);
+        ChipLogError(SoftwareUpdate, "Failed to queue block: %" CHIP_ERROR_FORMAT, error.Format());
+        imageProcessor->mDownloader->EndDownload(error);
         return;
     }
 
     imageProcessor->mParams.downloadedBytes += block.size();
+    if (fetchNext)
+    {
+        imageProcessor->mDownloader->FetchNextData();
+    }
+}
+
+void OTAImageProcessorImpl::HandleFetchNextData(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr && imageProcessor->mDownloader != nullptr);
+    VerifyOrReturn(imageProcessor->mWriterThread.joinable());
+
     imageProcessor->mDownloader->FetchNextData();
 }
 
+void OTAImageProcessorImpl::HandleWriteFailed(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr && imageProcessor->mDownloader != nullptr);
+    VerifyOrReturn(imageProcessor->mWriterThread.joinable());
+
+    imageProcessor->mDownloader->EndDownload(CHIP_ERROR_WRITE_FAILED);
+}
+
 CHIP_ERROR OTAImageProcessorImpl::ProcessHeader(ByteSpan & block)
 {
     if (mHeaderParser.IsInitialized())
@@ -230,6 +307,38 @@ CHIP_ERROR OTAImageProcessorImpl::ProcessHeader(ByteSpan & block)
         ReturnErrorOnFailure(error);
 
         mParams.totalFileBytes = header.mPayloadSize;
+
+        // Truncated SHA-256 variants are checked against a prefix of the full digest.
+        mDigestType = header.mImageDigestType;
+        switch (mDigestType)
+        {
+        case OTAImageDigestType::kSha256:
+            mExpectedDigestLength = 32;
+            break;
+        case OTAImageDigestType::kSha256_128:
+            mExpectedDigestLength = 16;
+            break;
+        case OTAImageDigestType::kSha256_120:
+            mExpectedDigestLength = 15;
+            break;
+        case OTAImageDigestType::kSha256_96:
+            mExpectedDigestLength = 12;
+            break;
+        case OTAImageDigestType::kSha256_64:
+            mExpectedDigestLength = 8;
+            break;
+        case OTAImageDigestType::kSha256_32:
+            mExpectedDigestLength = 4;
+            break;
+        default:
+            ChipLogError(SoftwareUpdate, "Image digest type %u not supported, skipping verification",
+                         to_underlying(mDigestType));
+            mExpectedDigestLength = 0;
+            break;
+        }
+        ReturnErrorCodeIf(header.mImageDigest.size() < mExpectedDigestLength, CHIP_ERROR_INVALID_ARGUMENT);
+        memcpy(mExpectedDigest, header.mImageDigest.data(), mExpectedDigestLength);
+
         mHeaderParser.Clear();
     }
 
@@ -276,4 +385,261 @@ CHIP_ERROR OTAImageProcessorImpl::ReleaseBlock()
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR OTAImageProcessorImpl::StartWriter()
+{
+    StopWriter();
+
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#ifdef O_DIRECT
+    // Bypass the page cache so large images do not evict everything else; fall back to
+    // buffered I/O on file systems (such as tmpfs) that reject O_DIRECT.
+    mFd       = open(mImageFile, flags | O_DIRECT, S_IRUSR | S_IWUSR);
+    mDirectIO = (mFd >= 0);
+#endif
+    if (mFd < 0)
+    {
+        mFd = open(mImageFile, flags, S_IRUSR | S_IWUSR);
+    }
+    ReturnErrorCodeIf(mFd < 0, CHIP_ERROR_POSIX(errno));
+
+    void * staging = nullptr;
+    if (posix_memalign(&staging, kWriteAlignment, kStagingBufferSize) != 0)
+    {
+        StopWriter();
+        return CHIP_ERROR_NO_MEMORY;
+    }
+    mStaging       = static_cast<uint8_t *>(staging);
+    mStagingLength = 0;
+    mFileOffset    = 0;
+    mWriteFailed   = false;
+
+    CHIP_ERROR err = mDigest.Begin();
+    if (err != CHIP_NO_ERROR)
+    {
+        StopWriter();
+        return err;
+    }
+
+    mQueueHead            = 0;
+    mQueueCount           = 0;
+    mFetchDeferred        = false;
+    mFinalizeRequested    = false;
+    mFinalizeComplete     = false;
+    mStopRequested        = false;
+    mFinalizeResult       = CHIP_NO_ERROR;
+    mExpectedDigestLength = 0;
+    mImageValid           = false;
+
+    mWriterThread = std::thread(&OTAImageProcessorImpl::WriterThreadMain, this);
+    return CHIP_NO_ERROR;
+}
+
+void OTAImageProcessorImpl::StopWriter()
+{
+    if (mWriterThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mWriterMutex);
+            mStopRequested = true;
+            mWriterCondition.notify_one();
+        }
+        // At most one in-flight pwrite is waited for here; queued blocks are dropped.
+        mWriterThread.join();
+    }
+    mFinalizeComplete = false;
+
+    if (mFd >= 0)
+    {
+        close(mFd);
+        mFd = -1;
+    }
+
+    free(mStaging);
+    mStaging       = nullptr;
+    mStagingLength = 0;
+
+    mDigest.Clear();
+    ReleaseQueue();
+}
+
+CHIP_ERROR OTAImageProcessorImpl::EnqueueBlock(const ByteSpan & block, bool & fetchNext)
+{
+    fetchNext = true;
+    VerifyOrReturnError(!block.empty(), CHIP_NO_ERROR);
+
+    std::lock_guard<std::mutex> lock(mWriterMutex);
+    // Only a downloader that ignores the deferred fetch can deliver a block while the queue is full.
+    VerifyOrReturnError(mQueueCount < kBlockQueueDepth, CHIP_ERROR_NO_MEMORY);
+
+    QueuedBlock & slot = mQueue[(mQueueHead + mQueueCount) % kBlockQueueDepth];
+    if (slot.capacity < block.size())
+    {
+        chip::Platform::MemoryFree(slot.data);
+        slot.data     = static_cast<uint8_t *>(chip::Platform::MemoryAlloc(block.size()));
+        slot.capacity = (slot.data != nullptr) ? block.size() : 0;
+    }
+
+    // On allocation failure the empty slot is still queued so that the writer thread
+    // reports the failure and ends the download.
+    if (slot.data != nullptr)
+    {
+        memcpy(slot.data, block.data(), block.size());
+    }
+    slot.length = slot.capacity > 0 ? block.size() : 0;
+
+    mQueueCount++;
+    mWriterCondition.notify_one();
+
+    mFetchDeferred = (mQueueCount == kBlockQueueDepth);
+    fetchNext      = !mFetchDeferred;
+    return CHIP_NO_ERROR;
+}
+
+void OTAImageProcessorImpl::WriterThreadMain()
+{
+    std::unique_lock<std::mutex> lock(mWriterMutex);
+    while (true)
+    {
+        mWriterCondition.wait(lock, [this] { return mStopRequested || mQueueCount > 0 || mFinalizeRequested; });
+        if (mStopRequested)
+        {
+            return;
+        }
+
+        if (mQueueCount > 0)
+        {
+            // The CHIP thread only fills the slot after the tail, so the head slot can be
+            // consumed without holding the lock.
+            const QueuedBlock & slot = mQueue[mQueueHead];
+            bool alreadyFailed       = mWriteFailed;
+            bool failed              = alreadyFailed;
+            lock.unlock();
+
+            if (!failed)
+            {
+                failed = (slot.data == nullptr) || (mDigest.AddData(ByteSpan(slot.data, slot.length)) != CHIP_NO_ERROR) ||
+                    (WriteToStaging(slot.data, slot.length) != CHIP_NO_ERROR);
+            }
+
+            lock.lock();
+            mQueueHead = (mQueueHead + 1) % kBlockQueueDepth;
+            mQueueCount--;
+            mWriteFailed = failed;
+
+            if (failed && !alreadyFailed)
+            {
+                DeviceLayer::PlatformMgr().ScheduleWork(HandleWriteFailed, reinterpret_cast<intptr_t>(this));
+            }
+            else if (!failed && mFetchDeferred)
+            {
+                mFetchDeferred = false;
+                DeviceLayer::PlatformMgr().ScheduleWork(HandleFetchNextData, reinterpret_cast<intptr_t>(this));
+            }
+            continue;
+        }
+
+        // Finalize requested and all queued blocks have been written.
+        bool failed = mWriteFailed;
+        lock.unlock();
+
+        CHIP_ERROR err = failed ? CHIP_ERROR_WRITE_FAILED : FlushStaging(true);
+        if (err == CHIP_NO_ERROR)
+        {
+            err = VerifyDigest();
+        }
+
+        lock.lock();
+        mFinalizeResult    = err;
+        mFinalizeRequested = false;
+        mFinalizeComplete  = true;
+        DeviceLayer::PlatformMgr().ScheduleWork(HandleFinalizeComplete, reinterpret_cast<intptr_t>(this));
+        return;
+    }
+}
+
+CHIP_ERROR OTAImageProcessorImpl::WriteToStaging(const uint8_t * data, size_t length)
+{
+    while (length > 0)
+    {
+        size_t chunk = std::min(length, kStagingBufferSize - mStagingLength);
+        memcpy(mStaging + mStagingLength, data, chunk);
+        mStagingLength += chunk;
+        data += chunk;
+        length -= chunk;
+
+        if (mStagingLength == kStagingBufferSize)
+        {
+            ReturnErrorOnFailure(FlushStaging(false));
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageProcessorImpl::FlushStaging(bool final)
+{
+    VerifyOrReturnError(mStagingLength > 0, CHIP_NO_ERROR);
+
+#ifdef O_DIRECT
+    if (final && mDirectIO && (mStagingLength % kWriteAlignment) != 0)
+    {
+        // The unaligned tail of the image cannot be written with O_DIRECT.
+        int flags = fcntl(mFd, F_GETFL);
+        VerifyOrReturnError(flags >= 0 && fcntl(mFd, F_SETFL, flags & ~O_DIRECT) == 0, CHIP_ERROR_POSIX(errno));
+        mDirectIO = false;
+    }
+#endif
+
+    size_t written = 0;
+    while (written < mStagingLength)
+    {
+        ssize_t rv = pwrite(mFd, mStaging + written, mStagingLength - written, mFileOffset + static_cast<off_t>(written));
+        if (rv < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (rv <= 0)
+        {
+            ChipLogError(SoftwareUpdate, "Failed to write OTA image: %s", strerror(errno));
+            return CHIP_ERROR_WRITE_FAILED;
+        }
+        written += static_cast<size_t>(rv);
+    }
+
+    mFileOffset += static_cast<off_t>(mStagingLength);
+    mStagingLength = 0;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageProcessorImpl::VerifyDigest()
+{
+    uint8_t digestBuffer[Crypto::kSHA256_Hash_Length];
+    MutableByteSpan digest(digestBuffer);
+    ReturnErrorOnFailure(mDigest.Finish(digest));
+
+    if (mExpectedDigestLength == 0)
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    if (memcmp(digest.data(), mExpectedDigest, mExpectedDigestLength) != 0)
+    {
+        ChipLogError(SoftwareUpdate, "OTA image digest mismatch");
+        return CHIP_ERROR_INTEGRITY_CHECK_FAILED;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void OTAImageProcessorImpl::ReleaseQueue()
+{
+    for (auto & slot : mQueue)
+    {
+        chip::Platform::MemoryFree(slot.data);
+        slot = QueuedBlock();
+    }
+    mQueueHead  = 0;
+    mQueueCount = 0;
+}
+
 } // namespace chip
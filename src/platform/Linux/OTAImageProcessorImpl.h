@@ -19,11 +19,14 @@
 #pragma once
 
 #include <app/clusters/ota-requestor/OTADownloader.h>
+#include <crypto/CHIPCryptoPAL.h>
 #include <lib/core/OTAImageHeader.h>
 #include <platform/CHIPDeviceLayer.h>
 #include <platform/OTAImageProcessor.h>
 
-#include <fstream>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace chip {
 
@@ -33,6 +36,8 @@ static char kImageExecPath[] = "/tmp/ota.update";
 class OTAImageProcessorImpl : public OTAImageProcessorInterface
 {
 public:
+    ~OTAImageProcessorImpl() { StopWriter(); }
+
     //////////// OTAImageProcessorInterface Implementation ///////////////
     CHIP_ERROR PrepareDownload() override;
     CHIP_ERROR Finalize() override;
@@ -45,7 +50,27 @@ public:
     void SetOTADownloader(OTADownloader * downloader) { mDownloader = downloader; }
     void SetOTAImageFile(const char * imageFile) { mImageFile = imageFile; }
 
+    /**
+     * Whether the downloaded image was finalized and its digest verified, so that it can be applied.
+     */
+    bool IsImageValid() const { return mImageValid; }
+
 private:
+    // Number of received blocks that may be queued for the writer thread before the
+    // next block is requested from the downloader.
+    static constexpr size_t kBlockQueueDepth = 8;
+    // Alignment required for O_DIRECT buffers, offsets and sizes.
+    static constexpr size_t kWriteAlignment = 4096;
+    // Size of the aligned staging buffer flushed to disk with a single pwrite.
+    static constexpr size_t kStagingBufferSize = 16 * kWriteAlignment;
+
+    struct QueuedBlock
+    {
+        uint8_t * data  = nullptr;
+        size_t capacity = 0;
+        size_t length   = 0;
+    };
+
     //////////// Actual handlers for the OTAImageProcessorInterface ///////////////
     static void HandlePrepareDownload(intptr_t context);
     static void HandleFinalize(intptr_t context);
@@ -53,6 +78,11 @@ private:
     static void HandleAbort(intptr_t context);
     static void HandleProcessBlock(intptr_t context);
 
+    //////////// Completions posted by the writer thread to the CHIP thread ///////////////
+    static void HandleFetchNextData(intptr_t context);
+    static void HandleWriteFailed(intptr_t context);
+    static void HandleFinalizeComplete(intptr_t context);
+
     CHIP_ERROR ProcessHeader(ByteSpan & block);
 
     /**
@@ -65,11 +95,61 @@ private:
      */
     CHIP_ERROR ReleaseBlock();
 
-    std::ofstream mOfs;
+    /**
+     * Open the output image file and start the writer thread.
+     */
+    CHIP_ERROR StartWriter();
+
+    /**
+     * Stop the writer thread, discarding any queued blocks, and close the output image file.
+     */
+    void StopWriter();
+
+    /**
+     * Copy block into the writer queue. fetchNext is set to true if there is room left for another
+     * block, false if the next block must not be requested until the writer thread drains the queue.
+     * Returns CHIP_ERROR_NO_MEMORY, without queuing the block, if the queue is already full.
+     */
+    CHIP_ERROR EnqueueBlock(const ByteSpan & block, bool & fetchNext);
+
+    void WriterThreadMain();
+    CHIP_ERROR WriteToStaging(const uint8_t * data, size_t length);
+    CHIP_ERROR FlushStaging(bool final);
+    CHIP_ERROR VerifyDigest();
+    void ReleaseQueue();
+
     MutableByteSpan mBlock;
     OTADownloader * mDownloader;
     OTAImageHeaderParser mHeaderParser;
     const char * mImageFile = nullptr;
+
+    // Digest announced by the image header, copied out of the header parser buffer.
+    OTAImageDigestType mDigestType = OTAImageDigestType::kSha256;
+    uint8_t mExpectedDigest[Crypto::kSHA256_Hash_Length];
+    size_t mExpectedDigestLength = 0;
+    bool mImageValid             = false;
+
+    // State shared with the writer thread; guarded by mWriterMutex.
+    std::thread mWriterThread;
+    std::mutex mWriterMutex;
+    std::condition_variable mWriterCondition;
+    QueuedBlock mQueue[kBlockQueueDepth];
+    size_t mQueueHead          = 0;
+    size_t mQueueCount         = 0;
+    bool mFetchDeferred        = false;
+    bool mFinalizeRequested    = false;
+    bool mFinalizeComplete     = false;
+    bool mStopRequested        = false;
+    CHIP_ERROR mFinalizeResult = CHIP_NO_ERROR;
+
+    // State owned by the writer thread while it is running.
+    int mFd               = -1;
+    bool mDirectIO        = false;
+    uint8_t * mStaging    = nullptr;
+    size_t mStagingLength = 0;
+    off_t mFileOffset     = 0;
+    bool mWriteFailed     = false;
+    Crypto::Hash_SHA256_stream mDigest;
 };
 
 } // namespace chip
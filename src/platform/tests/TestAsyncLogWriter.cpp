@@ -0,0 +1,362 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the Linux asynchronous log writer.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <platform/Linux/AsyncLogWriter.h>
+
+using namespace chip;
+using namespace chip::Logging::Platform;
+
+namespace {
+
+bool LogLine(AsyncLogWriter & writer, const char * msg, ...)
+{
+    va_list v;
+    va_start(v, msg);
+    bool queued = writer.Log("TST", msg, v);
+    va_end(v);
+    return queued;
+}
+
+bool LogFlushedLine(AsyncLogWriter & writer, const char * msg, ...)
+{
+    va_list v;
+    va_start(v, msg);
+    bool queued = writer.Log("TST", msg, v, /* flush = */ true);
+    va_end(v);
+    return queued;
+}
+
+// Collects what is written to a stream, so that it can be checked while the writer thread is still writing.
+class CapturedOutput
+{
+public:
+    CapturedOutput()
+    {
+        cookie_io_functions_t functions = {};
+        functions.write                 = &CapturedOutput::Write;
+        mFile                           = fopencookie(this, "w", functions);
+    }
+    ~CapturedOutput()
+    {
+        if (mFile != nullptr)
+        {
+            fclose(mFile);
+        }
+    }
+
+    FILE * File() const { return mFile; }
+
+    bool Contains(const char * text)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mText.find(text) != std::string::npos;
+    }
+
+private:
+    static ssize_t Write(void * cookie, const char * buffer, size_t size)
+    {
+        auto * output = static_cast<CapturedOutput *>(cookie);
+        std::lock_guard<std::mutex> lock(output->mMutex);
+        output->mText.append(buffer, size);
+        return static_cast<ssize_t>(size);
+    }
+
+    FILE * mFile = nullptr;
+    std::mutex mMutex;
+    std::string mText;
+};
+
+// What Logging::Platform::LogV does for each line when writing synchronously.
+void LogLineSynchronously(FILE * output, const char * msg, ...)
+{
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    va_list v;
+    va_start(v, msg);
+    flockfile(output);
+    fprintf(output, "[%" PRIu64 ".%06" PRIu64 "][%lld:%lld] CHIP:%s: ", static_cast<uint64_t>(tv.tv_sec),
+            static_cast<uint64_t>(tv.tv_usec), static_cast<long long>(syscall(SYS_getpid)),
+            static_cast<long long>(syscall(SYS_gettid)), "TST");
+    vfprintf(output, msg, v);
+    fprintf(output, "\n");
+    fflush(output);
+    funlockfile(output);
+    va_end(v);
+}
+
+std::vector<std::string> ReadLines(FILE * file)
+{
+    std::vector<std::string> lines;
+    char buffer[512];
+
+    rewind(file);
+    while (fgets(buffer, sizeof(buffer), file) != nullptr)
+    {
+        lines.emplace_back(buffer);
+    }
+    return lines;
+}
+
+TEST(TestAsyncLogWriter, TestWritesLinesInOrder)
+{
+    constexpr int kThreads        = 4;
+    constexpr int kLinesPerThread = 50;
+    static_assert(kThreads * kLinesPerThread <= AsyncLogWriter::kMaxPendingLines, "Lines could get dropped");
+
+    FILE * output = tmpfile();
+    ASSERT_NE(output, nullptr);
+
+    AsyncLogWriter writer;
+    ASSERT_EQ(writer.Start(output), CHIP_NO_ERROR);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++)
+    {
+        threads.emplace_back([&writer, t] {
+            for (int i = 0; i < kLinesPerThread; i++)
+            {
+                EXPECT_TRUE(LogLine(writer, "thread %d line %d", t, i));
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    writer.Stop();
+    EXPECT_EQ(writer.GetDroppedLineCount(), 0u);
+
+    std::vector<std::string> lines = ReadLines(output);
+    EXPECT_EQ(lines.size(), static_cast<size_t>(kThreads * kLinesPerThread));
+
+    char expectedPrefix[32];
+    snprintf(expectedPrefix, sizeof(expectedPrefix), "][%lld:", static_cast<long long>(getpid()));
+
+    int nextLine[kThreads] = {};
+    for (const auto & line : lines)
+    {
+        EXPECT_EQ(line[0], '[');
+        EXPECT_NE(line.find(expectedPrefix), std::string::npos);
+
+        size_t messageStart = line.find("] CHIP:TST: ");
+        ASSERT_NE(messageStart, std::string::npos);
+
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ(sscanf(line.c_str() + messageStart, "] CHIP:TST: thread %d line %d", &t, &i), 2);
+        ASSERT_TRUE(t >= 0 && t < kThreads);
+
+        // Lines of each thread come out in the order they were logged.
+        EXPECT_EQ(i, nextLine[t]);
+        nextLine[t] = i + 1;
+    }
+
+    fclose(output);
+}
+
+TEST(TestAsyncLogWriter, TestFlushWritesPendingLines)
+{
+    FILE * output = tmpfile();
+    ASSERT_NE(output, nullptr);
+
+    AsyncLogWriter writer;
+    ASSERT_EQ(writer.Start(output), CHIP_NO_ERROR);
+
+    EXPECT_TRUE(LogLine(writer, "%s has failed", "something"));
+    writer.Flush();
+
+    std::vector<std::string> lines = ReadLines(output);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find("CHIP:TST: something has failed\n"), std::string::npos);
+
+    writer.Stop();
+    fclose(output);
+}
+
+TEST(TestAsyncLogWriter, TestFlushedLineIsWrittenBeforeReturning)
+{
+    // Flushed lines compete with lines other threads are still filling, in a ring that other threads keep full.
+    constexpr int kThreads        = 4;
+    constexpr int kNoisyThreads   = 4;
+    constexpr int kLinesPerThread = 100;
+
+    CapturedOutput output;
+    ASSERT_NE(output.File(), nullptr);
+    // Makes the writer slower than the threads logging.
+    setvbuf(output.File(), nullptr, _IONBF, 0);
+
+    AsyncLogWriter writer;
+    ASSERT_EQ(writer.Start(output.File()), CHIP_NO_ERROR);
+
+    std::atomic<int> remainingThreads{ kThreads };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNoisyThreads; t++)
+    {
+        threads.emplace_back([&writer, &remainingThreads] {
+            while (remainingThreads.load() > 0)
+            {
+                LogLine(writer, "%s", "noise");
+            }
+        });
+    }
+    for (int t = 0; t < kThreads; t++)
+    {
+        threads.emplace_back([&writer, &output, &remainingThreads, t] {
+            for (int i = 0; i < kLinesPerThread; i++)
+            {
+                EXPECT_TRUE(LogFlushedLine(writer, "thread %d line %d", t, i));
+
+                char expected[32];
+                snprintf(expected, sizeof(expected), ": thread %d line %d\n", t, i);
+                EXPECT_TRUE(output.Contains(expected));
+            }
+            remainingThreads--;
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+    writer.Stop();
+}
+
+TEST(TestAsyncLogWriter, TestFormatsLikePrintf)
+{
+    FILE * output = tmpfile();
+    ASSERT_NE(output, nullptr);
+
+    AsyncLogWriter writer;
+    ASSERT_EQ(writer.Start(output), CHIP_NO_ERROR);
+
+    // The writer thread must not see the string as it is once it gets to the line.
+    char name[] = "fabric";
+    const unsigned char flags = 0xa5;
+    const short offset        = -7;
+
+    EXPECT_TRUE(LogLine(writer, "%s|%-8s|%.3s|%*d|%-*.*s|%05.1f|%Le|%c|%%|0x%02hhx|%hd|%" PRIu64 "|%zu|%lld|%p", name, "ab",
+                        "abcdef", 6, -42, 6, 2, "xyz", 3.14159, 2.5L, 'q', flags, offset, static_cast<uint64_t>(1) << 40,
+                        static_cast<size_t>(77), -1LL, static_cast<void *>(nullptr)));
+    strcpy(name, "XXXXXX");
+
+    // A string argument too long to be copied is formatted right away, and truncated as usual.
+    std::string longString(AsyncLogWriter::kMaxMessageLength * 2, 'z');
+    EXPECT_TRUE(LogLine(writer, "long %s", longString.c_str()));
+    writer.Flush();
+
+    char expected[AsyncLogWriter::kMaxMessageLength];
+    snprintf(expected, sizeof(expected), "%s|%-8s|%.3s|%*d|%-*.*s|%05.1f|%Le|%c|%%|0x%02hhx|%hd|%" PRIu64 "|%zu|%lld|%p", "fabric",
+             "ab", "abcdef", 6, -42, 6, 2, "xyz", 3.14159, 2.5L, 'q', flags, offset, static_cast<uint64_t>(1) << 40,
+             static_cast<size_t>(77), -1LL, static_cast<void *>(nullptr));
+    char expectedLong[AsyncLogWriter::kMaxMessageLength];
+    snprintf(expectedLong, sizeof(expectedLong), "long %s", longString.c_str());
+
+    std::vector<std::string> lines = ReadLines(output);
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_NE(lines[0].find(std::string("CHIP:TST: ") + expected + "\n"), std::string::npos);
+    EXPECT_NE(lines[1].find(std::string("CHIP:TST: ") + expectedLong), std::string::npos);
+
+    writer.Stop();
+    fclose(output);
+}
+
+TEST(TestAsyncLogWriter, TestOnlyQueuesWhileRunning)
+{
+    FILE * output = tmpfile();
+    ASSERT_NE(output, nullptr);
+
+    AsyncLogWriter writer;
+    EXPECT_FALSE(LogLine(writer, "before start"));
+
+    ASSERT_EQ(writer.Start(output), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Start(output), CHIP_ERROR_INCORRECT_STATE);
+    EXPECT_TRUE(LogLine(writer, "while running"));
+    writer.Stop();
+
+    EXPECT_FALSE(LogLine(writer, "after stop"));
+    EXPECT_EQ(ReadLines(output).size(), 1u);
+
+    fclose(output);
+}
+
+// Not a pass/fail test, so disabled by default: compares the time spent in the logging thread per line, writing
+// synchronously or not.
+TEST(TestAsyncLogWriter, DISABLED_BenchmarkLogCallOverhead)
+{
+    constexpr unsigned kLines      = 20480;
+    constexpr unsigned kBurstLines = AsyncLogWriter::kMaxPendingLines / 2;
+    static_assert(kLines % kBurstLines == 0, "Whole bursts only");
+
+    FILE * output = fopen("/dev/null", "w");
+    ASSERT_NE(output, nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < kLines; i++)
+    {
+        LogLineSynchronously(output, "Received message of type 0x%02x with protocolId %u and MessageCounter:%u on exchange %u",
+                             0x05, 1u, i, 1234u);
+    }
+    auto synchronousNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    AsyncLogWriter writer;
+    ASSERT_EQ(writer.Start(output), CHIP_NO_ERROR);
+
+    // Log in bursts that fit in the ring, giving the writer thread time to catch up in between, as lines that get dropped
+    // would be unfairly cheap.
+    std::chrono::nanoseconds asyncNs(0);
+    for (unsigned i = 0; i < kLines; i += kBurstLines)
+    {
+        start = std::chrono::steady_clock::now();
+        for (unsigned j = i; j < i + kBurstLines; j++)
+        {
+            LogLine(writer, "Received message of type 0x%02x with protocolId %u and MessageCounter:%u on exchange %u", 0x05, 1u,
+                    j, 1234u);
+        }
+        asyncNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    writer.Stop();
+
+    printf("Log call overhead: %u ns/line synchronous, %u ns/line queued (%u of %u lines dropped)\n",
+           static_cast<unsigned>(synchronousNs.count() / kLines), static_cast<unsigned>(asyncNs.count() / kLines),
+           static_cast<unsigned>(writer.GetDroppedLineCount()), kLines);
+
+    fclose(output);
+}
+
+} // namespace
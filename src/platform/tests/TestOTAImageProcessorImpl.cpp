@@ -0,0 +1,306 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the Linux OTA image processor,
+ *      which writes the image on a background thread and hashes it as it goes.
+ *
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <app/clusters/ota-requestor/OTARequestorInterface.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/OTAImageHeader.h>
+#include <lib/core/TLVWriter.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/Linux/OTAImageProcessorImpl.h>
+#include <platform/TestOnlyCommissionableDataProvider.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer;
+
+namespace chip {
+
+// The OTA requestor is part of the application data model, which these tests do not link.
+OTARequestorInterface * GetRequestorInstance()
+{
+    return nullptr;
+}
+
+} // namespace chip
+
+namespace {
+
+constexpr char kImageFile[] = "/tmp/TestOTAImageProcessorImpl.ota";
+constexpr size_t kBlockSize = 1024;
+// More than the staging buffer of the writer thread, and not a multiple of the O_DIRECT alignment.
+constexpr size_t kPayloadSize = 200 * 1024 + 123;
+
+// Builds a Matter OTA image with a SHA-256 digest of its payload.
+std::vector<uint8_t> MakeImage(const std::vector<uint8_t> & payload, bool corruptDigest)
+{
+    uint8_t digest[Crypto::kSHA256_Hash_Length];
+    EXPECT_EQ(Crypto::Hash_SHA256(payload.data(), payload.size(), digest), CHIP_NO_ERROR);
+    if (corruptDigest)
+    {
+        digest[0] ^= 0xFF;
+    }
+
+    uint8_t tlv[256];
+    TLV::TLVWriter writer;
+    TLV::TLVType outerType;
+    writer.Init(tlv);
+    EXPECT_EQ(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Put(TLV::ContextTag(0), static_cast<uint16_t>(0xFFF1)), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Put(TLV::ContextTag(1), static_cast<uint16_t>(0x8000)), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Put(TLV::ContextTag(2), static_cast<uint32_t>(2)), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.PutString(TLV::ContextTag(3), "2.0"), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Put(TLV::ContextTag(4), static_cast<uint64_t>(payload.size())), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Put(TLV::ContextTag(8), static_cast<uint8_t>(OTAImageDigestType::kSha256)), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Put(TLV::ContextTag(9), ByteSpan(digest)), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.EndContainer(outerType), CHIP_NO_ERROR);
+    EXPECT_EQ(writer.Finalize(), CHIP_NO_ERROR);
+
+    const uint32_t tlvSize   = writer.GetLengthWritten();
+    const uint64_t totalSize = 16 + tlvSize + payload.size();
+    std::vector<uint8_t> image(16);
+    Encoding::LittleEndian::Put32(&image[0], kOTAImageFileIdentifier);
+    Encoding::LittleEndian::Put64(&image[4], totalSize);
+    Encoding::LittleEndian::Put32(&image[12], tlvSize);
+    image.insert(image.end(), tlv, tlv + tlvSize);
+    image.insert(image.end(), payload.begin(), payload.end());
+    return image;
+}
+
+// Feeds the image from the CHIP thread one block at a time, whenever the image processor asks for more data,
+// and finalizes it after the last block.
+class TestDownloader : public OTADownloader
+{
+public:
+    void Init(OTAImageProcessorImpl * processor, std::vector<uint8_t> image)
+    {
+        mProcessor = processor;
+        mImage     = std::move(image);
+        mOffset    = 0;
+        mStallAt   = mImage.size();
+        SetImageProcessorDelegate(processor);
+        processor->SetOTADownloader(this);
+    }
+
+    CHIP_ERROR BeginPrepareDownload() override { return mProcessor->PrepareDownload(); }
+
+    CHIP_ERROR OnPreparedForDownload(CHIP_ERROR status) override
+    {
+        if (status != CHIP_NO_ERROR)
+        {
+            EndDownload(status);
+            return CHIP_NO_ERROR;
+        }
+        return FetchNextData();
+    }
+
+    void OnDownloadTimeout() override {}
+
+    void EndDownload(CHIP_ERROR reason) override { mEnded = true; }
+
+    CHIP_ERROR FetchNextData() override
+    {
+        if (mOffset >= mStallAt && mOffset < mImage.size())
+        {
+            mStalled = true;
+            return CHIP_NO_ERROR;
+        }
+        if (mOffset == mImage.size())
+        {
+            mFinalizing = true;
+            return mProcessor->Finalize();
+        }
+
+        ByteSpan block(mImage.data() + mOffset, std::min(kBlockSize, mImage.size() - mOffset));
+        mOffset += block.size();
+        return mProcessor->ProcessBlock(block);
+    }
+
+    OTAImageProcessorImpl * mProcessor = nullptr;
+    std::vector<uint8_t> mImage;
+    // Only accessed with the CHIP stack locked.
+    size_t mOffset   = 0;
+    size_t mStallAt  = 0;
+    bool mStalled    = false;
+    bool mFinalizing = false;
+    bool mEnded      = false;
+};
+
+// Note, as in TestPlatformMgr, the waits use a busy loop with a timeout.
+template <typename Condition>
+bool WaitFor(Condition condition)
+{
+    for (size_t t = 0; t < 5000; t++)
+    {
+        PlatformMgr().LockChipStack();
+        bool done = condition();
+        PlatformMgr().UnlockChipStack();
+        if (done)
+        {
+            return true;
+        }
+        chip::test_utils::SleepMillis(1);
+    }
+    return false;
+}
+
+std::vector<uint8_t> ReadImageFile()
+{
+    std::vector<uint8_t> contents;
+    FILE * file = fopen(kImageFile, "rb");
+    VerifyOrReturnValue(file != nullptr, contents);
+
+    uint8_t buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        contents.insert(contents.end(), buffer, buffer + length);
+    }
+    fclose(file);
+    return contents;
+}
+
+std::vector<uint8_t> MakePayload()
+{
+    std::vector<uint8_t> payload(kPayloadSize);
+    for (size_t i = 0; i < payload.size(); i++)
+    {
+        payload[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+    }
+    return payload;
+}
+
+class TestOTAImageProcessorImpl : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite()
+    {
+        ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR);
+
+        static TestOnlyCommissionableDataProvider commissionable_data_provider;
+        SetCommissionableDataProvider(&commissionable_data_provider);
+
+        ASSERT_EQ(PlatformMgr().InitChipStack(), CHIP_NO_ERROR);
+        ASSERT_EQ(PlatformMgr().StartEventLoopTask(), CHIP_NO_ERROR);
+    }
+
+    static void TearDownTestSuite()
+    {
+        PlatformMgr().StopEventLoopTask();
+        PlatformMgr().Shutdown();
+        chip::Platform::MemoryShutdown();
+    }
+
+    void SetUp() override
+    {
+        unlink(kImageFile);
+        mProcessor.SetOTAImageFile(kImageFile);
+    }
+
+    void TearDown() override
+    {
+        // Stops the writer thread if still running, then lets the events already posted for the download run
+        // before the downloader and the image processor go away.
+        EXPECT_EQ(mProcessor.Abort(), CHIP_NO_ERROR);
+        EXPECT_TRUE(WaitFor([] { return access(kImageFile, F_OK) != 0; }));
+
+        std::atomic<bool> drained{ false };
+        PlatformMgr().ScheduleWork([](intptr_t context) { *reinterpret_cast<std::atomic<bool> *>(context) = true; },
+                                   reinterpret_cast<intptr_t>(&drained));
+        EXPECT_TRUE(WaitFor([&drained] { return drained.load(); }));
+    }
+
+    // Downloads the image, stopping to request data past stallAt bytes if given, as a stalled transfer would.
+    void StartDownload(bool corruptDigest, size_t stallAt = SIZE_MAX)
+    {
+        mPayload = MakePayload();
+        mDownloader.Init(&mProcessor, MakeImage(mPayload, corruptDigest));
+        mDownloader.mStallAt = std::min(stallAt, mDownloader.mImage.size());
+        EXPECT_EQ(mDownloader.BeginPrepareDownload(), CHIP_NO_ERROR);
+    }
+
+    OTAImageProcessorImpl mProcessor;
+    TestDownloader mDownloader;
+    std::vector<uint8_t> mPayload;
+};
+
+TEST_F(TestOTAImageProcessorImpl, TestWritesAndVerifiesImage)
+{
+    StartDownload(false);
+
+    ASSERT_TRUE(WaitFor([this] { return mProcessor.IsImageValid(); }));
+    EXPECT_FALSE(mDownloader.mEnded);
+    EXPECT_EQ(mDownloader.mOffset, mDownloader.mImage.size());
+
+    // Only the payload is written, past the header.
+    EXPECT_EQ(ReadImageFile(), mPayload);
+}
+
+TEST_F(TestOTAImageProcessorImpl, TestRejectsImageWithWrongDigest)
+{
+    StartDownload(true);
+
+    // The image file exists from the start of the download, until the failed verification removes it.
+    ASSERT_TRUE(WaitFor([this] { return mDownloader.mFinalizing; }));
+    ASSERT_TRUE(WaitFor([] { return access(kImageFile, F_OK) != 0; }));
+    EXPECT_FALSE(mProcessor.IsImageValid());
+    EXPECT_FALSE(mDownloader.mEnded);
+}
+
+TEST_F(TestOTAImageProcessorImpl, TestAbortDiscardsVerifiedImage)
+{
+    StartDownload(false);
+    ASSERT_TRUE(WaitFor([this] { return mProcessor.IsImageValid(); }));
+
+    // An aborted image must not be applied afterwards.
+    EXPECT_EQ(mProcessor.Abort(), CHIP_NO_ERROR);
+    ASSERT_TRUE(WaitFor([this] { return !mProcessor.IsImageValid(); }));
+    EXPECT_NE(access(kImageFile, F_OK), 0);
+}
+
+TEST_F(TestOTAImageProcessorImpl, TestAbortDuringDownload)
+{
+    StartDownload(false, kPayloadSize / 2);
+    ASSERT_TRUE(WaitFor([this] { return mDownloader.mStalled; }));
+
+    // The writer thread stops with blocks still queued; the partial image is removed and never becomes valid.
+    EXPECT_EQ(mProcessor.Abort(), CHIP_NO_ERROR);
+    ASSERT_TRUE(WaitFor([] { return access(kImageFile, F_OK) != 0; }));
+    EXPECT_FALSE(mProcessor.IsImageValid());
+    EXPECT_FALSE(mDownloader.mFinalizing);
+}
+
+} // namespace
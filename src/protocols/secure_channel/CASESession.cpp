@@ -371,6 +371,11 @@ struct CASESession::HandleSigma3Data
     NodeId initiatorNodeId;
 
     ValidationContext validContext;
+
+    // Filled in Sigma3a if the chain was found in the fabric table's verified chain cache, in Sigma3b otherwise.
+    VerifiedCertChainCache::Digest chainDigest;
+    VerifiedCertChainCache::VerifiedChain verifiedChain;
+    bool isChainFromCache;
 };
 
 CASESession::~CASESession()
@@ -1366,8 +1371,7 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
 
     P256ECDSASignature tbsData2Signature;
 
-    NodeId responderNodeId;
-    P256PublicKey responderPublicKey;
+    VerifiedCertChainCache::VerifiedChain responderChain;
 
     uint8_t responderRandom[kSigmaParamRandomNumberSize];
     ByteSpan responderNOC;
@@ -1458,15 +1462,13 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
     // Validate responder identity located in msg_r2_encrypted
     // Constructing responder identity
     {
-        CompressedFabricId unused;
-        FabricId responderFabricId;
         SuccessOrExit(err = SetEffectiveTime());
-        SuccessOrExit(err = mFabricsTable->VerifyCredentials(mFabricIndex, responderNOC, responderICAC, mValidContext, unused,
-                                                             responderFabricId, responderNodeId, responderPublicKey));
-        VerifyOrExit(fabricId == responderFabricId, err = CHIP_ERROR_INVALID_CASE_PARAMETER);
-        // Verify that responderNodeId (from responderNOC) matches one that was included
+        SuccessOrExit(
+            err = mFabricsTable->VerifyCredentials(mFabricIndex, responderNOC, responderICAC, mValidContext, responderChain));
+        VerifyOrExit(fabricId == responderChain.fabricId, err = CHIP_ERROR_INVALID_CASE_PARAMETER);
+        // Verify that the responder node ID (from responderNOC) matches one that was included
         // in the computation of the Destination Identifier when generating Sigma1.
-        VerifyOrExit(mPeerNodeId == responderNodeId, err = CHIP_ERROR_INVALID_CASE_PARAMETER);
+        VerifyOrExit(mPeerNodeId == responderChain.nodeId, err = CHIP_ERROR_INVALID_CASE_PARAMETER);
     }
 
     // Construct msg_R2_Signed and validate the signature in msg_r2_encrypted
@@ -1485,14 +1487,15 @@ CHIP_ERROR CASESession::HandleSigma2(System::PacketBufferHandle && msg)
     SuccessOrExit(err = decryptedDataTlvReader.GetBytes(tbsData2Signature.Bytes(), tbsData2Signature.Length()));
 
     // Validate signature
-    SuccessOrExit(err = responderPublicKey.ECDSA_validate_msg_signature(msg_R2_Signed.Get(), msg_r2_signed_len, tbsData2Signature));
+    SuccessOrExit(err = responderChain.nocPublicKey.ECDSA_validate_msg_signature(msg_R2_Signed.Get(), msg_r2_signed_len,
+                                                                                  tbsData2Signature));
 
     // Retrieve session resumption ID
     SuccessOrExit(err = decryptedDataTlvReader.Next(TLV::kTLVType_ByteString, TLV::ContextTag(kTag_TBEData_ResumptionID)));
     SuccessOrExit(err = decryptedDataTlvReader.GetBytes(mNewResumptionId.data(), mNewResumptionId.size()));
 
     // Retrieve peer CASE Authenticated Tags (CATs) from peer's NOC.
-    SuccessOrExit(err = ExtractCATsFromOpCert(responderNOC, mPeerCATs));
+    mPeerCATs = responderChain.cats;
 
     // Retrieve responderMRPParams if present
     if (tlvReader.Next() != CHIP_END_OF_TLV)
@@ -1861,6 +1864,13 @@ CHIP_ERROR CASESession::HandleSigma3a(System::PacketBufferHandle && msg)
             }
         }
 
+        // A chain this fabric validated before does not need to be validated again in Sigma3b.  The cache is only used
+        // here and in Sigma3c, which run on the Matter thread.
+        SuccessOrExit(err = VerifiedCertChainCache::ComputeDigest(data.initiatorNOC, data.initiatorICAC, data.fabricRCAC,
+                                                                  data.validContext, data.chainDigest));
+        data.isChainFromCache = mFabricsTable->GetVerifiedCertChainCache().Find(mFabricIndex, data.chainDigest,
+                                                                                data.validContext, data.verifiedChain);
+
         SuccessOrExit(err = helper->ScheduleWork());
         mHandleSigma3Helper = helper;
         mExchangeCtxt.Value()->WillSendMessage();
@@ -1881,12 +1891,13 @@ CHIP_ERROR CASESession::HandleSigma3b(HandleSigma3Data & data, bool & cancel)
     // Step 5/6
     // Validate initiator identity located in msg->Start()
     // Constructing responder identity
-    CompressedFabricId unused;
-    FabricId initiatorFabricId;
-    P256PublicKey initiatorPublicKey;
-    ReturnErrorOnFailure(FabricTable::VerifyCredentials(data.initiatorNOC, data.initiatorICAC, data.fabricRCAC, data.validContext,
-                                                        unused, initiatorFabricId, data.initiatorNodeId, initiatorPublicKey));
-    VerifyOrReturnError(data.fabricId == initiatorFabricId, CHIP_ERROR_INVALID_CASE_PARAMETER);
+    if (!data.isChainFromCache)
+    {
+        ReturnErrorOnFailure(FabricTable::VerifyCredentials(data.initiatorNOC, data.initiatorICAC, data.fabricRCAC,
+                                                            data.validContext, data.verifiedChain));
+    }
+    VerifyOrReturnError(data.fabricId == data.verifiedChain.fabricId, CHIP_ERROR_INVALID_CASE_PARAMETER);
+    data.initiatorNodeId = data.verifiedChain.nodeId;
 
     // TODO - Validate message signature prior to validating the received operational credentials.
     //        The op cert check requires traversal of cert chain, that is a more expensive operation.
@@ -1894,8 +1905,8 @@ CHIP_ERROR CASESession::HandleSigma3b(HandleSigma3Data & data, bool & cancel)
     //        current flow of code, a malicious node can trigger a DoS style attack on the device.
     //        The same change should be made in Sigma2 processing.
     // Step 7 - Validate Signature
-    ReturnErrorOnFailure(
-        initiatorPublicKey.ECDSA_validate_msg_signature(data.msg_R3_Signed.Get(), data.msg_r3_signed_len, data.tbsData3Signature));
+    ReturnErrorOnFailure(data.verifiedChain.nocPublicKey.ECDSA_validate_msg_signature(
+        data.msg_R3_Signed.Get(), data.msg_r3_signed_len, data.tbsData3Signature));
 
     return CHIP_NO_ERROR;
 }
@@ -1916,8 +1927,11 @@ CHIP_ERROR CASESession::HandleSigma3c(HandleSigma3Data & data, CHIP_ERROR status
     }
 
     // Retrieve peer CASE Authenticated Tags (CATs) from peer's NOC.
+    mPeerCATs = data.verifiedChain.cats;
+
+    if (!data.isChainFromCache && mFabricsTable->FindFabricWithIndex(mFabricIndex) != nullptr)
     {
-        SuccessOrExit(err = ExtractCATsFromOpCert(data.initiatorNOC, mPeerCATs));
+        mFabricsTable->GetVerifiedCertChainCache().Add(mFabricIndex, data.chainDigest, data.validContext, data.verifiedChain);
     }
 
     if (mSessionResumptionStorage != nullptr)
@@ -0,0 +1,474 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/secure_channel/CachedSessionResumptionStorage.h>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+
+namespace chip {
+
+namespace {
+
+bool IgnoreNotFound(CHIP_ERROR & err)
+{
+    if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        err = CHIP_NO_ERROR;
+    }
+    return err == CHIP_NO_ERROR;
+}
+
+} // namespace
+
+CHIP_ERROR CachedSessionResumptionStorage::Init(PersistentStorageDelegate * storage, System::Layer * systemLayer)
+{
+    VerifyOrReturnError(storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    ReturnErrorOnFailure(mBackingStore.Init(storage));
+    mSystemLayer    = systemLayer;
+    mUseCounter     = 0;
+    mPersistedCount = 0;
+    mIndexDirty     = false;
+    mPendingChanges = 0;
+    ReturnErrorOnFailure(LoadFromStorage());
+
+    mInitialized = true;
+    return CHIP_NO_ERROR;
+}
+
+void CachedSessionResumptionStorage::Shutdown()
+{
+    VerifyOrReturn(mInitialized);
+
+    LogErrorOnFailure(Flush());
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(OnFlushTimer, this);
+    }
+    for (auto & entry : mEntries)
+    {
+        ReleaseEntry(entry);
+    }
+    mSystemLayer = nullptr;
+    mInitialized = false;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::FindByScopedNodeId(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                                                              Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    Entry * entry = FindEntry(node);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    Touch(*entry);
+    resumptionId = entry->resumptionId;
+    sharedSecret = entry->sharedSecret;
+    peerCATs     = entry->peerCATs;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::FindByResumptionId(ConstResumptionIdView resumptionId, ScopedNodeId & node,
+                                                              Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    Entry * entry = FindEntry(resumptionId);
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    Touch(*entry);
+    node         = entry->node;
+    sharedSecret = entry->sharedSecret;
+    peerCATs     = entry->peerCATs;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                                                const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    Entry * entry = FindEntry(node);
+    bool isNew    = (entry == nullptr);
+    bool rehash   = false;
+    if (isNew)
+    {
+        entry       = &AllocateEntry();
+        entry->node = node;
+    }
+    else
+    {
+        rehash = !std::equal(resumptionId.begin(), resumptionId.end(), entry->resumptionId.begin());
+    }
+
+    std::copy(resumptionId.begin(), resumptionId.end(), entry->resumptionId.begin());
+    entry->sharedSecret = sharedSecret;
+    entry->peerCATs     = peerCATs;
+    entry->dirty        = true;
+    Touch(*entry);
+
+    if (isNew)
+    {
+        InsertIntoHashTables(static_cast<uint16_t>(entry - mEntries));
+    }
+    else if (rehash)
+    {
+        RebuildHashTables();
+    }
+
+    OnChanged();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::Delete(const ScopedNodeId & node)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    Entry * entry = FindEntry(node);
+    VerifyOrReturnError(entry != nullptr, CHIP_NO_ERROR);
+
+    ReleaseEntry(*entry);
+    RebuildHashTables();
+    OnChanged();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::DeleteAll(FabricIndex fabricIndex)
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    for (auto & entry : mEntries)
+    {
+        if (entry.lastUsed != 0 && entry.node.GetFabricIndex() == fabricIndex)
+        {
+            ReleaseEntry(entry);
+        }
+    }
+    RebuildHashTables();
+
+    // The secrets of a removed fabric must not outlive it in storage: do not wait for the write-behind timer.
+    return Flush();
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::Flush()
+{
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(OnFlushTimer, this);
+    }
+
+    // Removals first, so that the index never has to hold more than kCapacity records.
+    CHIP_ERROR err        = PersistRemovals();
+    CHIP_ERROR entriesErr = PersistEntries();
+    err                   = (err == CHIP_NO_ERROR) ? entriesErr : err;
+
+    if (mIndexDirty)
+    {
+        DefaultSessionResumptionStorage::SessionIndex index;
+        index.mSize = mPersistedCount;
+        for (size_t i = 0; i < mPersistedCount; i++)
+        {
+            index.mNodes[i] = mPersisted[i].node;
+        }
+
+        CHIP_ERROR indexErr = mBackingStore.SaveIndex(index);
+        if (indexErr == CHIP_NO_ERROR)
+        {
+            mIndexDirty = false;
+        }
+        else
+        {
+            ChipLogError(SecureChannel, "Unable to save session resumption index: %" CHIP_ERROR_FORMAT, indexErr.Format());
+            err = (err == CHIP_NO_ERROR) ? indexErr : err;
+        }
+    }
+
+    // Whatever could not be persisted is retried later.
+    mPendingChanges = mIndexDirty ? 1 : 0;
+    for (auto & entry : mEntries)
+    {
+        mPendingChanges += (entry.lastUsed != 0 && entry.dirty) ? 1 : 0;
+    }
+    for (size_t i = 0; i < mPersistedCount; i++)
+    {
+        mPendingChanges += (FindEntry(mPersisted[i].node) == nullptr) ? 1 : 0;
+    }
+    if (mPendingChanges > 0 && mSystemLayer != nullptr)
+    {
+        LogErrorOnFailure(mSystemLayer->StartTimer(
+            System::Clock::Milliseconds32(CHIP_CONFIG_CASE_SESSION_RESUME_WRITE_BEHIND_DELAY_MS), OnFlushTimer, this));
+    }
+
+    return err;
+}
+
+size_t CachedSessionResumptionStorage::HashNode(const ScopedNodeId & node)
+{
+    uint64_t key = node.GetNodeId() ^ (static_cast<uint64_t>(node.GetFabricIndex()) << 56);
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+size_t CachedSessionResumptionStorage::HashResumptionId(ConstResumptionIdView resumptionId)
+{
+    // Resumption IDs are random.
+    return Encoding::LittleEndian::Get32(resumptionId.data());
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::LoadFromStorage()
+{
+    DefaultSessionResumptionStorage::SessionIndex index;
+    ReturnErrorOnFailure(mBackingStore.LoadIndex(index));
+
+    for (size_t i = 0; i < index.mSize && mPersistedCount < kCapacity; i++)
+    {
+        const ScopedNodeId & node = index.mNodes[i];
+        Entry & entry             = mEntries[mPersistedCount];
+
+        CHIP_ERROR err = mBackingStore.LoadState(node, entry.resumptionId, entry.sharedSecret, entry.peerCATs);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SecureChannel,
+                         "Unable to load session resumption state for node " ChipLogFormatX64 ", dropping it: %" CHIP_ERROR_FORMAT,
+                         ChipLogValueX64(node.GetNodeId()), err.Format());
+            LogErrorOnFailure(mBackingStore.Delete(node));
+            continue;
+        }
+
+        // The index lists records from the oldest saved to the most recently saved one.
+        entry.node  = node;
+        entry.dirty = false;
+        Touch(entry);
+        mPersisted[mPersistedCount++] = { node, entry.resumptionId };
+    }
+
+    RebuildHashTables();
+    return CHIP_NO_ERROR;
+}
+
+CachedSessionResumptionStorage::Entry * CachedSessionResumptionStorage::FindEntry(const ScopedNodeId & node)
+{
+    for (size_t probe = 0, bucket = HashNode(node) % kBucketCount; probe < kBucketCount;
+         probe++, bucket = (bucket + 1) % kBucketCount)
+    {
+        uint16_t entryIndex = mNodeBuckets[bucket];
+        VerifyOrReturnValue(entryIndex != kNoEntry, nullptr);
+        if (mEntries[entryIndex].node == node)
+        {
+            return &mEntries[entryIndex];
+        }
+    }
+    return nullptr;
+}
+
+CachedSessionResumptionStorage::Entry * CachedSessionResumptionStorage::FindEntry(ConstResumptionIdView resumptionId)
+{
+    for (size_t probe = 0, bucket = HashResumptionId(resumptionId) % kBucketCount; probe < kBucketCount;
+         probe++, bucket = (bucket + 1) % kBucketCount)
+    {
+        uint16_t entryIndex = mResumptionIdBuckets[bucket];
+        VerifyOrReturnValue(entryIndex != kNoEntry, nullptr);
+        const ResumptionIdStorage & candidate = mEntries[entryIndex].resumptionId;
+        if (std::equal(resumptionId.begin(), resumptionId.end(), candidate.begin()))
+        {
+            return &mEntries[entryIndex];
+        }
+    }
+    return nullptr;
+}
+
+CachedSessionResumptionStorage::Entry & CachedSessionResumptionStorage::AllocateEntry()
+{
+    Entry * victim = &mEntries[0];
+    for (auto & entry : mEntries)
+    {
+        if (entry.lastUsed == 0)
+        {
+            return entry;
+        }
+        if (entry.lastUsed < victim->lastUsed)
+        {
+            victim = &entry;
+        }
+    }
+
+    ChipLogProgress(SecureChannel, "Evicting session resumption record for node " ChipLogFormatX64,
+                    ChipLogValueX64(victim->node.GetNodeId()));
+    ReleaseEntry(*victim);
+    RebuildHashTables();
+    return *victim;
+}
+
+void CachedSessionResumptionStorage::ReleaseEntry(Entry & entry)
+{
+    Crypto::ClearSecretData(entry.sharedSecret.Bytes(), entry.sharedSecret.Capacity());
+    entry.sharedSecret.SetLength(0);
+    entry.node     = ScopedNodeId();
+    entry.lastUsed = 0;
+    entry.dirty    = false;
+}
+
+void CachedSessionResumptionStorage::RebuildHashTables()
+{
+    std::fill(std::begin(mNodeBuckets), std::end(mNodeBuckets), kNoEntry);
+    std::fill(std::begin(mResumptionIdBuckets), std::end(mResumptionIdBuckets), kNoEntry);
+    for (size_t i = 0; i < kCapacity; i++)
+    {
+        if (mEntries[i].lastUsed != 0)
+        {
+            InsertIntoHashTables(static_cast<uint16_t>(i));
+        }
+    }
+}
+
+void CachedSessionResumptionStorage::InsertIntoHashTables(uint16_t entryIndex)
+{
+    size_t bucket = HashNode(mEntries[entryIndex].node) % kBucketCount;
+    while (mNodeBuckets[bucket] != kNoEntry)
+    {
+        bucket = (bucket + 1) % kBucketCount;
+    }
+    mNodeBuckets[bucket] = entryIndex;
+
+    bucket = HashResumptionId(mEntries[entryIndex].resumptionId) % kBucketCount;
+    while (mResumptionIdBuckets[bucket] != kNoEntry)
+    {
+        bucket = (bucket + 1) % kBucketCount;
+    }
+    mResumptionIdBuckets[bucket] = entryIndex;
+}
+
+void CachedSessionResumptionStorage::OnChanged()
+{
+    mPendingChanges++;
+    if (mPendingChanges >= CHIP_CONFIG_CASE_SESSION_RESUME_MAX_PENDING_CHANGES)
+    {
+        LogErrorOnFailure(Flush());
+        return;
+    }
+
+    // The timer is armed by the first pending change only, which bounds how long any change stays in RAM.
+    if (mSystemLayer != nullptr && !mSystemLayer->IsTimerActive(OnFlushTimer, this))
+    {
+        LogErrorOnFailure(mSystemLayer->StartTimer(
+            System::Clock::Milliseconds32(CHIP_CONFIG_CASE_SESSION_RESUME_WRITE_BEHIND_DELAY_MS), OnFlushTimer, this));
+    }
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::PersistRemovals()
+{
+    CHIP_ERROR stickyErr = CHIP_NO_ERROR;
+    size_t kept          = 0;
+    for (size_t i = 0; i < mPersistedCount; i++)
+    {
+        const PersistedRecord & record = mPersisted[i];
+        if (FindEntry(record.node) == nullptr)
+        {
+            CHIP_ERROR err = mBackingStore.DeleteLink(record.resumptionId);
+            if (IgnoreNotFound(err))
+            {
+                err = mBackingStore.DeleteState(record.node);
+            }
+            if (IgnoreNotFound(err))
+            {
+                mIndexDirty = true;
+                continue;
+            }
+
+            ChipLogError(SecureChannel,
+                         "Unable to delete session resumption record for node " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                         ChipLogValueX64(record.node.GetNodeId()), err.Format());
+            stickyErr = (stickyErr == CHIP_NO_ERROR) ? err : stickyErr;
+        }
+        mPersisted[kept++] = record;
+    }
+    mPersistedCount = kept;
+    return stickyErr;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::PersistEntries()
+{
+    CHIP_ERROR stickyErr = CHIP_NO_ERROR;
+    for (auto & entry : mEntries)
+    {
+        if (entry.lastUsed == 0 || !entry.dirty)
+        {
+            continue;
+        }
+
+        PersistedRecord * record = std::find_if(mPersisted, mPersisted + mPersistedCount,
+                                                [&entry](const PersistedRecord & r) { return r.node == entry.node; });
+        bool isPersisted         = (record != mPersisted + mPersistedCount);
+        if (!isPersisted && mPersistedCount == kCapacity)
+        {
+            // Only possible while removals keep failing.
+            stickyErr = (stickyErr == CHIP_NO_ERROR) ? CHIP_ERROR_NO_MEMORY : stickyErr;
+            continue;
+        }
+
+        if (isPersisted && record->resumptionId != entry.resumptionId)
+        {
+            // Removal of the old link is best effort, as in DefaultSessionResumptionStorage::Save.
+            CHIP_ERROR err = mBackingStore.DeleteLink(record->resumptionId);
+            if (!IgnoreNotFound(err))
+            {
+                ChipLogError(SecureChannel,
+                             "Unable to delete session resumption link for node " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                             ChipLogValueX64(entry.node.GetNodeId()), err.Format());
+            }
+        }
+
+        CHIP_ERROR err = mBackingStore.SaveState(entry.node, entry.resumptionId, entry.sharedSecret, entry.peerCATs);
+        if (err == CHIP_NO_ERROR)
+        {
+            err = mBackingStore.SaveLink(entry.resumptionId, entry.node);
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SecureChannel,
+                         "Unable to save session resumption record for node " ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                         ChipLogValueX64(entry.node.GetNodeId()), err.Format());
+            stickyErr = (stickyErr == CHIP_NO_ERROR) ? err : stickyErr;
+            continue;
+        }
+
+        if (isPersisted)
+        {
+            record->resumptionId = entry.resumptionId;
+        }
+        else
+        {
+            mPersisted[mPersistedCount++] = { entry.node, entry.resumptionId };
+            mIndexDirty                   = true;
+        }
+        entry.dirty = false;
+    }
+    return stickyErr;
+}
+
+void CachedSessionResumptionStorage::OnFlushTimer(System::Layer * layer, void * context)
+{
+    LogErrorOnFailure(static_cast<CachedSessionResumptionStorage *>(context)->Flush());
+}
+
+} // namespace chip
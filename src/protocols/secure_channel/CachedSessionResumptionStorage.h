@@ -0,0 +1,131 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPConfig.h>
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+
+/**
+ * @brief A SessionResumptionStorage that keeps every resumption record in RAM and persists changes behind the callers.
+ *
+ *   Records are persisted with the same layout as SimpleSessionResumptionStorage, so both can be used on the same storage.
+ *   They are all loaded at Init; lookups by ScopedNodeId and by ResumptionId then go through two small hash tables and
+ *   never touch the storage.
+ *
+ *   Save and Delete only update RAM.  Changes are persisted at most
+ *   CHIP_CONFIG_CASE_SESSION_RESUME_WRITE_BEHIND_DELAY_MS after the first of them, or as soon as
+ *   CHIP_CONFIG_CASE_SESSION_RESUME_MAX_PENDING_CHANGES of them have accumulated.  Within that window, successive changes to
+ *   a record are coalesced and the index is written once.  DeleteAll, which is called when a fabric is removed, persists
+ *   right away.  Losing the pending changes, e.g. on a power loss, only makes the affected peers fall back to a full CASE
+ *   handshake.
+ *
+ *   When full, the least recently used record (saved or looked up) is evicted, instead of the oldest saved one.
+ */
+class CachedSessionResumptionStorage : public SessionResumptionStorage
+{
+public:
+    static constexpr size_t kCapacity = CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE;
+
+    ~CachedSessionResumptionStorage() override { Shutdown(); }
+
+    /**
+     * @param[in] storage      Storage the records are persisted to.
+     * @param[in] systemLayer  Layer used to arm the write-behind timer.  If null, pending changes are only persisted when
+     *                         too many of them have accumulated, or on DeleteAll, Flush and Shutdown.
+     */
+    CHIP_ERROR Init(PersistentStorageDelegate * storage, System::Layer * systemLayer);
+
+    /**
+     * Persists the pending changes and stops using the storage.
+     */
+    void Shutdown();
+
+    CHIP_ERROR FindByScopedNodeId(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                                  Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs) override;
+    CHIP_ERROR FindByResumptionId(ConstResumptionIdView resumptionId, ScopedNodeId & node,
+                                  Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs) override;
+    CHIP_ERROR Save(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                    const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs) override;
+    CHIP_ERROR Delete(const ScopedNodeId & node);
+    CHIP_ERROR DeleteAll(FabricIndex fabricIndex) override;
+
+    /**
+     * Persists the pending changes now.  Changes that could not be persisted stay pending.
+     */
+    CHIP_ERROR Flush();
+
+    size_t GetPendingChangeCount() const { return mPendingChanges; }
+
+private:
+    struct Entry
+    {
+        ScopedNodeId node;
+        ResumptionIdStorage resumptionId;
+        Crypto::P256ECDHDerivedSecret sharedSecret;
+        CATValues peerCATs;
+        uint32_t lastUsed = 0; // 0 for a free entry.
+        bool dirty        = false;
+    };
+
+    // Mirror of what the storage holds, in index order.
+    struct PersistedRecord
+    {
+        ScopedNodeId node;
+        ResumptionIdStorage resumptionId;
+    };
+
+    // Keeps the hash tables at most half full, so that probing always finds a free bucket quickly.
+    static constexpr size_t kBucketCount = 2 * kCapacity + 1;
+    static constexpr uint16_t kNoEntry   = UINT16_MAX;
+    static_assert(kCapacity < kNoEntry, "Session resumption cache too large");
+
+    static size_t HashNode(const ScopedNodeId & node);
+    static size_t HashResumptionId(ConstResumptionIdView resumptionId);
+
+    CHIP_ERROR LoadFromStorage();
+    Entry * FindEntry(const ScopedNodeId & node);
+    Entry * FindEntry(ConstResumptionIdView resumptionId);
+    Entry & AllocateEntry();
+    void ReleaseEntry(Entry & entry);
+    void RebuildHashTables();
+    void InsertIntoHashTables(uint16_t entryIndex);
+    void Touch(Entry & entry) { entry.lastUsed = ++mUseCounter; }
+    void OnChanged();
+    CHIP_ERROR PersistRemovals();
+    CHIP_ERROR PersistEntries();
+    static void OnFlushTimer(System::Layer * layer, void * context);
+
+    SimpleSessionResumptionStorage mBackingStore;
+    System::Layer * mSystemLayer = nullptr;
+    bool mInitialized            = false;
+
+    Entry mEntries[kCapacity];
+    uint16_t mNodeBuckets[kBucketCount];
+    uint16_t mResumptionIdBuckets[kBucketCount];
+    uint32_t mUseCounter = 0;
+
+    PersistedRecord mPersisted[kCapacity];
+    size_t mPersistedCount = 0;
+    bool mIndexDirty       = false;
+    size_t mPendingChanges = 0;
+};
+
+} // namespace chip
@@ -102,10 +102,12 @@ public:
     static constexpr uint16_t kMinPayloadSize =
         Crypto::CHIP_CRYPTO_AEAD_NONCE_LENGTH_BYTES + sizeof(CounterType) + Crypto::CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES;
 
-private:
     /**
      * @brief Generate the Nonce for the Check-In message
      *
+     *        Receivers may use it to precompute the nonces of the Check-In counter values they expect, which identifies the
+     *        sender of a Check-In message without trying to decrypt it with every registered key.
+     *
      * @param[in]   hmacKeyHandle Key handle to use with the HMAC algorithm
      * @param[in]   counter       Check-In Counter value to use as message of the HMAC algorithm
      * @param[out]  output        output buffer for the generated Nonce.
@@ -0,0 +1,379 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <protocols/secure_channel/CachedSessionResumptionStorage.h>
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+
+using namespace chip;
+
+namespace {
+
+class CountingPersistentStorageDelegate : public TestPersistentStorageDelegate
+{
+public:
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override
+    {
+        mReads++;
+        return TestPersistentStorageDelegate::SyncGetKeyValue(key, buffer, size);
+    }
+
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override
+    {
+        mWrites++;
+        return TestPersistentStorageDelegate::SyncSetKeyValue(key, value, size);
+    }
+
+    CHIP_ERROR SyncDeleteKeyValue(const char * key) override
+    {
+        mDeletes++;
+        return TestPersistentStorageDelegate::SyncDeleteKeyValue(key);
+    }
+
+    void ResetCounters() { mReads = mWrites = mDeletes = 0; }
+
+    size_t mReads   = 0;
+    size_t mWrites  = 0;
+    size_t mDeletes = 0;
+};
+
+struct Record
+{
+    SessionResumptionStorage::ResumptionIdStorage resumptionId;
+    Crypto::P256ECDHDerivedSecret sharedSecret;
+    ScopedNodeId node;
+    CATValues cats;
+};
+
+Record MakeRecord(size_t i, uint8_t generation = 0)
+{
+    Record record;
+    EXPECT_EQ(Crypto::DRBG_get_bytes(record.resumptionId.data(), record.resumptionId.size()), CHIP_NO_ERROR);
+    // Keep resumption IDs unique.
+    record.resumptionId[0] = static_cast<uint8_t>(i);
+    record.resumptionId[1] = generation;
+    record.sharedSecret.SetLength(record.sharedSecret.Capacity());
+    EXPECT_EQ(Crypto::DRBG_get_bytes(record.sharedSecret.Bytes(), record.sharedSecret.Length()), CHIP_NO_ERROR);
+    record.node           = ScopedNodeId(static_cast<NodeId>(i + 1), static_cast<FabricIndex>(i % 3 + 1));
+    record.cats.values[0] = static_cast<CASEAuthTag>(((i + 1) << 16) | 1);
+    return record;
+}
+
+CHIP_ERROR Save(SessionResumptionStorage & storage, const Record & record)
+{
+    return storage.Save(record.node, record.resumptionId, record.sharedSecret, record.cats);
+}
+
+void ExpectFound(SessionResumptionStorage & storage, const Record & record)
+{
+    SessionResumptionStorage::ResumptionIdStorage outResumptionId;
+    Crypto::P256ECDHDerivedSecret outSharedSecret;
+    CATValues outCats;
+    ScopedNodeId outNode;
+
+    ASSERT_EQ(storage.FindByScopedNodeId(record.node, outResumptionId, outSharedSecret, outCats), CHIP_NO_ERROR);
+    EXPECT_EQ(outResumptionId, record.resumptionId);
+    EXPECT_TRUE(outSharedSecret.Span().data_equal(record.sharedSecret.Span()));
+    EXPECT_EQ(outCats, record.cats);
+
+    ASSERT_EQ(storage.FindByResumptionId(record.resumptionId, outNode, outSharedSecret, outCats), CHIP_NO_ERROR);
+    EXPECT_EQ(outNode, record.node);
+    EXPECT_TRUE(outSharedSecret.Span().data_equal(record.sharedSecret.Span()));
+    EXPECT_EQ(outCats, record.cats);
+}
+
+void ExpectNotFound(SessionResumptionStorage & storage, const Record & record)
+{
+    SessionResumptionStorage::ResumptionIdStorage outResumptionId;
+    Crypto::P256ECDHDerivedSecret outSharedSecret;
+    CATValues outCats;
+    ScopedNodeId outNode;
+
+    EXPECT_NE(storage.FindByScopedNodeId(record.node, outResumptionId, outSharedSecret, outCats), CHIP_NO_ERROR);
+    EXPECT_NE(storage.FindByResumptionId(record.resumptionId, outNode, outSharedSecret, outCats), CHIP_NO_ERROR);
+}
+
+} // namespace
+
+TEST(TestCachedSessionResumptionStorage, TestWriteBehind)
+{
+    static_assert(CHIP_CONFIG_CASE_SESSION_RESUME_MAX_PENDING_CHANGES > 2, "Test expects a write-behind window");
+
+    CountingPersistentStorageDelegate storage;
+    CachedSessionResumptionStorage sessionStorage;
+    EXPECT_EQ(sessionStorage.Init(&storage, nullptr), CHIP_NO_ERROR);
+
+    Record first  = MakeRecord(0);
+    Record second = MakeRecord(1);
+    storage.ResetCounters();
+
+    // Changes are only applied in RAM.
+    EXPECT_EQ(Save(sessionStorage, first), CHIP_NO_ERROR);
+    EXPECT_EQ(Save(sessionStorage, second), CHIP_NO_ERROR);
+    ExpectFound(sessionStorage, first);
+    ExpectFound(sessionStorage, second);
+    EXPECT_EQ(storage.mReads, 0u);
+    EXPECT_EQ(storage.mWrites, 0u);
+    EXPECT_EQ(sessionStorage.GetPendingChangeCount(), 2u);
+
+    // A flush writes each record and its link, and the index once.
+    EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.mWrites, 5u);
+    EXPECT_EQ(sessionStorage.GetPendingChangeCount(), 0u);
+
+    // Records are stored in the layout of SimpleSessionResumptionStorage.
+    SimpleSessionResumptionStorage simpleStorage;
+    EXPECT_EQ(simpleStorage.Init(&storage), CHIP_NO_ERROR);
+    ExpectFound(simpleStorage, first);
+    ExpectFound(simpleStorage, second);
+
+    // Nothing left to write.
+    storage.ResetCounters();
+    EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.mWrites + storage.mDeletes, 0u);
+}
+
+TEST(TestCachedSessionResumptionStorage, TestCoalescing)
+{
+    CountingPersistentStorageDelegate storage;
+    CachedSessionResumptionStorage sessionStorage;
+    EXPECT_EQ(sessionStorage.Init(&storage, nullptr), CHIP_NO_ERROR);
+
+    Record record = MakeRecord(0);
+    EXPECT_EQ(Save(sessionStorage, record), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+    Record persisted = record;
+
+    // Repeated resumptions of the same peer within the window end up as a single update.
+    storage.ResetCounters();
+    for (uint8_t generation = 1; generation < CHIP_CONFIG_CASE_SESSION_RESUME_MAX_PENDING_CHANGES; generation++)
+    {
+        record = MakeRecord(0, generation);
+        EXPECT_EQ(Save(sessionStorage, record), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(storage.mWrites, 0u);
+    EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+
+    // Old link deleted, state and new link written, index unchanged.
+    EXPECT_EQ(storage.mDeletes, 1u);
+    EXPECT_EQ(storage.mWrites, 2u);
+    ExpectFound(sessionStorage, record);
+
+    ScopedNodeId outNode;
+    Crypto::P256ECDHDerivedSecret outSharedSecret;
+    CATValues outCats;
+    EXPECT_NE(sessionStorage.FindByResumptionId(persisted.resumptionId, outNode, outSharedSecret, outCats), CHIP_NO_ERROR);
+
+    SimpleSessionResumptionStorage simpleStorage;
+    EXPECT_EQ(simpleStorage.Init(&storage), CHIP_NO_ERROR);
+    ExpectFound(simpleStorage, record);
+    EXPECT_EQ(simpleStorage.FindNodeByResumptionId(persisted.resumptionId, outNode), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    // A record saved and deleted within the window never reaches the storage.
+    Record transient = MakeRecord(1);
+    EXPECT_EQ(Save(sessionStorage, transient), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Delete(transient.node), CHIP_NO_ERROR);
+    storage.ResetCounters();
+    EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.mWrites + storage.mDeletes, 0u);
+}
+
+TEST(TestCachedSessionResumptionStorage, TestBoundedPendingChanges)
+{
+    CountingPersistentStorageDelegate storage;
+    CachedSessionResumptionStorage sessionStorage;
+    EXPECT_EQ(sessionStorage.Init(&storage, nullptr), CHIP_NO_ERROR);
+
+    constexpr size_t kMaxPending = CHIP_CONFIG_CASE_SESSION_RESUME_MAX_PENDING_CHANGES;
+    for (size_t i = 0; i + 1 < kMaxPending; i++)
+    {
+        EXPECT_EQ(Save(sessionStorage, MakeRecord(i % CachedSessionResumptionStorage::kCapacity, static_cast<uint8_t>(i))),
+                  CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(storage.mWrites, 0u);
+    EXPECT_EQ(sessionStorage.GetPendingChangeCount(), kMaxPending - 1);
+
+    // The change that fills the window is persisted along with the others.
+    EXPECT_EQ(Save(sessionStorage, MakeRecord(0, 0xFF)), CHIP_NO_ERROR);
+    EXPECT_GT(storage.mWrites, 0u);
+    EXPECT_EQ(sessionStorage.GetPendingChangeCount(), 0u);
+}
+
+TEST(TestCachedSessionResumptionStorage, TestLoadAndLeastRecentlyUsedEviction)
+{
+    constexpr size_t kCapacity = CachedSessionResumptionStorage::kCapacity;
+    static_assert(kCapacity >= 2, "Test needs room for two records");
+
+    CountingPersistentStorageDelegate storage;
+    Record records[kCapacity + 1];
+    for (size_t i = 0; i < ArraySize(records); i++)
+    {
+        records[i] = MakeRecord(i);
+    }
+
+    // Fill the storage through the existing implementation.
+    {
+        SimpleSessionResumptionStorage simpleStorage;
+        EXPECT_EQ(simpleStorage.Init(&storage), CHIP_NO_ERROR);
+        for (size_t i = 0; i < kCapacity; i++)
+        {
+            EXPECT_EQ(Save(simpleStorage, records[i]), CHIP_NO_ERROR);
+        }
+    }
+
+    CachedSessionResumptionStorage sessionStorage;
+    EXPECT_EQ(sessionStorage.Init(&storage, nullptr), CHIP_NO_ERROR);
+
+    // Everything is served from RAM.
+    storage.ResetCounters();
+    for (size_t i = 0; i < kCapacity; i++)
+    {
+        ExpectFound(sessionStorage, records[i]);
+    }
+    EXPECT_EQ(storage.mReads, 0u);
+
+    // Records 0 and 1 are the oldest saved; looking up record 0 makes record 1 the least recently used.
+    for (size_t i = 1; i < kCapacity; i++)
+    {
+        ExpectFound(sessionStorage, records[i]);
+    }
+    ExpectFound(sessionStorage, records[0]);
+    EXPECT_EQ(Save(sessionStorage, records[kCapacity]), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+
+    ExpectNotFound(sessionStorage, records[1]);
+    ExpectFound(sessionStorage, records[0]);
+    ExpectFound(sessionStorage, records[kCapacity]);
+
+    SimpleSessionResumptionStorage simpleStorage;
+    EXPECT_EQ(simpleStorage.Init(&storage), CHIP_NO_ERROR);
+    ExpectNotFound(simpleStorage, records[1]);
+    for (size_t i = 0; i < ArraySize(records); i++)
+    {
+        if (i != 1)
+        {
+            ExpectFound(simpleStorage, records[i]);
+        }
+    }
+}
+
+TEST(TestCachedSessionResumptionStorage, TestDeleteAllPersistsImmediately)
+{
+    CountingPersistentStorageDelegate storage;
+    CachedSessionResumptionStorage sessionStorage;
+    EXPECT_EQ(sessionStorage.Init(&storage, nullptr), CHIP_NO_ERROR);
+
+    Record records[3] = { MakeRecord(0), MakeRecord(1), MakeRecord(3) };
+    for (auto & record : records)
+    {
+        EXPECT_EQ(Save(sessionStorage, record), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+
+    // Records 0 and 3 belong to fabric 1.
+    EXPECT_EQ(sessionStorage.DeleteAll(1), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.GetPendingChangeCount(), 0u);
+    ExpectNotFound(sessionStorage, records[0]);
+    ExpectFound(sessionStorage, records[1]);
+    ExpectNotFound(sessionStorage, records[2]);
+
+    SimpleSessionResumptionStorage simpleStorage;
+    EXPECT_EQ(simpleStorage.Init(&storage), CHIP_NO_ERROR);
+    ExpectNotFound(simpleStorage, records[0]);
+    ExpectFound(simpleStorage, records[1]);
+    ExpectNotFound(simpleStorage, records[2]);
+}
+
+TEST(TestCachedSessionResumptionStorage, TestShutdownFlushes)
+{
+    CountingPersistentStorageDelegate storage;
+    Record record = MakeRecord(0);
+    {
+        CachedSessionResumptionStorage sessionStorage;
+        EXPECT_EQ(sessionStorage.Init(&storage, nullptr), CHIP_NO_ERROR);
+        EXPECT_EQ(Save(sessionStorage, record), CHIP_NO_ERROR);
+        EXPECT_EQ(storage.mWrites, 0u);
+    }
+
+    CachedSessionResumptionStorage sessionStorage;
+    EXPECT_EQ(sessionStorage.Init(&storage, nullptr), CHIP_NO_ERROR);
+    ExpectFound(sessionStorage, record);
+}
+
+TEST(TestCachedSessionResumptionStorage, TestReconnectStormStorageTraffic)
+{
+    // Every peer resumes, then saves its new resumption record, several times in a row.
+    constexpr size_t kPeers  = CachedSessionResumptionStorage::kCapacity;
+    constexpr size_t kRounds = 5;
+
+    Record records[kPeers];
+    for (size_t i = 0; i < kPeers; i++)
+    {
+        records[i] = MakeRecord(i);
+    }
+
+    auto runStorm = [&](SessionResumptionStorage & sessionStorage) {
+        for (uint8_t round = 1; round <= kRounds; round++)
+        {
+            for (size_t i = 0; i < kPeers; i++)
+            {
+                ScopedNodeId outNode;
+                Crypto::P256ECDHDerivedSecret outSharedSecret;
+                CATValues outCats;
+                EXPECT_EQ(sessionStorage.FindByResumptionId(records[i].resumptionId, outNode, outSharedSecret, outCats),
+                          CHIP_NO_ERROR);
+                records[i] = MakeRecord(i, round);
+                EXPECT_EQ(Save(sessionStorage, records[i]), CHIP_NO_ERROR);
+            }
+        }
+    };
+
+    size_t simpleAccesses;
+    {
+        CountingPersistentStorageDelegate storage;
+        SimpleSessionResumptionStorage sessionStorage;
+        EXPECT_EQ(sessionStorage.Init(&storage), CHIP_NO_ERROR);
+        for (auto & record : records)
+        {
+            EXPECT_EQ(Save(sessionStorage, record), CHIP_NO_ERROR);
+        }
+        storage.ResetCounters();
+        runStorm(sessionStorage);
+        simpleAccesses = storage.mReads + storage.mWrites + storage.mDeletes;
+    }
+
+    size_t cachedAccesses;
+    {
+        CountingPersistentStorageDelegate storage;
+        CachedSessionResumptionStorage sessionStorage;
+        EXPECT_EQ(sessionStorage.Init(&storage, nullptr), CHIP_NO_ERROR);
+        for (auto & record : records)
+        {
+            EXPECT_EQ(Save(sessionStorage, record), CHIP_NO_ERROR);
+        }
+        EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+        storage.ResetCounters();
+        runStorm(sessionStorage);
+        EXPECT_EQ(sessionStorage.Flush(), CHIP_NO_ERROR);
+        EXPECT_EQ(storage.mReads, 0u);
+        cachedAccesses = storage.mReads + storage.mWrites + storage.mDeletes;
+    }
+
+    EXPECT_LT(cachedAccesses, simpleAccesses);
+}
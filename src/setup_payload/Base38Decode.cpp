@@ -25,82 +25,47 @@
 
 namespace {
 
-static inline CHIP_ERROR decodeChar(char c, uint8_t & value)
+constexpr uint8_t kBogus = 255;
+
+struct DecodeTable
+{
+    uint8_t values[256];
+};
+
+// Maps every character to its base38 numeric value, or kBogus for characters that are not part of the alphabet, so that
+// a character is decoded with a single lookup.
+constexpr DecodeTable MakeDecodeTable()
 {
-    static const int kBogus = 255;
-    // map of base38 charater to numeric value
-    // subtract 45 from the charater, then index into this array, if possible
-    const uint8_t decodes[] = {
-        36,     // '-', =45
-        37,     // '.', =46
-        kBogus, // '/', =47
-        0,      // '0', =48
-        1,      // '1', =49
-        2,      // '2', =50
-        3,      // '3', =51
-        4,      // '4', =52
-        5,      // '5', =53
-        6,      // '6', =54
-        7,      // '7', =55
-        8,      // '8', =56
-        9,      // '9', =57
-        kBogus, // ':', =58
-        kBogus, // ';', =59
-        kBogus, // '<', =50
-        kBogus, // '=', =61
-        kBogus, // '>', =62
-        kBogus, // '?', =63
-        kBogus, // '@', =64
-        10,     // 'A', =65
-        11,     // 'B', =66
-        12,     // 'C', =67
-        13,     // 'D', =68
-        14,     // 'E', =69
-        15,     // 'F', =70
-        16,     // 'G', =71
-        17,     // 'H', =72
-        18,     // 'I', =73
-        19,     // 'J', =74
-        20,     // 'K', =75
-        21,     // 'L', =76
-        22,     // 'M', =77
-        23,     // 'N', =78
-        24,     // 'O', =79
-        25,     // 'P', =80
-        26,     // 'Q', =81
-        27,     // 'R', =82
-        28,     // 'S', =83
-        29,     // 'T', =84
-        30,     // 'U', =85
-        31,     // 'V', =86
-        32,     // 'W', =87
-        33,     // 'X', =88
-        34,     // 'Y', =89
-        35,     // 'Z', =90
-    };
-    if (c < '-' || c > 'Z')
+    DecodeTable table = {};
+    for (auto & value : table.values)
     {
-        return CHIP_ERROR_INVALID_INTEGER_VALUE;
+        value = kBogus;
     }
-    uint8_t v = decodes[c - '-'];
-    if (v == kBogus)
+    for (uint8_t i = 0; i < 10; i++)
     {
-        return CHIP_ERROR_INVALID_INTEGER_VALUE;
+        table.values['0' + i] = i;
     }
-    value = v;
-    return CHIP_NO_ERROR;
+    for (uint8_t i = 0; i < 26; i++)
+    {
+        table.values['A' + i] = static_cast<uint8_t>(10 + i);
+    }
+    table.values['-'] = 36;
+    table.values['.'] = 37;
+    return table;
 }
 
+constexpr DecodeTable kDecodeTable = MakeDecodeTable();
+
 } // unnamed namespace
 
 namespace chip {
 
-CHIP_ERROR base38Decode(std::string base38, std::vector<uint8_t> & result)
+CHIP_ERROR base38Decode(CharSpan base38, MutableByteSpan & out)
 {
-    result.clear();
-
-    size_t base38CharactersNumber  = base38.length();
+    const char * base38Characters  = base38.data();
+    size_t base38CharactersNumber  = base38.size();
     size_t decodedBase38Characters = 0;
+    size_t decodedBytes            = 0;
     while (base38CharactersNumber > 0)
     {
         uint8_t base38CharactersInChunk;
@@ -130,22 +95,18 @@ CHIP_ERROR base38Decode(std::string base38, std::vector<uint8_t> & result)
 
         for (size_t i = base38CharactersInChunk; i > 0; i--)
         {
-            uint8_t v      = 0;
-            CHIP_ERROR err = decodeChar(base38[decodedBase38Characters + i - 1], v);
-
-            if (err != CHIP_NO_ERROR)
-            {
-                return err;
-            }
+            uint8_t v = kDecodeTable.values[static_cast<uint8_t>(base38Characters[decodedBase38Characters + i - 1])];
+            VerifyOrReturnError(v != kBogus, CHIP_ERROR_INVALID_INTEGER_VALUE);
 
             value = value * kRadix + v;
         }
         decodedBase38Characters += base38CharactersInChunk;
         base38CharactersNumber -= base38CharactersInChunk;
 
+        VerifyOrReturnError(decodedBytes + bytesInDecodedChunk <= out.size(), CHIP_ERROR_BUFFER_TOO_SMALL);
         for (size_t i = 0; i < bytesInDecodedChunk; i++)
         {
-            result.push_back(static_cast<uint8_t>(value));
+            out.data()[decodedBytes++] = static_cast<uint8_t>(value);
             value >>= 8;
         }
 
@@ -155,7 +116,35 @@ CHIP_ERROR base38Decode(std::string base38, std::vector<uint8_t> & result)
             return CHIP_ERROR_INVALID_ARGUMENT;
         }
     }
+
+    out.reduce_size(decodedBytes);
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR base38Decode(const std::string & base38, std::vector<uint8_t> & result)
+{
+    result.resize(base38DecodedLength(base38.length()));
+
+    MutableByteSpan decoded(result.data(), result.size());
+    CHIP_ERROR err = base38Decode(CharSpan(base38.data(), base38.length()), decoded);
+    result.resize(err == CHIP_NO_ERROR ? decoded.size() : 0);
+    return err;
+}
+
+size_t base38DecodedLength(size_t num_chars)
+{
+    const size_t lastChunkCharacters = num_chars % kBase38CharactersNeededInNBytesChunk[2];
+    size_t length                    = (num_chars / kBase38CharactersNeededInNBytesChunk[2]) * 3;
+
+    if (lastChunkCharacters >= kBase38CharactersNeededInNBytesChunk[1])
+    {
+        length += 2;
+    }
+    else if (lastChunkCharacters >= kBase38CharactersNeededInNBytesChunk[0])
+    {
+        length += 1;
+    }
+    return length;
+}
+
 } // namespace chip
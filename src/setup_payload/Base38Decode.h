@@ -19,11 +19,27 @@
 
 #include "Base38.h"
 
+#include <lib/support/Span.h>
+
+#include <stddef.h>
 #include <string>
 #include <vector>
 
 namespace chip {
 
-CHIP_ERROR base38Decode(std::string base38, std::vector<uint8_t> & out);
+CHIP_ERROR base38Decode(const std::string & base38, std::vector<uint8_t> & out);
+
+/**
+ * Decodes a Base38 string into a caller-provided buffer, without allocating memory.  On success, out is resized to the
+ * decoded bytes.
+ *
+ * @retval CHIP_ERROR_BUFFER_TOO_SMALL if out cannot hold the decoded bytes, see base38DecodedLength().
+ */
+CHIP_ERROR base38Decode(CharSpan base38, MutableByteSpan & out);
+
+/**
+ * Returns the number of bytes that a Base38 string of the given length decodes to, if the length is valid.
+ */
+size_t base38DecodedLength(size_t num_chars);
 
 } // namespace chip
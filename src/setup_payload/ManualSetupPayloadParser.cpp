@@ -94,50 +94,157 @@ CHIP_ERROR ManualSetupPayloadParser::ReadDigitsFromDecimalString(const std::stri
     return ToNumber(decimalSubstring, dest);
 }
 
-CHIP_ERROR ManualSetupPayloadParser::populatePayload(SetupPayload & outPayload)
+namespace {
+
+// Populate numberOfCharsToRead digits into dest from digits starting at index, like ReadDigitsFromDecimalString does for
+// a std::string.
+CHIP_ERROR readDigits(const char * digits, size_t length, size_t & index, uint32_t & dest, size_t numberOfCharsToRead)
 {
-    CHIP_ERROR result = CHIP_NO_ERROR;
-    SetupPayload payload;
-    std::string representationWithoutCheckDigit;
+    if (numberOfCharsToRead + index > length)
+    {
+        ChipLogError(SetupPayload, "Failed decoding base10. Input was too short. %u", static_cast<unsigned int>(length));
+        return CHIP_ERROR_INVALID_STRING_LENGTH;
+    }
 
-    result = CheckDecimalStringValidity(mDecimalStringRepresentation, representationWithoutCheckDigit);
-    if (result != CHIP_NO_ERROR)
+    uint32_t number = 0;
+    for (size_t i = 0; i < numberOfCharsToRead; i++)
     {
-        return result;
+        char c = digits[index + i];
+        if (c < '0' || c > '9')
+        {
+            ChipLogError(SetupPayload, "Failed decoding base10. Character was invalid %c", c);
+            return CHIP_ERROR_INVALID_INTEGER_VALUE;
+        }
+        number = number * 10 + static_cast<uint32_t>(c - '0');
     }
+    index += numberOfCharsToRead;
+    dest = number;
+    return CHIP_NO_ERROR;
+}
 
-    size_t stringOffset = 0;
-    uint32_t chunk1, chunk2, chunk3;
+// Validates the check digit at the end of decimalString, skipping its '-' separators, when there are too many digits to
+// copy them for Verhoeff10::ValidateCheckChar().  The permutation that Verhoeff's algorithm applies to a digit only
+// depends on its position from the right modulo 8, so groups of a multiple of 8 digits, from the right, can be checked
+// on their own and their products combined.
+bool ValidateCheckDigitOfLongString(CharSpan decimalString)
+{
+    constexpr size_t kGroupLength = 32;
+    char group[kGroupLength];
+    size_t groupLength = 0;
+    int product        = 0;
+    bool validChars    = true;
+    char checkChar     = 0;
+    bool haveCheckChar = false;
+
+    auto multiplyGroup = [&]() {
+        // The check digit of the group is the inverse of its product.
+        const char groupCheckChar = Verhoeff10::ComputeCheckChar(group + kGroupLength - groupLength, groupLength);
+        const int groupCheck      = Verhoeff10::CharToVal(groupCheckChar);
+        if (groupCheck < 0)
+        {
+            validChars = false;
+        }
+        else
+        {
+            const int groupProduct = Verhoeff::DihedralInvert(groupCheck, Verhoeff10::PolygonSize);
+            product                = Verhoeff::DihedralMultiply(product, groupProduct, Verhoeff10::PolygonSize);
+        }
+        groupLength = 0;
+    };
+
+    for (size_t i = decimalString.size(); i > 0; i--)
+    {
+        const char c = decimalString.data()[i - 1];
+        if (c == '-')
+        {
+            continue;
+        }
+        if (!haveCheckChar)
+        {
+            checkChar     = c;
+            haveCheckChar = true;
+            continue;
+        }
+        group[kGroupLength - ++groupLength] = c;
+        if (groupLength == kGroupLength)
+        {
+            multiplyGroup();
+        }
+    }
+    if (groupLength > 0)
+    {
+        multiplyGroup();
+    }
+
+    if (!validChars)
+    {
+        // As Verhoeff10::ComputeCheckChar() returns 0 for a string with an invalid character.
+        return checkChar == 0;
+    }
+    return checkChar == Verhoeff10::ValToChar(Verhoeff::DihedralInvert(product, Verhoeff10::PolygonSize));
+}
+
+} // namespace
+
+CHIP_ERROR ManualSetupPayloadParser::populatePayload(SetupPayload & outPayload)
+{
+    return ParseDecimalString(CharSpan(mDecimalStringRepresentation.data(), mDecimalStringRepresentation.length()), outPayload);
+}
+
+CHIP_ERROR ManualSetupPayloadParser::ParseDecimalString(CharSpan decimalString, PayloadContents & outPayload)
+{
+    // The digits of a long code and its check digit, without the '-' digit group separators.  Only the first ones of a
+    // longer string are kept: it is rejected for its length after its check digit and its first chunk are checked.
+    char digits[kManualSetupLongCodeCharLength + 1];
+    size_t digitCount = 0;
 
-    result = ReadDigitsFromDecimalString(representationWithoutCheckDigit, stringOffset, chunk1, kManualSetupCodeChunk1CharLength);
-    if (result != CHIP_NO_ERROR)
+    for (char c : decimalString)
     {
-        return result;
+        if (c == '-')
+        {
+            continue;
+        }
+        if (digitCount < sizeof(digits))
+        {
+            digits[digitCount] = c;
+        }
+        digitCount++;
     }
 
-    result = ReadDigitsFromDecimalString(representationWithoutCheckDigit, stringOffset, chunk2, kManualSetupCodeChunk2CharLength);
-    if (result != CHIP_NO_ERROR)
+    if (digitCount < 2)
     {
-        return result;
+        ChipLogError(SetupPayload, "Failed decoding base10. Input was empty. %u", static_cast<unsigned int>(digitCount));
+        return CHIP_ERROR_INVALID_STRING_LENGTH;
     }
 
-    result = ReadDigitsFromDecimalString(representationWithoutCheckDigit, stringOffset, chunk3, kManualSetupCodeChunk3CharLength);
-    if (result != CHIP_NO_ERROR)
+    const size_t length = digitCount - 1;
+    const bool valid    = (digitCount <= sizeof(digits)) ? Verhoeff10::ValidateCheckChar(digits[length], digits, length)
+                                                         : ValidateCheckDigitOfLongString(decimalString);
+    if (!valid)
     {
-        return result;
+        return CHIP_ERROR_INTEGRITY_CHECK_FAILED;
     }
 
+    size_t stringOffset = 0;
+    uint32_t chunk1, chunk2, chunk3;
+
+    ReturnErrorOnFailure(readDigits(digits, length, stringOffset, chunk1, kManualSetupCodeChunk1CharLength));
+    ReturnErrorOnFailure(readDigits(digits, length, stringOffset, chunk2, kManualSetupCodeChunk2CharLength));
+    ReturnErrorOnFailure(readDigits(digits, length, stringOffset, chunk3, kManualSetupCodeChunk3CharLength));
+
     // First digit of '8' or '9' would be invalid for v1 and would indicate new format (e.g. version 2)
     if (chunk1 == 8 || chunk1 == 9)
     {
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
 
-    bool isLongCode = ((chunk1 >> kManualSetupChunk1VidPidPresentBitPos) & 1) == 1;
-    result          = CheckCodeLengthValidity(representationWithoutCheckDigit, isLongCode);
-    if (result != CHIP_NO_ERROR)
+    bool isLongCode           = ((chunk1 >> kManualSetupChunk1VidPidPresentBitPos) & 1) == 1;
+    size_t expectedCharLength = isLongCode ? kManualSetupLongCodeCharLength : kManualSetupShortCodeCharLength;
+    if (length != expectedCharLength)
     {
-        return result;
+        ChipLogError(SetupPayload, "Failed decoding base10. Input length %u was not expected length %u",
+                     static_cast<unsigned int>(length), static_cast<unsigned int>(expectedCharLength));
+        return CHIP_ERROR_INVALID_STRING_LENGTH;
     }
 
     constexpr uint32_t kDiscriminatorMsbitsMask = (1 << kManualSetupChunk1DiscriminatorMsbitsLength) - 1;
@@ -162,20 +269,11 @@ CHIP_ERROR ManualSetupPayloadParser::populatePayload(SetupPayload & outPayload)
     if (isLongCode)
     {
         uint32_t vendorID;
-        result =
-            ReadDigitsFromDecimalString(representationWithoutCheckDigit, stringOffset, vendorID, kManualSetupVendorIdCharLength);
-        if (result != CHIP_NO_ERROR)
-        {
-            return result;
-        }
+        ReturnErrorOnFailure(readDigits(digits, length, stringOffset, vendorID, kManualSetupVendorIdCharLength));
 
         uint32_t productID;
-        result =
-            ReadDigitsFromDecimalString(representationWithoutCheckDigit, stringOffset, productID, kManualSetupProductIdCharLength);
-        if (result != CHIP_NO_ERROR)
-        {
-            return result;
-        }
+        ReturnErrorOnFailure(readDigits(digits, length, stringOffset, productID, kManualSetupProductIdCharLength));
+
         // Need to do dynamic checks, because we are reading 5 chars, so could
         // have 99,999 here or something.
         if (!CanCastTo<uint16_t>(vendorID))
@@ -195,7 +293,7 @@ CHIP_ERROR ManualSetupPayloadParser::populatePayload(SetupPayload & outPayload)
     static_assert(kManualSetupDiscriminatorFieldLengthInBits <= 8, "Won't fit in uint8_t");
     outPayload.discriminator.SetShortValue(static_cast<uint8_t>(discriminator));
 
-    return result;
+    return CHIP_NO_ERROR;
 }
 
 } // namespace chip
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
 #include <string>
 #include <utility>
 
@@ -53,6 +54,11 @@ public:
     }
     CHIP_ERROR populatePayload(SetupPayload & outPayload);
 
+    /**
+     * Parses a decimal manual setup code, which may contain '-' digit group separators, without allocating memory.
+     */
+    static CHIP_ERROR ParseDecimalString(CharSpan decimalString, PayloadContents & outPayload);
+
     static CHIP_ERROR CheckDecimalStringValidity(std::string decimalString, std::string & decimalStringWithoutCheckDigit);
     static CHIP_ERROR CheckCodeLengthValidity(const std::string & decimalString, bool isLongCode);
     static CHIP_ERROR ToNumber(const std::string & decimalString, uint32_t & dest);
@@ -38,29 +38,19 @@
 
 namespace chip {
 
-// Populate numberOfBits into dest from buf starting at startIndex
-static CHIP_ERROR readBits(std::vector<uint8_t> buf, size_t & index, uint64_t & dest, size_t numberOfBitsToRead)
+// Read numberOfBitsToRead bits from buf starting at bit index; the caller checks that they are within buf.
+static uint64_t readBits(const uint8_t * buf, size_t index, size_t numberOfBitsToRead)
 {
-    dest = 0;
-    if (index + numberOfBitsToRead > buf.size() * 8 || numberOfBitsToRead > sizeof(uint64_t) * 8)
-    {
-        ChipLogError(SetupPayload, "Error parsing QR code. startIndex %u numberOfBitsToLoad %u buf_len %u ",
-                     static_cast<unsigned int>(index), static_cast<unsigned int>(numberOfBitsToRead),
-                     static_cast<unsigned int>(buf.size()));
-        return CHIP_ERROR_INVALID_ARGUMENT;
-    }
+    const size_t firstByte = index / 8;
+    const size_t lastByte  = (index + numberOfBitsToRead - 1) / 8;
 
-    size_t currentIndex = index;
-    for (size_t bitsRead = 0; bitsRead < numberOfBitsToRead; bitsRead++)
+    // Load the bytes that hold the bits at once, least significant byte first.
+    uint64_t value = 0;
+    for (size_t i = lastByte + 1; i > firstByte; i--)
     {
-        if (buf[currentIndex / 8] & (1 << (currentIndex % 8)))
-        {
-            dest |= (1 << bitsRead);
-        }
-        currentIndex++;
+        value = (value << 8) | buf[i - 1];
     }
-    index += numberOfBitsToRead;
-    return CHIP_NO_ERROR;
+    return (value >> (index % 8)) & ((static_cast<uint64_t>(1) << numberOfBitsToRead) - 1);
 }
 
 static CHIP_ERROR openTLVContainer(TLV::ContiguousBufferTLVReader & reader, TLV::TLVType type, TLV::Tag tag,
@@ -274,9 +264,8 @@ CHIP_ERROR QRCodeSetupPayloadParser::populateTLV(SetupPayload & outPayload, cons
 
     for (size_t i = 0; i < tlvBytesLength; i++)
     {
-        uint64_t dest;
-        readBits(buf, index, dest, 8);
-        tlvArray[i] = static_cast<uint8_t>(dest);
+        tlvArray[i] = static_cast<uint8_t>(readBits(buf.data(), index, 8));
+        index += 8;
     }
 
     return parseTLVFields(outPayload, tlvArray.Get(), tlvBytesLength);
@@ -321,55 +310,79 @@ std::string QRCodeSetupPayloadParser::ExtractPayload(std::string inString)
     return chipSegment;
 }
 
-CHIP_ERROR QRCodeSetupPayloadParser::populatePayload(SetupPayload & outPayload)
+CHIP_ERROR QRCodeSetupPayloadParser::ParseFixedFields(ByteSpan buf, PayloadContents & outPayload)
 {
-    std::vector<uint8_t> buf;
-    size_t indexToReadFrom = 0;
-    uint64_t dest;
+    if (buf.size() < kTotalPayloadDataSizeInBytes)
+    {
+        ChipLogError(SetupPayload, "Error parsing QR code. buf_len %u is less than %u", static_cast<unsigned int>(buf.size()),
+                     static_cast<unsigned int>(kTotalPayloadDataSizeInBytes));
+        return CHIP_ERROR_INVALID_ARGUMENT;
+    }
 
-    std::string payload = ExtractPayload(mBase38Representation);
-    VerifyOrReturnError(payload.length() != 0, CHIP_ERROR_INVALID_ARGUMENT);
+    // Every field fits in the 64 bits that readBits loads, wherever it starts in a byte.
+    static_assert(kSetupPINCodeFieldLengthInBits + 7 <= 64, "Fields too large for readBits");
+    size_t index = 0;
+
+    const uint64_t version = readBits(buf.data(), index, kVersionFieldLengthInBits);
+    index += kVersionFieldLengthInBits;
+    const uint64_t vendorID = readBits(buf.data(), index, kVendorIDFieldLengthInBits);
+    index += kVendorIDFieldLengthInBits;
+    const uint64_t productID = readBits(buf.data(), index, kProductIDFieldLengthInBits);
+    index += kProductIDFieldLengthInBits;
+    const uint64_t commissioningFlow = readBits(buf.data(), index, kCommissioningFlowFieldLengthInBits);
+    index += kCommissioningFlowFieldLengthInBits;
+    const uint64_t rendezvousInformation = readBits(buf.data(), index, kRendezvousInfoFieldLengthInBits);
+    index += kRendezvousInfoFieldLengthInBits;
+    const uint64_t discriminator = readBits(buf.data(), index, kPayloadDiscriminatorFieldLengthInBits);
+    index += kPayloadDiscriminatorFieldLengthInBits;
+    const uint64_t setUpPINCode = readBits(buf.data(), index, kSetupPINCodeFieldLengthInBits);
+    index += kSetupPINCodeFieldLengthInBits;
+    const uint64_t padding = readBits(buf.data(), index, kPaddingFieldLengthInBits);
 
-    ReturnErrorOnFailure(base38Decode(payload, buf));
-
-    ReturnErrorOnFailure(readBits(buf, indexToReadFrom, dest, kVersionFieldLengthInBits));
     static_assert(kVersionFieldLengthInBits <= 8, "Won't fit in uint8_t");
-    outPayload.version = static_cast<uint8_t>(dest);
+    outPayload.version = static_cast<uint8_t>(version);
 
-    ReturnErrorOnFailure(readBits(buf, indexToReadFrom, dest, kVendorIDFieldLengthInBits));
     static_assert(kVendorIDFieldLengthInBits <= 16, "Won't fit in uint16_t");
-    outPayload.vendorID = static_cast<uint16_t>(dest);
+    outPayload.vendorID = static_cast<uint16_t>(vendorID);
 
-    ReturnErrorOnFailure(readBits(buf, indexToReadFrom, dest, kProductIDFieldLengthInBits));
     static_assert(kProductIDFieldLengthInBits <= 16, "Won't fit in uint16_t");
-    outPayload.productID = static_cast<uint16_t>(dest);
+    outPayload.productID = static_cast<uint16_t>(productID);
 
-    ReturnErrorOnFailure(readBits(buf, indexToReadFrom, dest, kCommissioningFlowFieldLengthInBits));
     static_assert(kCommissioningFlowFieldLengthInBits <= std::numeric_limits<std::underlying_type_t<CommissioningFlow>>::digits,
                   "Won't fit in CommissioningFlow");
-    outPayload.commissioningFlow = static_cast<CommissioningFlow>(dest);
+    outPayload.commissioningFlow = static_cast<CommissioningFlow>(commissioningFlow);
 
-    ReturnErrorOnFailure(readBits(buf, indexToReadFrom, dest, kRendezvousInfoFieldLengthInBits));
     static_assert(kRendezvousInfoFieldLengthInBits <= 8 * sizeof(RendezvousInformationFlag),
                   "Won't fit in RendezvousInformationFlags");
     outPayload.rendezvousInformation.SetValue(
-        RendezvousInformationFlags().SetRaw(static_cast<std::underlying_type_t<RendezvousInformationFlag>>(dest)));
+        RendezvousInformationFlags().SetRaw(static_cast<std::underlying_type_t<RendezvousInformationFlag>>(rendezvousInformation)));
 
-    ReturnErrorOnFailure(readBits(buf, indexToReadFrom, dest, kPayloadDiscriminatorFieldLengthInBits));
     static_assert(kPayloadDiscriminatorFieldLengthInBits <= 16, "Won't fit in uint16_t");
-    outPayload.discriminator.SetLongValue(static_cast<uint16_t>(dest));
+    outPayload.discriminator.SetLongValue(static_cast<uint16_t>(discriminator));
 
-    ReturnErrorOnFailure(readBits(buf, indexToReadFrom, dest, kSetupPINCodeFieldLengthInBits));
     static_assert(kSetupPINCodeFieldLengthInBits <= 32, "Won't fit in uint32_t");
-    outPayload.setUpPINCode = static_cast<uint32_t>(dest);
+    outPayload.setUpPINCode = static_cast<uint32_t>(setUpPINCode);
 
-    ReturnErrorOnFailure(readBits(buf, indexToReadFrom, dest, kPaddingFieldLengthInBits));
-    if (dest != 0)
+    if (padding != 0)
     {
-        ChipLogError(SetupPayload, "Payload padding bits are not all 0: 0x%x", static_cast<unsigned>(dest));
+        ChipLogError(SetupPayload, "Payload padding bits are not all 0: 0x%x", static_cast<unsigned>(padding));
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
 
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR QRCodeSetupPayloadParser::populatePayload(SetupPayload & outPayload)
+{
+    std::vector<uint8_t> buf;
+
+    std::string payload = ExtractPayload(mBase38Representation);
+    VerifyOrReturnError(payload.length() != 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReturnErrorOnFailure(base38Decode(payload, buf));
+    ReturnErrorOnFailure(ParseFixedFields(ByteSpan(buf.data(), buf.size()), outPayload));
+
+    size_t indexToReadFrom = kTotalPayloadDataSizeInBits;
     return populateTLV(outPayload, buf, indexToReadFrom);
 }
 
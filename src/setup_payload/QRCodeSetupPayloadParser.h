@@ -27,6 +27,7 @@
 
 #include <lib/core/CHIPError.h>
 #include <lib/core/TLV.h>
+#include <lib/support/Span.h>
 
 #include <string>
 #include <utility>
@@ -47,6 +48,12 @@ public:
     CHIP_ERROR populatePayload(SetupPayload & outPayload);
     static std::string ExtractPayload(std::string inString);
 
+    /**
+     * Parses the fixed-size fields at the start of a decoded QR code payload, that is everything but the optional
+     * TLV data, without allocating memory.
+     */
+    static CHIP_ERROR ParseFixedFields(ByteSpan buf, PayloadContents & outPayload);
+
 private:
     CHIP_ERROR retrieveOptionalInfos(SetupPayload & outPayload, TLV::ContiguousBufferTLVReader & reader);
     CHIP_ERROR populateTLV(SetupPayload & outPayload, const std::vector<uint8_t> & buf, size_t & index);
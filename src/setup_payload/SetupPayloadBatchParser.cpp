@@ -0,0 +1,181 @@
+/**
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a parser of many QR codes or manual setup codes
+ *      at once.
+ */
+
+#include "SetupPayloadBatchParser.h"
+#include "Base38Decode.h"
+#include "ManualSetupPayloadParser.h"
+#include "QRCodeSetupPayloadParser.h"
+
+#include <lib/core/TLVReader.h>
+#include <lib/support/CodeUtils.h>
+
+#include <string.h>
+
+namespace chip {
+
+namespace {
+
+// The largest QR code, of version 40, holds 4296 alphanumeric characters.  Base38 data of that length decodes to 3
+// bytes per chunk of 5 characters, and at most 2 bytes for the remaining ones.
+constexpr size_t kMaxQRCodeCharLength = 4296;
+constexpr size_t kMaxQRCodeDataLength = kMaxQRCodeCharLength / 5 * 3 + 2;
+
+// Finds the first segment between '%' delimiters that starts with kQRCodePrefix, like
+// QRCodeSetupPayloadParser::ExtractPayload() does, and returns it without the prefix.
+bool FindQRCodePayload(CharSpan code, CharSpan & outPayload)
+{
+    const size_t prefixLength = strlen(kQRCodePrefix);
+    size_t segmentStart       = 0;
+
+    while (segmentStart <= code.size())
+    {
+        size_t segmentEnd = segmentStart;
+        while (segmentEnd < code.size() && code.data()[segmentEnd] != '%')
+        {
+            segmentEnd++;
+        }
+
+        CharSpan segment = code.SubSpan(segmentStart, segmentEnd - segmentStart);
+        if (segment.size() > prefixLength && memcmp(segment.data(), kQRCodePrefix, prefixLength) == 0)
+        {
+            outPayload = segment.SubSpan(prefixLength);
+            return true;
+        }
+        segmentStart = segmentEnd + 1;
+    }
+
+    return false;
+}
+
+// Checks the optional data with the rules of QRCodeSetupPayloadParser::parseTLVFields(), without keeping its elements.
+CHIP_ERROR CheckOptionalData(ByteSpan optionalData)
+{
+    TLV::ContiguousBufferTLVReader rootReader;
+    rootReader.Init(optionalData);
+    ReturnErrorOnFailure(rootReader.Next());
+    VerifyOrReturnError(rootReader.GetType() == TLV::kTLVType_Structure, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(rootReader.GetTag() == TLV::AnonymousTag(), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(rootReader.GetLength() == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    TLV::ContiguousBufferTLVReader reader;
+    ReturnErrorOnFailure(rootReader.OpenContainer(reader));
+    ReturnErrorOnFailure(reader.Next());
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    while (err == CHIP_NO_ERROR)
+    {
+        // Elements of other types are skipped.
+        const TLV::TLVType type = reader.GetType();
+        if (type == TLV::kTLVType_UTF8String || type == TLV::kTLVType_SignedInteger || type == TLV::kTLVType_UnsignedInteger)
+        {
+            const TLV::Tag tag = reader.GetTag();
+            VerifyOrReturnError(TLV::IsContextTag(tag), CHIP_ERROR_INVALID_TLV_TAG);
+            const uint8_t tagNumber = static_cast<uint8_t>(TLV::TagNumFromTag(tag));
+
+            if (type == TLV::kTLVType_UTF8String)
+            {
+                CharSpan value;
+                ReturnErrorOnFailure(reader.GetStringView(value));
+            }
+            else if (SetupPayload::IsVendorTag(tagNumber))
+            {
+                int32_t value;
+                ReturnErrorOnFailure(reader.Get(value));
+            }
+            else
+            {
+                // The serial number is the only numeric common element.
+                VerifyOrReturnError(tagNumber == kSerialNumberTag, CHIP_ERROR_INVALID_ARGUMENT);
+                uint32_t value;
+                ReturnErrorOnFailure(reader.Get(value));
+            }
+        }
+        err = reader.Next();
+    }
+
+    return (err == CHIP_END_OF_TLV) ? CHIP_NO_ERROR : err;
+}
+
+} // namespace
+
+CHIP_ERROR SetupPayloadBatchParser::ParseQRCode(CharSpan code, PayloadContents & outPayload, bool & outHasOptionalData)
+{
+    CharSpan base38;
+    VerifyOrReturnError(FindQRCodePayload(code, base38), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(base38.size() <= kMaxQRCodeCharLength, CHIP_ERROR_INVALID_STRING_LENGTH);
+
+    uint8_t data[kMaxQRCodeDataLength];
+    MutableByteSpan dataSpan(data);
+    ReturnErrorOnFailure(base38Decode(base38, dataSpan));
+    ReturnErrorOnFailure(QRCodeSetupPayloadParser::ParseFixedFields(dataSpan, outPayload));
+
+    // The optional data starts at the first byte after the fixed fields, as they are a whole number of bytes.
+    static_assert(kTotalPayloadDataSizeInBits % 8 == 0, "Optional data is not byte aligned");
+    const ByteSpan optionalData = dataSpan.SubSpan(kTotalPayloadDataSizeInBytes);
+    if (!optionalData.empty())
+    {
+        ReturnErrorOnFailure(CheckOptionalData(optionalData));
+    }
+    outHasOptionalData = !optionalData.empty();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SetupPayloadBatchParser::ParseQRCodes(Span<const CharSpan> codes, Span<Record> outRecords, size_t & outValidCount)
+{
+    VerifyOrReturnError(outRecords.size() >= codes.size(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    outValidCount = 0;
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+        Record & record = outRecords[i];
+        record          = Record();
+        record.error    = ParseQRCode(codes[i], record.payload, record.hasOptionalData);
+        if (record.error == CHIP_NO_ERROR)
+        {
+            outValidCount++;
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SetupPayloadBatchParser::ParseManualCodes(Span<const CharSpan> codes, Span<Record> outRecords, size_t & outValidCount)
+{
+    VerifyOrReturnError(outRecords.size() >= codes.size(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    outValidCount = 0;
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+        Record & record = outRecords[i];
+        record          = Record();
+        record.error    = ManualSetupPayloadParser::ParseDecimalString(codes[i], record.payload);
+        if (record.error == CHIP_NO_ERROR)
+        {
+            outValidCount++;
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+} // namespace chip
@@ -0,0 +1,82 @@
+/**
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file describes a parser of many QR codes or manual setup codes
+ *      at once, e.g. for bulk imports of onboarding payloads.
+ */
+
+#pragma once
+
+#include "SetupPayload.h"
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+
+#include <stddef.h>
+
+namespace chip {
+
+/**
+ * @class SetupPayloadBatchParser
+ * Converts arrays of QR codes or manual setup codes into records provided by the caller, without allocating memory.
+ *
+ * Codes are parsed with the same rules and errors as QRCodeSetupPayloadParser and ManualSetupPayloadParser.  The
+ * optional TLV data of QR codes is checked but not kept, since its elements would need to be allocated: records of
+ * such codes are flagged, so that the caller can parse them again with QRCodeSetupPayloadParser when it needs the
+ * optional data.  QR codes longer than the largest QR code symbol, of 4296 characters, are rejected with
+ * CHIP_ERROR_INVALID_STRING_LENGTH.
+ */
+class SetupPayloadBatchParser
+{
+public:
+    struct Record
+    {
+        PayloadContents payload;
+        // Whether the code was parsed; payload is only meaningful if it was.
+        CHIP_ERROR error = CHIP_NO_ERROR;
+        // QR codes only: the code has optional TLV data after the fixed fields, which was checked but not kept.
+        bool hasOptionalData = false;
+    };
+
+    /**
+     * Parses QR codes into the matching entries of outRecords.  As for QRCodeSetupPayloadParser, a code is the first
+     * '%'-separated segment that starts with the "MT:" prefix.
+     *
+     * @param[out] outValidCount  The number of codes that were parsed successfully.
+     *
+     * @retval CHIP_ERROR_BUFFER_TOO_SMALL if there are fewer records than codes; no code is parsed then.
+     */
+    static CHIP_ERROR ParseQRCodes(Span<const CharSpan> codes, Span<Record> outRecords, size_t & outValidCount);
+
+    /**
+     * Parses manual setup codes into the matching entries of outRecords.
+     *
+     * @param[out] outValidCount  The number of codes that were parsed successfully.
+     *
+     * @retval CHIP_ERROR_BUFFER_TOO_SMALL if there are fewer records than codes; no code is parsed then.
+     */
+    static CHIP_ERROR ParseManualCodes(Span<const CharSpan> codes, Span<Record> outRecords, size_t & outValidCount);
+
+    /**
+     * Parses a single QR code without allocating memory, see ParseQRCodes().
+     */
+    static CHIP_ERROR ParseQRCode(CharSpan code, PayloadContents & outPayload, bool & outHasOptionalData);
+};
+
+} // namespace chip
@@ -0,0 +1,458 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/verhoeff/Verhoeff.h>
+#include <setup_payload/ManualSetupPayloadGenerator.h>
+#include <setup_payload/ManualSetupPayloadParser.h>
+#include <setup_payload/SetupPayloadBatchParser.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace chip;
+
+namespace {
+
+using Record = SetupPayloadBatchParser::Record;
+
+class TestSetupPayloadBatchParser : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+};
+
+// Payloads of a production run: the same product, with a different discriminator and passcode per device.
+PayloadContents GetDevicePayload(size_t index, CommissioningFlow commissioningFlow)
+{
+    PayloadContents payload;
+    payload.vendorID          = 0xFFF1;
+    payload.productID         = static_cast<uint16_t>(0x8000 + index % 16);
+    payload.commissioningFlow = commissioningFlow;
+    payload.rendezvousInformation.SetValue(RendezvousInformationFlag::kBLE);
+    payload.discriminator.SetLongValue(static_cast<uint16_t>(index % 4096));
+    payload.setUpPINCode = static_cast<uint32_t>(20202021 + index * 7);
+    return payload;
+}
+
+std::vector<std::string> GenerateQRCodes(size_t count)
+{
+    std::vector<std::string> codes;
+    for (size_t i = 0; i < count; i++)
+    {
+        std::string code;
+        SetupPayload payload;
+        static_cast<PayloadContents &>(payload) = GetDevicePayload(i, CommissioningFlow::kStandard);
+        EXPECT_EQ(QRCodeSetupPayloadGenerator(payload).payloadBase38RepresentationWithAutoTLVBuffer(code), CHIP_NO_ERROR);
+        codes.push_back(code);
+    }
+    return codes;
+}
+
+std::vector<std::string> GenerateManualCodes(size_t count)
+{
+    std::vector<std::string> codes;
+    for (size_t i = 0; i < count; i++)
+    {
+        std::string code;
+        CommissioningFlow commissioningFlow = (i % 2 == 0) ? CommissioningFlow::kStandard : CommissioningFlow::kCustom;
+        EXPECT_EQ(ManualSetupPayloadGenerator(GetDevicePayload(i, commissioningFlow)).payloadDecimalStringRepresentation(code),
+                  CHIP_NO_ERROR);
+        codes.push_back(code);
+    }
+    return codes;
+}
+
+std::vector<CharSpan> ToSpans(const std::vector<std::string> & codes)
+{
+    std::vector<CharSpan> spans;
+    for (const auto & code : codes)
+    {
+        spans.push_back(CharSpan(code.data(), code.length()));
+    }
+    return spans;
+}
+
+struct ExpectedError
+{
+    std::string code;
+    CHIP_ERROR error;
+};
+
+std::vector<Record> ParseQRCodes(const std::vector<std::string> & codes, size_t & validCount)
+{
+    std::vector<CharSpan> spans = ToSpans(codes);
+    std::vector<Record> records(codes.size());
+    EXPECT_EQ(SetupPayloadBatchParser::ParseQRCodes(Span<const CharSpan>(spans.data(), spans.size()),
+                                                    Span<Record>(records.data(), records.size()), validCount),
+              CHIP_NO_ERROR);
+    return records;
+}
+
+std::vector<Record> ParseManualCodes(const std::vector<std::string> & codes, size_t & validCount)
+{
+    std::vector<CharSpan> spans = ToSpans(codes);
+    std::vector<Record> records(codes.size());
+    EXPECT_EQ(SetupPayloadBatchParser::ParseManualCodes(Span<const CharSpan>(spans.data(), spans.size()),
+                                                        Span<Record>(records.data(), records.size()), validCount),
+              CHIP_NO_ERROR);
+    return records;
+}
+
+std::string WithCheckDigit(std::string decimalString)
+{
+    decimalString += Verhoeff10::ComputeCheckChar(decimalString.c_str());
+    return decimalString;
+}
+
+std::string WithWrongCheckDigit(std::string decimalString)
+{
+    decimalString += static_cast<char>('0' + (Verhoeff10::CharToVal(Verhoeff10::ComputeCheckChar(decimalString.c_str())) + 1) % 10);
+    return decimalString;
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestParseQRCodes)
+{
+    constexpr size_t kDeviceCount = 100;
+    std::vector<std::string> codes = GenerateQRCodes(kDeviceCount);
+
+    std::string codeWithOptionalData;
+    QRCodeSetupPayloadGenerator generator(GetDefaultPayloadWithOptionalDefaults());
+    EXPECT_EQ(generator.payloadBase38RepresentationWithAutoTLVBuffer(codeWithOptionalData), CHIP_NO_ERROR);
+    codes.push_back(codeWithOptionalData);
+    codes.push_back(std::string("Z%") + kDefaultPayloadQRCode + "%ABC");
+
+    size_t validCount            = 0;
+    std::vector<Record> records  = ParseQRCodes(codes, validCount);
+    const PayloadContents & defaultPayload = GetDefaultPayload();
+    EXPECT_EQ(validCount, codes.size());
+
+    for (size_t i = 0; i < kDeviceCount; i++)
+    {
+        EXPECT_EQ(records[i].error, CHIP_NO_ERROR);
+        EXPECT_TRUE(records[i].payload == GetDevicePayload(i, CommissioningFlow::kStandard));
+        EXPECT_FALSE(records[i].hasOptionalData);
+    }
+
+    // The optional data is flagged, and still parsed by QRCodeSetupPayloadParser.
+    EXPECT_TRUE(records[kDeviceCount].payload == defaultPayload);
+    EXPECT_TRUE(records[kDeviceCount].hasOptionalData);
+    SetupPayload payload;
+    EXPECT_EQ(QRCodeSetupPayloadParser(codeWithOptionalData).populatePayload(payload), CHIP_NO_ERROR);
+    EXPECT_TRUE(payload == GetDefaultPayloadWithOptionalDefaults());
+
+    EXPECT_TRUE(records[kDeviceCount + 1].payload == defaultPayload);
+    EXPECT_FALSE(records[kDeviceCount + 1].hasOptionalData);
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestParseInvalidQRCodes)
+{
+    const std::vector<ExpectedError> expectedErrors = {
+        { "", CHIP_ERROR_INVALID_ARGUMENT },
+        { "MT:", CHIP_ERROR_INVALID_ARGUMENT },
+        { "M5L90MP500K64J00000", CHIP_ERROR_INVALID_ARGUMENT },           // no prefix
+        { "MT:ABC", CHIP_ERROR_INVALID_STRING_LENGTH },                   // invalid length
+        { "MT:M5L90MP500K64J0000", CHIP_ERROR_INVALID_STRING_LENGTH },    // invalid length
+        { "MT:M5L90MP500K64J0000a", CHIP_ERROR_INVALID_INTEGER_VALUE },   // invalid character
+        { "MT:M5L90MP500", CHIP_ERROR_INVALID_ARGUMENT },                 // too short for the fixed fields
+        { "MT:M5L90MP500K64J00000QLS18", CHIP_ERROR_INVALID_ARGUMENT },   // optional data chunk out of range
+        { "MT:M5L90MP500K64J00000QLS1.", CHIP_ERROR_INVALID_ARGUMENT },   // optional data chunk out of range
+        { "MT:M5L90MP500K64J00000[LS18", CHIP_ERROR_INVALID_INTEGER_VALUE }, // invalid character in optional data
+    };
+
+    std::vector<std::string> codes;
+    for (const auto & expected : expectedErrors)
+    {
+        codes.push_back(expected.code);
+    }
+
+    size_t validCount           = 1;
+    std::vector<Record> records = ParseQRCodes(codes, validCount);
+    EXPECT_EQ(validCount, 0u);
+
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+        EXPECT_EQ(records[i].error, expectedErrors[i].error);
+
+        // Both parsers reject the same codes.
+        SetupPayload payload;
+        EXPECT_EQ(QRCodeSetupPayloadParser(codes[i]).populatePayload(payload), expectedErrors[i].error);
+    }
+}
+
+// Returns a QR code with the fixed fields of code and the given optional data.
+std::string WithOptionalData(const std::string & code, std::vector<uint8_t> optionalData)
+{
+    std::vector<uint8_t> data;
+    EXPECT_EQ(base38Decode(code.substr(strlen(kQRCodePrefix)), data), CHIP_NO_ERROR);
+    data.resize(kTotalPayloadDataSizeInBytes);
+    data.insert(data.end(), optionalData.begin(), optionalData.end());
+
+    std::vector<char> encoded(base38EncodedLength(data.size()) + 1);
+    MutableCharSpan encodedSpan(encoded.data(), encoded.size());
+    EXPECT_EQ(base38Encode(ByteSpan(data.data(), data.size()), encodedSpan), CHIP_NO_ERROR);
+    return kQRCodePrefix + std::string(encodedSpan.data(), encodedSpan.size());
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestParseQRCodesOptionalData)
+{
+    const std::string code = GenerateQRCodes(1)[0];
+
+    // Context-tagged elements in an anonymous structure, as QRCodeSetupPayloadGenerator writes them.
+    const std::vector<std::vector<uint8_t>> validData = {
+        { 0x15, 0x2C, 0x80, 0x02, 'a', 'b', 0x18 },                                // vendor string
+        { 0x15, 0x20, 0x81, 0xFE, 0x18 },                                          // vendor int32
+        { 0x15, 0x26, 0x00, 0x01, 0x02, 0x03, 0x04, 0x18 },                        // numeric serial number
+        { 0x15, 0x2C, 0x00, 0x01, '1', 0x35, 0x01, 0x24, 0x02, 0x05, 0x18, 0x18 }, // other types are skipped
+    };
+    const std::vector<std::vector<uint8_t>> invalidData = {
+        { 0x04, 0x01 },                                     // not a structure
+        { 0x35, 0x01, 0x18 },                               // tagged structure
+        { 0x15 },                                           // unterminated structure
+        { 0x15, 0x18 },                                     // empty structure
+        { 0x15, 0x2C, 0x80, 0x05, 'a', 'b', 0x18 },         // truncated string
+        { 0x15, 0x04, 0x05, 0x18 },                         // anonymous element
+        { 0x15, 0x24, 0x01, 0x05, 0x18 },                   // numeric common element other than the serial number
+        { 0x15, 0x26, 0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0x18 }, // vendor element out of int32 range
+        { 0x15, 0x20, 0x00, 0xFF, 0x18 },                   // negative serial number
+    };
+
+    std::vector<std::string> codes;
+    for (const auto & data : validData)
+    {
+        codes.push_back(WithOptionalData(code, data));
+    }
+    for (const auto & data : invalidData)
+    {
+        codes.push_back(WithOptionalData(code, data));
+    }
+
+    size_t validCount           = 0;
+    std::vector<Record> records = ParseQRCodes(codes, validCount);
+    EXPECT_EQ(validCount, validData.size());
+
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+        // Both parsers reject the same optional data, with the same errors.
+        SetupPayload payload;
+        EXPECT_EQ(records[i].error, QRCodeSetupPayloadParser(codes[i]).populatePayload(payload));
+        if (i < validData.size())
+        {
+            EXPECT_EQ(records[i].error, CHIP_NO_ERROR);
+            EXPECT_TRUE(records[i].hasOptionalData);
+        }
+        else
+        {
+            EXPECT_NE(records[i].error, CHIP_NO_ERROR);
+        }
+    }
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestParseTooLongQRCode)
+{
+    size_t validCount = 0;
+    std::vector<Record> records =
+        ParseQRCodes({ WithOptionalData(GenerateQRCodes(1)[0], std::vector<uint8_t>(3000, 0)) }, validCount);
+    EXPECT_EQ(validCount, 0u);
+    EXPECT_EQ(records[0].error, CHIP_ERROR_INVALID_STRING_LENGTH);
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestParseManualCodes)
+{
+    constexpr size_t kDeviceCount = 100;
+    std::vector<std::string> codes = GenerateManualCodes(kDeviceCount);
+    // Dashes may separate digit groups; they are not part of the check digit.
+    codes.push_back(std::string("6361-0875-3545-3671-4526") + Verhoeff10::ComputeCheckChar("63610875354536714526"));
+
+    size_t validCount           = 0;
+    std::vector<Record> records = ParseManualCodes(codes, validCount);
+    EXPECT_EQ(validCount, codes.size());
+
+    for (size_t i = 0; i < kDeviceCount; i++)
+    {
+        // Manual codes only hold the short discriminator, and the vendor and product IDs of the custom flow.
+        PayloadContents device = GetDevicePayload(i, (i % 2 == 0) ? CommissioningFlow::kStandard : CommissioningFlow::kCustom);
+        PayloadContents expected;
+        expected.commissioningFlow = device.commissioningFlow;
+        expected.discriminator.SetShortValue(device.discriminator.GetShortValue());
+        expected.setUpPINCode = device.setUpPINCode;
+        if (device.commissioningFlow == CommissioningFlow::kCustom)
+        {
+            expected.vendorID  = device.vendorID;
+            expected.productID = device.productID;
+        }
+
+        EXPECT_EQ(records[i].error, CHIP_NO_ERROR);
+        EXPECT_TRUE(records[i].payload == expected);
+        EXPECT_FALSE(records[i].hasOptionalData);
+    }
+
+    const PayloadContents & dashed = records[kDeviceCount].payload;
+    EXPECT_EQ(dashed.setUpPINCode, 123456780u);
+    EXPECT_EQ(dashed.discriminator.GetShortValue(), 0xa);
+    EXPECT_EQ(dashed.vendorID, 45367);
+    EXPECT_EQ(dashed.productID, 14526);
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestParseInvalidManualCodes)
+{
+    // Longer than the digits of a long code and its check digit.
+    const std::string tooLong = "123456789123456785671234";
+
+    const std::vector<ExpectedError> expectedErrors = {
+        { WithCheckDigit(""), CHIP_ERROR_INVALID_STRING_LENGTH },
+        { WithCheckDigit("24184.2196"), CHIP_ERROR_INVALID_INTEGER_VALUE },           // invalid character
+        { WithCheckDigit("2456"), CHIP_ERROR_INVALID_STRING_LENGTH },                 // too short
+        { WithCheckDigit("123456789123456785671"), CHIP_ERROR_INVALID_STRING_LENGTH }, // too long for long code
+        { WithCheckDigit("12749875380"), CHIP_ERROR_INVALID_STRING_LENGTH },          // too long for short code
+        { WithCheckDigit("23456789123456785610"), CHIP_ERROR_INVALID_STRING_LENGTH }, // short code bit, long code length
+        { WithCheckDigit("2327680000"), CHIP_ERROR_INVALID_ARGUMENT },                // no pin code (= 0)
+        { WithCheckDigit("8327680000"), CHIP_ERROR_INVALID_ARGUMENT },                // version 2
+        { WithCheckDigit("63610875359999914526"), CHIP_ERROR_INVALID_INTEGER_VALUE }, // vendor ID out of range
+        { "02684354589", CHIP_ERROR_INTEGRITY_CHECK_FAILED },                         // wrong check digit
+        { WithCheckDigit(tooLong), CHIP_ERROR_INVALID_STRING_LENGTH },
+        { "1234-5678-9123-4567-8567-1234" + WithCheckDigit(tooLong).substr(tooLong.size()),
+          CHIP_ERROR_INVALID_STRING_LENGTH },                                         // with separators
+        { WithCheckDigit("8" + tooLong.substr(1)), CHIP_ERROR_INVALID_ARGUMENT },     // version 2
+        { WithWrongCheckDigit(tooLong), CHIP_ERROR_INTEGRITY_CHECK_FAILED },          // wrong check digit
+        { "123456789123456785.712345", CHIP_ERROR_INTEGRITY_CHECK_FAILED },           // invalid character
+    };
+
+    std::vector<std::string> codes;
+    for (const auto & expected : expectedErrors)
+    {
+        codes.push_back(expected.code);
+    }
+
+    size_t validCount           = 1;
+    std::vector<Record> records = ParseManualCodes(codes, validCount);
+    EXPECT_EQ(validCount, 0u);
+
+    for (size_t i = 0; i < codes.size(); i++)
+    {
+        EXPECT_EQ(records[i].error, expectedErrors[i].error);
+    }
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestCheckDigitOfLongManualCodes)
+{
+    // Strings too long for a manual code are still rejected for a wrong check digit first, whatever their length.
+    std::string digits = "1";
+    for (size_t length = 1; length < 100; length++)
+    {
+        const std::string valid = WithCheckDigit(digits);
+        for (char checkChar = '0'; checkChar <= '9'; checkChar++)
+        {
+            std::string code = digits + checkChar;
+            code.insert(length / 2, "-");
+
+            PayloadContents payload;
+            CHIP_ERROR error = ManualSetupPayloadParser::ParseDecimalString(CharSpan(code.data(), code.size()), payload);
+            EXPECT_EQ(error == CHIP_ERROR_INTEGRITY_CHECK_FAILED, checkChar != valid.back()) << code;
+        }
+        digits += static_cast<char>('0' + (length * 7) % 10);
+    }
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestTooFewRecords)
+{
+    std::vector<std::string> codes = GenerateManualCodes(2);
+    std::vector<CharSpan> spans    = ToSpans(codes);
+    Record record;
+    size_t validCount = 0;
+
+    EXPECT_EQ(SetupPayloadBatchParser::ParseManualCodes(Span<const CharSpan>(spans.data(), spans.size()),
+                                                        Span<Record>(&record, 1), validCount),
+              CHIP_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_EQ(SetupPayloadBatchParser::ParseQRCodes(Span<const CharSpan>(spans.data(), spans.size()), Span<Record>(&record, 1),
+                                                    validCount),
+              CHIP_ERROR_BUFFER_TOO_SMALL);
+}
+
+TEST_F(TestSetupPayloadBatchParser, TestBase38DecodeIntoBuffer)
+{
+    const char encoded[] = "KKHF3W2S013OPM3EJX11";
+    uint8_t buffer[12];
+
+    EXPECT_EQ(base38DecodedLength(strlen(encoded)), sizeof(buffer));
+    EXPECT_EQ(base38DecodedLength(7), 4u);
+    EXPECT_EQ(base38DecodedLength(4), 2u);
+    EXPECT_EQ(base38DecodedLength(2), 1u);
+    EXPECT_EQ(base38DecodedLength(0), 0u);
+
+    MutableByteSpan decoded(buffer);
+    EXPECT_EQ(base38Decode(CharSpan::fromCharString(encoded), decoded), CHIP_NO_ERROR);
+    EXPECT_TRUE(decoded.data_equal(ByteSpan(reinterpret_cast<const uint8_t *>("Hello World!"), 12)));
+
+    MutableByteSpan tooSmall(buffer, sizeof(buffer) - 1);
+    EXPECT_EQ(base38Decode(CharSpan::fromCharString(encoded), tooSmall), CHIP_ERROR_BUFFER_TOO_SMALL);
+}
+
+// Not a pass/fail test, so disabled by default: reports how many codes per second are parsed one at a time, and with the
+// batch parser.
+TEST_F(TestSetupPayloadBatchParser, DISABLED_BenchmarkThroughput)
+{
+    constexpr size_t kCodeCount = 10000;
+
+    std::vector<std::string> qrCodes     = GenerateQRCodes(kCodeCount);
+    std::vector<std::string> manualCodes = GenerateManualCodes(kCodeCount);
+    std::vector<Record> records(kCodeCount);
+
+    for (bool isQRCode : { true, false })
+    {
+        const std::vector<std::string> & codes = isQRCode ? qrCodes : manualCodes;
+        std::vector<CharSpan> spans            = ToSpans(codes);
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto & code : codes)
+        {
+            SetupPayload payload;
+            CHIP_ERROR err = isQRCode ? QRCodeSetupPayloadParser(code).populatePayload(payload)
+                                      : ManualSetupPayloadParser(code).populatePayload(payload);
+            EXPECT_EQ(err, CHIP_NO_ERROR);
+        }
+        auto singleElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        size_t validCount = 0;
+        start             = std::chrono::steady_clock::now();
+        if (isQRCode)
+        {
+            SetupPayloadBatchParser::ParseQRCodes(Span<const CharSpan>(spans.data(), spans.size()),
+                                                  Span<Record>(records.data(), records.size()), validCount);
+        }
+        else
+        {
+            SetupPayloadBatchParser::ParseManualCodes(Span<const CharSpan>(spans.data(), spans.size()),
+                                                      Span<Record>(records.data(), records.size()), validCount);
+        }
+        auto batchElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        EXPECT_EQ(validCount, kCodeCount);
+
+        printf("%s codes: %llu per second one at a time, %llu per second in a batch\n", isQRCode ? "QR" : "Manual",
+               static_cast<unsigned long long>(kCodeCount * 1000000 / std::max<int64_t>(singleElapsed.count(), 1)),
+               static_cast<unsigned long long>(kCodeCount * 1000000 / std::max<int64_t>(batchElapsed.count(), 1)));
+    }
+}
+
+} // namespace
@@ -39,6 +39,15 @@ constexpr MetricKey kMetricDeviceCommissionerCommission = "core_dcm_commission_d
 
 constexpr MetricKey kMetricDeviceCommissionerCommissionStage = "core_dcm_commission_stage";
 
+// Time an attestation verification waited for a slot of the commissioning work pool
+constexpr MetricKey kMetricCommissioningAttestationQueueWait = "core_dcm_attestation_queue_wait";
+
+// Time a NOC chain generation waited for a slot of the commissioning work pool
+constexpr MetricKey kMetricCommissioningNOCQueueWait = "core_dcm_noc_queue_wait";
+
+// Time to commission a device by the commissioning orchestrator
+constexpr MetricKey kMetricCommissioningOrchestratorDevice = "core_dcm_orchestrator_device";
+
 // Setup Code Pairer
 constexpr MetricKey kMetricSetupCodePairerPairDevice = "core_setup_code_pairer_pair_dev";
 
@@ -38,72 +38,18 @@ CHIP_ERROR GroupPeerTable::FindOrAddPeer(FabricIndex fabricIndex, NodeId nodeId,
 
     for (auto & groupFabric : mGroupFabrics)
     {
+        // Fabrics are kept compacted, so the first empty slot means that the fabric is new: use that slot for it.
         if (groupFabric.mFabricIndex == kUndefinedFabricIndex)
         {
-            // Already iterated through all known fabricIndex
-            // Add the new peer to save some processing time
             groupFabric.mFabricIndex = fabricIndex;
-            if (isControl)
-            {
-                groupFabric.mControlGroupSenders[0].mNodeId = nodeId;
-                counter                                     = &(groupFabric.mControlGroupSenders[0].msgCounter);
-                groupFabric.mControlPeerCount++;
-            }
-            else
-            {
-                groupFabric.mDataGroupSenders[0].mNodeId = nodeId;
-                counter                                  = &(groupFabric.mDataGroupSenders[0].msgCounter);
-                groupFabric.mDataPeerCount++;
-            }
-            return CHIP_NO_ERROR;
         }
 
         if (fabricIndex == groupFabric.mFabricIndex)
         {
-            if (isControl)
-            {
-                for (auto & node : groupFabric.mControlGroupSenders)
-                {
-                    if (node.mNodeId == kUndefinedNodeId)
-                    {
-                        // Already iterated through all known NodeIds
-                        // Add the new peer to save some processing time
-                        node.mNodeId = nodeId;
-                        counter      = &(node.msgCounter);
-                        groupFabric.mControlPeerCount++;
-                        return CHIP_NO_ERROR;
-                    }
-
-                    if (node.mNodeId == nodeId)
-                    {
-                        counter = &(node.msgCounter);
-                        return CHIP_NO_ERROR;
-                    }
-                }
-            }
-            else
-            {
-                for (auto & node : groupFabric.mDataGroupSenders)
-                {
-                    if (node.mNodeId == kUndefinedNodeId)
-                    {
-                        // Already iterated through all known NodeIds
-                        // Add the new peer to save some processing time
-                        node.mNodeId = nodeId;
-                        counter      = &(node.msgCounter);
-                        groupFabric.mDataPeerCount++;
-                        return CHIP_NO_ERROR;
-                    }
-
-                    if (node.mNodeId == nodeId)
-                    {
-                        counter = &(node.msgCounter);
-                        return CHIP_NO_ERROR;
-                    }
-                }
-            }
-            // Exceeded the Max number of Group peers
-            return CHIP_ERROR_TOO_MANY_PEER_NODES;
+            System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+            counter                      = isControl ? groupFabric.mControlGroupSenders.FindOrAdd(nodeId, now)
+                                                     : groupFabric.mDataGroupSenders.FindOrAdd(nodeId, now);
+            return (counter != nullptr) ? CHIP_NO_ERROR : CHIP_ERROR_TOO_MANY_PEER_NODES;
         }
     }
 
@@ -114,9 +60,6 @@ CHIP_ERROR GroupPeerTable::FindOrAddPeer(FabricIndex fabricIndex, NodeId nodeId,
 // Used in case of MCSP failure
 CHIP_ERROR GroupPeerTable::RemovePeer(FabricIndex fabricIndex, NodeId nodeId, bool isControl)
 {
-    CHIP_ERROR err    = CHIP_ERROR_NOT_FOUND;
-    uint32_t fabricIt = CHIP_CONFIG_MAX_FABRICS;
-
     if (fabricIndex == kUndefinedFabricIndex || nodeId == kUndefinedNodeId)
     {
         return CHIP_ERROR_INVALID_ARGUMENT;
@@ -124,41 +67,29 @@ CHIP_ERROR GroupPeerTable::RemovePeer(FabricIndex fabricIndex, NodeId nodeId, bo
 
     for (uint32_t it = 0; it < CHIP_CONFIG_MAX_FABRICS; it++)
     {
-        if (fabricIndex == mGroupFabrics[it].mFabricIndex)
+        GroupFabric & groupFabric = mGroupFabrics[it];
+        if (fabricIndex != groupFabric.mFabricIndex)
+        {
+            continue;
+        }
+
+        bool removed =
+            isControl ? groupFabric.mControlGroupSenders.Remove(nodeId) : groupFabric.mDataGroupSenders.Remove(nodeId);
+        if (!removed)
         {
-            if (isControl)
-            {
-                if (RemoveSpecificPeer(mGroupFabrics[it].mControlGroupSenders, nodeId, CHIP_CONFIG_MAX_GROUP_CONTROL_PEERS))
-                {
-                    fabricIt = it;
-                    mGroupFabrics[it].mControlPeerCount--;
-                    err = CHIP_NO_ERROR;
-                }
-            }
-            else
-            {
-                if (RemoveSpecificPeer(mGroupFabrics[it].mDataGroupSenders, nodeId, CHIP_CONFIG_MAX_GROUP_DATA_PEERS))
-                {
-                    fabricIt = it;
-                    mGroupFabrics[it].mDataPeerCount--;
-                    err = CHIP_NO_ERROR;
-                }
-            }
             break;
         }
-    }
 
-    // Remove Fabric entry from PeerTable if empty
-    if (fabricIt < CHIP_CONFIG_MAX_FABRICS)
-    {
-        if (mGroupFabrics[fabricIt].mDataPeerCount == 0 && mGroupFabrics[fabricIt].mControlPeerCount == 0)
+        // Remove Fabric entry from PeerTable if empty
+        if (groupFabric.mDataGroupSenders.Count() == 0 && groupFabric.mControlGroupSenders.Count() == 0)
         {
-            RemoveAndCompactFabric(fabricIt);
+            RemoveAndCompactFabric(it);
         }
+        return CHIP_NO_ERROR;
     }
 
     // Cannot find Peer to remove
-    return err;
+    return CHIP_ERROR_NOT_FOUND;
 }
 
 CHIP_ERROR GroupPeerTable::FabricRemoved(FabricIndex fabricIndex)
@@ -183,56 +114,6 @@ CHIP_ERROR GroupPeerTable::FabricRemoved(FabricIndex fabricIndex)
     return err;
 }
 
-bool GroupPeerTable::RemoveSpecificPeer(GroupSender * list, NodeId nodeId, uint32_t size)
-{
-    bool removed = false;
-    for (uint32_t nodeIt = 0; nodeIt < size; nodeIt++)
-    {
-        if (list[nodeIt].mNodeId == nodeId)
-        {
-            list[nodeIt].mNodeId = kUndefinedNodeId;
-            list[nodeIt].msgCounter.Reset();
-            removed = true;
-            break;
-        }
-    }
-
-    if (removed)
-    {
-        CompactPeers(list, size);
-    }
-
-    return removed;
-}
-
-void GroupPeerTable::CompactPeers(GroupSender * list, uint32_t size)
-{
-    if (list == nullptr || size == 0)
-    {
-        return;
-    }
-
-    for (uint32_t peerIndex = 0; peerIndex < size; peerIndex++)
-    {
-        if (list[peerIndex].mNodeId != kUndefinedNodeId)
-        {
-            continue;
-        }
-
-        for (uint32_t i = (size - 1); i > peerIndex; i--)
-        {
-            if (list[i].mNodeId != kUndefinedNodeId)
-            {
-                // Logic works since all buffer are static
-                // move it up front
-                new (&list[peerIndex]) GroupSender(list[i]);
-                new (&list[i]) GroupSender();
-                break;
-            }
-        }
-    }
-}
-
 void GroupPeerTable::RemoveAndCompactFabric(uint32_t tableIndex)
 {
     if (tableIndex >= CHIP_CONFIG_MAX_FABRICS)
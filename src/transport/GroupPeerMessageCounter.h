@@ -23,12 +23,14 @@
 
 #include <array>
 #include <bitset>
+#include <new>
 
 #include <lib/core/CHIPPersistentStorageDelegate.h>
 #include <lib/core/DataModelTypes.h>
 #include <lib/core/NodeId.h>
 #include <lib/core/PeerId.h>
 #include <lib/support/Span.h>
+#include <system/SystemClock.h>
 #include <transport/PeerMessageCounter.h>
 
 #define GROUP_MSG_COUNTER_MIN_INCREMENT 1000
@@ -43,19 +45,176 @@ public:
     PeerMessageCounter msgCounter;
 };
 
+/**
+ * The senders of group messages of one kind (data or control) within a fabric.
+ *
+ * Senders are stored densely in insertion order and indexed by node id in an open-addressed hash table, so that the
+ * lookup done for every received group message does not depend on the number of senders.  When the list is full, adding
+ * a sender evicts the least recently used one, provided it has been idle for CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS;
+ * its message counter is forgotten, exactly as if it had been removed.  Otherwise the new sender is refused.
+ */
+template <size_t kCapacity>
+class GroupSenderList
+{
+public:
+    static_assert(kCapacity > 0, "A group sender list needs some room");
+    static_assert(kCapacity < UINT16_MAX / 2, "Group sender list too large");
+
+    GroupSenderList()
+    {
+        for (auto & bucket : mBuckets)
+        {
+            bucket = kNoEntry;
+        }
+    }
+
+    size_t Count() const { return mCount; }
+    const GroupSender & At(size_t index) const { return mSenders[index]; }
+
+    static constexpr System::Clock::Milliseconds32 kMinIdleBeforeEviction =
+        System::Clock::Milliseconds32(CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS);
+
+    /**
+     * Returns the message counter of nodeId, adding the node if it is unknown, or nullptr if the list is full and no sender
+     * has been idle long enough to be evicted.  The returned counter stays valid until the next call to FindOrAdd or Remove.
+     *
+     * @param[in] now  The current monotonic time, recorded as the last time nodeId was heard from.
+     */
+    PeerMessageCounter * FindOrAdd(NodeId nodeId, System::Clock::Timestamp now)
+    {
+        size_t bucket = FindBucket(nodeId);
+        if (mBuckets[bucket] == kNoEntry)
+        {
+            if (mCount == kCapacity)
+            {
+                uint16_t oldest = LeastRecentlyUsed();
+                if (now < mLastSeen[oldest] + kMinIdleBeforeEviction)
+                {
+                    return nullptr;
+                }
+                RemoveAt(oldest);
+                bucket = FindBucket(nodeId);
+            }
+            mBuckets[bucket]         = mCount;
+            mSenders[mCount].mNodeId = nodeId;
+            mCount++;
+        }
+
+        uint16_t index   = mBuckets[bucket];
+        mLastSeen[index] = now;
+        return &mSenders[index].msgCounter;
+    }
+
+    bool Remove(NodeId nodeId)
+    {
+        uint16_t index = mBuckets[FindBucket(nodeId)];
+        if (index == kNoEntry)
+        {
+            return false;
+        }
+        RemoveAt(index);
+        return true;
+    }
+
+private:
+    // Keeps the hash table at most half full, so that probing sequences stay short.
+    static constexpr size_t kBucketCount = 2 * kCapacity + 1;
+    static constexpr uint16_t kNoEntry   = UINT16_MAX;
+
+    static size_t HashNodeId(NodeId nodeId)
+    {
+        return static_cast<size_t>(((nodeId ^ (nodeId >> 32)) * UINT64_C(0x9E3779B97F4A7C15)) >> 32) % kBucketCount;
+    }
+
+    // Returns the bucket of nodeId, or the empty bucket ending its probing sequence if it is not in the list.
+    size_t FindBucket(NodeId nodeId) const
+    {
+        size_t bucket = HashNodeId(nodeId);
+        while (mBuckets[bucket] != kNoEntry && mSenders[mBuckets[bucket]].mNodeId != nodeId)
+        {
+            bucket = (bucket + 1) % kBucketCount;
+        }
+        return bucket;
+    }
+
+    uint16_t LeastRecentlyUsed() const
+    {
+        uint16_t oldest = 0;
+        for (uint16_t i = 1; i < mCount; i++)
+        {
+            if (mLastSeen[i] < mLastSeen[oldest])
+            {
+                oldest = i;
+            }
+        }
+        return oldest;
+    }
+
+    void RemoveAt(uint16_t index)
+    {
+        EraseBucket(FindBucket(mSenders[index].mNodeId));
+
+        // Move the last sender into the hole, so that senders stay dense.
+        uint16_t last = static_cast<uint16_t>(mCount - 1);
+        if (index != last)
+        {
+            mBuckets[FindBucket(mSenders[last].mNodeId)] = index;
+            new (&mSenders[index]) GroupSender(mSenders[last]);
+            mLastSeen[index] = mLastSeen[last];
+        }
+        new (&mSenders[last]) GroupSender();
+        mCount = last;
+    }
+
+    // Backward-shift deletion: pulls the following entries of the probing sequence back, so that no tombstone is needed.
+    void EraseBucket(size_t hole)
+    {
+        size_t bucket = hole;
+        while (true)
+        {
+            bucket = (bucket + 1) % kBucketCount;
+            if (mBuckets[bucket] == kNoEntry)
+            {
+                break;
+            }
+
+            size_t home = HashNodeId(mSenders[mBuckets[bucket]].mNodeId);
+            // The entry may fill the hole unless its home bucket lies cyclically in (hole, bucket].
+            bool homeBetween = (hole < bucket) ? (hole < home && home <= bucket) : (hole < home || home <= bucket);
+            if (!homeBetween)
+            {
+                mBuckets[hole] = mBuckets[bucket];
+                hole           = bucket;
+            }
+        }
+        mBuckets[hole] = kNoEntry;
+    }
+
+    GroupSender mSenders[kCapacity];
+    System::Clock::Timestamp mLastSeen[kCapacity] = {};
+    uint16_t mBuckets[kBucketCount];
+    uint16_t mCount = 0;
+};
+
 class GroupFabric
 {
 public:
-    FabricIndex mFabricIndex  = kUndefinedFabricIndex;
-    uint8_t mControlPeerCount = 0;
-    uint8_t mDataPeerCount    = 0;
-    GroupSender mDataGroupSenders[CHIP_CONFIG_MAX_GROUP_DATA_PEERS];
-    GroupSender mControlGroupSenders[CHIP_CONFIG_MAX_GROUP_CONTROL_PEERS];
+    FabricIndex mFabricIndex = kUndefinedFabricIndex;
+    GroupSenderList<CHIP_CONFIG_MAX_GROUP_DATA_PEERS> mDataGroupSenders;
+    GroupSenderList<CHIP_CONFIG_MAX_GROUP_CONTROL_PEERS> mControlGroupSenders;
 };
 
 class GroupPeerTable
 {
 public:
+    /**
+     * Finds the message counter of a group sender, adding the sender if needed.  A fabric keeps up to
+     * CHIP_CONFIG_MAX_GROUP_DATA_PEERS data senders and CHIP_CONFIG_MAX_GROUP_CONTROL_PEERS control senders, evicting the
+     * least recently used one when full if it has been idle for CHIP_CONFIG_GROUP_PEER_MIN_IDLE_BEFORE_EVICTION_MS.
+     *
+     * @retval CHIP_ERROR_TOO_MANY_PEER_NODES  If the fabric is new and CHIP_CONFIG_MAX_FABRICS fabrics already have senders,
+     *                                         or if the sender is new and every sender of the fabric was heard from recently.
+     */
     CHIP_ERROR FindOrAddPeer(FabricIndex fabricIndex, NodeId nodeId, bool isControl,
                              chip::Transport::PeerMessageCounter *& counter);
 
@@ -66,8 +225,6 @@ public:
 
     // Protected for Unit Tests inheritance
 protected:
-    bool RemoveSpecificPeer(GroupSender * list, NodeId nodeId, uint32_t size);
-    void CompactPeers(GroupSender * list, uint32_t size);
     void RemoveAndCompactFabric(uint32_t tableIndex);
 
     GroupFabric mGroupFabrics[CHIP_CONFIG_MAX_FABRICS];
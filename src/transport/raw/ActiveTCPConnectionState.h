@@ -27,6 +27,7 @@
 #include <inet/InetInterface.h>
 #include <inet/TCPEndPoint.h>
 #include <lib/core/CHIPCore.h>
+#include <system/SystemClock.h>
 #include <transport/raw/PeerAddress.h>
 #include <transport/raw/TCPConfig.h>
 
@@ -54,19 +55,24 @@ struct ActiveTCPConnectionState
 
     void Init(Inet::TCPEndPoint * endPoint, const PeerAddress & peerAddr)
     {
-        mEndPoint = endPoint;
-        mPeerAddr = peerAddr;
-        mReceived = nullptr;
-        mAppState = nullptr;
+        mEndPoint           = endPoint;
+        mPeerAddr           = peerAddr;
+        mReceived           = nullptr;
+        mPendingMessage     = nullptr;
+        mPendingMessageSize = 0;
+        mAppState           = nullptr;
+        mLastActivityTime   = System::SystemClock().GetMonotonicTimestamp();
     }
 
     void Free()
     {
         mEndPoint->Free();
-        mPeerAddr = PeerAddress::Uninitialized();
-        mEndPoint = nullptr;
-        mReceived = nullptr;
-        mAppState = nullptr;
+        mPeerAddr           = PeerAddress::Uninitialized();
+        mEndPoint           = nullptr;
+        mReceived           = nullptr;
+        mPendingMessage     = nullptr;
+        mPendingMessageSize = 0;
+        mAppState           = nullptr;
     }
 
     bool InUse() const { return mEndPoint != nullptr; }
@@ -76,7 +82,7 @@ struct ActiveTCPConnectionState
     bool IsConnecting() const { return (mEndPoint != nullptr && mConnectionState == TCPState::kConnecting); }
 
     // Associated endpoint.
-    Inet::TCPEndPoint * mEndPoint;
+    Inet::TCPEndPoint * mEndPoint = nullptr;
 
     // Peer Node Address
     PeerAddress mPeerAddr;
@@ -84,8 +90,16 @@ struct ActiveTCPConnectionState
     // Buffers received but not yet consumed.
     System::PacketBufferHandle mReceived;
 
+    // Message whose length prefix has been consumed but whose body has not been fully received yet,
+    // and the total size of that message body.
+    System::PacketBufferHandle mPendingMessage;
+    size_t mPendingMessageSize = 0;
+
+    // Time of the last data sent or received on this connection, used for idle reaping.
+    System::Clock::Timestamp mLastActivityTime = System::Clock::kZero;
+
     // Current state of the connection
-    TCPState mConnectionState;
+    TCPState mConnectionState = TCPState::kNotReady;
 
     // A pointer to an application-specific state object. It should
     // represent an object that is at a layer above the SessionManager. The
@@ -26,12 +26,14 @@
 #include <transport/raw/TCP.h>
 
 #include <lib/core/CHIPEncoding.h>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <transport/raw/MessageHeader.h>
 
 #include <inttypes.h>
 #include <limits>
+#include <string.h>
 
 namespace chip {
 namespace Transport {
@@ -62,18 +64,32 @@ TCPBase::~TCPBase()
         mListenSocket = nullptr;
     }
 
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(HandleIdleConnectionTimer, this);
+    }
+
     CloseActiveConnections();
+
+    ConnectionBlock * block = mActiveConnections.mNext;
+    while (block != nullptr)
+    {
+        ConnectionBlock * next = block->mNext;
+        Platform::Delete(static_cast<HeapConnectionBlock *>(block));
+        block = next;
+    }
+    mActiveConnections.mNext = nullptr;
 }
 
 void TCPBase::CloseActiveConnections()
 {
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (mActiveConnections[i].InUse())
+    ForEachConnection([&](ActiveTCPConnectionState * connection) {
+        if (connection->InUse())
         {
-            CloseConnectionInternal(&mActiveConnections[i], CHIP_NO_ERROR, SuppressCallback::Yes);
+            CloseConnectionInternal(connection, CHIP_NO_ERROR, SuppressCallback::Yes);
         }
-    }
+        return Loop::Continue;
+    });
 }
 
 CHIP_ERROR TCPBase::Init(TcpListenParameters & params)
@@ -98,11 +114,13 @@ CHIP_ERROR TCPBase::Init(TcpListenParameters & params)
     mListenSocket->OnAcceptError        = HandleAcceptError;
 
     mEndpointType = params.GetAddressType();
+    mSystemLayer  = &params.GetEndPointManager()->SystemLayer();
 
     err = mListenSocket->Listen(kListenBacklogSize);
     SuccessOrExit(err);
 
     mState = TCPState::kInitialized;
+    StartIdleConnectionTimer();
 
 exit:
     if (err != CHIP_NO_ERROR)
@@ -125,20 +143,91 @@ void TCPBase::Close()
         mListenSocket->Free();
         mListenSocket = nullptr;
     }
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(HandleIdleConnectionTimer, this);
+    }
     mState = TCPState::kNotReady;
 }
 
 ActiveTCPConnectionState * TCPBase::AllocateConnection()
 {
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
+    ConnectionBlock * lastBlock = &mActiveConnections;
+
+    for (ConnectionBlock * block = &mActiveConnections; block != nullptr; block = block->mNext)
     {
-        if (!mActiveConnections[i].InUse())
+        lastBlock = block;
+        for (size_t i = 0; i < block->mSize; i++)
         {
-            return &mActiveConnections[i];
+            if (!block->mConnections[i].InUse())
+            {
+                return &block->mConnections[i];
+            }
         }
     }
 
-    return nullptr;
+    // All connection states are in use: grow the pool if the configured limit allows it.
+    VerifyOrReturnValue(mConnectionPoolSize < mMaxActiveConnections, nullptr);
+
+    HeapConnectionBlock * newBlock = Platform::New<HeapConnectionBlock>();
+    VerifyOrReturnValue(newBlock != nullptr, nullptr);
+    for (auto & connection : newBlock->mStorage)
+    {
+        connection.Init(nullptr, PeerAddress::Uninitialized());
+    }
+
+    lastBlock->mNext = newBlock;
+    mConnectionPoolSize += newBlock->mSize;
+    ChipLogDetail(Inet, "TCP connection pool grown to %u connections", static_cast<unsigned>(mConnectionPoolSize));
+
+    return &newBlock->mConnections[0];
+}
+
+void TCPBase::SetIdleConnectionTimeout(uint32_t idleTimeoutMsecs)
+{
+    mIdleConnectionTimeout = idleTimeoutMsecs;
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(HandleIdleConnectionTimer, this);
+    }
+    StartIdleConnectionTimer();
+}
+
+void TCPBase::StartIdleConnectionTimer()
+{
+    VerifyOrReturn(mState == TCPState::kInitialized && mIdleConnectionTimeout != 0 && mSystemLayer != nullptr);
+
+    CHIP_ERROR err =
+        mSystemLayer->StartTimer(System::Clock::Milliseconds32(mIdleConnectionTimeout), HandleIdleConnectionTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Inet, "Failed to start TCP idle connection timer: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+void TCPBase::HandleIdleConnectionTimer(System::Layer *, void * appState)
+{
+    TCPBase * tcp = reinterpret_cast<TCPBase *>(appState);
+    tcp->CloseIdleConnections();
+    tcp->StartIdleConnectionTimer();
+}
+
+void TCPBase::CloseIdleConnections()
+{
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    const System::Clock::Milliseconds32 timeout(mIdleConnectionTimeout);
+
+    ForEachConnection([&](ActiveTCPConnectionState * connection) {
+        if (connection->IsConnected() && (now - connection->mLastActivityTime) >= timeout)
+        {
+            char addrStr[Transport::PeerAddress::kMaxToStringSize];
+            connection->mPeerAddr.ToString(addrStr);
+            ChipLogProgress(Inet, "Closing idle connection with peer %s.", addrStr);
+
+            CloseConnectionInternal(connection, CHIP_ERROR_TIMEOUT, SuppressCallback::No);
+        }
+        return Loop::Continue;
+    });
 }
 
 // Find an ActiveTCPConnectionState corresponding to a peer address
@@ -149,36 +238,40 @@ ActiveTCPConnectionState * TCPBase::FindActiveConnection(const PeerAddress & add
         return nullptr;
     }
 
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (!mActiveConnections[i].IsConnected())
+    ActiveTCPConnectionState * found = nullptr;
+    ForEachConnection([&](ActiveTCPConnectionState * connection) {
+        if (!connection->IsConnected())
         {
-            continue;
+            return Loop::Continue;
         }
         Inet::IPAddress addr;
         uint16_t port;
-        mActiveConnections[i].mEndPoint->GetPeerInfo(&addr, &port);
+        connection->mEndPoint->GetPeerInfo(&addr, &port);
 
         if ((addr == address.GetIPAddress()) && (port == address.GetPort()))
         {
-            return &mActiveConnections[i];
+            found = connection;
+            return Loop::Break;
         }
-    }
+        return Loop::Continue;
+    });
 
-    return nullptr;
+    return found;
 }
 
 // Find the ActiveTCPConnectionState for a given TCPEndPoint
 ActiveTCPConnectionState * TCPBase::FindActiveConnection(const Inet::TCPEndPoint * endPoint)
 {
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (mActiveConnections[i].mEndPoint == endPoint && mActiveConnections[i].IsConnected())
+    ActiveTCPConnectionState * found = nullptr;
+    ForEachConnection([&](ActiveTCPConnectionState * connection) {
+        if (connection->mEndPoint == endPoint && connection->IsConnected())
         {
-            return &mActiveConnections[i];
+            found = connection;
+            return Loop::Break;
         }
-    }
-    return nullptr;
+        return Loop::Continue;
+    });
+    return found;
 }
 
 ActiveTCPConnectionState * TCPBase::FindInUseConnection(const Inet::TCPEndPoint * endPoint)
@@ -188,14 +281,16 @@ ActiveTCPConnectionState * TCPBase::FindInUseConnection(const Inet::TCPEndPoint
         return nullptr;
     }
 
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (mActiveConnections[i].mEndPoint == endPoint)
+    ActiveTCPConnectionState * found = nullptr;
+    ForEachConnection([&](ActiveTCPConnectionState * connection) {
+        if (connection->mEndPoint == endPoint)
         {
-            return &mActiveConnections[i];
+            found = connection;
+            return Loop::Break;
         }
-    }
-    return nullptr;
+        return Loop::Continue;
+    });
+    return found;
 }
 
 CHIP_ERROR TCPBase::SendMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf)
@@ -223,6 +318,7 @@ CHIP_ERROR TCPBase::SendMessage(const Transport::PeerAddress & address, System::
 
     if (connection != nullptr)
     {
+        connection->mLastActivityTime = System::SystemClock().GetMonotonicTimestamp();
         return connection->mEndPoint->Send(std::move(msgBuf));
     }
 
@@ -293,7 +389,7 @@ CHIP_ERROR TCPBase::SendAfterConnect(const PeerAddress & addr, System::PacketBuf
     }
 
     // Ensures sufficient active connections size exist
-    VerifyOrReturnError(mUsedEndPointCount < mActiveConnectionsSize, CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(mUsedEndPointCount < mMaxActiveConnections, CHIP_ERROR_NO_MEMORY);
 
     Transport::ActiveTCPConnectionState * peerConnState = nullptr;
     ReturnErrorOnFailure(StartConnect(addr, nullptr, &peerConnState));
@@ -313,10 +409,18 @@ CHIP_ERROR TCPBase::ProcessReceivedBuffer(Inet::TCPEndPoint * endPoint, const Pe
 {
     ActiveTCPConnectionState * state = FindActiveConnection(endPoint);
     VerifyOrReturnError(state != nullptr, CHIP_ERROR_INTERNAL);
+    state->mLastActivityTime = System::SystemClock().GetMonotonicTimestamp();
     state->mReceived.AddToEnd(std::move(buffer));
 
     while (!state->mReceived.IsNull())
     {
+        if (!state->mPendingMessage.IsNull())
+        {
+            // The body of a message whose length has already been consumed is still being received.
+            ReturnErrorOnFailure(ContinuePendingMessage(peerAddress, state));
+            continue;
+        }
+
         uint8_t messageSizeBuf[kPacketSizeBytes];
         CHIP_ERROR err = state->mReceived->Read(messageSizeBuf);
         if (err == CHIP_ERROR_BUFFER_TOO_SMALL)
@@ -337,12 +441,6 @@ CHIP_ERROR TCPBase::ProcessReceivedBuffer(Inet::TCPEndPoint * endPoint, const Pe
 
             return CHIP_ERROR_MESSAGE_TOO_LONG;
         }
-        // The subtraction will not underflow because we successfully read kPacketSizeBytes.
-        if (messageSize > (state->mReceived->TotalLength() - kPacketSizeBytes))
-        {
-            // We have not yet received the complete message.
-            return CHIP_NO_ERROR;
-        }
         state->mReceived.Consume(kPacketSizeBytes);
         ReturnErrorOnFailure(ProcessSingleMessage(peerAddress, state, messageSize));
     }
@@ -352,24 +450,25 @@ CHIP_ERROR TCPBase::ProcessReceivedBuffer(Inet::TCPEndPoint * endPoint, const Pe
 
 CHIP_ERROR TCPBase::ProcessSingleMessage(const PeerAddress & peerAddress, ActiveTCPConnectionState * state, size_t messageSize)
 {
-    // We enter with `state->mReceived` containing at least one full message, perhaps in a chain.
-    // `state->mReceived->Start()` currently points to the message data.
-    // On exit, `state->mReceived` will have had `messageSize` bytes consumed, no matter what.
+    // We enter with `state->mReceived` containing the start of a message (or nothing, if only the length has
+    // been received so far). `state->mReceived->Start()` currently points to the message data.
+    // On exit, either the whole message has been consumed from `state->mReceived` and passed upstream, or
+    // everything received so far has been moved into `state->mPendingMessage`.
     System::PacketBufferHandle message;
     MessageTransportContext msgContext;
     msgContext.conn = state;
 
-    if (state->mReceived->DataLength() == messageSize)
+    if (!state->mReceived.IsNull() && state->mReceived->DataLength() == messageSize)
     {
         // In this case, the head packet buffer contains exactly the message.
         // This is common because typical messages fit in a network packet, and are delivered as such.
         // Peel off the head to pass upstream, which effectively consumes it from `state->mReceived`.
         message = state->mReceived.PopHead();
     }
-    else
+    else if (!state->mReceived.IsNull() && state->mReceived->DataLength() > messageSize)
     {
-        // The message is either longer or shorter than the head buffer.
-        // In either case, copy the message to a fresh linear buffer to pass upstream. We always copy, rather than provide
+        // The head buffer also holds the start of the next message.
+        // Copy the message to a fresh linear buffer to pass upstream. We always copy, rather than provide
         // a shared reference to the current buffer, in case upper layers manipulate the buffer in ways that would affect
         // our use, e.g. chaining it elsewhere or reusing space beyond the current message.
         message = System::PacketBufferHandle::New(messageSize, 0);
@@ -382,6 +481,55 @@ CHIP_ERROR TCPBase::ProcessSingleMessage(const PeerAddress & peerAddress, Active
         ReturnErrorOnFailure(err);
         message->SetDataLength(messageSize);
     }
+    else
+    {
+        // The message is longer than the head buffer. Upper layers need the message in a single linear buffer, so
+        // allocate it once at its final size and append the body to it as buffers arrive, rather than holding every
+        // received buffer until the whole message is available and copying it then.
+        state->mPendingMessage = System::PacketBufferHandle::New(messageSize, 0);
+        if (state->mPendingMessage.IsNull())
+        {
+            state->mReceived.Consume(messageSize);
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        state->mPendingMessageSize = messageSize;
+        return ContinuePendingMessage(peerAddress, state);
+    }
+
+    HandleMessageReceived(peerAddress, std::move(message), &msgContext);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR TCPBase::ContinuePendingMessage(const PeerAddress & peerAddress, ActiveTCPConnectionState * state)
+{
+    System::PacketBufferHandle & pending = state->mPendingMessage;
+
+    while (pending->DataLength() < state->mPendingMessageSize && !state->mReceived.IsNull())
+    {
+        if (state->mReceived->DataLength() == 0)
+        {
+            state->mReceived.FreeHead();
+            continue;
+        }
+
+        size_t toCopy = std::min(state->mPendingMessageSize - pending->DataLength(), state->mReceived->DataLength());
+        memcpy(pending->Start() + pending->DataLength(), state->mReceived->Start(), toCopy);
+        pending->SetDataLength(pending->DataLength() + toCopy);
+        state->mReceived.Consume(toCopy);
+    }
+
+    if (pending->DataLength() < state->mPendingMessageSize)
+    {
+        // We have not yet received the complete message.
+        return CHIP_NO_ERROR;
+    }
+
+    // Take the message out of the connection state before passing it upstream, since the delegate need not take
+    // ownership of it, and a message left pending would be delivered again.
+    System::PacketBufferHandle message = std::move(pending);
+    MessageTransportContext msgContext;
+    msgContext.conn            = state;
+    state->mPendingMessageSize = 0;
 
     HandleMessageReceived(peerAddress, std::move(message), &msgContext);
     return CHIP_NO_ERROR;
@@ -478,7 +626,8 @@ void TCPBase::HandleTCPEndPointConnectComplete(Inet::TCPEndPoint * endPoint, CHI
         VerifyOrDie(activeConnection != nullptr);
 
         // Set to Connected state
-        activeConnection->mConnectionState = TCPState::kConnected;
+        activeConnection->mConnectionState  = TCPState::kConnected;
+        activeConnection->mLastActivityTime = System::SystemClock().GetMonotonicTimestamp();
 
         // Disable TCP Nagle buffering by setting TCP_NODELAY socket option to true.
         // This is to expedite transmission of payload data and not rely on the
@@ -557,10 +706,13 @@ void TCPBase::HandleIncomingConnection(Inet::TCPEndPoint * listenEndPoint, Inet:
     endPoint->GetInterfaceId(&interfaceId);
     PeerAddress addr = PeerAddress::TCP(ipAddress, port, interfaceId);
 
-    if (tcp->mUsedEndPointCount < tcp->mActiveConnectionsSize)
+    if (tcp->mUsedEndPointCount < tcp->mMaxActiveConnections)
     {
         activeConnection = tcp->AllocateConnection();
+    }
 
+    if (activeConnection != nullptr)
+    {
         endPoint->mAppState          = listenEndPoint->mAppState;
         endPoint->OnDataReceived     = HandleTCPEndPointDataReceived;
         endPoint->OnDataSent         = nullptr;
@@ -603,7 +755,7 @@ CHIP_ERROR TCPBase::TCPConnect(const PeerAddress & address, Transport::AppTCPCon
     // Verify that PeerAddress AddressType is TCP
     VerifyOrReturnError(address.GetTransportType() == Transport::Type::kTcp, CHIP_ERROR_INVALID_ARGUMENT);
 
-    VerifyOrReturnError(mUsedEndPointCount < mActiveConnectionsSize, CHIP_ERROR_NO_MEMORY);
+    VerifyOrReturnError(mUsedEndPointCount < mMaxActiveConnections, CHIP_ERROR_NO_MEMORY);
 
     char addrStr[Transport::PeerAddress::kMaxToStringSize];
     address.ToString(addrStr);
@@ -618,26 +770,25 @@ void TCPBase::TCPDisconnect(const PeerAddress & address)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
     // Closes an existing connection
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (mActiveConnections[i].IsConnected())
+    ForEachConnection([&](ActiveTCPConnectionState * connection) {
+        if (connection->IsConnected())
         {
             Inet::IPAddress ipAddress;
             uint16_t port;
             Inet::InterfaceId interfaceId;
 
-            err = mActiveConnections[i].mEndPoint->GetPeerInfo(&ipAddress, &port);
+            err = connection->mEndPoint->GetPeerInfo(&ipAddress, &port);
             if (err != CHIP_NO_ERROR)
             {
                 ChipLogError(Inet, "TCPDisconnect: GetPeerInfo error: %" CHIP_ERROR_FORMAT, err.Format());
-                return;
+                return Loop::Break;
             }
 
-            err = mActiveConnections[i].mEndPoint->GetInterfaceId(&interfaceId);
+            err = connection->mEndPoint->GetInterfaceId(&interfaceId);
             if (err != CHIP_NO_ERROR)
             {
                 ChipLogError(Inet, "TCPDisconnect: GetInterfaceId error: %" CHIP_ERROR_FORMAT, err.Format());
-                return;
+                return Loop::Break;
             }
             // if (address == PeerAddress::TCP(ipAddress, port, interfaceId))
             if (ipAddress == address.GetIPAddress() && port == address.GetPort())
@@ -649,10 +800,11 @@ void TCPBase::TCPDisconnect(const PeerAddress & address)
                 // NOTE: this leaves the socket in TIME_WAIT.
                 // Calling Abort() would clean it since SO_LINGER would be set to 0,
                 // however this seems not to be useful.
-                CloseConnectionInternal(&mActiveConnections[i], CHIP_NO_ERROR, SuppressCallback::Yes);
+                CloseConnectionInternal(connection, CHIP_NO_ERROR, SuppressCallback::Yes);
             }
         }
-    }
+        return Loop::Continue;
+    });
 }
 
 void TCPBase::TCPDisconnect(Transport::ActiveTCPConnectionState * conn, bool shouldAbort)
@@ -679,15 +831,9 @@ void TCPBase::TCPDisconnect(Transport::ActiveTCPConnectionState * conn, bool sho
 
 bool TCPBase::HasActiveConnections() const
 {
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (mActiveConnections[i].IsConnected())
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return ForEachConnection([](const ActiveTCPConnectionState * connection) {
+               return connection->IsConnected() ? Loop::Break : Loop::Continue;
+           }) == Loop::Break;
 }
 
 } // namespace Transport
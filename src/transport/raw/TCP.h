@@ -34,6 +34,8 @@
 #include <lib/core/CHIPCore.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/PoolWrapper.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
 #include <transport/raw/ActiveTCPConnectionState.h>
 #include <transport/raw/Base.h>
 #include <transport/raw/TCPConfig.h>
@@ -119,7 +121,8 @@ protected:
 public:
     using PendingPacketPoolType = PoolInterface<PendingPacket, const PeerAddress &, System::PacketBufferHandle &&>;
     TCPBase(ActiveTCPConnectionState * activeConnectionsBuffer, size_t bufferSize, PendingPacketPoolType & packetBuffers) :
-        mActiveConnections(activeConnectionsBuffer), mActiveConnectionsSize(bufferSize), mPendingPackets(packetBuffers)
+        mActiveConnections{ activeConnectionsBuffer, bufferSize, nullptr }, mActiveConnectionsSize(bufferSize),
+        mMaxActiveConnections(bufferSize), mPendingPackets(packetBuffers)
     {
         // activeConnectionsBuffer must be initialized by the caller.
     }
@@ -144,6 +147,27 @@ public:
      */
     void SetConnectTimeout(const uint32_t connTimeoutMsecs) { mConnectTimeout = connTimeoutMsecs; }
 
+    /**
+     * Allow the connection pool to grow beyond the connection states provided at construction.
+     *
+     * Additional connection states are allocated from the heap in blocks of
+     * CHIP_CONFIG_TCP_CONNECTION_POOL_GROWTH_SIZE when needed and are only released when the
+     * transport is destroyed, so that connection pointers held by upper layers remain valid.
+     * The limit cannot be set below the static capacity of the transport.
+     */
+    void SetMaxActiveConnections(size_t maxConnections)
+    {
+        mMaxActiveConnections = std::max(maxConnections, mActiveConnectionsSize);
+    }
+    size_t GetMaxActiveConnections() const { return mMaxActiveConnections; }
+
+    /**
+     * Set the time (in milliseconds) after which a connection that has neither sent nor received
+     * data is closed. Upper layers are notified through HandleConnectionClosed. A value of 0
+     * disables idle connection reaping.
+     */
+    void SetIdleConnectionTimeout(uint32_t idleTimeoutMsecs);
+
     /**
      * Close the open endpoint without destroying the object
      */
@@ -209,7 +233,44 @@ private:
     friend class TCPBaseTestAccess;
 
     /**
-     * Allocate an unused connection from the pool
+     * A contiguous block of connection states. The first block is the buffer provided at
+     * construction; any following blocks are heap allocated when the pool grows.
+     */
+    struct ConnectionBlock
+    {
+        ActiveTCPConnectionState * mConnections;
+        size_t mSize;
+        ConnectionBlock * mNext;
+    };
+
+    struct HeapConnectionBlock : public ConnectionBlock
+    {
+        HeapConnectionBlock() : ConnectionBlock{ mStorage, CHIP_CONFIG_TCP_CONNECTION_POOL_GROWTH_SIZE, nullptr } {}
+
+        ActiveTCPConnectionState mStorage[CHIP_CONFIG_TCP_CONNECTION_POOL_GROWTH_SIZE];
+    };
+
+    /**
+     * Call function on every connection state of the pool, in use or not.
+     */
+    template <typename Function>
+    Loop ForEachConnection(Function && function) const
+    {
+        for (const ConnectionBlock * block = &mActiveConnections; block != nullptr; block = block->mNext)
+        {
+            for (size_t i = 0; i < block->mSize; i++)
+            {
+                if (function(&block->mConnections[i]) == Loop::Break)
+                {
+                    return Loop::Break;
+                }
+            }
+        }
+        return Loop::Finish;
+    }
+
+    /**
+     * Allocate an unused connection from the pool, growing the pool if allowed.
      *
      */
     ActiveTCPConnectionState * AllocateConnection();
@@ -255,11 +316,23 @@ private:
      * @param[in]     peerAddress   The peer the data is coming from.
      * @param[in,out] state         The connection state, which contains the message. On entry, the payload points to the message
      *                              body (after the length). On exit, it points after the message (or the queue is null, if there
-     *                              is no other data).
+     *                              is no other data). If the message has not been fully received yet, the available part is
+     *                              moved to `state->mPendingMessage` and the rest is appended as it arrives.
      * @param[in]     messageSize   Size of the single message.
      */
     CHIP_ERROR ProcessSingleMessage(const PeerAddress & peerAddress, ActiveTCPConnectionState * state, size_t messageSize);
 
+    /**
+     * Move received data into the message being reassembled for the given connection, and pass the
+     * message upstream once it is complete.
+     */
+    CHIP_ERROR ContinuePendingMessage(const PeerAddress & peerAddress, ActiveTCPConnectionState * state);
+
+    // Close connections that have been idle for longer than the configured timeout.
+    void CloseIdleConnections();
+    void StartIdleConnectionTimer();
+    static void HandleIdleConnectionTimer(System::Layer * layer, void * appState);
+
     /**
      * Initiate a connection to the given peer. On connection completion,
      * HandleTCPConnectComplete callback would be called.
@@ -302,16 +375,23 @@ private:
     Inet::IPAddressType mEndpointType = Inet::IPAddressType::kUnknown; ///< Socket listening type
     TCPState mState                   = TCPState::kNotReady;           ///< State of the TCP transport
 
+    System::Layer * mSystemLayer      = nullptr;                       ///< System layer used for the idle timer
+
     // The configured timeout for the connection attempt to the peer, before
     // giving up.
     uint32_t mConnectTimeout = CHIP_CONFIG_TCP_CONNECT_TIMEOUT_MSECS;
 
+    // The configured time after which idle connections are closed, 0 if disabled.
+    uint32_t mIdleConnectionTimeout = CHIP_CONFIG_TCP_IDLE_CONNECTION_TIMEOUT_MSECS;
+
     // Number of active and 'pending connection' endpoints
     size_t mUsedEndPointCount = 0;
 
-    // Currently active connections
-    ActiveTCPConnectionState * mActiveConnections;
+    // Currently active connections: the static buffer followed by any heap allocated blocks.
+    ConnectionBlock mActiveConnections;
     const size_t mActiveConnectionsSize;
+    size_t mConnectionPoolSize = mActiveConnectionsSize;
+    size_t mMaxActiveConnections;
 
     // Data to be sent when connections succeed
     PendingPacketPoolType & mPendingPackets;
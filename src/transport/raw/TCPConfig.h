@@ -63,6 +63,29 @@ namespace chip {
 #define CHIP_CONFIG_MAX_TCP_PENDING_PACKETS 4
 #endif
 
+/**
+ * @def CHIP_CONFIG_TCP_CONNECTION_POOL_GROWTH_SIZE
+ *
+ * @brief Number of connection states allocated at once when a TCP transport whose maximum
+ *        connection count was raised above its static capacity needs more connections.
+ */
+#ifndef CHIP_CONFIG_TCP_CONNECTION_POOL_GROWTH_SIZE
+#define CHIP_CONFIG_TCP_CONNECTION_POOL_GROWTH_SIZE 8
+#endif
+
+/**
+ *  @def CHIP_CONFIG_TCP_IDLE_CONNECTION_TIMEOUT_MSECS
+ *
+ *  @brief
+ *    This defines the default time after which a connected peer that
+ *    has neither sent nor received any data is disconnected. A value
+ *    of 0 disables idle connection reaping.
+ *
+ */
+#ifndef CHIP_CONFIG_TCP_IDLE_CONNECTION_TIMEOUT_MSECS
+#define CHIP_CONFIG_TCP_IDLE_CONNECTION_TIMEOUT_MSECS (0)
+#endif // CHIP_CONFIG_TCP_IDLE_CONNECTION_TIMEOUT_MSECS
+
 /**
  *  @def CHIP_CONFIG_TCP_CONNECT_TIMEOUT_MSECS
  *
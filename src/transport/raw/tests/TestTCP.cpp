@@ -23,7 +23,10 @@
 
 #include "NetworkTestHelpers.h"
 
+#include <algorithm>
+#include <chrono>
 #include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <utility>
@@ -35,6 +38,7 @@
 #include <lib/core/CHIPEncoding.h>
 #include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
+#include <lib/support/ScopedBuffer.h>
 #include <lib/support/UnitTestUtils.h>
 #include <system/SystemLayer.h>
 #include <transport/TransportMgr.h>
@@ -133,7 +137,7 @@ public:
         }
     }
 
-    void InitializeMessageTest(TCPImpl & tcp, const IPAddress & addr)
+    void InitializeMessageTest(Transport::TCPBase & tcp, const IPAddress & addr)
     {
         CHIP_ERROR err = tcp.Init(Transport::TcpListenParameters(mIOContext->GetTCPEndPointManager())
                                       .SetAddressType(addr.Type())
@@ -176,7 +180,7 @@ public:
         gAppTCPConnCbCtxt.connClosedCb   = nullptr;
     }
 
-    void SingleMessageTest(TCPImpl & tcp, const IPAddress & addr)
+    void SingleMessageTest(Transport::TCPBase & tcp, const IPAddress & addr)
     {
         chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::NewWithData(PAYLOAD, sizeof(PAYLOAD));
         ASSERT_FALSE(buffer.IsNull());
@@ -200,7 +204,7 @@ public:
         SetCallback(nullptr);
     }
 
-    void ConnectTest(TCPImpl & tcp, const IPAddress & addr)
+    void ConnectTest(Transport::TCPBase & tcp, const IPAddress & addr)
     {
         // Connect and wait for seeing active connection
         CHIP_ERROR err = tcp.TCPConnect(Transport::PeerAddress::TCP(addr, gChipTCPPort), &gAppTCPConnCbCtxt, &gActiveTCPConnState);
@@ -210,7 +214,7 @@ public:
         EXPECT_EQ(tcp.HasActiveConnections(), true);
     }
 
-    void HandleConnectCompleteCbCalledTest(TCPImpl & tcp, const IPAddress & addr)
+    void HandleConnectCompleteCbCalledTest(Transport::TCPBase & tcp, const IPAddress & addr)
     {
         // Connect and wait for seeing active connection and connection complete
         // handler being called.
@@ -221,7 +225,7 @@ public:
         EXPECT_EQ(mHandleConnectionCompleteCalled, true);
     }
 
-    void HandleConnectCloseCbCalledTest(TCPImpl & tcp, const IPAddress & addr)
+    void HandleConnectCloseCbCalledTest(Transport::TCPBase & tcp, const IPAddress & addr)
     {
         // Connect and wait for seeing active connection and connection complete
         // handler being called.
@@ -236,7 +240,33 @@ public:
         EXPECT_EQ(mHandleConnectionCloseCalled, true);
     }
 
-    void DisconnectTest(TCPImpl & tcp, chip::Transport::ActiveTCPConnectionState * conn)
+    void ManyMessagesTest(Transport::TCPBase & tcp, const IPAddress & addr, int messageCount, size_t payloadSize)
+    {
+        chip::Platform::ScopedMemoryBuffer<uint8_t> payload;
+        ASSERT_TRUE(payload.Calloc(payloadSize));
+
+        PacketHeader header;
+        header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageCounter(kMessageCounter);
+
+        mReceiveHandlerCallCount = 0;
+
+        for (int i = 0; i < messageCount; i++)
+        {
+            chip::System::PacketBufferHandle buffer = chip::System::PacketBufferHandle::NewWithData(payload.Get(), payloadSize);
+            ASSERT_FALSE(buffer.IsNull());
+            EXPECT_EQ(header.EncodeBeforeData(buffer), CHIP_NO_ERROR);
+            EXPECT_EQ(tcp.SendMessage(Transport::PeerAddress::TCP(addr, gChipTCPPort), std::move(buffer)), CHIP_NO_ERROR);
+
+            // Keep the receiving side draining so the socket buffers do not fill up.
+            mIOContext->DriveIO();
+        }
+
+        mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(20),
+                                 [this, messageCount]() { return mReceiveHandlerCallCount == messageCount; });
+        EXPECT_EQ(mReceiveHandlerCallCount, messageCount);
+    }
+
+    void DisconnectTest(Transport::TCPBase & tcp, chip::Transport::ActiveTCPConnectionState * conn)
     {
         // Disconnect and wait for seeing peer close
         tcp.TCPDisconnect(conn, true);
@@ -244,7 +274,7 @@ public:
         EXPECT_EQ(tcp.HasActiveConnections(), false);
     }
 
-    void DisconnectTest(TCPImpl & tcp, const IPAddress & addr)
+    void DisconnectTest(Transport::TCPBase & tcp, const IPAddress & addr)
     {
         // Disconnect and wait for seeing peer close
         tcp.TCPDisconnect(Transport::PeerAddress::TCP(addr, gChipTCPPort));
@@ -495,6 +525,67 @@ protected:
         gMockTransportMgrDelegate.DisconnectTest(tcp, addr);
     }
 
+    void ConnectionPoolGrowthTest(const IPAddress & addr)
+    {
+        // A single static connection state is not enough for a connection to self, which uses one state for each end.
+        Transport::TCP<1, kMaxTcpPendingPackets> tcp;
+        tcp.SetMaxActiveConnections(kMaxTcpActiveConnectionCount);
+        EXPECT_EQ(tcp.GetMaxActiveConnections(), kMaxTcpActiveConnectionCount);
+
+        MockTransportMgrDelegate gMockTransportMgrDelegate(mIOContext);
+        gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr);
+        gMockTransportMgrDelegate.SingleMessageTest(tcp, addr);
+        gMockTransportMgrDelegate.DisconnectTest(tcp, addr);
+    }
+
+    void IdleConnectionTimeoutTest(const IPAddress & addr)
+    {
+        TCPImpl tcp;
+
+        MockTransportMgrDelegate gMockTransportMgrDelegate(mIOContext);
+        gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr);
+        tcp.SetIdleConnectionTimeout(100);
+        gMockTransportMgrDelegate.ConnectTest(tcp, addr);
+
+        // Without traffic, both ends of the connection should be closed by the idle timer.
+        mIOContext->DriveIOUntil(chip::System::Clock::Seconds16(5), [&tcp]() { return !tcp.HasActiveConnections(); });
+        EXPECT_FALSE(tcp.HasActiveConnections());
+        EXPECT_TRUE(gMockTransportMgrDelegate.mHandleConnectionCloseCalled);
+    }
+
+    void LoopbackManyMessagesTest(const IPAddress & addr)
+    {
+        TCPImpl tcp;
+
+        MockTransportMgrDelegate gMockTransportMgrDelegate(mIOContext);
+        gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr);
+        gMockTransportMgrDelegate.SingleMessageTest(tcp, addr);
+        gMockTransportMgrDelegate.ManyMessagesTest(tcp, addr, 1000, 1024);
+        gMockTransportMgrDelegate.DisconnectTest(tcp, addr);
+    }
+
+    void LoopbackThroughputBenchmark(const IPAddress & addr)
+    {
+        constexpr int kMessageCount = 10000;
+
+        TCPImpl tcp;
+
+        MockTransportMgrDelegate gMockTransportMgrDelegate(mIOContext);
+        gMockTransportMgrDelegate.InitializeMessageTest(tcp, addr);
+        gMockTransportMgrDelegate.SingleMessageTest(tcp, addr);
+        for (size_t payloadSize : { 64, 256, 1024 })
+        {
+            auto start = std::chrono::steady_clock::now();
+            gMockTransportMgrDelegate.ManyMessagesTest(tcp, addr, kMessageCount, payloadSize);
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            elapsed      = std::max<long long>(elapsed, 1);
+            printf("%5u byte payloads: %8u messages/s, %8u KB/s\n", static_cast<unsigned>(payloadSize),
+                   static_cast<unsigned>(kMessageCount * 1000000LL / elapsed),
+                   static_cast<unsigned>(kMessageCount * static_cast<long long>(payloadSize) * 1000000 / 1024 / elapsed));
+        }
+        gMockTransportMgrDelegate.DisconnectTest(tcp, addr);
+    }
+
     void HandleConnCloseTest(const IPAddress & addr)
     {
         TCPImpl tcp;
@@ -608,6 +699,36 @@ TEST_F(TestTCP, HandleConnCloseCalledTest6)
     HandleConnCloseTest(addr);
 }
 
+TEST_F(TestTCP, ConnectionPoolGrowthTest6)
+{
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    ConnectionPoolGrowthTest(addr);
+}
+
+TEST_F(TestTCP, IdleConnectionTimeoutTest6)
+{
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    IdleConnectionTimeoutTest(addr);
+}
+
+TEST_F(TestTCP, LoopbackManyMessagesTest6)
+{
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    LoopbackManyMessagesTest(addr);
+}
+
+// Not a pass/fail test, so disabled by default: reports the sustained loopback throughput of a single connection for a few
+// payload sizes, sending and receiving on the same thread.
+TEST_F(TestTCP, DISABLED_BenchmarkLoopbackThroughput)
+{
+    IPAddress addr;
+    IPAddress::FromString("::1", addr);
+    LoopbackThroughputBenchmark(addr);
+}
+
 TEST_F(TestTCP, CheckProcessReceivedBuffer)
 {
     TCPImpl tcp;
@@ -664,6 +785,17 @@ TEST_F(TestTCP, CheckProcessReceivedBuffer)
     EXPECT_EQ(err, CHIP_NO_ERROR);
     EXPECT_EQ(gMockTransportMgrDelegate.mReceiveHandlerCallCount, 2);
 
+    // Test a message whose body arrives in separate receive calls.
+    gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
+    EXPECT_TRUE(testData[0].Init((const uint32_t[]){ 151, 152, 153, 0 }));
+    for (int i = 0; i < 3; i++)
+    {
+        System::PacketBufferHandle part = testData[0].mHandle.PopHead();
+        err = TestAccess::ProcessReceivedBuffer(tcp, lEndPoint, lPeerAddress, std::move(part));
+        EXPECT_EQ(err, CHIP_NO_ERROR);
+        EXPECT_EQ(gMockTransportMgrDelegate.mReceiveHandlerCallCount, (i == 2) ? 1 : 0);
+    }
+
     // Test a single packet buffer that is larger than
     // kMaxSizeWithoutReserve but less than CHIP_CONFIG_MAX_LARGE_PAYLOAD_SIZE_BYTES.
     gMockTransportMgrDelegate.mReceiveHandlerCallCount = 0;
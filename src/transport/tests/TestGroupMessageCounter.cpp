@@ -21,7 +21,10 @@
  *      This file implements unit tests for the SessionManager implementation.
  */
 
+#include <chrono>
 #include <errno.h>
+#include <map>
+
 #include <gtest/gtest.h>
 
 #include <lib/support/DefaultStorageKeyAllocator.h>
@@ -83,14 +86,14 @@ public:
     {
         if (fabricIndex < CHIP_CONFIG_MAX_FABRICS)
         {
-            if (isControl && index < CHIP_CONFIG_MAX_GROUP_CONTROL_PEERS)
+            if (isControl && index < mGroupFabrics[fabricIndex].mControlGroupSenders.Count())
             {
-                return mGroupFabrics[fabricIndex].mControlGroupSenders[index].mNodeId;
+                return mGroupFabrics[fabricIndex].mControlGroupSenders.At(index).mNodeId;
             }
 
-            if (!isControl && index < CHIP_CONFIG_MAX_GROUP_DATA_PEERS)
+            if (!isControl && index < mGroupFabrics[fabricIndex].mDataGroupSenders.Count())
             {
-                return mGroupFabrics[fabricIndex].mDataGroupSenders[index].mNodeId;
+                return mGroupFabrics[fabricIndex].mDataGroupSenders.At(index).mNodeId;
             }
         }
 
@@ -107,6 +110,7 @@ TEST(TestGroupMessageCounter, AddPeerTest)
     chip::Transport::PeerMessageCounter * counter = nullptr;
     chip::Transport::GroupPeerTable mGroupPeerMsgCounter;
 
+    // Senders that were all heard from recently are not evicted to make room for a new one.
     do
     {
         err = mGroupPeerMsgCounter.FindOrAddPeer(fabricIndex, peerNodeId++, false, counter);
@@ -125,6 +129,96 @@ TEST(TestGroupMessageCounter, AddPeerTest)
     EXPECT_EQ(i, CHIP_CONFIG_MAX_FABRICS + 1);
 }
 
+TEST(TestGroupMessageCounter, EvictLeastRecentlyUsedPeerTest)
+{
+    FabricIndex fabricIndex                       = 1;
+    chip::Transport::PeerMessageCounter * counter = nullptr;
+    TestGroupPeerTable mGroupPeerMsgCounter;
+
+    System::Clock::Internal::MockClock clock;
+    System::Clock::ClockBase * realClock = &System::SystemClock();
+    System::Clock::Internal::SetSystemClockForTesting(&clock);
+
+    for (NodeId peer = 1; peer <= CHIP_CONFIG_MAX_GROUP_DATA_PEERS; peer++)
+    {
+        EXPECT_EQ(mGroupPeerMsgCounter.FindOrAddPeer(fabricIndex, peer, false, counter), CHIP_NO_ERROR);
+        EXPECT_EQ(counter->VerifyOrTrustFirstGroup(5000), CHIP_NO_ERROR);
+        counter->CommitGroup(5000);
+    }
+
+    // Evicting a sender that is still active would let its messages be replayed: the new sender is refused instead.
+    clock.AdvanceMonotonic(chip::Transport::GroupSenderList<1>::kMinIdleBeforeEviction - System::Clock::Milliseconds64(1));
+    EXPECT_EQ(mGroupPeerMsgCounter.FindOrAddPeer(fabricIndex, 1000, false, counter), CHIP_ERROR_TOO_MANY_PEER_NODES);
+    EXPECT_EQ(mGroupPeerMsgCounter.FindOrAddPeer(fabricIndex, 1, false, counter), CHIP_NO_ERROR);
+    EXPECT_NE(counter->VerifyOrTrustFirstGroup(5000), CHIP_NO_ERROR);
+
+    // Once idle long enough, the least recently used sender is evicted: peer 1 was heard from again, so that is peer 2.
+    clock.AdvanceMonotonic(System::Clock::Milliseconds64(1));
+    EXPECT_EQ(mGroupPeerMsgCounter.FindOrAddPeer(fabricIndex, 1000, false, counter), CHIP_NO_ERROR);
+
+    bool peer2Found = false;
+    for (uint8_t index = 0; index < CHIP_CONFIG_MAX_GROUP_DATA_PEERS; index++)
+    {
+        peer2Found = peer2Found || (mGroupPeerMsgCounter.GetNodeIdAt(0, index, false) == 2);
+    }
+    EXPECT_FALSE(peer2Found);
+
+    // Peer 1 kept its counter, peer 2 starts over.
+    EXPECT_EQ(mGroupPeerMsgCounter.FindOrAddPeer(fabricIndex, 1, false, counter), CHIP_NO_ERROR);
+    EXPECT_NE(counter->VerifyOrTrustFirstGroup(5000), CHIP_NO_ERROR);
+    EXPECT_EQ(mGroupPeerMsgCounter.FindOrAddPeer(fabricIndex, 2, false, counter), CHIP_NO_ERROR);
+    EXPECT_EQ(counter->VerifyOrTrustFirstGroup(5000), CHIP_NO_ERROR);
+
+    System::Clock::Internal::SetSystemClockForTesting(realClock);
+}
+
+TEST(TestGroupMessageCounter, SenderListChurnTest)
+{
+    // Interleave additions and removals so that probing sequences wrap and get shifted back on removal.
+    constexpr size_t kCapacity = 37;
+    chip::Transport::GroupSenderList<kCapacity> senders;
+    std::map<NodeId, uint32_t> expected;
+
+    uint32_t seed = 1;
+    for (uint32_t round = 0; round < 5000; round++)
+    {
+        seed        = seed * 1103515245 + 12345;
+        NodeId node = (seed >> 8) % (2 * kCapacity) + 1;
+
+        if ((seed & 3) == 0)
+        {
+            EXPECT_EQ(senders.Remove(node), expected.erase(node) == 1);
+            continue;
+        }
+
+        if (expected.size() == kCapacity && expected.count(node) == 0)
+        {
+            // Avoid evictions here; EvictLeastRecentlyUsedPeerTest covers them.
+            continue;
+        }
+
+        chip::Transport::PeerMessageCounter & counter = *senders.FindOrAdd(node, System::Clock::Timestamp(round));
+        if (expected.count(node) == 0)
+        {
+            EXPECT_EQ(counter.VerifyOrTrustFirstGroup(round), CHIP_NO_ERROR);
+        }
+        else
+        {
+            // A known sender still has its counter: a replay of the last message is rejected.
+            EXPECT_NE(counter.VerifyOrTrustFirstGroup(expected[node]), CHIP_NO_ERROR);
+            EXPECT_EQ(counter.VerifyOrTrustFirstGroup(round), CHIP_NO_ERROR);
+        }
+        counter.CommitGroup(round);
+        expected[node] = round;
+    }
+
+    EXPECT_EQ(senders.Count(), expected.size());
+    for (size_t index = 0; index < senders.Count(); index++)
+    {
+        EXPECT_EQ(expected.count(senders.At(index).mNodeId), 1u);
+    }
+}
+
 TEST(TestGroupMessageCounter, RemovePeerTest)
 {
     NodeId peerNodeId                             = 1234;
@@ -453,4 +547,36 @@ TEST(TestGroupMessageCounter, GroupMessageCounterTest)
     EXPECT_EQ(groupCientCounter5.GetCounter(false), (UINT32_MAX + GROUP_MSG_COUNTER_MIN_INCREMENT));
 }
 
+template <size_t kSenders>
+void BenchmarkGroupCounterValidation()
+{
+    constexpr uint32_t kRounds = 100000;
+    chip::Transport::GroupSenderList<kSenders> senders;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < kRounds; round++)
+    {
+        // What SessionManager does for each received group message, with senders taking turns.
+        chip::Transport::PeerMessageCounter & counter =
+            *senders.FindOrAdd(0x1000 + round % kSenders, System::Clock::Timestamp(round));
+        uint32_t messageCounter = round / kSenders + 1;
+        EXPECT_EQ(counter.VerifyOrTrustFirstGroup(messageCounter), CHIP_NO_ERROR);
+        counter.CommitGroup(messageCounter);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(senders.Count(), kSenders);
+    printf("%5u group senders: %4u ns per validated message\n", static_cast<unsigned>(kSenders),
+           static_cast<unsigned>(elapsed / kRounds));
+}
+
+// Not a pass/fail test, so disabled by default: reports the cost of group message counter validation as the number of
+// senders grows.
+TEST(TestGroupMessageCounter, DISABLED_BenchmarkCounterValidation)
+{
+    BenchmarkGroupCounterValidation<10>();
+    BenchmarkGroupCounterValidation<100>();
+    BenchmarkGroupCounterValidation<1000>();
+}
+
 } // namespace